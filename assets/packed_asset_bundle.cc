@@ -0,0 +1,251 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/packed_asset_bundle.h"
+
+#include <algorithm>
+#include <cstring>
+#include <regex>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x4b415046;  // "FPAK"
+constexpr uint32_t kVersion = 1;
+constexpr size_t kDataAlignment = 16;
+
+struct Header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t entry_count;
+  uint32_t reserved;
+};
+
+size_t Align(size_t offset) {
+  return (offset + kDataAlignment - 1) & ~(kDataAlignment - 1);
+}
+
+std::string_view BaseName(std::string_view name) {
+  size_t slash = name.rfind('/');
+  return slash == std::string_view::npos ? name : name.substr(slash + 1);
+}
+
+bool IsLiteralPattern(const std::string& pattern) {
+  return pattern.find_first_of(".[]{}()\\*+?^$|") == std::string::npos;
+}
+
+}  // namespace
+
+struct PackedAssetBundle::IndexEntry {
+  uint64_t data_offset;
+  uint64_t data_size;
+  uint32_t name_offset;
+  uint32_t name_size;
+};
+
+PackedAssetBundle::PackedAssetBundle(
+    std::shared_ptr<const fml::Mapping> archive,
+    bool is_valid_after_asset_manager_change)
+    : archive_(std::move(archive)) {
+  static_assert(sizeof(Header) == 16, "The header must not be padded.");
+  static_assert(sizeof(IndexEntry) == 24, "The entries must not be padded.");
+  TRACE_EVENT0("flutter", "PackedAssetBundle::PackedAssetBundle");
+  if (!archive_ || archive_->GetMapping() == nullptr ||
+      archive_->GetSize() < sizeof(Header)) {
+    return;
+  }
+  const uint8_t* base = archive_->GetMapping();
+  const size_t size = archive_->GetSize();
+  Header header;
+  memcpy(&header, base, sizeof(header));
+  if (header.magic != kMagic || header.version != kVersion) {
+    FML_LOG(ERROR) << "Unsupported asset archive.";
+    return;
+  }
+  if (header.entry_count > (size - sizeof(Header)) / sizeof(IndexEntry)) {
+    FML_LOG(ERROR) << "Truncated asset archive index.";
+    return;
+  }
+
+  std::vector<IndexEntry> index(header.entry_count);
+  memcpy(index.data(), base + sizeof(Header),
+         header.entry_count * sizeof(IndexEntry));
+  std::string_view previous_name;
+  for (size_t i = 0; i < index.size(); i++) {
+    const IndexEntry& entry = index[i];
+    if (entry.name_offset > size ||
+        entry.name_size > size - entry.name_offset ||
+        entry.data_offset > size ||
+        entry.data_size > size - entry.data_offset) {
+      FML_LOG(ERROR) << "Asset archive entry out of bounds.";
+      return;
+    }
+    std::string_view name(
+        reinterpret_cast<const char*>(base + entry.name_offset),
+        entry.name_size);
+    if (i > 0 && !(previous_name < name)) {
+      FML_LOG(ERROR) << "Asset archive index is not sorted.";
+      return;
+    }
+    previous_name = name;
+  }
+
+  index_ = std::move(index);
+  is_valid_after_asset_manager_change_ = is_valid_after_asset_manager_change;
+  is_valid_ = true;
+}
+
+PackedAssetBundle::~PackedAssetBundle() = default;
+
+std::unique_ptr<fml::Mapping> PackedAssetBundle::Pack(
+    const std::map<std::string, std::unique_ptr<fml::Mapping>>& assets) {
+  size_t names_size = 0;
+  for (const auto& asset : assets) {
+    names_size += asset.first.size();
+  }
+  const size_t index_end = sizeof(Header) + assets.size() * sizeof(IndexEntry);
+  size_t size = Align(index_end + names_size);
+  for (const auto& asset : assets) {
+    size = Align(size + (asset.second ? asset.second->GetSize() : 0));
+  }
+
+  std::vector<uint8_t> archive(size, 0);
+  const Header header = {kMagic, kVersion,
+                         static_cast<uint32_t>(assets.size()), 0};
+  memcpy(archive.data(), &header, sizeof(header));
+
+  size_t name_offset = index_end;
+  size_t data_offset = Align(index_end + names_size);
+  size_t index_offset = sizeof(Header);
+  // |std::map| keeps the names sorted, as the index requires.
+  for (const auto& asset : assets) {
+    const std::string& name = asset.first;
+    const size_t data_size = asset.second ? asset.second->GetSize() : 0;
+    const IndexEntry entry = {data_offset, data_size,
+                              static_cast<uint32_t>(name_offset),
+                              static_cast<uint32_t>(name.size())};
+    memcpy(archive.data() + index_offset, &entry, sizeof(entry));
+    memcpy(archive.data() + name_offset, name.data(), name.size());
+    if (data_size > 0) {
+      memcpy(archive.data() + data_offset, asset.second->GetMapping(),
+             data_size);
+    }
+    index_offset += sizeof(entry);
+    name_offset += name.size();
+    data_offset = Align(data_offset + data_size);
+  }
+  return std::make_unique<fml::DataMapping>(std::move(archive));
+}
+
+// |AssetResolver|
+bool PackedAssetBundle::IsValid() const {
+  return is_valid_;
+}
+
+// |AssetResolver|
+bool PackedAssetBundle::IsValidAfterAssetManagerChange() const {
+  return is_valid_after_asset_manager_change_;
+}
+
+// |AssetResolver|
+AssetResolver::AssetResolverType PackedAssetBundle::GetType() const {
+  return AssetResolver::AssetResolverType::kPackedAssetBundle;
+}
+
+std::string_view PackedAssetBundle::GetName(const IndexEntry& entry) const {
+  return std::string_view(
+      reinterpret_cast<const char*>(archive_->GetMapping() + entry.name_offset),
+      entry.name_size);
+}
+
+size_t PackedAssetBundle::LowerBound(std::string_view name) const {
+  auto it = std::lower_bound(index_.begin(), index_.end(), name,
+                             [this](const IndexEntry& entry,
+                                    std::string_view name) {
+                               return GetName(entry) < name;
+                             });
+  return it - index_.begin();
+}
+
+std::unique_ptr<fml::Mapping> PackedAssetBundle::GetEntryMapping(
+    const IndexEntry& entry) const {
+  // The slice keeps the archive mapped for as long as it is used.
+  return std::make_unique<fml::NonOwnedMapping>(
+      archive_->GetMapping() + entry.data_offset, entry.data_size,
+      [archive = archive_](const uint8_t*, size_t) {});
+}
+
+// |AssetResolver|
+std::unique_ptr<fml::Mapping> PackedAssetBundle::GetAsMapping(
+    const std::string& asset_name) const {
+  if (!is_valid_) {
+    FML_DLOG(WARNING) << "Asset bundle was not valid.";
+    return nullptr;
+  }
+  const size_t position = LowerBound(asset_name);
+  if (position == index_.size() || GetName(index_[position]) != asset_name) {
+    return nullptr;
+  }
+  return GetEntryMapping(index_[position]);
+}
+
+std::vector<std::string> PackedAssetBundle::GetAssetNames(
+    const std::string& prefix) const {
+  std::vector<std::string> names;
+  if (!is_valid_) {
+    return names;
+  }
+  for (size_t i = LowerBound(prefix); i < index_.size(); i++) {
+    std::string_view name = GetName(index_[i]);
+    if (name.compare(0, prefix.size(), prefix) != 0) {
+      break;
+    }
+    names.emplace_back(name);
+  }
+  return names;
+}
+
+// |AssetResolver|
+std::vector<std::unique_ptr<fml::Mapping>> PackedAssetBundle::GetAsMappings(
+    const std::string& asset_pattern,
+    const std::optional<std::string>& subdir) const {
+  std::vector<std::unique_ptr<fml::Mapping>> mappings;
+  if (!is_valid_) {
+    FML_DLOG(WARNING) << "Asset bundle was not valid.";
+    return mappings;
+  }
+  TRACE_EVENT0("flutter", "PackedAssetBundle::GetAsMappings");
+
+  // Like |DirectoryAssetBundle|, the pattern is matched against the file
+  // names of the assets, either in all the directories or only directly in
+  // |subdir|.
+  const std::string prefix = subdir ? subdir.value() + "/" : "";
+  const bool literal = IsLiteralPattern(asset_pattern);
+  std::regex asset_regex;
+  if (!literal) {
+    asset_regex = std::regex(asset_pattern);
+  }
+  for (size_t i = LowerBound(prefix); i < index_.size(); i++) {
+    std::string_view name = GetName(index_[i]);
+    if (name.compare(0, prefix.size(), prefix) != 0) {
+      break;
+    }
+    if (subdir && name.find('/', prefix.size()) != std::string_view::npos) {
+      continue;
+    }
+    std::string_view filename = BaseName(name);
+    if (literal ? filename == asset_pattern
+                : std::regex_match(filename.begin(), filename.end(),
+                                   asset_regex)) {
+      mappings.push_back(GetEntryMapping(index_[i]));
+    }
+  }
+  return mappings;
+}
+
+}  // namespace flutter
@@ -0,0 +1,102 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
+#define FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "flutter/assets/asset_resolver.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      An asset resolver backed by a single archive that holds all the
+///             assets of the application.
+///
+///             The archive is mapped once and its index is read when the
+///             resolver is created. The index of asset names is sorted, so
+///             assets are found by a binary search and are returned as slices
+///             of the archive, without any further system calls. Queries for
+///             all the assets in a subdirectory only look at the range of the
+///             index with the names in it.
+///
+///             The archive consists of a header, the index, the names of the
+///             assets and their contents, each aligned to 16 bytes. All
+///             integers are little-endian. Use |Pack| to create one.
+///
+class PackedAssetBundle : public AssetResolver {
+ public:
+  /// The name of the archive in the assets directory of the application.
+  static constexpr char kArchiveFileName[] = "assets.pack";
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a resolver for the assets in `archive`. The resolver
+  ///             is invalid if `archive` is not a well formed archive.
+  ///
+  PackedAssetBundle(std::shared_ptr<const fml::Mapping> archive,
+                    bool is_valid_after_asset_manager_change);
+
+  ~PackedAssetBundle() override;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates an archive of `assets`, keyed by their names.
+  ///
+  static std::unique_ptr<fml::Mapping> Pack(
+      const std::map<std::string, std::unique_ptr<fml::Mapping>>& assets);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the names of the assets that start with `prefix`, in
+  ///             sorted order.
+  ///
+  std::vector<std::string> GetAssetNames(const std::string& prefix) const;
+
+  // |AssetResolver|
+  bool IsValid() const override;
+
+  // |AssetResolver|
+  bool IsValidAfterAssetManagerChange() const override;
+
+  // |AssetResolver|
+  AssetResolver::AssetResolverType GetType() const override;
+
+  // |AssetResolver|
+  std::unique_ptr<fml::Mapping> GetAsMapping(
+      const std::string& asset_name) const override;
+
+  // |AssetResolver|
+  std::vector<std::unique_ptr<fml::Mapping>> GetAsMappings(
+      const std::string& asset_pattern,
+      const std::optional<std::string>& subdir) const override;
+
+ private:
+  struct IndexEntry;
+
+  const std::shared_ptr<const fml::Mapping> archive_;
+  // Copied out of the archive, which makes no alignment guarantees.
+  std::vector<IndexEntry> index_;
+  bool is_valid_ = false;
+  bool is_valid_after_asset_manager_change_ = false;
+
+  std::string_view GetName(const IndexEntry& entry) const;
+
+  // Returns the position in `index_` of the first entry whose name is not less
+  // than `name`.
+  size_t LowerBound(std::string_view name) const;
+
+  std::unique_ptr<fml::Mapping> GetEntryMapping(const IndexEntry& entry) const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PackedAssetBundle);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
@@ -51,6 +51,7 @@ bool PersistentCache::gIsReadOnly = false;
 
 std::atomic<bool> PersistentCache::cache_sksl_ = false;
 std::atomic<bool> PersistentCache::strategy_set_ = false;
+std::atomic<bool> PersistentCache::use_shader_cache_file_ = false;
 
 void PersistentCache::SetCacheSkSL(bool value) {
   if (strategy_set_ && value != cache_sksl_) {
@@ -61,6 +62,10 @@ void PersistentCache::SetCacheSkSL(bool value) {
   cache_sksl_ = value;
 }
 
+void PersistentCache::SetUseShaderCacheFile(bool value) {
+  use_shader_cache_file_ = value;
+}
+
 PersistentCache* PersistentCache::GetCacheForProcess() {
   std::scoped_lock lock(instance_mutex_);
   if (gPersistentCache == nullptr) {
@@ -87,7 +92,9 @@ bool PersistentCache::Purge() {
 
   std::promise<bool> removed;
   GetWorkerTaskRunner()->PostTask([&removed,
-                                   cache_directory = cache_directory_]() {
+                                   cache_directory = cache_directory_,
+                                   cache_file = cache_file_,
+                                   sksl_cache_file = sksl_cache_file_]() {
     if (cache_directory->is_valid()) {
       // Only remove files but not directories.
       FML_LOG(INFO) << "Purge persistent cache.";
@@ -100,6 +107,8 @@ bool PersistentCache::Purge() {
         return fml::UnlinkFile(directory, filename.c_str());
       };
       removed.set_value(VisitFilesRecursively(*cache_directory, delete_file));
+      cache_file->Clear();
+      sksl_cache_file->Clear();
     } else {
       removed.set_value(false);
     }
@@ -107,6 +116,15 @@ bool PersistentCache::Purge() {
   return removed.get_future().get();
 }
 
+fml::UniqueFD PersistentCache::OpenSubdirectory(const std::string& name) const {
+  if (!IsValid()) {
+    return {};
+  }
+  return fml::CreateDirectory(*cache_directory_, {name},
+                              is_read_only_ ? fml::FilePermission::kRead
+                                            : fml::FilePermission::kReadWrite);
+}
+
 namespace {
 
 constexpr char kEngineComponent[] = "flutter_engine";
@@ -221,6 +239,10 @@ std::vector<PersistentCache::SkSLCache> PersistentCache::LoadSkSLs() const {
   std::vector<PersistentCache::SkSLCache> result;
   fml::FileVisitor visitor = [&result](const fml::UniqueFD& directory,
                                        const std::string& filename) {
+    if (ShaderCacheFile::IsCacheFileName(filename)) {
+      // Its entries are added below.
+      return true;
+    }
     sk_sp<SkData> key = ParseBase32(filename);
     sk_sp<SkData> data = LoadFile(directory, filename);
     if (key != nullptr && data != nullptr) {
@@ -242,6 +264,10 @@ std::vector<PersistentCache::SkSLCache> PersistentCache::LoadSkSLs() const {
     if (fresh_dir.is_valid()) {
       fml::VisitFiles(fresh_dir, visitor);
     }
+    if (use_shader_cache_file_) {
+      auto entries = sksl_cache_file_->GetEntries();
+      result.insert(result.end(), entries.begin(), entries.end());
+    }
   }
 
   std::unique_ptr<fml::Mapping> mapping = nullptr;
@@ -278,7 +304,10 @@ PersistentCache::PersistentCache(bool read_only)
     : is_read_only_(read_only),
       cache_directory_(MakeCacheDirectory(cache_base_path_, read_only, false)),
       sksl_cache_directory_(
-          MakeCacheDirectory(cache_base_path_, read_only, true)) {
+          MakeCacheDirectory(cache_base_path_, read_only, true)),
+      cache_file_(std::make_shared<ShaderCacheFile>(cache_directory_)),
+      sksl_cache_file_(
+          std::make_shared<ShaderCacheFile>(sksl_cache_directory_)) {
   if (!IsValid()) {
     FML_LOG(WARNING) << "Could not acquire the persistent cache directory. "
                         "Caching of GPU resources on disk is disabled.";
@@ -310,11 +339,16 @@ sk_sp<SkData> PersistentCache::load(const SkData& key) {
   if (!IsValid()) {
     return nullptr;
   }
-  auto file_name = SkKeyToFilePath(key);
-  if (file_name.size() == 0) {
-    return nullptr;
+  sk_sp<SkData> result;
+  if (use_shader_cache_file_) {
+    result = cache_file_->Find(key);
+  } else {
+    auto file_name = SkKeyToFilePath(key);
+    if (file_name.size() == 0) {
+      return nullptr;
+    }
+    result = PersistentCache::LoadFile(*cache_directory_, file_name);
   }
-  auto result = PersistentCache::LoadFile(*cache_directory_, file_name);
   if (result != nullptr) {
     TRACE_EVENT0("flutter", "PersistentCacheLoadHit");
   }
@@ -349,6 +383,19 @@ static void PersistentCacheStore(fml::RefPtr<fml::TaskRunner> worker,
   }
 }
 
+static void PersistentCacheFlush(fml::RefPtr<fml::TaskRunner> worker,
+                                 std::shared_ptr<ShaderCacheFile> cache_file) {
+  if (!worker) {
+    FML_LOG(WARNING)
+        << "The persistent cache has no available workers. Performing the task "
+           "on the current thread. This slow operation is going to occur on a "
+           "frame workload.";
+    cache_file->Flush();
+  } else {
+    worker->PostTask([cache_file]() { cache_file->Flush(); });
+  }
+}
+
 // |GrContextOptions::PersistentCache|
 void PersistentCache::store(const SkData& key, const SkData& data) {
   stored_new_shaders_ = true;
@@ -361,6 +408,17 @@ void PersistentCache::store(const SkData& key, const SkData& data) {
     return;
   }
 
+  if (use_shader_cache_file_) {
+    std::shared_ptr<ShaderCacheFile> cache_file =
+        cache_sksl_ ? sksl_cache_file_ : cache_file_;
+    // Entries are written in batches: only the first entry of a batch
+    // schedules a flush, the entries added until it runs are written with it.
+    if (cache_file->Add(key, data)) {
+      PersistentCacheFlush(GetWorkerTaskRunner(), std::move(cache_file));
+    }
+    return;
+  }
+
   auto file_name = SkKeyToFilePath(key);
 
   if (file_name.size() == 0) {
@@ -399,6 +457,14 @@ void PersistentCache::DumpSkp(const SkData& data) {
 
 void PersistentCache::AddWorkerTaskRunner(
     fml::RefPtr<fml::TaskRunner> task_runner) {
+  if (use_shader_cache_file_) {
+    // Build the index before the first frame asks for shaders.
+    task_runner->PostTask(
+        [cache_file = cache_file_, sksl_cache_file = sksl_cache_file_]() {
+          cache_file->Prefetch();
+          sksl_cache_file->Prefetch();
+        });
+  }
   std::scoped_lock lock(worker_task_runners_mutex_);
   worker_task_runners_.insert(task_runner);
 }
@@ -10,6 +10,7 @@
 #include <set>
 
 #include "flutter/assets/asset_manager.h"
+#include "flutter/common/graphics/shader_cache_file.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/task_runner.h"
 #include "flutter/fml/unique_fd.h"
@@ -66,6 +67,11 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   // Return whether the purge is successful.
   bool Purge();
 
+  // Open, and create if needed, the directory |name| inside the persistent
+  // cache directory. Like the cache directory itself, it is specific to the
+  // engine and Skia versions and its files are removed by |Purge|.
+  fml::UniqueFD OpenSubdirectory(const std::string& name) const;
+
   // |GrContextOptions::PersistentCache|
   sk_sp<SkData> load(const SkData& key) override;
 
@@ -100,9 +106,17 @@ class PersistentCache : public GrContextOptions::PersistentCache {
 
   static void SetCacheSkSL(bool value);
 
+  static bool use_shader_cache_file() { return use_shader_cache_file_; }
+
+  // Whether to keep the cache in a single |ShaderCacheFile| rather than in
+  // one file per key. Must be set before the first |load| or |store|.
+  static void SetUseShaderCacheFile(bool value);
+
   static void MarkStrategySet() { strategy_set_ = true; }
 
   static constexpr char kSkSLSubdirName[] = "sksl";
+  static constexpr char kRasterCacheSubdirName[] = "raster";
+  static constexpr char kFontSubdirName[] = "fonts";
   static constexpr char kAssetFileName[] = "io.flutter.shaders.json";
 
  private:
@@ -123,9 +137,15 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   // strategy_set_ becomes true.
   static std::atomic<bool> strategy_set_;
 
+  static std::atomic<bool> use_shader_cache_file_;
+
   const bool is_read_only_;
   const std::shared_ptr<fml::UniqueFD> cache_directory_;
   const std::shared_ptr<fml::UniqueFD> sksl_cache_directory_;
+  // The counterparts of the directories above when |use_shader_cache_file_|
+  // is set.
+  const std::shared_ptr<ShaderCacheFile> cache_file_;
+  const std::shared_ptr<ShaderCacheFile> sksl_cache_file_;
   mutable std::mutex worker_task_runners_mutex_;
   std::multiset<fml::RefPtr<fml::TaskRunner>> worker_task_runners_;
 
@@ -0,0 +1,396 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/common/graphics/shader_cache_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <string_view>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x46435346;  // "FSCF"
+constexpr uint32_t kVersion = 1;
+
+struct FileHeader {
+  uint32_t magic;
+  uint32_t version;
+};
+
+struct RecordHeader {
+  uint32_t key_size;
+  uint32_t data_size;
+  uint32_t checksum;
+};
+
+// 32-bit FNV-1a of the key and the data of a record.
+uint32_t Checksum(std::string_view key, const uint8_t* data, size_t size) {
+  uint32_t hash = 0x811c9dc5u;
+  for (char c : key) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x01000193u;
+  }
+  for (size_t i = 0; i < size; i++) {
+    hash ^= data[i];
+    hash *= 0x01000193u;
+  }
+  return hash;
+}
+
+void AppendHeader(std::vector<uint8_t>* buffer) {
+  const FileHeader header = {kMagic, kVersion};
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&header);
+  buffer->insert(buffer->end(), bytes, bytes + sizeof(header));
+}
+
+size_t RecordSize(const std::string& key, size_t data_size) {
+  return sizeof(RecordHeader) + key.size() + data_size;
+}
+
+void AppendRecord(std::vector<uint8_t>* buffer,
+                  const std::string& key,
+                  const uint8_t* data,
+                  size_t size) {
+  const RecordHeader header = {static_cast<uint32_t>(key.size()),
+                               static_cast<uint32_t>(size),
+                               Checksum(key, data, size)};
+  const uint8_t* header_bytes = reinterpret_cast<const uint8_t*>(&header);
+  buffer->insert(buffer->end(), header_bytes, header_bytes + sizeof(header));
+  buffer->insert(buffer->end(), key.begin(), key.end());
+  buffer->insert(buffer->end(), data, data + size);
+}
+
+using RecordVisitor = std::function<
+    void(const std::string& key, const uint8_t* data, size_t size)>;
+
+// Visits the valid records of a cache file and returns the offset of the
+// first byte that is not part of one, or 0 if the file has no valid header.
+size_t VisitRecords(const fml::Mapping& mapping, const RecordVisitor& visitor) {
+  const uint8_t* base = mapping.GetMapping();
+  const size_t size = mapping.GetSize();
+  FileHeader file_header;
+  if (base == nullptr || size < sizeof(file_header)) {
+    return 0;
+  }
+  memcpy(&file_header, base, sizeof(file_header));
+  if (file_header.magic != kMagic || file_header.version != kVersion) {
+    return 0;
+  }
+
+  size_t offset = sizeof(file_header);
+  while (size - offset >= sizeof(RecordHeader)) {
+    RecordHeader header;
+    memcpy(&header, base + offset, sizeof(header));
+    const size_t remaining = size - offset - sizeof(header);
+    if (header.key_size == 0 || header.key_size > remaining ||
+        header.data_size == 0 ||
+        header.data_size > remaining - header.key_size) {
+      break;
+    }
+    const uint8_t* key_bytes = base + offset + sizeof(header);
+    const std::string key(reinterpret_cast<const char*>(key_bytes),
+                          header.key_size);
+    const uint8_t* data = key_bytes + header.key_size;
+    if (Checksum(key, data, header.data_size) != header.checksum) {
+      break;
+    }
+    visitor(key, data, header.data_size);
+    offset += RecordSize(key, header.data_size);
+  }
+  return offset;
+}
+
+std::string KeyToString(const SkData& key) {
+  return std::string(reinterpret_cast<const char*>(key.data()), key.size());
+}
+
+}  // namespace
+
+bool ShaderCacheFile::IsCacheFileName(const std::string& file_name) {
+  // |fml::WriteAtomically| writes the file next to it under this name first.
+  return file_name == kFileName ||
+         file_name == std::string(kFileName) + ".temp";
+}
+
+ShaderCacheFile::ShaderCacheFile(std::shared_ptr<fml::UniqueFD> directory,
+                                 size_t max_bytes)
+    : directory_(std::move(directory)), max_bytes_(max_bytes) {}
+
+ShaderCacheFile::~ShaderCacheFile() = default;
+
+void ShaderCacheFile::Prefetch() {
+  EnsureLoaded();
+}
+
+void ShaderCacheFile::EnsureLoaded() {
+  std::call_once(load_flag_, [this]() {
+    TRACE_EVENT0("flutter", "ShaderCacheFile::Load");
+    std::scoped_lock lock(mutex_);
+    LoadFromFile();
+  });
+}
+
+void ShaderCacheFile::LoadFromFile() {
+  entries_.clear();
+  mapping_.reset();
+  file_size_ = 0;
+  needs_rewrite_ = false;
+  if (!directory_ || !directory_->is_valid()) {
+    return;
+  }
+  fml::UniqueFD file = fml::OpenFileReadOnly(*directory_, kFileName);
+  if (!file.is_valid()) {
+    return;
+  }
+  auto mapping = std::make_shared<fml::FileMapping>(file);
+  if (!mapping->IsValid()) {
+    return;
+  }
+
+  file_size_ = VisitRecords(
+      *mapping, [this](const std::string& key, const uint8_t* data,
+                       size_t size) {
+        Entry& entry = entries_[key];
+        entry.mapped_data = data;
+        entry.size = size;
+        // Records are appended as they are first used and rewritten from the
+        // least to the most recently used one, so their order is a good
+        // approximation of how recently they were used.
+        entry.last_use = ++use_clock_;
+      });
+  if (file_size_ != mapping->GetSize()) {
+    FML_LOG(WARNING) << "Ignoring " << mapping->GetSize() - file_size_
+                     << " invalid bytes at the end of the shader cache.";
+    needs_rewrite_ = true;
+  }
+  mapping_ = std::move(mapping);
+}
+
+sk_sp<SkData> ShaderCacheFile::GetData(const Entry& entry) const {
+  if (entry.data) {
+    return entry.data;
+  }
+  // The data stays valid for as long as the mapping is kept alive, even if
+  // the file is rewritten or deleted in the meantime.
+  auto* mapping = new std::shared_ptr<const fml::Mapping>(mapping_);
+  return SkData::MakeWithProc(
+      entry.mapped_data, entry.size,
+      [](const void* ptr, void* context) {
+        delete static_cast<std::shared_ptr<const fml::Mapping>*>(context);
+      },
+      mapping);
+}
+
+sk_sp<SkData> ShaderCacheFile::Find(const SkData& key) {
+  EnsureLoaded();
+  std::scoped_lock lock(mutex_);
+  auto found = entries_.find(KeyToString(key));
+  if (found == entries_.end()) {
+    return nullptr;
+  }
+  found->second.last_use = ++use_clock_;
+  return GetData(found->second);
+}
+
+bool ShaderCacheFile::Add(const SkData& key, const SkData& data) {
+  if (key.size() == 0 || data.size() == 0) {
+    return false;
+  }
+  EnsureLoaded();
+  std::scoped_lock lock(mutex_);
+  std::string key_string = KeyToString(key);
+  if (entries_.count(key_string) > 0) {
+    return false;
+  }
+  Entry& entry = entries_[key_string];
+  entry.data = SkData::MakeWithCopy(data.data(), data.size());
+  entry.size = data.size();
+  entry.last_use = ++use_clock_;
+  pending_keys_.push_back(std::move(key_string));
+  return pending_keys_.size() == 1;
+}
+
+void ShaderCacheFile::Flush() {
+  TRACE_EVENT0("flutter", "ShaderCacheFile::Flush");
+  EnsureLoaded();
+  std::scoped_lock write_lock(write_mutex_);
+
+  std::vector<uint8_t> records;
+  size_t file_size;
+  bool compact;
+  {
+    std::scoped_lock lock(mutex_);
+    if (pending_keys_.empty()) {
+      return;
+    }
+    file_size = file_size_;
+    if (file_size == 0) {
+      AppendHeader(&records);
+    }
+    for (const std::string& key : pending_keys_) {
+      auto found = entries_.find(key);
+      if (found != entries_.end() && found->second.data) {
+        AppendRecord(&records, key, found->second.data->bytes(),
+                     found->second.size);
+      }
+    }
+    pending_keys_.clear();
+    compact = needs_rewrite_ || file_size + records.size() > max_bytes_;
+  }
+  if (!directory_ || !directory_->is_valid()) {
+    return;
+  }
+  if (compact) {
+    Compact();
+    return;
+  }
+
+  // Appending through a shared mapping writes the whole batch with a single
+  // resize of the file.
+  const size_t new_file_size = file_size + records.size();
+  fml::UniqueFD file = fml::OpenFile(*directory_, kFileName, true,
+                                     fml::FilePermission::kReadWrite);
+  bool written = false;
+  if (file.is_valid() && fml::TruncateFile(file, new_file_size)) {
+    fml::FileMapping mapping(
+        file, {fml::FileMapping::Protection::kRead,
+               fml::FileMapping::Protection::kWrite});
+    if (mapping.GetMutableMapping() != nullptr &&
+        mapping.GetSize() == new_file_size) {
+      memcpy(mapping.GetMutableMapping() + file_size, records.data(),
+             records.size());
+      written = true;
+    }
+  }
+
+  std::scoped_lock lock(mutex_);
+  if (written) {
+    file_size_ = new_file_size;
+  } else {
+    FML_LOG(WARNING) << "Could not append to the shader cache.";
+    // The entries are still in memory, the next flush writes them out.
+    needs_rewrite_ = true;
+  }
+}
+
+void ShaderCacheFile::Compact() {
+  TRACE_EVENT0("flutter", "ShaderCacheFile::Compact");
+  struct LiveEntry {
+    std::string key;
+    sk_sp<SkData> data;
+    uint64_t last_use;
+  };
+  std::vector<LiveEntry> live_entries;
+  {
+    std::scoped_lock lock(mutex_);
+    live_entries.reserve(entries_.size());
+    for (const auto& entry : entries_) {
+      live_entries.push_back(
+          {entry.first, GetData(entry.second), entry.second.last_use});
+    }
+  }
+
+  // Keep the most recently used entries, leaving room for new ones so that
+  // the next flushes can append again.
+  std::sort(live_entries.begin(), live_entries.end(),
+            [](const LiveEntry& a, const LiveEntry& b) {
+              return a.last_use > b.last_use;
+            });
+  const size_t budget = max_bytes_ / 4 * 3;
+  size_t kept_bytes = sizeof(FileHeader);
+  size_t kept_count = 0;
+  while (kept_count < live_entries.size()) {
+    const LiveEntry& entry = live_entries[kept_count];
+    const size_t record_size = RecordSize(entry.key, entry.data->size());
+    if (kept_bytes + record_size > budget) {
+      break;
+    }
+    kept_bytes += record_size;
+    kept_count++;
+  }
+
+  std::vector<uint8_t> buffer;
+  buffer.reserve(kept_bytes);
+  AppendHeader(&buffer);
+  for (size_t i = kept_count; i > 0; i--) {
+    const LiveEntry& entry = live_entries[i - 1];
+    AppendRecord(&buffer, entry.key, entry.data->bytes(), entry.data->size());
+  }
+  if (!fml::WriteAtomically(*directory_, kFileName,
+                            fml::DataMapping(std::move(buffer)))) {
+    FML_LOG(WARNING) << "Could not rewrite the shader cache.";
+    std::scoped_lock lock(mutex_);
+    needs_rewrite_ = true;
+    return;
+  }
+
+  std::shared_ptr<const fml::Mapping> mapping =
+      fml::FileMapping::CreateReadOnly(*directory_, kFileName);
+  std::scoped_lock lock(mutex_);
+  for (size_t i = kept_count; i < live_entries.size(); i++) {
+    entries_.erase(live_entries[i].key);
+  }
+  file_size_ = kept_bytes;
+  needs_rewrite_ = false;
+  if (!mapping) {
+    return;
+  }
+  // Serve the entries from the new file rather than from memory. Entries
+  // added while the file was written stay in memory until the next flush.
+  VisitRecords(*mapping, [this](const std::string& key, const uint8_t* data,
+                                size_t size) {
+    auto found = entries_.find(key);
+    if (found != entries_.end()) {
+      found->second.mapped_data = data;
+      found->second.data.reset();
+    }
+  });
+  mapping_ = std::move(mapping);
+}
+
+void ShaderCacheFile::Clear() {
+  EnsureLoaded();
+  std::scoped_lock write_lock(write_mutex_);
+  std::scoped_lock lock(mutex_);
+  entries_.clear();
+  pending_keys_.clear();
+  mapping_.reset();
+  file_size_ = 0;
+  needs_rewrite_ = false;
+}
+
+std::vector<std::pair<sk_sp<SkData>, sk_sp<SkData>>>
+ShaderCacheFile::GetEntries() {
+  EnsureLoaded();
+  std::vector<std::pair<sk_sp<SkData>, sk_sp<SkData>>> result;
+  std::scoped_lock lock(mutex_);
+  result.reserve(entries_.size());
+  for (const auto& entry : entries_) {
+    result.emplace_back(
+        SkData::MakeWithCopy(entry.first.data(), entry.first.size()),
+        GetData(entry.second));
+  }
+  return result;
+}
+
+size_t ShaderCacheFile::GetEntryCount() {
+  EnsureLoaded();
+  std::scoped_lock lock(mutex_);
+  return entries_.size();
+}
+
+size_t ShaderCacheFile::GetFileSize() {
+  EnsureLoaded();
+  std::scoped_lock lock(mutex_);
+  return file_size_;
+}
+
+}  // namespace flutter
@@ -0,0 +1,123 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_COMMON_GRAPHICS_SHADER_CACHE_FILE_H_
+#define FLUTTER_COMMON_GRAPHICS_SHADER_CACHE_FILE_H_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+#include "third_party/skia/include/core/SkData.h"
+
+namespace flutter {
+
+/// The entries of a |PersistentCache| kept in a single file instead of one
+/// file per key.
+///
+/// The file is a header followed by records of a key and its data. New
+/// entries are appended in batches by |Flush|. The file is mapped once,
+/// either by |Prefetch| on a worker or by the first |Find|, and an in-memory
+/// index of the keys points into the mapping, so finding an entry does not
+/// touch the file system. Records that were cut short, e.g. because the
+/// process died while appending them, are ignored and dropped by the next
+/// |Flush|.
+///
+/// When the file would grow past its size limit, |Flush| rewrites it with
+/// only the most recently used entries. This class is thread-safe.
+class ShaderCacheFile {
+ public:
+  static constexpr char kFileName[] = "shaders.cache";
+  static constexpr size_t kDefaultMaxBytes = 16 * 1024 * 1024;
+
+  /// Whether |file_name| is the name of the file, or of the temporary file
+  /// it is rewritten into, in the directory the file is kept in.
+  static bool IsCacheFileName(const std::string& file_name);
+
+  explicit ShaderCacheFile(std::shared_ptr<fml::UniqueFD> directory,
+                           size_t max_bytes = kDefaultMaxBytes);
+
+  ~ShaderCacheFile();
+
+  /// Maps the file and builds the index if that has not happened yet. Meant
+  /// to be called on a worker ahead of the first |Find|.
+  void Prefetch();
+
+  /// Returns the data of the entry with |key|, or null if there is none.
+  sk_sp<SkData> Find(const SkData& key);
+
+  /// Adds an entry that will be written to the file by the next |Flush|.
+  /// Returns true if no other entries are waiting to be written, in which
+  /// case the caller is responsible for scheduling a |Flush|.
+  bool Add(const SkData& key, const SkData& data);
+
+  /// Writes the entries added since the last flush to the file. Must not be
+  /// called on the thread that renders frames.
+  void Flush();
+
+  /// Forgets all the entries. Used after the file has been deleted.
+  void Clear();
+
+  /// Returns the keys and the data of all the entries.
+  std::vector<std::pair<sk_sp<SkData>, sk_sp<SkData>>> GetEntries();
+
+  size_t GetEntryCount();
+
+  /// The size of the file in bytes, as far as it is known to be valid.
+  size_t GetFileSize();
+
+  size_t max_bytes() const { return max_bytes_; }
+
+ private:
+  struct Entry {
+    // Either points into |mapping_| or is owned by |data|, for entries that
+    // were added since the file was mapped.
+    const uint8_t* mapped_data = nullptr;
+    sk_sp<SkData> data;
+    size_t size = 0;
+    // Entries with a lower value were used less recently.
+    uint64_t last_use = 0;
+  };
+
+  const std::shared_ptr<fml::UniqueFD> directory_;
+  const size_t max_bytes_;
+
+  std::once_flag load_flag_;
+  // Serializes the writes to the file. Acquired before |mutex_|.
+  std::mutex write_mutex_;
+
+  std::mutex mutex_;
+  std::shared_ptr<const fml::Mapping> mapping_;
+  std::unordered_map<std::string, Entry> entries_;
+  std::vector<std::string> pending_keys_;
+  size_t file_size_ = 0;
+  // Whether the file has invalid records at its end, so that it has to be
+  // rewritten rather than appended to.
+  bool needs_rewrite_ = false;
+  uint64_t use_clock_ = 0;
+
+  void EnsureLoaded();
+
+  // Maps the file and replaces the index with its entries. Must be called
+  // with |mutex_| held.
+  void LoadFromFile();
+
+  sk_sp<SkData> GetData(const Entry& entry) const;
+
+  // Rewrites the file with the most recently used entries that fit in three
+  // quarters of |max_bytes_|. Must be called with |write_mutex_| held.
+  void Compact();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ShaderCacheFile);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_COMMON_GRAPHICS_SHADER_CACHE_FILE_H_
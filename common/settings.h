@@ -107,6 +107,10 @@ struct Settings {
   std::string trace_allowlist;
   bool trace_startup = false;
   bool trace_systrace = false;
+  // If not empty, the path of the file trace events are recorded into
+  // instead of the timeline. The file is complete once the last shell
+  // recording into it has been destroyed.
+  std::string trace_to_file;
   bool dump_skp_on_shader_compilation = false;
   bool cache_sksl = false;
   bool purge_persistent_cache = false;
@@ -158,6 +162,47 @@ struct Settings {
   // Selects the SkParagraph implementation of the text layout engine.
   bool enable_skparagraph = false;
 
+  // Records the pictures drawn by the framework as display lists, which
+  // layer tree diffing and the raster cache can compare by their contents,
+  // instead of as Skia pictures. See |DisplayList|.
+  bool enable_display_list = false;
+
+  // Batches the drawing calls made on a Dart canvas into a command buffer
+  // that is sent to the engine in one native call per picture, or whenever
+  // the buffer is full, instead of one native call per drawing call.
+  bool enable_canvas_command_buffer = false;
+
+  // When the rasterizer falls behind, replace the layer tree waiting to be
+  // rasterized with the newest one instead of queueing layer trees and
+  // blocking the UI thread. See |PipelineMode::Mailbox|.
+  bool enable_mailbox_pipeline = false;
+
+  // Delay the build of each frame within the frame interval by the time
+  // recent frames did not need, so that frames handle input dispatched as
+  // late as possible and are still presented on time. See
+  // |FrameSchedulingMode::LatencyAware|.
+  bool enable_latency_aware_frame_scheduling = false;
+
+  // Store expensive static pictures rasterized by the raster cache on disk,
+  // and restore them on later launches instead of rasterizing them again. See
+  // |PersistentRasterCache|.
+  bool enable_persistent_raster_cache = false;
+
+  // The budget for the sum of the bytes of the images cached by the raster
+  // cache. When it is exceeded at the end of a frame, the least recently used
+  // images are evicted first. Zero places no limit on the size of the cache.
+  size_t raster_cache_max_bytes = 0;
+
+  // The number of consecutive frames an image cached by the raster cache may
+  // go unused and still be retained while the cache is within its budget.
+  // Zero evicts images at the end of the first frame that does not use them.
+  size_t raster_cache_max_unused_frames = 0;
+
+  // Keep the persistent shader cache in a single file with an index that is
+  // loaded once, instead of reading one file per shader as Skia asks for
+  // them. See |ShaderCacheFile|.
+  bool enable_shader_cache_file = false;
+
   // All shells in the process share the same VM. The last shell to shutdown
   // should typically shut down the VM as well. However, applications depend on
   // the behavior of "warming-up" the VM by creating a shell that does not do
@@ -210,6 +255,13 @@ struct Settings {
   // calls in this callback will cause applications to jank.
   LogMessageCallback log_message_callback;
   bool enable_software_rendering = false;
+  // The number of horizontal bands the software backend rasterizes frames in
+  // concurrently. Frames are rasterized on the raster thread alone if 1.
+  size_t software_raster_tile_count = 1;
+  // Coalesce the pointer move events of each frame and resample them to the
+  // frame instead of dispatching them as the platform delivers them. See
+  // |ResamplingPointerDataDispatcher|.
+  bool enable_pointer_resampling = false;
   bool skia_deterministic_rendering_on_cpu = false;
   bool verbose_logging = false;
   std::string log_tag = "flutter";
@@ -4,13 +4,22 @@
 
 #include "flutter/flow/compositor_context.h"
 
+#include <optional>
+
 #include "flutter/flow/layers/layer_tree.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 
 namespace flutter {
 
-CompositorContext::CompositorContext(fml::Milliseconds frame_budget)
-    : raster_time_(frame_budget), ui_time_(frame_budget) {}
+CompositorContext::CompositorContext(fml::Milliseconds frame_budget,
+                                     size_t raster_cache_max_bytes,
+                                     size_t raster_cache_max_unused_frames)
+    : raster_cache_(/*access_threshold=*/3,
+                    RasterCache::kDefaultPictureCacheLimitPerFrame,
+                    raster_cache_max_bytes,
+                    raster_cache_max_unused_frames),
+      raster_time_(frame_budget),
+      ui_time_(frame_budget) {}
 
 CompositorContext::~CompositorContext() = default;
 
@@ -69,7 +78,8 @@ CompositorContext::ScopedFrame::~ScopedFrame() {
 
 RasterStatus CompositorContext::ScopedFrame::Raster(
     flutter::LayerTree& layer_tree,
-    bool ignore_raster_cache) {
+    bool ignore_raster_cache,
+    const SkIRect* clip_rect) {
   TRACE_EVENT0("flutter", "CompositorContext::ScopedFrame::Raster");
   bool root_needs_readback = layer_tree.Preroll(*this, ignore_raster_cache);
   bool needs_save_layer = root_needs_readback && !surface_supports_readback();
@@ -87,10 +97,16 @@ RasterStatus CompositorContext::ScopedFrame::Raster(
   }
   // Clearing canvas after preroll reduces one render target switch when preroll
   // paints some raster cache.
+  std::optional<SkAutoCanvasRestore> clip_restore;
   if (canvas()) {
+    if (clip_rect) {
+      clip_restore.emplace(canvas(), true);
+      canvas()->clipRect(SkRect::Make(*clip_rect));
+    }
     if (needs_save_layer) {
       FML_LOG(INFO) << "Using SaveLayer to protect non-readback surface";
-      SkRect bounds = SkRect::Make(layer_tree.frame_size());
+      SkRect bounds = clip_rect ? SkRect::Make(*clip_rect)
+                                : SkRect::Make(layer_tree.frame_size());
       SkPaint paint;
       paint.setBlendMode(SkBlendMode::kSrc);
       canvas()->saveLayer(&bounds, &paint);
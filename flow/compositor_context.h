@@ -79,8 +79,12 @@ class CompositorContext {
 
     GrDirectContext* gr_context() const { return gr_context_; }
 
+    // Prerolls and paints |layer_tree| into the frame canvas. If |clip_rect|
+    // is not null, only that region of the canvas, in device coordinates, is
+    // cleared and repainted.
     virtual RasterStatus Raster(LayerTree& layer_tree,
-                                bool ignore_raster_cache);
+                                bool ignore_raster_cache,
+                                const SkIRect* clip_rect);
 
    private:
     CompositorContext& context_;
@@ -95,7 +99,11 @@ class CompositorContext {
     FML_DISALLOW_COPY_AND_ASSIGN(ScopedFrame);
   };
 
-  CompositorContext(fml::Milliseconds frame_budget = fml::kDefaultFrameBudget);
+  CompositorContext(
+      fml::Milliseconds frame_budget = fml::kDefaultFrameBudget,
+      size_t raster_cache_max_bytes = RasterCache::kUnlimitedCacheBytes,
+      size_t raster_cache_max_unused_frames =
+          RasterCache::kDefaultMaxUnusedFrames);
 
   virtual ~CompositorContext();
 
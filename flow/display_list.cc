@@ -0,0 +1,1348 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/display_list.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+#include "flutter/flow/layers/physical_shape_layer.h"
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/logging.h"
+#include "third_party/skia/include/core/SkDrawable.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkImageFilter.h"
+#include "third_party/skia/include/core/SkM44.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkRRect.h"
+#include "third_party/skia/include/core/SkRSXform.h"
+#include "third_party/skia/include/core/SkRegion.h"
+#include "third_party/skia/include/core/SkTextBlob.h"
+#include "third_party/skia/include/core/SkVertices.h"
+
+namespace flutter {
+
+namespace {
+
+// All the operations start at a multiple of this, which is enough for the
+// pointers and floats they contain.
+constexpr size_t kOpAlignment = 8;
+
+// The buffer of a recorder starts at this size and doubles as it fills up.
+constexpr size_t kInitialBufferBytes = 512;
+
+size_t AlignOpSize(size_t size) {
+  return (size + kOpAlignment - 1) & ~(kOpAlignment - 1);
+}
+
+#define FOR_EACH_DISPLAY_LIST_OP(V) \
+  V(Save)                           \
+  V(SaveLayer)                      \
+  V(Restore)                        \
+  V(Translate)                      \
+  V(Scale)                          \
+  V(Concat)                         \
+  V(SetMatrix)                      \
+  V(ClipRect)                       \
+  V(ClipRRect)                      \
+  V(ClipPath)                       \
+  V(DrawPaint)                      \
+  V(DrawRect)                       \
+  V(DrawOval)                       \
+  V(DrawRRect)                      \
+  V(DrawDRRect)                     \
+  V(DrawArc)                        \
+  V(DrawPath)                       \
+  V(DrawPoints)                     \
+  V(DrawVertices)                   \
+  V(DrawPatch)                      \
+  V(DrawImage)                      \
+  V(DrawImageRect)                  \
+  V(DrawImageLattice)               \
+  V(DrawAtlas)                      \
+  V(DrawEdgeAAQuad)                 \
+  V(DrawTextBlob)                   \
+  V(DrawPicture)                    \
+  V(DrawDisplayList)                \
+  V(DrawShadow)
+
+enum class OpType : uint32_t {
+#define DISPLAY_LIST_OP_TYPE(name) k##name,
+  FOR_EACH_DISPLAY_LIST_OP(DISPLAY_LIST_OP_TYPE)
+#undef DISPLAY_LIST_OP_TYPE
+};
+
+// Precedes every operation in the buffer. |size| covers the header, the
+// operation and the data that follows it, e.g. the points of |DrawPoints|.
+struct OpHeader {
+  OpType type;
+  uint32_t size;
+};
+
+static_assert(sizeof(OpHeader) == kOpAlignment);
+
+struct RenderContext {
+  SkCanvas* canvas;
+  // The transformation of the canvas before the display list was drawn, which
+  // |SetMatrix| operations are relative to.
+  SkM44 initial_matrix;
+};
+
+const SkPaint* AsPointer(const std::optional<SkPaint>& paint) {
+  return paint ? &*paint : nullptr;
+}
+
+// Every operation is an aggregate with the following members:
+//  - |kType|, its |OpType|.
+//  - |kIsDraw|, whether it draws. Drawing operations start with the |bounds|
+//    of what they draw in the coordinate space of the display list.
+//  - |Fields|, a tuple of all the members that affect what is drawn, which
+//    is used to compare and hash the operation.
+//  - |Render|, which replays the operation given the data that follows it.
+
+struct SaveOp {
+  static constexpr OpType kType = OpType::kSave;
+  static constexpr bool kIsDraw = false;
+
+  auto Fields() const { return std::tie(); }
+
+  void Render(RenderContext& context, const uint8_t*) const {
+    context.canvas->save();
+  }
+};
+
+struct SaveLayerOp {
+  static constexpr OpType kType = OpType::kSaveLayer;
+  static constexpr bool kIsDraw = false;
+
+  std::optional<SkRect> layer_bounds;
+  std::optional<SkPaint> paint;
+  sk_sp<SkImageFilter> backdrop;
+  SkCanvas::SaveLayerFlags flags;
+
+  auto Fields() const { return std::tie(layer_bounds, paint, backdrop, flags); }
+
+  void Render(RenderContext& context, const uint8_t*) const {
+    context.canvas->saveLayer(SkCanvas::SaveLayerRec(
+        layer_bounds ? &*layer_bounds : nullptr, AsPointer(paint),
+        backdrop.get(), flags));
+  }
+};
+
+struct RestoreOp {
+  static constexpr OpType kType = OpType::kRestore;
+  static constexpr bool kIsDraw = false;
+
+  auto Fields() const { return std::tie(); }
+
+  void Render(RenderContext& context, const uint8_t*) const {
+    context.canvas->restore();
+  }
+};
+
+struct TranslateOp {
+  static constexpr OpType kType = OpType::kTranslate;
+  static constexpr bool kIsDraw = false;
+
+  SkScalar dx;
+  SkScalar dy;
+
+  auto Fields() const { return std::tie(dx, dy); }
+
+  void Render(RenderContext& context, const uint8_t*) const {
+    context.canvas->translate(dx, dy);
+  }
+};
+
+struct ScaleOp {
+  static constexpr OpType kType = OpType::kScale;
+  static constexpr bool kIsDraw = false;
+
+  SkScalar sx;
+  SkScalar sy;
+
+  auto Fields() const { return std::tie(sx, sy); }
+
+  void Render(RenderContext& context, const uint8_t*) const {
+    context.canvas->scale(sx, sy);
+  }
+};
+
+struct ConcatOp {
+  static constexpr OpType kType = OpType::kConcat;
+  static constexpr bool kIsDraw = false;
+
+  SkM44 matrix;
+
+  auto Fields() const { return std::tie(matrix); }
+
+  void Render(RenderContext& context, const uint8_t*) const {
+    context.canvas->concat(matrix);
+  }
+};
+
+struct SetMatrixOp {
+  static constexpr OpType kType = OpType::kSetMatrix;
+  static constexpr bool kIsDraw = false;
+
+  SkM44 matrix;
+
+  auto Fields() const { return std::tie(matrix); }
+
+  void Render(RenderContext& context, const uint8_t*) const {
+    context.canvas->setMatrix(context.initial_matrix * matrix);
+  }
+};
+
+struct ClipRectOp {
+  static constexpr OpType kType = OpType::kClipRect;
+  static constexpr bool kIsDraw = false;
+
+  SkRect rect;
+  SkClipOp op;
+  bool anti_alias;
+
+  auto Fields() const { return std::tie(rect, op, anti_alias); }
+
+  void Render(RenderContext& context, const uint8_t*) const {
+    context.canvas->clipRect(rect, op, anti_alias);
+  }
+};
+
+struct ClipRRectOp {
+  static constexpr OpType kType = OpType::kClipRRect;
+  static constexpr bool kIsDraw = false;
+
+  SkRRect rrect;
+  SkClipOp op;
+  bool anti_alias;
+
+  auto Fields() const { return std::tie(rrect, op, anti_alias); }
+
+  void Render(RenderContext& context, const uint8_t*) const {
+    context.canvas->clipRRect(rrect, op, anti_alias);
+  }
+};
+
+struct ClipPathOp {
+  static constexpr OpType kType = OpType::kClipPath;
+  static constexpr bool kIsDraw = false;
+
+  SkPath path;
+  SkClipOp op;
+  bool anti_alias;
+
+  auto Fields() const { return std::tie(path, op, anti_alias); }
+
+  void Render(RenderContext& context, const uint8_t*) const {
+    context.canvas->clipPath(path, op, anti_alias);
+  }
+};
+
+struct DrawPaintOp {
+  static constexpr OpType kType = OpType::kDrawPaint;
+  static constexpr bool kIsDraw = true;
+
+  SkRect bounds;
+  SkPaint paint;
+
+  auto Fields() const { return std::tie(paint); }
+
+  void Render(RenderContext& context, const uint8_t*) const {
+    context.canvas->drawPaint(paint);
+  }
+};
+
+struct DrawRectOp {
+  static constexpr OpType kType = OpType::kDrawRect;
+  static constexpr bool kIsDraw = true;
+
+  SkRect bounds;
+  SkRect rect;
+  SkPaint paint;
+
+  auto Fields() const { return std::tie(rect, paint); }
+
+  void Render(RenderContext& context, const uint8_t*) const {
+    context.canvas->drawRect(rect, paint);
+  }
+};
+
+struct DrawOvalOp {
+  static constexpr OpType kType = OpType::kDrawOval;
+  static constexpr bool kIsDraw = true;
+
+  SkRect bounds;
+  SkRect oval;
+  SkPaint paint;
+
+  auto Fields() const { return std::tie(oval, paint); }
+
+  void Render(RenderContext& context, const uint8_t*) const {
+    context.canvas->drawOval(oval, paint);
+  }
+};
+
+struct DrawRRectOp {
+  static constexpr OpType kType = OpType::kDrawRRect;
+  static constexpr bool kIsDraw = true;
+
+  SkRect bounds;
+  SkRRect rrect;
+  SkPaint paint;
+
+  auto Fields() const { return std::tie(rrect, paint); }
+
+  void Render(RenderContext& context, const uint8_t*) const {
+    context.canvas->drawRRect(rrect, paint);
+  }
+};
+
+struct DrawDRRectOp {
+  static constexpr OpType kType = OpType::kDrawDRRect;
+  static constexpr bool kIsDraw = true;
+
+  SkRect bounds;
+  SkRRect outer;
+  SkRRect inner;
+  SkPaint paint;
+
+  auto Fields() const { return std::tie(outer, inner, paint); }
+
+  void Render(RenderContext& context, const uint8_t*) const {
+    context.canvas->drawDRRect(outer, inner, paint);
+  }
+};
+
+struct DrawArcOp {
+  static constexpr OpType kType = OpType::kDrawArc;
+  static constexpr bool kIsDraw = true;
+
+  SkRect bounds;
+  SkRect oval;
+  SkScalar start_angle;
+  SkScalar sweep_angle;
+  bool use_center;
+  SkPaint paint;
+
+  auto Fields() const {
+    return std::tie(oval, start_angle, sweep_angle, use_center, paint);
+  }
+
+  void Render(RenderContext& context, const uint8_t*) const {
+    context.canvas->drawArc(oval, start_angle, sweep_angle, use_center, paint);
+  }
+};
+
+struct DrawPathOp {
+  static constexpr OpType kType = OpType::kDrawPath;
+  static constexpr bool kIsDraw = true;
+
+  SkRect bounds;
+  SkPath path;
+  SkPaint paint;
+
+  auto Fields() const { return std::tie(path, paint); }
+
+  void Render(RenderContext& context, const uint8_t*) const {
+    context.canvas->drawPath(path, paint);
+  }
+};
+
+// Followed by |count| points.
+struct DrawPointsOp {
+  static constexpr OpType kType = OpType::kDrawPoints;
+  static constexpr bool kIsDraw = true;
+
+  SkRect bounds;
+  SkCanvas::PointMode mode;
+  uint32_t count;
+  SkPaint paint;
+
+  auto Fields() const { return std::tie(mode, count, paint); }
+
+  void Render(RenderContext& context, const uint8_t* data) const {
+    context.canvas->drawPoints(mode, count,
+                               reinterpret_cast<const SkPoint*>(data), paint);
+  }
+};
+
+struct DrawVerticesOp {
+  static constexpr OpType kType = OpType::kDrawVertices;
+  static constexpr bool kIsDraw = true;
+
+  SkRect bounds;
+  sk_sp<SkVertices> vertices;
+  SkBlendMode mode;
+  SkPaint paint;
+
+  auto Fields() const { return std::tie(vertices, mode, paint); }
+
+  void Render(RenderContext& context, const uint8_t*) const {
+    context.canvas->drawVertices(vertices, mode, paint);
+  }
+};
+
+// Followed by the 12 points of the cubics, the 4 colors if |has_colors| and
+// the 4 texture coordinates if |has_texture_coordinates|.
+struct DrawPatchOp {
+  static constexpr OpType kType = OpType::kDrawPatch;
+  static constexpr bool kIsDraw = true;
+
+  SkRect bounds;
+  bool has_colors;
+  bool has_texture_coordinates;
+  SkBlendMode mode;
+  SkPaint paint;
+
+  auto Fields() const {
+    return std::tie(has_colors, has_texture_coordinates, mode, paint);
+  }
+
+  void Render(RenderContext& context, const uint8_t* data) const {
+    const SkPoint* cubics = reinterpret_cast<const SkPoint*>(data);
+    data += 12 * sizeof(SkPoint);
+    const SkColor* colors = nullptr;
+    if (has_colors) {
+      colors = reinterpret_cast<const SkColor*>(data);
+      data += 4 * sizeof(SkColor);
+    }
+    const SkPoint* texture_coordinates =
+        has_texture_coordinates ? reinterpret_cast<const SkPoint*>(data)
+                                : nullptr;
+    context.canvas->drawPatch(cubics, colors, texture_coordinates, mode,
+                              paint);
+  }
+};
+
+struct DrawImageOp {
+  static constexpr OpType kType = OpType::kDrawImage;
+  static constexpr bool kIsDraw = true;
+
+  SkRect bounds;
+  sk_sp<SkImage> image;
+  SkScalar left;
+  SkScalar top;
+  SkSamplingOptions sampling;
+  std::optional<SkPaint> paint;
+
+  auto Fields() const { return std::tie(image, left, top, sampling, paint); }
+
+  void Render(RenderContext& context, const uint8_t*) const {
+    context.canvas->drawImage(image.get(), left, top, sampling,
+                              AsPointer(paint));
+  }
+};
+
+struct DrawImageRectOp {
+  static constexpr OpType kType = OpType::kDrawImageRect;
+  static constexpr bool kIsDraw = true;
+
+  SkRect bounds;
+  sk_sp<SkImage> image;
+  SkRect src;
+  SkRect dst;
+  SkSamplingOptions sampling;
+  std::optional<SkPaint> paint;
+  SkCanvas::SrcRectConstraint constraint;
+
+  auto Fields() const {
+    return std::tie(image, src, dst, sampling, paint, constraint);
+  }
+
+  void Render(RenderContext& context, const uint8_t*) const {
+    context.canvas->drawImageRect(image.get(), src, dst, sampling,
+                                  AsPointer(paint), constraint);
+  }
+};
+
+// Followed by the |x_count| x divs, the |y_count| y divs, the |cell_count|
+// colors if |has_colors| and the |cell_count| rect types.
+struct DrawImageLatticeOp {
+  static constexpr OpType kType = OpType::kDrawImageLattice;
+  static constexpr bool kIsDraw = true;
+
+  SkRect bounds;
+  sk_sp<SkImage> image;
+  SkRect dst;
+  SkFilterMode filter;
+  std::optional<SkPaint> paint;
+  std::optional<SkIRect> lattice_bounds;
+  uint32_t x_count;
+  uint32_t y_count;
+  uint32_t cell_count;
+  bool has_colors;
+
+  auto Fields() const {
+    return std::tie(image, dst, filter, paint, lattice_bounds, x_count,
+                    y_count, cell_count, has_colors);
+  }
+
+  void Render(RenderContext& context, const uint8_t* data) const {
+    SkCanvas::Lattice lattice = {};
+    lattice.fXCount = x_count;
+    lattice.fYCount = y_count;
+    lattice.fXDivs = reinterpret_cast<const int*>(data);
+    data += x_count * sizeof(int);
+    lattice.fYDivs = reinterpret_cast<const int*>(data);
+    data += y_count * sizeof(int);
+    if (has_colors) {
+      lattice.fColors = reinterpret_cast<const SkColor*>(data);
+      data += cell_count * sizeof(SkColor);
+    }
+    if (cell_count > 0) {
+      lattice.fRectTypes =
+          reinterpret_cast<const SkCanvas::Lattice::RectType*>(data);
+    }
+    lattice.fBounds = lattice_bounds ? &*lattice_bounds : nullptr;
+    context.canvas->drawImageLattice(image.get(), lattice, dst, filter,
+                                     AsPointer(paint));
+  }
+};
+
+// Followed by the |count| transforms, the |count| texture rects and the
+// |count| colors if |has_colors|.
+struct DrawAtlasOp {
+  static constexpr OpType kType = OpType::kDrawAtlas;
+  static constexpr bool kIsDraw = true;
+
+  SkRect bounds;
+  sk_sp<SkImage> atlas;
+  uint32_t count;
+  bool has_colors;
+  SkBlendMode mode;
+  SkSamplingOptions sampling;
+  std::optional<SkRect> cull;
+  std::optional<SkPaint> paint;
+
+  auto Fields() const {
+    return std::tie(atlas, count, has_colors, mode, sampling, cull, paint);
+  }
+
+  void Render(RenderContext& context, const uint8_t* data) const {
+    const SkRSXform* transforms = reinterpret_cast<const SkRSXform*>(data);
+    data += count * sizeof(SkRSXform);
+    const SkRect* texture_rects = reinterpret_cast<const SkRect*>(data);
+    data += count * sizeof(SkRect);
+    const SkColor* colors =
+        has_colors ? reinterpret_cast<const SkColor*>(data) : nullptr;
+    context.canvas->drawAtlas(atlas.get(), transforms, texture_rects, colors,
+                              count, mode, sampling, cull ? &*cull : nullptr,
+                              AsPointer(paint));
+  }
+};
+
+// Followed by the 4 points of the clip if |has_clip|.
+struct DrawEdgeAAQuadOp {
+  static constexpr OpType kType = OpType::kDrawEdgeAAQuad;
+  static constexpr bool kIsDraw = true;
+
+  SkRect bounds;
+  SkRect rect;
+  bool has_clip;
+  SkCanvas::QuadAAFlags aa_flags;
+  SkColor4f color;
+  SkBlendMode mode;
+
+  auto Fields() const {
+    return std::tie(rect, has_clip, aa_flags, color, mode);
+  }
+
+  void Render(RenderContext& context, const uint8_t* data) const {
+    context.canvas->experimental_DrawEdgeAAQuad(
+        rect, has_clip ? reinterpret_cast<const SkPoint*>(data) : nullptr,
+        aa_flags, color, mode);
+  }
+};
+
+struct DrawTextBlobOp {
+  static constexpr OpType kType = OpType::kDrawTextBlob;
+  static constexpr bool kIsDraw = true;
+
+  SkRect bounds;
+  sk_sp<SkTextBlob> blob;
+  SkScalar x;
+  SkScalar y;
+  SkPaint paint;
+
+  auto Fields() const { return std::tie(blob, x, y, paint); }
+
+  void Render(RenderContext& context, const uint8_t*) const {
+    context.canvas->drawTextBlob(blob.get(), x, y, paint);
+  }
+};
+
+struct DrawPictureOp {
+  static constexpr OpType kType = OpType::kDrawPicture;
+  static constexpr bool kIsDraw = true;
+
+  SkRect bounds;
+  sk_sp<SkPicture> picture;
+  std::optional<SkMatrix> matrix;
+  std::optional<SkPaint> paint;
+
+  auto Fields() const { return std::tie(picture, matrix, paint); }
+
+  void Render(RenderContext& context, const uint8_t*) const {
+    context.canvas->drawPicture(picture.get(), matrix ? &*matrix : nullptr,
+                                AsPointer(paint));
+  }
+};
+
+struct DrawDisplayListOp {
+  static constexpr OpType kType = OpType::kDrawDisplayList;
+  static constexpr bool kIsDraw = true;
+
+  SkRect bounds;
+  sk_sp<DisplayList> display_list;
+
+  auto Fields() const { return std::tie(display_list); }
+
+  void Render(RenderContext& context, const uint8_t*) const {
+    display_list->RenderTo(context.canvas);
+  }
+};
+
+struct DrawShadowOp {
+  static constexpr OpType kType = OpType::kDrawShadow;
+  static constexpr bool kIsDraw = true;
+
+  SkRect bounds;
+  SkPath path;
+  SkColor color;
+  float elevation;
+  bool transparent_occluder;
+  SkScalar dpr;
+
+  auto Fields() const {
+    return std::tie(path, color, elevation, transparent_occluder, dpr);
+  }
+
+  void Render(RenderContext& context, const uint8_t*) const {
+    PhysicalShapeLayer::DrawShadow(context.canvas, path, color, elevation,
+                                   transparent_occluder, dpr);
+  }
+};
+
+// Calls |visitor| with the operation that follows |header|.
+template <typename Visitor>
+void VisitOp(const OpHeader* header, Visitor&& visitor) {
+  const void* op = header + 1;
+  switch (header->type) {
+#define DISPLAY_LIST_VISIT_OP(name)                    \
+  case OpType::k##name:                                \
+    visitor(*static_cast<const name##Op*>(op));        \
+    return;
+    FOR_EACH_DISPLAY_LIST_OP(DISPLAY_LIST_VISIT_OP)
+#undef DISPLAY_LIST_VISIT_OP
+  }
+}
+
+// Calls |visitor| with the header of every operation in the buffer.
+template <typename Visitor>
+void ForEachOp(const uint8_t* storage, size_t byte_count, Visitor&& visitor) {
+  const uint8_t* end = storage + byte_count;
+  while (storage < end) {
+    const OpHeader* header = reinterpret_cast<const OpHeader*>(storage);
+    visitor(header);
+    storage += header->size;
+  }
+}
+
+void DisposeOps(uint8_t* storage, size_t byte_count) {
+  ForEachOp(storage, byte_count, [](const OpHeader* header) {
+    VisitOp(header, [](const auto& op) {
+      using Op = std::decay_t<decltype(op)>;
+      const_cast<Op&>(op).~Op();
+    });
+  });
+}
+
+template <typename Op>
+const uint8_t* GetData(const Op& op) {
+  return reinterpret_cast<const uint8_t*>(&op + 1);
+}
+
+template <typename Op>
+size_t GetDataSize(const OpHeader* header) {
+  return header->size - sizeof(OpHeader) - sizeof(Op);
+}
+
+// Compares the members of operations. Anything that is not compared by
+// value is compared by identity.
+template <typename T>
+bool FieldEquals(const T& a, const T& b) {
+  return a == b;
+}
+
+bool FieldEquals(const sk_sp<DisplayList>& a, const sk_sp<DisplayList>& b) {
+  return a == b || (a && b && a->Equals(*b));
+}
+
+template <typename Tuple>
+bool FieldsEqual(const Tuple& a, const Tuple& b) {
+  return std::apply(
+      [&b](const auto&... a_fields) {
+        return std::apply(
+            [&](const auto&... b_fields) {
+              return (FieldEquals(a_fields, b_fields) && ...);
+            },
+            b);
+      },
+      a);
+}
+
+// Hashes the members of operations, consistently with |FieldEquals|.
+template <typename T,
+          typename = std::enable_if_t<std::is_arithmetic_v<T> ||
+                                      std::is_enum_v<T>>>
+void HashField(size_t& seed, T value) {
+  fml::HashCombineSeed(seed, value);
+}
+
+void HashField(size_t& seed, const SkRect& rect) {
+  fml::HashCombineSeed(seed, rect.fLeft, rect.fTop, rect.fRight,
+                       rect.fBottom);
+}
+
+void HashField(size_t& seed, const SkIRect& rect) {
+  fml::HashCombineSeed(seed, rect.fLeft, rect.fTop, rect.fRight,
+                       rect.fBottom);
+}
+
+void HashField(size_t& seed, const SkRRect& rrect) {
+  HashField(seed, rrect.rect());
+  for (int corner = 0; corner < 4; corner++) {
+    SkVector radii = rrect.radii(static_cast<SkRRect::Corner>(corner));
+    fml::HashCombineSeed(seed, radii.fX, radii.fY);
+  }
+}
+
+// Paths are hashed by their bounds rather than by all their points, equal
+// paths have equal bounds.
+void HashField(size_t& seed, const SkPath& path) {
+  fml::HashCombineSeed(seed, path.getFillType(), path.countPoints(),
+                       path.countVerbs());
+  HashField(seed, path.getBounds());
+}
+
+void HashField(size_t& seed, const SkM44& matrix) {
+  SkScalar values[16];
+  matrix.getColMajor(values);
+  for (SkScalar value : values) {
+    fml::HashCombineSeed(seed, value);
+  }
+}
+
+void HashField(size_t& seed, const SkMatrix& matrix) {
+  SkScalar values[9];
+  matrix.get9(values);
+  for (SkScalar value : values) {
+    fml::HashCombineSeed(seed, value);
+  }
+}
+
+void HashField(size_t& seed, const SkColor4f& color) {
+  fml::HashCombineSeed(seed, color.fR, color.fG, color.fB, color.fA);
+}
+
+void HashField(size_t& seed, const SkPaint& paint) {
+  HashField(seed, paint.getColor4f());
+  fml::HashCombineSeed(seed, paint.getStyle(), paint.getStrokeWidth(),
+                       paint.isAntiAlias(), paint.getShader(),
+                       paint.getColorFilter(), paint.getMaskFilter(),
+                       paint.getPathEffect(), paint.getImageFilter());
+}
+
+// Sampling options are left out of the hash, they rarely tell operations
+// apart.
+void HashField(size_t& seed, const SkSamplingOptions&) {}
+
+template <typename T>
+void HashField(size_t& seed, const sk_sp<T>& object) {
+  fml::HashCombineSeed(seed, object.get());
+}
+
+void HashField(size_t& seed, const sk_sp<DisplayList>& display_list) {
+  fml::HashCombineSeed(seed, display_list ? display_list->hash() : 0);
+}
+
+template <typename T>
+void HashField(size_t& seed, const std::optional<T>& value) {
+  fml::HashCombineSeed(seed, value.has_value());
+  if (value) {
+    HashField(seed, *value);
+  }
+}
+
+std::atomic<uint32_t> next_unique_id = 1;
+
+}  // namespace
+
+void DisplayList::FreeDeleter::operator()(uint8_t* storage) const {
+  std::free(storage);
+}
+
+DisplayList::DisplayList(Storage storage,
+                         size_t byte_count,
+                         size_t op_count,
+                         const SkRect& bounds)
+    : storage_(std::move(storage)),
+      byte_count_(byte_count),
+      op_count_(op_count),
+      bounds_(bounds),
+      unique_id_(next_unique_id.fetch_add(1, std::memory_order_relaxed)) {
+  size_t seed = fml::HashCombine();
+  HashField(seed, bounds_);
+  ForEachOp(storage_.get(), byte_count_, [&seed](const OpHeader* header) {
+    fml::HashCombineSeed(seed, header->type);
+    VisitOp(header, [&seed, header](const auto& op) {
+      using Op = std::decay_t<decltype(op)>;
+      std::apply(
+          [&seed](const auto&... fields) { (HashField(seed, fields), ...); },
+          op.Fields());
+      const size_t data_size = GetDataSize<Op>(header);
+      if (data_size > 0) {
+        fml::HashCombineSeed(
+            seed, std::string_view(reinterpret_cast<const char*>(GetData(op)),
+                                   data_size));
+      }
+    });
+  });
+  hash_ = seed;
+}
+
+DisplayList::~DisplayList() {
+  DisposeOps(storage_.get(), byte_count_);
+}
+
+void DisplayList::RenderTo(SkCanvas* canvas) const {
+  Render(canvas, nullptr);
+}
+
+void DisplayList::RenderTo(SkCanvas* canvas, const SkRect& cull_rect) const {
+  Render(canvas, &cull_rect);
+}
+
+void DisplayList::Render(SkCanvas* canvas, const SkRect* cull_rect) const {
+  // Operations at the top level may change the transformation and the clip
+  // without a save.
+  SkAutoCanvasRestore auto_restore(canvas, true);
+  RenderContext context{canvas, canvas->getLocalToDevice()};
+  ForEachOp(storage_.get(), byte_count_,
+            [&context, cull_rect](const OpHeader* header) {
+              VisitOp(header, [&context, cull_rect](const auto& op) {
+                using Op = std::decay_t<decltype(op)>;
+                if constexpr (Op::kIsDraw) {
+                  if (cull_rect && !op.bounds.intersects(*cull_rect)) {
+                    return;
+                  }
+                }
+                op.Render(context, GetData(op));
+              });
+            });
+}
+
+sk_sp<SkPicture> DisplayList::ToSkPicture() const {
+  SkPictureRecorder recorder;
+  RenderTo(recorder.beginRecording(bounds_));
+  return recorder.finishRecordingAsPicture();
+}
+
+bool DisplayList::Equals(const DisplayList& other) const {
+  if (this == &other) {
+    return true;
+  }
+  if (hash_ != other.hash_ || byte_count_ != other.byte_count_ ||
+      op_count_ != other.op_count_ || bounds_ != other.bounds_) {
+    return false;
+  }
+  const uint8_t* other_storage = other.storage_.get();
+  bool equal = true;
+  ForEachOp(storage_.get(), byte_count_, [&](const OpHeader* header) {
+    const OpHeader* other_header =
+        reinterpret_cast<const OpHeader*>(other_storage);
+    other_storage += other_header->size;
+    if (!equal) {
+      return;
+    }
+    if (header->type != other_header->type ||
+        header->size != other_header->size) {
+      equal = false;
+      return;
+    }
+    VisitOp(header, [&equal, header, other_header](const auto& op) {
+      using Op = std::decay_t<decltype(op)>;
+      const Op& other_op = *reinterpret_cast<const Op*>(other_header + 1);
+      equal = FieldsEqual(op.Fields(), other_op.Fields()) &&
+              std::memcmp(GetData(op), GetData(other_op),
+                          GetDataSize<Op>(header)) == 0;
+    });
+  });
+  return equal;
+}
+
+DisplayListCanvasRecorder::DisplayListCanvasRecorder(const SkRect& bounds)
+    : SkCanvasVirtualEnforcer<SkNoDrawCanvas>(bounds.roundOut()),
+      recording_bounds_(bounds) {}
+
+DisplayListCanvasRecorder::~DisplayListCanvasRecorder() {
+  DisposeOps(storage_.get(), used_);
+}
+
+template <typename Op, typename... Args>
+Op* DisplayListCanvasRecorder::Push(size_t trailing_bytes, Args&&... args) {
+  static_assert(alignof(Op) <= kOpAlignment);
+  const size_t size =
+      AlignOpSize(sizeof(OpHeader) + sizeof(Op) + trailing_bytes);
+  if (used_ + size > allocated_) {
+    // The operations are moved by copying their bytes, which all the types
+    // they hold support.
+    allocated_ = std::max({allocated_ * 2, used_ + size, kInitialBufferBytes});
+    uint8_t* storage = static_cast<uint8_t*>(
+        std::realloc(storage_.release(), allocated_));
+    FML_CHECK(storage != nullptr);
+    storage_.reset(storage);
+  }
+  uint8_t* header_address = storage_.get() + used_;
+  used_ += size;
+  op_count_++;
+  // The data and the padding are zeroed so that they can be compared.
+  std::memset(header_address + sizeof(OpHeader) + sizeof(Op), 0,
+              size - sizeof(OpHeader) - sizeof(Op));
+  OpHeader* header = new (header_address)
+      OpHeader{Op::kType, static_cast<uint32_t>(size)};
+  return new (header + 1) Op{std::forward<Args>(args)...};
+}
+
+template <typename Op, typename... Args>
+Op* DisplayListCanvasRecorder::PushDraw(const SkRect& bounds,
+                                        size_t trailing_bytes,
+                                        Args&&... args) {
+  bounds_.join(bounds);
+  return Push<Op>(trailing_bytes, bounds, std::forward<Args>(args)...);
+}
+
+SkRect DisplayListCanvasRecorder::ClipBounds() {
+  return SkRect::Make(getDeviceClipBounds());
+}
+
+SkRect DisplayListCanvasRecorder::ComputeBounds(const SkRect& local_bounds,
+                                                const SkPaint* paint) {
+  // Layers that filter their contents may move them anywhere.
+  if (spreading_layer_count_ > 0 ||
+      (paint && !paint->canComputeFastBounds())) {
+    return ClipBounds();
+  }
+  SkRect bounds = local_bounds;
+  bounds.sort();
+  if (paint) {
+    bounds = paint->computeFastBounds(bounds, &bounds);
+  }
+  getTotalMatrix().mapRect(&bounds);
+  // Anti-aliasing may touch the pixels around the geometry.
+  bounds.outset(1, 1);
+  if (!bounds.intersect(ClipBounds())) {
+    return SkRect::MakeEmpty();
+  }
+  return bounds;
+}
+
+void DisplayListCanvasRecorder::DrawShadow(const SkPath& path,
+                                           SkColor color,
+                                           float elevation,
+                                           bool transparent_occluder,
+                                           SkScalar dpr) {
+  SkRect bounds = ComputeBounds(
+      PhysicalShapeLayer::ComputeShadowBounds(path.getBounds(), elevation,
+                                              dpr),
+      nullptr);
+  PushDraw<DrawShadowOp>(bounds, 0, path, color, elevation,
+                         transparent_occluder, dpr);
+}
+
+void DisplayListCanvasRecorder::DrawDisplayList(
+    sk_sp<DisplayList> display_list) {
+  SkRect bounds = ComputeBounds(display_list->bounds(), nullptr);
+  PushDraw<DrawDisplayListOp>(bounds, 0, std::move(display_list));
+}
+
+sk_sp<DisplayList> DisplayListCanvasRecorder::Build() {
+  // Like |SkPictureRecorder|, balances the saves that were not restored.
+  restoreToCount(1);
+  SkRect bounds = bounds_;
+  if (!bounds.intersect(recording_bounds_)) {
+    bounds.setEmpty();
+  }
+  sk_sp<DisplayList> display_list(
+      new DisplayList(std::move(storage_), used_, op_count_, bounds));
+  used_ = 0;
+  allocated_ = 0;
+  op_count_ = 0;
+  bounds_.setEmpty();
+  return display_list;
+}
+
+void DisplayListCanvasRecorder::willSave() {
+  layer_stack_.push_back(false);
+  Push<SaveOp>(0);
+}
+
+SkCanvas::SaveLayerStrategy DisplayListCanvasRecorder::getSaveLayerStrategy(
+    const SaveLayerRec& rec) {
+  const bool spreads =
+      rec.fBackdrop != nullptr ||
+      (rec.fPaint != nullptr && (rec.fPaint->getImageFilter() != nullptr ||
+                                 rec.fPaint->getColorFilter() != nullptr));
+  layer_stack_.push_back(spreads);
+  if (spreads) {
+    spreading_layer_count_++;
+    // The layer may draw anywhere within the clip when it is restored.
+    bounds_.join(ClipBounds());
+  }
+  Push<SaveLayerOp>(
+      0, rec.fBounds ? std::optional<SkRect>(*rec.fBounds) : std::nullopt,
+      rec.fPaint ? std::optional<SkPaint>(*rec.fPaint) : std::nullopt,
+      sk_ref_sp(rec.fBackdrop), rec.fSaveLayerFlags);
+  return kNoLayer_SaveLayerStrategy;
+}
+
+bool DisplayListCanvasRecorder::onDoSaveBehind(const SkRect*) {
+  FML_DLOG(ERROR) << "Display lists do not support saveBehind.";
+  return false;
+}
+
+void DisplayListCanvasRecorder::willRestore() {
+  if (!layer_stack_.empty()) {
+    if (layer_stack_.back()) {
+      spreading_layer_count_--;
+    }
+    layer_stack_.pop_back();
+  }
+  Push<RestoreOp>(0);
+}
+
+void DisplayListCanvasRecorder::didConcat44(const SkM44& matrix) {
+  Push<ConcatOp>(0, matrix);
+}
+
+void DisplayListCanvasRecorder::didSetM44(const SkM44& matrix) {
+  Push<SetMatrixOp>(0, matrix);
+}
+
+void DisplayListCanvasRecorder::didScale(SkScalar sx, SkScalar sy) {
+  Push<ScaleOp>(0, sx, sy);
+}
+
+void DisplayListCanvasRecorder::didTranslate(SkScalar dx, SkScalar dy) {
+  Push<TranslateOp>(0, dx, dy);
+}
+
+void DisplayListCanvasRecorder::onClipRect(const SkRect& rect,
+                                           SkClipOp op,
+                                           ClipEdgeStyle style) {
+  Push<ClipRectOp>(0, rect, op, style == kSoft_ClipEdgeStyle);
+  SkCanvasVirtualEnforcer<SkNoDrawCanvas>::onClipRect(rect, op, style);
+}
+
+void DisplayListCanvasRecorder::onClipRRect(const SkRRect& rrect,
+                                            SkClipOp op,
+                                            ClipEdgeStyle style) {
+  Push<ClipRRectOp>(0, rrect, op, style == kSoft_ClipEdgeStyle);
+  SkCanvasVirtualEnforcer<SkNoDrawCanvas>::onClipRRect(rrect, op, style);
+}
+
+void DisplayListCanvasRecorder::onClipPath(const SkPath& path,
+                                           SkClipOp op,
+                                           ClipEdgeStyle style) {
+  Push<ClipPathOp>(0, path, op, style == kSoft_ClipEdgeStyle);
+  SkCanvasVirtualEnforcer<SkNoDrawCanvas>::onClipPath(path, op, style);
+}
+
+void DisplayListCanvasRecorder::onClipRegion(const SkRegion& region,
+                                             SkClipOp op) {
+  // Regions are in device space, which is the space of the display list,
+  // while paths are transformed by the current matrix.
+  SkMatrix inverse;
+  if (!getTotalMatrix().invert(&inverse)) {
+    return;
+  }
+  SkPath path;
+  region.getBoundaryPath(&path);
+  path.transform(inverse);
+  clipPath(path, op, false);
+}
+
+void DisplayListCanvasRecorder::onDrawPaint(const SkPaint& paint) {
+  PushDraw<DrawPaintOp>(ClipBounds(), 0, paint);
+}
+
+void DisplayListCanvasRecorder::onDrawBehind(const SkPaint&) {
+  FML_DLOG(ERROR) << "Display lists do not support drawBehind.";
+}
+
+void DisplayListCanvasRecorder::onDrawRect(const SkRect& rect,
+                                           const SkPaint& paint) {
+  PushDraw<DrawRectOp>(ComputeBounds(rect, &paint), 0, rect, paint);
+}
+
+void DisplayListCanvasRecorder::onDrawRRect(const SkRRect& rrect,
+                                            const SkPaint& paint) {
+  PushDraw<DrawRRectOp>(ComputeBounds(rrect.rect(), &paint), 0, rrect, paint);
+}
+
+void DisplayListCanvasRecorder::onDrawDRRect(const SkRRect& outer,
+                                             const SkRRect& inner,
+                                             const SkPaint& paint) {
+  PushDraw<DrawDRRectOp>(ComputeBounds(outer.rect(), &paint), 0, outer, inner,
+                         paint);
+}
+
+void DisplayListCanvasRecorder::onDrawOval(const SkRect& oval,
+                                           const SkPaint& paint) {
+  PushDraw<DrawOvalOp>(ComputeBounds(oval, &paint), 0, oval, paint);
+}
+
+void DisplayListCanvasRecorder::onDrawArc(const SkRect& oval,
+                                          SkScalar start_angle,
+                                          SkScalar sweep_angle,
+                                          bool use_center,
+                                          const SkPaint& paint) {
+  PushDraw<DrawArcOp>(ComputeBounds(oval, &paint), 0, oval, start_angle,
+                      sweep_angle, use_center, paint);
+}
+
+void DisplayListCanvasRecorder::onDrawPath(const SkPath& path,
+                                           const SkPaint& paint) {
+  // Inverse fills cover everything outside of the path.
+  SkRect bounds = path.isInverseFillType()
+                      ? ClipBounds()
+                      : ComputeBounds(path.getBounds(), &paint);
+  PushDraw<DrawPathOp>(bounds, 0, path, paint);
+}
+
+void DisplayListCanvasRecorder::onDrawRegion(const SkRegion& region,
+                                             const SkPaint& paint) {
+  SkPath path;
+  region.getBoundaryPath(&path);
+  onDrawPath(path, paint);
+}
+
+void DisplayListCanvasRecorder::onDrawTextBlob(const SkTextBlob* blob,
+                                               SkScalar x,
+                                               SkScalar y,
+                                               const SkPaint& paint) {
+  PushDraw<DrawTextBlobOp>(
+      ComputeBounds(blob->bounds().makeOffset(x, y), &paint), 0,
+      sk_ref_sp(blob), x, y, paint);
+}
+
+void DisplayListCanvasRecorder::onDrawPatch(const SkPoint cubics[12],
+                                            const SkColor colors[4],
+                                            const SkPoint texCoords[4],
+                                            SkBlendMode mode,
+                                            const SkPaint& paint) {
+  SkRect patch_bounds;
+  patch_bounds.setBounds(cubics, 12);
+  const size_t data_size = 12 * sizeof(SkPoint) +
+                           (colors ? 4 * sizeof(SkColor) : 0) +
+                           (texCoords ? 4 * sizeof(SkPoint) : 0);
+  DrawPatchOp* op = PushDraw<DrawPatchOp>(
+      ComputeBounds(patch_bounds, &paint), data_size, colors != nullptr,
+      texCoords != nullptr, mode, paint);
+  uint8_t* data = reinterpret_cast<uint8_t*>(op + 1);
+  std::memcpy(data, cubics, 12 * sizeof(SkPoint));
+  data += 12 * sizeof(SkPoint);
+  if (colors) {
+    std::memcpy(data, colors, 4 * sizeof(SkColor));
+    data += 4 * sizeof(SkColor);
+  }
+  if (texCoords) {
+    std::memcpy(data, texCoords, 4 * sizeof(SkPoint));
+  }
+}
+
+void DisplayListCanvasRecorder::onDrawPoints(PointMode mode,
+                                             size_t count,
+                                             const SkPoint pts[],
+                                             const SkPaint& paint) {
+  if (count == 0) {
+    return;
+  }
+  SkRect points_bounds;
+  points_bounds.setBounds(pts, count);
+  // Points are always stroked, whatever the style of the paint.
+  SkPaint stroke_paint(paint);
+  stroke_paint.setStyle(SkPaint::kStroke_Style);
+  DrawPointsOp* op = PushDraw<DrawPointsOp>(
+      ComputeBounds(points_bounds, &stroke_paint), count * sizeof(SkPoint),
+      mode, static_cast<uint32_t>(count), paint);
+  std::memcpy(op + 1, pts, count * sizeof(SkPoint));
+}
+
+void DisplayListCanvasRecorder::onDrawVerticesObject(const SkVertices* vertices,
+                                                     SkBlendMode mode,
+                                                     const SkPaint& paint) {
+  PushDraw<DrawVerticesOp>(ComputeBounds(vertices->bounds(), &paint), 0,
+                           sk_ref_sp(vertices), mode, paint);
+}
+
+void DisplayListCanvasRecorder::onDrawImage2(const SkImage* image,
+                                             SkScalar left,
+                                             SkScalar top,
+                                             const SkSamplingOptions& sampling,
+                                             const SkPaint* paint) {
+  SkRect image_bounds =
+      SkRect::MakeXYWH(left, top, image->width(), image->height());
+  PushDraw<DrawImageOp>(
+      ComputeBounds(image_bounds, paint), 0, sk_ref_sp(image), left, top,
+      sampling, paint ? std::optional<SkPaint>(*paint) : std::nullopt);
+}
+
+void DisplayListCanvasRecorder::onDrawImageRect2(
+    const SkImage* image,
+    const SkRect& src,
+    const SkRect& dst,
+    const SkSamplingOptions& sampling,
+    const SkPaint* paint,
+    SrcRectConstraint constraint) {
+  PushDraw<DrawImageRectOp>(
+      ComputeBounds(dst, paint), 0, sk_ref_sp(image), src, dst, sampling,
+      paint ? std::optional<SkPaint>(*paint) : std::nullopt, constraint);
+}
+
+void DisplayListCanvasRecorder::onDrawImageLattice2(const SkImage* image,
+                                                    const Lattice& lattice,
+                                                    const SkRect& dst,
+                                                    SkFilterMode filter,
+                                                    const SkPaint* paint) {
+  const uint32_t x_count = lattice.fXCount;
+  const uint32_t y_count = lattice.fYCount;
+  const uint32_t cell_count =
+      lattice.fRectTypes ? (x_count + 1) * (y_count + 1) : 0;
+  const bool has_colors = lattice.fRectTypes && lattice.fColors;
+  const size_t data_size = (x_count + y_count) * sizeof(int) +
+                           (has_colors ? cell_count * sizeof(SkColor) : 0) +
+                           cell_count * sizeof(Lattice::RectType);
+  DrawImageLatticeOp* op = PushDraw<DrawImageLatticeOp>(
+      ComputeBounds(dst, paint), data_size, sk_ref_sp(image), dst, filter,
+      paint ? std::optional<SkPaint>(*paint) : std::nullopt,
+      lattice.fBounds ? std::optional<SkIRect>(*lattice.fBounds)
+                      : std::nullopt,
+      x_count, y_count, cell_count, has_colors);
+  uint8_t* data = reinterpret_cast<uint8_t*>(op + 1);
+  std::memcpy(data, lattice.fXDivs, x_count * sizeof(int));
+  data += x_count * sizeof(int);
+  std::memcpy(data, lattice.fYDivs, y_count * sizeof(int));
+  data += y_count * sizeof(int);
+  if (has_colors) {
+    std::memcpy(data, lattice.fColors, cell_count * sizeof(SkColor));
+    data += cell_count * sizeof(SkColor);
+  }
+  if (cell_count > 0) {
+    std::memcpy(data, lattice.fRectTypes,
+                cell_count * sizeof(Lattice::RectType));
+  }
+}
+
+void DisplayListCanvasRecorder::onDrawAtlas2(const SkImage* atlas,
+                                             const SkRSXform transforms[],
+                                             const SkRect texture_rects[],
+                                             const SkColor colors[],
+                                             int count,
+                                             SkBlendMode mode,
+                                             const SkSamplingOptions& sampling,
+                                             const SkRect* cull,
+                                             const SkPaint* paint) {
+  if (count <= 0) {
+    return;
+  }
+  SkRect atlas_bounds = SkRect::MakeEmpty();
+  if (cull) {
+    atlas_bounds = *cull;
+  } else {
+    for (int i = 0; i < count; i++) {
+      SkMatrix matrix;
+      matrix.setRSXform(transforms[i]);
+      atlas_bounds.join(matrix.mapRect(SkRect::MakeWH(
+          texture_rects[i].width(), texture_rects[i].height())));
+    }
+  }
+  const size_t data_size = count * (sizeof(SkRSXform) + sizeof(SkRect) +
+                                     (colors ? sizeof(SkColor) : 0));
+  DrawAtlasOp* op = PushDraw<DrawAtlasOp>(
+      ComputeBounds(atlas_bounds, paint), data_size, sk_ref_sp(atlas),
+      static_cast<uint32_t>(count), colors != nullptr, mode, sampling,
+      cull ? std::optional<SkRect>(*cull) : std::nullopt,
+      paint ? std::optional<SkPaint>(*paint) : std::nullopt);
+  uint8_t* data = reinterpret_cast<uint8_t*>(op + 1);
+  std::memcpy(data, transforms, count * sizeof(SkRSXform));
+  data += count * sizeof(SkRSXform);
+  std::memcpy(data, texture_rects, count * sizeof(SkRect));
+  data += count * sizeof(SkRect);
+  if (colors) {
+    std::memcpy(data, colors, count * sizeof(SkColor));
+  }
+}
+
+void DisplayListCanvasRecorder::onDrawEdgeAAImageSet2(const ImageSetEntry[],
+                                                      int,
+                                                      const SkPoint[],
+                                                      const SkMatrix[],
+                                                      const SkSamplingOptions&,
+                                                      const SkPaint*,
+                                                      SrcRectConstraint) {
+  FML_DLOG(ERROR) << "Display lists do not support image sets.";
+}
+
+void DisplayListCanvasRecorder::onDrawShadowRec(const SkPath&,
+                                                const SkDrawShadowRec&) {
+  FML_DLOG(ERROR) << "Display lists only support shadows drawn with "
+                     "DrawShadow.";
+}
+
+void DisplayListCanvasRecorder::onDrawPicture(const SkPicture* picture,
+                                              const SkMatrix* matrix,
+                                              const SkPaint* paint) {
+  SkRect picture_bounds = picture->cullRect();
+  if (matrix) {
+    matrix->mapRect(&picture_bounds);
+  }
+  PushDraw<DrawPictureOp>(
+      ComputeBounds(picture_bounds, paint), 0, sk_ref_sp(picture),
+      matrix ? std::optional<SkMatrix>(*matrix) : std::nullopt,
+      paint ? std::optional<SkPaint>(*paint) : std::nullopt);
+}
+
+void DisplayListCanvasRecorder::onDrawDrawable(SkDrawable* drawable,
+                                               const SkMatrix* matrix) {
+  // Drawables may draw something different every time, the display list
+  // keeps what they draw now.
+  onDrawPicture(drawable->newPictureSnapshot().get(), matrix, nullptr);
+}
+
+void DisplayListCanvasRecorder::onDrawAnnotation(const SkRect&,
+                                                 const char[],
+                                                 SkData*) {}
+
+void DisplayListCanvasRecorder::onDrawEdgeAAQuad(const SkRect& rect,
+                                                 const SkPoint clip[4],
+                                                 SkCanvas::QuadAAFlags aa_flags,
+                                                 const SkColor4f& color,
+                                                 SkBlendMode mode) {
+  DrawEdgeAAQuadOp* op = PushDraw<DrawEdgeAAQuadOp>(
+      ComputeBounds(rect, nullptr), clip ? 4 * sizeof(SkPoint) : 0, rect,
+      clip != nullptr, aa_flags, color, mode);
+  if (clip) {
+    std::memcpy(op + 1, clip, 4 * sizeof(SkPoint));
+  }
+}
+
+}  // namespace flutter
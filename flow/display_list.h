@@ -0,0 +1,340 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_DISPLAY_LIST_H_
+#define FLUTTER_FLOW_DISPLAY_LIST_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkCanvasVirtualEnforcer.h"
+#include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkRefCnt.h"
+#include "third_party/skia/include/utils/SkNoDrawCanvas.h"
+
+namespace flutter {
+
+class DisplayListCanvasRecorder;
+
+//------------------------------------------------------------------------------
+/// An immutable sequence of drawing operations, the engine's counterpart of
+/// an |SkPicture|.
+///
+/// The operations are stored back to back in a single buffer with their
+/// parameters inline, and every drawing operation carries its bounds in the
+/// coordinate space of the display list. Unlike pictures, two display lists
+/// can be compared for equality and hashed without serializing them, so
+/// that a display list that was recorded again with the same contents can be
+/// recognized by the layer tree diffing and the raster cache.
+///
+/// Images, text blobs, vertices, pictures and the shaders, filters and other
+/// effects of paints are compared by identity rather than by contents.
+///
+class DisplayList : public SkRefCnt {
+ public:
+  ~DisplayList() override;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Draws the operations into |canvas|.
+  ///
+  void RenderTo(SkCanvas* canvas) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Draws the operations into |canvas|, skipping the drawing
+  ///             operations whose bounds do not intersect |cull_rect|.
+  ///
+  /// @param[in]  canvas     The canvas to draw into.
+  /// @param[in]  cull_rect  The area that is drawn, in the coordinate space
+  ///                        of the display list.
+  ///
+  void RenderTo(SkCanvas* canvas, const SkRect& cull_rect) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Records the operations into a new picture.
+  ///
+  sk_sp<SkPicture> ToSkPicture() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether |other| is made of the same operations with the same
+  ///             parameters, and would draw the same contents.
+  ///
+  bool Equals(const DisplayList& other) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      A hash of the operations and their parameters. Display lists
+  ///             that are |Equals| have the same hash.
+  ///
+  uint64_t hash() const { return hash_; }
+
+  //----------------------------------------------------------------------------
+  /// @brief      The union of the bounds of the drawing operations, limited to
+  ///             the bounds the display list was recorded with.
+  ///
+  const SkRect& bounds() const { return bounds_; }
+
+  size_t op_count() const { return op_count_; }
+
+  //----------------------------------------------------------------------------
+  /// @brief      The size of the operation buffer, in bytes.
+  ///
+  size_t bytes() const { return byte_count_; }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Unique among the display lists of the process, like
+  ///             |SkPicture::uniqueID|.
+  ///
+  uint32_t unique_id() const { return unique_id_; }
+
+ private:
+  friend class DisplayListCanvasRecorder;
+
+  struct FreeDeleter {
+    void operator()(uint8_t* storage) const;
+  };
+  using Storage = std::unique_ptr<uint8_t, FreeDeleter>;
+
+  DisplayList(Storage storage,
+              size_t byte_count,
+              size_t op_count,
+              const SkRect& bounds);
+
+  void Render(SkCanvas* canvas, const SkRect* cull_rect) const;
+
+  const Storage storage_;
+  const size_t byte_count_;
+  const size_t op_count_;
+  const SkRect bounds_;
+  const uint32_t unique_id_;
+  uint64_t hash_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DisplayList);
+};
+
+//------------------------------------------------------------------------------
+/// A canvas that records the operations drawn into it into a |DisplayList|,
+/// like the canvas of an |SkPictureRecorder| does for pictures.
+///
+/// The canvas keeps track of the transformation and the clip like any other
+/// canvas, so that it can compute the bounds of the drawing operations, but
+/// does not draw anything. Operations that the engine never issues, like
+/// |drawRegion| clips and Android specific operations, are not recorded.
+///
+class DisplayListCanvasRecorder final
+    : public SkCanvasVirtualEnforcer<SkNoDrawCanvas> {
+ public:
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a recorder that records operations drawn within
+  ///             |bounds|. Operations outside of the bounds are recorded as
+  ///             well but are clipped out when the display list is drawn.
+  ///
+  explicit DisplayListCanvasRecorder(const SkRect& bounds);
+
+  ~DisplayListCanvasRecorder() override;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Draws the shadow of |path| the way |PhysicalShapeLayer| does.
+  ///             Shadows drawn through |SkShadowUtils| can not be recorded.
+  ///
+  void DrawShadow(const SkPath& path,
+                  SkColor color,
+                  float elevation,
+                  bool transparent_occluder,
+                  SkScalar dpr);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Draws |display_list|, which is referenced rather than
+  ///             copied into the display list being recorded.
+  ///
+  void DrawDisplayList(sk_sp<DisplayList> display_list);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns a display list of the operations recorded so far and
+  ///             resets the recorder.
+  ///
+  sk_sp<DisplayList> Build();
+
+ private:
+  const SkRect recording_bounds_;
+  DisplayList::Storage storage_;
+  size_t used_ = 0;
+  size_t allocated_ = 0;
+  size_t op_count_ = 0;
+  SkRect bounds_ = SkRect::MakeEmpty();
+  // For every save and save layer that was not restored yet, whether it is a
+  // layer whose filters spread the drawing operations within it outside of
+  // their own bounds.
+  std::vector<bool> layer_stack_;
+  // The number of layers in |layer_stack_| that spread their contents.
+  size_t spreading_layer_count_ = 0;
+
+  template <typename Op, typename... Args>
+  Op* Push(size_t trailing_bytes, Args&&... args);
+
+  template <typename Op, typename... Args>
+  Op* PushDraw(const SkRect& bounds, size_t trailing_bytes, Args&&... args);
+
+  // Returns the bounds in the coordinate space of the display list of
+  // drawing |local_bounds| with |paint|, limited to the current clip.
+  SkRect ComputeBounds(const SkRect& local_bounds, const SkPaint* paint);
+
+  // The bounds of an operation that may draw anywhere within the clip.
+  SkRect ClipBounds();
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void willSave() override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec&) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  bool onDoSaveBehind(const SkRect*) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void willRestore() override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void didConcat44(const SkM44&) override;
+  void didSetM44(const SkM44&) override;
+  void didScale(SkScalar, SkScalar) override;
+  void didTranslate(SkScalar, SkScalar) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onClipRect(const SkRect&, SkClipOp, ClipEdgeStyle) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onClipRRect(const SkRRect&, SkClipOp, ClipEdgeStyle) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onClipPath(const SkPath&, SkClipOp, ClipEdgeStyle) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onClipRegion(const SkRegion&, SkClipOp) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawPaint(const SkPaint&) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawBehind(const SkPaint&) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawRect(const SkRect&, const SkPaint&) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawRRect(const SkRRect&, const SkPaint&) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawDRRect(const SkRRect&, const SkRRect&, const SkPaint&) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawOval(const SkRect&, const SkPaint&) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawArc(const SkRect&,
+                 SkScalar,
+                 SkScalar,
+                 bool,
+                 const SkPaint&) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawPath(const SkPath&, const SkPaint&) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawRegion(const SkRegion&, const SkPaint&) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawTextBlob(const SkTextBlob* blob,
+                      SkScalar x,
+                      SkScalar y,
+                      const SkPaint& paint) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawPatch(const SkPoint cubics[12],
+                   const SkColor colors[4],
+                   const SkPoint texCoords[4],
+                   SkBlendMode,
+                   const SkPaint& paint) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawPoints(PointMode,
+                    size_t count,
+                    const SkPoint pts[],
+                    const SkPaint&) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawVerticesObject(const SkVertices*,
+                            SkBlendMode,
+                            const SkPaint&) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawImage2(const SkImage*,
+                    SkScalar left,
+                    SkScalar top,
+                    const SkSamplingOptions&,
+                    const SkPaint*) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawImageRect2(const SkImage*,
+                        const SkRect& src,
+                        const SkRect& dst,
+                        const SkSamplingOptions&,
+                        const SkPaint*,
+                        SrcRectConstraint) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawImageLattice2(const SkImage*,
+                           const Lattice&,
+                           const SkRect&,
+                           SkFilterMode,
+                           const SkPaint*) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawAtlas2(const SkImage*,
+                    const SkRSXform[],
+                    const SkRect[],
+                    const SkColor[],
+                    int,
+                    SkBlendMode,
+                    const SkSamplingOptions&,
+                    const SkRect*,
+                    const SkPaint*) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawEdgeAAImageSet2(const ImageSetEntry[],
+                             int count,
+                             const SkPoint[],
+                             const SkMatrix[],
+                             const SkSamplingOptions&,
+                             const SkPaint*,
+                             SrcRectConstraint) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawShadowRec(const SkPath&, const SkDrawShadowRec&) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawPicture(const SkPicture*,
+                     const SkMatrix*,
+                     const SkPaint*) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawDrawable(SkDrawable*, const SkMatrix*) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawAnnotation(const SkRect&, const char[], SkData*) override;
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawEdgeAAQuad(const SkRect&,
+                        const SkPoint[4],
+                        SkCanvas::QuadAAFlags,
+                        const SkColor4f&,
+                        SkBlendMode) override;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DisplayListCanvasRecorder);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_DISPLAY_LIST_H_
@@ -0,0 +1,241 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/display_list.h"
+
+#include <cstring>
+#include <functional>
+
+#include "flutter/testing/mock_canvas.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/effects/SkImageFilters.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+constexpr SkRect kBounds = SkRect::MakeWH(100, 100);
+
+sk_sp<DisplayList> Record(const std::function<void(SkCanvas*)>& draw) {
+  DisplayListCanvasRecorder recorder(kBounds);
+  draw(&recorder);
+  return recorder.Build();
+}
+
+void DrawScene(SkCanvas* canvas, SkColor color = SK_ColorBLUE) {
+  SkPaint paint;
+  paint.setColor(color);
+  paint.setAntiAlias(true);
+  canvas->save();
+  canvas->translate(10, 5);
+  canvas->clipRect(SkRect::MakeLTRB(0, 0, 70, 80), true);
+  canvas->drawRect(SkRect::MakeLTRB(5, 5, 30, 30), paint);
+  paint.setStyle(SkPaint::kStroke_Style);
+  paint.setStrokeWidth(3);
+  canvas->drawOval(SkRect::MakeLTRB(20, 20, 60, 50), paint);
+  canvas->restore();
+
+  SkPaint layer_paint;
+  layer_paint.setAlphaf(0.5f);
+  canvas->saveLayer(nullptr, &layer_paint);
+  SkPath path;
+  path.moveTo(10, 90);
+  path.lineTo(50, 60);
+  path.lineTo(90, 90);
+  path.close();
+  canvas->drawPath(path, SkPaint(SkColors::kRed));
+  const SkPoint points[] = {{10, 10}, {90, 10}, {90, 50}};
+  SkPaint point_paint(SkColors::kGreen);
+  point_paint.setStrokeWidth(4);
+  canvas->drawPoints(SkCanvas::kPolygon_PointMode, 3, points, point_paint);
+  canvas->restore();
+}
+
+SkBitmap Rasterize(const std::function<void(SkCanvas*)>& draw) {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(kBounds.width(), kBounds.height());
+  bitmap.eraseColor(SK_ColorTRANSPARENT);
+  SkCanvas canvas(bitmap);
+  draw(&canvas);
+  return bitmap;
+}
+
+bool PixelsEqual(const SkBitmap& a, const SkBitmap& b) {
+  return a.computeByteSize() == b.computeByteSize() &&
+         std::memcmp(a.getPixels(), b.getPixels(), a.computeByteSize()) == 0;
+}
+
+size_t CountDrawRects(const MockCanvas& canvas) {
+  size_t count = 0;
+  for (const auto& call : canvas.draw_calls()) {
+    if (std::holds_alternative<MockCanvas::DrawRectData>(call.data)) {
+      count++;
+    }
+  }
+  return count;
+}
+
+}  // namespace
+
+TEST(DisplayListTest, RendersLikeTheCanvas) {
+  sk_sp<DisplayList> display_list = Record([](SkCanvas* c) { DrawScene(c); });
+
+  SkBitmap expected = Rasterize([](SkCanvas* c) { DrawScene(c); });
+  SkBitmap actual =
+      Rasterize([&](SkCanvas* c) { display_list->RenderTo(c); });
+  EXPECT_TRUE(PixelsEqual(expected, actual));
+
+  SkBitmap from_picture = Rasterize(
+      [&](SkCanvas* c) { c->drawPicture(display_list->ToSkPicture()); });
+  EXPECT_TRUE(PixelsEqual(expected, from_picture));
+}
+
+TEST(DisplayListTest, EqualRecordingsAreEqual) {
+  sk_sp<DisplayList> a = Record([](SkCanvas* c) { DrawScene(c); });
+  sk_sp<DisplayList> b = Record([](SkCanvas* c) { DrawScene(c); });
+
+  EXPECT_NE(a->unique_id(), b->unique_id());
+  EXPECT_EQ(a->hash(), b->hash());
+  EXPECT_TRUE(a->Equals(*b));
+  EXPECT_TRUE(b->Equals(*a));
+  EXPECT_EQ(a->op_count(), b->op_count());
+  EXPECT_EQ(a->bytes(), b->bytes());
+}
+
+TEST(DisplayListTest, DifferentParametersAreNotEqual) {
+  sk_sp<DisplayList> blue = Record([](SkCanvas* c) { DrawScene(c); });
+  sk_sp<DisplayList> red =
+      Record([](SkCanvas* c) { DrawScene(c, SK_ColorRED); });
+  sk_sp<DisplayList> moved = Record([](SkCanvas* c) {
+    c->translate(1, 0);
+    DrawScene(c);
+  });
+
+  EXPECT_FALSE(blue->Equals(*red));
+  EXPECT_NE(blue->hash(), red->hash());
+  EXPECT_FALSE(blue->Equals(*moved));
+}
+
+TEST(DisplayListTest, ImagesAreComparedByIdentity) {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(4, 4);
+  bitmap.eraseColor(SK_ColorWHITE);
+  sk_sp<SkImage> image1 = bitmap.asImage();
+  sk_sp<SkImage> image2 = bitmap.asImage();
+  auto draw_image = [](sk_sp<SkImage> image) {
+    return Record([image](SkCanvas* c) {
+      c->drawImage(image, 10, 10, SkSamplingOptions(), nullptr);
+    });
+  };
+
+  EXPECT_TRUE(draw_image(image1)->Equals(*draw_image(image1)));
+  EXPECT_FALSE(draw_image(image1)->Equals(*draw_image(image2)));
+}
+
+TEST(DisplayListTest, NestedDisplayListsAreComparedByContents) {
+  auto draw_nested = [] {
+    DisplayListCanvasRecorder recorder(kBounds);
+    recorder.DrawDisplayList(Record([](SkCanvas* c) { DrawScene(c); }));
+    return recorder.Build();
+  };
+
+  EXPECT_TRUE(draw_nested()->Equals(*draw_nested()));
+  EXPECT_EQ(draw_nested()->hash(), draw_nested()->hash());
+}
+
+TEST(DisplayListTest, BoundsAreInTheSpaceOfTheDisplayList) {
+  sk_sp<DisplayList> display_list = Record([](SkCanvas* c) {
+    c->translate(10, 20);
+    c->scale(2, 2);
+    c->drawRect(SkRect::MakeLTRB(0, 0, 10, 10), SkPaint());
+  });
+
+  // Outset by a pixel for anti-aliasing.
+  EXPECT_EQ(display_list->bounds(), SkRect::MakeLTRB(9, 19, 31, 41));
+}
+
+TEST(DisplayListTest, BoundsAreLimitedToTheClip) {
+  sk_sp<DisplayList> clipped = Record([](SkCanvas* c) {
+    c->clipRect(SkRect::MakeLTRB(0, 0, 20, 20));
+    c->drawRect(SkRect::MakeLTRB(10, 10, 50, 50), SkPaint());
+  });
+  EXPECT_EQ(clipped->bounds(), SkRect::MakeLTRB(9, 9, 20, 20));
+
+  sk_sp<DisplayList> outside = Record([](SkCanvas* c) {
+    c->drawRect(SkRect::MakeLTRB(200, 200, 300, 300), SkPaint());
+  });
+  EXPECT_TRUE(outside->bounds().isEmpty());
+}
+
+TEST(DisplayListTest, FilteredLayersCoverTheClip) {
+  sk_sp<DisplayList> display_list = Record([](SkCanvas* c) {
+    c->clipRect(SkRect::MakeLTRB(0, 0, 50, 60));
+    SkPaint layer_paint;
+    layer_paint.setImageFilter(SkImageFilters::Blur(5, 5, nullptr));
+    c->saveLayer(nullptr, &layer_paint);
+    c->drawRect(SkRect::MakeLTRB(10, 10, 20, 20), SkPaint());
+    c->restore();
+  });
+
+  EXPECT_EQ(display_list->bounds(), SkRect::MakeLTRB(0, 0, 50, 60));
+}
+
+TEST(DisplayListTest, CullRectSkipsOperationsOutsideOfIt) {
+  sk_sp<DisplayList> display_list = Record([](SkCanvas* c) {
+    c->drawRect(SkRect::MakeLTRB(0, 0, 10, 10), SkPaint());
+    c->save();
+    c->translate(50, 50);
+    c->drawRect(SkRect::MakeLTRB(0, 0, 10, 10), SkPaint());
+    c->restore();
+  });
+
+  MockCanvas all;
+  display_list->RenderTo(&all);
+  EXPECT_EQ(CountDrawRects(all), 2u);
+
+  MockCanvas culled;
+  display_list->RenderTo(&culled, SkRect::MakeLTRB(40, 40, 64, 64));
+  EXPECT_EQ(CountDrawRects(culled), 1u);
+}
+
+TEST(DisplayListTest, UnbalancedSavesAreRestored) {
+  sk_sp<DisplayList> display_list = Record([](SkCanvas* c) {
+    c->save();
+    c->translate(10, 10);
+    c->saveLayer(nullptr, nullptr);
+  });
+
+  // The two saves and the two restores added by |Build|.
+  EXPECT_EQ(display_list->op_count(), 5u);
+
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(10, 10);
+  SkCanvas canvas(bitmap);
+  display_list->RenderTo(&canvas);
+  EXPECT_EQ(canvas.getSaveCount(), 1);
+  EXPECT_TRUE(canvas.getTotalMatrix().isIdentity());
+}
+
+TEST(DisplayListTest, SetMatrixIsRelativeToTheCanvas) {
+  sk_sp<DisplayList> display_list = Record([](SkCanvas* c) {
+    c->translate(30, 30);
+    c->setMatrix(SkM44::Translate(10, 10));
+    c->drawRect(SkRect::MakeLTRB(0, 0, 10, 10), SkPaint(SkColors::kRed));
+  });
+
+  SkBitmap bitmap = Rasterize([&](SkCanvas* c) {
+    c->translate(20, 20);
+    display_list->RenderTo(c);
+  });
+  EXPECT_EQ(bitmap.getColor(35, 35), SK_ColorRED);
+  EXPECT_EQ(bitmap.getColor(15, 15), SK_ColorTRANSPARENT);
+  EXPECT_EQ(bitmap.getColor(65, 65), SK_ColorTRANSPARENT);
+}
+
+}  // namespace testing
+}  // namespace flutter
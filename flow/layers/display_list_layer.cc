@@ -0,0 +1,124 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/display_list_layer.h"
+
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+DisplayListLayer::DisplayListLayer(const SkPoint& offset,
+                                   SkiaGPUObject<DisplayList> display_list,
+                                   bool is_complex,
+                                   bool will_change)
+    : offset_(offset),
+      display_list_(std::move(display_list)),
+      is_complex_(is_complex),
+      will_change_(will_change) {}
+
+#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
+
+bool DisplayListLayer::IsReplacing(DiffContext* context,
+                                   const Layer* layer) const {
+  // Only return true for equal display lists, like |PictureLayer| does.
+  auto display_list_layer = layer->as_display_list_layer();
+  return display_list_layer != nullptr &&
+         offset_ == display_list_layer->offset_ &&
+         Compare(context->statistics(), this, display_list_layer);
+}
+
+void DisplayListLayer::Diff(DiffContext* context, const Layer* old_layer) {
+  DiffContext::AutoSubtreeRestore subtree(context);
+  if (!context->IsSubtreeDirty()) {
+#ifndef NDEBUG
+    FML_DCHECK(old_layer);
+    auto prev = old_layer->as_display_list_layer();
+    DiffContext::Statistics dummy_statistics;
+    // IsReplacing has already determined that the display list is same
+    FML_DCHECK(prev->offset_ == offset_ &&
+               Compare(dummy_statistics, this, prev));
+#endif
+  }
+  context->PushTransform(SkMatrix::Translate(offset_.x(), offset_.y()));
+  context->AddLayerBounds(display_list()->bounds());
+  context->SetLayerPaintRegion(this, context->CurrentSubtreeRegion());
+}
+
+bool DisplayListLayer::Compare(DiffContext::Statistics& statistics,
+                               const DisplayListLayer* l1,
+                               const DisplayListLayer* l2) {
+  const auto& list1 = l1->display_list_.get();
+  const auto& list2 = l2->display_list_.get();
+  if (list1.get() == list2.get()) {
+    statistics.AddSameInstancePicture();
+    return true;
+  }
+  // Display lists with different hashes or sizes are told apart without
+  // looking at their operations.
+  if (list1->hash() != list2->hash() || list1->bytes() != list2->bytes()) {
+    statistics.AddNewPicture();
+    return false;
+  }
+
+  statistics.AddDeepComparePicture();
+  auto res = list1->Equals(*list2);
+  if (res) {
+    statistics.AddDifferentInstanceButEqualPicture();
+  } else {
+    statistics.AddNewPicture();
+  }
+  return res;
+}
+
+#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
+
+void DisplayListLayer::Preroll(PrerollContext* context,
+                               const SkMatrix& matrix) {
+  TRACE_EVENT0("flutter", "DisplayListLayer::Preroll");
+
+#if defined(LEGACY_FUCHSIA_EMBEDDER)
+  CheckForChildLayerBelow(context);
+#endif
+
+  DisplayList* list = display_list();
+
+  if (auto* cache = context->raster_cache) {
+    TRACE_EVENT0("flutter", "DisplayListLayer::RasterCache (Preroll)");
+
+    SkMatrix ctm = matrix;
+    ctm.preTranslate(offset_.x(), offset_.y());
+#ifndef SUPPORT_FRACTIONAL_TRANSLATION
+    ctm = RasterCache::GetIntegralTransCTM(ctm);
+#endif
+    cache->Prepare(context->gr_context, list, ctm, context->dst_color_space,
+                   is_complex_, will_change_);
+  }
+
+  SkRect bounds = list->bounds().makeOffset(offset_.x(), offset_.y());
+  set_paint_bounds(bounds);
+}
+
+void DisplayListLayer::Paint(PaintContext& context) const {
+  TRACE_EVENT0("flutter", "DisplayListLayer::Paint");
+  FML_DCHECK(display_list_.get());
+  FML_DCHECK(needs_painting(context));
+
+  SkAutoCanvasRestore save(context.leaf_nodes_canvas, true);
+  context.leaf_nodes_canvas->translate(offset_.x(), offset_.y());
+#ifndef SUPPORT_FRACTIONAL_TRANSLATION
+  context.leaf_nodes_canvas->setMatrix(RasterCache::GetIntegralTransCTM(
+      context.leaf_nodes_canvas->getTotalMatrix()));
+#endif
+
+  if (context.raster_cache &&
+      context.raster_cache->Draw(*display_list(), *context.leaf_nodes_canvas)) {
+    TRACE_EVENT_INSTANT0("flutter", "raster cache hit");
+    return;
+  }
+  // Only the operations that intersect the clip are drawn.
+  display_list()->RenderTo(context.leaf_nodes_canvas,
+                           context.leaf_nodes_canvas->getLocalClipBounds());
+}
+
+}  // namespace flutter
@@ -0,0 +1,149 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#define FML_USED_ON_EMBEDDER
+
+#include "flutter/flow/layers/display_list_layer.h"
+
+#include "flutter/flow/testing/diff_context_test.h"
+#include "flutter/flow/testing/skia_gpu_object_layer_test.h"
+#include "flutter/fml/macros.h"
+#include "flutter/testing/mock_canvas.h"
+
+#ifndef SUPPORT_FRACTIONAL_TRANSLATION
+#include "flutter/flow/raster_cache.h"
+#endif
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+sk_sp<DisplayList> CreateDisplayList(const SkRect& bounds, uint32_t color) {
+  DisplayListCanvasRecorder recorder(bounds);
+  recorder.drawRect(bounds, SkPaint(SkColor4f::FromBytes_RGBA(color)));
+  return recorder.Build();
+}
+
+}  // namespace
+
+using DisplayListLayerTest = SkiaGPUObjectLayerTest;
+
+#ifndef NDEBUG
+TEST_F(DisplayListLayerTest, PaintBeforePrerollDies) {
+  const SkPoint layer_offset = SkPoint::Make(0.0f, 0.0f);
+  const SkRect bounds = SkRect::MakeLTRB(5.0f, 6.0f, 20.5f, 21.5f);
+  auto layer = std::make_shared<DisplayListLayer>(
+      layer_offset,
+      SkiaGPUObject(CreateDisplayList(bounds, 0xFF0000FF), unref_queue()),
+      false, false);
+
+  EXPECT_EQ(layer->paint_bounds(), SkRect::MakeEmpty());
+  EXPECT_DEATH_IF_SUPPORTED(layer->Paint(paint_context()),
+                            "needs_painting\\(context\\)");
+}
+#endif
+
+TEST_F(DisplayListLayerTest, SimpleDisplayList) {
+  const SkPoint layer_offset = SkPoint::Make(1.5f, -0.5f);
+  const SkMatrix layer_offset_matrix =
+      SkMatrix::Translate(layer_offset.fX, layer_offset.fY);
+  const SkRect bounds = SkRect::MakeLTRB(5.0f, 6.0f, 20.5f, 21.5f);
+  auto display_list = CreateDisplayList(bounds, 0xFF0000FF);
+  auto layer = std::make_shared<DisplayListLayer>(
+      layer_offset, SkiaGPUObject(display_list, unref_queue()), false, false);
+
+  layer->Preroll(preroll_context(), SkMatrix());
+  EXPECT_EQ(layer->paint_bounds(),
+            display_list->bounds().makeOffset(layer_offset.fX,
+                                              layer_offset.fY));
+  EXPECT_EQ(layer->display_list(), display_list.get());
+  EXPECT_TRUE(layer->needs_painting(paint_context()));
+
+  layer->Paint(paint_context());
+  const SkPaint paint(SkColor4f::FromBytes_RGBA(0xFF0000FF));
+  auto expected_draw_calls = std::vector(
+      {MockCanvas::DrawCall{0, MockCanvas::SaveData{1}},
+       MockCanvas::DrawCall{
+           1, MockCanvas::ConcatMatrixData{SkM44(layer_offset_matrix)}},
+#ifndef SUPPORT_FRACTIONAL_TRANSLATION
+       MockCanvas::DrawCall{
+           1, MockCanvas::SetMatrixData{SkM44(
+                  RasterCache::GetIntegralTransCTM(layer_offset_matrix))}},
+#endif
+       MockCanvas::DrawCall{1, MockCanvas::SaveData{2}},
+       MockCanvas::DrawCall{2, MockCanvas::DrawRectData{bounds, paint}},
+       MockCanvas::DrawCall{2, MockCanvas::RestoreData{1}},
+       MockCanvas::DrawCall{1, MockCanvas::RestoreData{0}}});
+  EXPECT_EQ(mock_canvas().draw_calls(), expected_draw_calls);
+}
+
+#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
+
+class DisplayListLayerDiffTest : public DiffContextTest {
+ public:
+  std::shared_ptr<DisplayListLayer> CreateDisplayListLayer(
+      sk_sp<DisplayList> display_list,
+      const SkPoint& offset = SkPoint::Make(0, 0)) {
+    return std::make_shared<DisplayListLayer>(
+        offset, SkiaGPUObject(display_list, unref_queue()), false, false);
+  }
+};
+
+TEST_F(DisplayListLayerDiffTest, DisplayListCompare) {
+  const SkRect bounds = SkRect::MakeLTRB(10, 10, 60, 60);
+  // The bounds of the display lists include a pixel for anti-aliasing.
+  const SkIRect damage_bounds = SkIRect::MakeLTRB(9, 9, 61, 61);
+
+  MockLayerTree tree1;
+  tree1.root()->Add(CreateDisplayListLayer(CreateDisplayList(bounds, 1)));
+
+  auto damage = DiffLayerTree(tree1, MockLayerTree());
+  EXPECT_EQ(damage.frame_damage, damage_bounds);
+
+  // Recorded again with the same operations.
+  MockLayerTree tree2;
+  tree2.root()->Add(CreateDisplayListLayer(CreateDisplayList(bounds, 1)));
+
+  damage = DiffLayerTree(tree2, tree1);
+  EXPECT_TRUE(damage.frame_damage.isEmpty());
+
+  MockLayerTree tree3;
+  // different color
+  tree3.root()->Add(CreateDisplayListLayer(CreateDisplayList(bounds, 2)));
+
+  damage = DiffLayerTree(tree3, tree2);
+  EXPECT_EQ(damage.frame_damage, damage_bounds);
+}
+
+TEST_F(DisplayListLayerDiffTest, LargeDisplayListsAreComparedDeeply) {
+  // Pictures with that many operations are never compared.
+  auto create_display_list = [](uint32_t color) {
+    DisplayListCanvasRecorder recorder(SkRect::MakeWH(100, 100));
+    for (int i = 0; i < 100; i++) {
+      recorder.drawRect(SkRect::MakeXYWH(i, i, 1, 1),
+                        SkPaint(SkColor4f::FromBytes_RGBA(color)));
+    }
+    return recorder.Build();
+  };
+
+  MockLayerTree tree1;
+  tree1.root()->Add(CreateDisplayListLayer(create_display_list(1)));
+  DiffLayerTree(tree1, MockLayerTree());
+
+  MockLayerTree tree2;
+  tree2.root()->Add(CreateDisplayListLayer(create_display_list(1)));
+  auto damage = DiffLayerTree(tree2, tree1);
+  EXPECT_TRUE(damage.frame_damage.isEmpty());
+
+  MockLayerTree tree3;
+  tree3.root()->Add(CreateDisplayListLayer(create_display_list(2)));
+  damage = DiffLayerTree(tree3, tree2);
+  EXPECT_FALSE(damage.frame_damage.isEmpty());
+}
+
+#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
+
+}  // namespace testing
+}  // namespace flutter
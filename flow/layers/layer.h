@@ -74,6 +74,7 @@ struct PrerollContext {
   bool has_texture_layer = false;
 };
 
+class DisplayListLayer;
 class PictureLayer;
 class PerformanceOverlayLayer;
 class TextureLayer;
@@ -246,6 +247,9 @@ class Layer {
 #ifdef FLUTTER_ENABLE_DIFF_CONTEXT
 
   virtual const PictureLayer* as_picture_layer() const { return nullptr; }
+  virtual const DisplayListLayer* as_display_list_layer() const {
+    return nullptr;
+  }
   virtual const TextureLayer* as_texture_layer() const { return nullptr; }
   virtual const PerformanceOverlayLayer* as_performance_overlay_layer() const {
     return nullptr;
@@ -0,0 +1,54 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/layer_arena.h"
+
+#include <algorithm>
+
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+std::shared_ptr<LayerArena> LayerArena::Create(size_t block_size) {
+  return std::shared_ptr<LayerArena>(new LayerArena(block_size));
+}
+
+LayerArena::LayerArena(size_t block_size) : block_size_(block_size) {
+  FML_DCHECK(block_size_ > 0);
+}
+
+LayerArena::~LayerArena() = default;
+
+void* LayerArena::Allocate(size_t size, size_t alignment) {
+  FML_DCHECK_CREATION_THREAD_IS_CURRENT(allocation_thread_checker_);
+  FML_DCHECK(alignment > 0 && (alignment & (alignment - 1)) == 0);
+  FML_DCHECK(alignment <= alignof(std::max_align_t));
+
+  uintptr_t cursor = reinterpret_cast<uintptr_t>(cursor_);
+  uintptr_t aligned = (cursor + alignment - 1) & ~(alignment - 1);
+  if (cursor_ == nullptr ||
+      aligned + size > reinterpret_cast<uintptr_t>(limit_)) {
+    // Blocks come from operator new[] and are suitably aligned for any
+    // fundamental type.
+    const size_t new_block_size = std::max(size, block_size_);
+    blocks_.emplace_back(new uint8_t[new_block_size]);
+    uint8_t* block = blocks_.back().get();
+    if (new_block_size > block_size_) {
+      // Oversized requests get a dedicated block so that the remainder of the
+      // current block can still be used.
+      allocated_bytes_ += size;
+      return block;
+    }
+    cursor_ = block;
+    limit_ = block + new_block_size;
+    aligned = reinterpret_cast<uintptr_t>(cursor_);
+  }
+
+  uint8_t* result = reinterpret_cast<uint8_t*>(aligned);
+  cursor_ = result + size;
+  allocated_bytes_ += size;
+  return result;
+}
+
+}  // namespace flutter
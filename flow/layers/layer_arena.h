@@ -0,0 +1,121 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_LAYERS_LAYER_ARENA_H_
+#define FLUTTER_FLOW_LAYERS_LAYER_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/thread_checker.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      A bump allocator for the layers of a single frame.
+///
+///             Layers are still handed out as `std::shared_ptr`s so that they
+///             can be stored in `ContainerLayer`s like any other layer, but
+///             both the layer and its control block live in blocks owned by
+///             the arena. Freeing a layer only runs its destructor; the blocks
+///             are released in one shot once the last layer allocated from
+///             the arena, and the arena itself, are gone.
+///
+///             The control block of every layer holds a reference to the
+///             arena, so each layer costs an atomic reference count update
+///             on creation and destruction, and keeps every block of its
+///             arena alive. Layers that may be retained across frames (those
+///             wrapped by an `EngineLayer`) should therefore not be allocated
+///             from an arena. Leaves of a retained subtree are, and a single
+///             one of them keeps the whole arena of the frame that created it
+///             alive for as long as the subtree is retained.
+///
+///             Allocation must happen on a single thread. Layers may be
+///             released on any thread.
+///
+class LayerArena : public std::enable_shared_from_this<LayerArena> {
+ public:
+  static constexpr size_t kDefaultBlockSize = 16 * 1024;
+
+  template <class T>
+  class Allocator {
+   public:
+    using value_type = T;
+
+    explicit Allocator(std::shared_ptr<LayerArena> arena)
+        : arena_(std::move(arena)) {}
+
+    template <class U>
+    Allocator(const Allocator<U>& other) : arena_(other.arena_) {}
+
+    T* allocate(size_t n) {
+      return static_cast<T*>(arena_->Allocate(sizeof(T) * n, alignof(T)));
+    }
+
+    void deallocate(T* p, size_t n) {}
+
+    template <class U>
+    bool operator==(const Allocator<U>& other) const {
+      return arena_ == other.arena_;
+    }
+
+    template <class U>
+    bool operator!=(const Allocator<U>& other) const {
+      return arena_ != other.arena_;
+    }
+
+   private:
+    template <class U>
+    friend class Allocator;
+
+    std::shared_ptr<LayerArena> arena_;
+  };
+
+  static std::shared_ptr<LayerArena> Create(
+      size_t block_size = kDefaultBlockSize);
+
+  ~LayerArena();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Constructs a `T` in the arena.
+  ///
+  template <class T, class... Args>
+  std::shared_ptr<T> Make(Args&&... args) {
+    return std::allocate_shared<T>(Allocator<T>(shared_from_this()),
+                                   std::forward<Args>(args)...);
+  }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns `size` bytes aligned to `alignment`, which must be a
+  ///             power of two no larger than `alignof(std::max_align_t)`.
+  ///             Requests larger than the block size get a block of their own.
+  ///
+  void* Allocate(size_t size, size_t alignment);
+
+  /// The number of bytes handed out by |Allocate| so far.
+  size_t allocated_bytes() const { return allocated_bytes_; }
+
+  /// The number of blocks requested from the system allocator so far.
+  size_t block_count() const { return blocks_.size(); }
+
+ private:
+  explicit LayerArena(size_t block_size);
+
+  const size_t block_size_;
+  std::vector<std::unique_ptr<uint8_t[]>> blocks_;
+  uint8_t* cursor_ = nullptr;
+  uint8_t* limit_ = nullptr;
+  size_t allocated_bytes_ = 0;
+  FML_DECLARE_THREAD_CHECKER(allocation_thread_checker_);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(LayerArena);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_LAYERS_LAYER_ARENA_H_
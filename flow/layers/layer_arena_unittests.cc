@@ -0,0 +1,65 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/layer_arena.h"
+
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/texture_layer.h"
+#include "flutter/flow/testing/mock_layer.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+TEST(LayerArenaTest, AllocationsAreAligned) {
+  auto arena = LayerArena::Create(64);
+  arena->Allocate(1, 1);
+  void* aligned = arena->Allocate(8, 8);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % 8, 0u);
+  EXPECT_EQ(arena->allocated_bytes(), 9u);
+  EXPECT_EQ(arena->block_count(), 1u);
+}
+
+TEST(LayerArenaTest, FullBlockStartsANewBlock) {
+  auto arena = LayerArena::Create(64);
+  arena->Allocate(48, 8);
+  arena->Allocate(48, 8);
+  EXPECT_EQ(arena->block_count(), 2u);
+}
+
+TEST(LayerArenaTest, OversizedAllocationGetsItsOwnBlock) {
+  auto arena = LayerArena::Create(64);
+  uint8_t* small = static_cast<uint8_t*>(arena->Allocate(8, 8));
+  arena->Allocate(256, 8);
+  uint8_t* next = static_cast<uint8_t*>(arena->Allocate(8, 8));
+  EXPECT_EQ(arena->block_count(), 2u);
+  // The current block is still used after the oversized allocation.
+  EXPECT_EQ(next, small + 8);
+}
+
+TEST(LayerArenaTest, LayersOutliveArenaHandle) {
+  std::shared_ptr<TextureLayer> layer;
+  {
+    auto arena = LayerArena::Create();
+    layer = arena->Make<TextureLayer>(SkPoint::Make(1, 2),
+                                      SkSize::Make(3, 4), 0, false,
+                                      SkSamplingOptions());
+    EXPECT_GE(arena->allocated_bytes(), sizeof(TextureLayer));
+  }
+  auto container = std::make_shared<ContainerLayer>();
+  container->Add(layer);
+  EXPECT_EQ(container->layers().size(), 1u);
+  EXPECT_EQ(layer.use_count(), 2);
+}
+
+TEST(LayerArenaTest, DestroyingLayerRunsDestructor) {
+  auto arena = LayerArena::Create();
+  auto layer = arena->Make<MockLayer>(SkPath());
+  std::weak_ptr<MockLayer> weak_layer = layer;
+  layer.reset();
+  EXPECT_TRUE(weak_layer.expired());
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,329 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/persistent_raster_cache.h"
+
+#include <cstring>
+#include <future>
+#include <vector>
+
+#include "flutter/common/graphics/persistent_cache.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkData.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr char kEntryExtension[] = ".png";
+constexpr size_t kEntryExtensionLength = sizeof(kEntryExtension) - 1;
+
+// 64-bit FNV-1a. Unlike |std::hash|, the result is the same in every process,
+// which is what makes the keys usable across launches.
+uint64_t HashBytes(const void* bytes, size_t size) {
+  const uint8_t* data = static_cast<const uint8_t*>(bytes);
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= data[i];
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+bool IsEntryFile(const std::string& filename) {
+  return filename.size() > kEntryExtensionLength &&
+         filename.compare(filename.size() - kEntryExtensionLength,
+                          kEntryExtensionLength, kEntryExtension) == 0;
+}
+
+std::string EntryFileName(const std::string& key) {
+  return key + kEntryExtension;
+}
+
+}  // namespace
+
+std::shared_ptr<PersistentRasterCache> PersistentRasterCache::Create(
+    fml::UniqueFD directory,
+    fml::RefPtr<fml::TaskRunner> io_task_runner,
+    size_t max_bytes) {
+  if (!directory.is_valid() || !io_task_runner) {
+    return nullptr;
+  }
+  return std::shared_ptr<PersistentRasterCache>(new PersistentRasterCache(
+      std::move(directory), std::move(io_task_runner), max_bytes));
+}
+
+PersistentRasterCache::PersistentRasterCache(
+    fml::UniqueFD directory,
+    fml::RefPtr<fml::TaskRunner> io_task_runner,
+    size_t max_bytes)
+    : directory_(std::move(directory)),
+      io_task_runner_(std::move(io_task_runner)),
+      max_bytes_(max_bytes) {}
+
+PersistentRasterCache::~PersistentRasterCache() = default;
+
+std::string PersistentRasterCache::ComputeKey(const SkPicture& picture,
+                                              const SkMatrix& ctm,
+                                              SkColorSpace* dst_color_space) {
+  TRACE_EVENT0("flutter", "PersistentRasterCache::ComputeKey");
+  sk_sp<SkData> serialized = picture.serialize();
+  if (!serialized || serialized->size() == 0) {
+    return "";
+  }
+
+  SkMatrix matrix = ctm;
+  matrix[SkMatrix::kMTransX] = 0;
+  matrix[SkMatrix::kMTransY] = 0;
+  SkScalar matrix_values[9];
+  matrix.get9(matrix_values);
+  const uint64_t picture_hash =
+      HashBytes(serialized->data(), serialized->size());
+  const uint32_t color_space_hashes[2] = {
+      dst_color_space ? dst_color_space->toXYZD50Hash() : 0,
+      dst_color_space ? dst_color_space->transferFnHash() : 0,
+  };
+
+  uint8_t key[sizeof(picture_hash) + sizeof(matrix_values) +
+              sizeof(color_space_hashes)];
+  uint8_t* cursor = key;
+  memcpy(cursor, &picture_hash, sizeof(picture_hash));
+  cursor += sizeof(picture_hash);
+  memcpy(cursor, matrix_values, sizeof(matrix_values));
+  cursor += sizeof(matrix_values);
+  memcpy(cursor, color_space_hashes, sizeof(color_space_hashes));
+
+  return PersistentCache::SkKeyToFilePath(
+      *SkData::MakeWithCopy(key, sizeof(key)));
+}
+
+void PersistentRasterCache::LoadAsync() {
+  io_task_runner_->PostTask(
+      [self = shared_from_this()]() { self->LoadEntries(); });
+}
+
+bool PersistentRasterCache::IsLoaded() const {
+  std::scoped_lock lock(mutex_);
+  return loaded_;
+}
+
+void PersistentRasterCache::LoadEntries() {
+  TRACE_EVENT0("flutter", "PersistentRasterCache::LoadEntries");
+  std::vector<std::string> filenames;
+  fml::VisitFiles(directory_, [&filenames](const fml::UniqueFD& directory,
+                                           const std::string& filename) {
+    if (IsEntryFile(filename)) {
+      filenames.push_back(filename);
+    }
+    return true;
+  });
+
+  for (const std::string& filename : filenames) {
+    fml::UniqueFD file = fml::OpenFileReadOnly(directory_, filename.c_str());
+    if (!file.is_valid()) {
+      continue;
+    }
+    fml::FileMapping mapping(file);
+    if (mapping.GetSize() == 0) {
+      continue;
+    }
+
+    // Only the index is loaded, the entries are decoded when they are found.
+    std::scoped_lock lock(mutex_);
+    Entry& entry = TouchEntry(
+        filename.substr(0, filename.size() - kEntryExtensionLength));
+    if (entry.bytes == 0) {
+      entry.bytes = mapping.GetSize();
+      disk_bytes_ += entry.bytes;
+    }
+  }
+
+  {
+    std::scoped_lock lock(mutex_);
+    loaded_ = true;
+  }
+  // The limit may have been lowered since the entries were written.
+  EnforceSizeLimit();
+}
+
+void PersistentRasterCache::Lookup::Complete(std::string key,
+                                             sk_sp<SkImage> image) {
+  key_ = std::move(key);
+  image_ = std::move(image);
+  status_.store(image_ ? Status::kFound : Status::kNotFound,
+                std::memory_order_release);
+}
+
+std::shared_ptr<PersistentRasterCache::Lookup> PersistentRasterCache::Find(
+    sk_sp<SkPicture> picture,
+    const SkMatrix& ctm,
+    sk_sp<SkColorSpace> dst_color_space) {
+  auto lookup = std::make_shared<Lookup>();
+  io_task_runner_->PostTask([self = shared_from_this(), lookup,
+                             picture = std::move(picture), ctm,
+                             dst_color_space = std::move(dst_color_space)]() {
+    std::string key = ComputeKey(*picture, ctm, dst_color_space.get());
+    sk_sp<SkImage> image = key.empty() ? nullptr : self->ReadEntry(key);
+    lookup->Complete(std::move(key), std::move(image));
+  });
+  return lookup;
+}
+
+sk_sp<SkImage> PersistentRasterCache::ReadEntry(const std::string& key) {
+  {
+    std::scoped_lock lock(mutex_);
+    if (entries_.count(key) == 0) {
+      return nullptr;
+    }
+    TouchEntry(key);
+  }
+
+  TRACE_EVENT0("flutter", "PersistentRasterCache::ReadEntry");
+  const std::string filename = EntryFileName(key);
+  fml::UniqueFD file = fml::OpenFileReadOnly(directory_, filename.c_str());
+  sk_sp<SkImage> image;
+  if (file.is_valid()) {
+    fml::FileMapping mapping(file);
+    if (mapping.GetSize() > 0) {
+      image = SkImage::MakeFromEncoded(
+          SkData::MakeWithCopy(mapping.GetMapping(), mapping.GetSize()));
+    }
+  }
+  if (image) {
+    // Decode here rather than when the image is first drawn on the raster
+    // thread.
+    image = image->makeRasterImage();
+  }
+  if (!image) {
+    FML_LOG(WARNING) << "Discarding corrupt raster cache entry " << filename;
+    fml::UnlinkFile(directory_, filename.c_str());
+    std::scoped_lock lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      disk_bytes_ -= it->second.bytes;
+      lru_.erase(it->second.lru_position);
+      entries_.erase(it);
+    }
+  }
+  return image;
+}
+
+void PersistentRasterCache::Store(const std::string& key,
+                                  const sk_sp<SkImage>& image) {
+  if (key.empty() || !image) {
+    return;
+  }
+  {
+    std::scoped_lock lock(mutex_);
+    if (entries_.count(key) > 0) {
+      // Already on disk.
+      TouchEntry(key);
+      return;
+    }
+  }
+
+  TRACE_EVENT0("flutter", "PersistentRasterCache::Store");
+  // Reading the pixels back must happen on the thread of the context of the
+  // image, but encoding and writing them out can happen on the IO thread.
+  sk_sp<SkImage> raster_image = image->makeRasterImage();
+  if (!raster_image) {
+    return;
+  }
+  io_task_runner_->PostTask([self = shared_from_this(), key,
+                             raster_image = std::move(raster_image)]() {
+    self->WriteEntry(
+        key, raster_image->encodeToData(SkEncodedImageFormat::kPNG, 100));
+  });
+}
+
+void PersistentRasterCache::WriteEntry(const std::string& key,
+                                       sk_sp<SkData> data) {
+  TRACE_EVENT0("flutter", "PersistentRasterCache::WriteEntry");
+  if (!data) {
+    return;
+  }
+  if (data->size() > max_bytes_) {
+    return;
+  }
+  fml::NonOwnedMapping mapping(data->bytes(), data->size());
+  if (!fml::WriteAtomically(directory_, EntryFileName(key).c_str(), mapping)) {
+    FML_LOG(ERROR) << "Could not write raster cache entry " << key;
+    return;
+  }
+  {
+    std::scoped_lock lock(mutex_);
+    Entry& entry = TouchEntry(key);
+    disk_bytes_ -= entry.bytes;
+    entry.bytes = data->size();
+    disk_bytes_ += entry.bytes;
+  }
+  EnforceSizeLimit();
+}
+
+PersistentRasterCache::Entry& PersistentRasterCache::TouchEntry(
+    const std::string& key) {
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    Entry& entry = entries_[key];
+    entry.lru_position = lru_.insert(lru_.end(), key);
+    return entry;
+  }
+  lru_.splice(lru_.end(), lru_, it->second.lru_position);
+  return it->second;
+}
+
+void PersistentRasterCache::EnforceSizeLimit() {
+  std::vector<std::string> evicted;
+  {
+    std::scoped_lock lock(mutex_);
+    while (disk_bytes_ > max_bytes_ && !lru_.empty()) {
+      const std::string& key = lru_.front();
+      disk_bytes_ -= entries_[key].bytes;
+      entries_.erase(key);
+      evicted.push_back(key);
+      lru_.pop_front();
+    }
+  }
+  for (const std::string& key : evicted) {
+    fml::UnlinkFile(directory_, EntryFileName(key).c_str());
+  }
+}
+
+bool PersistentRasterCache::Purge() {
+  std::promise<bool> removed;
+  fml::TaskRunner::RunNowOrPostTask(
+      io_task_runner_, [self = shared_from_this(), &removed]() {
+        FML_LOG(INFO) << "Purge persistent raster cache.";
+        {
+          std::scoped_lock lock(self->mutex_);
+          self->entries_.clear();
+          self->lru_.clear();
+          self->disk_bytes_ = 0;
+        }
+        removed.set_value(fml::VisitFiles(
+            self->directory_,
+            [](const fml::UniqueFD& directory, const std::string& filename) {
+              if (!IsEntryFile(filename)) {
+                return true;
+              }
+              return fml::UnlinkFile(directory, filename.c_str());
+            }));
+      });
+  return removed.get_future().get();
+}
+
+size_t PersistentRasterCache::GetEntryCount() const {
+  std::scoped_lock lock(mutex_);
+  return entries_.size();
+}
+
+size_t PersistentRasterCache::GetDiskBytes() const {
+  std::scoped_lock lock(mutex_);
+  return disk_bytes_;
+}
+
+}  // namespace flutter
@@ -0,0 +1,163 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_PERSISTENT_RASTER_CACHE_H_
+#define FLUTTER_FLOW_PERSISTENT_RASTER_CACHE_H_
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/task_runner.h"
+#include "flutter/fml/unique_fd.h"
+#include "third_party/skia/include/core/SkColorSpace.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkMatrix.h"
+#include "third_party/skia/include/core/SkPicture.h"
+
+namespace flutter {
+
+/// An on-disk cache of rasterized pictures that outlives the process.
+///
+/// Entries are PNG files keyed by a hash of the serialized picture, the
+/// transformation it was rasterized with and the destination color space, so
+/// the same artwork is found again on the next launch even though it gets a
+/// different |SkPicture::uniqueID|. All file system access happens on the
+/// given task runner, which is typically the IO task runner.
+///
+/// The cache is opt-in, see |Settings::enable_persistent_raster_cache|. It is
+/// meant for expensive static artwork: pictures are only stored after the
+/// |RasterCache| decided they were worth rasterizing.
+class PersistentRasterCache
+    : public std::enable_shared_from_this<PersistentRasterCache> {
+ public:
+  static constexpr size_t kDefaultMaxBytes = 32 * 1024 * 1024;
+
+  /// Creates a cache that stores its entries in |directory|, evicting the
+  /// least recently used entries once the files take more than |max_bytes|.
+  static std::shared_ptr<PersistentRasterCache> Create(
+      fml::UniqueFD directory,
+      fml::RefPtr<fml::TaskRunner> io_task_runner,
+      size_t max_bytes = kDefaultMaxBytes);
+
+  ~PersistentRasterCache();
+
+  /// Returns the key of the raster cache entry of |picture| drawn with |ctm|
+  /// into |dst_color_space|, or an empty string if the picture can not be
+  /// serialized. Like |RasterCacheKey|, the key ignores the translation of
+  /// |ctm|. Serializing the picture is expensive, see |Find|.
+  static std::string ComputeKey(const SkPicture& picture,
+                                const SkMatrix& ctm,
+                                SkColorSpace* dst_color_space);
+
+  /// The result of a |Find|, completed on the IO task runner.
+  class Lookup {
+   public:
+    enum class Status {
+      // The key is being computed or the entry read from disk.
+      kPending,
+      // The entry is on disk, its image can be taken.
+      kFound,
+      // There is no entry with the key, or the picture can not be
+      // serialized, in which case the key is empty.
+      kNotFound,
+    };
+
+    Status status() const { return status_.load(std::memory_order_acquire); }
+
+    /// The key of the entry. Only valid once the lookup is no longer pending.
+    const std::string& key() const { return key_; }
+
+    /// Hands the decoded image of a found entry over to the caller.
+    sk_sp<SkImage> TakeImage() { return std::move(image_); }
+
+   private:
+    friend class PersistentRasterCache;
+
+    std::atomic<Status> status_{Status::kPending};
+    std::string key_;
+    sk_sp<SkImage> image_;
+
+    void Complete(std::string key, sk_sp<SkImage> image);
+  };
+
+  /// Reads the index of the entries on disk on the IO task runner. The
+  /// entries are only decoded when they are found by |Find|.
+  void LoadAsync();
+
+  /// Whether the entries on disk have been loaded.
+  bool IsLoaded() const;
+
+  /// Looks up the entry of |picture| drawn with |ctm| into |dst_color_space|
+  /// without blocking the calling thread. Serializing the picture to compute
+  /// its key, reading the entry and decoding it all happen on the IO task
+  /// runner, after the entries on disk have been loaded.
+  std::shared_ptr<Lookup> Find(sk_sp<SkPicture> picture,
+                               const SkMatrix& ctm,
+                               sk_sp<SkColorSpace> dst_color_space);
+
+  /// Encodes |image| and writes it to disk as the entry with |key|. Texture
+  /// backed images are read back on the calling thread, which must be the
+  /// thread of the context they belong to. Encoding and writing happen on the
+  /// IO task runner.
+  void Store(const std::string& key, const sk_sp<SkImage>& image);
+
+  /// Removes all the entries from disk and memory. Returns whether the purge
+  /// is successful.
+  bool Purge();
+
+  size_t GetEntryCount() const;
+
+  /// The size of the entries on disk in bytes.
+  size_t GetDiskBytes() const;
+
+  size_t max_bytes() const { return max_bytes_; }
+
+ private:
+  struct Entry {
+    size_t bytes = 0;
+    std::list<std::string>::iterator lru_position;
+  };
+
+  const fml::UniqueFD directory_;
+  const fml::RefPtr<fml::TaskRunner> io_task_runner_;
+  const size_t max_bytes_;
+
+  mutable std::mutex mutex_;
+  bool loaded_ = false;
+  std::unordered_map<std::string, Entry> entries_;
+  // Keys ordered from the least to the most recently used.
+  std::list<std::string> lru_;
+  size_t disk_bytes_ = 0;
+
+  PersistentRasterCache(fml::UniqueFD directory,
+                        fml::RefPtr<fml::TaskRunner> io_task_runner,
+                        size_t max_bytes);
+
+  void LoadEntries();
+
+  // Reads and decodes the entry with |key|, discarding it if it is corrupt.
+  // Must be called on the IO task runner.
+  sk_sp<SkImage> ReadEntry(const std::string& key);
+
+  void WriteEntry(const std::string& key, sk_sp<SkData> data);
+
+  // Adds an entry to the index, or marks it as the most recently used one.
+  // Must be called with |mutex_| held.
+  Entry& TouchEntry(const std::string& key);
+
+  // Deletes the least recently used entries until the entries fit in
+  // |max_bytes_|. Must be called on the IO task runner.
+  void EnforceSizeLimit();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PersistentRasterCache);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_PERSISTENT_RASTER_CACHE_H_
@@ -0,0 +1,304 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/persistent_raster_cache.h"
+
+#include "flutter/flow/raster_cache.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/testing/thread_test.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkPaint.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+sk_sp<SkPicture> GetSamplePicture(SkColor color = SK_ColorRED) {
+  SkPictureRecorder recorder;
+  recorder.beginRecording(SkRect::MakeWH(150, 100));
+  SkPaint paint;
+  paint.setColor(color);
+  recorder.getRecordingCanvas()->drawRect(SkRect::MakeXYWH(10, 10, 80, 80),
+                                          paint);
+  return recorder.finishRecordingAsPicture();
+}
+
+sk_sp<SkImage> GetSampleImage(int width, int height) {
+  sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(width, height);
+  SkPaint paint;
+  for (int i = 0; i < 64; i++) {
+    // Noise, so the image does not compress to nothing.
+    paint.setColor(SkColorSetARGB(255, i * 37 % 256, i * 91 % 256, i * 13));
+    surface->getCanvas()->drawRect(
+        SkRect::MakeXYWH(i * 7 % width, i * 11 % height, 9, 5), paint);
+  }
+  return surface->makeImageSnapshot();
+}
+
+}  // namespace
+
+class PersistentRasterCacheTest : public ThreadTest {
+ public:
+  PersistentRasterCacheTest() : io_task_runner_(CreateNewThread("io")) {}
+
+  std::shared_ptr<PersistentRasterCache> CreateCache(
+      size_t max_bytes = PersistentRasterCache::kDefaultMaxBytes) {
+    return PersistentRasterCache::Create(
+        fml::OpenDirectory(directory_.path().c_str(), false,
+                           fml::FilePermission::kReadWrite),
+        io_task_runner_, max_bytes);
+  }
+
+  // Waits for the tasks posted to the IO task runner so far.
+  void FlushIOTaskRunner() {
+    fml::AutoResetWaitableEvent latch;
+    io_task_runner_->PostTask([&latch]() { latch.Signal(); });
+    latch.Wait();
+  }
+
+  std::shared_ptr<PersistentRasterCache> CreateLoadedCache() {
+    auto cache = CreateCache();
+    cache->LoadAsync();
+    FlushIOTaskRunner();
+    EXPECT_TRUE(cache->IsLoaded());
+    return cache;
+  }
+
+  bool EntryFileExists(const std::string& key) {
+    return fml::FileExists(directory_.fd(), (key + ".png").c_str());
+  }
+
+  const fml::UniqueFD& directory_fd() { return directory_.fd(); }
+
+ private:
+  fml::ScopedTemporaryDirectory directory_;
+  fml::RefPtr<fml::TaskRunner> io_task_runner_;
+};
+
+TEST_F(PersistentRasterCacheTest, KeyDependsOnContentMatrixAndColorSpace) {
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  const SkMatrix identity = SkMatrix::I();
+  const std::string key = PersistentRasterCache::ComputeKey(
+      *GetSamplePicture(), identity, srgb.get());
+  ASSERT_FALSE(key.empty());
+
+  // Pictures recorded again get a new unique ID but the same key.
+  EXPECT_EQ(PersistentRasterCache::ComputeKey(*GetSamplePicture(), identity,
+                                              srgb.get()),
+            key);
+  // Like |RasterCacheKey|, translations are ignored.
+  EXPECT_EQ(PersistentRasterCache::ComputeKey(
+                *GetSamplePicture(), SkMatrix::Translate(10, 20), srgb.get()),
+            key);
+
+  EXPECT_NE(PersistentRasterCache::ComputeKey(*GetSamplePicture(SK_ColorBLUE),
+                                              identity, srgb.get()),
+            key);
+  EXPECT_NE(PersistentRasterCache::ComputeKey(*GetSamplePicture(),
+                                              SkMatrix::Scale(2, 2),
+                                              srgb.get()),
+            key);
+  sk_sp<SkColorSpace> linear = SkColorSpace::MakeSRGBLinear();
+  EXPECT_NE(PersistentRasterCache::ComputeKey(*GetSamplePicture(), identity,
+                                              linear.get()),
+            key);
+}
+
+TEST_F(PersistentRasterCacheTest, StoredEntriesAreFoundOnNextLaunch) {
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  auto cache = CreateLoadedCache();
+  auto lookup = cache->Find(GetSamplePicture(), SkMatrix::I(), srgb);
+  FlushIOTaskRunner();
+  ASSERT_EQ(lookup->status(),
+            PersistentRasterCache::Lookup::Status::kNotFound);
+  const std::string key = lookup->key();
+  EXPECT_EQ(key, PersistentRasterCache::ComputeKey(*GetSamplePicture(),
+                                                   SkMatrix::I(), srgb.get()));
+
+  cache->Store(key, GetSampleImage(40, 30));
+  FlushIOTaskRunner();
+  EXPECT_EQ(cache->GetEntryCount(), 1u);
+  EXPECT_GT(cache->GetDiskBytes(), 0u);
+
+  auto next_cache = CreateCache();
+  next_cache->LoadAsync();
+  lookup = next_cache->Find(GetSamplePicture(), SkMatrix::I(), srgb);
+  FlushIOTaskRunner();
+  EXPECT_EQ(next_cache->GetDiskBytes(), cache->GetDiskBytes());
+  ASSERT_EQ(lookup->status(), PersistentRasterCache::Lookup::Status::kFound);
+  EXPECT_EQ(lookup->key(), key);
+
+  sk_sp<SkImage> image = lookup->TakeImage();
+  ASSERT_NE(image, nullptr);
+  EXPECT_EQ(image->dimensions(), SkISize::Make(40, 30));
+  // The entry was decoded on the IO thread.
+  EXPECT_FALSE(image->isLazyGenerated());
+  EXPECT_TRUE(EntryFileExists(key));
+}
+
+TEST_F(PersistentRasterCacheTest, DiscardsCorruptEntriesWhenFound) {
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  const std::string key = PersistentRasterCache::ComputeKey(
+      *GetSamplePicture(), SkMatrix::I(), srgb.get());
+  auto cache = CreateLoadedCache();
+  cache->Store(key, GetSampleImage(16, 16));
+  FlushIOTaskRunner();
+  ASSERT_TRUE(EntryFileExists(key));
+  const char garbage[] = "not a png";
+  fml::NonOwnedMapping mapping(reinterpret_cast<const uint8_t*>(garbage),
+                               sizeof(garbage));
+  ASSERT_TRUE(fml::WriteAtomically(directory_fd(), (key + ".png").c_str(),
+                                   mapping));
+
+  // Loading the index does not decode the entries.
+  auto next_cache = CreateLoadedCache();
+  EXPECT_EQ(next_cache->GetEntryCount(), 1u);
+
+  auto lookup = next_cache->Find(GetSamplePicture(), SkMatrix::I(), srgb);
+  FlushIOTaskRunner();
+  EXPECT_EQ(lookup->status(),
+            PersistentRasterCache::Lookup::Status::kNotFound);
+  EXPECT_EQ(next_cache->GetEntryCount(), 0u);
+  EXPECT_EQ(next_cache->GetDiskBytes(), 0u);
+  EXPECT_FALSE(EntryFileExists(key));
+}
+
+TEST_F(PersistentRasterCacheTest, SizeLimitEvictsLeastRecentlyUsedEntries) {
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  auto key_of = [&srgb](SkColor color) {
+    return PersistentRasterCache::ComputeKey(*GetSamplePicture(color),
+                                             SkMatrix::I(), srgb.get());
+  };
+  const std::string a = key_of(SK_ColorRED);
+  const std::string b = key_of(SK_ColorGREEN);
+  const std::string c = key_of(SK_ColorBLUE);
+
+  auto cache = CreateLoadedCache();
+  cache->Store(a, GetSampleImage(64, 64));
+  FlushIOTaskRunner();
+  const size_t entry_bytes = cache->GetDiskBytes();
+  ASSERT_GT(entry_bytes, 0u);
+
+  // Room for two entries of the same size.
+  cache.reset();
+  auto next_cache = CreateCache(entry_bytes * 5 / 2);
+  next_cache->LoadAsync();
+  FlushIOTaskRunner();
+  next_cache->Store(b, GetSampleImage(64, 64));
+  FlushIOTaskRunner();
+  // Using "a" makes "b" the least recently used entry.
+  auto lookup =
+      next_cache->Find(GetSamplePicture(SK_ColorRED), SkMatrix::I(), srgb);
+  FlushIOTaskRunner();
+  EXPECT_EQ(lookup->status(), PersistentRasterCache::Lookup::Status::kFound);
+  next_cache->Store(c, GetSampleImage(64, 64));
+  FlushIOTaskRunner();
+
+  EXPECT_EQ(next_cache->GetEntryCount(), 2u);
+  EXPECT_LE(next_cache->GetDiskBytes(), next_cache->max_bytes());
+  EXPECT_TRUE(EntryFileExists(a));
+  EXPECT_FALSE(EntryFileExists(b));
+  EXPECT_TRUE(EntryFileExists(c));
+}
+
+TEST_F(PersistentRasterCacheTest, PurgeRemovesAllEntries) {
+  auto cache = CreateLoadedCache();
+  cache->Store("a", GetSampleImage(16, 16));
+  cache->Store("b", GetSampleImage(16, 16));
+  FlushIOTaskRunner();
+  ASSERT_EQ(cache->GetEntryCount(), 2u);
+
+  EXPECT_TRUE(cache->Purge());
+  EXPECT_EQ(cache->GetEntryCount(), 0u);
+  EXPECT_EQ(cache->GetDiskBytes(), 0u);
+  EXPECT_FALSE(EntryFileExists("a"));
+  EXPECT_FALSE(EntryFileExists("b"));
+}
+
+TEST_F(PersistentRasterCacheTest, RasterCacheRestoresPicturesFromDisk) {
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  SkMatrix matrix = SkMatrix::I();
+  SkCanvas dummy_canvas;
+
+  {
+    RasterCache raster_cache(/*access_threshold=*/1);
+    raster_cache.SetPersistentCache(CreateLoadedCache());
+    auto picture = GetSamplePicture();
+    ASSERT_FALSE(raster_cache.Prepare(nullptr, picture.get(), matrix,
+                                      srgb.get(), true, false));
+    ASSERT_FALSE(raster_cache.Draw(*picture, dummy_canvas));
+    raster_cache.SweepAfterFrame();
+    // The picture is drawn without the cache while it is looked up on disk.
+    ASSERT_TRUE(raster_cache.Prepare(nullptr, picture.get(), matrix,
+                                     srgb.get(), true, false));
+    ASSERT_FALSE(raster_cache.Draw(*picture, dummy_canvas));
+    raster_cache.SweepAfterFrame();
+    FlushIOTaskRunner();
+    ASSERT_TRUE(raster_cache.Prepare(nullptr, picture.get(), matrix,
+                                     srgb.get(), true, false));
+    EXPECT_TRUE(raster_cache.Draw(*picture, dummy_canvas));
+    EXPECT_EQ(raster_cache.GetFrameMetrics().persistent_hit_count, 0u);
+    FlushIOTaskRunner();
+    EXPECT_EQ(raster_cache.persistent_cache()->GetEntryCount(), 1u);
+  }
+
+  // The next launch records the same artwork into a new picture.
+  RasterCache raster_cache(/*access_threshold=*/1);
+  raster_cache.SetPersistentCache(CreateLoadedCache());
+  auto picture = GetSamplePicture();
+  ASSERT_FALSE(raster_cache.Prepare(nullptr, picture.get(), matrix,
+                                    srgb.get(), true, false));
+  ASSERT_FALSE(raster_cache.Draw(*picture, dummy_canvas));
+  raster_cache.SweepAfterFrame();
+  ASSERT_TRUE(raster_cache.Prepare(nullptr, picture.get(), matrix, srgb.get(),
+                                   true, false));
+  ASSERT_FALSE(raster_cache.Draw(*picture, dummy_canvas));
+  raster_cache.SweepAfterFrame();
+  FlushIOTaskRunner();
+  ASSERT_TRUE(raster_cache.Prepare(nullptr, picture.get(), matrix, srgb.get(),
+                                   true, false));
+  EXPECT_EQ(raster_cache.GetFrameMetrics().persistent_hit_count, 1u);
+  EXPECT_TRUE(raster_cache.Draw(*picture, dummy_canvas));
+}
+
+TEST_F(PersistentRasterCacheTest, RasterCacheSpreadsStoresOverFrames) {
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  SkMatrix matrix = SkMatrix::I();
+  SkCanvas dummy_canvas;
+  RasterCache raster_cache(/*access_threshold=*/1);
+  raster_cache.SetPersistentCache(CreateLoadedCache());
+  auto red = GetSamplePicture(SK_ColorRED);
+  auto blue = GetSamplePicture(SK_ColorBLUE);
+
+  // Draws both pictures in a frame.
+  auto draw_frame = [&]() {
+    for (SkPicture* picture : {red.get(), blue.get()}) {
+      raster_cache.Prepare(nullptr, picture, matrix, srgb.get(), true, false);
+      raster_cache.Draw(*picture, dummy_canvas);
+    }
+    raster_cache.SweepAfterFrame();
+    FlushIOTaskRunner();
+  };
+  draw_frame();
+  draw_frame();
+  EXPECT_EQ(raster_cache.persistent_cache()->GetEntryCount(), 0u);
+
+  // Both pictures are rasterized in the same frame, but only one of them is
+  // read back and stored.
+  draw_frame();
+  EXPECT_EQ(raster_cache.GetPictureCachedEntriesCount(), 2u);
+  EXPECT_EQ(raster_cache.persistent_cache()->GetEntryCount(),
+            RasterCache::kPersistentStoresPerFrame);
+  draw_frame();
+  EXPECT_EQ(raster_cache.persistent_cache()->GetEntryCount(), 2u);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -4,6 +4,7 @@
 
 #include "flutter/flow/raster_cache.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "flutter/common/constants.h"
@@ -37,18 +38,16 @@ void RasterCacheResult::draw(SkCanvas& canvas, const SkPaint* paint) const {
 }
 
 RasterCache::RasterCache(size_t access_threshold,
-                         size_t picture_cache_limit_per_frame)
+                         size_t picture_cache_limit_per_frame,
+                         size_t max_cache_bytes,
+                         size_t max_unused_frames)
     : access_threshold_(access_threshold),
       picture_cache_limit_per_frame_(picture_cache_limit_per_frame),
+      max_cache_bytes_(max_cache_bytes),
+      max_unused_frames_(max_unused_frames),
       checkerboard_images_(false) {}
 
-static bool CanRasterizePicture(SkPicture* picture) {
-  if (picture == nullptr) {
-    return false;
-  }
-
-  const SkRect cull_rect = picture->cullRect();
-
+static bool CanRasterize(const SkRect& cull_rect) {
   if (cull_rect.isEmpty()) {
     // No point in ever rasterizing an empty picture.
     return false;
@@ -62,16 +61,17 @@ static bool CanRasterizePicture(SkPicture* picture) {
   return true;
 }
 
-static bool IsPictureWorthRasterizing(SkPicture* picture,
-                                      bool will_change,
-                                      bool is_complex) {
+static bool IsWorthRasterizing(const SkRect& cull_rect,
+                               int op_count,
+                               bool will_change,
+                               bool is_complex) {
   if (will_change) {
     // If the picture is going to change in the future, there is no point in
     // doing to extra work to rasterize.
     return false;
   }
 
-  if (!CanRasterizePicture(picture)) {
+  if (!CanRasterize(cull_rect)) {
     // No point in deciding whether the picture is worth rasterizing if it
     // cannot be rasterized at all.
     return false;
@@ -85,7 +85,15 @@ static bool IsPictureWorthRasterizing(SkPicture* picture,
 
   // TODO(abarth): We should find a better heuristic here that lets us avoid
   // wasting memory on trivial layers that are easy to re-rasterize every frame.
-  return picture->approximateOpCount() > 5;
+  return op_count > 5;
+}
+
+static bool IsPictureWorthRasterizing(SkPicture* picture,
+                                      bool will_change,
+                                      bool is_complex) {
+  return picture != nullptr &&
+         IsWorthRasterizing(picture->cullRect(), picture->approximateOpCount(),
+                            will_change, is_complex);
 }
 
 /// @note Procedure doesn't copy all closures.
@@ -136,6 +144,17 @@ std::unique_ptr<RasterCacheResult> RasterCache::RasterizePicture(
                    [=](SkCanvas* canvas) { canvas->drawPicture(picture); });
 }
 
+std::unique_ptr<RasterCacheResult> RasterCache::RasterizeDisplayList(
+    const DisplayList* display_list,
+    GrDirectContext* context,
+    const SkMatrix& ctm,
+    SkColorSpace* dst_color_space,
+    bool checkerboard) const {
+  return Rasterize(
+      context, ctm, dst_color_space, checkerboard, display_list->bounds(),
+      [=](SkCanvas* canvas) { display_list->RenderTo(canvas); });
+}
+
 void RasterCache::Prepare(PrerollContext* context,
                           Layer* layer,
                           const SkMatrix& ctm) {
@@ -216,17 +235,109 @@ bool RasterCache::Prepare(GrDirectContext* context,
   }
 
   if (!entry.image) {
-    entry.image = RasterizePicture(picture, context, transformation_matrix,
-                                   dst_color_space, checkerboard_images_);
+    entry.image = LoadOrRasterizePicture(
+        entry, picture, context, transformation_matrix, dst_color_space);
+  }
+
+  // Pictures that were not found on disk are stored once they have been
+  // rasterized, a few per frame as their pixels are read back on this thread.
+  const auto& lookup = entry.persistent_lookup;
+  if (entry.image && lookup && persistent_cache_ &&
+      lookup->status() == PersistentRasterCache::Lookup::Status::kNotFound &&
+      persistent_stores_this_frame_ < kPersistentStoresPerFrame) {
+    if (!lookup->key().empty()) {
+      persistent_cache_->Store(lookup->key(), entry.image->image());
+      persistent_stores_this_frame_++;
+    }
+    entry.persistent_lookup.reset();
+  }
+  return true;
+}
+
+bool RasterCache::Prepare(GrDirectContext* context,
+                          const DisplayList* display_list,
+                          const SkMatrix& transformation_matrix,
+                          SkColorSpace* dst_color_space,
+                          bool is_complex,
+                          bool will_change) {
+  if (access_threshold_ == 0) {
+    return false;
+  }
+  if (picture_cached_this_frame_ >= picture_cache_limit_per_frame_) {
+    return false;
+  }
+  if (display_list == nullptr ||
+      !IsWorthRasterizing(display_list->bounds(), display_list->op_count(),
+                          will_change, is_complex)) {
+    return false;
+  }
+
+  const MatrixDecomposition matrix(transformation_matrix);
+  if (!matrix.IsValid()) {
+    return false;
+  }
+
+  DisplayListRasterCacheKey cache_key({sk_ref_sp(display_list)},
+                                      transformation_matrix);
+  Entry& entry = display_list_cache_[cache_key];
+  if (entry.access_count < access_threshold_) {
+    return false;
+  }
+
+  if (!entry.image) {
+    entry.image =
+        RasterizeDisplayList(display_list, context, transformation_matrix,
+                             dst_color_space, checkerboard_images_);
     picture_cached_this_frame_++;
   }
   return true;
 }
 
+std::unique_ptr<RasterCacheResult> RasterCache::LoadOrRasterizePicture(
+    Entry& entry,
+    SkPicture* picture,
+    GrDirectContext* context,
+    const SkMatrix& ctm,
+    SkColorSpace* dst_color_space) {
+  // Checkerboarded images are a debugging aid and are never persisted.
+  if (persistent_cache_ && !checkerboard_images_) {
+    if (!entry.persistent_lookup) {
+      entry.persistent_lookup = persistent_cache_->Find(
+          sk_ref_sp(picture), ctm, sk_ref_sp(dst_color_space));
+    }
+    switch (entry.persistent_lookup->status()) {
+      case PersistentRasterCache::Lookup::Status::kPending:
+        // The picture is drawn without the cache in the meantime.
+        return nullptr;
+      case PersistentRasterCache::Lookup::Status::kFound: {
+        sk_sp<SkImage> image = entry.persistent_lookup->TakeImage();
+        entry.persistent_lookup.reset();
+        if (context) {
+          image = image->makeTextureImage(context);
+        }
+        if (image) {
+          frame_metrics_.persistent_hit_count++;
+          return std::make_unique<RasterCacheResult>(std::move(image),
+                                                     picture->cullRect());
+        }
+        break;
+      }
+      case PersistentRasterCache::Lookup::Status::kNotFound:
+        break;
+    }
+  }
+
+  auto result = RasterizePicture(picture, context, ctm, dst_color_space,
+                                 checkerboard_images_);
+  picture_cached_this_frame_++;
+  return result;
+}
+
 bool RasterCache::Draw(const SkPicture& picture, SkCanvas& canvas) const {
   PictureRasterCacheKey cache_key(picture.uniqueID(), canvas.getTotalMatrix());
   auto it = picture_cache_.find(cache_key);
   if (it == picture_cache_.end()) {
+    frame_metrics_.miss_count++;
     return false;
   }
 
@@ -235,10 +346,36 @@ bool RasterCache::Draw(const SkPicture& picture, SkCanvas& canvas) const {
   entry.used_this_frame = true;
 
   if (entry.image) {
+    frame_metrics_.hit_count++;
     entry.image->draw(canvas, nullptr);
     return true;
   }
 
+  frame_metrics_.miss_count++;
+  return false;
+}
+
+bool RasterCache::Draw(const DisplayList& display_list,
+                       SkCanvas& canvas) const {
+  DisplayListRasterCacheKey cache_key({sk_ref_sp(&display_list)},
+                                      canvas.getTotalMatrix());
+  auto it = display_list_cache_.find(cache_key);
+  if (it == display_list_cache_.end()) {
+    frame_metrics_.miss_count++;
+    return false;
+  }
+
+  Entry& entry = it->second;
+  entry.access_count++;
+  entry.used_this_frame = true;
+
+  if (entry.image) {
+    frame_metrics_.hit_count++;
+    entry.image->draw(canvas, nullptr);
+    return true;
+  }
+
+  frame_metrics_.miss_count++;
   return false;
 }
 
@@ -248,6 +385,7 @@ bool RasterCache::Draw(const Layer* layer,
   LayerRasterCacheKey cache_key(layer->unique_id(), canvas.getTotalMatrix());
   auto it = layer_cache_.find(cache_key);
   if (it == layer_cache_.end()) {
+    frame_metrics_.miss_count++;
     return false;
   }
 
@@ -256,27 +394,82 @@ bool RasterCache::Draw(const Layer* layer,
   entry.used_this_frame = true;
 
   if (entry.image) {
+    frame_metrics_.hit_count++;
     entry.image->draw(canvas, paint);
     return true;
   }
 
+  frame_metrics_.miss_count++;
   return false;
 }
 
 void RasterCache::SweepAfterFrame() {
   SweepOneCacheAfterFrame(picture_cache_);
+  SweepOneCacheAfterFrame(display_list_cache_);
   SweepOneCacheAfterFrame(layer_cache_);
+  EnforceCacheBudget();
   picture_cached_this_frame_ = 0;
+  persistent_stores_this_frame_ = 0;
   TraceStatsToTimeline();
+  total_metrics_.Add(frame_metrics_);
+  frame_metrics_ = {};
+}
+
+void RasterCache::EnforceCacheBudget() {
+  if (max_cache_bytes_ == kUnlimitedCacheBytes) {
+    return;
+  }
+
+  size_t cache_bytes =
+      EstimateLayerCacheByteSize() + EstimatePictureCacheByteSize();
+  if (cache_bytes <= max_cache_bytes_) {
+    return;
+  }
+
+  std::vector<Entry*> candidates;
+  CollectEvictionCandidates(picture_cache_, candidates);
+  CollectEvictionCandidates(display_list_cache_, candidates);
+  CollectEvictionCandidates(layer_cache_, candidates);
+
+  // At this point |used_this_frame| has been reset and |unused_frames| is zero
+  // for the entries used in the frame that just ended.
+  std::sort(candidates.begin(), candidates.end(),
+            [](const Entry* a, const Entry* b) {
+              if (a->unused_frames != b->unused_frames) {
+                return a->unused_frames > b->unused_frames;
+              }
+              return a->image->image_bytes() > b->image->image_bytes();
+            });
+
+  for (Entry* entry : candidates) {
+    if (cache_bytes <= max_cache_bytes_) {
+      break;
+    }
+    cache_bytes -= entry->image->image_bytes();
+    RecordEviction(*entry);
+    entry->evicted = true;
+  }
+
+  EraseEvictedEntries(picture_cache_);
+  EraseEvictedEntries(display_list_cache_);
+  EraseEvictedEntries(layer_cache_);
+}
+
+void RasterCache::RecordEviction(const Entry& entry) {
+  if (entry.image) {
+    frame_metrics_.eviction_count++;
+    frame_metrics_.evicted_bytes += entry.image->image_bytes();
+  }
 }
 
 void RasterCache::Clear() {
   picture_cache_.clear();
+  display_list_cache_.clear();
   layer_cache_.clear();
 }
 
 size_t RasterCache::GetCachedEntriesCount() const {
-  return layer_cache_.size() + picture_cache_.size();
+  return layer_cache_.size() + GetPictureCachedEntriesCount();
 }
 
 size_t RasterCache::GetLayerCachedEntriesCount() const {
@@ -284,7 +477,7 @@ size_t RasterCache::GetLayerCachedEntriesCount() const {
 }
 
 size_t RasterCache::GetPictureCachedEntriesCount() const {
-  return picture_cache_.size();
+  return picture_cache_.size() + display_list_cache_.size();
 }
 
 void RasterCache::SetCheckboardCacheImages(bool checkerboard) {
@@ -304,8 +497,16 @@ void RasterCache::TraceStatsToTimeline() const {
   FML_TRACE_COUNTER("flutter", "RasterCache", reinterpret_cast<int64_t>(this),
                     "LayerCount", layer_cache_.size(), "LayerMBytes",
                     EstimateLayerCacheByteSize() / kMegaByteSizeInBytes,
-                    "PictureCount", picture_cache_.size(), "PictureMBytes",
+                    "PictureCount", GetPictureCachedEntriesCount(),
+                    "PictureMBytes",
                     EstimatePictureCacheByteSize() / kMegaByteSizeInBytes);
+  FML_TRACE_COUNTER("flutter", "RasterCacheFrameMetrics",
+                    reinterpret_cast<int64_t>(this), "Hits",
+                    frame_metrics_.hit_count, "Misses",
+                    frame_metrics_.miss_count, "Evictions",
+                    frame_metrics_.eviction_count, "EvictedKBytes",
+                    frame_metrics_.evicted_bytes / 1024, "PersistentHits",
+                    frame_metrics_.persistent_hit_count);
 
 #endif  // !FLUTTER_RELEASE
 }
@@ -327,6 +528,11 @@ size_t RasterCache::EstimatePictureCacheByteSize() const {
       picture_cache_bytes += item.second.image->image_bytes();
     }
   }
+  for (const auto& item : display_list_cache_) {
+    if (item.second.image) {
+      picture_cache_bytes += item.second.image->image_bytes();
+    }
+  }
   return picture_cache_bytes;
 }
 
@@ -7,7 +7,9 @@
 
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
+#include "flutter/flow/persistent_raster_cache.h"
 #include "flutter/flow/raster_cache_key.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
@@ -32,6 +34,8 @@ class RasterCacheResult {
     return image_ ? image_->imageInfo().computeMinByteSize() : 0;
   };
 
+  const sk_sp<SkImage>& image() const { return image_; }
+
  private:
   sk_sp<SkImage> image_;
   SkRect logical_rect_;
@@ -39,6 +43,35 @@ class RasterCacheResult {
 
 struct PrerollContext;
 
+// Cache hit/miss and eviction counts. See |RasterCache::GetFrameMetrics| and
+// |RasterCache::GetTotalMetrics|.
+struct RasterCacheMetrics {
+  // Number of |RasterCache::Draw| calls that drew a cached image.
+  size_t hit_count = 0;
+
+  // Number of |RasterCache::Draw| calls that found no cached image.
+  size_t miss_count = 0;
+
+  // Number of cached images evicted, either because they went unused for too
+  // many frames or to keep the cache under its byte budget.
+  size_t eviction_count = 0;
+
+  // Sum of |RasterCacheResult::image_bytes| of the evicted images.
+  size_t evicted_bytes = 0;
+
+  // Number of pictures restored from the |PersistentRasterCache| instead of
+  // being rasterized.
+  size_t persistent_hit_count = 0;
+
+  void Add(const RasterCacheMetrics& other) {
+    hit_count += other.hit_count;
+    miss_count += other.miss_count;
+    eviction_count += other.eviction_count;
+    evicted_bytes += other.evicted_bytes;
+    persistent_hit_count += other.persistent_hit_count;
+  }
+};
+
 class RasterCache {
  public:
   // The default max number of picture raster caches to be generated per frame.
@@ -47,9 +80,39 @@ class RasterCache {
   // multiple frames.
   static constexpr int kDefaultPictureCacheLimitPerFrame = 3;
 
+  // A |max_cache_bytes| value of zero places no limit on the total size of the
+  // cached images.
+  static constexpr size_t kUnlimitedCacheBytes = 0;
+
+  // By default, entries that were not used in the frame that just ended are
+  // evicted at the end of that frame.
+  static constexpr size_t kDefaultMaxUnusedFrames = 0;
+
+  // The max number of rasterized pictures stored to the persistent cache per
+  // frame. Storing a picture reads its pixels back on the raster thread, the
+  // pictures over the limit are stored in the following frames.
+  static constexpr size_t kPersistentStoresPerFrame = 1;
+
+  /**
+   * @brief Create a raster cache.
+   *
+   * @param access_threshold the number of frames a picture must be seen in
+   *        before it is rasterized. Zero disables picture caching.
+   * @param picture_cache_limit_per_frame the maximum number of pictures that
+   *        are rasterized in a single frame.
+   * @param max_cache_bytes the budget for the sum of the image bytes of all
+   *        cached layers and pictures. When the budget is exceeded at the end
+   *        of a frame, the least recently used entries are evicted first.
+   *        |kUnlimitedCacheBytes| disables the budget.
+   * @param max_unused_frames the number of consecutive frames an entry may go
+   *        unused and still be retained, as long as the cache is within its
+   *        byte budget.
+   */
   explicit RasterCache(
       size_t access_threshold = 3,
-      size_t picture_cache_limit_per_frame = kDefaultPictureCacheLimitPerFrame);
+      size_t picture_cache_limit_per_frame = kDefaultPictureCacheLimitPerFrame,
+      size_t max_cache_bytes = kUnlimitedCacheBytes,
+      size_t max_unused_frames = kDefaultMaxUnusedFrames);
 
   virtual ~RasterCache() = default;
 
@@ -75,6 +138,19 @@ class RasterCache {
       SkColorSpace* dst_color_space,
       bool checkerboard) const;
 
+  /**
+   * @brief Rasterize a display list and produce a RasterCacheResult
+   * to be stored in the cache.
+   *
+   * @see RasterizePicture
+   */
+  virtual std::unique_ptr<RasterCacheResult> RasterizeDisplayList(
+      const DisplayList* display_list,
+      GrDirectContext* context,
+      const SkMatrix& ctm,
+      SkColorSpace* dst_color_space,
+      bool checkerboard) const;
+
   /**
    * @brief Rasterize an engine Layer and produce a RasterCacheResult
    * to be stored in the cache.
@@ -139,6 +215,15 @@ class RasterCache {
                bool is_complex,
                bool will_change);
 
+  // Like the picture variant, but entries are shared by all the display lists
+  // that are equal to |display_list|.
+  bool Prepare(GrDirectContext* context,
+               const DisplayList* display_list,
+               const SkMatrix& transformation_matrix,
+               SkColorSpace* dst_color_space,
+               bool is_complex,
+               bool will_change);
+
   void Prepare(PrerollContext* context, Layer* layer, const SkMatrix& ctm);
 
   // Find the raster cache for the picture and draw it to the canvas.
@@ -146,6 +231,12 @@ class RasterCache {
   // Return true if it's found and drawn.
   bool Draw(const SkPicture& picture, SkCanvas& canvas) const;
 
+  // Find the raster cache for the display list, or for an equal display
+  // list, and draw it to the canvas.
+  //
+  // Return true if it's found and drawn.
+  bool Draw(const DisplayList& display_list, SkCanvas& canvas) const;
+
   // Find the raster cache for the layer and draw it to the canvas.
   //
   // Additional paint can be given to change how the raster cache is drawn
@@ -156,21 +247,38 @@ class RasterCache {
             SkCanvas& canvas,
             SkPaint* paint = nullptr) const;
 
+  // Called at the end of each frame. Evicts the entries that have not been
+  // used for more than |max_unused_frames| frames, then the least recently
+  // used entries until the cache fits in |max_cache_bytes|.
   void SweepAfterFrame();
 
   void Clear();
 
   void SetCheckboardCacheImages(bool checkerboard);
 
+  /**
+   * @brief Set the on-disk cache that rasterized pictures are stored to and
+   * restored from. Layers are never persisted. Entries in the persistent cache
+   * survive |Clear|. A null cache disables persistence.
+   */
+  void SetPersistentCache(std::shared_ptr<PersistentRasterCache> cache) {
+    persistent_cache_ = std::move(cache);
+  }
+
+  PersistentRasterCache* persistent_cache() const {
+    return persistent_cache_.get();
+  }
+
   size_t GetCachedEntriesCount() const;
 
   size_t GetLayerCachedEntriesCount() const;
 
+  // Display lists are counted as pictures.
   size_t GetPictureCachedEntriesCount() const;
 
   /**
-   * @brief Estimate how much memory is used by picture raster cache entries in
-   * bytes.
+   * @brief Estimate how much memory is used by picture and display list raster
+   * cache entries in bytes.
    *
    * Only SkImage's memory usage is counted as other objects are often much
    * smaller compared to SkImage. SkImageInfo::computeMinByteSize is used to
@@ -188,36 +296,110 @@ class RasterCache {
    */
   size_t EstimateLayerCacheByteSize() const;
 
+  size_t max_cache_bytes() const { return max_cache_bytes_; }
+
+  size_t max_unused_frames() const { return max_unused_frames_; }
+
+  /**
+   * @brief The cache metrics of the frame in progress. They are reset by
+   * |SweepAfterFrame|, after having been added to the totals.
+   */
+  const RasterCacheMetrics& GetFrameMetrics() const { return frame_metrics_; }
+
+  /**
+   * @brief The cache metrics accumulated over all the frames swept so far.
+   */
+  const RasterCacheMetrics& GetTotalMetrics() const { return total_metrics_; }
+
  private:
   struct Entry {
     bool used_this_frame = false;
+    // Set when the entry is evicted to stay within |max_cache_bytes_|; the
+    // entry is then erased along with its access count.
+    bool evicted = false;
     size_t access_count = 0;
+    // Number of frames swept since the entry was last used.
+    size_t unused_frames = 0;
     std::unique_ptr<RasterCacheResult> image;
+    // The lookup of a picture in |persistent_cache_|, until the picture has
+    // been restored from it or stored to it.
+    std::shared_ptr<PersistentRasterCache::Lookup> persistent_lookup;
   };
 
   template <class Cache>
-  static void SweepOneCacheAfterFrame(Cache& cache) {
+  void SweepOneCacheAfterFrame(Cache& cache) {
     std::vector<typename Cache::iterator> dead;
 
     for (auto it = cache.begin(); it != cache.end(); ++it) {
       Entry& entry = it->second;
-      if (!entry.used_this_frame) {
+      if (entry.used_this_frame) {
+        entry.unused_frames = 0;
+      } else if (++entry.unused_frames > max_unused_frames_) {
         dead.push_back(it);
       }
       entry.used_this_frame = false;
     }
 
     for (auto it : dead) {
+      RecordEviction(it->second);
       cache.erase(it);
     }
   }
 
+  template <class Cache>
+  static void CollectEvictionCandidates(Cache& cache,
+                                        std::vector<Entry*>& candidates) {
+    for (auto& item : cache) {
+      if (item.second.image) {
+        candidates.push_back(&item.second);
+      }
+    }
+  }
+
+  template <class Cache>
+  static void EraseEvictedEntries(Cache& cache) {
+    for (auto it = cache.begin(); it != cache.end();) {
+      if (it->second.evicted) {
+        it = cache.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  // Evicts the least recently used entries until the images of the remaining
+  // entries fit in |max_cache_bytes_|. Among entries last used in the same
+  // frame, the largest ones are evicted first.
+  void EnforceCacheBudget();
+
+  void RecordEviction(const Entry& entry);
+
+  // Restores the image of |entry| from |persistent_cache_| or, if it is not
+  // there, rasterizes |picture|. Returns null while the picture is being
+  // looked up in |persistent_cache_|, so that the frame does not wait for the
+  // IO thread.
+  std::unique_ptr<RasterCacheResult> LoadOrRasterizePicture(
+      Entry& entry,
+      SkPicture* picture,
+      GrDirectContext* context,
+      const SkMatrix& ctm,
+      SkColorSpace* dst_color_space);
+
   const size_t access_threshold_;
   const size_t picture_cache_limit_per_frame_;
+  const size_t max_cache_bytes_;
+  const size_t max_unused_frames_;
   size_t picture_cached_this_frame_ = 0;
+  size_t persistent_stores_this_frame_ = 0;
   mutable PictureRasterCacheKey::Map<Entry> picture_cache_;
+  // Display lists are not persisted, the contents they are keyed by include
+  // references to images and other objects of this process.
+  mutable DisplayListRasterCacheKey::Map<Entry> display_list_cache_;
   mutable LayerRasterCacheKey::Map<Entry> layer_cache_;
+  mutable RasterCacheMetrics frame_metrics_;
+  RasterCacheMetrics total_metrics_;
   bool checkerboard_images_;
+  std::shared_ptr<PersistentRasterCache> persistent_cache_;
 
   void TraceStatsToTimeline() const;
 
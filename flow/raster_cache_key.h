@@ -7,6 +7,7 @@
 
 #include <unordered_map>
 
+#include "flutter/flow/display_list.h"
 #include "flutter/flow/matrix_decomposition.h"
 #include "flutter/fml/logging.h"
 
@@ -57,6 +58,30 @@ class Layer;
 // The ID is the uint64_t layer unique_id
 using LayerRasterCacheKey = RasterCacheKey<uint64_t>;
 
+// Identifies a display list by its contents rather than by its instance, so
+// that a display list recorded again with the same operations finds the
+// image cached for the previous one.
+struct DisplayListRasterCacheId {
+  sk_sp<const DisplayList> display_list;
+
+  bool operator==(const DisplayListRasterCacheId& other) const {
+    return display_list->Equals(*other.display_list);
+  }
+};
+
+using DisplayListRasterCacheKey = RasterCacheKey<DisplayListRasterCacheId>;
+
 }  // namespace flutter
 
+namespace std {
+
+template <>
+struct hash<flutter::DisplayListRasterCacheId> {
+  size_t operator()(const flutter::DisplayListRasterCacheId& id) const {
+    return id.display_list->hash();
+  }
+};
+
+}  // namespace std
+
 #endif  // FLUTTER_FLOW_RASTER_CACHE_KEY_H_
@@ -24,6 +24,14 @@ sk_sp<SkPicture> GetSamplePicture() {
   return recorder.finishRecordingAsPicture();
 }
 
+sk_sp<DisplayList> GetSampleDisplayList() {
+  DisplayListCanvasRecorder recorder(SkRect::MakeWH(150, 100));
+  SkPaint paint;
+  paint.setColor(SK_ColorRED);
+  recorder.drawRect(SkRect::MakeXYWH(10, 10, 80, 80), paint);
+  return recorder.Build();
+}
+
 }  // namespace
 
 TEST(RasterCache, SimpleInitialization) {
@@ -164,5 +172,151 @@ TEST(RasterCache, DeviceRectRoundOut) {
   ASSERT_TRUE(cache.Draw(*picture, canvas));
 }
 
+TEST(RasterCache, UnusedEntriesAreRetainedForMaxUnusedFrames) {
+  size_t threshold = 1;
+  size_t max_unused_frames = 2;
+  flutter::RasterCache cache(threshold,
+                             RasterCache::kDefaultPictureCacheLimitPerFrame,
+                             RasterCache::kUnlimitedCacheBytes,
+                             max_unused_frames);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true,
+                             false));  // 1
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+
+  cache.SweepAfterFrame();
+
+  ASSERT_TRUE(cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true,
+                            false));  // 2
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+
+  cache.SweepAfterFrame();
+  cache.SweepAfterFrame();  // 1st frame without an access.
+  cache.SweepAfterFrame();  // 2nd frame without an access.
+
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+
+  cache.SweepAfterFrame();
+  cache.SweepAfterFrame();
+  cache.SweepAfterFrame();
+  cache.SweepAfterFrame();  // 3rd frame without an access.
+
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 0u);
+}
+
+TEST(RasterCache, ByteBudgetEvictsLeastRecentlyUsedEntries) {
+  auto picture_a = GetSamplePicture();
+  auto picture_b = GetSamplePicture();
+
+  // Room for exactly one 150x100 N32 image.
+  size_t max_cache_bytes = 150 * 100 * 4;
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold,
+                             RasterCache::kDefaultPictureCacheLimitPerFrame,
+                             max_cache_bytes, 10);
+
+  SkMatrix matrix = SkMatrix::I();
+  SkCanvas dummy_canvas;
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture_a.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture_b.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture_a, dummy_canvas));
+  ASSERT_FALSE(cache.Draw(*picture_b, dummy_canvas));
+  cache.SweepAfterFrame();
+
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture_a.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture_a, dummy_canvas));
+  cache.SweepAfterFrame();
+  ASSERT_EQ(cache.EstimatePictureCacheByteSize(), max_cache_bytes);
+
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture_b.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture_b, dummy_canvas));
+  cache.SweepAfterFrame();
+
+  // |picture_a| was used least recently and is evicted to make room for
+  // |picture_b|.
+  ASSERT_EQ(cache.EstimatePictureCacheByteSize(), max_cache_bytes);
+  ASSERT_FALSE(cache.Draw(*picture_a, dummy_canvas));
+  ASSERT_TRUE(cache.Draw(*picture_b, dummy_canvas));
+  ASSERT_EQ(cache.GetTotalMetrics().eviction_count, 1u);
+  ASSERT_EQ(cache.GetTotalMetrics().evicted_bytes, max_cache_bytes);
+}
+
+TEST(RasterCache, MetricsCountHitsAndMisses) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  ASSERT_EQ(cache.GetFrameMetrics().miss_count, 1u);
+
+  cache.SweepAfterFrame();
+  ASSERT_EQ(cache.GetFrameMetrics().miss_count, 0u);
+
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+  ASSERT_EQ(cache.GetFrameMetrics().hit_count, 2u);
+
+  cache.SweepAfterFrame();
+  cache.SweepAfterFrame();  // Evicts the unused picture.
+
+  const RasterCacheMetrics& total = cache.GetTotalMetrics();
+  ASSERT_EQ(total.hit_count, 2u);
+  ASSERT_EQ(total.miss_count, 1u);
+  ASSERT_EQ(total.eviction_count, 1u);
+}
+
+TEST(RasterCache, EqualDisplayListsShareAnEntry) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list = GetSampleDisplayList();
+  auto recorded_again = GetSampleDisplayList();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(cache.Prepare(NULL, display_list.get(), matrix, srgb.get(),
+                             true, false));
+  ASSERT_FALSE(cache.Draw(*display_list, dummy_canvas));
+
+  cache.SweepAfterFrame();
+
+  ASSERT_TRUE(cache.Prepare(NULL, recorded_again.get(), matrix, srgb.get(),
+                            true, false));
+  ASSERT_TRUE(cache.Draw(*display_list, dummy_canvas));
+  ASSERT_TRUE(cache.Draw(*recorded_again, dummy_canvas));
+  ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 1u);
+  ASSERT_GT(cache.EstimatePictureCacheByteSize(), 0u);
+
+  cache.Clear();
+  ASSERT_EQ(cache.GetCachedEntriesCount(), 0u);
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -4,7 +4,13 @@
 
 #include "rtree.h"
 
+#include <algorithm>
+#include <functional>
+#include <limits>
 #include <list>
+#include <map>
+#include <queue>
+#include <utility>
 
 #include "flutter/fml/logging.h"
 #include "third_party/skia/include/core/SkBBHFactory.h"
@@ -18,9 +24,10 @@ void RTree::insert(const SkRect boundsArray[],
                    int N) {
   FML_DCHECK(0 == all_ops_count_);
   bbh_->insert(boundsArray, metadata, N);
+  draw_op_bounds_.assign(N, SkRect::MakeEmpty());
   for (int i = 0; i < N; i++) {
     if (metadata != nullptr && metadata[i].isDraw) {
-      draw_op_[i] = boundsArray[i];
+      draw_op_bounds_[i] = boundsArray[i];
     }
   }
   all_ops_count_ = N;
@@ -34,49 +41,111 @@ void RTree::search(const SkRect& query, std::vector<int>* results) const {
   bbh_->search(query, results);
 }
 
+namespace {
+
+// The join of one or more drawn rects, and the position of the first of them
+// in the search results.
+struct DrawnRegion {
+  SkRect rect;
+  size_t order;
+};
+
+// Joins the intersecting regions, sweeping a vertical line from left to
+// right.
+//
+// The regions crossed by the sweep line don't intersect each other, so they
+// don't overlap vertically and are kept ordered by their top. A new region is
+// joined with the contiguous run of them it overlaps vertically.
+//
+// Returns true if a joined region extends to the left of a region the sweep
+// line has already passed, as they may intersect now. Another sweep is needed
+// in that case.
+bool JoinIntersectingRegions(std::vector<DrawnRegion>& regions) {
+  std::sort(regions.begin(), regions.end(),
+            [](const DrawnRegion& a, const DrawnRegion& b) {
+              return a.rect.fLeft < b.rect.fLeft;
+            });
+
+  std::vector<DrawnRegion> swept;
+  swept.reserve(regions.size());
+  SkScalar swept_right = std::numeric_limits<SkScalar>::lowest();
+  std::map<SkScalar, DrawnRegion> crossed;
+  // The right and top of the crossed regions, by their right. The entries of
+  // the regions that have been joined since are skipped.
+  using Edge = std::pair<SkScalar, SkScalar>;
+  std::priority_queue<Edge, std::vector<Edge>, std::greater<Edge>> rights;
+  bool needs_another_sweep = false;
+
+  for (DrawnRegion region : regions) {
+    const SkScalar x = region.rect.fLeft;
+    while (!rights.empty() && rights.top().first <= x) {
+      const auto [right, top] = rights.top();
+      rights.pop();
+      auto passed = crossed.find(top);
+      if (passed != crossed.end() && passed->second.rect.fRight == right) {
+        swept_right = std::max(swept_right, right);
+        swept.push_back(passed->second);
+        crossed.erase(passed);
+      }
+    }
+
+    auto overlapping = crossed.upper_bound(region.rect.fTop);
+    if (overlapping != crossed.begin() &&
+        std::prev(overlapping)->second.rect.fBottom > region.rect.fTop) {
+      overlapping--;
+    }
+    bool joined = false;
+    while (overlapping != crossed.end() &&
+           overlapping->first < region.rect.fBottom) {
+      region.rect.join(overlapping->second.rect);
+      region.order = std::min(region.order, overlapping->second.order);
+      overlapping = crossed.erase(overlapping);
+      joined = true;
+    }
+    if (joined && region.rect.fLeft < swept_right) {
+      needs_another_sweep = true;
+    }
+    crossed.emplace(region.rect.fTop, region);
+    rights.emplace(region.rect.fRight, region.rect.fTop);
+  }
+
+  for (const auto& [top, region] : crossed) {
+    swept.push_back(region);
+  }
+  regions = std::move(swept);
+  return needs_another_sweep;
+}
+
+}  // namespace
+
 std::list<SkRect> RTree::searchNonOverlappingDrawnRects(
     const SkRect& query) const {
   // Get the indexes for the operations that intersect with the query rect.
   std::vector<int> intermediary_results;
   search(query, &intermediary_results);
 
-  std::list<SkRect> final_results;
+  std::vector<DrawnRegion> regions;
+  regions.reserve(intermediary_results.size());
   for (int index : intermediary_results) {
-    auto draw_op = draw_op_.find(index);
+    const SkRect& bounds = draw_op_bounds_[index];
     // Ignore records that don't draw anything.
-    if (draw_op == draw_op_.end()) {
+    if (bounds.isEmpty()) {
       continue;
     }
-    auto current_record_rect = draw_op->second;
-    auto replaced_existing_rect = false;
-    // // If the current record rect intersects with any of the rects in the
-    // // result list, then join them, and update the rect in final_results.
-    std::list<SkRect>::iterator curr_rect_itr = final_results.begin();
-    std::list<SkRect>::iterator first_intersecting_rect_itr;
-    while (!replaced_existing_rect && curr_rect_itr != final_results.end()) {
-      if (SkRect::Intersects(*curr_rect_itr, current_record_rect)) {
-        replaced_existing_rect = true;
-        first_intersecting_rect_itr = curr_rect_itr;
-        curr_rect_itr->join(current_record_rect);
-      }
-      curr_rect_itr++;
-    }
-    // It's possible that the result contains duplicated rects at this point.
-    // For example, consider a result list that contains rects A, B. If a
-    // new rect C is a superset of A and B, then A and B are the same set after
-    // the merge. As a result, find such cases and remove them from the result
-    // list.
-    while (replaced_existing_rect && curr_rect_itr != final_results.end()) {
-      if (SkRect::Intersects(*curr_rect_itr, *first_intersecting_rect_itr)) {
-        first_intersecting_rect_itr->join(*curr_rect_itr);
-        curr_rect_itr = final_results.erase(curr_rect_itr);
-      } else {
-        curr_rect_itr++;
-      }
-    }
-    if (!replaced_existing_rect) {
-      final_results.push_back(current_record_rect);
-    }
+    regions.push_back({bounds, regions.size()});
+  }
+
+  while (JoinIntersectingRegions(regions)) {
+  }
+
+  // Keep the order of the search results.
+  std::sort(regions.begin(), regions.end(),
+            [](const DrawnRegion& a, const DrawnRegion& b) {
+              return a.order < b.order;
+            });
+  std::list<SkRect> final_results;
+  for (const DrawnRegion& region : regions) {
+    final_results.push_back(region.rect);
   }
   return final_results;
 }
@@ -6,7 +6,7 @@
 #define FLUTTER_FLOW_RTREE_H_
 
 #include <list>
-#include <map>
+#include <vector>
 
 #include "third_party/skia/include/core/SkBBHFactory.h"
 #include "third_party/skia/include/core/SkTypes.h"
@@ -41,9 +41,10 @@ class RTree : public SkBBoxHierarchy {
   int getCount() const { return all_ops_count_; }
 
  private:
-  // A map containing the draw operation rects keyed off the operation index
-  // in the insert call.
-  std::map<int, SkRect> draw_op_;
+  // The rects of the operations, indexed by the operation index in the insert
+  // call. The rects of the operations that don't draw are empty, which never
+  // match a search.
+  std::vector<SkRect> draw_op_bounds_;
   sk_sp<SkBBoxHierarchy> bbh_;
   int all_ops_count_;
 };
@@ -4,6 +4,8 @@
 
 #include "rtree.h"
 
+#include <algorithm>
+
 #include "flutter/testing/testing.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
@@ -231,5 +233,75 @@ TEST(RTree, searchNonOverlappingDrawnRectsJoinRectsWhenIntersectedCase3) {
   ASSERT_EQ(*hits.begin(), SkRect::MakeLTRB(50, 50, 620, 300));
 }
 
+TEST(RTree, searchNonOverlappingDrawnRectsJoinRectsWhenIntersectedCase4) {
+  auto rtree_factory = RTreeFactory();
+  auto recorder = std::make_unique<SkPictureRecorder>();
+  auto recording_canvas =
+      recorder->beginRecording(SkRect::MakeIWH(1000, 1000), &rtree_factory);
+
+  auto rect_paint = SkPaint();
+  rect_paint.setColor(SkColors::kCyan);
+  rect_paint.setStyle(SkPaint::Style::kFill_Style);
+
+  // Given the A, B and C rects that intersect with the query rect, where A
+  // only intersects with the union of B and C, the result list contains a
+  // single rect, which is the union of these three rects.
+  //
+  // +-----+
+  // |  A  |    +-----+
+  // |     |    |  C  |
+  // +-----+    |     |
+  //      +-----|     |
+  //      |  B  +-----+
+  //      +----------+
+
+  // A
+  recording_canvas->drawRect(SkRect::MakeLTRB(10, 10, 30, 30), rect_paint);
+  // B
+  recording_canvas->drawRect(SkRect::MakeLTRB(20, 40, 60, 60), rect_paint);
+  // C
+  recording_canvas->drawRect(SkRect::MakeLTRB(50, 20, 70, 50), rect_paint);
+
+  recorder->finishRecordingAsPicture();
+
+  auto hits = rtree_factory.getInstance()->searchNonOverlappingDrawnRects(
+      SkRect::MakeLTRB(0, 0, 100, 100));
+  ASSERT_EQ(1UL, hits.size());
+  ASSERT_EQ(*hits.begin(), SkRect::MakeLTRB(10, 10, 70, 60));
+}
+
+TEST(RTree, searchNonOverlappingDrawnRectsManyRects) {
+  auto rtree_factory = RTreeFactory();
+  auto recorder = std::make_unique<SkPictureRecorder>();
+  auto recording_canvas =
+      recorder->beginRecording(SkRect::MakeIWH(1000, 1000), &rtree_factory);
+
+  auto rect_paint = SkPaint();
+  rect_paint.setColor(SkColors::kCyan);
+  rect_paint.setStyle(SkPaint::Style::kFill_Style);
+
+  // Given rows of rects, where the rects of the even rows touch without
+  // intersecting and the rects of the odd rows overlap their neighbors, the
+  // result list contains each rect of the even rows and a rect for each odd
+  // row.
+  for (int row = 0; row < 10; row++) {
+    for (int column = 0; column < 10; column++) {
+      const SkScalar width = row % 2 == 0 ? 10 : 15;
+      recording_canvas->drawRect(
+          SkRect::MakeXYWH(column * 10, row * 10, width, 10), rect_paint);
+    }
+  }
+
+  recorder->finishRecordingAsPicture();
+
+  auto hits = rtree_factory.getInstance()->searchNonOverlappingDrawnRects(
+      SkRect::MakeLTRB(0, 0, 1000, 1000));
+  ASSERT_EQ(55UL, hits.size());
+  for (int row = 1; row < 10; row += 2) {
+    const SkRect row_rect = SkRect::MakeLTRB(0, row * 10, 105, row * 10 + 10);
+    ASSERT_NE(std::find(hits.begin(), hits.end(), row_rect), hits.end());
+  }
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -6,6 +6,7 @@
 #define FLUTTER_FLOW_SURFACE_FRAME_H_
 
 #include <memory>
+#include <optional>
 
 #include "flutter/common/graphics/gl_context_switch.h"
 #include "flutter/fml/macros.h"
@@ -21,6 +22,27 @@ class SurfaceFrame {
   using SubmitCallback =
       std::function<bool(const SurfaceFrame& surface_frame, SkCanvas* canvas)>;
 
+  // Information about the framebuffer backing the frame, provided by the
+  // surface when the frame is acquired.
+  struct FramebufferInfo {
+    // Whether the surface can present a frame in which only the damaged
+    // region was repainted.
+    bool supports_partial_repaint = false;
+
+    // The region in which the framebuffer differs from the last frame
+    // submitted to the surface. Unset if the contents of the framebuffer are
+    // unknown, in which case the whole frame must be repainted.
+    std::optional<SkIRect> existing_damage;
+  };
+
+  // Information provided by the rasterizer to the surface when the frame is
+  // submitted.
+  struct SubmitInfo {
+    // The region of the frame that differs from the previously submitted
+    // frame. If unset, the whole frame must be assumed to have changed.
+    std::optional<SkIRect> frame_damage;
+  };
+
   SurfaceFrame(sk_sp<SkSurface> surface,
                bool supports_readback,
                const SubmitCallback& submit_callback);
@@ -40,12 +62,30 @@ class SurfaceFrame {
 
   sk_sp<SkSurface> SkiaSurface() const;
 
+  // Makes the frame draw into |canvas| instead of the canvas of its surface.
+  // The surface is responsible for getting what was drawn into its backing
+  // store when the frame is submitted.
+  void set_canvas(SkCanvas* canvas) { canvas_ = canvas; }
+
   bool supports_readback() { return supports_readback_; }
 
+  void set_framebuffer_info(const FramebufferInfo& framebuffer_info) {
+    framebuffer_info_ = framebuffer_info;
+  }
+  const FramebufferInfo& framebuffer_info() const { return framebuffer_info_; }
+
+  void set_submit_info(const SubmitInfo& submit_info) {
+    submit_info_ = submit_info;
+  }
+  const SubmitInfo& submit_info() const { return submit_info_; }
+
  private:
   bool submitted_ = false;
   sk_sp<SkSurface> surface_;
+  SkCanvas* canvas_ = nullptr;
   bool supports_readback_;
+  FramebufferInfo framebuffer_info_;
+  SubmitInfo submit_info_;
   SubmitCallback submit_callback_;
   std::unique_ptr<GLContextResult> context_result_;
 
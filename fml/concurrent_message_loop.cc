@@ -5,12 +5,49 @@
 #include "flutter/fml/concurrent_message_loop.h"
 
 #include <algorithm>
+#include <deque>
 
 #include "flutter/fml/thread.h"
 #include "flutter/fml/trace_event.h"
 
 namespace fml {
 
+namespace {
+
+constexpr size_t kPriorityCount =
+    static_cast<size_t>(ConcurrentTaskPriority::kLow) + 1;
+
+}  // namespace
+
+struct ConcurrentMessageLoop::Worker {
+  std::mutex mutex;
+  // Guarded by |mutex|.
+  std::deque<fml::closure> tasks[kPriorityCount];
+  std::vector<fml::closure> thread_tasks;
+
+  // Mirror the sizes above so that other workers can skip empty queues
+  // without taking |mutex|.
+  std::atomic_size_t task_counts[kPriorityCount] = {};
+  std::atomic_bool has_thread_tasks = false;
+
+  std::thread::id thread_id;
+
+  bool PopTask(size_t priority, fml::closure& task) {
+    if (task_counts[priority].load(std::memory_order_relaxed) == 0) {
+      return false;
+    }
+    std::scoped_lock lock(mutex);
+    auto& queue = tasks[priority];
+    if (queue.empty()) {
+      return false;
+    }
+    task = std::move(queue.front());
+    queue.pop_front();
+    task_counts[priority]--;
+    return true;
+  }
+};
+
 std::shared_ptr<ConcurrentMessageLoop> ConcurrentMessageLoop::Create(
     size_t worker_count) {
   return std::shared_ptr<ConcurrentMessageLoop>{
@@ -19,16 +56,20 @@ std::shared_ptr<ConcurrentMessageLoop> ConcurrentMessageLoop::Create(
 
 ConcurrentMessageLoop::ConcurrentMessageLoop(size_t worker_count)
     : worker_count_(std::max<size_t>(worker_count, 1ul)) {
+  for (size_t i = 0; i < worker_count_; ++i) {
+    worker_states_.emplace_back(std::make_unique<Worker>());
+  }
+
   for (size_t i = 0; i < worker_count_; ++i) {
     workers_.emplace_back([i, this]() {
       fml::Thread::SetCurrentThreadName(
           std::string{"io.worker." + std::to_string(i + 1)});
-      WorkerMain();
+      WorkerMain(i);
     });
   }
 
-  for (const auto& worker : workers_) {
-    worker_thread_ids_.emplace_back(worker.get_id());
+  for (size_t i = 0; i < worker_count_; ++i) {
+    worker_states_[i]->thread_id = workers_[i].get_id();
   }
 }
 
@@ -47,80 +88,132 @@ std::shared_ptr<ConcurrentTaskRunner> ConcurrentMessageLoop::GetTaskRunner() {
   return std::make_shared<ConcurrentTaskRunner>(weak_from_this());
 }
 
-void ConcurrentMessageLoop::PostTask(const fml::closure& task) {
+ConcurrentMessageLoop::Worker& ConcurrentMessageLoop::GetWorkerForPost() {
+  // Keep tasks posted by a worker on that worker. They are likely to share
+  // data with the task that posted them and other workers can still steal
+  // them.
+  const auto current_thread_id = std::this_thread::get_id();
+  for (const auto& worker : worker_states_) {
+    if (worker->thread_id == current_thread_id) {
+      return *worker;
+    }
+  }
+  return *worker_states_[next_worker_.fetch_add(1, std::memory_order_relaxed) %
+                         worker_count_];
+}
+
+void ConcurrentMessageLoop::PostTask(const fml::closure& task,
+                                     ConcurrentTaskPriority priority) {
   if (!task) {
     return;
   }
 
-  std::unique_lock lock(tasks_mutex_);
-
   // Don't just drop tasks on the floor in case of shutdown.
   if (shutdown_) {
     FML_DLOG(WARNING)
         << "Tried to post a task to shutdown concurrent message "
            "loop. The task will be executed on the callers thread.";
-    lock.unlock();
     task();
     return;
   }
 
-  tasks_.push(task);
-
-  // Unlock the mutex before notifying the condition variable because that mutex
-  // has to be acquired on the other thread anyway. Waiting in this scope till
-  // it is acquired there is a pessimization.
-  lock.unlock();
+  const size_t priority_index = static_cast<size_t>(priority);
+  Worker& worker = GetWorkerForPost();
+  {
+    std::scoped_lock lock(worker.mutex);
+    worker.tasks[priority_index].push_back(task);
+    worker.task_counts[priority_index]++;
+    pending_tasks_++;
+  }
 
-  tasks_condition_.notify_one();
+  WakeUpWorker();
 }
 
-void ConcurrentMessageLoop::WorkerMain() {
-  while (true) {
-    std::unique_lock lock(tasks_mutex_);
-    tasks_condition_.wait(lock, [&]() {
-      return tasks_.size() > 0 || shutdown_ || HasThreadTasksLocked();
-    });
-
-    // Shutdown cannot be read with the task mutex unlocked.
-    bool shutdown_now = shutdown_;
-    fml::closure task;
-    std::vector<fml::closure> thread_tasks;
+void ConcurrentMessageLoop::WakeUpWorker() {
+  // If no worker is sleeping, the busy ones will find the task once they are
+  // done with what they are running.
+  if (sleeping_workers_ == 0) {
+    return;
+  }
+  std::scoped_lock lock(sleep_mutex_);
+  // Coalesce wake ups: a sleeping worker that has already been notified will
+  // pick up this task as well as the one it was notified for.
+  if (sleeping_workers_ > notified_workers_) {
+    notified_workers_++;
+    sleep_condition_.notify_one();
+  }
+}
 
-    if (tasks_.size() != 0) {
-      task = tasks_.front();
-      tasks_.pop();
+bool ConcurrentMessageLoop::RunNextTask(size_t index) {
+  fml::closure task;
+  for (size_t priority = 0; priority < kPriorityCount; ++priority) {
+    // Own queue first, then steal from the other workers in turn.
+    for (size_t i = 0; i < worker_count_; ++i) {
+      Worker& worker = *worker_states_[(index + i) % worker_count_];
+      if (worker.PopTask(priority, task)) {
+        pending_tasks_--;
+        task();
+        return true;
+      }
     }
+  }
+  return false;
+}
 
-    if (HasThreadTasksLocked()) {
-      thread_tasks = GetThreadTasksLocked();
-      FML_DCHECK(!HasThreadTasksLocked());
-    }
+void ConcurrentMessageLoop::RunThreadTasks(Worker& worker) {
+  if (!worker.has_thread_tasks) {
+    return;
+  }
+  std::vector<fml::closure> thread_tasks;
+  {
+    std::scoped_lock lock(worker.mutex);
+    std::swap(thread_tasks, worker.thread_tasks);
+    worker.has_thread_tasks = false;
+  }
+  for (const auto& thread_task : thread_tasks) {
+    thread_task();
+  }
+}
 
-    // Don't hold onto the mutex while tasks are being executed as they could
-    // themselves try to post more tasks to the message loop.
-    lock.unlock();
+void ConcurrentMessageLoop::WorkerMain(size_t index) {
+  Worker& worker = *worker_states_[index];
+  while (true) {
+    RunThreadTasks(worker);
 
-    TRACE_EVENT0("flutter", "ConcurrentWorkerWake");
-    // Execute the primary task we woke up for.
-    if (task) {
-      task();
+    if (shutdown_) {
+      break;
     }
 
-    // Execute any thread tasks.
-    for (const auto& thread_task : thread_tasks) {
-      thread_task();
+    if (RunNextTask(index)) {
+      continue;
     }
 
-    if (shutdown_now) {
-      break;
+    std::unique_lock lock(sleep_mutex_);
+    // Announce that this worker is about to sleep before checking for work
+    // one last time. Posters increment the pending count before checking for
+    // sleeping workers, so either this worker sees the task or the poster
+    // sees this worker.
+    sleeping_workers_++;
+    while (pending_tasks_ == 0 && !worker.has_thread_tasks && !shutdown_) {
+      sleep_condition_.wait(lock);
+      // Consume the notification even if another worker got to the task
+      // first. Otherwise this worker would go back to sleep counted as
+      // notified and later posters would not wake it up.
+      if (notified_workers_ > 0) {
+        notified_workers_--;
+      }
     }
+    sleeping_workers_--;
+    lock.unlock();
+
+    TRACE_EVENT0("flutter", "ConcurrentWorkerWake");
   }
 }
 
 void ConcurrentMessageLoop::Terminate() {
-  std::scoped_lock lock(tasks_mutex_);
+  std::scoped_lock lock(sleep_mutex_);
   shutdown_ = true;
-  tasks_condition_.notify_all();
+  sleep_condition_.notify_all();
 }
 
 void ConcurrentMessageLoop::PostTaskToAllWorkers(fml::closure task) {
@@ -128,24 +221,15 @@ void ConcurrentMessageLoop::PostTaskToAllWorkers(fml::closure task) {
     return;
   }
 
-  std::scoped_lock lock(tasks_mutex_);
-  for (const auto& worker_thread_id : worker_thread_ids_) {
-    thread_tasks_[worker_thread_id].emplace_back(task);
+  for (const auto& worker : worker_states_) {
+    std::scoped_lock lock(worker->mutex);
+    worker->thread_tasks.emplace_back(task);
+    worker->has_thread_tasks = true;
   }
-  tasks_condition_.notify_all();
-}
-
-bool ConcurrentMessageLoop::HasThreadTasksLocked() const {
-  return thread_tasks_.count(std::this_thread::get_id()) > 0;
-}
 
-std::vector<fml::closure> ConcurrentMessageLoop::GetThreadTasksLocked() {
-  auto found = thread_tasks_.find(std::this_thread::get_id());
-  FML_DCHECK(found != thread_tasks_.end());
-  std::vector<fml::closure> pending_tasks;
-  std::swap(pending_tasks, found->second);
-  thread_tasks_.erase(found);
-  return pending_tasks;
+  std::scoped_lock lock(sleep_mutex_);
+  notified_workers_ = sleeping_workers_;
+  sleep_condition_.notify_all();
 }
 
 ConcurrentTaskRunner::ConcurrentTaskRunner(
@@ -155,12 +239,18 @@ ConcurrentTaskRunner::ConcurrentTaskRunner(
 ConcurrentTaskRunner::~ConcurrentTaskRunner() = default;
 
 void ConcurrentTaskRunner::PostTask(const fml::closure& task) {
+  PostTaskWithPriority(task, ConcurrentTaskPriority::kNormal);
+}
+
+void ConcurrentTaskRunner::PostTaskWithPriority(
+    const fml::closure& task,
+    ConcurrentTaskPriority priority) {
   if (!task) {
     return;
   }
 
   if (auto loop = weak_loop_.lock()) {
-    loop->PostTask(task);
+    loop->PostTask(task, priority);
     return;
   }
 
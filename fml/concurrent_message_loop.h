@@ -5,10 +5,12 @@
 #ifndef FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 #define FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 
+#include <atomic>
 #include <condition_variable>
-#include <map>
-#include <queue>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/closure.h"
 #include "flutter/fml/macros.h"
@@ -18,6 +20,19 @@ namespace fml {
 
 class ConcurrentTaskRunner;
 
+// Tasks of higher priority are picked up by idle workers before tasks of lower
+// priority that are already queued. Tasks already running are not preempted.
+enum class ConcurrentTaskPriority {
+  kHigh,
+  kNormal,
+  kLow,
+};
+
+// Each worker owns a queue per priority. Tasks posted from a worker go to its
+// own queues and tasks posted from other threads are spread over the workers.
+// Idle workers steal from the queues of busy ones before going to sleep, and
+// posting skips the wake up when every sleeping worker has already been
+// notified.
 class ConcurrentMessageLoop
     : public std::enable_shared_from_this<ConcurrentMessageLoop> {
  public:
@@ -37,24 +52,38 @@ class ConcurrentMessageLoop
  private:
   friend ConcurrentTaskRunner;
 
+  struct Worker;
+
   size_t worker_count_ = 0;
+  std::vector<std::unique_ptr<Worker>> worker_states_;
   std::vector<std::thread> workers_;
-  std::mutex tasks_mutex_;
-  std::condition_variable tasks_condition_;
-  std::queue<fml::closure> tasks_;
-  std::vector<std::thread::id> worker_thread_ids_;
-  std::map<std::thread::id, std::vector<fml::closure>> thread_tasks_;
-  bool shutdown_ = false;
+  std::atomic_size_t next_worker_ = 0;
+  std::atomic_bool shutdown_ = false;
+
+  // The number of tasks queued on all workers. Together with
+  // |sleeping_workers_|, this lets posters skip the wake up when every worker
+  // is busy.
+  std::atomic_size_t pending_tasks_ = 0;
+  std::atomic_size_t sleeping_workers_ = 0;
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_condition_;
+  // Guarded by |sleep_mutex_|. The number of sleeping workers that have been
+  // notified but have not woken up yet.
+  size_t notified_workers_ = 0;
 
   ConcurrentMessageLoop(size_t worker_count);
 
-  void WorkerMain();
+  void WorkerMain(size_t index);
 
-  void PostTask(const fml::closure& task);
+  void PostTask(const fml::closure& task, ConcurrentTaskPriority priority);
 
-  bool HasThreadTasksLocked() const;
+  Worker& GetWorkerForPost();
 
-  std::vector<fml::closure> GetThreadTasksLocked();
+  bool RunNextTask(size_t index);
+
+  void RunThreadTasks(Worker& worker);
+
+  void WakeUpWorker();
 
   FML_DISALLOW_COPY_AND_ASSIGN(ConcurrentMessageLoop);
 };
@@ -67,6 +96,9 @@ class ConcurrentTaskRunner : public BasicTaskRunner {
 
   void PostTask(const fml::closure& task) override;
 
+  void PostTaskWithPriority(const fml::closure& task,
+                            ConcurrentTaskPriority priority);
+
  private:
   friend ConcurrentMessageLoop;
 
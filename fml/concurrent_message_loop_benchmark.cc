@@ -0,0 +1,123 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/concurrent_message_loop.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace fml {
+namespace benchmarking {
+
+static void BusyWork(TimeDelta duration) {
+  const auto end = TimePoint::Now() + duration;
+  while (TimePoint::Now() < end) {
+  }
+}
+
+// Posts |task_count| tasks that each run for |task_duration| and reports the
+// throughput along with the median and tail latency between posting a task
+// and the task starting to run.
+static void RunConcurrentLoopWorkload(benchmark::State& state,
+                                      size_t task_count,
+                                      TimeDelta task_duration) {
+  auto loop = ConcurrentMessageLoop::Create();
+  auto task_runner = loop->GetTaskRunner();
+  std::vector<TimeDelta> latencies(task_count);
+  std::vector<TimeDelta> all_latencies;
+
+  while (state.KeepRunning()) {
+    CountDownLatch latch(task_count);
+    for (size_t i = 0; i < task_count; ++i) {
+      task_runner->PostTask(
+          [&latencies, &latch, i, task_duration, posted = TimePoint::Now()]() {
+            latencies[i] = TimePoint::Now() - posted;
+            if (task_duration > TimeDelta::Zero()) {
+              BusyWork(task_duration);
+            }
+            latch.CountDown();
+          });
+    }
+    latch.Wait();
+    all_latencies.insert(all_latencies.end(), latencies.begin(),
+                         latencies.end());
+  }
+
+  std::sort(all_latencies.begin(), all_latencies.end());
+  auto percentile = [&all_latencies](double p) {
+    if (all_latencies.empty()) {
+      return 0.0;
+    }
+    const size_t index = std::min(
+        all_latencies.size() - 1,
+        static_cast<size_t>(p * static_cast<double>(all_latencies.size())));
+    return all_latencies[index].ToMicrosecondsF();
+  };
+  state.counters["p50_latency_us"] = percentile(0.5);
+  state.counters["p99_latency_us"] = percentile(0.99);
+  state.SetItemsProcessed(state.iterations() * task_count);
+}
+
+static void BM_ConcurrentLoopManyTinyTasks(benchmark::State& state) {
+  RunConcurrentLoopWorkload(state, state.range(0), TimeDelta::Zero());
+}
+
+static void BM_ConcurrentLoopFewLargeTasks(benchmark::State& state) {
+  RunConcurrentLoopWorkload(state, state.range(0),
+                            TimeDelta::FromMilliseconds(2));
+}
+
+// Measures how long high priority tasks wait behind a backlog of low priority
+// ones, e.g. decoding a visible image while images are being prefetched.
+static void BM_ConcurrentLoopHighPriorityLatencyUnderLoad(
+    benchmark::State& state) {
+  const size_t kBackgroundTaskCount = 256;
+  auto loop = ConcurrentMessageLoop::Create();
+  auto task_runner = loop->GetTaskRunner();
+  std::vector<TimeDelta> latencies;
+
+  while (state.KeepRunning()) {
+    CountDownLatch latch(kBackgroundTaskCount + 1);
+    for (size_t i = 0; i < kBackgroundTaskCount; ++i) {
+      task_runner->PostTaskWithPriority(
+          [&latch]() {
+            BusyWork(TimeDelta::FromMicroseconds(100));
+            latch.CountDown();
+          },
+          ConcurrentTaskPriority::kLow);
+    }
+    task_runner->PostTaskWithPriority(
+        [&latencies, &latch, posted = TimePoint::Now()]() {
+          latencies.push_back(TimePoint::Now() - posted);
+          latch.CountDown();
+        },
+        ConcurrentTaskPriority::kHigh);
+    latch.Wait();
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  if (!latencies.empty()) {
+    state.counters["p50_latency_us"] =
+        latencies[latencies.size() / 2].ToMicrosecondsF();
+    state.counters["max_latency_us"] = latencies.back().ToMicrosecondsF();
+  }
+}
+
+BENCHMARK(BM_ConcurrentLoopManyTinyTasks)
+    ->Arg(1 << 10)
+    ->Arg(1 << 14)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ConcurrentLoopFewLargeTasks)
+    ->Arg(8)
+    ->Arg(32)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ConcurrentLoopHighPriorityLatencyUnderLoad)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace benchmarking
+}  // namespace fml
@@ -36,19 +36,105 @@ class TaskSourceGradeHolder {
 };
 }  // namespace
 
-// Guarded by creation_mutex_.
 FML_THREAD_LOCAL ThreadLocalUniquePtr<TaskSourceGradeHolder>
     tls_task_source_grade;
 
+struct TaskQueueEntry::IncomingTask {
+  DelayedTask task;
+  IncomingTask* next;
+};
+
 TaskQueueEntry::TaskQueueEntry(TaskQueueId created_for_arg)
     : owner_of(_kUnmerged),
       subsumed_by(_kUnmerged),
-      created_for(created_for_arg) {
+      created_for(created_for_arg),
+      incoming_tasks_(nullptr) {
   wakeable = NULL;
   task_observers = TaskObservers();
   task_source = std::make_unique<TaskSource>(created_for);
 }
 
+TaskQueueEntry::~TaskQueueEntry() {
+  IncomingTask* incoming = incoming_tasks_.exchange(nullptr);
+  while (incoming) {
+    IncomingTask* next = incoming->next;
+    delete incoming;
+    incoming = next;
+  }
+}
+
+bool TaskQueueEntry::PushIncomingTask(const DelayedTask& task) {
+  IncomingTask* incoming = new IncomingTask{task, nullptr};
+  IncomingTask* head = incoming_tasks_.load(std::memory_order_relaxed);
+  do {
+    incoming->next = head;
+  } while (!incoming_tasks_.compare_exchange_weak(
+      head, incoming, std::memory_order_acq_rel, std::memory_order_relaxed));
+  return head == nullptr;
+}
+
+void TaskQueueEntry::DrainIncomingTasks() {
+  // The heap orders tasks by target time and registration order, so the
+  // reverse order of the stack does not matter.
+  IncomingTask* incoming =
+      incoming_tasks_.exchange(nullptr, std::memory_order_acq_rel);
+  while (incoming) {
+    task_source->RegisterTask(incoming->task);
+    IncomingTask* next = incoming->next;
+    delete incoming;
+    incoming = next;
+  }
+}
+
+// Locks the entry of a queue along with the entry of the queue it is merged
+// with, if any, and moves their incoming tasks into their task heaps.
+class MessageLoopTaskQueues::MergedQueuesLock {
+ public:
+  MergedQueuesLock(const MessageLoopTaskQueues& queues, TaskQueueId queue_id) {
+    TaskQueueEntry* entry = queues.GetEntry(queue_id);
+    for (;;) {
+      std::unique_lock entry_lock(entry->mutex);
+      const TaskQueueId partner = GetMergePartner(entry);
+      if (partner == _kUnmerged) {
+        entry_lock_ = std::move(entry_lock);
+        break;
+      }
+      TaskQueueEntry* partner_entry = queues.GetEntry(partner);
+      if (partner_entry->mutex.try_lock()) {
+        entry_lock_ = std::move(entry_lock);
+        partner_lock_ =
+            std::unique_lock(partner_entry->mutex, std::adopt_lock);
+        break;
+      }
+      // Avoid waiting on the partner while holding this entry's mutex.
+      entry_lock.unlock();
+      std::unique_lock partner_lock(partner_entry->mutex, std::defer_lock);
+      std::lock(entry_lock, partner_lock);
+      if (GetMergePartner(entry) == partner) {
+        entry_lock_ = std::move(entry_lock);
+        partner_lock_ = std::move(partner_lock);
+        break;
+      }
+      // The queue was merged or unmerged in the meantime. Try again.
+    }
+    entry->DrainIncomingTasks();
+    if (partner_lock_.owns_lock()) {
+      queues.GetEntry(GetMergePartner(entry))->DrainIncomingTasks();
+    }
+  }
+
+ private:
+  static TaskQueueId GetMergePartner(const TaskQueueEntry* entry) {
+    return entry->subsumed_by != _kUnmerged ? entry->subsumed_by
+                                            : entry->owner_of;
+  }
+
+  std::unique_lock<std::mutex> entry_lock_;
+  std::unique_lock<std::mutex> partner_lock_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(MergedQueuesLock);
+};
+
 fml::RefPtr<MessageLoopTaskQueues> MessageLoopTaskQueues::GetInstance() {
   std::scoped_lock creation(creation_mutex_);
   if (!instance_) {
@@ -62,40 +148,101 @@ fml::RefPtr<MessageLoopTaskQueues> MessageLoopTaskQueues::GetInstance() {
 TaskQueueId MessageLoopTaskQueues::CreateTaskQueue() {
   std::lock_guard guard(queue_mutex_);
   TaskQueueId loop_id = TaskQueueId(task_queue_id_counter_);
-  ++task_queue_id_counter_;
-  queue_entries_[loop_id] = std::make_unique<TaskQueueEntry>(loop_id);
+  if (free_queue_ids_.empty()) {
+    ++task_queue_id_counter_;
+  } else {
+    loop_id = free_queue_ids_.front();
+    free_queue_ids_.pop_front();
+  }
+  SetEntry(loop_id, new TaskQueueEntry(loop_id));
   return loop_id;
 }
 
 MessageLoopTaskQueues::MessageLoopTaskQueues()
-    : task_queue_id_counter_(0), order_(0) {}
+    : task_queue_id_counter_(0), order_(0) {
+  for (auto& block : queue_entry_blocks_) {
+    block.store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+MessageLoopTaskQueues::~MessageLoopTaskQueues() {
+  for (auto& block_slot : queue_entry_blocks_) {
+    QueueEntryBlock* block = block_slot.load(std::memory_order_relaxed);
+    if (!block) {
+      continue;
+    }
+    for (auto& entry : *block) {
+      delete entry.load(std::memory_order_relaxed);
+    }
+    delete block;
+  }
+}
 
-MessageLoopTaskQueues::~MessageLoopTaskQueues() = default;
+TaskQueueEntry* MessageLoopTaskQueues::GetEntry(TaskQueueId queue_id) const {
+  const size_t index = queue_id;
+  FML_CHECK(index < kMaxQueueEntryBlocks * kQueueEntriesPerBlock)
+      << "Invalid task queue id.";
+  const QueueEntryBlock* block =
+      queue_entry_blocks_[index / kQueueEntriesPerBlock].load(
+          std::memory_order_acquire);
+  FML_CHECK(block) << "Invalid task queue id.";
+  TaskQueueEntry* entry =
+      (*block)[index % kQueueEntriesPerBlock].load(std::memory_order_acquire);
+  FML_CHECK(entry) << "Invalid task queue id.";
+  return entry;
+}
+
+// Requires queue_mutex_.
+void MessageLoopTaskQueues::SetEntry(TaskQueueId queue_id,
+                                     TaskQueueEntry* entry) {
+  const size_t index = queue_id;
+  FML_CHECK(index < kMaxQueueEntryBlocks * kQueueEntriesPerBlock)
+      << "Too many live task queues.";
+  auto& block_slot = queue_entry_blocks_[index / kQueueEntriesPerBlock];
+  QueueEntryBlock* block = block_slot.load(std::memory_order_relaxed);
+  if (!block) {
+    block = new QueueEntryBlock();
+    for (auto& slot : *block) {
+      slot.store(nullptr, std::memory_order_relaxed);
+    }
+    block_slot.store(block, std::memory_order_release);
+  }
+  (*block)[index % kQueueEntriesPerBlock].store(entry,
+                                                std::memory_order_release);
+}
 
 void MessageLoopTaskQueues::Dispose(TaskQueueId queue_id) {
   std::lock_guard guard(queue_mutex_);
-  const auto& queue_entry = queue_entries_.at(queue_id);
-  FML_DCHECK(queue_entry->subsumed_by == _kUnmerged);
-  TaskQueueId subsumed = queue_entry->owner_of;
-  queue_entries_.erase(queue_id);
+  TaskQueueEntry* queue_entry = GetEntry(queue_id);
+  TaskQueueId subsumed = _kUnmerged;
+  {
+    std::lock_guard entry_guard(queue_entry->mutex);
+    FML_DCHECK(queue_entry->subsumed_by == _kUnmerged);
+    subsumed = queue_entry->owner_of;
+  }
+  SetEntry(queue_id, nullptr);
+  delete queue_entry;
+  free_queue_ids_.push_back(queue_id);
   if (subsumed != _kUnmerged) {
-    queue_entries_.erase(subsumed);
+    TaskQueueEntry* subsumed_entry = GetEntry(subsumed);
+    SetEntry(subsumed, nullptr);
+    delete subsumed_entry;
+    free_queue_ids_.push_back(subsumed);
   }
 }
 
 void MessageLoopTaskQueues::DisposeTasks(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
-  const auto& queue_entry = queue_entries_.at(queue_id);
+  MergedQueuesLock lock(*this, queue_id);
+  TaskQueueEntry* queue_entry = GetEntry(queue_id);
   FML_DCHECK(queue_entry->subsumed_by == _kUnmerged);
   TaskQueueId subsumed = queue_entry->owner_of;
   queue_entry->task_source->ShutDown();
   if (subsumed != _kUnmerged) {
-    queue_entries_.at(subsumed)->task_source->ShutDown();
+    GetEntry(subsumed)->task_source->ShutDown();
   }
 }
 
 TaskSourceGrade MessageLoopTaskQueues::GetCurrentTaskSourceGrade() {
-  std::scoped_lock creation(creation_mutex_);
   return tls_task_source_grade.get()->task_source_grade;
 }
 
@@ -104,11 +251,16 @@ void MessageLoopTaskQueues::RegisterTask(
     const fml::closure& task,
     fml::TimePoint target_time,
     fml::TaskSourceGrade task_source_grade) {
-  std::lock_guard guard(queue_mutex_);
   size_t order = order_++;
-  const auto& queue_entry = queue_entries_.at(queue_id);
-  queue_entry->task_source->RegisterTask(
-      {order, task, target_time, task_source_grade});
+  TaskQueueEntry* queue_entry = GetEntry(queue_id);
+  if (!queue_entry->PushIncomingTask(
+          {order, task, target_time, task_source_grade})) {
+    // The poster that found the incoming stack empty, or the consumer, will
+    // pick this task up and wake up the queue as needed.
+    return;
+  }
+
+  MergedQueuesLock lock(*this, queue_id);
   TaskQueueId loop_to_wake = queue_id;
   if (queue_entry->subsumed_by != _kUnmerged) {
     loop_to_wake = queue_entry->subsumed_by;
@@ -121,13 +273,13 @@ void MessageLoopTaskQueues::RegisterTask(
 }
 
 bool MessageLoopTaskQueues::HasPendingTasks(TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
+  MergedQueuesLock lock(*this, queue_id);
   return HasPendingTasksUnlocked(queue_id);
 }
 
 fml::closure MessageLoopTaskQueues::GetNextTaskToRun(TaskQueueId queue_id,
                                                      fml::TimePoint from_time) {
-  std::lock_guard guard(queue_mutex_);
+  MergedQueuesLock lock(*this, queue_id);
   if (!HasPendingTasksUnlocked(queue_id)) {
     return nullptr;
   }
@@ -143,11 +295,13 @@ fml::closure MessageLoopTaskQueues::GetNextTaskToRun(TaskQueueId queue_id,
     return nullptr;
   }
   fml::closure invocation = top.task.GetTask();
-  queue_entries_.at(top.task_queue_id)
-      ->task_source->PopTask(top.task.GetTaskSourceGrade());
-  {
-    std::scoped_lock creation(creation_mutex_);
-    const auto task_source_grade = top.task.GetTaskSourceGrade();
+  const auto task_source_grade = top.task.GetTaskSourceGrade();
+  GetEntry(top.task_queue_id)->task_source->PopTask(task_source_grade);
+  // The grade is thread local and does not need to be guarded.
+  TaskSourceGradeHolder* holder = tls_task_source_grade.get();
+  if (holder) {
+    holder->task_source_grade = task_source_grade;
+  } else {
     tls_task_source_grade.reset(new TaskSourceGradeHolder{task_source_grade});
   }
   return invocation;
@@ -155,14 +309,15 @@ fml::closure MessageLoopTaskQueues::GetNextTaskToRun(TaskQueueId queue_id,
 
 void MessageLoopTaskQueues::WakeUpUnlocked(TaskQueueId queue_id,
                                            fml::TimePoint time) const {
-  if (queue_entries_.at(queue_id)->wakeable) {
-    queue_entries_.at(queue_id)->wakeable->WakeUp(time);
+  Wakeable* wakeable = GetEntry(queue_id)->wakeable;
+  if (wakeable) {
+    wakeable->WakeUp(time);
   }
 }
 
 size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
-  const auto& queue_entry = queue_entries_.at(queue_id);
+  MergedQueuesLock lock(*this, queue_id);
+  const TaskQueueEntry* queue_entry = GetEntry(queue_id);
   if (queue_entry->subsumed_by != _kUnmerged) {
     return 0;
   }
@@ -172,7 +327,7 @@ size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
 
   TaskQueueId subsumed = queue_entry->owner_of;
   if (subsumed != _kUnmerged) {
-    const auto& subsumed_entry = queue_entries_.at(subsumed);
+    const TaskQueueEntry* subsumed_entry = GetEntry(subsumed);
     total_tasks += subsumed_entry->task_source->GetNumPendingTasks();
   }
   return total_tasks;
@@ -181,33 +336,36 @@ size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
 void MessageLoopTaskQueues::AddTaskObserver(TaskQueueId queue_id,
                                             intptr_t key,
                                             const fml::closure& callback) {
-  std::lock_guard guard(queue_mutex_);
+  TaskQueueEntry* queue_entry = GetEntry(queue_id);
+  std::lock_guard guard(queue_entry->mutex);
   FML_DCHECK(callback != nullptr) << "Observer callback must be non-null.";
-  queue_entries_.at(queue_id)->task_observers[key] = callback;
+  queue_entry->task_observers[key] = callback;
 }
 
 void MessageLoopTaskQueues::RemoveTaskObserver(TaskQueueId queue_id,
                                                intptr_t key) {
-  std::lock_guard guard(queue_mutex_);
-  queue_entries_.at(queue_id)->task_observers.erase(key);
+  TaskQueueEntry* queue_entry = GetEntry(queue_id);
+  std::lock_guard guard(queue_entry->mutex);
+  queue_entry->task_observers.erase(key);
 }
 
 std::vector<fml::closure> MessageLoopTaskQueues::GetObserversToNotify(
     TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
+  MergedQueuesLock lock(*this, queue_id);
   std::vector<fml::closure> observers;
+  const TaskQueueEntry* queue_entry = GetEntry(queue_id);
 
-  if (queue_entries_.at(queue_id)->subsumed_by != _kUnmerged) {
+  if (queue_entry->subsumed_by != _kUnmerged) {
     return observers;
   }
 
-  for (const auto& observer : queue_entries_.at(queue_id)->task_observers) {
+  for (const auto& observer : queue_entry->task_observers) {
     observers.push_back(observer.second);
   }
 
-  TaskQueueId subsumed = queue_entries_.at(queue_id)->owner_of;
+  TaskQueueId subsumed = queue_entry->owner_of;
   if (subsumed != _kUnmerged) {
-    for (const auto& observer : queue_entries_.at(subsumed)->task_observers) {
+    for (const auto& observer : GetEntry(subsumed)->task_observers) {
       observers.push_back(observer.second);
     }
   }
@@ -217,19 +375,19 @@ std::vector<fml::closure> MessageLoopTaskQueues::GetObserversToNotify(
 
 void MessageLoopTaskQueues::SetWakeable(TaskQueueId queue_id,
                                         fml::Wakeable* wakeable) {
-  std::lock_guard guard(queue_mutex_);
-  FML_CHECK(!queue_entries_.at(queue_id)->wakeable)
-      << "Wakeable can only be set once.";
-  queue_entries_.at(queue_id)->wakeable = wakeable;
+  TaskQueueEntry* queue_entry = GetEntry(queue_id);
+  std::lock_guard guard(queue_entry->mutex);
+  FML_CHECK(!queue_entry->wakeable) << "Wakeable can only be set once.";
+  queue_entry->wakeable = wakeable;
 }
 
 bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
   if (owner == subsumed) {
     return true;
   }
-  std::lock_guard guard(queue_mutex_);
-  auto& owner_entry = queue_entries_.at(owner);
-  auto& subsumed_entry = queue_entries_.at(subsumed);
+  TaskQueueEntry* owner_entry = GetEntry(owner);
+  TaskQueueEntry* subsumed_entry = GetEntry(subsumed);
+  std::scoped_lock guard(owner_entry->mutex, subsumed_entry->mutex);
 
   if (owner_entry->owner_of == subsumed) {
     return true;
@@ -248,6 +406,8 @@ bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
   owner_entry->owner_of = subsumed;
   subsumed_entry->subsumed_by = owner;
 
+  owner_entry->DrainIncomingTasks();
+  subsumed_entry->DrainIncomingTasks();
   if (HasPendingTasksUnlocked(owner)) {
     WakeUpUnlocked(owner, GetNextWakeTimeUnlocked(owner));
   }
@@ -256,14 +416,14 @@ bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
 }
 
 bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner) {
-  std::lock_guard guard(queue_mutex_);
-  const auto& owner_entry = queue_entries_.at(owner);
+  MergedQueuesLock lock(*this, owner);
+  TaskQueueEntry* owner_entry = GetEntry(owner);
   const TaskQueueId subsumed = owner_entry->owner_of;
   if (subsumed == _kUnmerged) {
     return false;
   }
 
-  queue_entries_.at(subsumed)->subsumed_by = _kUnmerged;
+  GetEntry(subsumed)->subsumed_by = _kUnmerged;
   owner_entry->owner_of = _kUnmerged;
 
   if (HasPendingTasksUnlocked(owner)) {
@@ -279,25 +439,30 @@ bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner) {
 
 bool MessageLoopTaskQueues::Owns(TaskQueueId owner,
                                  TaskQueueId subsumed) const {
-  std::lock_guard guard(queue_mutex_);
-  return owner != _kUnmerged && subsumed != _kUnmerged &&
-         subsumed == queue_entries_.at(owner)->owner_of;
+  if (owner == _kUnmerged || subsumed == _kUnmerged) {
+    return false;
+  }
+  TaskQueueEntry* owner_entry = GetEntry(owner);
+  std::lock_guard guard(owner_entry->mutex);
+  return subsumed == owner_entry->owner_of;
 }
 
 TaskQueueId MessageLoopTaskQueues::GetSubsumedTaskQueueId(
     TaskQueueId owner) const {
-  std::lock_guard guard(queue_mutex_);
-  return queue_entries_.at(owner)->owner_of;
+  TaskQueueEntry* owner_entry = GetEntry(owner);
+  std::lock_guard guard(owner_entry->mutex);
+  return owner_entry->owner_of;
 }
 
 void MessageLoopTaskQueues::PauseSecondarySource(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
-  queue_entries_.at(queue_id)->task_source->PauseSecondary();
+  TaskQueueEntry* queue_entry = GetEntry(queue_id);
+  std::lock_guard guard(queue_entry->mutex);
+  queue_entry->task_source->PauseSecondary();
 }
 
 void MessageLoopTaskQueues::ResumeSecondarySource(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
-  queue_entries_.at(queue_id)->task_source->ResumeSecondary();
+  MergedQueuesLock lock(*this, queue_id);
+  GetEntry(queue_id)->task_source->ResumeSecondary();
   // Schedule a wake as needed.
   if (HasPendingTasksUnlocked(queue_id)) {
     WakeUpUnlocked(queue_id, GetNextWakeTimeUnlocked(queue_id));
@@ -306,9 +471,11 @@ void MessageLoopTaskQueues::ResumeSecondarySource(TaskQueueId queue_id) {
 
 // Subsumed queues will never have pending tasks.
 // Owning queues will consider both their and their subsumed tasks.
+// Requires the entries of |queue_id| and its subsumed queue to be locked and
+// their incoming tasks drained.
 bool MessageLoopTaskQueues::HasPendingTasksUnlocked(
     TaskQueueId queue_id) const {
-  const auto& entry = queue_entries_.at(queue_id);
+  const TaskQueueEntry* entry = GetEntry(queue_id);
   bool is_subsumed = entry->subsumed_by != _kUnmerged;
   if (is_subsumed) {
     return false;
@@ -323,7 +490,7 @@ bool MessageLoopTaskQueues::HasPendingTasksUnlocked(
     // this is not an owner and queue is empty.
     return false;
   } else {
-    return !queue_entries_.at(subsumed)->task_source->IsEmpty();
+    return !GetEntry(subsumed)->task_source->IsEmpty();
   }
 }
 
@@ -335,14 +502,14 @@ fml::TimePoint MessageLoopTaskQueues::GetNextWakeTimeUnlocked(
 TaskSource::TopTask MessageLoopTaskQueues::PeekNextTaskUnlocked(
     TaskQueueId owner) const {
   FML_DCHECK(HasPendingTasksUnlocked(owner));
-  const auto& entry = queue_entries_.at(owner);
+  const TaskQueueEntry* entry = GetEntry(owner);
   const TaskQueueId subsumed = entry->owner_of;
   if (subsumed == _kUnmerged) {
     return entry->task_source->Top();
   }
 
   TaskSource* owner_tasks = entry->task_source.get();
-  TaskSource* subsumed_tasks = queue_entries_.at(subsumed)->task_source.get();
+  TaskSource* subsumed_tasks = GetEntry(subsumed)->task_source.get();
 
   // we are owning another task queue
   const bool subsumed_has_task = !subsumed_tasks->IsEmpty();
@@ -361,7 +528,7 @@ TaskSource::TopTask MessageLoopTaskQueues::PeekNextTaskUnlocked(
   } else {
     top_queue_id = subsumed;
   }
-  return queue_entries_.at(top_queue_id)->task_source->Top();
+  return GetEntry(top_queue_id)->task_source->Top();
 }
 
 }  // namespace fml
@@ -5,7 +5,11 @@
 #ifndef FLUTTER_FML_MESSAGE_LOOP_TASK_QUEUES_H_
 #define FLUTTER_FML_MESSAGE_LOOP_TASK_QUEUES_H_
 
+#include <array>
+#include <atomic>
+#include <deque>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -13,7 +17,6 @@
 #include "flutter/fml/delayed_task.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
-#include "flutter/fml/synchronization/shared_mutex.h"
 #include "flutter/fml/task_queue_id.h"
 #include "flutter/fml/task_source.h"
 #include "flutter/fml/wakeable.h"
@@ -40,9 +43,28 @@ class TaskQueueEntry {
 
   TaskQueueId created_for;
 
+  // Guards all of the above. A queue that is merged is always locked together
+  // with the queue it is merged with.
+  std::mutex mutex;
+
   explicit TaskQueueEntry(TaskQueueId created_for);
 
+  ~TaskQueueEntry();
+
+  // Adds a task to the incoming stack without taking |mutex|. Returns true if
+  // the stack was empty, in which case the caller is responsible for moving
+  // the incoming tasks into |task_source| and waking up the queue.
+  bool PushIncomingTask(const DelayedTask& task);
+
+  // Moves the incoming tasks into |task_source|. Requires |mutex|.
+  void DrainIncomingTasks();
+
  private:
+  struct IncomingTask;
+
+  // Lock-free intake for tasks registered from any thread.
+  std::atomic<IncomingTask*> incoming_tasks_;
+
   FML_DISALLOW_COPY_ASSIGN_AND_MOVE(TaskQueueEntry);
 };
 
@@ -54,6 +76,12 @@ enum class FlushType {
 // This class keeps track of all the tasks and observers that
 // need to be run on it's MessageLoopImpl. This also wakes up the
 // loop at the required times.
+//
+// There is no lock shared by all queues. Entries are looked up without
+// locking and each entry has its own mutex, so loops of unrelated engines do
+// not contend with one another. Registering a task pushes it onto a lock-free
+// stack; the entry's mutex is only taken by the poster that finds the stack
+// empty, and by the consumer, which moves incoming tasks into the task heap.
 class MessageLoopTaskQueues
     : public fml::RefCountedThreadSafe<MessageLoopTaskQueues> {
  public:
@@ -127,12 +155,22 @@ class MessageLoopTaskQueues
   void ResumeSecondarySource(TaskQueueId queue_id);
 
  private:
-  class MergedQueuesRunner;
+  class MergedQueuesLock;
+
+  static constexpr size_t kQueueEntriesPerBlock = 256;
+  static constexpr size_t kMaxQueueEntryBlocks = 4096;
+
+  using QueueEntryBlock =
+      std::array<std::atomic<TaskQueueEntry*>, kQueueEntriesPerBlock>;
 
   MessageLoopTaskQueues();
 
   ~MessageLoopTaskQueues();
 
+  TaskQueueEntry* GetEntry(TaskQueueId queue_id) const;
+
+  void SetEntry(TaskQueueId queue_id, TaskQueueEntry* entry);
+
   void WakeUpUnlocked(TaskQueueId queue_id, fml::TimePoint time) const;
 
   bool HasPendingTasksUnlocked(TaskQueueId queue_id) const;
@@ -144,11 +182,18 @@ class MessageLoopTaskQueues
   static std::mutex creation_mutex_;
   static fml::RefPtr<MessageLoopTaskQueues> instance_;
 
-  mutable std::mutex queue_mutex_;
-  std::map<TaskQueueId, std::unique_ptr<TaskQueueEntry>> queue_entries_;
+  // Guards the creation and disposal of queues. Lookups do not take it.
+  std::mutex queue_mutex_;
+  std::array<std::atomic<QueueEntryBlock*>, kMaxQueueEntryBlocks>
+      queue_entry_blocks_;
 
   size_t task_queue_id_counter_;
 
+  // The ids of disposed queues, reused by new queues in the order they were
+  // freed so that the blocks do not run out over the life of the process.
+  // Guarded by |queue_mutex_|.
+  std::deque<TaskQueueId> free_queue_ids_;
+
   std::atomic_int order_;
 
   FML_FRIEND_MAKE_REF_COUNTED(MessageLoopTaskQueues);
@@ -16,15 +16,16 @@ namespace fml {
 namespace benchmarking {
 
 static void BM_RegisterAndGetTasks(benchmark::State& state) {  // NOLINT
+  const int num_task_queues = state.range(0);
   while (state.KeepRunning()) {
     auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
 
-    const int num_task_queues = 10;
     const int num_tasks_per_queue = 100;
     const fml::TimePoint past = fml::TimePoint::Now();
 
+    std::vector<TaskQueueId> queue_ids;
     for (int i = 0; i < num_task_queues; i++) {
-      task_queue->CreateTaskQueue();
+      queue_ids.push_back(task_queue->CreateTaskQueue());
     }
 
     std::vector<std::thread> threads;
@@ -33,11 +34,11 @@ static void BM_RegisterAndGetTasks(benchmark::State& state) {  // NOLINT
     CountDownLatch tasks_done(num_task_queues);
 
     for (int i = 0; i < num_task_queues; i++) {
-      threads.emplace_back([task_runner_id = i, &task_queue, past, &tasks_done,
-                            &tasks_registered]() {
+      threads.emplace_back([queue_id = queue_ids[i], &task_queue, past,
+                            &tasks_done, &tasks_registered]() {
         for (int j = 0; j < num_tasks_per_queue; j++) {
           task_queue->RegisterTask(
-              TaskQueueId(task_runner_id), [] {}, past);
+              queue_id, [] {}, past);
         }
         tasks_registered.CountDown();
         tasks_registered.Wait();
@@ -45,7 +46,7 @@ static void BM_RegisterAndGetTasks(benchmark::State& state) {  // NOLINT
         int num_invocations = 0;
         for (;;) {
           fml::closure invocation =
-              task_queue->GetNextTaskToRun(TaskQueueId(task_runner_id), now);
+              task_queue->GetNextTaskToRun(queue_id, now);
           if (!invocation) {
             break;
           }
@@ -61,10 +62,70 @@ static void BM_RegisterAndGetTasks(benchmark::State& state) {  // NOLINT
     for (auto& thread : threads) {
       thread.join();
     }
+
+    for (auto queue_id : queue_ids) {
+      task_queue->Dispose(queue_id);
+    }
+  }
+}
+
+// Every thread drains its own queue while posting to the queue of the next
+// thread, the way the threads of many engines in one process post to each
+// other.
+static void BM_CrossThreadPostAndRunTasks(benchmark::State& state) {  // NOLINT
+  const int num_task_queues = state.range(0);
+  const int num_tasks_per_queue = 100;
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+
+  while (state.KeepRunning()) {
+    std::vector<TaskQueueId> queue_ids;
+    for (int i = 0; i < num_task_queues; i++) {
+      queue_ids.push_back(task_queue->CreateTaskQueue());
+    }
+
+    CountDownLatch threads_ready(num_task_queues);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_task_queues; i++) {
+      threads.emplace_back([&task_queue, &threads_ready,
+                            queue_id = queue_ids[i],
+                            target_id =
+                                queue_ids[(i + 1) % num_task_queues]]() {
+        threads_ready.CountDown();
+        threads_ready.Wait();
+        int num_posted = 0;
+        int num_invocations = 0;
+        while (num_invocations < num_tasks_per_queue) {
+          if (num_posted < num_tasks_per_queue) {
+            task_queue->RegisterTask(
+                target_id, [] {}, fml::TimePoint::Now());
+            num_posted++;
+          }
+          fml::closure invocation =
+              task_queue->GetNextTaskToRun(queue_id, fml::TimePoint::Now());
+          if (invocation) {
+            invocation();
+            num_invocations++;
+          } else if (num_posted == num_tasks_per_queue) {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    for (auto queue_id : queue_ids) {
+      task_queue->Dispose(queue_id);
+    }
   }
+  state.SetItemsProcessed(state.iterations() * num_task_queues *
+                          num_tasks_per_queue);
 }
 
-BENCHMARK(BM_RegisterAndGetTasks);
+BENCHMARK(BM_RegisterAndGetTasks)->Arg(10)->Arg(64)->Arg(128);
+BENCHMARK(BM_CrossThreadPostAndRunTasks)->Arg(10)->Arg(64)->Arg(128);
 
 }  // namespace benchmarking
 }  // namespace fml
@@ -6,7 +6,9 @@
 
 #include "flutter/fml/message_loop_task_queues.h"
 
+#include <atomic>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/synchronization/waitable_event.h"
@@ -290,5 +292,107 @@ TEST(MessageLoopTaskQueue, RegisterTaskWakesUpOwnerQueue) {
   ASSERT_EQ(time1, wakes[2]);
 }
 
+TEST(MessageLoopTaskQueue, ConcurrentRegisterFromManyThreads) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queue->CreateTaskQueue();
+
+  const int num_threads = 8;
+  const int num_tasks_per_thread = 1000;
+  std::atomic_int num_wakes = 0;
+  task_queue->SetWakeable(
+      queue_id, new TestWakeable(
+                    [&num_wakes](fml::TimePoint wake_time) { ++num_wakes; }));
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back([&task_queue, queue_id]() {
+      for (int j = 0; j < num_tasks_per_thread; j++) {
+        task_queue->RegisterTask(
+            queue_id, []() {}, fml::TimePoint::Now());
+      }
+    });
+  }
+
+  // Drain concurrently with the posting threads.
+  int num_invocations = 0;
+  while (num_invocations < num_threads * num_tasks_per_thread) {
+    fml::closure invocation =
+        task_queue->GetNextTaskToRun(queue_id, fml::TimePoint::Max());
+    if (invocation) {
+      invocation();
+      num_invocations++;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_FALSE(task_queue->HasPendingTasks(queue_id));
+  ASSERT_GT(num_wakes, 0);
+  task_queue->Dispose(queue_id);
+}
+
+TEST(MessageLoopTaskQueue, ConcurrentRegisterPreservesOrderPerThread) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queue->CreateTaskQueue();
+
+  const int num_threads = 4;
+  const int num_tasks_per_thread = 500;
+  const auto now = fml::TimePoint::Now();
+  std::vector<int> last_seen(num_threads, -1);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back([&task_queue, &last_seen, queue_id, now, i]() {
+      for (int j = 0; j < num_tasks_per_thread; j++) {
+        task_queue->RegisterTask(
+            queue_id,
+            [&last_seen, i, j]() {
+              ASSERT_EQ(last_seen[i] + 1, j);
+              last_seen[i] = j;
+            },
+            now);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  while (fml::closure invocation =
+             task_queue->GetNextTaskToRun(queue_id, fml::TimePoint::Max())) {
+    invocation();
+  }
+  for (int i = 0; i < num_threads; i++) {
+    ASSERT_EQ(last_seen[i], num_tasks_per_thread - 1);
+  }
+  task_queue->Dispose(queue_id);
+}
+
+TEST(MessageLoopTaskQueue, ReusesIdsOfDisposedQueues) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queue->CreateTaskQueue();
+  task_queue->RegisterTask(
+      queue_id, []() {}, fml::TimePoint::Now());
+  task_queue->Dispose(queue_id);
+
+  // Ids are reused in the order the queues were disposed in, the ids of the
+  // queues other tests disposed come first.
+  std::vector<TaskQueueId> created_queue_ids;
+  bool reused = false;
+  for (int i = 0; i < 64 && !reused; i++) {
+    created_queue_ids.push_back(task_queue->CreateTaskQueue());
+    reused = created_queue_ids.back() == queue_id;
+  }
+  ASSERT_TRUE(reused);
+  ASSERT_FALSE(task_queue->HasPendingTasks(queue_id));
+  for (TaskQueueId created_queue_id : created_queue_ids) {
+    task_queue->Dispose(created_queue_id);
+  }
+}
+
 }  // namespace testing
 }  // namespace fml
@@ -7,7 +7,9 @@
 #include "flutter/fml/message_loop.h"
 
 #include <iostream>
+#include <set>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/concurrent_message_loop.h"
@@ -316,3 +318,97 @@ TEST(MessageLoop, CanCreateConcurrentMessageLoop) {
   latch.Wait();
   ASSERT_GE(thread_ids.size(), 1u);
 }
+
+TEST(MessageLoop, ConcurrentMessageLoopRunsHigherPriorityTasksFirst) {
+  auto loop = fml::ConcurrentMessageLoop::Create(1u);
+  auto task_runner = loop->GetTaskRunner();
+
+  // Keep the only worker busy while the other tasks are queued.
+  fml::AutoResetWaitableEvent worker_busy, release_worker;
+  task_runner->PostTask([&]() {
+    worker_busy.Signal();
+    release_worker.Wait();
+  });
+  worker_busy.Wait();
+
+  std::mutex order_mutex;
+  std::vector<fml::ConcurrentTaskPriority> order;
+  fml::CountDownLatch latch(3);
+  auto record = [&](fml::ConcurrentTaskPriority priority) {
+    return [&, priority]() {
+      std::scoped_lock lock(order_mutex);
+      order.push_back(priority);
+      latch.CountDown();
+    };
+  };
+  task_runner->PostTaskWithPriority(record(fml::ConcurrentTaskPriority::kLow),
+                                    fml::ConcurrentTaskPriority::kLow);
+  task_runner->PostTask(record(fml::ConcurrentTaskPriority::kNormal));
+  task_runner->PostTaskWithPriority(record(fml::ConcurrentTaskPriority::kHigh),
+                                    fml::ConcurrentTaskPriority::kHigh);
+
+  release_worker.Signal();
+  latch.Wait();
+  ASSERT_EQ(order.size(), 3u);
+  ASSERT_EQ(order[0], fml::ConcurrentTaskPriority::kHigh);
+  ASSERT_EQ(order[1], fml::ConcurrentTaskPriority::kNormal);
+  ASSERT_EQ(order[2], fml::ConcurrentTaskPriority::kLow);
+}
+
+TEST(MessageLoop, ConcurrentMessageLoopIdleWorkersStealTasks) {
+  auto loop = fml::ConcurrentMessageLoop::Create(2u);
+  auto task_runner = loop->GetTaskRunner();
+
+  // A task posted from a worker is queued on that worker. Since the worker
+  // then blocks until the task has run, the task has to be stolen by the
+  // other worker.
+  fml::AutoResetWaitableEvent done;
+  task_runner->PostTask([&]() {
+    fml::AutoResetWaitableEvent stolen;
+    std::thread::id poster = std::this_thread::get_id();
+    std::thread::id runner;
+    task_runner->PostTask([&]() {
+      runner = std::this_thread::get_id();
+      stolen.Signal();
+    });
+    stolen.Wait();
+    ASSERT_NE(poster, runner);
+    done.Signal();
+  });
+  done.Wait();
+}
+
+TEST(MessageLoop, ConcurrentMessageLoopPostTaskToAllWorkers) {
+  const size_t kWorkerCount = 4;
+  auto loop = fml::ConcurrentMessageLoop::Create(kWorkerCount);
+  fml::CountDownLatch latch(kWorkerCount);
+  std::mutex thread_ids_mutex;
+  std::set<std::thread::id> thread_ids;
+  loop->PostTaskToAllWorkers([&]() {
+    std::scoped_lock lock(thread_ids_mutex);
+    thread_ids.insert(std::this_thread::get_id());
+    latch.CountDown();
+  });
+  latch.Wait();
+  ASSERT_EQ(thread_ids.size(), kWorkerCount);
+}
+
+TEST(MessageLoop, ConcurrentMessageLoopRunsManyTasksFromManyThreads) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4u);
+  auto task_runner = loop->GetTaskRunner();
+  const size_t kThreadCount = 4;
+  const size_t kTaskCount = 1000;
+  fml::CountDownLatch latch(kThreadCount * kTaskCount);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kThreadCount; ++i) {
+    threads.emplace_back([&]() {
+      for (size_t j = 0; j < kTaskCount; ++j) {
+        task_runner->PostTask([&]() { latch.CountDown(); });
+      }
+    });
+  }
+  latch.Wait();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
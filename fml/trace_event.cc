@@ -6,11 +6,13 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cstring>
 #include <utility>
 
 #include "flutter/fml/ascii_trie.h"
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/trace_recorder.h"
 
 namespace fml {
 namespace tracing {
@@ -28,6 +30,22 @@ inline void FlutterTimelineEvent(const char* label,
                                  intptr_t argument_count,
                                  const char** argument_names,
                                  const char** argument_values) {
+  if (TraceRecorder::IsRecording()) {
+    TraceRecord* record = TraceRecordBegin(label, timestamp0,
+                                           timestamp1_or_async_id, type);
+    if (record != nullptr) {
+      for (intptr_t i = 0; i < argument_count &&
+                           record->argument_count < TraceRecord::kMaxArguments;
+           i++) {
+        TraceRecord::Argument& argument =
+            record->arguments[record->argument_count++];
+        argument.name = argument_names[i];
+        TraceRecordArgument(argument, argument_values[i]);
+      }
+      TraceRecorder::Commit(record);
+    }
+    return;
+  }
   if (gTimelineEventHandler && gAllowlist.Query(label)) {
     gTimelineEventHandler(label, timestamp0, timestamp1_or_async_id, type,
                           argument_count, argument_names, argument_values);
@@ -48,6 +66,36 @@ size_t TraceNonce() {
   return ++gLastItem;
 }
 
+void TraceRecordArgument(TraceRecord::Argument& argument, const char* value) {
+  argument.type = TraceRecord::ArgumentType::kString;
+  size_t length = 0;
+  if (value != nullptr) {
+    while (length < TraceRecord::kMaxStringLength && value[length] != '\0') {
+      length++;
+    }
+    memcpy(argument.string_value, value, length);
+  }
+  argument.string_value[length] = '\0';
+}
+
+TraceRecord* TraceRecordBegin(TraceArg name,
+                              int64_t timestamp_micros,
+                              TraceIDArg identifier,
+                              Dart_Timeline_Event_Type type) {
+  if (!gAllowlist.Query(name)) {
+    return nullptr;
+  }
+  TraceRecord* record = TraceRecorder::Reserve();
+  if (record != nullptr) {
+    record->name = name;
+    record->timestamp_micros = timestamp_micros;
+    record->id = identifier;
+    record->type = type;
+    record->argument_count = 0;
+  }
+  return record;
+}
+
 void TraceTimelineEvent(TraceArg category_group,
                         TraceArg name,
                         int64_t timestamp_micros,
@@ -293,6 +341,15 @@ void TraceEventFlowEnd0(TraceArg category_group, TraceArg name, TraceIDArg id) {
 
 void TraceSetAllowlist(const std::vector<std::string>& allowlist) {}
 
+void TraceRecordArgument(TraceRecord::Argument& argument, const char* value) {}
+
+TraceRecord* TraceRecordBegin(TraceArg name,
+                              int64_t timestamp_micros,
+                              TraceIDArg identifier,
+                              Dart_Timeline_Event_Type type) {
+  return nullptr;
+}
+
 void TraceSetTimelineEventHandler(TimelineEventHandler handler) {}
 
 size_t TraceNonce() {
@@ -45,6 +45,7 @@
 
 #include "flutter/fml/macros.h"
 #include "flutter/fml/time/time_point.h"
+#include "flutter/fml/trace_recorder.h"
 #include "third_party/dart/runtime/include/dart_tools_api.h"
 
 #if (FLUTTER_RELEASE && !defined(OS_FUCHSIA))
@@ -217,6 +218,74 @@ SplitArguments(Key key, Value value, Args... args) {
   return std::make_pair(std::move(keys), std::move(values));
 }
 
+void TraceRecordArgument(TraceRecord::Argument& argument, const char* value);
+
+inline void TraceRecordArgument(TraceRecord::Argument& argument,
+                                const std::string& value) {
+  TraceRecordArgument(argument, value.c_str());
+}
+
+inline void TraceRecordArgument(TraceRecord::Argument& argument,
+                                TimePoint point) {
+  argument.type = TraceRecord::ArgumentType::kInt;
+  argument.int_value = point.ToEpochDelta().ToNanoseconds();
+}
+
+template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+void TraceRecordArgument(TraceRecord::Argument& argument, T value) {
+  if constexpr (std::is_floating_point<T>::value) {
+    argument.type = TraceRecord::ArgumentType::kDouble;
+    argument.double_value = value;
+  } else {
+    argument.type = TraceRecord::ArgumentType::kInt;
+    argument.int_value = static_cast<int64_t>(value);
+  }
+}
+
+inline void TraceRecordArguments(TraceRecord* record) {}
+
+template <typename Key, typename Value, typename... Args>
+void TraceRecordArguments(TraceRecord* record,
+                          Key key,
+                          Value value,
+                          Args... args) {
+  if (record->argument_count < TraceRecord::kMaxArguments) {
+    TraceRecord::Argument& argument =
+        record->arguments[record->argument_count++];
+    argument.name = key;
+    TraceRecordArgument(argument, value);
+  }
+  TraceRecordArguments(record, args...);
+}
+
+// Returns the record of a new event for the |TraceRecorder|, or null if the
+// event is filtered out or can not be recorded.
+TraceRecord* TraceRecordBegin(TraceArg name,
+                              int64_t timestamp_micros,
+                              TraceIDArg identifier,
+                              Dart_Timeline_Event_Type type);
+
+// Records an event with the |TraceRecorder| if it is recording. Unlike
+// |SplitArguments|, this does not convert the arguments to strings. Returns
+// whether the recorder took the event.
+template <typename... Args>
+bool TraceRecordEvent(TraceArg name,
+                      int64_t timestamp_micros,
+                      TraceIDArg identifier,
+                      Dart_Timeline_Event_Type type,
+                      Args... args) {
+  if (!TraceRecorder::IsRecording()) {
+    return false;
+  }
+  TraceRecord* record =
+      TraceRecordBegin(name, timestamp_micros, identifier, type);
+  if (record != nullptr) {
+    TraceRecordArguments(record, args...);
+    TraceRecorder::Commit(record);
+  }
+  return true;
+}
+
 size_t TraceNonce();
 
 template <typename... Args>
@@ -225,6 +294,10 @@ void TraceCounter(TraceArg category,
                   TraceIDArg identifier,
                   Args... args) {
 #if FLUTTER_TIMELINE_ENABLED
+  if (TraceRecordEvent(name, Dart_TimelineGetMicros(), identifier,
+                       Dart_Timeline_Event_Counter, args...)) {
+    return;
+  }
   auto split = SplitArguments(args...);
   TraceTimelineEvent(category, name, identifier, Dart_Timeline_Event_Counter,
                      split.first, split.second);
@@ -242,6 +315,10 @@ void TraceCounterNopHACK(TraceArg category,
 template <typename... Args>
 void TraceEvent(TraceArg category, TraceArg name, Args... args) {
 #if FLUTTER_TIMELINE_ENABLED
+  if (TraceRecordEvent(name, Dart_TimelineGetMicros(), 0,
+                       Dart_Timeline_Event_Begin, args...)) {
+    return;
+  }
   auto split = SplitArguments(args...);
   TraceTimelineEvent(category, name, 0, Dart_Timeline_Event_Begin, split.first,
                      split.second);
@@ -272,7 +349,6 @@ void TraceEventAsyncComplete(TraceArg category_group,
                              Args... args) {
 #if FLUTTER_TIMELINE_ENABLED
   auto identifier = TraceNonce();
-  const auto split = SplitArguments(args...);
 
   if (begin > end) {
     std::swap(begin, end);
@@ -281,6 +357,15 @@ void TraceEventAsyncComplete(TraceArg category_group,
   const int64_t begin_micros = begin.ToEpochDelta().ToMicroseconds();
   const int64_t end_micros = end.ToEpochDelta().ToMicroseconds();
 
+  if (TraceRecordEvent(name, begin_micros, identifier,
+                       Dart_Timeline_Event_Async_Begin, args...)) {
+    TraceRecordEvent(name, end_micros, identifier,
+                     Dart_Timeline_Event_Async_End, args...);
+    return;
+  }
+
+  const auto split = SplitArguments(args...);
+
   TraceTimelineEvent(category_group,                   // group
                      name,                             // name
                      begin_micros,                     // timestamp_micros
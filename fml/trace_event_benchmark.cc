@@ -0,0 +1,100 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/trace_event.h"
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/paths.h"
+#include "flutter/fml/trace_recorder.h"
+
+namespace fml {
+namespace benchmarking {
+
+// Runs |trace| with the events sent either to a timeline event handler that
+// ignores them, which measures the cost of preparing the events for the Dart
+// timeline, or to the |TraceRecorder|. The buffer of the recorder is drained
+// outside of the measured time so that no events are dropped.
+template <typename Func>
+static void RunTraceBenchmark(benchmark::State& state,
+                              bool use_recorder,
+                              Func trace) {
+  constexpr size_t kEventsPerThread = 1 << 12;
+  // Each call records at most two events.
+  constexpr size_t kCallsPerFlush = kEventsPerThread / 2;
+
+  fml::ScopedTemporaryDirectory directory;
+  if (use_recorder) {
+    tracing::TraceRecorder::Start(
+        fml::paths::JoinPaths({directory.path(), "trace.json"}),
+        kEventsPerThread, fml::TimeDelta::FromSeconds(3600));
+  } else {
+    tracing::TraceSetTimelineEventHandler(
+        [](const char*, int64_t, int64_t, Dart_Timeline_Event_Type, intptr_t,
+           const char**, const char**) {});
+  }
+  size_t calls = 0;
+  while (state.KeepRunning()) {
+    trace();
+    if (use_recorder && ++calls % kCallsPerFlush == 0) {
+      state.PauseTiming();
+      tracing::TraceRecorder::Flush();
+      state.ResumeTiming();
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (use_recorder) {
+    FML_CHECK(tracing::TraceRecorder::GetDroppedEventCount() == 0);
+    tracing::TraceRecorder::Stop();
+  } else {
+    tracing::TraceSetTimelineEventHandler(nullptr);
+  }
+}
+
+static void TraceScope() {
+  TRACE_EVENT0("flutter", "BenchmarkScope");
+}
+
+static void TraceScopeWithArguments() {
+  FML_TRACE_EVENT("flutter", "BenchmarkScope", "frame", 42, "elapsed", 1.5);
+}
+
+static void TraceCounter() {
+  FML_TRACE_COUNTER("flutter", "BenchmarkCounter", 1, "LayerCount", 12,
+                    "PictureCount", 34, "Hits", 56);
+}
+
+static void BM_TraceEventToTimeline(benchmark::State& state) {
+  RunTraceBenchmark(state, false, TraceScope);
+}
+BENCHMARK(BM_TraceEventToTimeline);
+
+static void BM_TraceEventToRecorder(benchmark::State& state) {
+  RunTraceBenchmark(state, true, TraceScope);
+}
+BENCHMARK(BM_TraceEventToRecorder);
+
+static void BM_TraceEventWithArgumentsToTimeline(benchmark::State& state) {
+  RunTraceBenchmark(state, false, TraceScopeWithArguments);
+}
+BENCHMARK(BM_TraceEventWithArgumentsToTimeline);
+
+static void BM_TraceEventWithArgumentsToRecorder(benchmark::State& state) {
+  RunTraceBenchmark(state, true, TraceScopeWithArguments);
+}
+BENCHMARK(BM_TraceEventWithArgumentsToRecorder);
+
+static void BM_TraceCounterToTimeline(benchmark::State& state) {
+  RunTraceBenchmark(state, false, TraceCounter);
+}
+BENCHMARK(BM_TraceCounterToTimeline);
+
+static void BM_TraceCounterToRecorder(benchmark::State& state) {
+  RunTraceBenchmark(state, true, TraceCounter);
+}
+BENCHMARK(BM_TraceCounterToRecorder);
+
+}  // namespace benchmarking
+}  // namespace fml
@@ -0,0 +1,307 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/trace_recorder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/thread.h"
+#include "flutter/fml/thread_local.h"
+
+namespace fml {
+namespace tracing {
+
+namespace {
+
+// A single producer, single consumer queue of the events of one thread. The
+// thread only writes the records between |write_index| and |read_index| plus
+// the capacity, the flusher only reads the ones between |read_index| and
+// |write_index|.
+struct ThreadBuffer {
+  ThreadBuffer(size_t capacity, int64_t thread_id)
+      : records(new TraceRecord[capacity]),
+        capacity(capacity),
+        thread_id(thread_id) {}
+
+  const std::unique_ptr<TraceRecord[]> records;
+  const size_t capacity;
+  const int64_t thread_id;
+  std::atomic<uint64_t> write_index = 0;
+  std::atomic<uint64_t> read_index = 0;
+  std::atomic<bool> thread_exited = false;
+};
+
+struct ThreadBufferHolder {
+  std::shared_ptr<ThreadBuffer> buffer;
+
+  ~ThreadBufferHolder() { buffer->thread_exited = true; }
+};
+
+FML_THREAD_LOCAL ThreadLocalUniquePtr<ThreadBufferHolder> tls_buffer;
+
+struct RecorderState {
+  // Guards all the fields but |dropped_event_count|.
+  std::mutex mutex;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  int64_t next_thread_id = 1;
+  size_t events_per_thread = TraceRecorder::kDefaultEventsPerThread;
+  std::ofstream file;
+  bool wrote_event = false;
+  std::unique_ptr<fml::Thread> flush_thread;
+  std::atomic<size_t> dropped_event_count = 0;
+};
+
+// Never destroyed, threads may record events during shutdown.
+RecorderState& GetState() {
+  static RecorderState* state = new RecorderState();
+  return *state;
+}
+
+ThreadBuffer& GetThreadBuffer() {
+  ThreadBufferHolder* holder = tls_buffer.get();
+  if (holder == nullptr) {
+    holder = new ThreadBufferHolder();
+    RecorderState& state = GetState();
+    {
+      std::scoped_lock lock(state.mutex);
+      holder->buffer = std::make_shared<ThreadBuffer>(state.events_per_thread,
+                                                      state.next_thread_id++);
+      state.buffers.push_back(holder->buffer);
+    }
+    tls_buffer.reset(holder);
+  }
+  return *holder->buffer;
+}
+
+const char* GetPhase(Dart_Timeline_Event_Type type) {
+  switch (type) {
+    case Dart_Timeline_Event_Begin:
+      return "B";
+    case Dart_Timeline_Event_End:
+      return "E";
+    case Dart_Timeline_Event_Instant:
+      return "i";
+    case Dart_Timeline_Event_Duration:
+      return "X";
+    case Dart_Timeline_Event_Async_Begin:
+      return "b";
+    case Dart_Timeline_Event_Async_End:
+      return "e";
+    case Dart_Timeline_Event_Async_Instant:
+      return "n";
+    case Dart_Timeline_Event_Counter:
+      return "C";
+    case Dart_Timeline_Event_Flow_Begin:
+      return "s";
+    case Dart_Timeline_Event_Flow_Step:
+      return "t";
+    case Dart_Timeline_Event_Flow_End:
+      return "f";
+    default:
+      return "i";
+  }
+}
+
+void WriteString(std::ostream& out, const char* string) {
+  static constexpr char kHexDigits[] = "0123456789abcdef";
+  out << '"';
+  for (const char* c = string ? string : ""; *c != '\0'; c++) {
+    if (*c == '"' || *c == '\\') {
+      out << '\\' << *c;
+    } else if (static_cast<unsigned char>(*c) < 0x20) {
+      out << "\\u00" << kHexDigits[*c >> 4] << kHexDigits[*c & 0xf];
+    } else {
+      out << *c;
+    }
+  }
+  out << '"';
+}
+
+void WriteRecord(std::ostream& out,
+                 const TraceRecord& record,
+                 int64_t thread_id) {
+  out << "{\"name\":";
+  WriteString(out, record.name);
+  out << ",\"cat\":\"flutter\",\"ph\":\"" << GetPhase(record.type)
+      << "\",\"ts\":" << record.timestamp_micros << ",\"pid\":0,\"tid\":"
+      << thread_id;
+  switch (record.type) {
+    case Dart_Timeline_Event_Instant:
+      out << ",\"s\":\"t\"";
+      break;
+    case Dart_Timeline_Event_Duration:
+      out << ",\"dur\":" << record.id - record.timestamp_micros;
+      break;
+    case Dart_Timeline_Event_Flow_End:
+      out << ",\"bp\":\"e\"";
+      [[fallthrough]];
+    case Dart_Timeline_Event_Async_Begin:
+    case Dart_Timeline_Event_Async_End:
+    case Dart_Timeline_Event_Async_Instant:
+    case Dart_Timeline_Event_Counter:
+    case Dart_Timeline_Event_Flow_Begin:
+    case Dart_Timeline_Event_Flow_Step:
+      out << ",\"id\":\"0x" << std::hex << record.id << std::dec << '"';
+      break;
+    default:
+      break;
+  }
+  if (record.argument_count > 0) {
+    out << ",\"args\":{";
+    for (size_t i = 0; i < record.argument_count; i++) {
+      const TraceRecord::Argument& argument = record.arguments[i];
+      if (i > 0) {
+        out << ',';
+      }
+      WriteString(out, argument.name);
+      out << ':';
+      switch (argument.type) {
+        case TraceRecord::ArgumentType::kInt:
+          out << argument.int_value;
+          break;
+        case TraceRecord::ArgumentType::kDouble:
+          if (std::isfinite(argument.double_value)) {
+            out << argument.double_value;
+          } else {
+            out << "null";
+          }
+          break;
+        case TraceRecord::ArgumentType::kString:
+          WriteString(out, argument.string_value);
+          break;
+      }
+    }
+    out << '}';
+  }
+  out << '}';
+}
+
+void ScheduleFlush(fml::RefPtr<fml::TaskRunner> task_runner,
+                   fml::TimeDelta interval) {
+  task_runner->PostDelayedTask(
+      [task_runner, interval]() {
+        if (!TraceRecorder::IsRecording()) {
+          return;
+        }
+        TraceRecorder::Flush();
+        ScheduleFlush(task_runner, interval);
+      },
+      interval);
+}
+
+}  // namespace
+
+std::atomic<bool> TraceRecorder::recording_ = false;
+
+bool TraceRecorder::Start(const std::string& path,
+                          size_t events_per_thread,
+                          fml::TimeDelta flush_interval) {
+  RecorderState& state = GetState();
+  std::scoped_lock lock(state.mutex);
+  if (recording_) {
+    return false;
+  }
+  state.file.open(path, std::ios::out | std::ios::trunc);
+  if (!state.file.is_open()) {
+    FML_LOG(ERROR) << "Could not open " << path << " to record a trace.";
+    return false;
+  }
+  state.file << '[';
+  state.wrote_event = false;
+  state.events_per_thread = std::max<size_t>(events_per_thread, 1);
+  state.dropped_event_count = 0;
+  // Discard the events left over from a previous recording.
+  for (const auto& buffer : state.buffers) {
+    buffer->read_index.store(buffer->write_index.load());
+  }
+  state.flush_thread = std::make_unique<fml::Thread>("io.flutter.trace");
+  recording_ = true;
+  ScheduleFlush(state.flush_thread->GetTaskRunner(), flush_interval);
+  return true;
+}
+
+void TraceRecorder::Stop() {
+  RecorderState& state = GetState();
+  std::unique_ptr<fml::Thread> flush_thread;
+  {
+    std::scoped_lock lock(state.mutex);
+    if (!recording_) {
+      return;
+    }
+    recording_ = false;
+    flush_thread = std::move(state.flush_thread);
+  }
+  flush_thread.reset();
+  Flush();
+
+  std::scoped_lock lock(state.mutex);
+  state.file << "\n]\n";
+  state.file.close();
+  if (state.dropped_event_count > 0) {
+    FML_LOG(WARNING) << "Dropped " << state.dropped_event_count
+                     << " trace events because the trace buffer of their "
+                        "thread was full.";
+  }
+}
+
+TraceRecord* TraceRecorder::Reserve() {
+  ThreadBuffer& buffer = GetThreadBuffer();
+  const uint64_t write_index =
+      buffer.write_index.load(std::memory_order_relaxed);
+  if (write_index - buffer.read_index.load(std::memory_order_acquire) >=
+      buffer.capacity) {
+    GetState().dropped_event_count.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  return &buffer.records[write_index % buffer.capacity];
+}
+
+void TraceRecorder::Commit(TraceRecord* record) {
+  ThreadBuffer& buffer = GetThreadBuffer();
+  const uint64_t write_index =
+      buffer.write_index.load(std::memory_order_relaxed);
+  FML_DCHECK(record == &buffer.records[write_index % buffer.capacity]);
+  buffer.write_index.store(write_index + 1, std::memory_order_release);
+}
+
+void TraceRecorder::Flush() {
+  RecorderState& state = GetState();
+  std::scoped_lock lock(state.mutex);
+  if (!state.file.is_open()) {
+    return;
+  }
+  std::vector<std::shared_ptr<ThreadBuffer>> live_buffers;
+  for (const auto& buffer : state.buffers) {
+    // A thread that is gone records no more events, so its buffer can be
+    // released once the events recorded so far have been written out.
+    if (!buffer->thread_exited.load()) {
+      live_buffers.push_back(buffer);
+    }
+    const uint64_t write_index =
+        buffer->write_index.load(std::memory_order_acquire);
+    uint64_t read_index = buffer->read_index.load(std::memory_order_relaxed);
+    for (; read_index < write_index; read_index++) {
+      state.file << (state.wrote_event ? ",\n" : "\n");
+      WriteRecord(state.file, buffer->records[read_index % buffer->capacity],
+                  buffer->thread_id);
+      state.wrote_event = true;
+    }
+    buffer->read_index.store(read_index, std::memory_order_release);
+  }
+  state.file.flush();
+  state.buffers = std::move(live_buffers);
+}
+
+size_t TraceRecorder::GetDroppedEventCount() {
+  return GetState().dropped_event_count;
+}
+
+}  // namespace tracing
+}  // namespace fml
@@ -0,0 +1,103 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_TRACE_RECORDER_H_
+#define FLUTTER_FML_TRACE_RECORDER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "third_party/dart/runtime/include/dart_tools_api.h"
+
+namespace fml {
+namespace tracing {
+
+/// A trace event as it is recorded by the |TraceRecorder|. Records have a
+/// fixed size so that recording one does not allocate. The name of the event
+/// and of its arguments must be string literals, string arguments are copied
+/// and truncated to |kMaxStringLength| characters.
+struct TraceRecord {
+  static constexpr size_t kMaxArguments = 6;
+  static constexpr size_t kMaxStringLength = 15;
+
+  enum class ArgumentType : uint8_t {
+    kInt,
+    kDouble,
+    kString,
+  };
+
+  struct Argument {
+    const char* name;
+    ArgumentType type;
+    union {
+      int64_t int_value;
+      double double_value;
+      char string_value[kMaxStringLength + 1];
+    };
+  };
+
+  const char* name;
+  int64_t timestamp_micros;
+  // The identifier of asynchronous events, flows and counters.
+  int64_t id;
+  Dart_Timeline_Event_Type type;
+  uint8_t argument_count;
+  Argument arguments[kMaxArguments];
+};
+
+/// Records trace events into a ring buffer per thread instead of sending
+/// them to the Dart timeline, and streams them to a file in the JSON array
+/// format of Chrome's trace event format, which can be opened in Perfetto
+/// and in chrome://tracing.
+///
+/// Recording an event only copies it into the buffer of the calling thread,
+/// without locks or allocations. A dedicated thread periodically moves the
+/// events from the buffers to the file. Events recorded while the buffer of
+/// a thread is full are dropped.
+class TraceRecorder {
+ public:
+  static constexpr size_t kDefaultEventsPerThread = 8192;
+
+  /// Starts recording the trace events of all threads into the file at
+  /// |path|, replacing its contents. Returns false if the file can not be
+  /// opened or if a recording is already in progress.
+  static bool Start(const std::string& path,
+                    size_t events_per_thread = kDefaultEventsPerThread,
+                    fml::TimeDelta flush_interval = fml::TimeDelta::FromSeconds(
+                        1));
+
+  /// Stops recording, and writes the remaining events to the file.
+  static void Stop();
+
+  static bool IsRecording() {
+    return recording_.load(std::memory_order_relaxed);
+  }
+
+  /// Returns the record for a new event in the buffer of the calling thread,
+  /// or null if the buffer is full. The event is recorded once the record
+  /// is passed to |Commit|.
+  static TraceRecord* Reserve();
+
+  static void Commit(TraceRecord* record);
+
+  /// Writes the events recorded so far to the file.
+  static void Flush();
+
+  /// The number of events dropped since recording started.
+  static size_t GetDroppedEventCount();
+
+ private:
+  static std::atomic<bool> recording_;
+
+  FML_DISALLOW_IMPLICIT_CONSTRUCTORS(TraceRecorder);
+};
+
+}  // namespace tracing
+}  // namespace fml
+
+#endif  // FLUTTER_FML_TRACE_RECORDER_H_
@@ -0,0 +1,119 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/trace_recorder.h"
+
+#include <string>
+#include <thread>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/paths.h"
+#include "flutter/fml/trace_event.h"
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace tracing {
+namespace testing {
+
+static std::string ReadTrace(fml::ScopedTemporaryDirectory& directory) {
+  auto mapping = fml::FileMapping::CreateReadOnly(directory.fd(), "trace.json");
+  if (!mapping || mapping->GetSize() == 0) {
+    return "";
+  }
+  return std::string(reinterpret_cast<const char*>(mapping->GetMapping()),
+                     mapping->GetSize());
+}
+
+static bool StartRecording(const fml::ScopedTemporaryDirectory& directory,
+                           size_t events_per_thread) {
+  return TraceRecorder::Start(
+      fml::paths::JoinPaths({directory.path(), "trace.json"}),
+      events_per_thread, fml::TimeDelta::FromSeconds(3600));
+}
+
+TEST(TraceRecorderTest, WritesEventsOfAllThreadsAsChromeTrace) {
+  fml::ScopedTemporaryDirectory directory;
+  ASSERT_TRUE(StartRecording(directory, 64));
+  EXPECT_TRUE(TraceRecorder::IsRecording());
+  // Only one recording at a time.
+  EXPECT_FALSE(StartRecording(directory, 64));
+
+  {
+    TRACE_EVENT1("flutter", "MainThreadScope", "label", "\"quoted\"");
+    FML_TRACE_COUNTER("flutter", "Counter", 0x1234, "Count", 3, "Ratio", 0.5);
+  }
+  std::thread thread([]() {
+    TRACE_EVENT_INSTANT0("flutter", "OtherThreadInstant");
+  });
+  thread.join();
+  TraceRecorder::Stop();
+  EXPECT_FALSE(TraceRecorder::IsRecording());
+
+  const std::string trace = ReadTrace(directory);
+  ASSERT_FALSE(trace.empty());
+  EXPECT_EQ(trace.front(), '[');
+  EXPECT_EQ(trace.substr(trace.size() - 2), "]\n");
+  EXPECT_NE(trace.find("{\"name\":\"MainThreadScope\",\"cat\":\"flutter\","
+                       "\"ph\":\"B\""),
+            std::string::npos);
+  EXPECT_NE(trace.find("\"args\":{\"label\":\"\\\"quoted\\\"\"}"),
+            std::string::npos);
+  EXPECT_NE(trace.find("\"name\":\"MainThreadScope\",\"cat\":\"flutter\","
+                       "\"ph\":\"E\""),
+            std::string::npos);
+  EXPECT_NE(trace.find("\"id\":\"0x1234\",\"args\":{\"Count\":3,"
+                       "\"Ratio\":0.5}"),
+            std::string::npos);
+  EXPECT_NE(trace.find("\"name\":\"OtherThreadInstant\",\"cat\":\"flutter\","
+                       "\"ph\":\"i\""),
+            std::string::npos);
+  // The events of the other thread are attributed to it.
+  const size_t main_tid = trace.find("\"tid\":", trace.find("MainThread"));
+  const size_t other_tid = trace.find("\"tid\":", trace.find("OtherThread"));
+  EXPECT_NE(trace.substr(main_tid, trace.find(',', main_tid) - main_tid),
+            trace.substr(other_tid, trace.find(',', other_tid) - other_tid));
+}
+
+TEST(TraceRecorderTest, DropsEventsWhenTheBufferIsFull) {
+  fml::ScopedTemporaryDirectory directory;
+  // The buffer of the calling thread may have been created by an earlier
+  // recording, in which case it keeps its size.
+  ASSERT_TRUE(StartRecording(directory, 8));
+  std::thread thread([]() {
+    for (int i = 0; i < 20; i++) {
+      TRACE_EVENT_INSTANT1("flutter", "Instant", "a very long string argument",
+                           "that is truncated");
+    }
+  });
+  thread.join();
+  EXPECT_EQ(TraceRecorder::GetDroppedEventCount(), 12u);
+  TraceRecorder::Stop();
+
+  const std::string trace = ReadTrace(directory);
+  size_t count = 0;
+  for (size_t i = trace.find("\"Instant\""); i != std::string::npos;
+       i = trace.find("\"Instant\"", i + 1)) {
+    count++;
+  }
+  EXPECT_EQ(count, 8u);
+  EXPECT_NE(trace.find("\"that is truncat\""), std::string::npos);
+}
+
+TEST(TraceRecorderTest, StringArgumentsAreCopied) {
+  fml::ScopedTemporaryDirectory directory;
+  ASSERT_TRUE(StartRecording(directory, 64));
+  {
+    std::string value = "short-lived";
+    TRACE_EVENT_INSTANT1("flutter", "Instant", "value", value.c_str());
+    value.assign(value.size(), 'x');
+  }
+  TraceRecorder::Stop();
+  EXPECT_NE(ReadTrace(directory).find("\"value\":\"short-lived\""),
+            std::string::npos);
+}
+
+}  // namespace testing
+}  // namespace tracing
+}  // namespace fml
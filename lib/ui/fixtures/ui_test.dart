@@ -57,6 +57,85 @@ void frameCallback(FrameInfo info) {
 @pragma('vm:entry-point')
 void messageCallback(dynamic data) {}
 
+// Records |count| rectangles, alternating between two paints every ten
+// rectangles, like a chart drawing its bars.
+@pragma('vm:entry-point')
+void recordRects(int count) {
+  final PictureRecorder recorder = PictureRecorder();
+  final Canvas canvas = Canvas(recorder);
+  final Paint fill = Paint()..color = const Color(0xFF2196F3);
+  final Paint stroke = Paint()
+    ..color = const Color(0xFF0D47A1)
+    ..style = PaintingStyle.stroke;
+  for (int i = 0; i < count; i++) {
+    final Offset offset = Offset((i % 100) * 10.0, (i ~/ 100) * 10.0);
+    canvas.drawRect(offset & const Size(8.0, 8.0), (i ~/ 10).isEven ? fill : stroke);
+  }
+  recorder.endRecording().dispose();
+}
+
+// Records a picture using every kind of call the canvas command buffer
+// batches, mixed with calls it does not, and hands it to the test.
+@pragma('vm:entry-point')
+void recordCanvasCommands() {
+  final PictureRecorder recorder = PictureRecorder();
+  final Canvas canvas = Canvas(recorder);
+  final Paint fill = Paint()..color = const Color(0xFF2196F3);
+  final Paint stroke = Paint()
+    ..color = const Color(0xFF0D47A1)
+    ..style = PaintingStyle.stroke
+    ..strokeWidth = 2.0;
+  final Paint gradient = Paint()
+    ..shader = Gradient.linear(
+        Offset.zero, const Offset(200.0, 0.0), <Color>[
+      const Color(0xFFFF0000),
+      const Color(0xFF00FF00),
+    ]);
+  final Path triangle = Path()
+    ..moveTo(10.0, 10.0)
+    ..lineTo(190.0, 10.0)
+    ..lineTo(100.0, 190.0)
+    ..close();
+
+  canvas.drawColor(const Color(0xFFFFFFFF), BlendMode.src);
+  canvas.save();
+  canvas.translate(5.0, 5.0);
+  canvas.scale(0.9, 0.95);
+  canvas.clipRRect(RRect.fromLTRBR(0.0, 0.0, 200.0, 200.0,
+      const Radius.circular(20.0)));
+  // Enough rectangles to fill the buffer several times, switching between
+  // paints with and without objects.
+  for (int i = 0; i < 2500; i++) {
+    final Paint paint = <Paint>[fill, stroke, gradient][(i ~/ 7) % 3];
+    final Offset offset = Offset((i % 50) * 4.0, (i ~/ 50) * 4.0);
+    canvas.drawRect(offset & const Size(3.0, 3.0), paint);
+  }
+  // A call that is not batched between calls with the same paint, which has
+  // to be encoded again after the flush. The order of the calls shows.
+  canvas.drawCircle(const Offset(100.0, 100.0), 60.0, gradient);
+  canvas.drawPath(triangle, fill);
+  canvas.drawCircle(const Offset(100.0, 100.0), 30.0, gradient);
+  canvas.clipPath(triangle);
+  canvas.drawOval(const Rect.fromLTRB(20.0, 40.0, 180.0, 120.0), stroke);
+  canvas.restore();
+  canvas.rotate(0.1);
+  canvas.skew(0.1, 0.0);
+  canvas.drawLine(Offset.zero, const Offset(200.0, 200.0), stroke);
+  canvas.drawRRect(RRect.fromLTRBR(120.0, 120.0, 190.0, 190.0,
+      const Radius.circular(10.0)), fill);
+  canvas.drawDRRect(
+      RRect.fromLTRBR(10.0, 120.0, 80.0, 190.0, const Radius.circular(10.0)),
+      RRect.fromLTRBR(20.0, 130.0, 70.0, 180.0, const Radius.circular(5.0)),
+      gradient);
+  canvas.drawArc(const Rect.fromLTRB(60.0, 60.0, 140.0, 140.0), 0.0, 2.0,
+      true, stroke);
+  canvas.clipRect(const Rect.fromLTRB(0.0, 0.0, 100.0, 100.0));
+  canvas.drawPaint(Paint()..color = const Color(0x40000000));
+  _captureCanvasCommandsPicture(recorder.endRecording());
+}
+void _captureCanvasCommandsPicture(Picture picture)
+    native 'CaptureCanvasCommandsPicture';
+
 @pragma('vm:entry-point')
 void validateConfiguration() native 'ValidateConfiguration';
 
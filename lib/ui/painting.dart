@@ -2010,6 +2010,54 @@ class Codec extends NativeFieldWrapperClass2 {
   void dispose() native 'Codec_dispose';
 }
 
+/// A [Codec] that decodes an image while its encoded bytes are still arriving,
+/// e.g. from the network, so that the part of the image received so far can be
+/// shown before the rest arrives.
+///
+/// Add the bytes with [addData] as they arrive, and call [setDataComplete]
+/// after the last of them. Each call to [getNextFrame] decodes as much of the
+/// image as the bytes added before it allow, and returns an image of the full
+/// size of the image in which the rows not decoded yet are transparent. It
+/// completes with an error if not even the header of the image has arrived.
+///
+/// PNG and GIF images resume decoding where they left off. JPEG images are
+/// decoded again from the start, but only once the data has grown by half since
+/// the last time. Other formats are decoded once all of their data has been
+/// added. Only the first frame of animated images is decoded.
+class ProgressiveCodec extends Codec {
+  /// Creates a codec for an image whose data will be added with [addData].
+  @pragma('vm:entry-point')
+  ProgressiveCodec() : super._() { _constructor(); }
+  void _constructor() native 'ProgressiveCodec_constructor';
+
+  bool _dataComplete = false;
+
+  /// Appends the next part of the encoded image.
+  ///
+  /// The data is taken over from the buffer, which can be disposed of once this
+  /// returns. Throws a [StateError] after [setDataComplete] has been called.
+  void addData(ImmutableBuffer buffer) {
+    if (_dataComplete) {
+      throw StateError('Data cannot be added once it is complete.');
+    }
+    final String? error = _addData(buffer);
+    if (error != null) {
+      throw Exception(error);
+    }
+  }
+  String? _addData(ImmutableBuffer buffer) native 'ProgressiveCodec_addData';
+
+  /// Marks the encoded image as complete.
+  ///
+  /// The next call to [getNextFrame] decodes whatever of the image the data
+  /// allows, even if it is truncated.
+  void setDataComplete() {
+    _dataComplete = true;
+    _setDataComplete();
+  }
+  void _setDataComplete() native 'ProgressiveCodec_setDataComplete';
+}
+
 /// Instantiates an image [Codec].
 ///
 /// This method is a convenience wrapper around the [ImageDescriptor] API, and
@@ -3856,6 +3904,142 @@ enum ClipOp {
   intersect,
 }
 
+// Encodes the calls made on a [Canvas] so that they are sent to the engine in
+// one native call, when the picture is finished or the buffer is full, instead
+// of one native call each.
+//
+// A paint is only encoded when it differs from the paint of the previous
+// command, so that the engine does not decode it again.
+//
+// The binary format must match the decoding code in canvas.cc.
+class _CanvasCommandBuffer {
+  _CanvasCommandBuffer(this._canvas);
+
+  static const int _kSetPaint = 0;
+  static const int _kSave = 1;
+  static const int _kRestore = 2;
+  static const int _kTranslate = 3;
+  static const int _kScale = 4;
+  static const int _kRotate = 5;
+  static const int _kSkew = 6;
+  static const int _kClipRect = 7;
+  static const int _kClipRRect = 8;
+  static const int _kDrawColor = 9;
+  static const int _kDrawLine = 10;
+  static const int _kDrawPaint = 11;
+  static const int _kDrawRect = 12;
+  static const int _kDrawRRect = 13;
+  static const int _kDrawDRRect = 14;
+  static const int _kDrawOval = 15;
+  static const int _kDrawCircle = 16;
+  static const int _kDrawArc = 17;
+
+  static const int _kByteCount = 16 << 10;
+  // A paint followed by the largest command, a drawDRRect.
+  static const int _kMaxCommandByteCount =
+      (2 << 2) + Paint._kDataByteCount + ((1 + 24) << 2);
+  static const int _kPaintWordCount = Paint._kDataByteCount >> 2;
+
+  final Canvas _canvas;
+  final ByteData _data = ByteData(_kByteCount);
+  int _byteCount = 0;
+
+  // The objects of the paints encoded since the last flush, three per paint.
+  final List<dynamic> _paintObjects = <dynamic>[];
+
+  // A copy of the last paint encoded since the last flush.
+  bool _hasPaint = false;
+  final Uint32List _paintData = Uint32List(_kPaintWordCount);
+  final List<dynamic> _paintDataObjects =
+      List<dynamic>.filled(Paint._kObjectCount, null, growable: false);
+  bool _paintHasObjects = false;
+
+  void _addCommand(int type, [Paint? paint]) {
+    if (_byteCount + _kMaxCommandByteCount > _kByteCount)
+      flush();
+    if (paint != null && !_isCurrentPaint(paint))
+      _addPaint(paint);
+    _addUint32(type);
+  }
+
+  void _addUint32(int value) {
+    _data.setUint32(_byteCount, value, _kFakeHostEndian);
+    _byteCount += 4;
+  }
+
+  void _addInt32(int value) {
+    _data.setInt32(_byteCount, value, _kFakeHostEndian);
+    _byteCount += 4;
+  }
+
+  void _addFloat(double value) {
+    _data.setFloat32(_byteCount, value, _kFakeHostEndian);
+    _byteCount += 4;
+  }
+
+  void _addRect(Rect rect) {
+    _addFloat(rect.left);
+    _addFloat(rect.top);
+    _addFloat(rect.right);
+    _addFloat(rect.bottom);
+  }
+
+  void _addRRect(RRect rrect) {
+    final Float32List value = rrect._value32;
+    for (int i = 0; i < value.length; i++)
+      _addFloat(value[i]);
+  }
+
+  bool _isCurrentPaint(Paint paint) {
+    if (!_hasPaint)
+      return false;
+    final ByteData data = paint._data;
+    for (int i = 0; i < _kPaintWordCount; i++) {
+      if (data.getUint32(i << 2, _kFakeHostEndian) != _paintData[i])
+        return false;
+    }
+    final List<dynamic>? objects = paint._objects;
+    if (objects == null)
+      return !_paintHasObjects;
+    if (!_paintHasObjects)
+      return false;
+    for (int i = 0; i < Paint._kObjectCount; i++) {
+      if (!identical(objects[i], _paintDataObjects[i]))
+        return false;
+    }
+    return true;
+  }
+
+  void _addPaint(Paint paint) {
+    _addUint32(_kSetPaint);
+    final List<dynamic>? objects = paint._objects;
+    _paintHasObjects = objects != null;
+    if (objects == null) {
+      _addInt32(-1);
+    } else {
+      _addInt32(_paintObjects.length ~/ Paint._kObjectCount);
+      _paintObjects.addAll(objects);
+      _paintDataObjects.setAll(0, objects);
+    }
+    final ByteData data = paint._data;
+    for (int i = 0; i < _kPaintWordCount; i++) {
+      final int word = data.getUint32(i << 2, _kFakeHostEndian);
+      _paintData[i] = word;
+      _addUint32(word);
+    }
+    _hasPaint = true;
+  }
+
+  void flush() {
+    if (_byteCount == 0)
+      return;
+    _canvas._executeCommands(_data, _byteCount, _paintObjects);
+    _byteCount = 0;
+    _paintObjects.clear();
+    _hasPaint = false;
+  }
+}
+
 /// An interface for recording graphical operations.
 ///
 /// [Canvas] objects are used in creating [Picture] objects, which can
@@ -3894,6 +4078,8 @@ class Canvas extends NativeFieldWrapperClass2 {
     _recorder!._canvas = this;
     cullRect ??= Rect.largest;
     _constructor(recorder, cullRect.left, cullRect.top, cullRect.right, cullRect.bottom);
+    if (_isCommandBufferEnabled)
+      _commands = _CanvasCommandBuffer(this);
   }
   void _constructor(PictureRecorder recorder,
                     double left,
@@ -3906,6 +4092,18 @@ class Canvas extends NativeFieldWrapperClass2 {
   // garbage collected until PictureRecorder.endRecording is called.
   PictureRecorder? _recorder;
 
+  // Batches the calls made on this canvas when the engine was started with
+  // --enable-canvas-command-buffer. The calls that are not batched flush it
+  // first, so that all the calls reach the engine in order.
+  _CanvasCommandBuffer? _commands;
+
+  static final bool _isCommandBufferEnabled = _getIsCommandBufferEnabled();
+  static bool _getIsCommandBufferEnabled() native 'Canvas_isCommandBufferEnabled';
+
+  void _executeCommands(ByteData commands,
+                        int byteCount,
+                        List<dynamic> paintObjects) native 'Canvas_executeCommands';
+
   /// Saves a copy of the current transform and clip on the save stack.
   ///
   /// Call [restore] to pop the save stack.
@@ -3914,7 +4112,15 @@ class Canvas extends NativeFieldWrapperClass2 {
   ///
   ///  * [saveLayer], which does the same thing but additionally also groups the
   ///    commands done until the matching [restore].
-  void save() native 'Canvas_save';
+  void save() {
+    final _CanvasCommandBuffer? commands = _commands;
+    if (commands != null) {
+      commands._addCommand(_CanvasCommandBuffer._kSave);
+      return;
+    }
+    _save();
+  }
+  void _save() native 'Canvas_save';
 
   /// Saves a copy of the current transform and clip on the save stack, and then
   /// creates a new group which subsequent calls will become a part of. When the
@@ -4027,6 +4233,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   ///    [saveLayer].
   void saveLayer(Rect? bounds, Paint paint) {
     assert(paint != null);
+    _commands?.flush();
     if (bounds == null) {
       _saveLayerWithoutBounds(paint._objects, paint._data);
     } else {
@@ -4051,7 +4258,15 @@ class Canvas extends NativeFieldWrapperClass2 {
   ///
   /// If the state was pushed with with [saveLayer], then this call will also
   /// cause the new layer to be composited into the previous layer.
-  void restore() native 'Canvas_restore';
+  void restore() {
+    final _CanvasCommandBuffer? commands = _commands;
+    if (commands != null) {
+      commands._addCommand(_CanvasCommandBuffer._kRestore);
+      return;
+    }
+    _restore();
+  }
+  void _restore() native 'Canvas_restore';
 
   /// Returns the number of items on the save stack, including the
   /// initial state. This means it returns 1 for a clean canvas, and
@@ -4059,11 +4274,26 @@ class Canvas extends NativeFieldWrapperClass2 {
   /// each matching call to [restore] decrements it.
   ///
   /// This number cannot go below 1.
-  int getSaveCount() native 'Canvas_getSaveCount';
+  int getSaveCount() {
+    _commands?.flush();
+    return _getSaveCount();
+  }
+  int _getSaveCount() native 'Canvas_getSaveCount';
 
   /// Add a translation to the current transform, shifting the coordinate space
   /// horizontally by the first argument and vertically by the second argument.
-  void translate(double dx, double dy) native 'Canvas_translate';
+  void translate(double dx, double dy) {
+    final _CanvasCommandBuffer? commands = _commands;
+    if (commands != null) {
+      commands
+        .._addCommand(_CanvasCommandBuffer._kTranslate)
+        .._addFloat(dx)
+        .._addFloat(dy);
+      return;
+    }
+    _translate(dx, dy);
+  }
+  void _translate(double dx, double dy) native 'Canvas_translate';
 
   /// Add an axis-aligned scale to the current transform, scaling by the first
   /// argument in the horizontal direction and the second in the vertical
@@ -4071,18 +4301,49 @@ class Canvas extends NativeFieldWrapperClass2 {
   ///
   /// If [sy] is unspecified, [sx] will be used for the scale in both
   /// directions.
-  void scale(double sx, [double? sy]) => _scale(sx, sy ?? sx);
+  void scale(double sx, [double? sy]) {
+    final _CanvasCommandBuffer? commands = _commands;
+    if (commands != null) {
+      commands
+        .._addCommand(_CanvasCommandBuffer._kScale)
+        .._addFloat(sx)
+        .._addFloat(sy ?? sx);
+      return;
+    }
+    _scale(sx, sy ?? sx);
+  }
 
   void _scale(double sx, double sy) native 'Canvas_scale';
 
   /// Add a rotation to the current transform. The argument is in radians clockwise.
-  void rotate(double radians) native 'Canvas_rotate';
+  void rotate(double radians) {
+    final _CanvasCommandBuffer? commands = _commands;
+    if (commands != null) {
+      commands
+        .._addCommand(_CanvasCommandBuffer._kRotate)
+        .._addFloat(radians);
+      return;
+    }
+    _rotate(radians);
+  }
+  void _rotate(double radians) native 'Canvas_rotate';
 
   /// Add an axis-aligned skew to the current transform, with the first argument
   /// being the horizontal skew in rise over run units clockwise around the
   /// origin, and the second argument being the vertical skew in rise over run
   /// units clockwise around the origin.
-  void skew(double sx, double sy) native 'Canvas_skew';
+  void skew(double sx, double sy) {
+    final _CanvasCommandBuffer? commands = _commands;
+    if (commands != null) {
+      commands
+        .._addCommand(_CanvasCommandBuffer._kSkew)
+        .._addFloat(sx)
+        .._addFloat(sy);
+      return;
+    }
+    _skew(sx, sy);
+  }
+  void _skew(double sx, double sy) native 'Canvas_skew';
 
   /// Multiply the current transform by the specified 4⨉4 transformation matrix
   /// specified as a list of values in column-major order.
@@ -4090,6 +4351,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(matrix4 != null);
     if (matrix4.length != 16)
       throw ArgumentError('"matrix4" must have 16 entries.');
+    _commands?.flush();
     _transform(matrix4);
   }
   void _transform(Float64List matrix4) native 'Canvas_transform';
@@ -4109,6 +4371,15 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(_rectIsValid(rect));
     assert(clipOp != null);
     assert(doAntiAlias != null);
+    final _CanvasCommandBuffer? commands = _commands;
+    if (commands != null) {
+      commands
+        .._addCommand(_CanvasCommandBuffer._kClipRect)
+        .._addRect(rect)
+        .._addUint32(clipOp.index)
+        .._addUint32(doAntiAlias ? 1 : 0);
+      return;
+    }
     _clipRect(rect.left, rect.top, rect.right, rect.bottom, clipOp.index, doAntiAlias);
   }
   void _clipRect(double left,
@@ -4129,6 +4400,14 @@ class Canvas extends NativeFieldWrapperClass2 {
   void clipRRect(RRect rrect, {bool doAntiAlias = true}) {
     assert(_rrectIsValid(rrect));
     assert(doAntiAlias != null);
+    final _CanvasCommandBuffer? commands = _commands;
+    if (commands != null) {
+      commands
+        .._addCommand(_CanvasCommandBuffer._kClipRRect)
+        .._addRRect(rrect)
+        .._addUint32(doAntiAlias ? 1 : 0);
+      return;
+    }
     _clipRRect(rrect._value32, doAntiAlias);
   }
   void _clipRRect(Float32List rrect, bool doAntiAlias) native 'Canvas_clipRRect';
@@ -4145,6 +4424,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   void clipPath(Path path, {bool doAntiAlias = true}) {
     assert(path != null); // path is checked on the engine side
     assert(doAntiAlias != null);
+    _commands?.flush();
     _clipPath(path, doAntiAlias);
   }
   void _clipPath(Path path, bool doAntiAlias) native 'Canvas_clipPath';
@@ -4155,6 +4435,14 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawColor(Color color, BlendMode blendMode) {
     assert(color != null);
     assert(blendMode != null);
+    final _CanvasCommandBuffer? commands = _commands;
+    if (commands != null) {
+      commands
+        .._addCommand(_CanvasCommandBuffer._kDrawColor)
+        .._addUint32(color.value)
+        .._addUint32(blendMode.index);
+      return;
+    }
     _drawColor(color.value, blendMode.index);
   }
   void _drawColor(int color, int blendMode) native 'Canvas_drawColor';
@@ -4167,6 +4455,16 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(_offsetIsValid(p1));
     assert(_offsetIsValid(p2));
     assert(paint != null);
+    final _CanvasCommandBuffer? commands = _commands;
+    if (commands != null) {
+      commands
+        .._addCommand(_CanvasCommandBuffer._kDrawLine, paint)
+        .._addFloat(p1.dx)
+        .._addFloat(p1.dy)
+        .._addFloat(p2.dx)
+        .._addFloat(p2.dy);
+      return;
+    }
     _drawLine(p1.dx, p1.dy, p2.dx, p2.dy, paint._objects, paint._data);
   }
   void _drawLine(double x1,
@@ -4182,6 +4480,11 @@ class Canvas extends NativeFieldWrapperClass2 {
   /// [drawColor] instead.
   void drawPaint(Paint paint) {
     assert(paint != null);
+    final _CanvasCommandBuffer? commands = _commands;
+    if (commands != null) {
+      commands._addCommand(_CanvasCommandBuffer._kDrawPaint, paint);
+      return;
+    }
     _drawPaint(paint._objects, paint._data);
   }
   void _drawPaint(List<dynamic>? paintObjects, ByteData paintData) native 'Canvas_drawPaint';
@@ -4191,6 +4494,13 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawRect(Rect rect, Paint paint) {
     assert(_rectIsValid(rect));
     assert(paint != null);
+    final _CanvasCommandBuffer? commands = _commands;
+    if (commands != null) {
+      commands
+        .._addCommand(_CanvasCommandBuffer._kDrawRect, paint)
+        .._addRect(rect);
+      return;
+    }
     _drawRect(rect.left, rect.top, rect.right, rect.bottom,
               paint._objects, paint._data);
   }
@@ -4206,6 +4516,13 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawRRect(RRect rrect, Paint paint) {
     assert(_rrectIsValid(rrect));
     assert(paint != null);
+    final _CanvasCommandBuffer? commands = _commands;
+    if (commands != null) {
+      commands
+        .._addCommand(_CanvasCommandBuffer._kDrawRRect, paint)
+        .._addRRect(rrect);
+      return;
+    }
     _drawRRect(rrect._value32, paint._objects, paint._data);
   }
   void _drawRRect(Float32List rrect,
@@ -4221,6 +4538,14 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(_rrectIsValid(outer));
     assert(_rrectIsValid(inner));
     assert(paint != null);
+    final _CanvasCommandBuffer? commands = _commands;
+    if (commands != null) {
+      commands
+        .._addCommand(_CanvasCommandBuffer._kDrawDRRect, paint)
+        .._addRRect(outer)
+        .._addRRect(inner);
+      return;
+    }
     _drawDRRect(outer._value32, inner._value32, paint._objects, paint._data);
   }
   void _drawDRRect(Float32List outer,
@@ -4234,6 +4559,13 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawOval(Rect rect, Paint paint) {
     assert(_rectIsValid(rect));
     assert(paint != null);
+    final _CanvasCommandBuffer? commands = _commands;
+    if (commands != null) {
+      commands
+        .._addCommand(_CanvasCommandBuffer._kDrawOval, paint)
+        .._addRect(rect);
+      return;
+    }
     _drawOval(rect.left, rect.top, rect.right, rect.bottom,
               paint._objects, paint._data);
   }
@@ -4251,6 +4583,15 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawCircle(Offset c, double radius, Paint paint) {
     assert(_offsetIsValid(c));
     assert(paint != null);
+    final _CanvasCommandBuffer? commands = _commands;
+    if (commands != null) {
+      commands
+        .._addCommand(_CanvasCommandBuffer._kDrawCircle, paint)
+        .._addFloat(c.dx)
+        .._addFloat(c.dy)
+        .._addFloat(radius);
+      return;
+    }
     _drawCircle(c.dx, c.dy, radius, paint._objects, paint._data);
   }
   void _drawCircle(double x,
@@ -4273,6 +4614,16 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawArc(Rect rect, double startAngle, double sweepAngle, bool useCenter, Paint paint) {
     assert(_rectIsValid(rect));
     assert(paint != null);
+    final _CanvasCommandBuffer? commands = _commands;
+    if (commands != null) {
+      commands
+        .._addCommand(_CanvasCommandBuffer._kDrawArc, paint)
+        .._addRect(rect)
+        .._addFloat(startAngle)
+        .._addFloat(sweepAngle)
+        .._addUint32(useCenter ? 1 : 0);
+      return;
+    }
     _drawArc(rect.left, rect.top, rect.right, rect.bottom, startAngle,
              sweepAngle, useCenter, paint._objects, paint._data);
   }
@@ -4294,6 +4645,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawPath(Path path, Paint paint) {
     assert(path != null); // path is checked on the engine side
     assert(paint != null);
+    _commands?.flush();
     _drawPath(path, paint._objects, paint._data);
   }
   void _drawPath(Path path,
@@ -4306,6 +4658,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(image != null); // image is checked on the engine side
     assert(_offsetIsValid(offset));
     assert(paint != null);
+    _commands?.flush();
     _drawImage(image._image, offset.dx, offset.dy, paint._objects, paint._data, paint.filterQuality.index);
   }
   void _drawImage(_Image image,
@@ -4329,6 +4682,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(_rectIsValid(src));
     assert(_rectIsValid(dst));
     assert(paint != null);
+    _commands?.flush();
     _drawImageRect(image._image,
                    src.left,
                    src.top,
@@ -4373,6 +4727,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(_rectIsValid(center));
     assert(_rectIsValid(dst));
     assert(paint != null);
+    _commands?.flush();
     _drawImageNine(image._image,
                    center.left,
                    center.top,
@@ -4403,6 +4758,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   /// [PictureRecorder].
   void drawPicture(Picture picture) {
     assert(picture != null); // picture is checked on the engine side
+    _commands?.flush();
     _drawPicture(picture);
   }
   void _drawPicture(Picture picture) native 'Canvas_drawPicture';
@@ -4430,6 +4786,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawParagraph(Paragraph paragraph, Offset offset) {
     assert(paragraph != null);
     assert(_offsetIsValid(offset));
+    _commands?.flush();
     paragraph._paint(this, offset.dx, offset.dy);
   }
 
@@ -4445,6 +4802,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(pointMode != null);
     assert(points != null);
     assert(paint != null);
+    _commands?.flush();
     _drawPoints(paint._objects, paint._data, pointMode.index, _encodePointList(points));
   }
 
@@ -4463,6 +4821,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(paint != null);
     if (points.length % 2 != 0)
       throw ArgumentError('"points" must have an even number of values.');
+    _commands?.flush();
     _drawPoints(paint._objects, paint._data, pointMode.index, points);
   }
 
@@ -4484,6 +4843,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(vertices != null); // vertices is checked on the engine side
     assert(paint != null);
     assert(blendMode != null);
+    _commands?.flush();
     _drawVertices(vertices, blendMode.index, paint._objects, paint._data);
   }
   void _drawVertices(Vertices vertices,
@@ -4662,6 +5022,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     final Float32List? cullRectBuffer = cullRect?._value32;
     final int qualityIndex = paint.filterQuality.index;
 
+    _commands?.flush();
     _drawAtlas(
       paint._objects, paint._data, qualityIndex, atlas._image, rstTransformBuffer, rectBuffer,
       colorBuffer, (blendMode ?? BlendMode.src).index, cullRectBuffer
@@ -4831,6 +5192,7 @@ class Canvas extends NativeFieldWrapperClass2 {
       throw ArgumentError('If non-null, "colors" length must be one fourth the length of "rstTransforms" and "rects".');
     final int qualityIndex = paint.filterQuality.index;
 
+    _commands?.flush();
     _drawAtlas(
       paint._objects, paint._data, qualityIndex, atlas._image, rstTransforms, rects,
       colors, (blendMode ?? BlendMode.src).index, cullRect?._value32
@@ -4857,6 +5219,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(path != null); // path is checked on the engine side
     assert(color != null);
     assert(transparentOccluder != null);
+    _commands?.flush();
     _drawShadow(path, color.value, elevation, transparentOccluder);
   }
   void _drawShadow(Path path,
@@ -4946,6 +5309,7 @@ class PictureRecorder extends NativeFieldWrapperClass2 {
     if (_canvas == null)
       throw StateError('PictureRecorder did not start recording.');
     final Picture picture = Picture._();
+    _canvas!._commands?.flush();
     _endRecording(picture);
     _canvas!._recorder = null;
     _canvas = null;
@@ -5255,7 +5619,33 @@ class ImageDescriptor extends NativeFieldWrapperClass2 {
   ///
   /// If either targetWidth or targetHeight is less than or equal to zero, it
   /// will be treated as if it is null.
-  Future<Codec> instantiateCodec({int? targetWidth, int? targetHeight}) async {
+  ///
+  /// If `region` is specified, only that part of the image is decoded, and
+  /// targetWidth and targetHeight describe the size of the decoded region
+  /// instead of the size of the whole image. The region is in pixels of the
+  /// image, is rounded out to whole pixels and is clipped to the bounds of the
+  /// image. This allows showing parts of images that are too large to decode
+  /// in full, e.g. as tiles. The region is ignored for animated images.
+  Future<Codec> instantiateCodec({int? targetWidth, int? targetHeight, Rect? region}) async {
+    int regionLeft = 0;
+    int regionTop = 0;
+    int regionRight = 0;
+    int regionBottom = 0;
+    int sourceWidth = width;
+    int sourceHeight = height;
+    if (region != null) {
+      assert(_rectIsValid(region));
+      regionLeft = math.max(region.left.floor(), 0);
+      regionTop = math.max(region.top.floor(), 0);
+      regionRight = math.min(region.right.ceil(), width);
+      regionBottom = math.min(region.bottom.ceil(), height);
+      if (regionRight <= regionLeft || regionBottom <= regionTop) {
+        throw ArgumentError.value(region, 'region', 'does not overlap the image');
+      }
+      sourceWidth = regionRight - regionLeft;
+      sourceHeight = regionBottom - regionTop;
+    }
+
     if (targetWidth != null && targetWidth <= 0) {
       targetWidth = null;
     }
@@ -5264,23 +5654,23 @@ class ImageDescriptor extends NativeFieldWrapperClass2 {
     }
 
     if (targetWidth == null && targetHeight == null) {
-      targetWidth = width;
-      targetHeight = height;
+      targetWidth = sourceWidth;
+      targetHeight = sourceHeight;
     } else if (targetWidth == null && targetHeight != null) {
-      targetWidth = (targetHeight * (width / height)).round();
+      targetWidth = (targetHeight * (sourceWidth / sourceHeight)).round();
       targetHeight = targetHeight;
     } else if (targetHeight == null && targetWidth != null) {
       targetWidth = targetWidth;
-      targetHeight = targetWidth ~/ (width / height);
+      targetHeight = targetWidth ~/ (sourceWidth / sourceHeight);
     }
     assert(targetWidth != null);
     assert(targetHeight != null);
 
     final Codec codec = Codec._();
-    _instantiateCodec(codec, targetWidth!, targetHeight!);
+    _instantiateCodec(codec, targetWidth!, targetHeight!, regionLeft, regionTop, regionRight, regionBottom);
     return codec;
   }
-  void _instantiateCodec(Codec outCodec, int targetWidth, int targetHeight) native 'ImageDescriptor_instantiateCodec';
+  void _instantiateCodec(Codec outCodec, int targetWidth, int targetHeight, int regionLeft, int regionTop, int regionRight, int regionBottom) native 'ImageDescriptor_instantiateCodec';
 }
 
 /// Generic callback signature, used by [_futurize].
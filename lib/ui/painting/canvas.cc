@@ -6,6 +6,8 @@
 #include "flutter/lib/ui/painting/image_filter.h"
 
 #include <cmath>
+#include <cstring>
+#include <vector>
 
 #include "flutter/flow/layers/physical_shape_layer.h"
 #include "flutter/lib/ui/painting/image.h"
@@ -20,6 +22,7 @@
 #include "third_party/tonic/dart_args.h"
 #include "third_party/tonic/dart_binding_macros.h"
 #include "third_party/tonic/dart_library_natives.h"
+#include "third_party/tonic/typed_data/dart_byte_data.h"
 
 using tonic::ToDart;
 
@@ -30,6 +33,11 @@ static void Canvas_constructor(Dart_NativeArguments args) {
   DartCallConstructor(&Canvas::Create, args);
 }
 
+static void Canvas_isCommandBufferEnabled(Dart_NativeArguments args) {
+  Dart_SetBooleanReturnValue(
+      args, UIDartState::Current()->enable_canvas_command_buffer());
+}
+
 IMPLEMENT_WRAPPERTYPEINFO(ui, Canvas);
 
 #define FOR_EACH_BINDING(V)         \
@@ -63,13 +71,17 @@ IMPLEMENT_WRAPPERTYPEINFO(ui, Canvas);
   V(Canvas, drawPoints)             \
   V(Canvas, drawVertices)           \
   V(Canvas, drawAtlas)              \
-  V(Canvas, drawShadow)
+  V(Canvas, drawShadow)             \
+  V(Canvas, executeCommands)
 
 FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
 
 void Canvas::RegisterNatives(tonic::DartLibraryNatives* natives) {
-  natives->Register({{"Canvas_constructor", Canvas_constructor, 6, true},
-                     FOR_EACH_BINDING(DART_REGISTER_NATIVE)});
+  natives->Register(
+      {{"Canvas_constructor", Canvas_constructor, 6, true},
+       {"Canvas_isCommandBufferEnabled", Canvas_isCommandBufferEnabled, 0,
+        true},
+       FOR_EACH_BINDING(DART_REGISTER_NATIVE)});
 }
 
 fml::RefPtr<Canvas> Canvas::Create(PictureRecorder* recorder,
@@ -82,13 +94,17 @@ fml::RefPtr<Canvas> Canvas::Create(PictureRecorder* recorder,
         ToDart("Canvas constructor called with non-genuine PictureRecorder."));
     return nullptr;
   }
+  SkCanvas* recording_canvas =
+      recorder->BeginRecording(SkRect::MakeLTRB(left, top, right, bottom));
   fml::RefPtr<Canvas> canvas = fml::MakeRefCounted<Canvas>(
-      recorder->BeginRecording(SkRect::MakeLTRB(left, top, right, bottom)));
+      recording_canvas, recorder->display_list_recorder());
   recorder->set_canvas(canvas);
   return canvas;
 }
 
-Canvas::Canvas(SkCanvas* canvas) : canvas_(canvas) {}
+Canvas::Canvas(SkCanvas* canvas,
+               DisplayListCanvasRecorder* display_list_recorder)
+    : canvas_(canvas), display_list_recorder_(display_list_recorder) {}
 
 Canvas::~Canvas() {}
 
@@ -396,6 +412,14 @@ void Canvas::drawPicture(Picture* picture) {
         ToDart("Canvas.drawPicture called with non-genuine Picture."));
     return;
   }
+  if (auto display_list = picture->display_list()) {
+    if (display_list_recorder_) {
+      display_list_recorder_->DrawDisplayList(std::move(display_list));
+    } else {
+      display_list->RenderTo(canvas_);
+    }
+    return;
+  }
   canvas_->drawPicture(picture->picture().get());
 }
 
@@ -482,12 +506,320 @@ void Canvas::drawShadow(const CanvasPath* path,
                      ->get_window(0)
                      ->viewport_metrics()
                      .device_pixel_ratio;
+  if (display_list_recorder_) {
+    // Shadows drawn through SkShadowUtils can not be recorded.
+    display_list_recorder_->DrawShadow(path->path(), color, elevation,
+                                       transparentOccluder, dpr);
+    return;
+  }
   flutter::PhysicalShapeLayer::DrawShadow(canvas_, path->path(), color,
                                           elevation, transparentOccluder, dpr);
 }
 
+namespace {
+
+// The commands encoded by _CanvasCommandBuffer in painting.dart. A command is
+// its 32-bit type followed by its 32-bit arguments.
+// Must be kept in sync with _CanvasCommandBuffer in painting.dart.
+enum class CanvasCommand : uint32_t {
+  kSetPaint,
+  kSave,
+  kRestore,
+  kTranslate,
+  kScale,
+  kRotate,
+  kSkew,
+  kClipRect,
+  kClipRRect,
+  kDrawColor,
+  kDrawLine,
+  kDrawPaint,
+  kDrawRect,
+  kDrawRRect,
+  kDrawDRRect,
+  kDrawOval,
+  kDrawCircle,
+  kDrawArc,
+};
+
+// The size in bytes of a rounded rectangle argument: its bounds and the x and
+// y radii of its four corners.
+constexpr int kRRectByteCount = 12 * sizeof(float);
+
+// Returns the size in bytes of the arguments that follow |command|, or -1 if
+// it is not a known command.
+int GetArgumentByteCount(CanvasCommand command) {
+  switch (command) {
+    case CanvasCommand::kSetPaint:
+      return sizeof(int32_t) + Paint::kDataByteCount;
+    case CanvasCommand::kSave:
+    case CanvasCommand::kRestore:
+    case CanvasCommand::kDrawPaint:
+      return 0;
+    case CanvasCommand::kRotate:
+      return sizeof(float);
+    case CanvasCommand::kTranslate:
+    case CanvasCommand::kScale:
+    case CanvasCommand::kSkew:
+      return 2 * sizeof(float);
+    case CanvasCommand::kClipRect:
+      return 4 * sizeof(float) + 2 * sizeof(uint32_t);
+    case CanvasCommand::kClipRRect:
+      return kRRectByteCount + sizeof(uint32_t);
+    case CanvasCommand::kDrawColor:
+      return 2 * sizeof(uint32_t);
+    case CanvasCommand::kDrawLine:
+    case CanvasCommand::kDrawRect:
+    case CanvasCommand::kDrawOval:
+      return 4 * sizeof(float);
+    case CanvasCommand::kDrawRRect:
+      return kRRectByteCount;
+    case CanvasCommand::kDrawDRRect:
+      return 2 * kRRectByteCount;
+    case CanvasCommand::kDrawCircle:
+      return 3 * sizeof(float);
+    case CanvasCommand::kDrawArc:
+      return 6 * sizeof(float) + sizeof(uint32_t);
+  }
+  return -1;
+}
+
+class CanvasCommandReader {
+ public:
+  CanvasCommandReader(const void* data, size_t size)
+      : data_(static_cast<const uint8_t*>(data)), size_(size) {}
+
+  bool done() const { return offset_ == size_; }
+
+  size_t remaining() const { return size_ - offset_; }
+
+  const void* ReadBytes(size_t size) {
+    FML_DCHECK(size <= remaining());
+    const void* bytes = data_ + offset_;
+    offset_ += size;
+    return bytes;
+  }
+
+  template <typename T>
+  T Read() {
+    T value;
+    std::memcpy(&value, ReadBytes(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  float ReadFloat() { return Read<float>(); }
+
+  RRect ReadRRect() {
+    const float left = ReadFloat();
+    const float top = ReadFloat();
+    const float right = ReadFloat();
+    const float bottom = ReadFloat();
+    SkVector radii[4];
+    for (SkVector& radius : radii) {
+      radius.fX = ReadFloat();
+      radius.fY = ReadFloat();
+    }
+    RRect rrect;
+    rrect.sk_rrect.setRectRadii(SkRect::MakeLTRB(left, top, right, bottom),
+                                radii);
+    rrect.is_null = false;
+    return rrect;
+  }
+
+ private:
+  const uint8_t* data_;
+  const size_t size_;
+  size_t offset_ = 0;
+};
+
+}  // namespace
+
+void Canvas::executeCommands(Dart_Handle commands,
+                             int byte_count,
+                             Dart_Handle paint_objects) {
+  // Nothing that needs to be destroyed may be on the stack when the exception
+  // unwinds it.
+  if (const char* error =
+          ExecuteCommandBuffer(commands, byte_count, paint_objects)) {
+    Dart_ThrowException(ToDart(error));
+  }
+}
+
+const char* Canvas::ExecuteCommandBuffer(Dart_Handle commands,
+                                         int byte_count,
+                                         Dart_Handle paint_objects) {
+  if (!canvas_) {
+    return nullptr;
+  }
+
+  // The paint objects are unwrapped up front, the VM can not be called into
+  // while the commands are acquired.
+  intptr_t object_count = 0;
+  if (Dart_IsError(Dart_ListLength(paint_objects, &object_count)) ||
+      object_count % Paint::kObjectCount != 0) {
+    return "Canvas.executeCommands called with an invalid list of paint "
+           "objects.";
+  }
+  std::vector<Paint::Objects> objects;
+  if (object_count > 0) {
+    std::vector<Dart_Handle> values(object_count);
+    if (Dart_IsError(Dart_ListGetRange(paint_objects, 0, object_count,
+                                       values.data()))) {
+      return "Canvas.executeCommands called with an invalid list of paint "
+             "objects.";
+    }
+    objects.reserve(object_count / Paint::kObjectCount);
+    for (intptr_t i = 0; i < object_count; i += Paint::kObjectCount) {
+      objects.push_back(Paint::UnwrapObjects(&values[i]));
+    }
+  }
+
+  tonic::DartByteData data(commands);
+  if (byte_count < 0 ||
+      static_cast<size_t>(byte_count) > data.length_in_bytes()) {
+    return "Canvas.executeCommands called with a byte count out of range.";
+  }
+  CanvasCommandReader reader(data.data(), byte_count);
+  Paint paint;
+  const PaintData paint_data;
+  while (!reader.done()) {
+    if (reader.remaining() < sizeof(uint32_t)) {
+      return "Canvas.executeCommands called with a truncated command.";
+    }
+    const auto command = static_cast<CanvasCommand>(reader.Read<uint32_t>());
+    const int argument_byte_count = GetArgumentByteCount(command);
+    if (argument_byte_count < 0) {
+      return "Canvas.executeCommands called with an unknown command.";
+    }
+    if (reader.remaining() < static_cast<size_t>(argument_byte_count)) {
+      return "Canvas.executeCommands called with a truncated command.";
+    }
+    switch (command) {
+      case CanvasCommand::kSetPaint: {
+        const int32_t objects_index = reader.Read<int32_t>();
+        const void* bytes = reader.ReadBytes(Paint::kDataByteCount);
+        if (objects_index < 0) {
+          paint = Paint(Paint::Objects(), bytes);
+        } else if (static_cast<size_t>(objects_index) < objects.size()) {
+          paint = Paint(objects[objects_index], bytes);
+        } else {
+          return "Canvas.executeCommands called with a paint object index "
+                 "out of range.";
+        }
+        break;
+      }
+      case CanvasCommand::kSave:
+        save();
+        break;
+      case CanvasCommand::kRestore:
+        restore();
+        break;
+      case CanvasCommand::kTranslate: {
+        const float dx = reader.ReadFloat();
+        const float dy = reader.ReadFloat();
+        translate(dx, dy);
+        break;
+      }
+      case CanvasCommand::kScale: {
+        const float sx = reader.ReadFloat();
+        const float sy = reader.ReadFloat();
+        scale(sx, sy);
+        break;
+      }
+      case CanvasCommand::kRotate:
+        rotate(reader.ReadFloat());
+        break;
+      case CanvasCommand::kSkew: {
+        const float sx = reader.ReadFloat();
+        const float sy = reader.ReadFloat();
+        skew(sx, sy);
+        break;
+      }
+      case CanvasCommand::kClipRect: {
+        const float left = reader.ReadFloat();
+        const float top = reader.ReadFloat();
+        const float right = reader.ReadFloat();
+        const float bottom = reader.ReadFloat();
+        const auto clip_op = static_cast<SkClipOp>(reader.Read<uint32_t>());
+        const bool anti_alias = reader.Read<uint32_t>() != 0;
+        clipRect(left, top, right, bottom, clip_op, anti_alias);
+        break;
+      }
+      case CanvasCommand::kClipRRect: {
+        const RRect rrect = reader.ReadRRect();
+        clipRRect(rrect, reader.Read<uint32_t>() != 0);
+        break;
+      }
+      case CanvasCommand::kDrawColor: {
+        const SkColor color = reader.Read<uint32_t>();
+        const auto blend_mode =
+            static_cast<SkBlendMode>(reader.Read<uint32_t>());
+        drawColor(color, blend_mode);
+        break;
+      }
+      case CanvasCommand::kDrawLine: {
+        const float x1 = reader.ReadFloat();
+        const float y1 = reader.ReadFloat();
+        const float x2 = reader.ReadFloat();
+        const float y2 = reader.ReadFloat();
+        drawLine(x1, y1, x2, y2, paint, paint_data);
+        break;
+      }
+      case CanvasCommand::kDrawPaint:
+        drawPaint(paint, paint_data);
+        break;
+      case CanvasCommand::kDrawRect: {
+        const float left = reader.ReadFloat();
+        const float top = reader.ReadFloat();
+        const float right = reader.ReadFloat();
+        const float bottom = reader.ReadFloat();
+        drawRect(left, top, right, bottom, paint, paint_data);
+        break;
+      }
+      case CanvasCommand::kDrawRRect:
+        drawRRect(reader.ReadRRect(), paint, paint_data);
+        break;
+      case CanvasCommand::kDrawDRRect: {
+        const RRect outer = reader.ReadRRect();
+        const RRect inner = reader.ReadRRect();
+        drawDRRect(outer, inner, paint, paint_data);
+        break;
+      }
+      case CanvasCommand::kDrawOval: {
+        const float left = reader.ReadFloat();
+        const float top = reader.ReadFloat();
+        const float right = reader.ReadFloat();
+        const float bottom = reader.ReadFloat();
+        drawOval(left, top, right, bottom, paint, paint_data);
+        break;
+      }
+      case CanvasCommand::kDrawCircle: {
+        const float x = reader.ReadFloat();
+        const float y = reader.ReadFloat();
+        const float radius = reader.ReadFloat();
+        drawCircle(x, y, radius, paint, paint_data);
+        break;
+      }
+      case CanvasCommand::kDrawArc: {
+        const float left = reader.ReadFloat();
+        const float top = reader.ReadFloat();
+        const float right = reader.ReadFloat();
+        const float bottom = reader.ReadFloat();
+        const float start_angle = reader.ReadFloat();
+        const float sweep_angle = reader.ReadFloat();
+        const bool use_center = reader.Read<uint32_t>() != 0;
+        drawArc(left, top, right, bottom, start_angle, sweep_angle,
+                use_center, paint, paint_data);
+        break;
+      }
+    }
+  }
+  return nullptr;
+}
+
 void Canvas::Invalidate() {
   canvas_ = nullptr;
+  display_list_recorder_ = nullptr;
   if (dart_wrapper()) {
     ClearDartWrapper();
   }
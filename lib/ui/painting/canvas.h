@@ -168,18 +168,35 @@ class Canvas : public RefCountedDartWrappable<Canvas> {
                   double elevation,
                   bool transparentOccluder);
 
+  // Executes the first |byte_count| bytes of |commands|, encoded by the
+  // command buffer of the Dart canvas. |paint_objects| holds the objects of
+  // the paints set by the commands, |Paint::kObjectCount| per paint.
+  void executeCommands(Dart_Handle commands,
+                       int byte_count,
+                       Dart_Handle paint_objects);
+
   SkCanvas* canvas() const { return canvas_; }
   void Invalidate();
 
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
 
  private:
-  explicit Canvas(SkCanvas* canvas);
+  Canvas(SkCanvas* canvas, DisplayListCanvasRecorder* display_list_recorder);
+
+  // Executes the commands for |executeCommands|. Returns the error to throw
+  // if the commands or the paint objects are invalid, in which case the
+  // commands before the invalid one are executed, or null.
+  const char* ExecuteCommandBuffer(Dart_Handle commands,
+                                   int byte_count,
+                                   Dart_Handle paint_objects);
 
   // The SkCanvas is supplied by a call to SkPictureRecorder::beginRecording,
   // which does not transfer ownership.  For this reason, we hold a raw
   // pointer and manually set to null in Clear.
   SkCanvas* canvas_;
+  // The same canvas as |canvas_| when pictures are recorded as display
+  // lists, for the operations that are not part of the |SkCanvas| API.
+  DisplayListCanvasRecorder* display_list_recorder_;
 };
 
 }  // namespace flutter
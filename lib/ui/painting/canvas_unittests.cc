@@ -0,0 +1,91 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#define FML_USED_ON_EMBEDDER
+
+#include "flutter/lib/ui/painting/canvas.h"
+
+#include <memory>
+
+#include "flutter/common/task_runners.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/lib/ui/painting/picture.h"
+#include "flutter/runtime/dart_vm.h"
+#include "flutter/shell/common/shell_test.h"
+#include "flutter/shell/common/thread_host.h"
+#include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+namespace testing {
+
+class CanvasCommandBufferTest : public ShellTest {
+ public:
+  // Runs the |recordCanvasCommands| fixture and returns the picture it
+  // records.
+  sk_sp<SkPicture> RecordCanvasCommands(bool enable_canvas_command_buffer) {
+    sk_sp<SkPicture> picture;
+    fml::AutoResetWaitableEvent latch;
+    auto native_capture_picture = [&](Dart_NativeArguments args) {
+      intptr_t peer = 0;
+      Dart_Handle result = Dart_GetNativeInstanceField(
+          Dart_GetNativeArgument(args, 0), tonic::DartWrappable::kPeerIndex,
+          &peer);
+      EXPECT_FALSE(Dart_IsError(result)) << Dart_GetError(result);
+      picture = reinterpret_cast<Picture*>(peer)->ToSkPicture();
+      latch.Signal();
+    };
+    AddNativeCallback("CaptureCanvasCommandsPicture",
+                      CREATE_NATIVE_ENTRY(native_capture_picture));
+
+    Settings settings = CreateSettingsForFixture();
+    settings.enable_canvas_command_buffer = enable_canvas_command_buffer;
+    TaskRunners task_runners("test",                  // label
+                             GetCurrentTaskRunner(),  // platform
+                             CreateNewThread(),       // raster
+                             CreateNewThread(),       // ui
+                             CreateNewThread()        // io
+    );
+    std::unique_ptr<Shell> shell = CreateShell(settings, task_runners);
+    EXPECT_TRUE(shell->IsSetup());
+
+    auto configuration = RunConfiguration::InferFromSettings(settings);
+    configuration.SetEntrypoint("recordCanvasCommands");
+    shell->RunEngine(std::move(configuration), [](auto result) {
+      ASSERT_EQ(result, Engine::RunStatus::Success);
+    });
+
+    latch.Wait();
+    DestroyShell(std::move(shell), std::move(task_runners));
+    return picture;
+  }
+};
+
+TEST_F(CanvasCommandBufferTest, RecordsTheSamePictureAsDirectCalls) {
+  // Each picture is recorded by the isolate of a shell of its own, started
+  // with or without the command buffer.
+  sk_sp<SkPicture> direct = RecordCanvasCommands(false);
+  sk_sp<SkPicture> batched = RecordCanvasCommands(true);
+  ASSERT_TRUE(direct);
+  ASSERT_TRUE(batched);
+  EXPECT_EQ(batched->approximateOpCount(), direct->approximateOpCount());
+
+  sk_sp<SkSurface> direct_surface = SkSurface::MakeRasterN32Premul(200, 200);
+  sk_sp<SkSurface> batched_surface = SkSurface::MakeRasterN32Premul(200, 200);
+  direct_surface->getCanvas()->drawPicture(direct);
+  batched_surface->getCanvas()->drawPicture(batched);
+  SkPixmap direct_pixels;
+  SkPixmap batched_pixels;
+  ASSERT_TRUE(direct_surface->peekPixels(&direct_pixels));
+  ASSERT_TRUE(batched_surface->peekPixels(&batched_pixels));
+  for (int y = 0; y < 200; y++) {
+    for (int x = 0; x < 200; x++) {
+      ASSERT_EQ(batched_pixels.getColor(x, y), direct_pixels.getColor(x, y))
+          << "at " << x << ", " << y;
+    }
+  }
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -7,6 +7,7 @@
 #include <algorithm>
 
 #include "flutter/fml/make_copyable.h"
+#include "third_party/skia/include/codec/SkAndroidCodec.h"
 #include "third_party/skia/include/codec/SkCodec.h"
 
 namespace flutter {
@@ -76,6 +77,7 @@ static sk_sp<SkImage> ResizeRasterImage(sk_sp<SkImage> image,
 
 static sk_sp<SkImage> ImageFromDecompressedData(
     ImageDescriptor* descriptor,
+    const std::optional<SkIRect>& region,
     uint32_t target_width,
     uint32_t target_height,
     const fml::tracing::TraceFlow& flow) {
@@ -89,6 +91,15 @@ static sk_sp<SkImage> ImageFromDecompressedData(
     return nullptr;
   }
 
+  if (region.has_value()) {
+    image = image->makeSubset(region.value());
+    if (!image) {
+      FML_LOG(ERROR) << "Could not create image from region of decompressed "
+                        "bytes.";
+      return nullptr;
+    }
+  }
+
   if (!target_width && !target_height) {
     // No resizing requested. Just rasterize the image.
     return image->makeRasterImage();
@@ -98,23 +109,191 @@ static sk_sp<SkImage> ImageFromDecompressedData(
                            SkISize::Make(target_width, target_height), flow);
 }
 
+// Whether |codec| filters the image when it samples it down while decoding.
+// The other codecs, such as the PNG, GIF and BMP ones, keep every n-th pixel,
+// which looks much worse than the filtered resize of the full image.
+static bool SamplesWithFiltering(SkAndroidCodec* codec) {
+  switch (codec->getEncodedFormat()) {
+    // Scales in the inverse DCT.
+    case SkEncodedImageFormat::kJPEG:
+    // Averages the pixels in the rescaler of libwebp.
+    case SkEncodedImageFormat::kWEBP:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns the largest sample size at which |codec| decodes |region| to at
+// least |target_dimensions|, so that the decoded image is only ever scaled
+// down afterwards. Codecs that do not filter while sampling decode at full
+// size.
+static int ComputeSampleSize(SkAndroidCodec* codec,
+                             const SkIRect& region,
+                             const SkISize& target_dimensions) {
+  if (!SamplesWithFiltering(codec)) {
+    return 1;
+  }
+  int sample_size =
+      std::max(1, std::min(region.width() / target_dimensions.width(),
+                           region.height() / target_dimensions.height()));
+  while (sample_size > 1) {
+    const SkISize sampled_dimensions =
+        codec->getSampledSubsetDimensions(sample_size, region);
+    if (sampled_dimensions.width() >= target_dimensions.width() &&
+        sampled_dimensions.height() >= target_dimensions.height()) {
+      break;
+    }
+    sample_size--;
+  }
+  return sample_size;
+}
+
+// Decodes |region| of the image and, if the codec filters while sampling,
+// samples it down to about |target_dimensions| while decoding. The result is
+// resized to |target_dimensions| with the same filtering as full images.
+// Returns nullptr if the codec of the image cannot do this, in which case the
+// whole image has to be decoded.
+static sk_sp<SkImage> ImageFromSampledCodec(
+    ImageDescriptor* descriptor,
+    const SkIRect& region,
+    const SkISize& target_dimensions,
+    const fml::tracing::TraceFlow& flow) {
+  TRACE_EVENT0("flutter", __FUNCTION__);
+  flow.Step(__FUNCTION__);
+
+  if (target_dimensions.isEmpty()) {
+    return nullptr;
+  }
+
+  auto codec = descriptor->CreateSampledCodec();
+  if (!codec) {
+    return nullptr;
+  }
+
+  // Codecs may only be able to start decoding at certain offsets, in which
+  // case they widen the region and the extra pixels are cropped below.
+  const SkIRect bounds = SkIRect::MakeSize(codec->getInfo().dimensions());
+  SkIRect decode_region = region;
+  if (decode_region != bounds && !codec->getSupportedSubset(&decode_region)) {
+    return nullptr;
+  }
+
+  const int sample_size =
+      ComputeSampleSize(codec.get(), decode_region, target_dimensions);
+  const SkISize decode_dimensions =
+      codec->getSampledSubsetDimensions(sample_size, decode_region);
+  if (decode_dimensions.isEmpty()) {
+    return nullptr;
+  }
+
+  const auto decode_info =
+      descriptor->image_info().makeDimensions(decode_dimensions);
+  SkBitmap bitmap;
+  if (!bitmap.tryAllocPixels(decode_info)) {
+    FML_LOG(ERROR) << "Failed to allocate memory for bitmap of size "
+                   << decode_info.computeMinByteSize() << "B";
+    return nullptr;
+  }
+
+  SkAndroidCodec::AndroidOptions options;
+  options.fSampleSize = sample_size;
+  if (decode_region != bounds) {
+    options.fSubset = &decode_region;
+  }
+  const auto result = codec->getAndroidPixels(
+      decode_info, bitmap.getPixels(), bitmap.rowBytes(), &options);
+  // Like SkCodecImageGenerator, show whatever could be decoded of truncated
+  // or corrupt images.
+  if (result != SkCodec::kSuccess && result != SkCodec::kIncompleteInput &&
+      result != SkCodec::kErrorInInput) {
+    FML_LOG(ERROR) << "Could not decode image: "
+                   << SkCodec::ResultToString(result);
+    return nullptr;
+  }
+
+  if (decode_region != region) {
+    const float scale_x = static_cast<float>(decode_dimensions.width()) /
+                          decode_region.width();
+    const float scale_y = static_cast<float>(decode_dimensions.height()) /
+                          decode_region.height();
+    SkIRect crop =
+        SkRect::MakeLTRB((region.left() - decode_region.left()) * scale_x,
+                         (region.top() - decode_region.top()) * scale_y,
+                         (region.right() - decode_region.left()) * scale_x,
+                         (region.bottom() - decode_region.top()) * scale_y)
+            .roundOut();
+    SkBitmap cropped_bitmap;
+    if (!crop.intersect(SkIRect::MakeSize(decode_dimensions)) ||
+        !bitmap.extractSubset(&cropped_bitmap, crop)) {
+      FML_LOG(ERROR) << "Could not crop decoded image to the region.";
+      return nullptr;
+    }
+    bitmap = std::move(cropped_bitmap);
+  }
+
+  // Marking this as immutable makes the MakeFromBitmap call share the pixels
+  // instead of copying.
+  bitmap.setImmutable();
+
+  auto decoded_image = SkImage::MakeFromBitmap(bitmap);
+  if (!decoded_image) {
+    FML_LOG(ERROR) << "Could not create an image from a sampled bitmap.";
+    return nullptr;
+  }
+
+  // Only allocates another bitmap if the codec could not sample to exactly the
+  // target dimensions.
+  return ResizeRasterImage(std::move(decoded_image), target_dimensions, flow);
+}
+
 sk_sp<SkImage> ImageFromCompressedData(ImageDescriptor* descriptor,
                                        uint32_t target_width,
                                        uint32_t target_height,
                                        const fml::tracing::TraceFlow& flow) {
+  return ImageFromCompressedData(
+      descriptor, SkIRect::MakeSize(descriptor->image_info().dimensions()),
+      target_width, target_height, flow);
+}
+
+sk_sp<SkImage> ImageFromCompressedData(ImageDescriptor* descriptor,
+                                       const SkIRect& region,
+                                       uint32_t target_width,
+                                       uint32_t target_height,
+                                       const fml::tracing::TraceFlow& flow) {
   TRACE_EVENT0("flutter", __FUNCTION__);
   flow.Step(__FUNCTION__);
 
-  if (!descriptor->should_resize(target_width, target_height)) {
+  const SkISize source_dimensions = descriptor->image_info().dimensions();
+  const bool is_region = region != SkIRect::MakeSize(source_dimensions);
+
+  if (!is_region && !descriptor->should_resize(target_width, target_height)) {
     // No resizing requested. Just decode & rasterize the image.
     sk_sp<SkImage> image = descriptor->image();
     return image ? image->makeRasterImage() : nullptr;
   }
 
-  const SkISize source_dimensions = descriptor->image_info().dimensions();
   const SkISize resized_dimensions = {static_cast<int32_t>(target_width),
                                       static_cast<int32_t>(target_height)};
 
+  if (auto image = ImageFromSampledCodec(descriptor, region,
+                                         resized_dimensions, flow)) {
+    return image;
+  }
+
+  if (is_region) {
+    auto image = descriptor->image();
+    if (!image) {
+      return nullptr;
+    }
+    image = image->makeSubset(region);
+    if (!image) {
+      FML_LOG(ERROR) << "Could not create image from region of decoded image.";
+      return nullptr;
+    }
+    return ResizeRasterImage(std::move(image), resized_dimensions, flow);
+  }
+
   auto decode_dimensions = descriptor->get_scaled_dimensions(
       std::max(static_cast<double>(resized_dimensions.width()) /
                    source_dimensions.width(),
@@ -216,9 +395,18 @@ static SkiaGPUObject<SkImage> UploadRasterImage(
   return result;
 }
 
+void ImageDecoder::Decode(fml::RefPtr<ImageDescriptor> descriptor,
+                          uint32_t target_width,
+                          uint32_t target_height,
+                          const ImageResult& callback) {
+  Decode(std::move(descriptor), target_width, target_height, std::nullopt,
+         callback);
+}
+
 void ImageDecoder::Decode(fml::RefPtr<ImageDescriptor> descriptor_ref_ptr,
                           uint32_t target_width,
                           uint32_t target_height,
+                          std::optional<SkIRect> region,
                           const ImageResult& callback) {
   TRACE_EVENT0("flutter", __FUNCTION__);
   fml::tracing::TraceFlow flow(__FUNCTION__);
@@ -270,20 +458,26 @@ void ImageDecoder::Decode(fml::RefPtr<ImageDescriptor> descriptor_ref_ptr,
                          result,                                  //
                          target_width = target_width,             //
                          target_height = target_height,           //
+                         region = region,                         //
                          flow = std::move(flow)                   //
   ]() mutable {
         // Step 1: Decompress the image.
         // On Worker.
 
-        auto decompressed = raw_descriptor->is_compressed()
-                                ? ImageFromCompressedData(raw_descriptor,  //
-                                                          target_width,    //
-                                                          target_height,   //
-                                                          flow)
-                                : ImageFromDecompressedData(raw_descriptor,  //
-                                                            target_width,    //
-                                                            target_height,   //
-                                                            flow);
+        auto decompressed =
+            raw_descriptor->is_compressed()
+                ? ImageFromCompressedData(
+                      raw_descriptor,                                     //
+                      region.value_or(SkIRect::MakeSize(                  //
+                          raw_descriptor->image_info().dimensions())),    //
+                      target_width,                                       //
+                      target_height,                                      //
+                      flow)
+                : ImageFromDecompressedData(raw_descriptor,  //
+                                            region,          //
+                                            target_width,    //
+                                            target_height,   //
+                                            flow);
 
         if (!decompressed) {
           FML_DLOG(ERROR) << "Could not decompress image.";
@@ -19,6 +19,7 @@
 #include "third_party/skia/include/core/SkData.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkImageInfo.h"
+#include "third_party/skia/include/core/SkRect.h"
 #include "third_party/skia/include/core/SkRefCnt.h"
 #include "third_party/skia/include/core/SkSize.h"
 
@@ -50,6 +51,14 @@ class ImageDecoder {
               uint32_t target_height,
               const ImageResult& result);
 
+  // Like |Decode| but only decodes the |region| of the image, which must lie
+  // within the bounds of the image. The target size applies to the region.
+  void Decode(fml::RefPtr<ImageDescriptor> descriptor,
+              uint32_t target_width,
+              uint32_t target_height,
+              std::optional<SkIRect> region,
+              const ImageResult& result);
+
   fml::WeakPtr<ImageDecoder> GetWeakPtr() const;
 
  private:
@@ -66,6 +75,15 @@ sk_sp<SkImage> ImageFromCompressedData(ImageDescriptor* descriptor,
                                        uint32_t target_height,
                                        const fml::tracing::TraceFlow& flow);
 
+// Decodes only the |region| of the image. Where the codec supports it, the
+// region is decoded directly, and sampled down while decoding if the codec
+// filters when it does, so that no bitmap of the full image is allocated.
+sk_sp<SkImage> ImageFromCompressedData(ImageDescriptor* descriptor,
+                                       const SkIRect& region,
+                                       uint32_t target_width,
+                                       uint32_t target_height,
+                                       const fml::tracing::TraceFlow& flow);
+
 }  // namespace flutter
 
 #endif  // FLUTTER_LIB_UI_PAINTING_IMAGE_DECODER_H_
@@ -8,6 +8,7 @@
 #include "flutter/fml/mapping.h"
 #include "flutter/fml/synchronization/waitable_event.h"
 #include "flutter/lib/ui/painting/multi_frame_codec.h"
+#include "flutter/lib/ui/painting/progressive_image_decoder.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/runtime/dart_vm_lifecycle.h"
 #include "flutter/testing/dart_isolate_runner.h"
@@ -592,6 +593,127 @@ TEST(ImageDecoderTest, VerifySubpixelDecodingPreservesExifOrientation) {
   assert_image(decode(300, 100));
 }
 
+static bool ImagesHaveSamePixels(const sk_sp<SkImage>& a,
+                                 const sk_sp<SkImage>& b) {
+  if (a->dimensions() != b->dimensions()) {
+    return false;
+  }
+  SkBitmap a_bitmap;
+  SkBitmap b_bitmap;
+  const auto info = SkImageInfo::MakeN32Premul(a->dimensions());
+  if (!a_bitmap.tryAllocPixels(info) || !b_bitmap.tryAllocPixels(info) ||
+      !a->readPixels(a_bitmap.pixmap(), 0, 0) ||
+      !b->readPixels(b_bitmap.pixmap(), 0, 0)) {
+    return false;
+  }
+  return memcmp(a_bitmap.getPixels(), b_bitmap.getPixels(),
+                a_bitmap.computeByteSize()) == 0;
+}
+
+TEST(ImageDecoderTest, VerifySampledDecodingReachesTargetSize) {
+  auto data = OpenFixtureAsSkData("Horizontal.png");
+  auto codec = SkCodec::MakeFromData(data);
+  ASSERT_TRUE(codec);
+  auto descriptor =
+      fml::MakeRefCounted<ImageDescriptor>(std::move(data), std::move(codec));
+  ASSERT_EQ(descriptor->image_info().dimensions(), SkISize::Make(300, 100));
+
+  auto image = ImageFromCompressedData(descriptor.get(), 150, 50,
+                                       fml::tracing::TraceFlow(""));
+  ASSERT_TRUE(image);
+  ASSERT_EQ(image->dimensions(), SkISize::Make(150, 50));
+
+  image = ImageFromCompressedData(descriptor.get(), 100, 40,
+                                  fml::tracing::TraceFlow(""));
+  ASSERT_TRUE(image);
+  ASSERT_EQ(image->dimensions(), SkISize::Make(100, 40));
+}
+
+TEST(ImageDecoderTest, VerifyDownscaledPngMatchesFilteredResize) {
+  auto data = OpenFixtureAsSkData("Horizontal.png");
+  auto codec = SkCodec::MakeFromData(data);
+  ASSERT_TRUE(codec);
+  auto descriptor =
+      fml::MakeRefCounted<ImageDescriptor>(data, std::move(codec));
+
+  // The PNG codec samples without filtering, so the image is decoded at full
+  // size and then resized.
+  auto image = ImageFromCompressedData(descriptor.get(), 100, 33,
+                                       fml::tracing::TraceFlow(""));
+  ASSERT_TRUE(image);
+
+  auto full_image = SkImage::MakeFromEncoded(data);
+  ASSERT_TRUE(full_image);
+  full_image = full_image->makeRasterImage();
+  SkBitmap expected;
+  ASSERT_TRUE(expected.tryAllocPixels(
+      full_image->imageInfo().makeDimensions(SkISize::Make(100, 33))));
+  ASSERT_TRUE(full_image->scalePixels(
+      expected.pixmap(),
+      SkSamplingOptions(SkFilterMode::kLinear, SkMipmapMode::kNone),
+      SkImage::kDisallow_CachingHint));
+  expected.setImmutable();
+  ASSERT_TRUE(ImagesHaveSamePixels(image, SkImage::MakeFromBitmap(expected)));
+}
+
+TEST(ImageDecoderTest, VerifyRegionDecodingMatchesRegionOfFullDecode) {
+  auto data = OpenFixtureAsSkData("Horizontal.png");
+  auto codec = SkCodec::MakeFromData(data);
+  ASSERT_TRUE(codec);
+  auto descriptor =
+      fml::MakeRefCounted<ImageDescriptor>(data, std::move(codec));
+
+  const auto region = SkIRect::MakeXYWH(50, 20, 100, 60);
+  auto image = ImageFromCompressedData(descriptor.get(), region, 100, 60,
+                                       fml::tracing::TraceFlow(""));
+  ASSERT_TRUE(image);
+
+  auto expected = SkImage::MakeFromEncoded(data);
+  ASSERT_TRUE(expected);
+  expected = expected->makeRasterImage()->makeSubset(region);
+  ASSERT_TRUE(expected);
+  ASSERT_TRUE(ImagesHaveSamePixels(image, expected));
+
+  image = ImageFromCompressedData(descriptor.get(), region, 50, 30,
+                                  fml::tracing::TraceFlow(""));
+  ASSERT_TRUE(image);
+  ASSERT_EQ(image->dimensions(), SkISize::Make(50, 30));
+}
+
+TEST(ImageDecoderTest, ProgressiveDecodingDecodesRowsAsDataArrives) {
+  auto data = OpenFixtureAsSkData("Horizontal.png");
+  ASSERT_TRUE(data);
+
+  ProgressiveImageDecoder decoder;
+  ASSERT_EQ(decoder.Decode(), ProgressiveImageDecoder::Status::kNeedMoreData);
+  ASSERT_FALSE(decoder.MakeImageSnapshot());
+
+  const size_t half = data->size() / 2;
+  decoder.AddData(data->bytes(), half);
+  ASSERT_EQ(decoder.Decode(), ProgressiveImageDecoder::Status::kNeedMoreData);
+  ASSERT_EQ(decoder.image_info().dimensions(), SkISize::Make(300, 100));
+  ASSERT_LT(decoder.decoded_rows(), 100);
+  ASSERT_TRUE(decoder.MakeImageSnapshot());
+
+  decoder.AddData(data->bytes() + half, data->size() - half);
+  decoder.SetDataComplete();
+  ASSERT_EQ(decoder.Decode(), ProgressiveImageDecoder::Status::kComplete);
+  ASSERT_EQ(decoder.decoded_rows(), 100);
+
+  auto expected = SkImage::MakeFromEncoded(data);
+  ASSERT_TRUE(expected);
+  ASSERT_TRUE(ImagesHaveSamePixels(decoder.MakeImageSnapshot(), expected));
+}
+
+TEST(ImageDecoderTest, ProgressiveDecodingFailsForInvalidData) {
+  ProgressiveImageDecoder decoder;
+  const uint8_t garbage[64] = {};
+  decoder.AddData(garbage, sizeof(garbage));
+  ASSERT_EQ(decoder.Decode(), ProgressiveImageDecoder::Status::kNeedMoreData);
+  decoder.SetDataComplete();
+  ASSERT_EQ(decoder.Decode(), ProgressiveImageDecoder::Status::kError);
+}
+
 TEST_F(ImageDecoderFixtureTest,
        MultiFrameCodecCanBeCollectedBeforeIOTasksFinish) {
   // This test verifies that the MultiFrameCodec safely shares state between
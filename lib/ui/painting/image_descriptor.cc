@@ -156,12 +156,24 @@ void ImageDescriptor::initRaw(Dart_Handle descriptor_handle,
 
 void ImageDescriptor::instantiateCodec(Dart_Handle codec_handle,
                                        int target_width,
-                                       int target_height) {
+                                       int target_height,
+                                       int region_left,
+                                       int region_top,
+                                       int region_right,
+                                       int region_bottom) {
+  std::optional<SkIRect> region;
+  SkIRect requested_region =
+      SkIRect::MakeLTRB(region_left, region_top, region_right, region_bottom);
+  if (!requested_region.isEmpty() &&
+      requested_region.intersect(SkIRect::MakeSize(image_info_.dimensions()))) {
+    region = requested_region;
+  }
+
   fml::RefPtr<Codec> ui_codec;
   if (!generator_ || generator_->getFrameCount() == 1) {
     ui_codec = fml::MakeRefCounted<SingleFrameCodec>(
         static_cast<fml::RefPtr<ImageDescriptor>>(this), target_width,
-        target_height);
+        target_height, region);
   } else {
     ui_codec = fml::MakeRefCounted<MultiFrameCodec>(generator_);
   }
@@ -194,4 +206,15 @@ bool ImageDescriptor::get_pixels(const SkPixmap& pixmap) const {
   return platform_image_generator_->getPixels(pixmap);
 }
 
+std::unique_ptr<SkAndroidCodec> ImageDescriptor::CreateSampledCodec() const {
+  if (!generator_) {
+    return nullptr;
+  }
+  auto codec = SkAndroidCodec::MakeFromData(buffer_);
+  if (!codec || codec->codec()->getOrigin() != kTopLeft_SkEncodedOrigin) {
+    return nullptr;
+  }
+  return codec;
+}
+
 }  // namespace flutter
@@ -12,6 +12,7 @@
 #include "flutter/fml/macros.h"
 #include "flutter/lib/ui/dart_wrapper.h"
 #include "flutter/lib/ui/painting/immutable_buffer.h"
+#include "third_party/skia/include/codec/SkAndroidCodec.h"
 #include "third_party/skia/include/codec/SkCodec.h"
 #include "third_party/skia/include/core/SkImageGenerator.h"
 #include "third_party/skia/include/core/SkImageInfo.h"
@@ -54,7 +55,18 @@ class ImageDescriptor : public RefCountedDartWrappable<ImageDescriptor> {
                       PixelFormat pixel_format);
 
   /// Associates a flutter::Codec object with the dart.ui Codec handle.
-  void instantiateCodec(Dart_Handle codec, int target_width, int target_height);
+  ///
+  /// If the region described by the last four arguments is not empty, only
+  /// that region of the image is decoded and the target size applies to the
+  /// region instead of the whole image. Regions are ignored for animated
+  /// images.
+  void instantiateCodec(Dart_Handle codec,
+                        int target_width,
+                        int target_height,
+                        int region_left,
+                        int region_top,
+                        int region_right,
+                        int region_bottom);
 
   /// The width of this image, EXIF oriented if applicable.
   int width() const { return image_info_.width(); }
@@ -103,6 +115,14 @@ class ImageDescriptor : public RefCountedDartWrappable<ImageDescriptor> {
   /// if applicable.
   bool get_pixels(const SkPixmap& pixmap) const;
 
+  /// Creates a codec that can decode a subset of this image and downsample it
+  /// while decoding.
+  ///
+  /// Returns nullptr if the image is not backed by a Skia codec or needs to be
+  /// transformed based on its EXIF orientation, in which case callers should
+  /// fall back to |get_pixels|.
+  std::unique_ptr<SkAndroidCodec> CreateSampledCodec() const;
+
   void dispose() {
     ClearDartWrapper();
     generator_.reset();
@@ -33,13 +33,13 @@ constexpr int kMaskFilterBlurStyleIndex = 10;
 constexpr int kMaskFilterSigmaIndex = 11;
 constexpr int kInvertColorIndex = 12;
 constexpr int kDitherIndex = 13;
-constexpr size_t kDataByteCount = 56;  // 4 * (last index + 1)
+static_assert(Paint::kDataByteCount == 4 * (kDitherIndex + 1));
 
 // Indices for objects.
 constexpr int kShaderIndex = 0;
 constexpr int kColorFilterIndex = 1;
 constexpr int kImageFilterIndex = 2;
-constexpr int kObjectCount = 3;  // One larger than largest object index.
+static_assert(Paint::kObjectCount == kImageFilterIndex + 1);
 
 // Must be kept in sync with the default in painting.dart.
 constexpr uint32_t kColorDefault = 0xFF000000;
@@ -74,42 +74,62 @@ Paint::Paint(Dart_Handle paint_objects, Dart_Handle paint_data) {
   tonic::DartByteData byte_data(paint_data);
   FML_CHECK(byte_data.length_in_bytes() == kDataByteCount);
 
-  const uint32_t* uint_data = static_cast<const uint32_t*>(byte_data.data());
-  const float* float_data = static_cast<const float*>(byte_data.data());
-
-  Dart_Handle values[kObjectCount];
+  Objects objects;
   if (!Dart_IsNull(paint_objects)) {
     FML_DCHECK(Dart_IsList(paint_objects));
     intptr_t length = 0;
     Dart_ListLength(paint_objects, &length);
 
     FML_CHECK(length == kObjectCount);
+    Dart_Handle values[kObjectCount];
     if (Dart_IsError(
             Dart_ListGetRange(paint_objects, 0, kObjectCount, values))) {
       return;
     }
+    objects = UnwrapObjects(values);
+  }
 
-    Dart_Handle shader = values[kShaderIndex];
-    if (!Dart_IsNull(shader)) {
-      Shader* decoded = tonic::DartConverter<Shader*>::FromDart(shader);
-      auto sampling =
-          ImageFilter::SamplingFromIndex(uint_data[kFilterQualityIndex]);
-      paint_.setShader(decoded->shader(sampling));
-    }
+  Decode(objects, byte_data.data());
+}
 
-    Dart_Handle color_filter = values[kColorFilterIndex];
-    if (!Dart_IsNull(color_filter)) {
-      ColorFilter* decoded_color_filter =
-          tonic::DartConverter<ColorFilter*>::FromDart(color_filter);
-      paint_.setColorFilter(decoded_color_filter->filter());
-    }
+Paint::Paint(const Objects& paint_objects, const void* paint_data)
+    : is_null_(false) {
+  Decode(paint_objects, paint_data);
+}
 
-    Dart_Handle image_filter = values[kImageFilterIndex];
-    if (!Dart_IsNull(image_filter)) {
-      ImageFilter* decoded =
-          tonic::DartConverter<ImageFilter*>::FromDart(image_filter);
-      paint_.setImageFilter(decoded->filter());
-    }
+Paint::Objects Paint::UnwrapObjects(const Dart_Handle* values) {
+  Objects objects;
+  if (!Dart_IsNull(values[kShaderIndex])) {
+    objects.shader =
+        tonic::DartConverter<Shader*>::FromDart(values[kShaderIndex]);
+  }
+  if (!Dart_IsNull(values[kColorFilterIndex])) {
+    objects.color_filter =
+        tonic::DartConverter<ColorFilter*>::FromDart(values[kColorFilterIndex]);
+  }
+  if (!Dart_IsNull(values[kImageFilterIndex])) {
+    objects.image_filter =
+        tonic::DartConverter<ImageFilter*>::FromDart(values[kImageFilterIndex]);
+  }
+  return objects;
+}
+
+void Paint::Decode(const Objects& paint_objects, const void* paint_data) {
+  const uint32_t* uint_data = static_cast<const uint32_t*>(paint_data);
+  const float* float_data = static_cast<const float*>(paint_data);
+
+  if (paint_objects.shader) {
+    auto sampling =
+        ImageFilter::SamplingFromIndex(uint_data[kFilterQualityIndex]);
+    paint_.setShader(paint_objects.shader->shader(sampling));
+  }
+
+  if (paint_objects.color_filter) {
+    paint_.setColorFilter(paint_objects.color_filter->filter());
+  }
+
+  if (paint_objects.image_filter) {
+    paint_.setImageFilter(paint_objects.image_filter->filter());
   }
 
   paint_.setAntiAlias(uint_data[kIsAntiAliasIndex] == 0);
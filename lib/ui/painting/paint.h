@@ -10,16 +10,40 @@
 
 namespace flutter {
 
+class ColorFilter;
+class ImageFilter;
+class Shader;
+
 class Paint {
  public:
+  // The number of objects and bytes painting.dart encodes a paint into.
+  static constexpr int kObjectCount = 3;
+  static constexpr size_t kDataByteCount = 56;
+
+  // The native objects of an encoded paint.
+  struct Objects {
+    Shader* shader = nullptr;
+    ColorFilter* color_filter = nullptr;
+    ImageFilter* image_filter = nullptr;
+  };
+
   Paint() = default;
   Paint(Dart_Handle paint_objects, Dart_Handle paint_data);
 
+  // Decodes the |kDataByteCount| bytes of |paint_data| without calling into
+  // the VM, so that it can be used while a typed data is acquired.
+  Paint(const Objects& paint_objects, const void* paint_data);
+
+  // Unwraps the |kObjectCount| handles of the objects of an encoded paint.
+  static Objects UnwrapObjects(const Dart_Handle* values);
+
   const SkPaint* paint() const { return is_null_ ? nullptr : &paint_; }
 
  private:
   friend struct tonic::DartConverter<Paint>;
 
+  void Decode(const Objects& paint_objects, const void* paint_data);
+
   SkPaint paint_;
   bool is_null_ = true;
 };
@@ -37,29 +37,54 @@ fml::RefPtr<Picture> Picture::Create(
   return canvas_picture;
 }
 
+fml::RefPtr<Picture> Picture::Create(
+    Dart_Handle dart_handle,
+    flutter::SkiaGPUObject<DisplayList> display_list) {
+  auto canvas_picture =
+      fml::MakeRefCounted<Picture>(std::move(display_list));
+
+  canvas_picture->AssociateWithDartWrapper(dart_handle);
+  return canvas_picture;
+}
+
 Picture::Picture(flutter::SkiaGPUObject<SkPicture> picture)
     : picture_(std::move(picture)) {}
 
+Picture::Picture(flutter::SkiaGPUObject<DisplayList> display_list)
+    : display_list_(std::move(display_list)) {}
+
 Picture::~Picture() = default;
 
 Dart_Handle Picture::toImage(uint32_t width,
                              uint32_t height,
                              Dart_Handle raw_image_callback) {
-  if (!picture_.get()) {
+  sk_sp<SkPicture> picture = ToSkPicture();
+  if (!picture) {
     return tonic::ToDart("Picture is null");
   }
 
-  return RasterizeToImage(picture_.get(), width, height, raw_image_callback);
+  return RasterizeToImage(std::move(picture), width, height,
+                          raw_image_callback);
+}
+
+sk_sp<SkPicture> Picture::ToSkPicture() const {
+  if (auto display_list = display_list_.get()) {
+    return display_list->ToSkPicture();
+  }
+  return picture_.get();
 }
 
 void Picture::dispose() {
   picture_.reset();
+  display_list_.reset();
   ClearDartWrapper();
 }
 
 size_t Picture::GetAllocationSize() const {
   if (auto picture = picture_.get()) {
     return picture->approximateBytesUsed() + sizeof(Picture);
+  } else if (auto display_list = display_list_.get()) {
+    return display_list->bytes() + sizeof(Picture);
   } else {
     return sizeof(Picture);
   }
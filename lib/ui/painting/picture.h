@@ -5,6 +5,7 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_PICTURE_H_
 #define FLUTTER_LIB_UI_PAINTING_PICTURE_H_
 
+#include "flutter/flow/display_list.h"
 #include "flutter/flow/skia_gpu_object.h"
 #include "flutter/lib/ui/dart_wrapper.h"
 #include "flutter/lib/ui/painting/image.h"
@@ -27,8 +28,19 @@ class Picture : public RefCountedDartWrappable<Picture> {
   static fml::RefPtr<Picture> Create(Dart_Handle dart_handle,
                                      flutter::SkiaGPUObject<SkPicture> picture);
 
+  static fml::RefPtr<Picture> Create(
+      Dart_Handle dart_handle,
+      flutter::SkiaGPUObject<DisplayList> display_list);
+
+  // Null if the picture was recorded as a display list.
   sk_sp<SkPicture> picture() const { return picture_.get(); }
 
+  // Null if the picture was recorded as an |SkPicture|.
+  sk_sp<DisplayList> display_list() const { return display_list_.get(); }
+
+  // Returns the picture, or a picture drawing the display list.
+  sk_sp<SkPicture> ToSkPicture() const;
+
   Dart_Handle toImage(uint32_t width,
                       uint32_t height,
                       Dart_Handle raw_image_callback);
@@ -47,7 +59,10 @@ class Picture : public RefCountedDartWrappable<Picture> {
  private:
   Picture(flutter::SkiaGPUObject<SkPicture> picture);
 
+  Picture(flutter::SkiaGPUObject<DisplayList> display_list);
+
   flutter::SkiaGPUObject<SkPicture> picture_;
+  flutter::SkiaGPUObject<DisplayList> display_list_;
 };
 
 }  // namespace flutter
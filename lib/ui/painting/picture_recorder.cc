@@ -39,6 +39,11 @@ PictureRecorder::PictureRecorder() {}
 PictureRecorder::~PictureRecorder() {}
 
 SkCanvas* PictureRecorder::BeginRecording(SkRect bounds) {
+  if (UIDartState::Current()->enable_display_list()) {
+    display_list_recorder_ =
+        std::make_unique<DisplayListCanvasRecorder>(bounds);
+    return display_list_recorder_.get();
+  }
   return picture_recorder_.beginRecording(bounds, &rtree_factory_);
 }
 
@@ -47,12 +52,20 @@ fml::RefPtr<Picture> PictureRecorder::endRecording(Dart_Handle dart_picture) {
     return nullptr;
   }
 
-  fml::RefPtr<Picture> picture = Picture::Create(
-      dart_picture, UIDartState::CreateGPUObject(
-                        picture_recorder_.finishRecordingAsPicture()));
+  fml::RefPtr<Picture> picture;
+  if (display_list_recorder_) {
+    picture = Picture::Create(dart_picture,
+                              UIDartState::CreateGPUObject(
+                                  display_list_recorder_->Build()));
+  } else {
+    picture = Picture::Create(
+        dart_picture, UIDartState::CreateGPUObject(
+                          picture_recorder_.finishRecordingAsPicture()));
+  }
 
   canvas_->Invalidate();
   canvas_ = nullptr;
+  display_list_recorder_.reset();
   ClearDartWrapper();
   return picture;
 }
@@ -5,6 +5,9 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_PICTURE_RECORDER_H_
 #define FLUTTER_LIB_UI_PAINTING_PICTURE_RECORDER_H_
 
+#include <memory>
+
+#include "flutter/flow/display_list.h"
 #include "flutter/lib/ui/dart_wrapper.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
 
@@ -28,6 +31,12 @@ class PictureRecorder : public RefCountedDartWrappable<PictureRecorder> {
   SkCanvas* BeginRecording(SkRect bounds);
   fml::RefPtr<Picture> endRecording(Dart_Handle dart_picture);
 
+  // The canvas returned by |BeginRecording| when pictures are recorded as
+  // display lists, null otherwise.
+  DisplayListCanvasRecorder* display_list_recorder() const {
+    return display_list_recorder_.get();
+  }
+
   void set_canvas(fml::RefPtr<Canvas> canvas) { canvas_ = std::move(canvas); }
 
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
@@ -37,6 +46,7 @@ class PictureRecorder : public RefCountedDartWrappable<PictureRecorder> {
 
   SkRTreeFactory rtree_factory_;
   SkPictureRecorder picture_recorder_;
+  std::unique_ptr<DisplayListCanvasRecorder> display_list_recorder_;
   fml::RefPtr<Canvas> canvas_;
 };
 
@@ -0,0 +1,131 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/progressive_codec.h"
+
+#include "flutter/fml/make_copyable.h"
+#include "flutter/fml/trace_event.h"
+#include "flutter/lib/ui/painting/image.h"
+#include "third_party/tonic/dart_args.h"
+#include "third_party/tonic/dart_binding_macros.h"
+#include "third_party/tonic/dart_library_natives.h"
+#include "third_party/tonic/logging/dart_invoke.h"
+
+namespace flutter {
+
+static void ProgressiveCodec_constructor(Dart_NativeArguments args) {
+  UIDartState::ThrowIfUIOperationsProhibited();
+  DartCallConstructor(&ProgressiveCodec::Create, args);
+}
+
+#define FOR_EACH_BINDING(V)    \
+  V(ProgressiveCodec, addData) \
+  V(ProgressiveCodec, setDataComplete)
+
+FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
+
+void ProgressiveCodec::RegisterNatives(tonic::DartLibraryNatives* natives) {
+  natives->Register(
+      {{"ProgressiveCodec_constructor", ProgressiveCodec_constructor, 1, true},
+       FOR_EACH_BINDING(DART_REGISTER_NATIVE)});
+}
+
+fml::RefPtr<ProgressiveCodec> ProgressiveCodec::Create() {
+  return fml::MakeRefCounted<ProgressiveCodec>();
+}
+
+ProgressiveCodec::ProgressiveCodec() : state_(std::make_shared<State>()) {}
+
+ProgressiveCodec::~ProgressiveCodec() = default;
+
+Dart_Handle ProgressiveCodec::addData(fml::RefPtr<ImmutableBuffer> buffer) {
+  sk_sp<SkData> data = buffer ? buffer->data() : nullptr;
+  if (!data) {
+    return tonic::ToDart("Buffer is disposed");
+  }
+  data_size_ += data->size();
+  // The buffer may be disposed of once this returns, but its data lives on.
+  UIDartState::Current()->GetTaskRunners().GetIOTaskRunner()->PostTask(
+      [state = state_, data = std::move(data)]() {
+        state->decoder.AddData(data->data(), data->size());
+      });
+  return Dart_Null();
+}
+
+void ProgressiveCodec::setDataComplete() {
+  UIDartState::Current()->GetTaskRunners().GetIOTaskRunner()->PostTask(
+      [state = state_]() { state->decoder.SetDataComplete(); });
+}
+
+size_t ProgressiveCodec::GetAllocationSize() const {
+  return sizeof(*this) + data_size_;
+}
+
+int ProgressiveCodec::frameCount() const {
+  return 1;
+}
+
+int ProgressiveCodec::repetitionCount() const {
+  return 0;
+}
+
+sk_sp<SkImage> ProgressiveCodec::State::DecodeNextFrameImage(
+    fml::WeakPtr<GrDirectContext> resource_context) {
+  if (decoder.Decode() == ProgressiveImageDecoder::Status::kError) {
+    return nullptr;
+  }
+  sk_sp<SkImage> image = decoder.MakeImageSnapshot();
+  if (!image || !resource_context) {
+    // Defer uploading until time of draw on the raster thread, as
+    // MultiFrameCodec does when GL operations are forbidden.
+    return image;
+  }
+  SkPixmap pixmap;
+  if (!image->peekPixels(&pixmap)) {
+    return nullptr;
+  }
+  return SkImage::MakeCrossContextFromPixmap(resource_context.get(), pixmap,
+                                             true);
+}
+
+Dart_Handle ProgressiveCodec::getNextFrame(Dart_Handle callback_handle) {
+  if (!Dart_IsClosure(callback_handle)) {
+    return tonic::ToDart("Callback must be a function");
+  }
+
+  auto* dart_state = UIDartState::Current();
+  const auto& task_runners = dart_state->GetTaskRunners();
+
+  // Decoding is posted after the data added so far, so it decodes all of it.
+  task_runners.GetIOTaskRunner()->PostTask(fml::MakeCopyable(
+      [callback = std::make_unique<DartPersistentValue>(
+           tonic::DartState::Current(), callback_handle),
+       state = state_, ui_task_runner = task_runners.GetUITaskRunner(),
+       io_manager = dart_state->GetIOManager()]() mutable {
+        TRACE_EVENT0("flutter", "ProgressiveCodec::getNextFrame");
+        fml::RefPtr<CanvasImage> image;
+        sk_sp<SkImage> sk_image =
+            state->DecodeNextFrameImage(io_manager->GetResourceContext());
+        if (sk_image) {
+          image = CanvasImage::Create();
+          image->set_image(
+              {std::move(sk_image), io_manager->GetSkiaUnrefQueue()});
+        }
+        ui_task_runner->PostTask(fml::MakeCopyable(
+            [callback = std::move(callback), image = std::move(image)]() {
+              std::shared_ptr<tonic::DartState> dart_state =
+                  callback->dart_state().lock();
+              if (!dart_state) {
+                return;
+              }
+              tonic::DartState::Scope scope(dart_state);
+              tonic::DartInvoke(callback->value(),
+                                {tonic::ToDart(image), tonic::ToDart(0)});
+            }));
+      }));
+
+  return Dart_Null();
+}
+
+}  // namespace flutter
@@ -0,0 +1,71 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_PROGRESSIVE_CODEC_H_
+#define FLUTTER_LIB_UI_PAINTING_PROGRESSIVE_CODEC_H_
+
+#include <memory>
+
+#include "flutter/fml/macros.h"
+#include "flutter/lib/ui/painting/codec.h"
+#include "flutter/lib/ui/painting/immutable_buffer.h"
+#include "flutter/lib/ui/painting/progressive_image_decoder.h"
+
+namespace flutter {
+
+// A codec for an image whose encoded bytes are still arriving.
+//
+// Each frame is an image of the rows decoded from the data added so far.
+class ProgressiveCodec : public Codec {
+ public:
+  ~ProgressiveCodec() override;
+
+  static fml::RefPtr<ProgressiveCodec> Create();
+
+  // Appends the data of |buffer| to the encoded image. Returns an error
+  // message if |buffer| has been disposed of, or null.
+  Dart_Handle addData(fml::RefPtr<ImmutableBuffer> buffer);
+
+  // Marks the encoded image as complete.
+  void setDataComplete();
+
+  // |Codec|
+  int frameCount() const override;
+
+  // |Codec|
+  int repetitionCount() const override;
+
+  // |Codec|
+  Dart_Handle getNextFrame(Dart_Handle args) override;
+
+  // |DartWrappable|
+  size_t GetAllocationSize() const override;
+
+  static void RegisterNatives(tonic::DartLibraryNatives* natives);
+
+ private:
+  // The decoder, which is only used on the IO task runner.
+  //
+  // Like the state of MultiFrameCodec, it is shared with the tasks on the IO
+  // task runner, which may outlive the Dart object.
+  struct State {
+    ProgressiveImageDecoder decoder;
+
+    sk_sp<SkImage> DecodeNextFrameImage(
+        fml::WeakPtr<GrDirectContext> resource_context);
+  };
+
+  std::shared_ptr<State> state_;
+  // The size of the data added so far, which the decoder keeps a copy of.
+  size_t data_size_ = 0;
+
+  ProgressiveCodec();
+
+  FML_FRIEND_MAKE_REF_COUNTED(ProgressiveCodec);
+  FML_FRIEND_REF_COUNTED_THREAD_SAFE(ProgressiveCodec);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_PROGRESSIVE_CODEC_H_
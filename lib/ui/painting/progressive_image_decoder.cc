@@ -0,0 +1,193 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/progressive_image_decoder.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkStream.h"
+
+namespace flutter {
+
+// A stream over the data received so far. Codecs keep reading from it as more
+// data is appended to the decoder.
+class ProgressiveImageDecoder::Stream : public SkStream {
+ public:
+  Stream(const std::vector<uint8_t>& data, const bool& data_complete)
+      : data_(data), data_complete_(data_complete) {}
+
+  ~Stream() override = default;
+
+  // |SkStream|
+  size_t read(void* buffer, size_t size) override {
+    size = peek(buffer, size);
+    position_ += size;
+    return size;
+  }
+
+  // |SkStream|
+  size_t peek(void* buffer, size_t size) const override {
+    size = std::min(size, data_.size() - position_);
+    if (buffer && size > 0) {
+      memcpy(buffer, data_.data() + position_, size);
+    }
+    return size;
+  }
+
+  // |SkStream|
+  bool isAtEnd() const override {
+    return data_complete_ && position_ == data_.size();
+  }
+
+  // |SkStream|
+  bool rewind() override {
+    position_ = 0;
+    return true;
+  }
+
+  // |SkStream|
+  bool hasPosition() const override { return true; }
+
+  // |SkStream|
+  size_t getPosition() const override { return position_; }
+
+ private:
+  const std::vector<uint8_t>& data_;
+  const bool& data_complete_;
+  size_t position_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(Stream);
+};
+
+ProgressiveImageDecoder::ProgressiveImageDecoder() = default;
+
+ProgressiveImageDecoder::~ProgressiveImageDecoder() = default;
+
+void ProgressiveImageDecoder::AddData(const void* data, size_t length) {
+  FML_DCHECK(!data_complete_);
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  data_.insert(data_.end(), bytes, bytes + length);
+}
+
+void ProgressiveImageDecoder::SetDataComplete() {
+  data_complete_ = true;
+}
+
+ProgressiveImageDecoder::Status ProgressiveImageDecoder::Decode() {
+  TRACE_EVENT0("flutter", "ProgressiveImageDecoder::Decode");
+  if (status_ != Status::kNeedMoreData) {
+    return status_;
+  }
+
+  if (!codec_ && !CreateCodec()) {
+    return status_;
+  }
+
+  if (!decode_started_) {
+    const auto result = codec_->startIncrementalDecode(
+        bitmap_.info(), bitmap_.getPixels(), bitmap_.rowBytes());
+    if (result == SkCodec::kIncompleteInput && !data_complete_) {
+      return status_;
+    }
+    decode_started_ = true;
+    incremental_ = result == SkCodec::kSuccess;
+  }
+
+  status_ = incremental_ ? DecodeIncremental() : DecodeScanlines();
+  return status_;
+}
+
+bool ProgressiveImageDecoder::CreateCodec() {
+  SkCodec::Result result = SkCodec::kSuccess;
+  codec_ = SkCodec::MakeFromStream(
+      std::make_unique<Stream>(data_, data_complete_), &result);
+  if (!codec_) {
+    // The header may just not have been received in full yet.
+    if (data_complete_) {
+      FML_LOG(ERROR) << "Could not create codec for image: "
+                     << SkCodec::ResultToString(result);
+      status_ = Status::kError;
+    }
+    return false;
+  }
+
+  const auto& codec_info = codec_->getInfo();
+  const auto info = SkImageInfo::MakeN32(
+      codec_info.width(), codec_info.height(),
+      codec_info.isOpaque() ? kOpaque_SkAlphaType : kPremul_SkAlphaType);
+  if (!bitmap_.tryAllocPixels(info)) {
+    FML_LOG(ERROR) << "Failed to allocate memory for bitmap of size "
+                   << info.computeMinByteSize() << "B";
+    status_ = Status::kError;
+    return false;
+  }
+  bitmap_.eraseColor(SK_ColorTRANSPARENT);
+  return true;
+}
+
+ProgressiveImageDecoder::Status ProgressiveImageDecoder::DecodeIncremental() {
+  int rows_decoded = 0;
+  switch (codec_->incrementalDecode(&rows_decoded)) {
+    case SkCodec::kSuccess:
+      decoded_rows_ = bitmap_.height();
+      return Status::kComplete;
+    case SkCodec::kIncompleteInput:
+      decoded_rows_ = std::max(decoded_rows_, rows_decoded);
+      return data_complete_ ? Status::kComplete : Status::kNeedMoreData;
+    case SkCodec::kErrorInInput:
+      // Like SkCodecImageGenerator, keep whatever could be decoded of corrupt
+      // images.
+      decoded_rows_ = std::max(decoded_rows_, rows_decoded);
+      return Status::kComplete;
+    default:
+      return Status::kError;
+  }
+}
+
+ProgressiveImageDecoder::Status ProgressiveImageDecoder::DecodeScanlines() {
+  const bool top_down =
+      codec_->getScanlineOrder() == SkCodec::kTopDown_SkScanlineOrder;
+  // Decoding starts over every time, so wait until the data has grown by half
+  // since the last attempt.
+  if (!data_complete_ &&
+      (!top_down || data_.size() < last_decode_size_ + last_decode_size_ / 2)) {
+    return Status::kNeedMoreData;
+  }
+  last_decode_size_ = data_.size();
+
+  if (!top_down) {
+    switch (codec_->getPixels(bitmap_.pixmap())) {
+      case SkCodec::kSuccess:
+      case SkCodec::kIncompleteInput:
+      case SkCodec::kErrorInInput:
+        decoded_rows_ = bitmap_.height();
+        return Status::kComplete;
+      default:
+        return Status::kError;
+    }
+  }
+
+  if (codec_->startScanlineDecode(bitmap_.info()) != SkCodec::kSuccess) {
+    return data_complete_ ? Status::kError : Status::kNeedMoreData;
+  }
+  const int rows_decoded = codec_->getScanlines(
+      bitmap_.getPixels(), bitmap_.height(), bitmap_.rowBytes());
+  decoded_rows_ = std::max(decoded_rows_, rows_decoded);
+  if (rows_decoded == bitmap_.height() || data_complete_) {
+    return Status::kComplete;
+  }
+  return Status::kNeedMoreData;
+}
+
+sk_sp<SkImage> ProgressiveImageDecoder::MakeImageSnapshot() const {
+  if (bitmap_.drawsNothing()) {
+    return nullptr;
+  }
+  return SkImage::MakeRasterCopy(bitmap_.pixmap());
+}
+
+}  // namespace flutter
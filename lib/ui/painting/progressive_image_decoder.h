@@ -0,0 +1,92 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_PROGRESSIVE_IMAGE_DECODER_H_
+#define FLUTTER_LIB_UI_PAINTING_PROGRESSIVE_IMAGE_DECODER_H_
+
+#include <memory>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/codec/SkCodec.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkImageInfo.h"
+
+namespace flutter {
+
+/// Decodes an encoded image while its bytes are still arriving, e.g. from the
+/// network, so that the rows received so far can be shown before the download
+/// finishes.
+///
+/// Codecs that support incremental decoding (PNG, GIF) resume where they left
+/// off whenever more data arrives. Other codecs that decode from top to bottom
+/// (JPEG) start over, but only once the received data has grown enough to make
+/// that worthwhile. Codecs that can do neither decode once all data arrived.
+///
+/// ProgressiveCodec exposes this to Dart.
+///
+/// This object is not thread safe. It may be used on any thread but all calls
+/// must be serialized.
+class ProgressiveImageDecoder {
+ public:
+  enum class Status {
+    // More rows can be decoded once more data has been added.
+    kNeedMoreData,
+    // All rows have been decoded, or as many as the data allowed.
+    kComplete,
+    // The data is not a supported image or is corrupt.
+    kError,
+  };
+
+  ProgressiveImageDecoder();
+
+  ~ProgressiveImageDecoder();
+
+  /// Appends the next |length| bytes of the encoded image.
+  void AddData(const void* data, size_t length);
+
+  /// Marks the encoded image as complete. No more data may be added.
+  void SetDataComplete();
+
+  /// Decodes as many rows as the data added so far allows.
+  Status Decode();
+
+  /// The info of the decoded image. Empty until enough data has been added to
+  /// read the header of the image.
+  const SkImageInfo& image_info() const { return bitmap_.info(); }
+
+  /// The number of rows, from the top, that have been decoded.
+  int decoded_rows() const { return decoded_rows_; }
+
+  /// Returns a copy of the pixels decoded so far. Rows that have not been
+  /// decoded yet are transparent. Returns nullptr until the header of the
+  /// image has been read.
+  sk_sp<SkImage> MakeImageSnapshot() const;
+
+ private:
+  class Stream;
+
+  std::vector<uint8_t> data_;
+  bool data_complete_ = false;
+  std::unique_ptr<SkCodec> codec_;
+  SkBitmap bitmap_;
+  bool incremental_ = false;
+  bool decode_started_ = false;
+  size_t last_decode_size_ = 0;
+  int decoded_rows_ = 0;
+  Status status_ = Status::kNeedMoreData;
+
+  bool CreateCodec();
+
+  Status DecodeIncremental();
+
+  Status DecodeScanlines();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ProgressiveImageDecoder);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_PROGRESSIVE_IMAGE_DECODER_H_
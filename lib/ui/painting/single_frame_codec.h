@@ -5,6 +5,8 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_SINGLE_FRAME_CODEC_H_
 #define FLUTTER_LIB_UI_PAINTING_SINGLE_FRAME_CODEC_H_
 
+#include <optional>
+
 #include "flutter/fml/macros.h"
 #include "flutter/lib/ui/painting/codec.h"
 #include "flutter/lib/ui/painting/image.h"
@@ -17,7 +19,8 @@ class SingleFrameCodec : public Codec {
  public:
   SingleFrameCodec(fml::RefPtr<ImageDescriptor> descriptor,
                    uint32_t target_width,
-                   uint32_t target_height);
+                   uint32_t target_height,
+                   std::optional<SkIRect> region = std::nullopt);
 
   ~SingleFrameCodec() override;
 
@@ -39,6 +42,7 @@ class SingleFrameCodec : public Codec {
   fml::RefPtr<ImageDescriptor> descriptor_;
   uint32_t target_width_;
   uint32_t target_height_;
+  std::optional<SkIRect> region_;
   fml::RefPtr<CanvasImage> cached_image_;
   std::vector<DartPersistentValue> pending_callbacks_;
 
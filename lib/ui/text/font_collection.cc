@@ -4,8 +4,12 @@
 
 #include "flutter/lib/ui/text/font_collection.h"
 
+#include <atomic>
 #include <mutex>
 
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/text/asset_manager_font_provider.h"
 #include "flutter/lib/ui/ui_dart_state.h"
 #include "flutter/lib/ui/window/platform_configuration.h"
@@ -27,6 +31,59 @@ namespace flutter {
 
 namespace {
 
+constexpr char kFallbackFontIndexFileName[] = "fallback_font_index";
+
+// Writes the fallback font index to disk a while after it changes, so that
+// the changes made by the layout of a paragraph using many scripts are
+// written at once.
+constexpr fml::TimeDelta kFallbackFontIndexWriteDelay =
+    fml::TimeDelta::FromSeconds(1);
+
+class FallbackFontIndexWriter
+    : public std::enable_shared_from_this<FallbackFontIndexWriter> {
+ public:
+  FallbackFontIndexWriter(fml::UniqueFD directory,
+                          fml::RefPtr<fml::TaskRunner> io_task_runner,
+                          std::weak_ptr<txt::FallbackFontIndex> index)
+      : directory_(std::move(directory)),
+        io_task_runner_(std::move(io_task_runner)),
+        index_(std::move(index)) {}
+
+  void ScheduleWrite() {
+    if (write_pending_.exchange(true)) {
+      return;
+    }
+    io_task_runner_->PostDelayedTask(
+        [self = shared_from_this()]() {
+          self->write_pending_ = false;
+          self->Write();
+        },
+        kFallbackFontIndexWriteDelay);
+  }
+
+ private:
+  const fml::UniqueFD directory_;
+  const fml::RefPtr<fml::TaskRunner> io_task_runner_;
+  const std::weak_ptr<txt::FallbackFontIndex> index_;
+  std::atomic<bool> write_pending_ = false;
+
+  void Write() {
+    TRACE_EVENT0("flutter", "FallbackFontIndexWriter::Write");
+    std::shared_ptr<txt::FallbackFontIndex> index = index_.lock();
+    if (!index) {
+      return;
+    }
+    sk_sp<SkData> data = index->Serialize();
+    fml::NonOwnedMapping mapping(data->bytes(), data->size());
+    if (!fml::WriteAtomically(directory_, kFallbackFontIndexFileName,
+                              mapping)) {
+      FML_LOG(ERROR) << "Could not write the fallback font index.";
+    }
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FallbackFontIndexWriter);
+};
+
 void LoadFontFromList(tonic::Uint8List& font_data,  // NOLINT
                       Dart_Handle callback,
                       std::string family_name) {
@@ -173,4 +230,25 @@ void FontCollection::LoadFontFromList(const uint8_t* font_data,
   collection_->ClearFontFamilyCache();
 }
 
+void FontCollection::LoadFallbackFontIndex(
+    fml::UniqueFD directory,
+    fml::RefPtr<fml::TaskRunner> io_task_runner) {
+  if (!directory.is_valid() || collection_->GetFallbackFontIndex()) {
+    return;
+  }
+  TRACE_EVENT0("flutter", "FontCollection::LoadFallbackFontIndex");
+  auto index = std::make_shared<txt::FallbackFontIndex>();
+  std::unique_ptr<fml::FileMapping> mapping =
+      fml::FileMapping::CreateReadOnly(directory, kFallbackFontIndexFileName);
+  if (mapping && mapping->GetSize() > 0) {
+    index->Deserialize(mapping->GetMapping(), mapping->GetSize());
+  }
+  if (io_task_runner) {
+    auto writer = std::make_shared<FallbackFontIndexWriter>(
+        std::move(directory), std::move(io_task_runner), index);
+    index->SetChangeCallback([writer]() { writer->ScheduleWrite(); });
+  }
+  collection_->SetFallbackFontIndex(std::move(index));
+}
+
 }  // namespace flutter
@@ -11,6 +11,8 @@
 #include "flutter/assets/asset_manager.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_ptr.h"
+#include "flutter/fml/task_runner.h"
+#include "flutter/fml/unique_fd.h"
 #include "txt/font_collection.h"
 
 namespace tonic {
@@ -39,6 +41,14 @@ class FontCollection {
                         int length,
                         std::string family_name);
 
+  // Loads the index of the system fonts used for font fallback from
+  // |directory|, and writes it back on |io_task_runner| as text using new
+  // scripts is laid out. The index is not written if |io_task_runner| is
+  // null. Does nothing if the font collection already uses an index, which
+  // is the case when it is shared with a spawning engine.
+  void LoadFallbackFontIndex(fml::UniqueFD directory,
+                             fml::RefPtr<fml::TaskRunner> io_task_runner);
+
  private:
   std::shared_ptr<txt::FontCollection> collection_;
   sk_sp<txt::DynamicFontManager> dynamic_font_manager_;
@@ -112,9 +112,59 @@ static void BM_PathVolatilityTracker(benchmark::State& state) {
   }
 }
 
+// Records a picture of |state.range(0)| rectangles from Dart, with each
+// drawing call crossing into the engine on its own or batched in the canvas
+// command buffer.
+static void RecordRectsFromDart(benchmark::State& state,
+                                bool enable_canvas_command_buffer) {
+  ThreadHost thread_host("test",
+                         ThreadHost::Type::Platform | ThreadHost::Type::RASTER |
+                             ThreadHost::Type::IO | ThreadHost::Type::UI);
+  TaskRunners task_runners("test", thread_host.platform_thread->GetTaskRunner(),
+                           thread_host.raster_thread->GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+  Fixture fixture;
+  auto settings = fixture.CreateSettingsForFixture();
+  settings.enable_canvas_command_buffer = enable_canvas_command_buffer;
+  auto vm_ref = DartVMRef::Create(settings);
+  auto isolate =
+      testing::RunDartCodeInIsolate(vm_ref, settings, task_runners, "main", {},
+                                    testing::GetDefaultKernelFilePath(), {});
+
+  const int64_t rect_count = state.range(0);
+  while (state.KeepRunning()) {
+    bool successful = isolate->RunInIsolateScope([&]() -> bool {
+      Dart_Handle args[] = {Dart_NewInteger(rect_count)};
+      Dart_Handle result =
+          Dart_Invoke(Dart_RootLibrary(),
+                      Dart_NewStringFromCString("recordRects"), 1, args);
+      return !Dart_IsError(result);
+    });
+    FML_CHECK(successful);
+  }
+  state.SetItemsProcessed(state.iterations() * rect_count);
+}
+
+static void BM_RecordRectsWithNativeCalls(benchmark::State& state) {
+  RecordRectsFromDart(state, false);
+}
+
+static void BM_RecordRectsWithCommandBuffer(benchmark::State& state) {
+  RecordRectsFromDart(state, true);
+}
+
 BENCHMARK(BM_PlatformMessageResponseDartComplete)
     ->Unit(benchmark::kMicrosecond);
 
 BENCHMARK(BM_PathVolatilityTracker)->Unit(benchmark::kMillisecond);
 
+BENCHMARK(BM_RecordRectsWithNativeCalls)
+    ->Arg(10000)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_RecordRectsWithCommandBuffer)
+    ->Arg(10000)
+    ->Unit(benchmark::kMicrosecond);
+
 }  // namespace flutter
@@ -41,7 +41,9 @@ UIDartState::UIDartState(
     std::shared_ptr<IsolateNameServer> isolate_name_server,
     bool is_root_isolate,
     std::shared_ptr<VolatilePathTracker> volatile_path_tracker,
-    bool enable_skparagraph)
+    bool enable_skparagraph,
+    bool enable_display_list,
+    bool enable_canvas_command_buffer)
     : task_runners_(std::move(task_runners)),
       add_callback_(std::move(add_callback)),
       remove_callback_(std::move(remove_callback)),
@@ -58,7 +60,9 @@ UIDartState::UIDartState(
       unhandled_exception_callback_(unhandled_exception_callback),
       log_message_callback_(log_message_callback),
       isolate_name_server_(std::move(isolate_name_server)),
-      enable_skparagraph_(enable_skparagraph) {
+      enable_skparagraph_(enable_skparagraph),
+      enable_display_list_(enable_display_list),
+      enable_canvas_command_buffer_(enable_canvas_command_buffer) {
   AddOrRemoveTaskObserver(true /* add */);
 }
 
@@ -230,4 +234,12 @@ bool UIDartState::enable_skparagraph() const {
   return enable_skparagraph_;
 }
 
+bool UIDartState::enable_display_list() const {
+  return enable_display_list_;
+}
+
+bool UIDartState::enable_canvas_command_buffer() const {
+  return enable_canvas_command_buffer_;
+}
+
 }  // namespace flutter
@@ -194,6 +194,30 @@ Dart_Handle ToByteData(const std::vector<uint8_t>& buffer) {
   return tonic::DartByteData::Create(buffer.data(), buffer.size());
 }
 
+// Payloads at least this large are handed to Dart as external typed data that
+// aliases the message's mapping instead of being copied into the Dart heap.
+// Matches the threshold tonic uses to switch to external typed data.
+constexpr size_t kExternalPlatformMessageThreshold = 1000;
+
+void FinalizeMapping(void* isolate_callback_data, void* peer) {
+  delete reinterpret_cast<fml::Mapping*>(peer);
+}
+
+Dart_Handle ToByteData(std::unique_ptr<fml::Mapping> mapping) {
+  FML_DCHECK(mapping);
+  const size_t size = mapping->GetSize();
+  if (size < kExternalPlatformMessageThreshold) {
+    return tonic::DartByteData::Create(mapping->GetMapping(), size);
+  }
+  // PlatformMessage requires its mapping to be backed by writable memory, so
+  // Dart can be given direct access to it. The mapping is destroyed (and any
+  // embedder release callback invoked) when the ByteData is collected.
+  void* bytes = const_cast<uint8_t*>(mapping->GetMapping());
+  void* peer = reinterpret_cast<void*>(mapping.release());
+  return Dart_NewExternalTypedDataWithFinalizer(
+      Dart_TypedData_kByteData, bytes, size, peer, size, FinalizeMapping);
+}
+
 }  // namespace
 
 PlatformConfigurationClient::~PlatformConfigurationClient() {}
@@ -316,7 +340,7 @@ void PlatformConfiguration::DispatchPlatformMessage(
   }
   tonic::DartState::Scope scope(dart_state);
   Dart_Handle data_handle =
-      (message->hasData()) ? ToByteData(message->data()) : Dart_Null();
+      (message->hasData()) ? ToByteData(message->releaseData()) : Dart_Null();
   if (Dart_IsError(data_handle)) {
     FML_DLOG(WARNING)
         << "Dropping platform message because of a Dart error on channel: "
@@ -12,9 +12,16 @@ PlatformMessage::PlatformMessage(std::string channel,
                                  std::vector<uint8_t> data,
                                  fml::RefPtr<PlatformMessageResponse> response)
     : channel_(std::move(channel)),
-      data_(std::move(data)),
+      data_(std::make_unique<fml::DataMapping>(std::move(data))),
       hasData_(true),
       response_(std::move(response)) {}
+PlatformMessage::PlatformMessage(std::string channel,
+                                 std::unique_ptr<fml::Mapping> data,
+                                 fml::RefPtr<PlatformMessageResponse> response)
+    : channel_(std::move(channel)),
+      data_(std::move(data)),
+      hasData_(data_ != nullptr),
+      response_(std::move(response)) {}
 PlatformMessage::PlatformMessage(std::string channel,
                                  fml::RefPtr<PlatformMessageResponse> response)
     : channel_(std::move(channel)),
@@ -24,4 +31,13 @@ PlatformMessage::PlatformMessage(std::string channel,
 
 PlatformMessage::~PlatformMessage() = default;
 
+const fml::Mapping& PlatformMessage::data() const {
+  if (data_) {
+    return *data_;
+  }
+  static const fml::NonOwnedMapping* empty_mapping =
+      new fml::NonOwnedMapping(nullptr, 0);
+  return *empty_mapping;
+}
+
 }  // namespace flutter
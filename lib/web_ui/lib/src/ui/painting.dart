@@ -448,6 +448,14 @@ class Codec {
   void dispose() {}
 }
 
+class ProgressiveCodec extends Codec {
+  ProgressiveCodec() : super._() {
+    throw UnsupportedError('ProgressiveCodec is not supported on web.');
+  }
+  void addData(ImmutableBuffer buffer) {}
+  void setDataComplete() {}
+}
+
 Future<Codec> instantiateImageCodec(
   Uint8List list, {
   int? targetWidth,
@@ -752,10 +760,13 @@ class ImageDescriptor {
   int get bytesPerPixel =>
       throw UnsupportedError('ImageDescriptor.bytesPerPixel is not supported on web.');
   void dispose() => _data = null;
-  Future<Codec> instantiateCodec({int? targetWidth, int? targetHeight}) async {
+  Future<Codec> instantiateCodec({int? targetWidth, int? targetHeight, Rect? region}) async {
     if (_data == null) {
       throw StateError('Object is disposed');
     }
+    if (region != null) {
+      throw UnsupportedError('ImageDescriptor.instantiateCodec(region) is not supported on web.');
+    }
     if (_width == null) {
       return await instantiateImageCodec(
         _data!,
@@ -21,7 +21,9 @@ constexpr fml::TimeDelta kNotifyIdleTaskWaitTime =
 
 Animator::Animator(Delegate& delegate,
                    TaskRunners task_runners,
-                   std::unique_ptr<VsyncWaiter> waiter)
+                   std::unique_ptr<VsyncWaiter> waiter,
+                   PipelineMode pipeline_mode,
+                   FrameSchedulingMode frame_scheduling_mode)
     : delegate_(delegate),
       task_runners_(std::move(task_runners)),
       waiter_(std::move(waiter)),
@@ -30,7 +32,8 @@ Animator::Animator(Delegate& delegate,
       last_frame_target_time_(),
       dart_frame_deadline_(0),
 #if SHELL_ENABLE_METAL
-      layer_tree_pipeline_(fml::MakeRefCounted<LayerTreePipeline>(2)),
+      layer_tree_pipeline_(
+          fml::MakeRefCounted<LayerTreePipeline>(2, pipeline_mode)),
 #else   // SHELL_ENABLE_METAL
       // TODO(dnfield): We should remove this logic and set the pipeline depth
       // back to 2 in this case. See
@@ -39,7 +42,8 @@ Animator::Animator(Delegate& delegate,
           task_runners.GetPlatformTaskRunner() ==
                   task_runners.GetRasterTaskRunner()
               ? 1
-              : 2)),
+              : 2,
+          pipeline_mode)),
 #endif  // SHELL_ENABLE_METAL
       pending_frame_semaphore_(1),
       frame_number_(1),
@@ -48,6 +52,7 @@ Animator::Animator(Delegate& delegate,
       frame_scheduled_(false),
       notify_idle_task_id_(0),
       dimension_change_pending_(false),
+      frame_scheduler_(frame_scheduling_mode),
       weak_factory_(this) {
 }
 
@@ -80,10 +85,23 @@ void Animator::EnqueueTraceFlowId(uint64_t trace_flow_id) {
           return;
         }
         self->trace_flow_ids_.push_back(trace_flow_id);
+        self->frame_scheduler_.OnInputDispatched(fml::TimePoint::Now());
         self->ScheduleMaybeClearTraceFlowIds();
       });
 }
 
+PipelineStats Animator::GetPipelineStats() const {
+  return layer_tree_pipeline_->GetStats();
+}
+
+void Animator::OnFrameRasterized(const FrameTiming& timing) {
+  frame_scheduler_.OnFrameRasterized(timing);
+}
+
+FrameSchedulingStats Animator::GetFrameSchedulingStats() const {
+  return frame_scheduler_.GetStats();
+}
+
 // This Parity is used by the timeline component to correctly align
 // GPU Workloads events with their respective Framework Workload.
 const char* Animator::FrameParity() {
@@ -96,8 +114,30 @@ static int64_t FxlToDartOrEarlier(fml::TimePoint time) {
   return (time - fxl_now).ToMicroseconds() + dart_now;
 }
 
+void Animator::ScheduleBeginFrame(fml::TimePoint vsync_start_time,
+                                  fml::TimePoint frame_target_time) {
+  const fml::TimeDelta build_delay =
+      frame_scheduler_.GetBuildStartDelay(vsync_start_time, frame_target_time);
+  const fml::TimePoint build_start_time = vsync_start_time + build_delay;
+  if (build_start_time <= fml::TimePoint::Now()) {
+    BeginFrame(vsync_start_time, frame_target_time, build_delay);
+    return;
+  }
+  // The input dispatched to the framework until then is handled by this
+  // frame rather than the next one.
+  task_runners_.GetUITaskRunner()->PostTaskForTime(
+      [self = weak_factory_.GetWeakPtr(), vsync_start_time, frame_target_time,
+       build_delay]() {
+        if (self) {
+          self->BeginFrame(vsync_start_time, frame_target_time, build_delay);
+        }
+      },
+      build_start_time);
+}
+
 void Animator::BeginFrame(fml::TimePoint vsync_start_time,
-                          fml::TimePoint frame_target_time) {
+                          fml::TimePoint frame_target_time,
+                          fml::TimeDelta build_delay) {
   TRACE_EVENT_ASYNC_END0("flutter", "Frame Request Pending", frame_number_++);
 
   TRACE_EVENT0("flutter", "Animator::BeginFrame");
@@ -133,10 +173,17 @@ void Animator::BeginFrame(fml::TimePoint vsync_start_time,
 
   last_frame_begin_time_ = fml::TimePoint::Now();
   last_vsync_start_time_ = vsync_start_time;
-  fml::tracing::TraceEventAsyncComplete("flutter", "VsyncSchedulingOverhead",
-                                        last_vsync_start_time_,
-                                        last_frame_begin_time_);
+  if (build_delay > fml::TimeDelta::Zero()) {
+    fml::tracing::TraceEventAsyncComplete("flutter", "FrameBuildDelay",
+                                          vsync_start_time,
+                                          vsync_start_time + build_delay);
+  }
+  fml::tracing::TraceEventAsyncComplete(
+      "flutter", "VsyncSchedulingOverhead", vsync_start_time + build_delay,
+      last_frame_begin_time_);
   last_frame_target_time_ = frame_target_time;
+  frame_scheduler_.OnBeginFrame(vsync_start_time, frame_target_time,
+                                build_delay);
   dart_frame_deadline_ = FxlToDartOrEarlier(frame_target_time);
   {
     TRACE_EVENT2("flutter", "Framework Workload", "mode", "basic", "frame",
@@ -242,7 +289,7 @@ void Animator::AwaitVSync() {
           if (self->CanReuseLastLayerTree()) {
             self->DrawLastLayerTree();
           } else {
-            self->BeginFrame(vsync_start_time, frame_target_time);
+            self->ScheduleBeginFrame(vsync_start_time, frame_target_time);
           }
         }
       });
@@ -12,6 +12,7 @@
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/fml/synchronization/semaphore.h"
 #include "flutter/fml/time/time_point.h"
+#include "flutter/shell/common/frame_scheduler.h"
 #include "flutter/shell/common/pipeline.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/vsync_waiter.h"
@@ -43,7 +44,10 @@ class Animator final {
 
   Animator(Delegate& delegate,
            TaskRunners task_runners,
-           std::unique_ptr<VsyncWaiter> waiter);
+           std::unique_ptr<VsyncWaiter> waiter,
+           PipelineMode pipeline_mode = PipelineMode::Queue,
+           FrameSchedulingMode frame_scheduling_mode =
+               FrameSchedulingMode::Immediate);
 
   ~Animator();
 
@@ -80,11 +84,28 @@ class Animator final {
   // active rendering.
   void EnqueueTraceFlowId(uint64_t trace_flow_id);
 
+  // Statistics about the layer trees produced by this animator.
+  PipelineStats GetPipelineStats() const;
+
+  // Learns from the timing of a frame produced by this animator when to start
+  // building the next ones. See |FrameSchedulingMode::LatencyAware|.
+  void OnFrameRasterized(const FrameTiming& timing);
+
+  // Statistics about the scheduling of the frames produced by this animator,
+  // for the frames whose timing was reported with |OnFrameRasterized|.
+  FrameSchedulingStats GetFrameSchedulingStats() const;
+
  private:
   using LayerTreePipeline = Pipeline<flutter::LayerTree>;
 
   void BeginFrame(fml::TimePoint frame_start_time,
-                  fml::TimePoint frame_target_time);
+                  fml::TimePoint frame_target_time,
+                  fml::TimeDelta build_delay = fml::TimeDelta::Zero());
+
+  // Calls |BeginFrame| right away, or later in the frame interval if the
+  // frame scheduler delays the build.
+  void ScheduleBeginFrame(fml::TimePoint frame_start_time,
+                          fml::TimePoint frame_target_time);
 
   bool CanReuseLastLayerTree();
   void DrawLastLayerTree();
@@ -115,6 +136,7 @@ class Animator final {
   bool dimension_change_pending_;
   SkISize last_layer_tree_size_ = {0, 0};
   std::deque<uint64_t> trace_flow_ids_;
+  FrameScheduler frame_scheduler_;
 
   fml::WeakPtrFactory<Animator> weak_factory_;
 
@@ -577,6 +577,25 @@ class Engine final : public RuntimeDelegate,
   ///
   void ReportTimings(std::vector<int64_t> timings);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Notifies the animator of the timing of a frame it produced,
+  ///             as soon as the frame is rasterized. The animator learns from
+  ///             it when to start building the next frames in
+  ///             `FrameSchedulingMode::LatencyAware` mode.
+  ///
+  /// @param[in]  timing  The timing of the rasterized frame.
+  ///
+  void ReportFrameTiming(const FrameTiming& timing);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Gets statistics about the scheduling of the frames produced
+  ///             by the animator, for the frames whose timing was reported
+  ///             with `ReportFrameTiming`.
+  ///
+  /// @return     The frame scheduling statistics.
+  ///
+  FrameSchedulingStats GetFrameSchedulingStats() const;
+
   //----------------------------------------------------------------------------
   /// @brief      Gets the main port of the root isolate. Since the isolate is
   ///             created immediately in the constructor of the engine, it is
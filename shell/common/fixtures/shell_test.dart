@@ -206,3 +206,35 @@ void canAccessResourceFromAssetDir() async {
     },
   );
 }
+
+// Draws a frame once the view has a size, and reports it on the
+// 'flutter/firstframe' channel. Shells spawned ahead of time run up to the
+// point where they wait for the viewport metrics.
+@pragma('vm:entry-point')
+void drawFirstFrameWhenSized() {
+  void drawFrame() {
+    PlatformDispatcher.instance.onBeginFrame = (Duration beginTime) {
+      final PictureRecorder recorder = PictureRecorder();
+      final Canvas canvas = Canvas(recorder);
+      canvas.drawRect(
+        Offset.zero & window.physicalSize,
+        Paint()..color = const Color(0xFF2196F3),
+      );
+      final SceneBuilder builder = SceneBuilder();
+      builder.addPicture(Offset.zero, recorder.endRecording());
+      window.render(builder.build());
+      PlatformDispatcher.instance
+          .sendPlatformMessage('flutter/firstframe', null, null);
+    };
+    PlatformDispatcher.instance.scheduleFrame();
+  }
+
+  if (window.physicalSize.isEmpty) {
+    window.onMetricsChanged = () {
+      window.onMetricsChanged = null;
+      drawFrame();
+    };
+  } else {
+    drawFrame();
+  }
+}
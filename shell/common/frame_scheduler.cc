@@ -0,0 +1,154 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_scheduler.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+namespace {
+
+// The number of recent frames whose durations are learned from.
+constexpr size_t kSampleCount = 60;
+
+// Builds are not delayed until this many frames have been learned from.
+constexpr size_t kMinSampleCount = 10;
+
+// The time left in the frame interval on top of the expected durations, for
+// the scheduling of the tasks and the durations not to be exceeded by much.
+constexpr fml::TimeDelta kSafetyMargin = fml::TimeDelta::FromMilliseconds(1);
+
+// Frames older than this many frames are assumed never to be rasterized.
+constexpr size_t kMaxPendingFrames = 8;
+
+// The duration that 90% of the |durations| are shorter than.
+fml::TimeDelta ExpectedDuration(const std::deque<fml::TimeDelta>& durations) {
+  std::vector<fml::TimeDelta> sorted(durations.begin(), durations.end());
+  auto percentile = sorted.begin() + sorted.size() * 9 / 10;
+  std::nth_element(sorted.begin(), percentile, sorted.end());
+  return *percentile;
+}
+
+void AddDuration(std::deque<fml::TimeDelta>& durations,
+                 fml::TimeDelta duration) {
+  durations.push_back(duration);
+  if (durations.size() > kSampleCount) {
+    durations.pop_front();
+  }
+}
+
+// The first vsync from |frame_target| on, at the interval of the frame, after
+// the frame is rasterized, when it is presented.
+fml::TimePoint PresentationTime(fml::TimePoint vsync_start,
+                                fml::TimePoint frame_target,
+                                fml::TimePoint raster_finish) {
+  const fml::TimeDelta interval = frame_target - vsync_start;
+  if (raster_finish <= frame_target || interval <= fml::TimeDelta::Zero()) {
+    return frame_target;
+  }
+  const fml::TimeDelta lateness =
+      raster_finish - frame_target - fml::TimeDelta::FromNanoseconds(1);
+  return frame_target + interval * (lateness / interval + 1);
+}
+
+}  // namespace
+
+FrameScheduler::FrameScheduler(FrameSchedulingMode mode) : mode_(mode) {}
+
+FrameScheduler::~FrameScheduler() = default;
+
+fml::TimeDelta FrameScheduler::GetBuildStartDelay(
+    fml::TimePoint vsync_start,
+    fml::TimePoint frame_target) const {
+  if (mode_ != FrameSchedulingMode::LatencyAware ||
+      build_durations_.size() < kMinSampleCount) {
+    return fml::TimeDelta::Zero();
+  }
+  const fml::TimeDelta slack = (frame_target - vsync_start) -
+                               ExpectedDuration(build_durations_) -
+                               ExpectedDuration(raster_durations_) -
+                               kSafetyMargin;
+  return std::max(slack, fml::TimeDelta::Zero());
+}
+
+void FrameScheduler::OnInputDispatched(fml::TimePoint time) {
+  if (!first_input_) {
+    first_input_ = time;
+  }
+}
+
+void FrameScheduler::OnBeginFrame(fml::TimePoint vsync_start,
+                                  fml::TimePoint frame_target,
+                                  fml::TimeDelta build_delay) {
+  PendingFrame& frame = pending_frames_.emplace_back();
+  frame.vsync_start = vsync_start;
+  frame.frame_target = frame_target;
+  frame.first_input = first_input_;
+  frame.build_delay = build_delay;
+  first_input_.reset();
+  if (pending_frames_.size() > kMaxPendingFrames) {
+    pending_frames_.pop_front();
+  }
+}
+
+void FrameScheduler::OnFrameRasterized(const FrameTiming& timing) {
+  const fml::TimePoint vsync_start = timing.Get(FrameTiming::kVsyncStart);
+  const fml::TimePoint build_finish = timing.Get(FrameTiming::kBuildFinish);
+  const fml::TimePoint raster_finish = timing.Get(FrameTiming::kRasterFinish);
+  AddDuration(build_durations_,
+              build_finish - timing.Get(FrameTiming::kBuildStart));
+  AddDuration(raster_durations_, raster_finish - build_finish);
+
+  // Frames built before this one that were not rasterized were dropped.
+  while (!pending_frames_.empty() &&
+         pending_frames_.front().vsync_start < vsync_start) {
+    pending_frames_.pop_front();
+  }
+  if (pending_frames_.empty() ||
+      pending_frames_.front().vsync_start != vsync_start) {
+    // The frame was rasterized again, or not built by the |Animator|.
+    return;
+  }
+  const PendingFrame frame = pending_frames_.front();
+  pending_frames_.pop_front();
+
+  const bool delayed = frame.build_delay > fml::TimeDelta::Zero();
+  stats_.frames++;
+  if (delayed) {
+    stats_.delayed_frames++;
+  }
+  if (raster_finish > frame.frame_target) {
+    stats_.late_frames++;
+    if (delayed) {
+      // The frame would probably have been on time if it had not been
+      // delayed, the durations learned are not representative anymore.
+      build_durations_.clear();
+      raster_durations_.clear();
+    }
+  }
+  if (frame.first_input) {
+    const fml::TimeDelta latency =
+        PresentationTime(frame.vsync_start, frame.frame_target, raster_finish) -
+        *frame.first_input;
+    stats_.input_frames++;
+    stats_.last_input_latency = latency;
+    stats_.max_input_latency = std::max(stats_.max_input_latency, latency);
+    stats_.total_input_latency = stats_.total_input_latency + latency;
+  }
+
+#if !FLUTTER_RELEASE
+  FML_TRACE_COUNTER("flutter", "FrameScheduling",
+                    reinterpret_cast<int64_t>(this), "BuildDelayMicros",
+                    frame.build_delay.ToMicroseconds(),
+                    "InputToPresentLatencyMicros",
+                    stats_.last_input_latency.ToMicroseconds(), "LateFrames",
+                    stats_.late_frames);
+#endif  // !FLUTTER_RELEASE
+}
+
+}  // namespace flutter
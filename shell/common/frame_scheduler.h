@@ -0,0 +1,118 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_FRAME_SCHEDULER_H_
+#define FLUTTER_SHELL_COMMON_FRAME_SCHEDULER_H_
+
+#include <deque>
+#include <optional>
+
+#include "flutter/common/settings.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace flutter {
+
+/// When the |Animator| starts building a frame after the vsync.
+enum class FrameSchedulingMode {
+  /// Frames are built as soon as the vsync fires.
+  Immediate,
+  /// The build of a frame is delayed within the frame interval by the time
+  /// the frame is not expected to need, so that it starts as late as it can
+  /// while still being presented on time. Input dispatched to the framework
+  /// during the delay is handled in the frame instead of the next one.
+  LatencyAware,
+};
+
+/// Statistics about the frames scheduled by a |FrameScheduler|.
+struct FrameSchedulingStats {
+  /// The number of frames whose timing was reported.
+  size_t frames = 0;
+  /// The number of frames whose build was delayed.
+  size_t delayed_frames = 0;
+  /// The number of frames that finished rasterizing after their target time.
+  size_t late_frames = 0;
+  /// The number of frames that handled input.
+  size_t input_frames = 0;
+  /// The time from the first input handled by the last frame that handled
+  /// input being dispatched to the framework, to the frame being presented.
+  fml::TimeDelta last_input_latency;
+  /// The largest input latency of any frame.
+  fml::TimeDelta max_input_latency;
+  /// The sum of the input latencies of all frames that handled input.
+  fml::TimeDelta total_input_latency;
+};
+
+/// Decides when the |Animator| starts building frames.
+///
+/// In |FrameSchedulingMode::LatencyAware| mode, the scheduler learns how long
+/// recent frames took to build on the UI thread and to get rasterized after
+/// that from their |FrameTiming|, and delays the start of the build by the
+/// part of the frame interval they are not expected to need. A frame whose
+/// build was delayed and that is late anyway makes the scheduler start over
+/// learning, building frames right away in the meantime.
+///
+/// From the |FrameTiming| it is given, the scheduler also measures the latency
+/// from input being dispatched to the framework to the frame handling it being
+/// presented, at the first vsync after it is rasterized, and traces it to the
+/// timeline. The |Shell| only reports |FrameTiming| to it in
+/// |FrameSchedulingMode::LatencyAware| mode, see
+/// |Settings::enable_latency_aware_frame_scheduling|.
+///
+/// This class is not thread-safe, it is used on the UI thread.
+class FrameScheduler {
+ public:
+  explicit FrameScheduler(FrameSchedulingMode mode);
+
+  ~FrameScheduler();
+
+  FrameSchedulingMode mode() const { return mode_; }
+
+  /// Returns how long after |vsync_start| the build of the frame targeting
+  /// |frame_target| should start.
+  fml::TimeDelta GetBuildStartDelay(fml::TimePoint vsync_start,
+                                    fml::TimePoint frame_target) const;
+
+  /// Records that input was dispatched to the framework at |time|.
+  void OnInputDispatched(fml::TimePoint time);
+
+  /// Records that the build of the frame for |vsync_start| and targeting
+  /// |frame_target| started after being delayed by |build_delay|. The input
+  /// dispatched before is handled by the frame.
+  void OnBeginFrame(fml::TimePoint vsync_start,
+                    fml::TimePoint frame_target,
+                    fml::TimeDelta build_delay);
+
+  /// Learns from the timing of a rasterized frame.
+  void OnFrameRasterized(const FrameTiming& timing);
+
+  FrameSchedulingStats GetStats() const { return stats_; }
+
+ private:
+  struct PendingFrame {
+    fml::TimePoint vsync_start;
+    fml::TimePoint frame_target;
+    std::optional<fml::TimePoint> first_input;
+    fml::TimeDelta build_delay;
+  };
+
+  const FrameSchedulingMode mode_;
+  // The durations of the builds of the last frames, and from the end of the
+  // builds to the end of the rasterization, including the hop to the raster
+  // thread.
+  std::deque<fml::TimeDelta> build_durations_;
+  std::deque<fml::TimeDelta> raster_durations_;
+  // The frames being built or rasterized.
+  std::deque<PendingFrame> pending_frames_;
+  // The first input dispatched since the last frame began.
+  std::optional<fml::TimePoint> first_input_;
+  FrameSchedulingStats stats_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FrameScheduler);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_FRAME_SCHEDULER_H_
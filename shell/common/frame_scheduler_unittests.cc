@@ -0,0 +1,210 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_scheduler.h"
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+using FrameCost = std::function<fml::TimeDelta(int frame)>;
+
+fml::TimeDelta Millis(double millis) {
+  return fml::TimeDelta::FromMicroseconds(
+      static_cast<int64_t>(millis * 1000));
+}
+
+// A deterministic cost in [min, max] that varies from frame to frame.
+FrameCost JitteredCost(double min_millis, double max_millis) {
+  return [min_millis, max_millis](int frame) {
+    const double fraction = ((frame * 7919) % 101) / 100.0;
+    return Millis(min_millis + fraction * (max_millis - min_millis));
+  };
+}
+
+struct SimulationResult {
+  FrameSchedulingStats stats;
+  std::vector<fml::TimeDelta> build_delays;
+
+  fml::TimeDelta MeanInputLatency() const {
+    return stats.total_input_latency / stats.input_frames;
+  }
+};
+
+//------------------------------------------------------------------------------
+/// Simulates |frame_count| frames with a vsync every |frame_interval|, built
+/// on the UI thread in |build_cost(i)| and rasterized on the raster thread in
+/// |raster_cost(i)| for the i-th frame, with input arriving every millisecond.
+///
+/// Like the |Animator|, the build of a frame starts after the delay the
+/// scheduler asks for, or when the UI thread is done with the previous frame.
+/// The input that arrives while the UI thread is building a frame is
+/// dispatched to the framework once it is done. The timings of the frames are
+/// reported at the first vsync after they are rasterized.
+SimulationResult SimulateFrames(FrameSchedulingMode mode,
+                                int frame_count,
+                                fml::TimeDelta frame_interval,
+                                const FrameCost& build_cost,
+                                const FrameCost& raster_cost) {
+  FrameScheduler scheduler(mode);
+  SimulationResult result;
+
+  const fml::TimePoint start = fml::TimePoint::FromEpochDelta(Millis(1000));
+  const fml::TimeDelta input_interval = Millis(1);
+  fml::TimePoint next_input = start;
+  fml::TimePoint ui_thread_free = start;
+  fml::TimePoint raster_thread_free = start;
+  std::vector<FrameTiming> unreported_timings;
+
+  for (int i = 0; i < frame_count; i++) {
+    const fml::TimePoint vsync_start = start + frame_interval * i;
+    const fml::TimePoint frame_target = vsync_start + frame_interval;
+
+    auto rasterized = std::partition(
+        unreported_timings.begin(), unreported_timings.end(),
+        [vsync_start](const FrameTiming& timing) {
+          return timing.Get(FrameTiming::kRasterFinish) <= vsync_start;
+        });
+    for (auto timing = unreported_timings.begin(); timing != rasterized;
+         ++timing) {
+      scheduler.OnFrameRasterized(*timing);
+    }
+    unreported_timings.erase(unreported_timings.begin(), rasterized);
+
+    const fml::TimeDelta build_delay =
+        scheduler.GetBuildStartDelay(vsync_start, frame_target);
+    result.build_delays.push_back(build_delay);
+    const fml::TimePoint build_start =
+        std::max(vsync_start + build_delay, ui_thread_free);
+
+    while (next_input <= build_start) {
+      scheduler.OnInputDispatched(std::max(next_input, ui_thread_free));
+      next_input = next_input + input_interval;
+    }
+    scheduler.OnBeginFrame(vsync_start, frame_target, build_delay);
+
+    FrameTiming timing;
+    timing.Set(FrameTiming::kVsyncStart, vsync_start);
+    timing.Set(FrameTiming::kBuildStart, build_start);
+    ui_thread_free =
+        timing.Set(FrameTiming::kBuildFinish, build_start + build_cost(i));
+    const fml::TimePoint raster_start =
+        timing.Set(FrameTiming::kRasterStart,
+                   std::max(ui_thread_free, raster_thread_free));
+    raster_thread_free =
+        timing.Set(FrameTiming::kRasterFinish, raster_start + raster_cost(i));
+    unreported_timings.push_back(timing);
+  }
+  for (const FrameTiming& timing : unreported_timings) {
+    scheduler.OnFrameRasterized(timing);
+  }
+
+  result.stats = scheduler.GetStats();
+  return result;
+}
+
+}  // namespace
+
+TEST(FrameSchedulerTest, ImmediateModeNeverDelaysBuilds) {
+  SimulationResult result =
+      SimulateFrames(FrameSchedulingMode::Immediate, 300, Millis(16.667),
+                     JitteredCost(2, 4), JitteredCost(3, 5));
+  for (fml::TimeDelta build_delay : result.build_delays) {
+    EXPECT_EQ(build_delay, fml::TimeDelta::Zero());
+  }
+  EXPECT_EQ(result.stats.frames, 300u);
+  EXPECT_EQ(result.stats.delayed_frames, 0u);
+  EXPECT_EQ(result.stats.late_frames, 0u);
+  EXPECT_EQ(result.stats.input_frames, 300u);
+}
+
+TEST(FrameSchedulerTest, DelaysBuildsWithoutMissingDeadlines) {
+  for (double frame_interval : {16.667, 8.333}) {
+    FrameCost build_cost = JitteredCost(1, frame_interval / 4);
+    FrameCost raster_cost = JitteredCost(1, frame_interval / 3);
+    SimulationResult immediate =
+        SimulateFrames(FrameSchedulingMode::Immediate, 300,
+                       Millis(frame_interval), build_cost, raster_cost);
+    SimulationResult latency_aware =
+        SimulateFrames(FrameSchedulingMode::LatencyAware, 300,
+                       Millis(frame_interval), build_cost, raster_cost);
+
+    // The first frames are built right away while the durations are learned.
+    for (size_t i = 0; i < 10; i++) {
+      EXPECT_EQ(latency_aware.build_delays[i], fml::TimeDelta::Zero());
+    }
+    EXPECT_GT(latency_aware.stats.delayed_frames, 280u);
+    EXPECT_EQ(latency_aware.stats.late_frames, 0u);
+    EXPECT_EQ(immediate.stats.late_frames, 0u);
+
+    // The input is handled by frames that start later, but are presented at
+    // the same time.
+    const fml::TimeDelta min_delay = *std::min_element(
+        latency_aware.build_delays.begin() + 10,
+        latency_aware.build_delays.end());
+    EXPECT_GT(min_delay, Millis(frame_interval / 5));
+    EXPECT_LT(latency_aware.MeanInputLatency(),
+              immediate.MeanInputLatency() - min_delay + Millis(1));
+  }
+}
+
+TEST(FrameSchedulerTest, DoesNotDelayFramesOverBudget) {
+  // Frames that need more than the frame interval are presented late however
+  // they are scheduled.
+  SimulationResult result =
+      SimulateFrames(FrameSchedulingMode::LatencyAware, 100, Millis(16.667),
+                     JitteredCost(8, 10), JitteredCost(8, 10));
+  for (fml::TimeDelta build_delay : result.build_delays) {
+    EXPECT_EQ(build_delay, fml::TimeDelta::Zero());
+  }
+  EXPECT_EQ(result.stats.delayed_frames, 0u);
+}
+
+TEST(FrameSchedulerTest, StopsDelayingWhenFramesGetSlower) {
+  // The frames get slower after 100 frames, still fitting in the frame
+  // interval when built right away.
+  FrameCost build_cost = [](int frame) {
+    return frame < 100 ? Millis(3) : Millis(7);
+  };
+  FrameCost raster_cost = [](int frame) {
+    return frame < 100 ? Millis(3) : Millis(7);
+  };
+  SimulationResult result =
+      SimulateFrames(FrameSchedulingMode::LatencyAware, 200, Millis(16.667),
+                     build_cost, raster_cost);
+
+  // Only the frames delayed before the scheduler noticed are late.
+  EXPECT_GT(result.stats.late_frames, 0u);
+  EXPECT_LE(result.stats.late_frames, 2u);
+  for (size_t i = 105; i < result.build_delays.size(); i++) {
+    EXPECT_LE(result.build_delays[i], Millis(16.667 - 14));
+  }
+}
+
+TEST(FrameSchedulerTest, IgnoresFramesItDidNotSchedule) {
+  FrameScheduler scheduler(FrameSchedulingMode::LatencyAware);
+  const fml::TimePoint vsync_start =
+      fml::TimePoint::FromEpochDelta(Millis(1000));
+  FrameTiming timing;
+  timing.Set(FrameTiming::kVsyncStart, vsync_start);
+  timing.Set(FrameTiming::kBuildStart, vsync_start);
+  timing.Set(FrameTiming::kBuildFinish, vsync_start + Millis(1));
+  timing.Set(FrameTiming::kRasterStart, vsync_start + Millis(1));
+  timing.Set(FrameTiming::kRasterFinish, vsync_start + Millis(30));
+  scheduler.OnFrameRasterized(timing);
+
+  FrameSchedulingStats stats = scheduler.GetStats();
+  EXPECT_EQ(stats.frames, 0u);
+  EXPECT_EQ(stats.late_frames, 0u);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -7,6 +7,7 @@
 #include <memory>
 
 #include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/common/graphics/shader_cache_file.h"
 #include "flutter/flow/layers/container_layer.h"
 #include "flutter/flow/layers/layer.h"
 #include "flutter/flow/layers/physical_shape_layer.h"
@@ -14,6 +15,7 @@
 #include "flutter/fml/command_line.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/log_settings.h"
+#include "flutter/fml/paths.h"
 #include "flutter/fml/unique_fd.h"
 #include "flutter/shell/common/shell_test.h"
 #include "flutter/shell/common/switches.h"
@@ -362,5 +364,164 @@ TEST_F(PersistentCacheTest, PurgeAllowsFutureSkSLCache) {
   DestroyShell(std::move(shell));
 }
 
+static sk_sp<SkData> MakeShaderData(size_t size, char value) {
+  return SkData::MakeWithCopy(std::string(size, value).data(), size);
+}
+
+TEST_F(PersistentCacheTest, ShaderCacheFileServesLoadsFromOneFile) {
+  sk_sp<SkData> shader_key = SkData::MakeWithCString("key");
+  sk_sp<SkData> shader_value = SkData::MakeWithCString("value");
+
+  fml::ScopedTemporaryDirectory base_dir;
+  ASSERT_TRUE(base_dir.fd().is_valid());
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::SetUseShaderCacheFile(true);
+  PersistentCache::ResetCacheForProcess();
+  PersistentCache::SetCacheSkSL(false);
+
+  // Without workers, the entry is written right away.
+  auto persistent_cache = PersistentCache::GetCacheForProcess();
+  StorePersistentCache(persistent_cache, *shader_key, *shader_value);
+  sk_sp<SkData> loaded = persistent_cache->load(*shader_key);
+  ASSERT_NE(loaded, nullptr);
+  EXPECT_TRUE(loaded->equals(shader_value.get()));
+
+  // The next launch finds the entry in the cache file, and nowhere else.
+  PersistentCache::ResetCacheForProcess();
+  persistent_cache = PersistentCache::GetCacheForProcess();
+  loaded = persistent_cache->load(*shader_key);
+  ASSERT_NE(loaded, nullptr);
+  EXPECT_TRUE(loaded->equals(shader_value.get()));
+  EXPECT_EQ(persistent_cache->load(*SkData::MakeWithCString("other")),
+            nullptr);
+
+  auto cache_dir = fml::OpenDirectoryReadOnly(
+      base_dir.fd(), fml::paths::JoinPaths({"flutter_engine",
+                                            GetFlutterEngineVersion(), "skia",
+                                            GetSkiaVersion()})
+                         .c_str());
+  EXPECT_TRUE(fml::FileExists(cache_dir, ShaderCacheFile::kFileName));
+  EXPECT_FALSE(fml::FileExists(
+      cache_dir, PersistentCache::SkKeyToFilePath(*shader_key).c_str()));
+
+  // Cleanup
+  PersistentCache::SetUseShaderCacheFile(false);
+  PersistentCache::ResetCacheForProcess();
+  fml::RemoveFilesInDirectory(base_dir.fd());
+}
+
+TEST_F(PersistentCacheTest, ShaderCacheFileIsNotLoadedAsAnSkSL) {
+  sk_sp<SkData> shader_key = SkData::MakeWithCString("key");
+  sk_sp<SkData> shader_value = SkData::MakeWithCString("sksl");
+
+  fml::ScopedTemporaryDirectory base_dir;
+  ASSERT_TRUE(base_dir.fd().is_valid());
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::SetUseShaderCacheFile(true);
+  PersistentCache::ResetCacheForProcess();
+  PersistentCache::SetCacheSkSL(true);
+
+  auto persistent_cache = PersistentCache::GetCacheForProcess();
+  StorePersistentCache(persistent_cache, *shader_key, *shader_value);
+
+  // The cache file shares the SkSL directory with the files of the SkSLs
+  // cached before it was used, and with its temporary file during a rewrite.
+  auto sksl_dir = fml::OpenDirectory(
+      base_dir.fd(),
+      fml::paths::JoinPaths({"flutter_engine", GetFlutterEngineVersion(),
+                             "skia", GetSkiaVersion(),
+                             PersistentCache::kSkSLSubdirName})
+          .c_str(),
+      false, fml::FilePermission::kReadWrite);
+  ASSERT_TRUE(fml::FileExists(sksl_dir, ShaderCacheFile::kFileName));
+  const std::string temp_file_name =
+      std::string(ShaderCacheFile::kFileName) + ".temp";
+  ASSERT_TRUE(ShaderCacheFile::IsCacheFileName(temp_file_name));
+  ASSERT_TRUE(fml::WriteAtomically(
+      sksl_dir, temp_file_name.c_str(),
+      fml::DataMapping(std::vector<uint8_t>{1, 2, 3})));
+
+  auto sksls = persistent_cache->LoadSkSLs();
+  ASSERT_EQ(sksls.size(), 1u);
+  EXPECT_TRUE(sksls[0].first->equals(shader_key.get()));
+  EXPECT_TRUE(sksls[0].second->equals(shader_value.get()));
+  EXPECT_FALSE(ShaderCacheFile::IsCacheFileName(
+      PersistentCache::SkKeyToFilePath(*shader_key)));
+
+  // Cleanup
+  PersistentCache::SetCacheSkSL(false);
+  PersistentCache::SetUseShaderCacheFile(false);
+  PersistentCache::ResetCacheForProcess();
+  fml::RemoveFilesInDirectory(base_dir.fd());
+}
+
+TEST_F(PersistentCacheTest, ShaderCacheFileEvictsLeastRecentlyUsedEntries) {
+  fml::ScopedTemporaryDirectory dir;
+  auto directory = std::make_shared<fml::UniqueFD>(fml::OpenDirectory(
+      dir.path().c_str(), false, fml::FilePermission::kReadWrite));
+  constexpr size_t kMaxBytes = 4096;
+
+  {
+    ShaderCacheFile cache_file(directory, kMaxBytes);
+    for (char c = 'a'; c <= 'z'; c++) {
+      std::string key(1, c);
+      ASSERT_TRUE(cache_file.Add(*SkData::MakeWithCString(key.c_str()),
+                                 *MakeShaderData(256, c)));
+      // Keep using "a", so that it is never the least recently used entry.
+      ASSERT_NE(cache_file.Find(*SkData::MakeWithCString("a")), nullptr);
+      cache_file.Flush();
+      EXPECT_LE(cache_file.GetFileSize(), kMaxBytes);
+    }
+    EXPECT_LT(cache_file.GetEntryCount(), 26u);
+  }
+
+  ShaderCacheFile cache_file(directory, kMaxBytes);
+  EXPECT_GT(cache_file.GetEntryCount(), 0u);
+  EXPECT_LT(cache_file.GetEntryCount(), 26u);
+  sk_sp<SkData> a = cache_file.Find(*SkData::MakeWithCString("a"));
+  ASSERT_NE(a, nullptr);
+  EXPECT_TRUE(a->equals(MakeShaderData(256, 'a').get()));
+  EXPECT_NE(cache_file.Find(*SkData::MakeWithCString("z")), nullptr);
+  EXPECT_EQ(cache_file.Find(*SkData::MakeWithCString("b")), nullptr);
+}
+
+TEST_F(PersistentCacheTest, ShaderCacheFileIgnoresTruncatedRecords) {
+  fml::ScopedTemporaryDirectory dir;
+  auto directory = std::make_shared<fml::UniqueFD>(fml::OpenDirectory(
+      dir.path().c_str(), false, fml::FilePermission::kReadWrite));
+
+  size_t valid_size;
+  {
+    ShaderCacheFile cache_file(directory);
+    cache_file.Add(*SkData::MakeWithCString("a"), *MakeShaderData(100, 'a'));
+    cache_file.Add(*SkData::MakeWithCString("b"), *MakeShaderData(100, 'b'));
+    cache_file.Flush();
+    valid_size = cache_file.GetFileSize();
+    ASSERT_GT(valid_size, 200u);
+  }
+
+  // Cut the last record short, as if the process died while writing it.
+  {
+    auto file = fml::OpenFile(*directory, ShaderCacheFile::kFileName, false,
+                              fml::FilePermission::kReadWrite);
+    ASSERT_TRUE(fml::TruncateFile(file, valid_size - 10));
+  }
+
+  {
+    ShaderCacheFile cache_file(directory);
+    EXPECT_EQ(cache_file.GetEntryCount(), 1u);
+    EXPECT_NE(cache_file.Find(*SkData::MakeWithCString("a")), nullptr);
+    EXPECT_EQ(cache_file.Find(*SkData::MakeWithCString("b")), nullptr);
+    // The next flush drops the truncated record.
+    cache_file.Add(*SkData::MakeWithCString("c"), *MakeShaderData(100, 'c'));
+    cache_file.Flush();
+  }
+
+  ShaderCacheFile cache_file(directory);
+  EXPECT_EQ(cache_file.GetEntryCount(), 2u);
+  EXPECT_NE(cache_file.Find(*SkData::MakeWithCString("a")), nullptr);
+  EXPECT_NE(cache_file.Find(*SkData::MakeWithCString("c")), nullptr);
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -5,6 +5,7 @@
 #ifndef FLUTTER_SHELL_COMMON_PIPELINE_H_
 #define FLUTTER_SHELL_COMMON_PIPELINE_H_
 
+#include <algorithm>
 #include <deque>
 #include <memory>
 #include <mutex>
@@ -12,6 +13,7 @@
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
 #include "flutter/fml/synchronization/semaphore.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/fml/trace_event.h"
 
 namespace flutter {
@@ -22,10 +24,47 @@ enum class PipelineConsumeResult {
   MoreAvailable,
 };
 
+enum class PipelineMode {
+  /// Resources are consumed in the order they were produced. The producer
+  /// can not produce more resources than the depth of the pipeline before the
+  /// consumer catches up.
+  Queue,
+  /// The pipeline holds at most one pending resource and the producer can
+  /// always produce. Committing a resource replaces the pending one if the
+  /// consumer has not taken it yet, so the consumer always gets the newest
+  /// resource.
+  Mailbox,
+};
+
+/// Statistics about the resources that went through a pipeline.
+struct PipelineStats {
+  /// The number of resources committed by the producer.
+  size_t produced = 0;
+  /// The number of resources handed to the consumer.
+  size_t consumed = 0;
+  /// The number of resources replaced by a newer one before they were
+  /// consumed. Only resources in a |PipelineMode::Mailbox| pipeline are ever
+  /// replaced.
+  size_t replaced = 0;
+  /// The number of continuations that were discarded or whose resource was
+  /// rejected by the pipeline.
+  size_t dropped = 0;
+  /// The time from the last consumed resource being produced to the consumer
+  /// being done with it.
+  fml::TimeDelta last_latency;
+  /// The largest latency of any consumed resource.
+  fml::TimeDelta max_latency;
+  /// The sum of the latencies of all consumed resources.
+  fml::TimeDelta total_latency;
+};
+
 size_t GetNextPipelineTraceID();
 
 /// A thread-safe queue of resources for a single consumer and a single
 /// producer.
+///
+/// The latency of a resource is measured from the call to |Produce| that
+/// reserved its spot in the pipeline.
 template <class R>
 class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
  public:
@@ -90,15 +129,26 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
     FML_DISALLOW_COPY_AND_ASSIGN(ProducerContinuation);
   };
 
-  explicit Pipeline(uint32_t depth)
-      : depth_(depth), empty_(depth), available_(0), inflight_(0) {}
+  explicit Pipeline(uint32_t depth, PipelineMode mode = PipelineMode::Queue)
+      : depth_(depth),
+        mode_(mode),
+        empty_(depth),
+        available_(0),
+        inflight_(0) {}
 
   ~Pipeline() = default;
 
   bool IsValid() const { return empty_.IsValid() && available_.IsValid(); }
 
+  PipelineMode mode() const { return mode_; }
+
+  PipelineStats GetStats() {
+    std::scoped_lock lock(queue_mutex_);
+    return stats_;
+  }
+
   ProducerContinuation Produce() {
-    if (!empty_.TryWait()) {
+    if (mode_ == PipelineMode::Queue && !empty_.TryWait()) {
       return {};
     }
     ++inflight_;
@@ -109,7 +159,8 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
 
     return ProducerContinuation{
         std::bind(&Pipeline::ProducerCommit, this, std::placeholders::_1,
-                  std::placeholders::_2),  // continuation
+                  std::placeholders::_2,
+                  fml::TimePoint::Now()),  // continuation
         GetNextPipelineTraceID()};         // trace id
   }
 
@@ -118,7 +169,7 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
   // Prefer using |Produce|. ProducerContinuation returned by this method
   // doesn't guarantee that the frame will be rendered.
   ProducerContinuation ProduceIfEmpty() {
-    if (!empty_.TryWait()) {
+    if (mode_ == PipelineMode::Queue && !empty_.TryWait()) {
       return {};
     }
     ++inflight_;
@@ -129,7 +180,8 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
 
     return ProducerContinuation{
         std::bind(&Pipeline::ProducerCommitIfEmpty, this, std::placeholders::_1,
-                  std::placeholders::_2),  // continuation
+                  std::placeholders::_2,
+                  fml::TimePoint::Now()),  // continuation
         GetNextPipelineTraceID()};         // trace id
   }
 
@@ -145,25 +197,42 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
       return PipelineConsumeResult::NoneAvailable;
     }
 
-    ResourcePtr resource;
-    size_t trace_id = 0;
+    Item item;
     size_t items_count = 0;
 
     {
       std::scoped_lock lock(queue_mutex_);
-      std::tie(resource, trace_id) = std::move(queue_.front());
+      item = std::move(queue_.front());
       queue_.pop_front();
       items_count = queue_.size();
     }
 
+    const size_t trace_id = item.trace_id;
+    const bool has_resource = item.resource != nullptr;
     {
       TRACE_EVENT0("flutter", "PipelineConsume");
-      consumer(std::move(resource));
+      consumer(std::move(item.resource));
     }
 
-    empty_.Signal();
+    if (mode_ == PipelineMode::Queue) {
+      empty_.Signal();
+    }
     --inflight_;
 
+    if (has_resource) {
+      const fml::TimeDelta latency =
+          fml::TimePoint::Now() - item.produce_time;
+      std::scoped_lock lock(queue_mutex_);
+      stats_.consumed++;
+      stats_.last_latency = latency;
+      stats_.max_latency = std::max(stats_.max_latency, latency);
+      stats_.total_latency = stats_.total_latency + latency;
+      FML_TRACE_COUNTER("flutter", "Pipeline Latency",
+                        reinterpret_cast<int64_t>(this),            //
+                        "latency (us)", latency.ToMicroseconds()  //
+      );
+    }
+
     TRACE_FLOW_END("flutter", "PipelineItem", trace_id);
     TRACE_EVENT_ASYNC_END0("flutter", "PipelineItem", trace_id);
 
@@ -172,17 +241,41 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
   }
 
  private:
+  struct Item {
+    ResourcePtr resource;
+    size_t trace_id = 0;
+    fml::TimePoint produce_time;
+  };
+
   const uint32_t depth_;
+  const PipelineMode mode_;
   fml::Semaphore empty_;
   fml::Semaphore available_;
   std::atomic<int> inflight_;
   std::mutex queue_mutex_;
-  std::deque<std::pair<ResourcePtr, size_t>> queue_;
+  std::deque<Item> queue_;
+  PipelineStats stats_;
 
-  bool ProducerCommit(ResourcePtr resource, size_t trace_id) {
+  bool ProducerCommit(ResourcePtr resource,
+                      size_t trace_id,
+                      fml::TimePoint produce_time) {
     {
       std::scoped_lock lock(queue_mutex_);
-      queue_.emplace_back(std::move(resource), trace_id);
+      if (!resource) {
+        stats_.dropped++;
+        if (mode_ == PipelineMode::Mailbox) {
+          // There is no spot to give back and nothing worth consuming.
+          --inflight_;
+          return false;
+        }
+      } else {
+        stats_.produced++;
+      }
+      if (mode_ == PipelineMode::Mailbox && !queue_.empty()) {
+        ReplacePendingItem(std::move(resource), trace_id, produce_time);
+        return true;
+      }
+      queue_.push_back({std::move(resource), trace_id, produce_time});
     }
 
     // Ensure the queue mutex is not held as that would be a pessimization.
@@ -190,16 +283,32 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
     return true;
   }
 
-  bool ProducerCommitIfEmpty(ResourcePtr resource, size_t trace_id) {
+  bool ProducerCommitIfEmpty(ResourcePtr resource,
+                             size_t trace_id,
+                             fml::TimePoint produce_time) {
     {
       std::scoped_lock lock(queue_mutex_);
       if (!queue_.empty()) {
         // Bail if the queue is not empty, opens up spaces to produce other
         // frames.
-        empty_.Signal();
+        stats_.dropped++;
+        if (mode_ == PipelineMode::Queue) {
+          empty_.Signal();
+        } else {
+          --inflight_;
+        }
         return false;
       }
-      queue_.emplace_back(std::move(resource), trace_id);
+      if (!resource) {
+        stats_.dropped++;
+        if (mode_ == PipelineMode::Mailbox) {
+          --inflight_;
+          return false;
+        }
+      } else {
+        stats_.produced++;
+      }
+      queue_.push_back({std::move(resource), trace_id, produce_time});
     }
 
     // Ensure the queue mutex is not held as that would be a pessimization.
@@ -207,6 +316,24 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
     return true;
   }
 
+  // Replaces the resource waiting in a |PipelineMode::Mailbox| pipeline. The
+  // consumer has already been signaled for the pending item so it is not
+  // signaled again. Must be called with |queue_mutex_| held.
+  void ReplacePendingItem(ResourcePtr resource,
+                          size_t trace_id,
+                          fml::TimePoint produce_time) {
+    Item& pending = queue_.front();
+    TRACE_FLOW_END("flutter", "PipelineItem", pending.trace_id);
+    TRACE_EVENT_ASYNC_END0("flutter", "PipelineItem", pending.trace_id);
+    pending = {std::move(resource), trace_id, produce_time};
+    stats_.replaced++;
+    --inflight_;
+    FML_TRACE_COUNTER("flutter", "Pipeline Replaced",
+                      reinterpret_cast<int64_t>(this),  //
+                      "replaced frames", stats_.replaced  //
+    );
+  }
+
   FML_DISALLOW_COPY_AND_ASSIGN(Pipeline);
 };
 
@@ -9,6 +9,7 @@
 #include <functional>
 #include <future>
 #include <memory>
+#include <thread>
 
 #include "gtest/gtest.h"
 
@@ -131,5 +132,96 @@ TEST(PipelineTest, ProduceIfEmptySuccessfulIfQueueIsEmpty) {
   ASSERT_EQ(consume_result_1, PipelineConsumeResult::Done);
 }
 
+TEST(PipelineTest, MailboxAlwaysProduces) {
+  fml::RefPtr<IntPipeline> pipeline =
+      fml::MakeRefCounted<IntPipeline>(1, PipelineMode::Mailbox);
+
+  for (int i = 0; i < 3; i++) {
+    Continuation continuation = pipeline->Produce();
+    ASSERT_TRUE(continuation);
+    ASSERT_TRUE(continuation.Complete(std::make_unique<int>(i)));
+  }
+}
+
+TEST(PipelineTest, MailboxConsumesLatestResource) {
+  fml::RefPtr<IntPipeline> pipeline =
+      fml::MakeRefCounted<IntPipeline>(2, PipelineMode::Mailbox);
+
+  Continuation continuation_1 = pipeline->Produce();
+  Continuation continuation_2 = pipeline->Produce();
+  Continuation continuation_3 = pipeline->Produce();
+  ASSERT_TRUE(continuation_1.Complete(std::make_unique<int>(1)));
+  ASSERT_TRUE(continuation_2.Complete(std::make_unique<int>(2)));
+  ASSERT_TRUE(continuation_3.Complete(std::make_unique<int>(3)));
+
+  int consumed = 0;
+  PipelineConsumeResult consume_result = pipeline->Consume(
+      [&consumed](std::unique_ptr<int> v) { consumed = *v; });
+  ASSERT_EQ(consume_result, PipelineConsumeResult::Done);
+  ASSERT_EQ(consumed, 3);
+
+  consume_result = pipeline->Consume([](std::unique_ptr<int> v) { FAIL(); });
+  ASSERT_EQ(consume_result, PipelineConsumeResult::NoneAvailable);
+
+  PipelineStats stats = pipeline->GetStats();
+  ASSERT_EQ(stats.produced, 3u);
+  ASSERT_EQ(stats.consumed, 1u);
+  ASSERT_EQ(stats.replaced, 2u);
+  ASSERT_EQ(stats.dropped, 0u);
+}
+
+TEST(PipelineTest, MailboxDoesNotReplaceWithDiscardedContinuation) {
+  fml::RefPtr<IntPipeline> pipeline =
+      fml::MakeRefCounted<IntPipeline>(1, PipelineMode::Mailbox);
+
+  Continuation continuation_1 = pipeline->Produce();
+  ASSERT_TRUE(continuation_1.Complete(std::make_unique<int>(1)));
+  { Continuation continuation_2 = pipeline->Produce(); }
+
+  int consumed = 0;
+  PipelineConsumeResult consume_result = pipeline->Consume(
+      [&consumed](std::unique_ptr<int> v) { consumed = *v; });
+  ASSERT_EQ(consume_result, PipelineConsumeResult::Done);
+  ASSERT_EQ(consumed, 1);
+  ASSERT_EQ(pipeline->GetStats().dropped, 1u);
+}
+
+TEST(PipelineTest, MailboxProduceIfEmptyDoesNotReplace) {
+  fml::RefPtr<IntPipeline> pipeline =
+      fml::MakeRefCounted<IntPipeline>(1, PipelineMode::Mailbox);
+
+  Continuation continuation_1 = pipeline->Produce();
+  Continuation continuation_2 = pipeline->ProduceIfEmpty();
+  ASSERT_TRUE(continuation_1.Complete(std::make_unique<int>(1)));
+  ASSERT_FALSE(continuation_2.Complete(std::make_unique<int>(2)));
+
+  int consumed = 0;
+  PipelineConsumeResult consume_result = pipeline->Consume(
+      [&consumed](std::unique_ptr<int> v) { consumed = *v; });
+  ASSERT_EQ(consume_result, PipelineConsumeResult::Done);
+  ASSERT_EQ(consumed, 1);
+}
+
+TEST(PipelineTest, QueueReportsLatency) {
+  fml::RefPtr<IntPipeline> pipeline = fml::MakeRefCounted<IntPipeline>(2);
+
+  Continuation continuation = pipeline->Produce();
+  ASSERT_TRUE(continuation.Complete(std::make_unique<int>(1)));
+  const fml::TimeDelta delay = fml::TimeDelta::FromMilliseconds(5);
+  PipelineConsumeResult consume_result =
+      pipeline->Consume([](std::unique_ptr<int> v) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      });
+  ASSERT_EQ(consume_result, PipelineConsumeResult::Done);
+
+  PipelineStats stats = pipeline->GetStats();
+  ASSERT_EQ(stats.produced, 1u);
+  ASSERT_EQ(stats.consumed, 1u);
+  ASSERT_EQ(stats.replaced, 0u);
+  ASSERT_GE(stats.last_latency, delay);
+  ASSERT_EQ(stats.max_latency, stats.last_latency);
+  ASSERT_EQ(stats.total_latency, stats.last_latency);
+}
+
 }  // namespace testing
 }  // namespace flutter
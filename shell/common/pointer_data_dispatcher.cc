@@ -4,6 +4,13 @@
 
 #include "flutter/shell/common/pointer_data_dispatcher.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <unordered_set>
+
 #include "flutter/fml/trace_event.h"
 
 namespace flutter {
@@ -15,6 +22,16 @@ SmoothPointerDataDispatcher::SmoothPointerDataDispatcher(Delegate& delegate)
     : DefaultPointerDataDispatcher(delegate), weak_factory_(this) {}
 SmoothPointerDataDispatcher::~SmoothPointerDataDispatcher() = default;
 
+ResamplingPointerDataDispatcher::ResamplingPointerDataDispatcher(
+    Delegate& delegate,
+    Config config,
+    Clock clock)
+    : DefaultPointerDataDispatcher(delegate),
+      config_(config),
+      clock_(std::move(clock)),
+      weak_factory_(this) {}
+ResamplingPointerDataDispatcher::~ResamplingPointerDataDispatcher() = default;
+
 void DefaultPointerDataDispatcher::DispatchPacket(
     std::unique_ptr<PointerDataPacket> packet,
     uint64_t trace_flow_id) {
@@ -68,4 +85,330 @@ void SmoothPointerDataDispatcher::DispatchPendingPacket() {
   ScheduleSecondaryVsyncCallback();
 }
 
+namespace {
+
+// Event timestamps further than this from the current time are assumed not to
+// be on the clock of |fml::TimePoint|.
+constexpr fml::TimeDelta kMaxClockSkew = fml::TimeDelta::FromMilliseconds(100);
+
+// The velocity of a pointer is measured over at least this long, as the
+// positions of events closer than this are too noisy to extrapolate from.
+constexpr fml::TimeDelta kMinExtrapolationInterval =
+    fml::TimeDelta::FromMilliseconds(2);
+
+bool IsMoveOrHover(const PointerData& data) {
+  return data.change == PointerData::Change::kMove ||
+         data.change == PointerData::Change::kHover;
+}
+
+// Sets the position of |data| to the one at |time_stamp| on the line through
+// |from| and |to|.
+void SetPositionAt(const PointerData& from,
+                   const PointerData& to,
+                   int64_t time_stamp,
+                   PointerData& data) {
+  const double alpha = static_cast<double>(time_stamp - from.time_stamp) /
+                       static_cast<double>(to.time_stamp - from.time_stamp);
+  data.time_stamp = time_stamp;
+  data.physical_x = from.physical_x + alpha * (to.physical_x - from.physical_x);
+  data.physical_y = from.physical_y + alpha * (to.physical_y - from.physical_y);
+}
+
+// The last event dispatched for a pointer.
+struct DispatchedEvent {
+  double x = 0;
+  double y = 0;
+  int64_t time_stamp = 0;
+};
+
+}  // namespace
+
+ResamplingPointerDataDispatcher::Config
+ResamplingPointerDataDispatcher::Config::Default() {
+  Config config;
+  for (DeviceKindConfig& device_kind : config.device_kinds) {
+    device_kind.sampling_offset = fml::TimeDelta::FromMilliseconds(5);
+    device_kind.max_extrapolation = fml::TimeDelta::FromMilliseconds(8);
+  }
+  DeviceKindConfig& mouse =
+      config.device_kinds[static_cast<size_t>(PointerData::DeviceKind::kMouse)];
+  mouse.sampling_offset = fml::TimeDelta::Zero();
+  mouse.max_extrapolation = fml::TimeDelta::Zero();
+  return config;
+}
+
+const ResamplingPointerDataDispatcher::DeviceKindConfig&
+ResamplingPointerDataDispatcher::Config::ForKind(
+    PointerData::DeviceKind kind) const {
+  // Embedders may report kinds the engine has no configuration for, such as
+  // the unknown kind of Android. Their events are not held.
+  static const DeviceKindConfig kUnknownKind{/*enabled=*/false};
+  const size_t index = static_cast<size_t>(kind);
+  if (index >= std::size(device_kinds)) {
+    return kUnknownKind;
+  }
+  return device_kinds[index];
+}
+
+bool ResamplingPointerDataDispatcher::IsHeld(const PointerData& data) const {
+  return config_.ForKind(data.kind).enabled;
+}
+
+bool ResamplingPointerDataDispatcher::IsResampled(
+    const PointerData& data) const {
+  return IsHeld(data) && IsMoveOrHover(data) &&
+         data.signal_kind == PointerData::SignalKind::kNone;
+}
+
+void ResamplingPointerDataDispatcher::DispatchPacket(
+    std::unique_ptr<PointerDataPacket> packet,
+    uint64_t trace_flow_id) {
+  TRACE_EVENT0("flutter", "ResamplingPointerDataDispatcher::DispatchPacket");
+  TRACE_FLOW_STEP("flutter", "PointerEvent", trace_flow_id);
+
+  const std::vector<uint8_t>& bytes = packet->data();
+  const size_t count = bytes.size() / sizeof(PointerData);
+  bool has_held_events = false;
+  for (size_t i = 0; i < count && !has_held_events; i++) {
+    PointerData data;
+    memcpy(&data, &bytes[i * sizeof(PointerData)], sizeof(PointerData));
+    has_held_events = IsHeld(data);
+  }
+  if (!has_held_events && pending_events_.empty()) {
+    DefaultPointerDataDispatcher::DispatchPacket(std::move(packet),
+                                                 trace_flow_id);
+    return;
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    PointerData& data = pending_events_.emplace_back();
+    memcpy(&data, &bytes[i * sizeof(PointerData)], sizeof(PointerData));
+  }
+  pending_trace_flow_ids_.push_back(trace_flow_id);
+  ScheduleSecondaryVsyncCallback();
+}
+
+void ResamplingPointerDataDispatcher::ScheduleSecondaryVsyncCallback() {
+  if (is_vsync_scheduled_) {
+    return;
+  }
+  is_vsync_scheduled_ = true;
+  delegate_.ScheduleSecondaryVsyncCallback(
+      reinterpret_cast<uintptr_t>(this),
+      [dispatcher = weak_factory_.GetWeakPtr()]() {
+        if (dispatcher) {
+          dispatcher->OnVsync();
+        }
+      });
+}
+
+void ResamplingPointerDataDispatcher::OnVsync() {
+  TRACE_EVENT0("flutter", "ResamplingPointerDataDispatcher::OnVsync");
+  is_vsync_scheduled_ = false;
+
+  const int64_t now = clock_().ToEpochDelta().ToMicroseconds();
+  bool resample = true;
+  for (const PointerData& data : pending_events_) {
+    if (IsResampled(data) &&
+        std::abs(data.time_stamp - now) > kMaxClockSkew.ToMicroseconds()) {
+      resample = false;
+      break;
+    }
+  }
+  auto sample_time = [this, resample, now](const PointerData& data) {
+    if (!resample) {
+      return std::numeric_limits<int64_t>::max();
+    }
+    return now - config_.ForKind(data.kind).sampling_offset.ToMicroseconds();
+  };
+
+  // The events dispatched before this frame, to compute the deltas and to
+  // keep the timestamps of each pointer from going backwards.
+  std::unordered_map<int64_t, DispatchedEvent> dispatched;
+  for (const auto& [device, pointer] : pointers_) {
+    dispatched[device] = {pointer.dispatched_x, pointer.dispatched_y,
+                          pointer.dispatched_time_stamp};
+  }
+
+  std::vector<PointerData> events;
+  std::vector<bool> coalesced;
+  // The index in |events| of the move or hover event of each pointer, if its
+  // last event in this frame is one.
+  std::unordered_map<int64_t, size_t> moves;
+  // The pointers with events left for the next frame.
+  std::unordered_set<int64_t> deferred;
+  std::deque<PointerData> remaining;
+
+  for (const PointerData& data : pending_events_) {
+    const int64_t device = data.device;
+    if (deferred.count(device) > 0) {
+      remaining.push_back(data);
+      continue;
+    }
+    if (!IsHeld(data)) {
+      events.push_back(data);
+      coalesced.push_back(false);
+      continue;
+    }
+    if (!IsResampled(data)) {
+      events.push_back(data);
+      coalesced.push_back(false);
+      moves.erase(device);
+      if (data.change == PointerData::Change::kRemove ||
+          data.change == PointerData::Change::kCancel) {
+        pointers_.erase(device);
+      } else {
+        PointerState& pointer = pointers_[device];
+        pointer.last_event = data;
+        pointer.history.clear();
+        pointer.extrapolated = false;
+      }
+      continue;
+    }
+
+    const int64_t time = sample_time(data);
+    if (data.time_stamp > time) {
+      // Dispatch the position at the sample time if it is between the last
+      // event and this one.
+      deferred.insert(device);
+      remaining.push_back(data);
+      auto pointer = pointers_.find(device);
+      if (pointer == pointers_.end() ||
+          pointer->second.last_event.change != data.change ||
+          pointer->second.last_event.time_stamp >= time) {
+        continue;
+      }
+      auto move = moves.find(device);
+      if (move == moves.end()) {
+        events.push_back(pointer->second.last_event);
+        coalesced.push_back(false);
+        move = moves.emplace(device, events.size() - 1).first;
+      }
+      SetPositionAt(pointer->second.last_event, data, time,
+                    events[move->second]);
+      pointer->second.extrapolated = false;
+      continue;
+    }
+
+    PointerState& pointer = pointers_[device];
+    if (pointer.last_event.change != data.change) {
+      pointer.history.clear();
+    }
+    pointer.history.push_back(data);
+    while (pointer.history.size() > 1 &&
+           pointer.history[1].time_stamp <=
+               data.time_stamp - kMinExtrapolationInterval.ToMicroseconds()) {
+      pointer.history.pop_front();
+    }
+    pointer.last_event = data;
+    pointer.extrapolated = false;
+    auto move = moves.find(device);
+    if (move != moves.end()) {
+      coalesced[move->second] = true;
+    }
+    events.push_back(data);
+    coalesced.push_back(false);
+    moves[device] = events.size() - 1;
+  }
+  pending_events_ = std::move(remaining);
+
+  for (auto& [device, pointer] : pointers_) {
+    if (!resample || deferred.count(device) > 0 ||
+        !IsResampled(pointer.last_event)) {
+      continue;
+    }
+    auto move = moves.find(device);
+    if (move == moves.end()) {
+      // Move the pointer back to its last reported position if it was
+      // extrapolated past it in the last frame, at the sample time rather
+      // than at the time of the event, which is before the extrapolation.
+      if (pointer.extrapolated) {
+        PointerData settle = pointer.last_event;
+        settle.time_stamp = sample_time(settle);
+        events.push_back(settle);
+        coalesced.push_back(false);
+        pointer.extrapolated = false;
+      }
+      continue;
+    }
+    const PointerData& last = pointer.last_event;
+    const PointerData& previous = pointer.history.front();
+    const int64_t interval = last.time_stamp - previous.time_stamp;
+    if (interval < kMinExtrapolationInterval.ToMicroseconds()) {
+      continue;
+    }
+    // Extrapolating further than half the interval the velocity is measured
+    // over overshoots when the pointer changes direction.
+    const DeviceKindConfig& device_kind = config_.ForKind(last.kind);
+    const int64_t max_extrapolation =
+        std::min(device_kind.max_extrapolation.ToMicroseconds(), interval / 2);
+    const int64_t time =
+        std::min(sample_time(last), last.time_stamp + max_extrapolation);
+    if (time > last.time_stamp) {
+      SetPositionAt(previous, last, time, events[move->second]);
+      pointer.extrapolated = true;
+    }
+  }
+
+  auto packet = std::make_unique<PointerDataPacket>(
+      std::count(coalesced.begin(), coalesced.end(), false));
+  size_t packet_index = 0;
+  for (size_t i = 0; i < events.size(); i++) {
+    if (coalesced[i]) {
+      continue;
+    }
+    PointerData& data = events[i];
+    if (IsHeld(data)) {
+      auto last = dispatched.find(data.device);
+      if (last != dispatched.end()) {
+        // Events that arrive late may be older than the position the pointer
+        // was extrapolated to. The framework tracks velocities assuming the
+        // timestamps of a pointer never go backwards.
+        data.time_stamp = std::max(data.time_stamp, last->second.time_stamp);
+        if (IsResampled(data)) {
+          data.physical_delta_x = data.physical_x - last->second.x;
+          data.physical_delta_y = data.physical_y - last->second.y;
+        }
+      }
+      dispatched[data.device] = {data.physical_x, data.physical_y,
+                                 data.time_stamp};
+    }
+    packet->SetPointerData(packet_index++, data);
+  }
+  for (auto& [device, pointer] : pointers_) {
+    auto last = dispatched.find(device);
+    if (last != dispatched.end()) {
+      pointer.dispatched_x = last->second.x;
+      pointer.dispatched_y = last->second.y;
+      pointer.dispatched_time_stamp = last->second.time_stamp;
+    }
+  }
+
+  if (packet_index > 0) {
+    // The packets whose events are all coalesced end their flows here, and
+    // the packets of the events moving pointers back after an extrapolation
+    // start a new one.
+    if (pending_trace_flow_ids_.empty()) {
+      pending_trace_flow_ids_.push_back(fml::tracing::TraceNonce());
+      TRACE_FLOW_BEGIN("flutter", "PointerEvent",
+                       pending_trace_flow_ids_.back());
+    }
+    for (size_t i = 0; i + 1 < pending_trace_flow_ids_.size(); i++) {
+      TRACE_FLOW_END("flutter", "PointerEvent", pending_trace_flow_ids_[i]);
+    }
+    uint64_t trace_flow_id = pending_trace_flow_ids_.back();
+    pending_trace_flow_ids_.clear();
+    DefaultPointerDataDispatcher::DispatchPacket(std::move(packet),
+                                                 trace_flow_id);
+  }
+
+  bool has_extrapolated_pointers = false;
+  for (const auto& [device, pointer] : pointers_) {
+    has_extrapolated_pointers |= pointer.extrapolated;
+  }
+  if (!pending_events_.empty() || has_extrapolated_pointers) {
+    ScheduleSecondaryVsyncCallback();
+  }
+}
+
 }  // namespace flutter
@@ -0,0 +1,430 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/pointer_data_dispatcher.h"
+
+#include <cmath>
+#include <cstring>
+#include <map>
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+// The time the simulated traces start at, in microseconds.
+constexpr int64_t kStartTime = 1000000000;
+constexpr int64_t kFrameInterval = 16667;
+
+class FakeDelegate : public PointerDataDispatcher::Delegate {
+ public:
+  void DoDispatchPacket(std::unique_ptr<PointerDataPacket> packet,
+                        uint64_t trace_flow_id) override {
+    const std::vector<uint8_t>& bytes = packet->data();
+    std::vector<PointerData>& events = packets.emplace_back();
+    events.resize(bytes.size() / sizeof(PointerData));
+    memcpy(events.data(), bytes.data(), bytes.size());
+  }
+
+  void ScheduleSecondaryVsyncCallback(uintptr_t id,
+                                      const fml::closure& callback) override {
+    callbacks_[id] = callback;
+  }
+
+  void Vsync() {
+    auto callbacks = std::move(callbacks_);
+    callbacks_.clear();
+    for (const auto& [id, callback] : callbacks) {
+      callback();
+    }
+  }
+
+  std::vector<std::vector<PointerData>> packets;
+
+ private:
+  std::map<uintptr_t, fml::closure> callbacks_;
+};
+
+PointerData CreatePointerData(PointerData::Change change,
+                              PointerData::DeviceKind kind,
+                              int64_t time_stamp,
+                              double x,
+                              double y) {
+  PointerData data;
+  data.Clear();
+  data.time_stamp = time_stamp;
+  data.change = change;
+  data.kind = kind;
+  data.signal_kind = PointerData::SignalKind::kNone;
+  data.physical_x = x;
+  data.physical_y = y;
+  return data;
+}
+
+std::unique_ptr<PointerDataPacket> CreatePacket(
+    const std::vector<PointerData>& events) {
+  auto packet = std::make_unique<PointerDataPacket>(events.size());
+  for (size_t i = 0; i < events.size(); i++) {
+    packet->SetPointerData(i, events[i]);
+  }
+  return packet;
+}
+
+// Replays a trace of packets of events delivered at given times through a
+// dispatcher, with a VSYNC every |kFrameInterval|.
+class TraceReplay {
+ public:
+  explicit TraceReplay(ResamplingPointerDataDispatcher::Config config =
+                           ResamplingPointerDataDispatcher::Config::Default())
+      : dispatcher_(delegate_, config, [this]() {
+          return fml::TimePoint::FromEpochDelta(
+              fml::TimeDelta::FromMicroseconds(now_));
+        }) {}
+
+  // Delivers |events| at |time| in one packet.
+  void Deliver(int64_t time, std::vector<PointerData> events) {
+    deliveries_.emplace(time, std::move(events));
+  }
+
+  // Runs until all the packets are delivered and a few frames after
+  // |end_time| so that the dispatcher catches up.
+  void Run(int64_t end_time) {
+    int64_t vsync_time = kStartTime;
+    while (vsync_time <= end_time + 3 * kFrameInterval ||
+           !deliveries_.empty()) {
+      auto delivery = deliveries_.begin();
+      if (delivery != deliveries_.end() && delivery->first <= vsync_time) {
+        now_ = delivery->first;
+        dispatcher_.DispatchPacket(CreatePacket(delivery->second), 0);
+        deliveries_.erase(delivery);
+        continue;
+      }
+      now_ = vsync_time;
+      vsync_times_.push_back(vsync_time);
+      delegate_.Vsync();
+      vsync_time += kFrameInterval;
+    }
+  }
+
+  const std::vector<std::vector<PointerData>>& packets() const {
+    return delegate_.packets;
+  }
+
+  const std::vector<int64_t>& vsync_times() const { return vsync_times_; }
+
+  // The events of |change| in the dispatched packets.
+  std::vector<PointerData> EventsOf(PointerData::Change change) const {
+    std::vector<PointerData> events;
+    for (const auto& packet : delegate_.packets) {
+      for (const PointerData& data : packet) {
+        if (data.change == change) {
+          events.push_back(data);
+        }
+      }
+    }
+    return events;
+  }
+
+  // Expects the timestamps of the events of each pointer, in the order they
+  // were dispatched, never to decrease.
+  void ExpectTimestampsNeverDecrease() const {
+    std::map<int64_t, int64_t> last_time_stamps;
+    for (const auto& packet : delegate_.packets) {
+      for (const PointerData& data : packet) {
+        auto last = last_time_stamps.find(data.device);
+        if (last != last_time_stamps.end()) {
+          EXPECT_GE(data.time_stamp, last->second)
+              << "for a " << static_cast<int>(data.change) << " event";
+        }
+        last_time_stamps[data.device] = data.time_stamp;
+      }
+    }
+  }
+
+ private:
+  FakeDelegate delegate_;
+  ResamplingPointerDataDispatcher dispatcher_;
+  int64_t now_ = kStartTime;
+  std::multimap<int64_t, std::vector<PointerData>> deliveries_;
+  std::vector<int64_t> vsync_times_;
+};
+
+// A deterministic jitter in [-amplitude, amplitude].
+int64_t Jitter(int i, int64_t amplitude) {
+  return ((i * 7919) % 201 - 100) * amplitude / 100;
+}
+
+// Records a touch drag from |start| to |end| sampled every |interval| with
+// jittered timestamps, delivered in batches of |batch| samples like the
+// platforms do for high rate devices. Returns the position of the finger
+// at a given time.
+std::function<double(int64_t)> RecordDrag(TraceReplay& replay,
+                                          int64_t start,
+                                          int64_t end,
+                                          int64_t interval,
+                                          int batch) {
+  // A finger moving back and forth, 1px/ms at most.
+  auto position = [start](int64_t time) {
+    return 100.0 + 200.0 * std::sin((time - start) / 200000.0);
+  };
+  const auto touch = PointerData::DeviceKind::kTouch;
+  replay.Deliver(start + 1000,
+                 {CreatePointerData(PointerData::Change::kAdd, touch, start,
+                                    position(start), 0),
+                  CreatePointerData(PointerData::Change::kDown, touch, start,
+                                    position(start), 0)});
+  std::vector<PointerData> moves;
+  int i = 1;
+  for (int64_t time = start + interval; time < end; time += interval, i++) {
+    const int64_t time_stamp = time + Jitter(i, interval / 4);
+    moves.push_back(CreatePointerData(PointerData::Change::kMove, touch,
+                                      time_stamp, position(time_stamp), 0));
+    if (i % batch == 0) {
+      replay.Deliver(time + 2000 + Jitter(i, 1000) + 1000, std::move(moves));
+      moves.clear();
+    }
+  }
+  moves.push_back(CreatePointerData(PointerData::Change::kUp, touch, end,
+                                    position(end), 0));
+  moves.push_back(CreatePointerData(PointerData::Change::kRemove, touch, end,
+                                    position(end), 0));
+  replay.Deliver(end + 3000, std::move(moves));
+  return position;
+}
+
+void ExpectResampledDrag(int64_t interval, int batch, int64_t max_lag) {
+  TraceReplay replay;
+  const int64_t end = kStartTime + 1000000;
+  auto position = RecordDrag(replay, kStartTime, end, interval, batch);
+  replay.Run(end);
+
+  // At most one packet per frame, with at most one move each.
+  EXPECT_LE(replay.packets().size(), replay.vsync_times().size());
+  for (const auto& packet : replay.packets()) {
+    int moves = 0;
+    for (const PointerData& data : packet) {
+      moves += data.change == PointerData::Change::kMove;
+    }
+    EXPECT_LE(moves, 1);
+  }
+
+  // The events are dispatched in order, and the moves follow the finger at
+  // most |max_lag| before the sample time of the frame.
+  std::vector<PointerData::Change> changes;
+  for (const auto& packet : replay.packets()) {
+    for (const PointerData& data : packet) {
+      if (changes.empty() || changes.back() != data.change) {
+        changes.push_back(data.change);
+      }
+    }
+  }
+  EXPECT_EQ(changes, std::vector<PointerData::Change>(
+                         {PointerData::Change::kAdd, PointerData::Change::kDown,
+                          PointerData::Change::kMove, PointerData::Change::kUp,
+                          PointerData::Change::kRemove}));
+  replay.ExpectTimestampsNeverDecrease();
+
+  std::vector<PointerData> moves = replay.EventsOf(PointerData::Change::kMove);
+  ASSERT_GT(moves.size(), 55u);
+  double x = position(kStartTime);
+  for (size_t i = 0; i < moves.size(); i++) {
+    const PointerData& move = moves[i];
+    // How long before the sample time of the frame the move is.
+    const int64_t lag =
+        (kFrameInterval - (move.time_stamp - kStartTime + 5000) %
+                              kFrameInterval) %
+        kFrameInterval;
+    // The last move is dispatched with the up event, without resampling.
+    if (i + 1 < moves.size()) {
+      EXPECT_LE(lag, max_lag);
+    }
+    EXPECT_NEAR(move.physical_x, position(move.time_stamp), 0.5);
+    EXPECT_DOUBLE_EQ(move.physical_delta_x, move.physical_x - x);
+    x = move.physical_x;
+  }
+
+  std::vector<PointerData> ups = replay.EventsOf(PointerData::Change::kUp);
+  ASSERT_EQ(ups.size(), 1u);
+  EXPECT_DOUBLE_EQ(ups[0].physical_x, position(end));
+}
+
+}  // namespace
+
+TEST(ResamplingPointerDataDispatcherTest, ResamplesDragAt1kHz) {
+  // The batches of samples may be delivered after the sample time, the
+  // positions are then extrapolated by up to 1ms.
+  ExpectResampledDrag(1000, 4, 2000);
+}
+
+TEST(ResamplingPointerDataDispatcherTest, ResamplesDragAt240Hz) {
+  // The samples are delivered before the sample time, the positions are
+  // always interpolated.
+  ExpectResampledDrag(4167, 1, 0);
+}
+
+TEST(ResamplingPointerDataDispatcherTest, MovesEvenlyAtConstantSpeed) {
+  TraceReplay replay;
+  const auto touch = PointerData::DeviceKind::kTouch;
+  const int64_t end = kStartTime + 500000;
+  replay.Deliver(kStartTime, {CreatePointerData(PointerData::Change::kDown,
+                                                touch, kStartTime, 0, 0)});
+  // 1px/ms at 240Hz, with timestamps jittering by up to a millisecond.
+  int i = 1;
+  for (int64_t time = kStartTime + 4167; time < end; time += 4167, i++) {
+    const int64_t time_stamp = time + Jitter(i, 1000);
+    replay.Deliver(time_stamp + 1500,
+                   {CreatePointerData(PointerData::Change::kMove, touch,
+                                      time_stamp, (time_stamp - kStartTime) /
+                                                      1000.0,
+                                      0)});
+  }
+  replay.Run(end);
+
+  std::vector<PointerData> moves = replay.EventsOf(PointerData::Change::kMove);
+  ASSERT_GT(moves.size(), 25u);
+  // Without resampling, the distance moved per frame would vary by up to
+  // 6ms worth of movement.
+  for (size_t i = 1; moves[i].time_stamp < end - kFrameInterval; i++) {
+    EXPECT_NEAR(moves[i].physical_delta_x, kFrameInterval / 1000.0, 0.01);
+  }
+}
+
+TEST(ResamplingPointerDataDispatcherTest, CoalescesMouseHovers) {
+  TraceReplay replay;
+  const auto mouse = PointerData::DeviceKind::kMouse;
+  replay.Deliver(kStartTime, {CreatePointerData(PointerData::Change::kAdd,
+                                                mouse, kStartTime, 0, 0)});
+  const int64_t end = kStartTime + 100000;
+  for (int64_t time = kStartTime + 1000; time < end; time += 1000) {
+    replay.Deliver(time, {CreatePointerData(PointerData::Change::kHover, mouse,
+                                            time, time - kStartTime, 0)});
+  }
+  replay.Run(end);
+
+  std::vector<PointerData> hovers =
+      replay.EventsOf(PointerData::Change::kHover);
+  ASSERT_EQ(hovers.size(),
+            static_cast<size_t>((end - kStartTime) / kFrameInterval + 1));
+  double x = 0;
+  for (size_t i = 0; i < hovers.size(); i++) {
+    // Mouse events are not delayed, the last hover before the VSYNC is
+    // dispatched.
+    const int64_t vsync_time = replay.vsync_times()[i + 1];
+    const int64_t last_time = vsync_time - (vsync_time - kStartTime) % 1000;
+    EXPECT_EQ(hovers[i].time_stamp, std::min(last_time, end - 1000));
+    EXPECT_DOUBLE_EQ(hovers[i].physical_delta_x, hovers[i].physical_x - x);
+    x = hovers[i].physical_x;
+  }
+}
+
+TEST(ResamplingPointerDataDispatcherTest, ExtrapolatesAndSettles) {
+  TraceReplay replay;
+  const auto touch = PointerData::DeviceKind::kTouch;
+  replay.Deliver(kStartTime, {CreatePointerData(PointerData::Change::kDown,
+                                                touch, kStartTime, 0, 0)});
+  // Moves at 1px/ms every 4ms, the last one more than 2ms before the sample
+  // time of the next VSYNC.
+  const int64_t last_time = kStartTime + 24000;
+  ASSERT_GT(kStartTime + 2 * kFrameInterval - 5000, last_time + 2000);
+  for (int64_t time = kStartTime + 4000; time <= last_time; time += 4000) {
+    replay.Deliver(time, {CreatePointerData(PointerData::Change::kMove, touch,
+                                            time, (time - kStartTime) / 1000.0,
+                                            0)});
+  }
+  replay.Run(last_time);
+
+  std::vector<PointerData> moves = replay.EventsOf(PointerData::Change::kMove);
+  ASSERT_GE(moves.size(), 2u);
+  // Extrapolated by half the interval the velocity is measured over.
+  const PointerData& extrapolated = moves[moves.size() - 2];
+  EXPECT_EQ(extrapolated.time_stamp, last_time + 2000);
+  EXPECT_DOUBLE_EQ(extrapolated.physical_x, 26);
+  // Then moved back to the last position once no more moves arrived, at the
+  // sample time of the next VSYNC rather than back in time.
+  const PointerData& settled = moves.back();
+  EXPECT_EQ(settled.time_stamp, kStartTime + 3 * kFrameInterval - 5000);
+  EXPECT_DOUBLE_EQ(settled.physical_x, 24);
+  EXPECT_DOUBLE_EQ(settled.physical_delta_x, -2);
+  replay.ExpectTimestampsNeverDecrease();
+}
+
+TEST(ResamplingPointerDataDispatcherTest, CoalescesEventsOnAnotherClock) {
+  TraceReplay replay;
+  const auto touch = PointerData::DeviceKind::kTouch;
+  // Timestamps starting at 0 rather than near the current time.
+  replay.Deliver(kStartTime,
+                 {CreatePointerData(PointerData::Change::kDown, touch, 0, 0, 0),
+                  CreatePointerData(PointerData::Change::kMove, touch, 1000,
+                                    1, 0),
+                  CreatePointerData(PointerData::Change::kMove, touch, 2000,
+                                    2, 0),
+                  CreatePointerData(PointerData::Change::kMove, touch, 3000,
+                                    3, 0)});
+  replay.Run(kStartTime);
+
+  ASSERT_EQ(replay.packets().size(), 1u);
+  const std::vector<PointerData>& packet = replay.packets()[0];
+  ASSERT_EQ(packet.size(), 2u);
+  EXPECT_EQ(packet[1].time_stamp, 3000);
+  EXPECT_DOUBLE_EQ(packet[1].physical_x, 3);
+  EXPECT_DOUBLE_EQ(packet[1].physical_delta_x, 3);
+}
+
+TEST(ResamplingPointerDataDispatcherTest, DispatchesDisabledKindsRightAway) {
+  ResamplingPointerDataDispatcher::Config config =
+      ResamplingPointerDataDispatcher::Config::Default();
+  config.device_kinds[static_cast<size_t>(PointerData::DeviceKind::kMouse)]
+      .enabled = false;
+  FakeDelegate delegate;
+  ResamplingPointerDataDispatcher dispatcher(delegate, config);
+  const auto mouse = PointerData::DeviceKind::kMouse;
+  for (int i = 0; i < 3; i++) {
+    dispatcher.DispatchPacket(
+        CreatePacket({CreatePointerData(PointerData::Change::kHover, mouse,
+                                        kStartTime + i, i, 0)}),
+        0);
+  }
+  EXPECT_EQ(delegate.packets.size(), 3u);
+}
+
+TEST(ResamplingPointerDataDispatcherTest, DispatchesUnknownKindsRightAway) {
+  FakeDelegate delegate;
+  ResamplingPointerDataDispatcher dispatcher(delegate);
+  // The kind Android reports for pointers of an unknown type.
+  const auto unknown = static_cast<PointerData::DeviceKind>(4);
+  for (int i = 0; i < 3; i++) {
+    dispatcher.DispatchPacket(
+        CreatePacket({CreatePointerData(PointerData::Change::kHover, unknown,
+                                        kStartTime + i, i, 0)}),
+        0);
+  }
+  ASSERT_EQ(delegate.packets.size(), 3u);
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ(delegate.packets[i].size(), 1u);
+    EXPECT_EQ(delegate.packets[i][0].kind, unknown);
+    EXPECT_DOUBLE_EQ(delegate.packets[i][0].physical_x, i);
+  }
+
+  // Pending events keep their order with the events of unknown kinds.
+  const auto touch = PointerData::DeviceKind::kTouch;
+  dispatcher.DispatchPacket(
+      CreatePacket({CreatePointerData(PointerData::Change::kDown, touch,
+                                      kStartTime + 3, 0, 0)}),
+      0);
+  dispatcher.DispatchPacket(
+      CreatePacket({CreatePointerData(PointerData::Change::kHover, unknown,
+                                      kStartTime + 4, 4, 0)}),
+      0);
+  EXPECT_EQ(delegate.packets.size(), 3u);
+  delegate.Vsync();
+  ASSERT_EQ(delegate.packets.size(), 4u);
+  ASSERT_EQ(delegate.packets[3].size(), 2u);
+  EXPECT_EQ(delegate.packets[3][0].kind, touch);
+  EXPECT_EQ(delegate.packets[3][1].kind, unknown);
+}
+
+}  // namespace testing
+}  // namespace flutter
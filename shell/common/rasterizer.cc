@@ -8,6 +8,7 @@
 #include <utility>
 
 #include "flutter/common/graphics/persistent_cache.h"
+#include "flutter/flow/diff_context.h"
 #include "flutter/fml/time/time_delta.h"
 #include "flutter/fml/time/time_point.h"
 #include "flutter/shell/common/serialization_callbacks.h"
@@ -40,7 +41,9 @@ static constexpr std::chrono::milliseconds kSkiaCleanupExpiration(15000);
 Rasterizer::Rasterizer(Delegate& delegate)
     : delegate_(delegate),
       compositor_context_(std::make_unique<flutter::CompositorContext>(
-          delegate.GetFrameBudget())),
+          delegate.GetFrameBudget(),
+          delegate.GetSettings().raster_cache_max_bytes,
+          delegate.GetSettings().raster_cache_max_unused_frames)),
       user_override_resource_cache_bytes_(false),
       weak_factory_(this) {
   FML_DCHECK(compositor_context_);
@@ -478,7 +481,9 @@ RasterStatus Rasterizer::DrawToSurface(flutter::LayerTree& layer_tree) {
   );
 
   if (compositor_frame) {
-    RasterStatus raster_status = compositor_frame->Raster(layer_tree, false);
+    std::optional<SkIRect> clip_rect = ComputeFrameDamage(layer_tree, *frame);
+    RasterStatus raster_status = compositor_frame->Raster(
+        layer_tree, false, clip_rect ? &clip_rect.value() : nullptr);
     if (raster_status == RasterStatus::kFailed ||
         raster_status == RasterStatus::kSkipAndRetry) {
       return raster_status;
@@ -517,6 +522,60 @@ RasterStatus Rasterizer::DrawToSurface(flutter::LayerTree& layer_tree) {
   return RasterStatus::kFailed;
 }
 
+std::optional<SkIRect> Rasterizer::ComputeFrameDamage(
+    flutter::LayerTree& layer_tree,
+    SurfaceFrame& frame) {
+#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
+  // Platform views are composited by the embedder, which has no notion of
+  // damage. Redrawing the last layer tree must repaint everything since the
+  // tree cannot be diffed against itself.
+  if (!frame.framebuffer_info().supports_partial_repaint ||
+      external_view_embedder_ || &layer_tree == last_layer_tree_.get() ||
+      !layer_tree.root_layer()) {
+    return std::nullopt;
+  }
+
+  TRACE_EVENT0("flutter", "Rasterizer::ComputeFrameDamage");
+
+  // A tree that was rasterized without diffing has no paint regions (the root
+  // layer always records one), so changes to it cannot be tracked.
+  const flutter::LayerTree* last_layer_tree = last_layer_tree_.get();
+  if (last_layer_tree &&
+      (last_layer_tree->frame_size() != layer_tree.frame_size() ||
+       last_layer_tree->paint_region_map().empty())) {
+    last_layer_tree = nullptr;
+  }
+
+  const PaintRegionMap empty_paint_region_map;
+  DiffContext context(layer_tree.frame_size(), layer_tree.device_pixel_ratio(),
+                      layer_tree.paint_region_map(),
+                      last_layer_tree ? last_layer_tree->paint_region_map()
+                                      : empty_paint_region_map);
+  context.PushCullRect(SkRect::Make(layer_tree.frame_size()));
+  {
+    DiffContext::AutoSubtreeRestore subtree(&context);
+    if (!last_layer_tree) {
+      context.MarkSubtreeDirty();
+    }
+    layer_tree.root_layer()->Diff(
+        &context, last_layer_tree ? last_layer_tree->root_layer() : nullptr);
+  }
+  context.statistics().LogStatistics();
+
+  const auto& existing_damage = frame.framebuffer_info().existing_damage;
+  if (!last_layer_tree || !existing_damage) {
+    frame.set_submit_info({SkIRect::MakeSize(layer_tree.frame_size())});
+    return std::nullopt;
+  }
+
+  Damage damage = context.ComputeDamage(existing_damage.value());
+  frame.set_submit_info({damage.frame_damage});
+  return damage.buffer_damage;
+#else
+  return std::nullopt;
+#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
+}
+
 static sk_sp<SkData> ScreenshotLayerTreeAsPicture(
     flutter::LayerTree* tree,
     flutter::CompositorContext& compositor_context) {
@@ -533,7 +592,7 @@ static sk_sp<SkData> ScreenshotLayerTreeAsPicture(
   auto frame = compositor_context.ACQUIRE_FRAME(
       nullptr, recorder.getRecordingCanvas(), nullptr,
       root_surface_transformation, false, true, nullptr);
-  frame->Raster(*tree, true);
+  frame->Raster(*tree, true, nullptr);
 
 #if defined(OS_FUCHSIA)
   SkSerialProcs procs = {0};
@@ -601,7 +660,7 @@ sk_sp<SkData> Rasterizer::ScreenshotLayerTreeAsImage(
       surface_context, canvas, nullptr, root_surface_transformation, false,
       true, nullptr);
   canvas->clear(SK_ColorTRANSPARENT);
-  frame->Raster(*tree, true);
+  frame->Raster(*tree, true, nullptr);
   canvas->flush();
 
   // Prepare an image from the surface, this image may potentially be on th GPU.
@@ -75,6 +75,9 @@ class Rasterizer final : public SnapshotDelegate {
     /// See: `DisplayManager::GetMainDisplayRefreshRate`.
     virtual fml::Milliseconds GetFrameBudget() = 0;
 
+    /// The settings the shell was created with.
+    virtual const Settings& GetSettings() const = 0;
+
     /// Target time for the latest frame. See also `Shell::OnAnimatorBeginFrame`
     /// for when this time gets updated.
     virtual fml::TimePoint GetLatestFrameTargetTime() const = 0;
@@ -482,6 +485,17 @@ class Rasterizer final : public SnapshotDelegate {
 
   RasterStatus DrawToSurface(flutter::LayerTree& layer_tree);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Diffs the layer tree against the last rasterized layer tree
+  ///             if the frame supports partial repaint, and records the
+  ///             resulting frame damage in the submit info of the frame.
+  ///
+  /// @return     The region of the frame that must be repainted, or
+  ///             `std::nullopt` if the whole frame must be repainted.
+  ///
+  std::optional<SkIRect> ComputeFrameDamage(flutter::LayerTree& layer_tree,
+                                            SurfaceFrame& frame);
+
   void FireNextFrameCallbackIfPresent();
 
   static bool NoDiscard(const flutter::LayerTree& layer_tree) { return false; }
@@ -6,6 +6,7 @@
 
 #include "flutter/shell/common/rasterizer.h"
 
+#include "flutter/flow/layers/container_layer.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/testing/testing.h"
 #include "gmock/gmock.h"
@@ -19,12 +20,19 @@ namespace flutter {
 namespace {
 class MockDelegate : public Rasterizer::Delegate {
  public:
+  MockDelegate() {
+    ON_CALL(*this, GetSettings()).WillByDefault(ReturnRef(settings_));
+  }
+
   MOCK_METHOD1(OnFrameRasterized, void(const FrameTiming& frame_timing));
   MOCK_METHOD0(GetFrameBudget, fml::Milliseconds());
+  MOCK_CONST_METHOD0(GetSettings, const Settings&());
   MOCK_CONST_METHOD0(GetLatestFrameTargetTime, fml::TimePoint());
   MOCK_CONST_METHOD0(GetTaskRunners, const TaskRunners&());
   MOCK_CONST_METHOD0(GetIsGpuDisabledSyncSwitch,
                      std::shared_ptr<const fml::SyncSwitch>());
+
+  Settings settings_;
 };
 
 class MockSurface : public Surface {
@@ -73,6 +81,20 @@ TEST(RasterizerTest, create) {
   EXPECT_TRUE(rasterizer != nullptr);
 }
 
+TEST(RasterizerTest, createsRasterCacheFromSettings) {
+  Settings settings;
+  settings.raster_cache_max_bytes = 16 * 1024 * 1024;
+  settings.raster_cache_max_unused_frames = 5;
+  MockDelegate delegate;
+  EXPECT_CALL(delegate, GetSettings()).WillRepeatedly(ReturnRef(settings));
+  auto rasterizer = std::make_unique<Rasterizer>(delegate);
+
+  const RasterCache& raster_cache =
+      rasterizer->compositor_context()->raster_cache();
+  EXPECT_EQ(raster_cache.max_cache_bytes(), 16u * 1024 * 1024);
+  EXPECT_EQ(raster_cache.max_unused_frames(), 5u);
+}
+
 TEST(RasterizerTest, drawEmptyPipeline) {
   std::string test_name =
       ::testing::UnitTest::GetInstance()->current_test_info()->name();
@@ -299,4 +321,68 @@ TEST(RasterizerTest, externalViewEmbedderDoesntEndFrameWhenNoSurfaceIsSet) {
   });
   latch.Wait();
 }
+
+#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
+TEST(RasterizerTest, drawWithPartialRepaintSubmitsFrameDamage) {
+  std::string test_name =
+      ::testing::UnitTest::GetInstance()->current_test_info()->name();
+  ThreadHost thread_host("io.flutter.test." + test_name + ".",
+                         ThreadHost::Type::Platform | ThreadHost::Type::RASTER |
+                             ThreadHost::Type::IO | ThreadHost::Type::UI);
+  TaskRunners task_runners("test", thread_host.platform_thread->GetTaskRunner(),
+                           thread_host.raster_thread->GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+  MockDelegate delegate;
+  EXPECT_CALL(delegate, GetTaskRunners())
+      .WillRepeatedly(ReturnRef(task_runners));
+  EXPECT_CALL(delegate, OnFrameRasterized(_)).Times(2);
+  auto rasterizer = std::make_unique<Rasterizer>(delegate);
+  auto surface = std::make_unique<MockSurface>();
+
+  const SkISize frame_size = SkISize::Make(100, 100);
+  std::vector<std::optional<SkIRect>> submitted_damage;
+  auto make_surface_frame = [&]() {
+    auto surface_frame = std::make_unique<SurfaceFrame>(
+        /*surface=*/SkSurface::MakeRasterN32Premul(100, 100),
+        /*supports_readback=*/true,
+        /*submit_callback=*/[&](const SurfaceFrame& frame, SkCanvas*) {
+          submitted_damage.push_back(frame.submit_info().frame_damage);
+          return true;
+        });
+    SurfaceFrame::FramebufferInfo framebuffer_info;
+    framebuffer_info.supports_partial_repaint = true;
+    framebuffer_info.existing_damage = SkIRect::MakeEmpty();
+    surface_frame->set_framebuffer_info(framebuffer_info);
+    return surface_frame;
+  };
+  EXPECT_CALL(*surface, AcquireFrame(frame_size))
+      .WillOnce(Return(ByMove(make_surface_frame())))
+      .WillOnce(Return(ByMove(make_surface_frame())));
+
+  rasterizer->Setup(std::move(surface));
+  fml::AutoResetWaitableEvent latch;
+  thread_host.raster_thread->GetTaskRunner()->PostTask([&] {
+    auto no_discard = [](LayerTree&) { return false; };
+    for (int i = 0; i < 2; i++) {
+      auto pipeline = fml::AdoptRef(new Pipeline<LayerTree>(/*depth=*/10));
+      auto layer_tree = std::make_unique<LayerTree>(
+          frame_size, /*device_pixel_ratio=*/1.0f);
+      layer_tree->set_root_layer(std::make_shared<ContainerLayer>());
+      bool result = pipeline->Produce().Complete(std::move(layer_tree));
+      EXPECT_TRUE(result);
+      rasterizer->Draw(pipeline, no_discard);
+    }
+    latch.Signal();
+  });
+  latch.Wait();
+
+  // The first frame has nothing to be diffed against and is fully repainted.
+  // The second frame is identical to the first one.
+  ASSERT_EQ(submitted_damage.size(), 2u);
+  EXPECT_EQ(submitted_damage[0], SkIRect::MakeSize(frame_size));
+  EXPECT_EQ(submitted_damage[1], SkIRect::MakeEmpty());
+}
+#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
+
 }  // namespace flutter
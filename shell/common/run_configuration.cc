@@ -7,6 +7,7 @@
 #include <sstream>
 
 #include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/assets/packed_asset_bundle.h"
 #include "flutter/common/graphics/persistent_cache.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/unique_fd.h"
@@ -24,10 +25,26 @@ RunConfiguration RunConfiguration::InferFromSettings(
         fml::Duplicate(settings.assets_dir), true));
   }
 
-  asset_manager->PushBack(std::make_unique<DirectoryAssetBundle>(
-      fml::OpenDirectory(settings.assets_path.c_str(), false,
-                         fml::FilePermission::kRead),
-      true));
+  fml::UniqueFD assets_path = fml::OpenDirectory(
+      settings.assets_path.c_str(), false, fml::FilePermission::kRead);
+  // Prefer the packed archive of the assets if the application has one. The
+  // archive holds all the assets, so the directory is not searched as well.
+  if (assets_path.is_valid() &&
+      fml::FileExists(assets_path, PackedAssetBundle::kArchiveFileName)) {
+    auto packed_asset_bundle = std::make_unique<PackedAssetBundle>(
+        fml::FileMapping::CreateReadOnly(assets_path,
+                                         PackedAssetBundle::kArchiveFileName),
+        true);
+    if (packed_asset_bundle->IsValid()) {
+      asset_manager->PushBack(std::move(packed_asset_bundle));
+      assets_path.reset();
+    }
+  }
+
+  if (assets_path.is_valid()) {
+    asset_manager->PushBack(
+        std::make_unique<DirectoryAssetBundle>(std::move(assets_path), true));
+  }
 
   return {IsolateConfiguration::InferFromSettings(settings, asset_manager,
                                                   io_worker),
@@ -11,6 +11,7 @@
 
 #include "flutter/assets/directory_asset_bundle.h"
 #include "flutter/common/graphics/persistent_cache.h"
+#include "flutter/flow/persistent_raster_cache.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/icu_util.h"
 #include "flutter/fml/log_settings.h"
@@ -19,6 +20,7 @@
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/paths.h"
 #include "flutter/fml/trace_event.h"
+#include "flutter/fml/trace_recorder.h"
 #include "flutter/fml/unique_fd.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/shell/common/engine.h"
@@ -78,6 +80,11 @@ void Tokenize(const std::string& input,
   }
 }
 
+// Guards |gTraceToFileShellCount| and starting and stopping the recording.
+std::mutex gTraceToFileMutex;
+// The number of live shells that record a trace to a file.
+size_t gTraceToFileShellCount = 0;
+
 // Though there can be multiple shells, some settings apply to all components in
 // the process. These have to be set up before the shell or any of its
 // sub-components can be initialized. In a perfect world, this would be empty.
@@ -92,6 +99,15 @@ void PerformInitializationTasks(Settings& settings) {
     fml::SetLogSettings(log_settings);
   }
 
+  // The recording stops when the last shell that records a trace to a file is
+  // destroyed, and starts again with the next one.
+  if (!settings.trace_to_file.empty()) {
+    std::scoped_lock lock(gTraceToFileMutex);
+    if (!fml::tracing::TraceRecorder::IsRecording()) {
+      fml::tracing::TraceRecorder::Start(settings.trace_to_file);
+    }
+  }
+
   static std::once_flag gShellSettingsInitialization = {};
   std::call_once(gShellSettingsInitialization, [&settings] {
     if (settings.engine_start_timestamp.count() == 0) {
@@ -130,6 +146,7 @@ void PerformInitializationTasks(Settings& settings) {
   });
 
   PersistentCache::SetCacheSkSL(settings.cache_sksl);
+  PersistentCache::SetUseShaderCacheFile(settings.enable_shader_cache_file);
 }
 
 }  // namespace
@@ -260,6 +277,11 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
   // Send dispatcher_maker to the engine constructor because shell won't have
   // platform_view set until Shell::Setup is called later.
   auto dispatcher_maker = platform_view->GetDispatcherMaker();
+  if (shell->GetSettings().enable_pointer_resampling) {
+    dispatcher_maker = [](PointerDataDispatcher::Delegate& delegate) {
+      return std::make_unique<ResamplingPointerDataDispatcher>(delegate);
+    };
+  }
 
   // Create the engine on the UI thread.
   std::promise<std::unique_ptr<Engine>> engine_promise;
@@ -281,8 +303,14 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
 
         // The animator is owned by the UI thread but it gets its vsync pulses
         // from the platform.
-        auto animator = std::make_unique<Animator>(*shell, task_runners,
-                                                   std::move(vsync_waiter));
+        auto animator = std::make_unique<Animator>(
+            *shell, task_runners, std::move(vsync_waiter),
+            shell->GetSettings().enable_mailbox_pipeline
+                ? PipelineMode::Mailbox
+                : PipelineMode::Queue,
+            shell->GetSettings().enable_latency_aware_frame_scheduling
+                ? FrameSchedulingMode::LatencyAware
+                : FrameSchedulingMode::Immediate);
 
         engine_promise.set_value(
             on_create_engine(*shell,                          //
@@ -378,6 +406,11 @@ Shell::Shell(DartVMRef vm,
   FML_DCHECK(task_runners_.IsValid());
   FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
 
+  if (!settings_.trace_to_file.empty()) {
+    std::scoped_lock lock(gTraceToFileMutex);
+    gTraceToFileShellCount++;
+  }
+
   display_manager_ = std::make_unique<DisplayManager>();
 
   // Generate a WeakPtrFactory for use with the raster thread. This does not
@@ -480,6 +513,15 @@ Shell::~Shell() {
         platform_latch.Signal();
       }));
   platform_latch.Wait();
+
+  if (!settings_.trace_to_file.empty()) {
+    // Write out the remaining events and close the trace once no shell
+    // records into it anymore, so that the file is valid JSON.
+    std::scoped_lock lock(gTraceToFileMutex);
+    if (--gTraceToFileShellCount == 0) {
+      fml::tracing::TraceRecorder::Stop();
+    }
+  }
 }
 
 std::unique_ptr<Shell> Shell::Spawn(
@@ -673,6 +715,42 @@ bool Shell::Setup(std::unique_ptr<PlatformView> platform_view,
     PersistentCache::GetCacheForProcess()->Purge();
   }
 
+  // Loaded after the default font manager is set up, which it is validated
+  // against.
+  fml::TaskRunner::RunNowOrPostTask(
+      task_runners_.GetUITaskRunner(),
+      fml::MakeCopyable(
+          [engine = weak_engine_,
+           directory = PersistentCache::GetCacheForProcess()->OpenSubdirectory(
+               PersistentCache::kFontSubdirName),
+           io_task_runner = PersistentCache::gIsReadOnly
+                                ? fml::RefPtr<fml::TaskRunner>()
+                                : task_runners_.GetIOTaskRunner()]() mutable {
+            if (engine) {
+              engine->GetFontCollection().LoadFallbackFontIndex(
+                  std::move(directory), std::move(io_task_runner));
+            }
+          }));
+
+  if (settings_.enable_persistent_raster_cache) {
+    auto persistent_raster_cache = PersistentRasterCache::Create(
+        PersistentCache::GetCacheForProcess()->OpenSubdirectory(
+            PersistentCache::kRasterCacheSubdirName),
+        task_runners_.GetIOTaskRunner());
+    if (persistent_raster_cache) {
+      persistent_raster_cache->LoadAsync();
+      fml::TaskRunner::RunNowOrPostTask(
+          task_runners_.GetRasterTaskRunner(),
+          [rasterizer = weak_rasterizer_, persistent_raster_cache]() {
+            if (rasterizer) {
+              rasterizer->compositor_context()
+                  ->raster_cache()
+                  .SetPersistentCache(persistent_raster_cache);
+            }
+          });
+    }
+  }
+
   return true;
 }
 
@@ -1224,7 +1302,8 @@ void Shell::HandleEngineSkiaMessage(fml::RefPtr<PlatformMessage> message) {
   const auto& data = message->data();
 
   rapidjson::Document document;
-  document.Parse(reinterpret_cast<const char*>(data.data()), data.size());
+  document.Parse(reinterpret_cast<const char*>(data.GetMapping()),
+                 data.GetSize());
   if (document.HasParseError() || !document.IsObject())
     return;
   auto root = document.GetObject();
@@ -1367,6 +1446,15 @@ void Shell::OnFrameRasterized(const FrameTiming& timing) {
     settings_.frame_rasterized_callback(timing);
   }
 
+  if (settings_.enable_latency_aware_frame_scheduling) {
+    task_runners_.GetUITaskRunner()->PostTask(
+        [timing, engine = weak_engine_] {
+          if (engine) {
+            engine->ReportFrameTiming(timing);
+          }
+        });
+  }
+
   if (!needs_report_timings_) {
     return;
   }
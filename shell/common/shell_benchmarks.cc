@@ -5,43 +5,71 @@
 #include "flutter/shell/common/shell.h"
 
 #include "flutter/benchmarking/benchmarking.h"
+#include "flutter/common/graphics/persistent_cache.h"
+#include "flutter/flow/compositor_context.h"
+#include "flutter/flow/diff_context.h"
+#include "flutter/flow/display_list.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/layer_arena.h"
+#include "flutter/flow/layers/layer_tree.h"
+#include "flutter/flow/layers/picture_layer.h"
+#include "flutter/flow/layers/texture_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "flutter/flow/rtree.h"
+#include "flutter/fml/file.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/thread.h"
 #include "flutter/runtime/dart_vm.h"
+#include "flutter/shell/common/pointer_data_dispatcher.h"
+#include "flutter/shell/common/shell_pool.h"
 #include "flutter/shell/common/thread_host.h"
+#include "flutter/shell/gpu/gpu_surface_software.h"
 #include "flutter/testing/elf_loader.h"
 #include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkBBHFactory.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkSurface.h"
 
 namespace flutter {
 
+// Settings that load the shell test fixtures. The symbols of the AOT
+// snapshot, if any, are loaded into |aot_symbols| which must outlive the
+// shells using the settings.
+static Settings CreateSettingsForFixture(testing::ELFAOTSymbols& aot_symbols) {
+  Settings settings = {};
+  settings.task_observer_add = [](intptr_t, fml::closure) {};
+  settings.task_observer_remove = [](intptr_t) {};
+
+  if (DartVM::IsRunningPrecompiledCode()) {
+    aot_symbols = testing::LoadELFSymbolFromFixturesIfNeccessary(
+        testing::kDefaultAOTAppELFFileName);
+    FML_CHECK(testing::PrepareSettingsForAOTWithSymbols(settings, aot_symbols))
+        << "Could not set up settings with AOT symbols.";
+  } else {
+    settings.application_kernels = []() {
+      auto assets_dir = fml::OpenDirectory(testing::GetFixturesPath(), false,
+                                           fml::FilePermission::kRead);
+      std::vector<std::unique_ptr<const fml::Mapping>> kernel_mappings;
+      kernel_mappings.emplace_back(
+          fml::FileMapping::CreateReadOnly(assets_dir, "kernel_blob.bin"));
+      return kernel_mappings;
+    };
+  }
+  return settings;
+}
+
 static void StartupAndShutdownShell(benchmark::State& state,
                                     bool measure_startup,
                                     bool measure_shutdown) {
-  auto assets_dir = fml::OpenDirectory(testing::GetFixturesPath(), false,
-                                       fml::FilePermission::kRead);
   std::unique_ptr<Shell> shell;
   std::unique_ptr<ThreadHost> thread_host;
   testing::ELFAOTSymbols aot_symbols;
 
   {
     benchmarking::ScopedPauseTiming pause(state, !measure_startup);
-    Settings settings = {};
-    settings.task_observer_add = [](intptr_t, fml::closure) {};
-    settings.task_observer_remove = [](intptr_t) {};
-
-    if (DartVM::IsRunningPrecompiledCode()) {
-      aot_symbols = testing::LoadELFSymbolFromFixturesIfNeccessary(
-          testing::kDefaultAOTAppELFFileName);
-      FML_CHECK(
-          testing::PrepareSettingsForAOTWithSymbols(settings, aot_symbols))
-          << "Could not set up settings with AOT symbols.";
-    } else {
-      settings.application_kernels = [&]() {
-        std::vector<std::unique_ptr<const fml::Mapping>> kernel_mappings;
-        kernel_mappings.emplace_back(
-            fml::FileMapping::CreateReadOnly(assets_dir, "kernel_blob.bin"));
-        return kernel_mappings;
-      };
-    }
+    Settings settings = CreateSettingsForFixture(aot_symbols);
 
     thread_host = std::make_unique<ThreadHost>(
         "io.flutter.bench.", ThreadHost::Type::Platform |
@@ -120,4 +148,669 @@ static void BM_ShellInitializationAndShutdown(benchmark::State& state) {
 
 BENCHMARK(BM_ShellInitializationAndShutdown);
 
+static void FlushTaskRunner(const fml::RefPtr<fml::TaskRunner>& task_runner) {
+  fml::AutoResetWaitableEvent latch;
+  task_runner->PostTask([&latch]() { latch.Signal(); });
+  latch.Wait();
+}
+
+// A platform view that signals |first_frame_latch| when the
+// |drawFirstFrameWhenSized| entrypoint reports its first frame.
+class FirstFramePlatformView : public PlatformView {
+ public:
+  FirstFramePlatformView(Shell& shell,
+                         fml::AutoResetWaitableEvent& first_frame_latch)
+      : PlatformView(shell, shell.GetTaskRunners()),
+        first_frame_latch_(first_frame_latch) {}
+
+  // |PlatformView|
+  void HandlePlatformMessage(fml::RefPtr<PlatformMessage> message) override {
+    if (message->channel() == "flutter/firstframe") {
+      first_frame_latch_.Signal();
+      return;
+    }
+    PlatformView::HandlePlatformMessage(std::move(message));
+  }
+
+ private:
+  fml::AutoResetWaitableEvent& first_frame_latch_;
+};
+
+// Measures the time from asking for the shell of a new view to the first
+// frame of that view, with the shell either taken from a |ShellPool| or
+// spawned on demand.
+static void FirstFrameOfSpawnedShell(benchmark::State& state, bool pooled) {
+  testing::ELFAOTSymbols aot_symbols;
+  Settings settings = CreateSettingsForFixture(aot_symbols);
+  ThreadHost thread_host("io.flutter.bench.", ThreadHost::Type::Platform |
+                                                  ThreadHost::Type::RASTER |
+                                                  ThreadHost::Type::IO |
+                                                  ThreadHost::Type::UI);
+  TaskRunners task_runners("test", thread_host.platform_thread->GetTaskRunner(),
+                           thread_host.raster_thread->GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+  auto platform_task_runner = task_runners.GetPlatformTaskRunner();
+
+  fml::AutoResetWaitableEvent first_frame_latch;
+  auto on_create_platform_view = [&first_frame_latch](Shell& shell) {
+    return std::make_unique<FirstFramePlatformView>(shell, first_frame_latch);
+  };
+  auto on_create_rasterizer = [](Shell& shell) {
+    return std::make_unique<Rasterizer>(shell);
+  };
+  auto create_run_configuration = [&settings]() {
+    auto configuration = RunConfiguration::InferFromSettings(settings);
+    configuration.SetEntrypoint("drawFirstFrameWhenSized");
+    return configuration;
+  };
+
+  std::unique_ptr<Shell> spawner = Shell::Create(
+      flutter::PlatformData(), task_runners, settings, on_create_platform_view,
+      on_create_rasterizer);
+  FML_CHECK(spawner);
+  spawner->RunEngine(create_run_configuration());
+
+  std::unique_ptr<ShellPool> pool;
+  fml::AutoResetWaitableEvent latch;
+  platform_task_runner->PostTask([&]() {
+    if (pooled) {
+      pool = std::make_unique<ShellPool>(*spawner, 1, create_run_configuration,
+                                         on_create_platform_view,
+                                         on_create_rasterizer);
+      pool->Fill();
+    }
+    latch.Signal();
+  });
+  latch.Wait();
+
+  ViewportMetrics metrics;
+  metrics.device_pixel_ratio = 2.0;
+  metrics.physical_width = 1080;
+  metrics.physical_height = 1920;
+
+  std::unique_ptr<Shell> shell;
+  while (state.KeepRunning()) {
+    platform_task_runner->PostTask([&]() {
+      shell = pooled ? pool->Take()
+                     : spawner->Spawn(create_run_configuration(),
+                                      on_create_platform_view,
+                                      on_create_rasterizer);
+      FML_CHECK(shell);
+      shell->GetPlatformView()->SetViewportMetrics(metrics);
+    });
+    first_frame_latch.Wait();
+
+    benchmarking::ScopedPauseTiming pause(state, true);
+    platform_task_runner->PostTask([&]() {
+      shell.reset();
+      latch.Signal();
+    });
+    latch.Wait();
+    // Lets the pool spawn the replacement of the shell.
+    FlushTaskRunner(platform_task_runner);
+  }
+
+  platform_task_runner->PostTask([&]() {
+    pool.reset();
+    spawner.reset();
+    latch.Signal();
+  });
+  latch.Wait();
+}
+
+static void BM_FirstFrameOfSpawnedShell(benchmark::State& state) {
+  FirstFrameOfSpawnedShell(state, false);
+}
+
+BENCHMARK(BM_FirstFrameOfSpawnedShell)->Unit(benchmark::kMillisecond);
+
+static void BM_FirstFrameOfPooledShell(benchmark::State& state) {
+  FirstFrameOfSpawnedShell(state, true);
+}
+
+BENCHMARK(BM_FirstFrameOfPooledShell)->Unit(benchmark::kMillisecond);
+
+// Measures the work of the persistent cache at startup with |state.range(0)|
+// programs cached by a previous launch: the cache is created, a worker is
+// added like |Shell::Setup| does, and every program is loaded the way Skia
+// does when the first frame compiles its shaders.
+static void LoadCachedPrograms(benchmark::State& state,
+                               bool use_shader_cache_file) {
+  constexpr size_t kProgramSize = 2048;
+  const int64_t program_count = state.range(0);
+
+  fml::ScopedTemporaryDirectory base_dir;
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::SetUseShaderCacheFile(use_shader_cache_file);
+  PersistentCache::ResetCacheForProcess();
+  PersistentCache::SetCacheSkSL(false);
+  fml::Thread worker("io.flutter.bench.worker");
+
+  std::vector<sk_sp<SkData>> keys;
+  {
+    GrContextOptions::PersistentCache* cache =
+        PersistentCache::GetCacheForProcess();
+    PersistentCache::GetCacheForProcess()->AddWorkerTaskRunner(
+        worker.GetTaskRunner());
+    std::vector<uint8_t> program(kProgramSize);
+    for (int64_t i = 0; i < program_count; i++) {
+      uint64_t key[4] = {static_cast<uint64_t>(i), ~static_cast<uint64_t>(i),
+                         static_cast<uint64_t>(i) * 0x9e3779b97f4a7c15ull, 0};
+      keys.push_back(SkData::MakeWithCopy(key, sizeof(key)));
+      std::fill(program.begin(), program.end(), static_cast<uint8_t>(i));
+      cache->store(*keys.back(), *SkData::MakeWithoutCopy(program.data(),
+                                                          program.size()));
+    }
+    FlushTaskRunner(worker.GetTaskRunner());
+    PersistentCache::GetCacheForProcess()->RemoveWorkerTaskRunner(
+        worker.GetTaskRunner());
+  }
+
+  while (state.KeepRunning()) {
+    PersistentCache::ResetCacheForProcess();
+    PersistentCache* cache = PersistentCache::GetCacheForProcess();
+    cache->AddWorkerTaskRunner(worker.GetTaskRunner());
+    for (const sk_sp<SkData>& key : keys) {
+      sk_sp<SkData> program = cache->load(*key);
+      FML_CHECK(program && program->size() == kProgramSize);
+    }
+    cache->RemoveWorkerTaskRunner(worker.GetTaskRunner());
+    // Let the prefetch finish before the cache is reset.
+    FlushTaskRunner(worker.GetTaskRunner());
+  }
+  state.SetItemsProcessed(state.iterations() * program_count);
+
+  PersistentCache::SetUseShaderCacheFile(false);
+  PersistentCache::SetCacheDirectoryPath("");
+  PersistentCache::ResetCacheForProcess();
+}
+
+static void BM_PersistentCacheStartupWithFilePerProgram(
+    benchmark::State& state) {
+  LoadCachedPrograms(state, false);
+}
+
+BENCHMARK(BM_PersistentCacheStartupWithFilePerProgram)
+    ->Arg(1 << 10)
+    ->Arg(4 << 10)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_PersistentCacheStartupWithShaderCacheFile(
+    benchmark::State& state) {
+  LoadCachedPrograms(state, true);
+}
+
+BENCHMARK(BM_PersistentCacheStartupWithShaderCacheFile)
+    ->Arg(1 << 10)
+    ->Arg(4 << 10)
+    ->Unit(benchmark::kMillisecond);
+
+// Builds and tears down a layer tree the way |SceneBuilder| does: every
+// container gets a transform layer holding |kLeavesPerContainer| leaves.
+// The leaves are allocated either individually or from a |LayerArena|.
+static void BuildAndRetireLayerTree(benchmark::State& state, bool use_arena) {
+  constexpr int64_t kLeavesPerContainer = 8;
+  const int64_t leaf_count = state.range(0);
+
+  while (state.KeepRunning()) {
+    auto arena = use_arena ? LayerArena::Create() : nullptr;
+    auto root = std::make_shared<ContainerLayer>();
+    std::shared_ptr<ContainerLayer> container;
+    for (int64_t i = 0; i < leaf_count; i++) {
+      if (i % kLeavesPerContainer == 0) {
+        container = std::make_shared<TransformLayer>(
+            SkMatrix::Translate(i % 100, i / 100));
+        root->Add(container);
+      }
+      const SkPoint offset = SkPoint::Make(i % 10, 0);
+      const SkSize size = SkSize::Make(10, 10);
+      std::shared_ptr<TextureLayer> leaf;
+      if (use_arena) {
+        leaf = arena->Make<TextureLayer>(offset, size, i, false,
+                                         SkSamplingOptions());
+      } else {
+        leaf = std::make_shared<TextureLayer>(offset, size, i, false,
+                                              SkSamplingOptions());
+      }
+      container->Add(std::move(leaf));
+    }
+    container.reset();
+    arena.reset();
+
+    auto layer_tree =
+        std::make_unique<LayerTree>(SkISize::Make(1000, 1000), 1.0f);
+    layer_tree->set_root_layer(std::move(root));
+    layer_tree.reset();
+  }
+  state.SetItemsProcessed(state.iterations() * leaf_count);
+}
+
+static void BM_BuildLayerTreeWithHeapLayers(benchmark::State& state) {
+  BuildAndRetireLayerTree(state, false);
+}
+
+BENCHMARK(BM_BuildLayerTreeWithHeapLayers)->Range(64, 8 << 10);
+
+static void BM_BuildLayerTreeWithArenaLayers(benchmark::State& state) {
+  BuildAndRetireLayerTree(state, true);
+}
+
+BENCHMARK(BM_BuildLayerTreeWithArenaLayers)->Range(64, 8 << 10);
+
+static std::shared_ptr<PictureLayer> MakePictureLayer(const SkRect& bounds,
+                                                      int shape_count) {
+  SkPictureRecorder recorder;
+  SkCanvas* canvas = recorder.beginRecording(bounds);
+  SkPaint paint;
+  paint.setAntiAlias(true);
+  for (int i = 0; i < shape_count; i++) {
+    paint.setColor(SkColorSetARGB(0xFF, i * 13, i * 29, i * 47));
+    canvas->drawRRect(
+        SkRRect::MakeRectXY(bounds.makeInset(i % 8, i % 5), 4, 4), paint);
+  }
+  return std::make_shared<PictureLayer>(
+      SkPoint::Make(0, 0),
+      SkiaGPUObject<SkPicture>(recorder.finishRecordingAsPicture(), nullptr),
+      false, false);
+}
+
+// A platform surface that hands out the same raster backing store for every
+// frame and presents nothing.
+class BenchmarkSoftwareSurfaceDelegate : public GPUSurfaceSoftwareDelegate {
+ public:
+  explicit BenchmarkSoftwareSurfaceDelegate(const SkISize& size)
+      : backing_store_(
+            SkSurface::MakeRasterN32Premul(size.width(), size.height())) {}
+
+  // |GPUSurfaceSoftwareDelegate|
+  sk_sp<SkSurface> AcquireBackingStore(const SkISize& size) override {
+    return backing_store_;
+  }
+
+  // |GPUSurfaceSoftwareDelegate|
+  bool PresentBackingStore(sk_sp<SkSurface> backing_store) override {
+    return true;
+  }
+
+ private:
+  sk_sp<SkSurface> backing_store_;
+};
+
+// Rasterizes a 4K dashboard through |GPUSurfaceSoftware| like
+// |Rasterizer::DrawToSurface| does, with frames split into |state.range(0)|
+// bands. Each tile of the dashboard draws |state.range(1)| shapes.
+static void BM_RasterSoftwareSurfaceInTiles(benchmark::State& state) {
+  const SkISize frame_size = SkISize::Make(3840, 2160);
+  BenchmarkSoftwareSurfaceDelegate delegate(frame_size);
+  GPUSurfaceSoftware surface(&delegate, true, state.range(0));
+
+  auto root = std::make_shared<ContainerLayer>();
+  for (int y = 0; y < frame_size.height(); y += 240) {
+    for (int x = 0; x < frame_size.width(); x += 240) {
+      root->Add(
+          MakePictureLayer(SkRect::MakeXYWH(x, y, 240, 240), state.range(1)));
+    }
+  }
+  LayerTree layer_tree(frame_size, 1.0f);
+  layer_tree.set_root_layer(std::move(root));
+
+  CompositorContext compositor_context;
+  while (state.KeepRunning()) {
+    auto frame = surface.AcquireFrame(frame_size);
+    auto compositor_frame = compositor_context.AcquireFrame(
+        nullptr, frame->SkiaCanvas(), nullptr,
+        surface.GetRootTransformation(), false, true, nullptr);
+    compositor_frame->Raster(layer_tree, true, nullptr);
+    frame->Submit();
+  }
+}
+
+// The bands are drawn on other threads, so the wall time is what matters.
+BENCHMARK(BM_RasterSoftwareSurfaceInTiles)
+    ->Args({1, 4})
+    ->Args({2, 4})
+    ->Args({4, 4})
+    ->Args({8, 4})
+    ->Args({1, 32})
+    ->Args({2, 32})
+    ->Args({4, 32})
+    ->Args({8, 32})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Draws a scene of |op_count| operations like the ones a framework
+// picture is made of: clipped, translated shapes and paths.
+static void DrawBenchmarkScene(SkCanvas* canvas, int64_t op_count) {
+  SkPaint fill;
+  fill.setAntiAlias(true);
+  SkPaint stroke;
+  stroke.setAntiAlias(true);
+  stroke.setStyle(SkPaint::kStroke_Style);
+  stroke.setStrokeWidth(2);
+  SkPath path;
+  path.moveTo(0, 0);
+  path.lineTo(20, 5);
+  path.lineTo(10, 20);
+  path.close();
+  for (int64_t i = 0; i < op_count; i += 4) {
+    const SkScalar x = (i * 7) % 1000;
+    const SkScalar y = (i * 13) % 1000;
+    canvas->save();
+    canvas->translate(x, y);
+    fill.setColor(SkColorSetARGB(0xFF, i * 13, i * 29, i * 47));
+    canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeWH(40, 20), 4, 4),
+                      fill);
+    canvas->drawPath(path, stroke);
+    canvas->restore();
+  }
+}
+
+static sk_sp<SkPicture> RecordBenchmarkPicture(int64_t op_count) {
+  SkPictureRecorder recorder;
+  SkRTreeFactory rtree_factory;
+  DrawBenchmarkScene(
+      recorder.beginRecording(SkRect::MakeWH(1000, 1000), &rtree_factory),
+      op_count);
+  return recorder.finishRecordingAsPicture();
+}
+
+static sk_sp<DisplayList> RecordBenchmarkDisplayList(int64_t op_count) {
+  DisplayListCanvasRecorder recorder(SkRect::MakeWH(1000, 1000));
+  DrawBenchmarkScene(&recorder, op_count);
+  return recorder.Build();
+}
+
+// Records like |PictureRecorder| does without display lists.
+static void BM_RecordSkPicture(benchmark::State& state) {
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(RecordBenchmarkPicture(state.range(0)));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_RecordSkPicture)->Range(64, 8 << 10);
+
+static void BM_RecordDisplayList(benchmark::State& state) {
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(RecordBenchmarkDisplayList(state.range(0)));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_RecordDisplayList)->Range(64, 8 << 10);
+
+static void BM_PlaybackSkPicture(benchmark::State& state) {
+  auto picture = RecordBenchmarkPicture(state.range(0));
+  auto surface = SkSurface::MakeRasterN32Premul(1000, 1000);
+  while (state.KeepRunning()) {
+    picture->playback(surface->getCanvas());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_PlaybackSkPicture)->Range(64, 8 << 10);
+
+static void BM_PlaybackDisplayList(benchmark::State& state) {
+  auto display_list = RecordBenchmarkDisplayList(state.range(0));
+  auto surface = SkSurface::MakeRasterN32Premul(1000, 1000);
+  while (state.KeepRunning()) {
+    display_list->RenderTo(surface->getCanvas());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_PlaybackDisplayList)->Range(64, 8 << 10);
+
+// Compares two recordings of the same scene the way pictures are deep
+// compared when diffing layer trees.
+static void BM_CompareSkPictures(benchmark::State& state) {
+  auto picture1 = RecordBenchmarkPicture(state.range(0));
+  auto picture2 = RecordBenchmarkPicture(state.range(0));
+  while (state.KeepRunning()) {
+    auto data1 = picture1->serialize();
+    auto data2 = picture2->serialize();
+    benchmark::DoNotOptimize(data1->equals(data2.get()));
+  }
+}
+
+BENCHMARK(BM_CompareSkPictures)->Range(64, 8 << 10);
+
+static void BM_CompareDisplayLists(benchmark::State& state) {
+  auto display_list1 = RecordBenchmarkDisplayList(state.range(0));
+  auto display_list2 = RecordBenchmarkDisplayList(state.range(0));
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(display_list1->Equals(*display_list2));
+  }
+}
+
+BENCHMARK(BM_CompareDisplayLists)->Range(64, 8 << 10);
+
+// Queries the drawn rects of a picture of |state.range(0)| rects laid out in
+// rows, a third of which overlap their right neighbor, like the overlays
+// above a platform view are computed.
+static void BM_RTreeSearchNonOverlappingDrawnRects(benchmark::State& state) {
+  const int64_t op_count = state.range(0);
+  RTreeFactory rtree_factory;
+  SkPictureRecorder recorder;
+  SkCanvas* canvas =
+      recorder.beginRecording(SkRect::MakeWH(1000, 1000), &rtree_factory);
+  for (int64_t i = 0; i < op_count; i++) {
+    const SkScalar width = i % 3 == 0 ? 14 : 8;
+    canvas->drawRect(
+        SkRect::MakeXYWH((i % 100) * 10, (i / 100) * 10, width, 8), SkPaint());
+  }
+  auto picture = recorder.finishRecordingAsPicture();
+  sk_sp<RTree> rtree = rtree_factory.getInstance();
+
+  const SkRect query = SkRect::MakeWH(1000, 1000);
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(rtree->searchNonOverlappingDrawnRects(query));
+  }
+  state.SetItemsProcessed(state.iterations() * op_count);
+}
+
+BENCHMARK(BM_RTreeSearchNonOverlappingDrawnRects)
+    ->Range(64, 10000)
+    ->Unit(benchmark::kMicrosecond);
+
+// Stands in for the engine, counting the packets and events that would reach
+// the framework.
+class CountingPointerDataDispatcherDelegate
+    : public PointerDataDispatcher::Delegate {
+ public:
+  void DoDispatchPacket(std::unique_ptr<PointerDataPacket> packet,
+                        uint64_t trace_flow_id) override {
+    packet_count++;
+    event_count += packet->data().size() / sizeof(PointerData);
+  }
+
+  void ScheduleSecondaryVsyncCallback(uintptr_t id,
+                                      const fml::closure& callback) override {
+    vsync_callbacks_.emplace_back(callback);
+  }
+
+  void Vsync() {
+    std::vector<fml::closure> callbacks = std::move(vsync_callbacks_);
+    vsync_callbacks_.clear();
+    for (const auto& callback : callbacks) {
+      callback();
+    }
+  }
+
+  int64_t packet_count = 0;
+  int64_t event_count = 0;
+
+ private:
+  std::vector<fml::closure> vsync_callbacks_;
+};
+
+// Dispatches a touch drag reported at 1kHz, one event per packet, through the
+// dispatcher |make_dispatcher| makes, with a VSYNC at 60Hz. An iteration is a
+// frame. The counters are the packets and events the framework receives per
+// frame, each costing a trip through the UI isolate.
+static void DispatchPointerEventsAt1kHz(
+    benchmark::State& state,
+    const std::function<std::unique_ptr<PointerDataDispatcher>(
+        PointerDataDispatcher::Delegate&,
+        const std::function<fml::TimePoint()>&)>& make_dispatcher) {
+  CountingPointerDataDispatcherDelegate delegate;
+  int64_t now = fml::TimePoint::Now().ToEpochDelta().ToMicroseconds();
+  auto dispatcher = make_dispatcher(delegate, [&now]() {
+    return fml::TimePoint::FromEpochDelta(
+        fml::TimeDelta::FromMicroseconds(now));
+  });
+
+  PointerData data;
+  data.Clear();
+  data.kind = PointerData::DeviceKind::kTouch;
+  data.change = PointerData::Change::kDown;
+  data.time_stamp = now;
+  auto down = std::make_unique<PointerDataPacket>(1);
+  down->SetPointerData(0, data);
+  dispatcher->DispatchPacket(std::move(down), 0);
+
+  data.change = PointerData::Change::kMove;
+  int64_t frame_count = 0;
+  while (state.KeepRunning()) {
+    for (int i = 0; i < 16; i++) {
+      now += 1000;
+      data.time_stamp = now;
+      data.physical_x += 1;
+      auto packet = std::make_unique<PointerDataPacket>(1);
+      packet->SetPointerData(0, data);
+      dispatcher->DispatchPacket(std::move(packet), 0);
+    }
+    now += 667;
+    delegate.Vsync();
+    frame_count++;
+  }
+  state.counters["PacketsPerFrame"] = benchmark::Counter(
+      static_cast<double>(delegate.packet_count) / frame_count);
+  state.counters["EventsPerFrame"] = benchmark::Counter(
+      static_cast<double>(delegate.event_count) / frame_count);
+}
+
+static void BM_DispatchPointerEventsAt1kHzDefault(benchmark::State& state) {
+  DispatchPointerEventsAt1kHz(
+      state, [](PointerDataDispatcher::Delegate& delegate, const auto& clock) {
+        return std::make_unique<DefaultPointerDataDispatcher>(delegate);
+      });
+}
+
+static void BM_DispatchPointerEventsAt1kHzSmooth(benchmark::State& state) {
+  DispatchPointerEventsAt1kHz(
+      state, [](PointerDataDispatcher::Delegate& delegate, const auto& clock) {
+        return std::make_unique<SmoothPointerDataDispatcher>(delegate);
+      });
+}
+
+static void BM_DispatchPointerEventsAt1kHzResampling(benchmark::State& state) {
+  DispatchPointerEventsAt1kHz(
+      state, [](PointerDataDispatcher::Delegate& delegate, const auto& clock) {
+        return std::make_unique<ResamplingPointerDataDispatcher>(
+            delegate, ResamplingPointerDataDispatcher::Config::Default(),
+            clock);
+      });
+}
+
+BENCHMARK(BM_DispatchPointerEventsAt1kHzDefault)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DispatchPointerEventsAt1kHzSmooth)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DispatchPointerEventsAt1kHzResampling)
+    ->Unit(benchmark::kMicrosecond);
+
+#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
+
+// Rasterizes a static dashboard with a blinking text cursor: every other
+// frame contains the cursor. With |partial_repaint|, each frame is diffed
+// against the previous one and painting is clipped to the damage, like
+// |Rasterizer::DrawToSurface| does for surfaces that support it.
+static void RasterBlinkingCursorScene(benchmark::State& state,
+                                      bool partial_repaint) {
+  const SkISize frame_size = SkISize::Make(1920, 1080);
+  auto surface = SkSurface::MakeRasterN32Premul(frame_size.width(),
+                                                frame_size.height());
+
+  std::vector<std::shared_ptr<PictureLayer>> tiles;
+  for (int y = 0; y < frame_size.height(); y += 120) {
+    for (int x = 0; x < frame_size.width(); x += 120) {
+      tiles.push_back(
+          MakePictureLayer(SkRect::MakeXYWH(x, y, 120, 120), state.range(0)));
+    }
+  }
+  auto cursor = MakePictureLayer(SkRect::MakeXYWH(500, 500, 2, 20), 1);
+
+  std::unique_ptr<LayerTree> layer_trees[2];
+  for (int i = 0; i < 2; i++) {
+    auto root = std::make_shared<ContainerLayer>();
+    for (const auto& tile : tiles) {
+      root->Add(tile);
+    }
+    if (i == 0) {
+      root->Add(cursor);
+    }
+    layer_trees[i] = std::make_unique<LayerTree>(frame_size, 1.0f);
+    layer_trees[i]->set_root_layer(std::move(root));
+  }
+
+  CompositorContext compositor_context;
+  SkMatrix root_surface_transformation;
+  int64_t frame_index = 0;
+  while (state.KeepRunning()) {
+    LayerTree& layer_tree = *layer_trees[frame_index % 2];
+    const LayerTree* last_layer_tree =
+        frame_index > 0 ? layer_trees[(frame_index + 1) % 2].get() : nullptr;
+    frame_index++;
+
+    std::optional<SkIRect> clip_rect;
+    if (partial_repaint) {
+      const PaintRegionMap empty_paint_region_map;
+      DiffContext context(frame_size, 1.0, layer_tree.paint_region_map(),
+                          last_layer_tree ? last_layer_tree->paint_region_map()
+                                          : empty_paint_region_map);
+      context.PushCullRect(SkRect::Make(frame_size));
+      {
+        DiffContext::AutoSubtreeRestore subtree(&context);
+        if (!last_layer_tree) {
+          context.MarkSubtreeDirty();
+        }
+        layer_tree.root_layer()->Diff(
+            &context,
+            last_layer_tree ? last_layer_tree->root_layer() : nullptr);
+      }
+      if (last_layer_tree) {
+        clip_rect = context.ComputeDamage(SkIRect::MakeEmpty()).buffer_damage;
+      }
+    }
+
+    auto frame = compositor_context.AcquireFrame(
+        nullptr, surface->getCanvas(), nullptr, root_surface_transformation,
+        false, true, nullptr);
+    frame->Raster(layer_tree, true, clip_rect ? &clip_rect.value() : nullptr);
+    surface->getCanvas()->flush();
+  }
+}
+
+static void BM_RasterBlinkingCursorFullRepaint(benchmark::State& state) {
+  RasterBlinkingCursorScene(state, false);
+}
+
+BENCHMARK(BM_RasterBlinkingCursorFullRepaint)
+    ->Arg(4)
+    ->Arg(32)
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_RasterBlinkingCursorPartialRepaint(benchmark::State& state) {
+  RasterBlinkingCursorScene(state, true);
+}
+
+BENCHMARK(BM_RasterBlinkingCursorPartialRepaint)
+    ->Arg(4)
+    ->Arg(32)
+    ->Unit(benchmark::kMicrosecond);
+
+#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
+
 }  // namespace flutter
@@ -0,0 +1,85 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/shell_pool.h"
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+ShellPool::ShellPool(
+    const Shell& spawner,
+    size_t capacity,
+    RunConfigurationFactory run_configuration_factory,
+    Shell::CreateCallback<PlatformView> on_create_platform_view,
+    Shell::CreateCallback<Rasterizer> on_create_rasterizer)
+    : spawner_(spawner),
+      capacity_(capacity),
+      run_configuration_factory_(std::move(run_configuration_factory)),
+      on_create_platform_view_(std::move(on_create_platform_view)),
+      on_create_rasterizer_(std::move(on_create_rasterizer)),
+      weak_factory_(this) {
+  FML_DCHECK(RunsOnPlatformTaskRunner());
+}
+
+ShellPool::~ShellPool() {
+  FML_DCHECK(RunsOnPlatformTaskRunner());
+}
+
+void ShellPool::Fill() {
+  FML_DCHECK(RunsOnPlatformTaskRunner());
+  if (fill_scheduled_ || idle_shells_.size() >= capacity_) {
+    return;
+  }
+  fill_scheduled_ = true;
+  spawner_.GetTaskRunners().GetPlatformTaskRunner()->PostTask(
+      [pool = weak_factory_.GetWeakPtr()]() {
+        if (pool) {
+          pool->fill_scheduled_ = false;
+          pool->SpawnIdleShell();
+        }
+      });
+}
+
+std::unique_ptr<Shell> ShellPool::Take() {
+  FML_DCHECK(RunsOnPlatformTaskRunner());
+  TRACE_EVENT0("flutter", "ShellPool::Take");
+  std::unique_ptr<Shell> shell;
+  if (idle_shells_.empty()) {
+    shell = SpawnShell();
+  } else {
+    shell = std::move(idle_shells_.front());
+    idle_shells_.pop_front();
+  }
+  Fill();
+  return shell;
+}
+
+void ShellPool::SpawnIdleShell() {
+  if (idle_shells_.size() >= capacity_) {
+    return;
+  }
+  TRACE_EVENT0("flutter", "ShellPool::SpawnIdleShell");
+  auto shell = SpawnShell();
+  if (!shell) {
+    FML_LOG(ERROR) << "Could not spawn a shell for the pool.";
+    return;
+  }
+  idle_shells_.push_back(std::move(shell));
+  Fill();
+}
+
+std::unique_ptr<Shell> ShellPool::SpawnShell() const {
+  return spawner_.Spawn(run_configuration_factory_(), on_create_platform_view_,
+                        on_create_rasterizer_);
+}
+
+bool ShellPool::RunsOnPlatformTaskRunner() const {
+  return spawner_.GetTaskRunners()
+      .GetPlatformTaskRunner()
+      ->RunsTasksOnCurrentThread();
+}
+
+}  // namespace flutter
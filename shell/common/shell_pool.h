@@ -0,0 +1,101 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_COMMON_SHELL_POOL_H_
+#define SHELL_COMMON_SHELL_POOL_H_
+
+#include <deque>
+#include <functional>
+#include <memory>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/weak_ptr.h"
+#include "flutter/shell/common/run_configuration.h"
+#include "flutter/shell/common/shell.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      A pool of idle shells spawned from a running shell, for
+///             embedders that show many short-lived views and need a shell
+///             for a new view within a frame.
+///
+///             The shells are spawned with |Shell::Spawn| ahead of time. They
+///             share the task runners, the Dart VM, the isolate group and the
+///             font collection of the spawning shell, and their platform
+///             view, rasterizer and engine are already set up when they are
+///             handed out. Their entrypoint has run too: an entrypoint that
+///             waits for the viewport metrics of its view before drawing runs
+///             up to that point while the shell is idle.
+///
+///             All the methods must be called on the platform task runner of
+///             the spawning shell, which must outlive the pool.
+///
+class ShellPool {
+ public:
+  using RunConfigurationFactory = std::function<RunConfiguration()>;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates an empty pool. Call |Fill| to spawn its shells.
+  ///
+  /// @param[in]  spawner                    The running shell to spawn the
+  ///                                        shells from.
+  /// @param[in]  capacity                   The number of idle shells to
+  ///                                        keep.
+  /// @param[in]  run_configuration_factory  Creates the run configuration of
+  ///                                        each shell.
+  /// @param[in]  on_create_platform_view    Creates the platform view of each
+  ///                                        shell.
+  /// @param[in]  on_create_rasterizer       Creates the rasterizer of each
+  ///                                        shell.
+  ///
+  ShellPool(const Shell& spawner,
+            size_t capacity,
+            RunConfigurationFactory run_configuration_factory,
+            Shell::CreateCallback<PlatformView> on_create_platform_view,
+            Shell::CreateCallback<Rasterizer> on_create_rasterizer);
+
+  ~ShellPool();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Spawns shells until the pool holds |capacity| idle shells.
+  ///             Each shell is spawned in its own platform task, so that the
+  ///             platform tasks posted meanwhile, such as input events, wait
+  ///             for at most one spawn.
+  ///
+  void Fill();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Hands out an idle shell, or spawns one if the pool is empty.
+  ///             The pool is filled again in later platform tasks, so that
+  ///             the caller isn't delayed by spawning the replacement.
+  ///
+  /// @return     The shell, which is owned by the caller from now on.
+  ///
+  std::unique_ptr<Shell> Take();
+
+  size_t GetIdleShellCount() const { return idle_shells_.size(); }
+
+ private:
+  const Shell& spawner_;
+  const size_t capacity_;
+  const RunConfigurationFactory run_configuration_factory_;
+  const Shell::CreateCallback<PlatformView> on_create_platform_view_;
+  const Shell::CreateCallback<Rasterizer> on_create_rasterizer_;
+  std::deque<std::unique_ptr<Shell>> idle_shells_;
+  bool fill_scheduled_ = false;
+  fml::WeakPtrFactory<ShellPool> weak_factory_;  // Must be the last member.
+
+  void SpawnIdleShell();
+
+  std::unique_ptr<Shell> SpawnShell() const;
+
+  bool RunsOnPlatformTaskRunner() const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ShellPool);
+};
+
+}  // namespace flutter
+
+#endif  // SHELL_COMMON_SHELL_POOL_H_
@@ -223,6 +223,10 @@ int ShellTest::UnreportedTimingsCount(Shell* shell) {
   return shell->unreported_timings_.size();
 }
 
+bool ShellTest::IsFrameScheduled(const Animator& animator) {
+  return animator.frame_scheduled_;
+}
+
 void ShellTest::SetNeedsReportTimings(Shell* shell, bool value) {
   shell->SetNeedsReportTimings(value);
 }
@@ -120,6 +120,9 @@ class ShellTest : public FixtureTest {
   // is unpredictive.
   static int UnreportedTimingsCount(Shell* shell);
 
+  // Whether |animator| waits for a vsync or a delayed build to begin a frame.
+  static bool IsFrameScheduled(const Animator& animator);
+
  private:
   ThreadHost thread_host_;
 
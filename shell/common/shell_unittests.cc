@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "assets/directory_asset_bundle.h"
+#include "assets/packed_asset_bundle.h"
 #include "flutter/common/graphics/persistent_cache.h"
 #include "flutter/flow/layers/layer_tree.h"
 #include "flutter/flow/layers/picture_layer.h"
@@ -20,22 +21,28 @@
 #include "flutter/fml/dart/dart_converter.h"
 #include "flutter/fml/make_copyable.h"
 #include "flutter/fml/message_loop.h"
+#include "flutter/fml/paths.h"
 #include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/trace_recorder.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/common/rasterizer.h"
+#include "flutter/shell/common/shell_pool.h"
 #include "flutter/shell/common/shell_test.h"
 #include "flutter/shell/common/shell_test_external_view_embedder.h"
 #include "flutter/shell/common/shell_test_platform_view.h"
 #include "flutter/shell/common/switches.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/shell/common/vsync_waiter_fallback.h"
+#include "flutter/shell/gpu/gpu_surface_software.h"
 #include "flutter/shell/version/version.h"
 #include "flutter/testing/testing.h"
 #include "gmock/gmock.h"
 #include "third_party/rapidjson/include/rapidjson/writer.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/effects/SkImageFilters.h"
 #include "third_party/tonic/converter/dart_converter.h"
 
 #ifdef SHELL_ENABLE_VULKAN
@@ -2520,6 +2527,147 @@ TEST_F(ShellTest, AssetManagerMultiSubdir) {
 }
 #endif  // OS_FUCHSIA
 
+static std::string MappingToString(const fml::Mapping& mapping) {
+  return std::string(reinterpret_cast<const char*>(mapping.GetMapping()),
+                     mapping.GetSize());
+}
+
+TEST_F(ShellTest, PackedAssetBundle) {
+  std::map<std::string, std::unique_ptr<fml::Mapping>> assets;
+  for (const char* name : {"good0", "bad0", "subdir/good1", "subdir/bad1",
+                           "subdir/nested/good2", "shaders/a.skp"}) {
+    assets[name] = std::make_unique<fml::DataMapping>(std::string(name));
+  }
+  std::shared_ptr<const fml::Mapping> archive =
+      PackedAssetBundle::Pack(assets);
+  ASSERT_NE(archive, nullptr);
+
+  AssetManager asset_manager;
+  asset_manager.PushBack(std::make_unique<PackedAssetBundle>(archive, false));
+  // Slices of the archive keep it alive.
+  archive.reset();
+
+  auto mapping = asset_manager.GetAsMapping("subdir/good1");
+  ASSERT_NE(mapping, nullptr);
+  EXPECT_EQ(MappingToString(*mapping), "subdir/good1");
+  EXPECT_EQ(asset_manager.GetAsMapping("subdir"), nullptr);
+  EXPECT_EQ(asset_manager.GetAsMapping("missing"), nullptr);
+
+  // Like |DirectoryAssetBundle|, patterns match file names, in all the
+  // directories or only directly in the given one.
+  EXPECT_EQ(asset_manager.GetAsMappings("(.*)", std::nullopt).size(), 6u);
+  EXPECT_EQ(asset_manager.GetAsMappings("(.*)good(.*)", std::nullopt).size(),
+            3u);
+  EXPECT_EQ(asset_manager.GetAsMappings("(.*)", "subdir").size(), 2u);
+  auto mappings = asset_manager.GetAsMappings(".*\\.skp$", "shaders");
+  ASSERT_EQ(mappings.size(), 1u);
+  EXPECT_EQ(MappingToString(*mappings[0]), "shaders/a.skp");
+  mappings = asset_manager.GetAsMappings("good1", "subdir");
+  ASSERT_EQ(mappings.size(), 1u);
+  EXPECT_EQ(MappingToString(*mappings[0]), "subdir/good1");
+}
+
+TEST_F(ShellTest, PackedAssetBundleRejectsMalformedArchives) {
+  std::map<std::string, std::unique_ptr<fml::Mapping>> assets;
+  assets["asset"] = std::make_unique<fml::DataMapping>(std::string("asset"));
+  std::unique_ptr<fml::Mapping> archive = PackedAssetBundle::Pack(assets);
+
+  std::vector<uint8_t> truncated(archive->GetMapping(),
+                                 archive->GetMapping() + 20);
+  PackedAssetBundle truncated_bundle(
+      std::make_shared<fml::DataMapping>(std::move(truncated)), false);
+  EXPECT_FALSE(truncated_bundle.IsValid());
+
+  std::vector<uint8_t> corrupt(archive->GetMapping(),
+                               archive->GetMapping() + archive->GetSize());
+  corrupt[0] ^= 0xff;
+  PackedAssetBundle corrupt_bundle(
+      std::make_shared<fml::DataMapping>(std::move(corrupt)), false);
+  EXPECT_FALSE(corrupt_bundle.IsValid());
+
+  PackedAssetBundle bundle(std::move(archive), false);
+  EXPECT_TRUE(bundle.IsValid());
+  EXPECT_EQ(bundle.GetType(),
+            AssetResolver::AssetResolverType::kPackedAssetBundle);
+}
+
+TEST_F(ShellTest, PackedAssetBundleReadsUnalignedArchives) {
+  std::map<std::string, std::unique_ptr<fml::Mapping>> assets;
+  assets["a"] = std::make_unique<fml::DataMapping>(std::string("a"));
+  assets["b/c"] = std::make_unique<fml::DataMapping>(std::string("b/c"));
+  std::unique_ptr<fml::Mapping> archive = PackedAssetBundle::Pack(assets);
+
+  // Archives embedded in other files are not necessarily aligned.
+  std::vector<uint8_t> shifted(archive->GetSize() + 1);
+  memcpy(shifted.data() + 1, archive->GetMapping(), archive->GetSize());
+  PackedAssetBundle bundle(std::make_shared<fml::NonOwnedMapping>(
+                               shifted.data() + 1, archive->GetSize()),
+                           false);
+  ASSERT_TRUE(bundle.IsValid());
+  auto mapping = bundle.GetAsMapping("b/c");
+  ASSERT_NE(mapping, nullptr);
+  EXPECT_EQ(MappingToString(*mapping), "b/c");
+  EXPECT_EQ(bundle.GetAsMappings("(.*)", std::nullopt).size(), 2u);
+}
+
+TEST_F(ShellTest, InferFromSettingsPrefersPackedAssets) {
+  fml::ScopedTemporaryDirectory asset_dir;
+  fml::UniqueFD asset_dir_fd = fml::OpenDirectory(
+      asset_dir.path().c_str(), false, fml::FilePermission::kReadWrite);
+  ASSERT_TRUE(fml::WriteAtomically(asset_dir_fd, "loose",
+                                   fml::DataMapping(std::string("loose"))));
+  Settings settings;
+  settings.assets_path = asset_dir.path();
+
+  // Without an archive, the assets are read from the directory.
+  auto asset_manager =
+      RunConfiguration::InferFromSettings(settings).GetAssetManager();
+  EXPECT_NE(asset_manager->GetAsMapping("loose"), nullptr);
+
+  // A corrupt archive is ignored.
+  ASSERT_TRUE(fml::WriteAtomically(asset_dir_fd,
+                                   PackedAssetBundle::kArchiveFileName,
+                                   fml::DataMapping(std::string("corrupt"))));
+  asset_manager =
+      RunConfiguration::InferFromSettings(settings).GetAssetManager();
+  EXPECT_NE(asset_manager->GetAsMapping("loose"), nullptr);
+
+  // The directory is not searched when it has an archive.
+  std::map<std::string, std::unique_ptr<fml::Mapping>> assets;
+  assets["packed"] = std::make_unique<fml::DataMapping>(std::string("packed"));
+  ASSERT_TRUE(fml::WriteAtomically(asset_dir_fd,
+                                   PackedAssetBundle::kArchiveFileName,
+                                   *PackedAssetBundle::Pack(assets)));
+  asset_manager =
+      RunConfiguration::InferFromSettings(settings).GetAssetManager();
+  EXPECT_NE(asset_manager->GetAsMapping("packed"), nullptr);
+  EXPECT_EQ(asset_manager->GetAsMapping("loose"), nullptr);
+  auto resolvers = asset_manager->TakeResolvers();
+  ASSERT_EQ(resolvers.size(), 1u);
+  EXPECT_EQ(resolvers[0]->GetType(),
+            AssetResolver::AssetResolverType::kPackedAssetBundle);
+}
+
+TEST_F(ShellTest, TraceToFileIsValidJsonAfterShellTeardown) {
+  fml::ScopedTemporaryDirectory trace_dir;
+  auto settings = CreateSettingsForFixture();
+  settings.trace_to_file = fml::paths::JoinPaths({trace_dir.path(), "t.json"});
+  auto shell = CreateShell(settings);
+  ASSERT_TRUE(ValidateShell(shell.get()));
+  EXPECT_TRUE(fml::tracing::TraceRecorder::IsRecording());
+
+  DestroyShell(std::move(shell));
+  EXPECT_FALSE(fml::tracing::TraceRecorder::IsRecording());
+
+  auto mapping = fml::FileMapping::CreateReadOnly(trace_dir.fd(), "t.json");
+  ASSERT_NE(mapping, nullptr);
+  rapidjson::Document trace;
+  trace.Parse(MappingToString(*mapping).c_str());
+  ASSERT_FALSE(trace.HasParseError());
+  ASSERT_TRUE(trace.IsArray());
+  EXPECT_GT(trace.Size(), 0u);
+}
+
 TEST_F(ShellTest, Spawn) {
   auto settings = CreateSettingsForFixture();
   auto shell = CreateShell(settings);
@@ -2605,6 +2753,66 @@ TEST_F(ShellTest, Spawn) {
   ASSERT_FALSE(DartVMRef::IsInstanceRunning());
 }
 
+TEST_F(ShellTest, ShellPoolHandsOutSpawnedShellsAndRefills) {
+  auto settings = CreateSettingsForFixture();
+  auto shell = CreateShell(settings);
+  ASSERT_TRUE(ValidateShell(shell.get()));
+
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  ASSERT_TRUE(configuration.IsValid());
+  configuration.SetEntrypoint("emptyMain");
+  RunEngine(shell.get(), std::move(configuration));
+
+  MockPlatformViewDelegate platform_view_delegate;
+  std::unique_ptr<ShellPool> pool;
+  std::unique_ptr<Shell> taken;
+  PostSync(shell->GetTaskRunners().GetPlatformTaskRunner(), [&] {
+    pool = std::make_unique<ShellPool>(
+        *shell, 2,
+        [&settings] {
+          auto configuration = RunConfiguration::InferFromSettings(settings);
+          configuration.SetEntrypoint("emptyMain");
+          return configuration;
+        },
+        [&platform_view_delegate](Shell& shell) {
+          auto result = std::make_unique<MockPlatformView>(
+              platform_view_delegate, shell.GetTaskRunners());
+          ON_CALL(*result, CreateRenderingSurface())
+              .WillByDefault(::testing::Invoke(
+                  [] { return std::make_unique<MockSurface>(); }));
+          return result;
+        },
+        [](Shell& shell) { return std::make_unique<Rasterizer>(shell); });
+    pool->Fill();
+    EXPECT_EQ(pool->GetIdleShellCount(), 0u);
+  });
+
+  // The shells are spawned one per platform task.
+  PostSync(shell->GetTaskRunners().GetPlatformTaskRunner(), [&pool] {
+    EXPECT_EQ(pool->GetIdleShellCount(), 1u);
+  });
+  PostSync(shell->GetTaskRunners().GetPlatformTaskRunner(), [&pool, &taken] {
+    EXPECT_EQ(pool->GetIdleShellCount(), 2u);
+
+    taken = pool->Take();
+    ASSERT_NE(taken, nullptr);
+    EXPECT_EQ(pool->GetIdleShellCount(), 1u);
+  });
+  ASSERT_TRUE(ValidateShell(taken.get()));
+
+  // The pool is filled again by a task posted when the shell was taken.
+  PostSync(shell->GetTaskRunners().GetPlatformTaskRunner(), [&pool] {
+    EXPECT_EQ(pool->GetIdleShellCount(), 2u);
+  });
+
+  PostSync(shell->GetTaskRunners().GetPlatformTaskRunner(), [&pool, &taken] {
+    pool.reset();
+    taken.reset();
+  });
+  DestroyShell(std::move(shell));
+  ASSERT_FALSE(DartVMRef::IsInstanceRunning());
+}
+
 TEST_F(ShellTest, UpdateAssetResolverByTypeReplaces) {
   ASSERT_FALSE(DartVMRef::IsInstanceRunning());
   Settings settings = CreateSettingsForFixture();
@@ -2838,5 +3046,164 @@ TEST_F(ShellTest, CanCreateShellsWithMetalBackend) {
   DestroyShell(std::move(shell));
 }
 
+TEST_F(ShellTest, RasterizeInTilesDrawsBackdropFiltersInOneBand) {
+  // The top half is red, and a blur of the whole backdrop makes it bleed
+  // into the bottom half, across the edge between two bands.
+  SkPictureRecorder recorder;
+  SkCanvas* recording_canvas = recorder.beginRecording(SkRect::MakeWH(64, 64));
+  SkPaint paint;
+  paint.setColor(SK_ColorRED);
+  recording_canvas->drawRect(SkRect::MakeWH(64, 32), paint);
+  sk_sp<SkImageFilter> blur = SkImageFilters::Blur(8, 8, nullptr);
+  recording_canvas->saveLayer(
+      SkCanvas::SaveLayerRec(nullptr, nullptr, blur.get(), 0));
+  recording_canvas->restore();
+  sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+  sk_sp<SkSurface> expected = SkSurface::MakeRasterN32Premul(64, 64);
+  expected->getCanvas()->drawPicture(picture);
+  sk_sp<SkSurface> tiled = SkSurface::MakeRasterN32Premul(64, 64);
+  auto workers = fml::ConcurrentMessageLoop::Create(1);
+  GPUSurfaceSoftware::RasterizeInTiles(*picture, *tiled, 2,
+                                       *workers->GetTaskRunner());
+
+  SkPixmap expected_pixels;
+  SkPixmap tiled_pixels;
+  ASSERT_TRUE(expected->peekPixels(&expected_pixels));
+  ASSERT_TRUE(tiled->peekPixels(&tiled_pixels));
+  ASSERT_NE(expected_pixels.getColor(32, 34), SK_ColorTRANSPARENT);
+  for (int y = 0; y < 64; y++) {
+    for (int x = 0; x < 64; x++) {
+      ASSERT_EQ(tiled_pixels.getColor(x, y), expected_pixels.getColor(x, y))
+          << "at " << x << ", " << y;
+    }
+  }
+}
+
+namespace {
+// Records the frames begun by an |Animator|, on the UI thread.
+class FrameRecordingAnimatorDelegate : public Animator::Delegate {
+ public:
+  void OnAnimatorBeginFrame(fml::TimePoint frame_target_time) override {
+    begin_frame_times.push_back(fml::TimePoint::Now());
+    begin_frame_latch.Signal();
+  }
+
+  void OnAnimatorNotifyIdle(int64_t deadline) override {}
+
+  void OnAnimatorDraw(fml::RefPtr<Pipeline<flutter::LayerTree>> pipeline,
+                      fml::TimePoint frame_target_time) override {}
+
+  void OnAnimatorDrawLastLayerTree() override {}
+
+  std::vector<fml::TimePoint> begin_frame_times;
+  fml::AutoResetWaitableEvent begin_frame_latch;
+};
+
+// Fires a vsync for a frame interval starting now whenever it is awaited, on
+// the UI thread.
+class ImmediateVsyncWaiter : public VsyncWaiter {
+ public:
+  static constexpr fml::TimeDelta kFrameInterval =
+      fml::TimeDelta::FromSeconds(1);
+
+  ImmediateVsyncWaiter(TaskRunners task_runners,
+                       std::vector<fml::TimePoint>& vsync_start_times)
+      : VsyncWaiter(std::move(task_runners)),
+        vsync_start_times_(vsync_start_times) {}
+
+ protected:
+  void AwaitVSync() override {
+    const fml::TimePoint now = fml::TimePoint::Now();
+    vsync_start_times_.push_back(now);
+    FireCallback(now, now + kFrameInterval);
+  }
+
+ private:
+  std::vector<fml::TimePoint>& vsync_start_times_;
+};
+
+FrameTiming MakeFrameTiming(fml::TimePoint vsync_start,
+                            fml::TimeDelta build_delay,
+                            fml::TimeDelta build_duration,
+                            fml::TimeDelta raster_duration) {
+  FrameTiming timing;
+  const fml::TimePoint build_start =
+      timing.Set(FrameTiming::kBuildStart, vsync_start + build_delay);
+  const fml::TimePoint build_finish =
+      timing.Set(FrameTiming::kBuildFinish, build_start + build_duration);
+  timing.Set(FrameTiming::kVsyncStart, vsync_start);
+  timing.Set(FrameTiming::kRasterStart, build_finish);
+  timing.Set(FrameTiming::kRasterFinish, build_finish + raster_duration);
+  return timing;
+}
+}  // namespace
+
+TEST_F(ShellTest, AnimatorDelaysLatencyAwareBuildsAfterVsync) {
+  TaskRunners task_runners = GetTaskRunnersForFixture();
+  auto ui_task_runner = task_runners.GetUITaskRunner();
+  const fml::TimeDelta build_duration = fml::TimeDelta::FromMilliseconds(1);
+  const fml::TimeDelta raster_duration = fml::TimeDelta::FromMilliseconds(1);
+
+  FrameRecordingAnimatorDelegate delegate;
+  std::vector<fml::TimePoint> vsync_start_times;
+  std::unique_ptr<Animator> animator;
+  PostSync(ui_task_runner, [&]() {
+    animator = std::make_unique<Animator>(
+        delegate, task_runners,
+        std::make_unique<ImmediateVsyncWaiter>(task_runners,
+                                               vsync_start_times),
+        PipelineMode::Queue, FrameSchedulingMode::LatencyAware);
+    // Frames the animator did not begin, for it to learn their durations.
+    const fml::TimePoint start =
+        fml::TimePoint::Now() - fml::TimeDelta::FromSeconds(10);
+    for (int i = 0; i < 10; i++) {
+      animator->OnFrameRasterized(MakeFrameTiming(
+          start + ImmediateVsyncWaiter::kFrameInterval * i,
+          fml::TimeDelta::Zero(), build_duration, raster_duration));
+    }
+    animator->RequestFrame();
+    ASSERT_TRUE(IsFrameScheduled(*animator));
+  });
+
+  // The first task awaits the vsync, the second one handles it and posts the
+  // build for later in the frame interval.
+  PostSync(ui_task_runner, [] {});
+  PostSync(ui_task_runner, [&]() {
+    ASSERT_EQ(vsync_start_times.size(), 1u);
+    ASSERT_TRUE(delegate.begin_frame_times.empty());
+    ASSERT_TRUE(IsFrameScheduled(*animator));
+
+    // The frame requested during the delay is the one about to be built.
+    animator->RequestFrame();
+  });
+  PostSync(ui_task_runner, [&]() {
+    ASSERT_EQ(vsync_start_times.size(), 1u);
+    ASSERT_TRUE(delegate.begin_frame_times.empty());
+    ASSERT_TRUE(IsFrameScheduled(*animator));
+  });
+
+  delegate.begin_frame_latch.Wait();
+  PostSync(ui_task_runner, [&]() {
+    ASSERT_EQ(vsync_start_times.size(), 1u);
+    ASSERT_EQ(delegate.begin_frame_times.size(), 1u);
+    ASSERT_FALSE(IsFrameScheduled(*animator));
+    const fml::TimeDelta build_delay = ImmediateVsyncWaiter::kFrameInterval -
+                                       build_duration - raster_duration -
+                                       fml::TimeDelta::FromMilliseconds(1);
+    ASSERT_GE(delegate.begin_frame_times[0],
+              vsync_start_times[0] + build_delay);
+
+    animator->OnFrameRasterized(MakeFrameTiming(
+        vsync_start_times[0], build_delay, build_duration, raster_duration));
+    FrameSchedulingStats stats = animator->GetFrameSchedulingStats();
+    ASSERT_EQ(stats.frames, 1u);
+    ASSERT_EQ(stats.delayed_frames, 1u);
+    ASSERT_EQ(stats.late_frames, 0u);
+
+    animator.reset();
+  });
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -280,6 +280,17 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.enable_software_rendering =
       command_line.HasOption(FlagForSwitch(Switch::EnableSoftwareRendering));
 
+  if (command_line.HasOption(FlagForSwitch(Switch::SoftwareRasterTiles))) {
+    std::string software_raster_tiles;
+    command_line.GetOptionValue(FlagForSwitch(Switch::SoftwareRasterTiles),
+                                &software_raster_tiles);
+    settings.software_raster_tile_count =
+        std::max(std::stoi(software_raster_tiles), 1);
+  }
+
+  settings.enable_pointer_resampling =
+      command_line.HasOption(FlagForSwitch(Switch::EnablePointerResampling));
+
   settings.endless_trace_buffer =
       command_line.HasOption(FlagForSwitch(Switch::EndlessTraceBuffer));
 
@@ -304,6 +315,9 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.trace_systrace =
       command_line.HasOption(FlagForSwitch(Switch::TraceSystrace));
 
+  command_line.GetOptionValue(FlagForSwitch(Switch::TraceToFile),
+                              &settings.trace_to_file);
+
   settings.skia_deterministic_rendering_on_cpu =
       command_line.HasOption(FlagForSwitch(Switch::SkiaDeterministicRendering));
 
@@ -381,6 +395,41 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.enable_skparagraph =
       command_line.HasOption(FlagForSwitch(Switch::EnableSkParagraph));
 
+  settings.enable_display_list =
+      command_line.HasOption(FlagForSwitch(Switch::EnableDisplayList));
+
+  settings.enable_canvas_command_buffer =
+      command_line.HasOption(FlagForSwitch(Switch::EnableCanvasCommandBuffer));
+
+  settings.enable_mailbox_pipeline =
+      command_line.HasOption(FlagForSwitch(Switch::EnableMailboxPipeline));
+
+  settings.enable_latency_aware_frame_scheduling = command_line.HasOption(
+      FlagForSwitch(Switch::EnableLatencyAwareFrameScheduling));
+
+  settings.enable_persistent_raster_cache = command_line.HasOption(
+      FlagForSwitch(Switch::EnablePersistentRasterCache));
+
+  settings.enable_shader_cache_file =
+      command_line.HasOption(FlagForSwitch(Switch::EnableShaderCacheFile));
+
+  if (command_line.HasOption(FlagForSwitch(Switch::RasterCacheMaxBytes))) {
+    std::string raster_cache_max_bytes;
+    command_line.GetOptionValue(FlagForSwitch(Switch::RasterCacheMaxBytes),
+                                &raster_cache_max_bytes);
+    settings.raster_cache_max_bytes = std::stoull(raster_cache_max_bytes);
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::RasterCacheMaxUnusedFrames))) {
+    std::string raster_cache_max_unused_frames;
+    command_line.GetOptionValue(
+        FlagForSwitch(Switch::RasterCacheMaxUnusedFrames),
+        &raster_cache_max_unused_frames);
+    settings.raster_cache_max_unused_frames =
+        std::stoull(raster_cache_max_unused_frames);
+  }
+
   std::string all_dart_flags;
   if (command_line.GetOptionValue(FlagForSwitch(Switch::DartFlags),
                                   &all_dart_flags)) {
@@ -101,6 +101,17 @@ DEF_SWITCH(EnableSoftwareRendering,
            "Enable rendering using the Skia software backend. This is useful "
            "when testing Flutter on emulators. By default, Flutter will "
            "attempt to either use OpenGL, Metal, or Vulkan.")
+DEF_SWITCH(SoftwareRasterTiles,
+           "software-raster-tiles",
+           "The number of horizontal bands the Skia software backend "
+           "rasterizes each frame in, in parallel. Defaults to 1, which "
+           "rasterizes frames on the raster thread alone.")
+DEF_SWITCH(EnablePointerResampling,
+           "enable-pointer-resampling",
+           "Dispatch at most one move event per pointer and per frame to the "
+           "framework, at a position resampled to the frame, rather than "
+           "every event the platform reports. Smooths scrolls with high rate "
+           "or irregularly reporting touchscreens and mice.")
 DEF_SWITCH(SkiaDeterministicRendering,
            "skia-deterministic-rendering",
            "Skips the call to SkGraphics::Init(), thus avoiding swapping out "
@@ -161,6 +172,11 @@ DEF_SWITCH(
     "Trace to the system tracer (instead of the timeline) on platforms where "
     "such a tracer is available. Currently only supported on Android and "
     "Fuchsia.")
+DEF_SWITCH(TraceToFile,
+           "trace-to-file",
+           "Record trace events into the file at the given path instead of "
+           "sending them to the timeline. The file uses the JSON format of "
+           "Chrome's trace viewer and can be opened in Perfetto.")
 DEF_SWITCH(UseTestFonts,
            "use-test-fonts",
            "Running tests that layout and measure text will not yield "
@@ -205,6 +221,44 @@ DEF_SWITCH(OldGenHeapSize,
 DEF_SWITCH(EnableSkParagraph,
            "enable-skparagraph",
            "Selects the SkParagraph implementation of the text layout engine.")
+DEF_SWITCH(EnableDisplayList,
+           "enable-display-list",
+           "Record pictures as engine display lists instead of Skia pictures, "
+           "so that pictures recorded again with the same contents are "
+           "recognized by the layer tree diffing and the raster cache.")
+DEF_SWITCH(EnableCanvasCommandBuffer,
+           "enable-canvas-command-buffer",
+           "Batch the drawing calls made on a Dart canvas and send them to "
+           "the engine in one call per picture, instead of one call per "
+           "drawing call.")
+DEF_SWITCH(EnablePersistentRasterCache,
+           "enable-persistent-raster-cache",
+           "Store pictures cached by the raster cache on disk and restore "
+           "them on later launches instead of rasterizing them again.")
+DEF_SWITCH(RasterCacheMaxBytes,
+           "raster-cache-max-bytes",
+           "The budget in bytes for the images cached by the raster cache. "
+           "The least recently used images are evicted first when it is "
+           "exceeded. The cache size is not limited by default.")
+DEF_SWITCH(RasterCacheMaxUnusedFrames,
+           "raster-cache-max-unused-frames",
+           "The number of consecutive frames an image cached by the raster "
+           "cache may go unused and still be retained while the cache is "
+           "within its budget. Defaults to 0.")
+DEF_SWITCH(EnableShaderCacheFile,
+           "enable-shader-cache-file",
+           "Keep the persistent shader cache in a single indexed file instead "
+           "of one file per shader.")
+DEF_SWITCH(EnableMailboxPipeline,
+           "enable-mailbox-pipeline",
+           "Always rasterize the newest frame. Frames the raster thread has "
+           "not started on yet are replaced by newer ones instead of being "
+           "queued.")
+DEF_SWITCH(EnableLatencyAwareFrameScheduling,
+           "enable-latency-aware-frame-scheduling",
+           "Start building each frame as late in the frame interval as the "
+           "durations of recent frames allow for it to be presented on time, "
+           "so that it handles the input received in the meantime.")
 
 DEF_SWITCHES_END
 
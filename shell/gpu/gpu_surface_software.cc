@@ -4,16 +4,59 @@
 
 #include "flutter/shell/gpu/gpu_surface_software.h"
 
+#include <algorithm>
 #include <memory>
+
 #include "flutter/fml/logging.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/utils/SkNoDrawCanvas.h"
 
 namespace flutter {
 
+namespace {
+
+// Plays back a picture without drawing it to find out whether it has save
+// layers with a backdrop filter.
+class BackdropFilterDetector final : public SkNoDrawCanvas {
+ public:
+  explicit BackdropFilterDetector(const SkIRect& bounds)
+      : SkNoDrawCanvas(bounds) {}
+
+  bool has_backdrop_filter() const { return has_backdrop_filter_; }
+
+ protected:
+  SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec& rec) override {
+    has_backdrop_filter_ |= rec.fBackdrop != nullptr;
+    return kNoLayer_SaveLayerStrategy;
+  }
+
+ private:
+  bool has_backdrop_filter_ = false;
+};
+
+bool HasBackdropFilter(const SkPicture& picture, const SkIRect& bounds) {
+  TRACE_EVENT0("flutter", "GPUSurfaceSoftware::HasBackdropFilter");
+  BackdropFilterDetector detector(bounds);
+  picture.playback(&detector);
+  return detector.has_backdrop_filter();
+}
+
+}  // namespace
+
 GPUSurfaceSoftware::GPUSurfaceSoftware(GPUSurfaceSoftwareDelegate* delegate,
-                                       bool render_to_surface)
+                                       bool render_to_surface,
+                                       size_t raster_tile_count)
     : delegate_(delegate),
       render_to_surface_(render_to_surface),
-      weak_factory_(this) {}
+      raster_tile_count_(std::max<size_t>(raster_tile_count, 1)),
+      weak_factory_(this) {
+  if (raster_tile_count_ > 1) {
+    raster_workers_ =
+        fml::ConcurrentMessageLoop::Create(raster_tile_count_ - 1);
+  }
+}
 
 GPUSurfaceSoftware::~GPUSurfaceSoftware() = default;
 
@@ -56,20 +99,132 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
   SkCanvas* canvas = backing_store->getCanvas();
   canvas->resetMatrix();
 
+  // When rasterizing in tiles, the frame is recorded and only replayed into
+  // the backing store once it is submitted.
+  std::shared_ptr<SkPictureRecorder> recorder;
+  if (raster_tile_count_ > 1) {
+    recorder = std::make_shared<SkPictureRecorder>();
+    recorder->beginRecording(SkRect::Make(size));
+  }
+
   SurfaceFrame::SubmitCallback on_submit =
-      [self = weak_factory_.GetWeakPtr()](const SurfaceFrame& surface_frame,
-                                          SkCanvas* canvas) -> bool {
+      [self = weak_factory_.GetWeakPtr(), recorder](
+          const SurfaceFrame& surface_frame, SkCanvas* canvas) -> bool {
     // If the surface itself went away, there is nothing more to do.
     if (!self || !self->IsValid() || canvas == nullptr) {
       return false;
     }
 
-    canvas->flush();
+    sk_sp<SkSurface> backing_store = surface_frame.SkiaSurface();
+    if (recorder) {
+      sk_sp<SkPicture> picture = recorder->finishRecordingAsPicture();
+      RasterizeInTiles(*picture, *backing_store, self->raster_tile_count_,
+                       *self->raster_workers_->GetTaskRunner());
+    } else {
+      canvas->flush();
+    }
+
+    const uint32_t generation_id = backing_store->generationID();
+    const auto& frame_damage = surface_frame.submit_info().frame_damage;
+    bool presented =
+        frame_damage ? self->delegate_->PresentBackingStoreRegion(
+                           std::move(backing_store), frame_damage.value())
+                     : self->delegate_->PresentBackingStore(
+                           std::move(backing_store));
+    self->OnBackingStorePresented(presented ? generation_id : 0,
+                                  frame_damage);
+    return presented;
+  };
+
+  auto frame = std::make_unique<SurfaceFrame>(backing_store, true, on_submit);
+  if (recorder) {
+    frame->set_canvas(recorder->getRecordingCanvas());
+  }
+  SurfaceFrame::FramebufferInfo framebuffer_info;
+  framebuffer_info.supports_partial_repaint = true;
+  framebuffer_info.existing_damage =
+      GetExistingDamage(backing_store->generationID());
+  frame->set_framebuffer_info(framebuffer_info);
+  return frame;
+}
+
+std::optional<SkIRect> GPUSurfaceSoftware::GetExistingDamage(
+    uint32_t generation_id) const {
+  for (const auto& presented : presented_backing_stores_) {
+    if (presented.generation_id == generation_id) {
+      return presented.damage;
+    }
+  }
+  return std::nullopt;
+}
+
+void GPUSurfaceSoftware::OnBackingStorePresented(
+    uint32_t generation_id,
+    const std::optional<SkIRect>& frame_damage) {
+  // The contents of the other backing stores are unknown relative to a frame
+  // that was not presented or that changed as a whole.
+  if (generation_id == 0 || !frame_damage) {
+    presented_backing_stores_.clear();
+  } else {
+    for (auto& presented : presented_backing_stores_) {
+      presented.damage.join(frame_damage.value());
+    }
+  }
+  if (generation_id == 0) {
+    return;
+  }
+  presented_backing_stores_.push_back({generation_id, SkIRect::MakeEmpty()});
+  if (presented_backing_stores_.size() > kMaxPresentedBackingStoreCount) {
+    presented_backing_stores_.pop_front();
+  }
+}
 
-    return self->delegate_->PresentBackingStore(surface_frame.SkiaSurface());
+void GPUSurfaceSoftware::RasterizeInTiles(const SkPicture& picture,
+                                          SkSurface& surface,
+                                          size_t tile_count,
+                                          fml::ConcurrentTaskRunner& workers) {
+  TRACE_EVENT0("flutter", "GPUSurfaceSoftware::RasterizeInTiles");
+  surface.notifyContentWillChange(SkSurface::kRetain_ContentChangeMode);
+  SkPixmap pixmap;
+  // A backdrop filter reads back the pixels under it, which may belong to
+  // other bands.
+  if (!surface.peekPixels(&pixmap) ||
+      HasBackdropFilter(picture, pixmap.bounds())) {
+    surface.getCanvas()->drawPicture(&picture);
+    return;
+  }
+
+  const int height = pixmap.height();
+  const int band_count =
+      std::max(std::min(static_cast<int>(tile_count), height), 1);
+  const SkSurfaceProps& props = surface.props();
+  auto draw_band = [&picture, &pixmap, &props, height,
+                    band_count](int index) {
+    TRACE_EVENT0("flutter", "GPUSurfaceSoftware::DrawBand");
+    const int top = height * index / band_count;
+    const int bottom = height * (index + 1) / band_count;
+    SkPixmap band;
+    if (!pixmap.extractSubset(
+            &band, SkIRect::MakeLTRB(0, top, pixmap.width(), bottom))) {
+      return;
+    }
+    std::unique_ptr<SkCanvas> canvas = SkCanvas::MakeRasterDirect(
+        band.info(), band.writable_addr(), band.rowBytes(), &props);
+    canvas->translate(0, -top);
+    canvas->drawPicture(&picture);
   };
 
-  return std::make_unique<SurfaceFrame>(backing_store, true, on_submit);
+  fml::CountDownLatch latch(band_count - 1);
+  for (int i = 1; i < band_count; i++) {
+    workers.PostTaskWithPriority(
+        [&draw_band, &latch, i]() {
+          draw_band(i);
+          latch.CountDown();
+        },
+        fml::ConcurrentTaskPriority::kHigh);
+  }
+  draw_band(0);
+  latch.Wait();
 }
 
 // |Surface|
@@ -5,17 +5,38 @@
 #ifndef FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_H_
 #define FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_H_
 
+#include <deque>
+#include <memory>
+#include <optional>
+
 #include "flutter/flow/surface.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/shell/gpu/gpu_surface_software_delegate.h"
+#include "third_party/skia/include/core/SkPicture.h"
 
 namespace flutter {
 
 class GPUSurfaceSoftware : public Surface {
  public:
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a surface that rasterizes frames into the software
+  ///             backing stores of the delegate.
+  ///
+  /// @param[in]  delegate           The platform surface.
+  /// @param[in]  render_to_surface  Whether frames are rendered into the
+  ///                                backing store at all.
+  /// @param[in]  raster_tile_count  If greater than 1, frames are recorded
+  ///                                and then replayed into that many
+  ///                                horizontal bands of the backing store in
+  ///                                parallel, one of them on the raster
+  ///                                thread and the others on workers owned
+  ///                                by the surface.
+  ///
   GPUSurfaceSoftware(GPUSurfaceSoftwareDelegate* delegate,
-                     bool render_to_surface);
+                     bool render_to_surface,
+                     size_t raster_tile_count = 1);
 
   ~GPUSurfaceSoftware() override;
 
@@ -31,6 +52,20 @@ class GPUSurfaceSoftware : public Surface {
   // |Surface|
   GrDirectContext* GetContext() override;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Draws |picture| into |surface| split into |tile_count|
+  ///             horizontal bands, all but one of which are drawn by
+  ///             |workers|. Returns once all the bands have been drawn.
+  ///
+  ///             Pictures with a backdrop filter are drawn in a single band,
+  ///             as the filter reads back pixels across the edges of the
+  ///             bands.
+  ///
+  static void RasterizeInTiles(const SkPicture& picture,
+                               SkSurface& surface,
+                               size_t tile_count,
+                               fml::ConcurrentTaskRunner& workers);
+
  private:
   GPUSurfaceSoftwareDelegate* delegate_;
   // TODO(38466): Refactor GPU surface APIs take into account the fact that an
@@ -38,8 +73,29 @@ class GPUSurfaceSoftware : public Surface {
   // hack to make avoid allocating resources for the root surface when an
   // external view embedder is present.
   const bool render_to_surface_;
+  const size_t raster_tile_count_;
+  // Draws all the bands but one when frames are rasterized in tiles.
+  std::shared_ptr<fml::ConcurrentMessageLoop> raster_workers_;
+  // The backing stores presented recently, by the generation ID they had when
+  // they were presented, along with the region in which they differ from the
+  // last presented frame. If the backing store acquired for the next frame
+  // still has the same generation ID, only that region and the damage of the
+  // next frame need to be repainted. Platforms that hand out a ring of
+  // backing stores get each of them back a few frames later.
+  struct PresentedBackingStore {
+    uint32_t generation_id;
+    SkIRect damage;
+  };
+  std::deque<PresentedBackingStore> presented_backing_stores_;
   fml::TaskRunnerAffineWeakPtrFactory<GPUSurfaceSoftware> weak_factory_;
 
+  static constexpr size_t kMaxPresentedBackingStoreCount = 4;
+
+  std::optional<SkIRect> GetExistingDamage(uint32_t generation_id) const;
+
+  void OnBackingStorePresented(uint32_t generation_id,
+                               const std::optional<SkIRect>& frame_damage);
+
   FML_DISALLOW_COPY_AND_ASSIGN(GPUSurfaceSoftware);
 };
 
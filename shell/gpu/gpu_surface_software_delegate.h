@@ -48,6 +48,25 @@ class GPUSurfaceSoftwareDelegate {
   ///             the screen.
   ///
   virtual bool PresentBackingStore(sk_sp<SkSurface> backing_store) = 0;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Called instead of `PresentBackingStore` when the region of
+  ///             the backing store that changed since the last presented
+  ///             frame is known. Platforms that can present part of the
+  ///             backing store may override this. By default, the whole
+  ///             backing store is presented.
+  ///
+  /// @param[in]  backing_store  The software backing store to present.
+  /// @param[in]  damage         The region of the backing store that changed
+  ///                            since the last presented frame.
+  ///
+  /// @return     Returns if the platform could present the backing store onto
+  ///             the screen.
+  ///
+  virtual bool PresentBackingStoreRegion(sk_sp<SkSurface> backing_store,
+                                         const SkIRect& damage) {
+    return PresentBackingStore(std::move(backing_store));
+  }
 };
 
 }  // namespace flutter
@@ -16,7 +16,9 @@
 namespace flutter {
 
 // Implementation of ByteStreamReader base on a byte array.
-class ByteBufferStreamReader : public ByteStreamReader {
+//
+// Final so that the codecs read from it without virtual calls.
+class ByteBufferStreamReader final : public ByteStreamReader {
  public:
   // Createa a reader reading from |bytes|, which must have a length of |size|.
   // |bytes| must remain valid for the lifetime of this object.
@@ -62,7 +64,9 @@ class ByteBufferStreamReader : public ByteStreamReader {
 };
 
 // Implementation of ByteStreamWriter based on a byte array.
-class ByteBufferStreamWriter : public ByteStreamWriter {
+//
+// Final so that the codecs write to it without virtual calls.
+class ByteBufferStreamWriter final : public ByteStreamWriter {
  public:
   // Creates a writer that writes into |buffer|.
   // |buffer| must remain valid for the lifetime of this object.
@@ -74,16 +78,16 @@ class ByteBufferStreamWriter : public ByteStreamWriter {
   virtual ~ByteBufferStreamWriter() = default;
 
   // |ByteStreamWriter|
-  void WriteByte(uint8_t byte) { bytes_->push_back(byte); }
+  void WriteByte(uint8_t byte) override { bytes_->push_back(byte); }
 
   // |ByteStreamWriter|
-  void WriteBytes(const uint8_t* bytes, size_t length) {
+  void WriteBytes(const uint8_t* bytes, size_t length) override {
     assert(length > 0);
     bytes_->insert(bytes_->end(), bytes, bytes + length);
   }
 
   // |ByteStreamWriter|
-  void WriteAlignment(uint8_t alignment) {
+  void WriteAlignment(uint8_t alignment) override {
     uint8_t mod = bytes_->size() % alignment;
     if (mod) {
       for (int i = 0; i < alignment - mod; ++i) {
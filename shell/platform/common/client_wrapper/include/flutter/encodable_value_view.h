@@ -0,0 +1,310 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_ENCODABLE_VALUE_VIEW_H_
+#define FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_ENCODABLE_VALUE_VIEW_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "encodable_value.h"
+
+namespace flutter {
+
+// A read-only view of |size| contiguous values of type |T| that are owned
+// elsewhere, typically by the buffer of a message.
+template <typename T>
+class EncodableSpan {
+ public:
+  EncodableSpan() = default;
+  EncodableSpan(const T* data, size_t size) : data_(data), size_(size) {}
+
+  const T* data() const { return data_; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  const T* begin() const { return data_; }
+  const T* end() const { return data_ + size_; }
+
+  const T& operator[](size_t index) const {
+    assert(index < size_);
+    return data_[index];
+  }
+
+ private:
+  const T* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+// A read-only view of a value of a message decoded with
+// StandardMessageCodec::DecodeMessageView.
+//
+// Unlike EncodableValue, strings and typed lists are not copied out of the
+// message: they are exposed as views of the bytes of the message, which must
+// outlive the view. Lists and maps are not materialized either, their items
+// are visited in the order of the message.
+//
+// For example, reading the arguments {'name': 'Thing', 'values': Float64List}
+// of a message:
+//   for (const auto& [key, value] : view.MapEntries()) {
+//     if (key.StringValue() == "name") {
+//       std::string_view name = value.StringValue();
+//     } else if (key.StringValue() == "values") {
+//       EncodableSpan<double> values = value.Float64ListValue();
+//     }
+//   }
+//
+// Calling an accessor that doesn't match the type of the value is an error;
+// it asserts in debug builds and returns an empty value otherwise.
+class EncodableValueView {
+ public:
+  // The types of values, which map to the alternatives of EncodableValue.
+  enum class Type {
+    kNull,
+    kBool,
+    kInt32,
+    kInt64,
+    kDouble,
+    kString,
+    kUInt8List,
+    kInt32List,
+    kInt64List,
+    kFloat64List,
+    kList,
+    kMap,
+  };
+
+  // A decoded value. Values are stored in the order of the message, each
+  // list or map followed by its items, so that a value and the values it
+  // contains are contiguous.
+  struct Node {
+    Type type;
+    // The number of nodes of the value, including the values it contains.
+    size_t node_count;
+    // The number of items of a list or entries of a map, or the number of
+    // elements of a string or typed list.
+    size_t size;
+    union {
+      bool bool_value;
+      int32_t int32_value;
+      int64_t int64_value;
+      double double_value;
+      // The first element of a string or typed list, in the message.
+      const uint8_t* data;
+    };
+  };
+
+  // Iterates over consecutive values, skipping the values they contain.
+  class Iterator {
+   public:
+    explicit Iterator(const Node* node) : node_(node) {}
+
+    EncodableValueView operator*() const { return EncodableValueView(node_); }
+
+    Iterator& operator++() {
+      node_ += node_->node_count;
+      return *this;
+    }
+
+    bool operator==(const Iterator& other) const {
+      return node_ == other.node_;
+    }
+    bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+   private:
+    const Node* node_;
+  };
+
+  // Iterates over the keys and values of a map.
+  class MapIterator {
+   public:
+    explicit MapIterator(const Node* node) : node_(node) {}
+
+    std::pair<EncodableValueView, EncodableValueView> operator*() const {
+      return {EncodableValueView(node_),
+              EncodableValueView(node_ + node_->node_count)};
+    }
+
+    MapIterator& operator++() {
+      const Node* value = node_ + node_->node_count;
+      node_ = value + value->node_count;
+      return *this;
+    }
+
+    bool operator==(const MapIterator& other) const {
+      return node_ == other.node_;
+    }
+    bool operator!=(const MapIterator& other) const {
+      return !(*this == other);
+    }
+
+   private:
+    const Node* node_;
+  };
+
+  // A range for use in range-based for loops.
+  template <typename I>
+  class Range {
+   public:
+    Range(I begin, I end) : begin_(begin), end_(end) {}
+
+    I begin() const { return begin_; }
+    I end() const { return end_; }
+
+   private:
+    I begin_;
+    I end_;
+  };
+
+  explicit EncodableValueView(const Node* node) : node_(node) {}
+
+  Type type() const { return node_->type; }
+
+  bool IsNull() const { return type() == Type::kNull; }
+
+  bool BoolValue() const {
+    return CheckType(Type::kBool) && node_->bool_value;
+  }
+
+  int32_t Int32Value() const {
+    return CheckType(Type::kInt32) ? node_->int32_value : 0;
+  }
+
+  int64_t Int64Value() const {
+    return CheckType(Type::kInt64) ? node_->int64_value : 0;
+  }
+
+  // Like EncodableValue::LongValue, returns either an int32 or an int64 value
+  // since both are an int in Dart.
+  int64_t LongValue() const {
+    return type() == Type::kInt32 ? node_->int32_value : Int64Value();
+  }
+
+  double DoubleValue() const {
+    return CheckType(Type::kDouble) ? node_->double_value : 0.0;
+  }
+
+  std::string_view StringValue() const {
+    if (!CheckType(Type::kString)) {
+      return {};
+    }
+    return std::string_view(reinterpret_cast<const char*>(node_->data),
+                            node_->size);
+  }
+
+  EncodableSpan<uint8_t> UInt8ListValue() const {
+    return ListValue<uint8_t>(Type::kUInt8List);
+  }
+
+  EncodableSpan<int32_t> Int32ListValue() const {
+    return ListValue<int32_t>(Type::kInt32List);
+  }
+
+  EncodableSpan<int64_t> Int64ListValue() const {
+    return ListValue<int64_t>(Type::kInt64List);
+  }
+
+  EncodableSpan<double> Float64ListValue() const {
+    return ListValue<double>(Type::kFloat64List);
+  }
+
+  // The number of items of a list, entries of a map or elements of a string
+  // or typed list.
+  size_t size() const { return node_->size; }
+
+  // The items of a list.
+  Range<Iterator> ListItems() const {
+    if (!CheckType(Type::kList)) {
+      return {Iterator(node_), Iterator(node_)};
+    }
+    return {Iterator(node_ + 1), Iterator(node_ + node_->node_count)};
+  }
+
+  // The keys and values of a map.
+  Range<MapIterator> MapEntries() const {
+    if (!CheckType(Type::kMap)) {
+      return {MapIterator(node_), MapIterator(node_)};
+    }
+    return {MapIterator(node_ + 1), MapIterator(node_ + node_->node_count)};
+  }
+
+  // Returns the value of the first entry of a map whose key is the string
+  // |key|, if any.
+  std::optional<EncodableValueView> FindValue(std::string_view key) const {
+    for (const auto& [entry_key, entry_value] : MapEntries()) {
+      if (entry_key.type() == Type::kString && entry_key.StringValue() == key) {
+        return entry_value;
+      }
+    }
+    return std::nullopt;
+  }
+
+  // Returns a copy of the value that doesn't depend on the message.
+  EncodableValue ToEncodableValue() const;
+
+ private:
+  const Node* node_;
+
+  bool CheckType(Type type) const {
+    assert(node_->type == type);
+    return node_->type == type;
+  }
+
+  template <typename T>
+  EncodableSpan<T> ListValue(Type type) const {
+    if (!CheckType(type)) {
+      return {};
+    }
+    return EncodableSpan<T>(reinterpret_cast<const T*>(node_->data),
+                            node_->size);
+  }
+};
+
+// A message decoded with StandardMessageCodec::DecodeMessageView, whose values
+// are views of the message. The message must outlive it and the values read
+// from it.
+//
+// A decoded message can be reused for the next message, in which case
+// decoding doesn't allocate memory unless the next message has more values.
+class EncodableMessageView {
+ public:
+  EncodableMessageView() = default;
+  ~EncodableMessageView() = default;
+
+  // Prevent copying.
+  EncodableMessageView(EncodableMessageView const&) = delete;
+  EncodableMessageView& operator=(EncodableMessageView const&) = delete;
+
+  // Decodes the value at the start of |message|, which must have a length of
+  // |message_size|, replacing the values of the previous message. Returns
+  // false if the message is malformed.
+  //
+  // Typed lists are exposed in place, so |message| must be aligned to
+  // 8 bytes like the messages received from the engine are. Only the types
+  // of the standard codec are supported; messages using the extension types
+  // of a custom serializer fail to decode.
+  bool Decode(const uint8_t* message, size_t message_size);
+
+  // The number of bytes of the message that were decoded.
+  size_t decoded_size() const { return decoded_size_; }
+
+  // The decoded value. Must only be called after a successful decode.
+  EncodableValueView value() const {
+    assert(!nodes_.empty());
+    return EncodableValueView(nodes_.data());
+  }
+
+ private:
+  std::vector<EncodableValueView::Node> nodes_;
+  size_t decoded_size_ = 0;
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_ENCODABLE_VALUE_VIEW_H_
@@ -56,19 +56,6 @@ class StandardCodecSerializer {
 
   // Writes the variable-length size encoding to |stream|.
   void WriteSize(size_t size, ByteStreamWriter* stream) const;
-
- private:
-  // Reads a fixed-type list whose values are of type T from the current
-  // position in |stream|, and returns it as the corresponding EncodableValue.
-  // |T| must correspond to one of the supported list value types of
-  // EncodableValue.
-  template <typename T>
-  EncodableValue ReadVector(ByteStreamReader* stream) const;
-
-  // Writes |vector| to |stream| as a fixed-type list. |T| must correspond to
-  // one of the supported list value types of EncodableValue.
-  template <typename T>
-  void WriteVector(const std::vector<T> vector, ByteStreamWriter* stream) const;
 };
 
 }  // namespace flutter
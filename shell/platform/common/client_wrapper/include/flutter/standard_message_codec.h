@@ -8,6 +8,7 @@
 #include <memory>
 
 #include "encodable_value.h"
+#include "encodable_value_view.h"
 #include "message_codec.h"
 #include "standard_codec_serializer.h"
 
@@ -35,6 +36,17 @@ class StandardMessageCodec : public MessageCodec<EncodableValue> {
   StandardMessageCodec(StandardMessageCodec const&) = delete;
   StandardMessageCodec& operator=(StandardMessageCodec const&) = delete;
 
+  // Decodes |binary_message|, which must have a length of |message_size|, into
+  // |view| without copying its strings and typed lists. The message must
+  // outlive |view| and the values read from it. Returns false if the message
+  // is malformed.
+  //
+  // Only the types of the standard codec are supported, regardless of the
+  // serializer of the codec. See EncodableMessageView for details.
+  bool DecodeMessageView(const uint8_t* binary_message,
+                         size_t message_size,
+                         EncodableMessageView* view) const;
+
  protected:
   // |flutter::MessageCodec|
   std::unique_ptr<EncodableValue> DecodeMessageInternal(
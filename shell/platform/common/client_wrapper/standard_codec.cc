@@ -7,10 +7,12 @@
 // together to simplify use of the client wrapper, since the common case is
 // that any client that needs one of these files needs all three.
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <iostream>
 #include <map>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -75,26 +77,153 @@ EncodedType EncodedTypeForValue(const EncodableValue& value) {
   return EncodedType::kNull;
 }
 
-}  // namespace
+// The encoding of the standard types, shared by StandardCodecSerializer and by
+// the fast path used when a codec has no extension types. |Reader| and
+// |Writer| are either ByteStreamReader and ByteStreamWriter, or the final
+// ByteBufferStreamReader and ByteBufferStreamWriter in which case the calls to
+// the streams aren't virtual.
+
+template <typename T, typename Reader>
+T ReadFixed(Reader* stream) {
+  T value = 0;
+  stream->ReadBytes(reinterpret_cast<uint8_t*>(&value), sizeof(T));
+  return value;
+}
 
-StandardCodecSerializer::StandardCodecSerializer() = default;
+template <typename T, typename Writer>
+void WriteFixed(T value, Writer* stream) {
+  stream->WriteBytes(reinterpret_cast<const uint8_t*>(&value), sizeof(T));
+}
 
-StandardCodecSerializer::~StandardCodecSerializer() = default;
+template <typename Reader>
+size_t ReadSizeFrom(Reader* stream) {
+  uint8_t byte = stream->ReadByte();
+  if (byte < 254) {
+    return byte;
+  } else if (byte == 254) {
+    return ReadFixed<uint16_t>(stream);
+  } else {
+    return ReadFixed<uint32_t>(stream);
+  }
+}
 
-const StandardCodecSerializer& StandardCodecSerializer::GetInstance() {
-  static StandardCodecSerializer sInstance;
-  return sInstance;
-};
+template <typename Writer>
+void WriteSizeTo(size_t size, Writer* stream) {
+  if (size < 254) {
+    stream->WriteByte(static_cast<uint8_t>(size));
+  } else if (size <= 0xffff) {
+    stream->WriteByte(254);
+    WriteFixed(static_cast<uint16_t>(size), stream);
+  } else {
+    stream->WriteByte(255);
+    WriteFixed(static_cast<uint32_t>(size), stream);
+  }
+}
 
-EncodableValue StandardCodecSerializer::ReadValue(
-    ByteStreamReader* stream) const {
-  uint8_t type = stream->ReadByte();
-  return ReadValueOfType(type, stream);
+// Reads a fixed-type list whose values are of type T from the current
+// position in |stream|, and returns it as the corresponding EncodableValue.
+// |T| must correspond to one of the supported list value types of
+// EncodableValue.
+template <typename T, typename Reader>
+EncodableValue ReadVector(Reader* stream) {
+  size_t count = ReadSizeFrom(stream);
+  std::vector<T> vector;
+  vector.resize(count);
+  uint8_t type_size = static_cast<uint8_t>(sizeof(T));
+  if (type_size > 1) {
+    stream->ReadAlignment(type_size);
+  }
+  stream->ReadBytes(reinterpret_cast<uint8_t*>(vector.data()),
+                    count * type_size);
+  return EncodableValue(vector);
 }
 
-void StandardCodecSerializer::WriteValue(const EncodableValue& value,
-                                         ByteStreamWriter* stream) const {
-  stream->WriteByte(static_cast<uint8_t>(EncodedTypeForValue(value)));
+// Writes |vector| to |stream| as a fixed-type list. |T| must correspond to
+// one of the supported list value types of EncodableValue.
+template <typename T, typename Writer>
+void WriteVector(const std::vector<T>& vector, Writer* stream) {
+  size_t count = vector.size();
+  WriteSizeTo(count, stream);
+  // Empty lists are padded too, as ReadVector and the Dart codec expect.
+  uint8_t type_size = static_cast<uint8_t>(sizeof(T));
+  if (type_size > 1) {
+    stream->WriteAlignment(type_size);
+  }
+  if (count == 0) {
+    return;
+  }
+  stream->WriteBytes(reinterpret_cast<const uint8_t*>(vector.data()),
+                     count * type_size);
+}
+
+// Reads a value of the standard type |type| from |stream|, calling
+// |read_value| to read the items of lists and maps. Returns std::nullopt if
+// |type| isn't a standard type.
+template <typename Reader, typename ReadValue>
+std::optional<EncodableValue> ReadValueOfStandardType(
+    uint8_t type,
+    Reader* stream,
+    const ReadValue& read_value) {
+  switch (static_cast<EncodedType>(type)) {
+    case EncodedType::kNull:
+      return EncodableValue();
+    case EncodedType::kTrue:
+      return EncodableValue(true);
+    case EncodedType::kFalse:
+      return EncodableValue(false);
+    case EncodedType::kInt32:
+      return EncodableValue(ReadFixed<int32_t>(stream));
+    case EncodedType::kInt64:
+      return EncodableValue(ReadFixed<int64_t>(stream));
+    case EncodedType::kFloat64:
+      stream->ReadAlignment(8);
+      return EncodableValue(ReadFixed<double>(stream));
+    case EncodedType::kLargeInt:
+    case EncodedType::kString: {
+      size_t size = ReadSizeFrom(stream);
+      std::string string_value;
+      string_value.resize(size);
+      stream->ReadBytes(reinterpret_cast<uint8_t*>(&string_value[0]), size);
+      return EncodableValue(string_value);
+    }
+    case EncodedType::kUInt8List:
+      return ReadVector<uint8_t>(stream);
+    case EncodedType::kInt32List:
+      return ReadVector<int32_t>(stream);
+    case EncodedType::kInt64List:
+      return ReadVector<int64_t>(stream);
+    case EncodedType::kFloat64List:
+      return ReadVector<double>(stream);
+    case EncodedType::kList: {
+      size_t length = ReadSizeFrom(stream);
+      EncodableList list_value;
+      list_value.reserve(length);
+      for (size_t i = 0; i < length; ++i) {
+        list_value.push_back(read_value(stream));
+      }
+      return EncodableValue(list_value);
+    }
+    case EncodedType::kMap: {
+      size_t length = ReadSizeFrom(stream);
+      EncodableMap map_value;
+      for (size_t i = 0; i < length; ++i) {
+        EncodableValue key = read_value(stream);
+        EncodableValue value = read_value(stream);
+        map_value.emplace(std::move(key), std::move(value));
+      }
+      return EncodableValue(map_value);
+    }
+  }
+  return std::nullopt;
+}
+
+// Writes the encoding of |value| to |stream|, excluding the type
+// discrimination byte, calling |write_value| to write the items of lists and
+// maps.
+template <typename Writer, typename WriteValue>
+void WriteValueContents(const EncodableValue& value,
+                        Writer* stream,
+                        const WriteValue& write_value) {
   // TODO: Consider replacing this this with a std::visitor.
   switch (value.index()) {
     case 0:
@@ -102,19 +231,19 @@ void StandardCodecSerializer::WriteValue(const EncodableValue& value,
       // Null and bool are encoded directly in the type.
       break;
     case 2:
-      stream->WriteInt32(std::get<int32_t>(value));
+      WriteFixed(std::get<int32_t>(value), stream);
       break;
     case 3:
-      stream->WriteInt64(std::get<int64_t>(value));
+      WriteFixed(std::get<int64_t>(value), stream);
       break;
     case 4:
       stream->WriteAlignment(8);
-      stream->WriteDouble(std::get<double>(value));
+      WriteFixed(std::get<double>(value), stream);
       break;
     case 5: {
       const auto& string_value = std::get<std::string>(value);
       size_t size = string_value.size();
-      WriteSize(size, stream);
+      WriteSizeTo(size, stream);
       if (size > 0) {
         stream->WriteBytes(
             reinterpret_cast<const uint8_t*>(string_value.data()), size);
@@ -135,18 +264,18 @@ void StandardCodecSerializer::WriteValue(const EncodableValue& value,
       break;
     case 10: {
       const auto& list = std::get<EncodableList>(value);
-      WriteSize(list.size(), stream);
+      WriteSizeTo(list.size(), stream);
       for (const auto& item : list) {
-        WriteValue(item, stream);
+        write_value(item, stream);
       }
       break;
     }
     case 11: {
       const auto& map = std::get<EncodableMap>(value);
-      WriteSize(map.size(), stream);
+      WriteSizeTo(map.size(), stream);
       for (const auto& pair : map) {
-        WriteValue(pair.first, stream);
-        WriteValue(pair.second, stream);
+        write_value(pair.first, stream);
+        write_value(pair.second, stream);
       }
       break;
     }
@@ -158,123 +287,368 @@ void StandardCodecSerializer::WriteValue(const EncodableValue& value,
   }
 }
 
+void PrintUnknownType(uint8_t type) {
+  std::cerr << "Unknown type in StandardCodecSerializer::ReadValueOfType: "
+            << static_cast<int>(type) << std::endl;
+}
+
+// Reads a value of a standard type without virtual calls.
+EncodableValue ReadStandardValue(ByteBufferStreamReader* stream) {
+  uint8_t type = stream->ReadByte();
+  auto value = ReadValueOfStandardType(
+      type, stream,
+      [](ByteBufferStreamReader* nested) { return ReadStandardValue(nested); });
+  if (!value) {
+    PrintUnknownType(type);
+    return EncodableValue();
+  }
+  return std::move(*value);
+}
+
+// Writes a value of a standard type without virtual calls.
+void WriteStandardValue(const EncodableValue& value,
+                        ByteBufferStreamWriter* stream) {
+  stream->WriteByte(static_cast<uint8_t>(EncodedTypeForValue(value)));
+  WriteValueContents(
+      value, stream,
+      [](const EncodableValue& item, ByteBufferStreamWriter* nested) {
+        WriteStandardValue(item, nested);
+      });
+}
+
+// Whether |serializer| is the one without extension types, whose values can
+// be read and written without virtual calls.
+bool IsStandardSerializer(const StandardCodecSerializer* serializer) {
+  return serializer == &StandardCodecSerializer::GetInstance();
+}
+
+EncodableValue ReadValue(const StandardCodecSerializer* serializer,
+                         ByteBufferStreamReader* stream) {
+  return IsStandardSerializer(serializer) ? ReadStandardValue(stream)
+                                          : serializer->ReadValue(stream);
+}
+
+void WriteValue(const StandardCodecSerializer* serializer,
+                const EncodableValue& value,
+                ByteBufferStreamWriter* stream) {
+  if (IsStandardSerializer(serializer)) {
+    WriteStandardValue(value, stream);
+  } else {
+    serializer->WriteValue(value, stream);
+  }
+}
+
+}  // namespace
+
+StandardCodecSerializer::StandardCodecSerializer() = default;
+
+StandardCodecSerializer::~StandardCodecSerializer() = default;
+
+const StandardCodecSerializer& StandardCodecSerializer::GetInstance() {
+  static StandardCodecSerializer sInstance;
+  return sInstance;
+};
+
+EncodableValue StandardCodecSerializer::ReadValue(
+    ByteStreamReader* stream) const {
+  uint8_t type = stream->ReadByte();
+  return ReadValueOfType(type, stream);
+}
+
+void StandardCodecSerializer::WriteValue(const EncodableValue& value,
+                                         ByteStreamWriter* stream) const {
+  stream->WriteByte(static_cast<uint8_t>(EncodedTypeForValue(value)));
+  WriteValueContents(
+      value, stream,
+      [this](const EncodableValue& item, ByteStreamWriter* nested) {
+        WriteValue(item, nested);
+      });
+}
+
 EncodableValue StandardCodecSerializer::ReadValueOfType(
     uint8_t type,
     ByteStreamReader* stream) const {
+  auto value = ReadValueOfStandardType(
+      type, stream,
+      [this](ByteStreamReader* nested) { return ReadValue(nested); });
+  if (!value) {
+    PrintUnknownType(type);
+    return EncodableValue();
+  }
+  return std::move(*value);
+}
+
+size_t StandardCodecSerializer::ReadSize(ByteStreamReader* stream) const {
+  return ReadSizeFrom(stream);
+}
+
+void StandardCodecSerializer::WriteSize(size_t size,
+                                        ByteStreamWriter* stream) const {
+  WriteSizeTo(size, stream);
+}
+
+// ===== encodable_value_view.h =====
+
+namespace {
+
+using Node = EncodableValueView::Node;
+using Type = EncodableValueView::Type;
+
+// Reads the values of a message into the nodes of an EncodableMessageView,
+// checking that they are within the message.
+class ViewDecoder {
+ public:
+  ViewDecoder(const uint8_t* bytes, size_t size, std::vector<Node>* nodes)
+      : bytes_(bytes), size_(size), nodes_(nodes) {}
+
+  // Reads the next value and the values it contains.
+  bool ReadValue();
+
+  size_t location() const { return std::min(location_, size_); }
+
+ private:
+  const uint8_t* bytes_;
+  size_t size_;
+  std::vector<Node>* nodes_;
+  size_t location_ = 0;
+
+  size_t remaining() const {
+    return location_ < size_ ? size_ - location_ : 0;
+  }
+
+  bool ReadBytes(size_t length, const uint8_t** bytes) {
+    if (length > remaining()) {
+      std::cerr << "Invalid read in EncodableMessageView::Decode" << std::endl;
+      return false;
+    }
+    *bytes = bytes_ + location_;
+    location_ += length;
+    return true;
+  }
+
+  template <typename T>
+  bool ReadFixed(T* value) {
+    const uint8_t* bytes;
+    if (!ReadBytes(sizeof(T), &bytes)) {
+      return false;
+    }
+    std::memcpy(value, bytes, sizeof(T));
+    return true;
+  }
+
+  bool ReadSize(size_t* size) {
+    uint8_t byte;
+    if (!ReadFixed(&byte)) {
+      return false;
+    }
+    if (byte < 254) {
+      *size = byte;
+      return true;
+    } else if (byte == 254) {
+      uint16_t value;
+      bool read = ReadFixed(&value);
+      *size = value;
+      return read;
+    } else {
+      uint32_t value;
+      bool read = ReadFixed(&value);
+      *size = value;
+      return read;
+    }
+  }
+
+  void ReadAlignment(uint8_t alignment) {
+    uint8_t mod = location_ % alignment;
+    if (mod) {
+      location_ += alignment - mod;
+    }
+  }
+
+  template <typename T>
+  bool ReadTypedList(Node* node) {
+    if (!ReadSize(&node->size)) {
+      return false;
+    }
+    // Aligned relative to the start of the message, like ReadVector.
+    if (sizeof(T) > 1) {
+      ReadAlignment(sizeof(T));
+    }
+    if (node->size > remaining() / sizeof(T)) {
+      std::cerr << "Invalid read in EncodableMessageView::Decode" << std::endl;
+      return false;
+    }
+    if (node->size == 0) {
+      // Older encoders write no padding for empty lists, so the message may
+      // end before the alignment.
+      node->data = nullptr;
+      return true;
+    }
+    node->data = bytes_ + location_;
+    if (reinterpret_cast<uintptr_t>(node->data) % alignof(T) != 0) {
+      std::cerr << "Typed list is not aligned in EncodableMessageView::Decode"
+                << std::endl;
+      return false;
+    }
+    location_ += node->size * sizeof(T);
+    return true;
+  }
+};
+
+bool ViewDecoder::ReadValue() {
+  uint8_t type;
+  if (!ReadFixed(&type)) {
+    return false;
+  }
+  // Items are appended after the node, which may move it.
+  const size_t index = nodes_->size();
+  nodes_->emplace_back();
+  Node node = {};
+  node.node_count = 1;
   switch (static_cast<EncodedType>(type)) {
     case EncodedType::kNull:
-      return EncodableValue();
+      node.type = Type::kNull;
+      break;
     case EncodedType::kTrue:
-      return EncodableValue(true);
     case EncodedType::kFalse:
-      return EncodableValue(false);
+      node.type = Type::kBool;
+      node.bool_value = static_cast<EncodedType>(type) == EncodedType::kTrue;
+      break;
     case EncodedType::kInt32:
-      return EncodableValue(stream->ReadInt32());
+      node.type = Type::kInt32;
+      if (!ReadFixed(&node.int32_value)) {
+        return false;
+      }
+      break;
     case EncodedType::kInt64:
-      return EncodableValue(stream->ReadInt64());
+      node.type = Type::kInt64;
+      if (!ReadFixed(&node.int64_value)) {
+        return false;
+      }
+      break;
     case EncodedType::kFloat64:
-      stream->ReadAlignment(8);
-      return EncodableValue(stream->ReadDouble());
+      node.type = Type::kDouble;
+      ReadAlignment(8);
+      if (!ReadFixed(&node.double_value)) {
+        return false;
+      }
+      break;
     case EncodedType::kLargeInt:
-    case EncodedType::kString: {
-      size_t size = ReadSize(stream);
-      std::string string_value;
-      string_value.resize(size);
-      stream->ReadBytes(reinterpret_cast<uint8_t*>(&string_value[0]), size);
-      return EncodableValue(string_value);
-    }
+    case EncodedType::kString:
+      node.type = Type::kString;
+      if (!ReadSize(&node.size) || !ReadBytes(node.size, &node.data)) {
+        return false;
+      }
+      break;
     case EncodedType::kUInt8List:
-      return ReadVector<uint8_t>(stream);
+      node.type = Type::kUInt8List;
+      if (!ReadTypedList<uint8_t>(&node)) {
+        return false;
+      }
+      break;
     case EncodedType::kInt32List:
-      return ReadVector<int32_t>(stream);
+      node.type = Type::kInt32List;
+      if (!ReadTypedList<int32_t>(&node)) {
+        return false;
+      }
+      break;
     case EncodedType::kInt64List:
-      return ReadVector<int64_t>(stream);
+      node.type = Type::kInt64List;
+      if (!ReadTypedList<int64_t>(&node)) {
+        return false;
+      }
+      break;
     case EncodedType::kFloat64List:
-      return ReadVector<double>(stream);
-    case EncodedType::kList: {
-      size_t length = ReadSize(stream);
+      node.type = Type::kFloat64List;
+      if (!ReadTypedList<double>(&node)) {
+        return false;
+      }
+      break;
+    case EncodedType::kList:
+    case EncodedType::kMap: {
+      const bool is_map = static_cast<EncodedType>(type) == EncodedType::kMap;
+      node.type = is_map ? Type::kMap : Type::kList;
+      if (!ReadSize(&node.size)) {
+        return false;
+      }
+      const size_t value_count = is_map ? node.size * 2 : node.size;
+      for (size_t i = 0; i < value_count; ++i) {
+        if (!ReadValue()) {
+          return false;
+        }
+      }
+      node.node_count = nodes_->size() - index;
+      break;
+    }
+    default:
+      PrintUnknownType(type);
+      return false;
+  }
+  (*nodes_)[index] = node;
+  return true;
+}
+
+}  // namespace
+
+EncodableValue EncodableValueView::ToEncodableValue() const {
+  switch (type()) {
+    case Type::kNull:
+      return EncodableValue();
+    case Type::kBool:
+      return EncodableValue(node_->bool_value);
+    case Type::kInt32:
+      return EncodableValue(node_->int32_value);
+    case Type::kInt64:
+      return EncodableValue(node_->int64_value);
+    case Type::kDouble:
+      return EncodableValue(node_->double_value);
+    case Type::kString:
+      return EncodableValue(std::string(StringValue()));
+    case Type::kUInt8List: {
+      auto list = UInt8ListValue();
+      return EncodableValue(std::vector<uint8_t>(list.begin(), list.end()));
+    }
+    case Type::kInt32List: {
+      auto list = Int32ListValue();
+      return EncodableValue(std::vector<int32_t>(list.begin(), list.end()));
+    }
+    case Type::kInt64List: {
+      auto list = Int64ListValue();
+      return EncodableValue(std::vector<int64_t>(list.begin(), list.end()));
+    }
+    case Type::kFloat64List: {
+      auto list = Float64ListValue();
+      return EncodableValue(std::vector<double>(list.begin(), list.end()));
+    }
+    case Type::kList: {
       EncodableList list_value;
-      list_value.reserve(length);
-      for (size_t i = 0; i < length; ++i) {
-        list_value.push_back(ReadValue(stream));
+      list_value.reserve(size());
+      for (const auto& item : ListItems()) {
+        list_value.push_back(item.ToEncodableValue());
       }
       return EncodableValue(list_value);
     }
-    case EncodedType::kMap: {
-      size_t length = ReadSize(stream);
+    case Type::kMap: {
       EncodableMap map_value;
-      for (size_t i = 0; i < length; ++i) {
-        EncodableValue key = ReadValue(stream);
-        EncodableValue value = ReadValue(stream);
-        map_value.emplace(std::move(key), std::move(value));
+      for (const auto& [key, value] : MapEntries()) {
+        map_value.emplace(key.ToEncodableValue(), value.ToEncodableValue());
       }
       return EncodableValue(map_value);
     }
   }
-  std::cerr << "Unknown type in StandardCodecSerializer::ReadValueOfType: "
-            << static_cast<int>(type) << std::endl;
   return EncodableValue();
 }
 
-size_t StandardCodecSerializer::ReadSize(ByteStreamReader* stream) const {
-  uint8_t byte = stream->ReadByte();
-  if (byte < 254) {
-    return byte;
-  } else if (byte == 254) {
-    uint16_t value;
-    stream->ReadBytes(reinterpret_cast<uint8_t*>(&value), 2);
-    return value;
-  } else {
-    uint32_t value;
-    stream->ReadBytes(reinterpret_cast<uint8_t*>(&value), 4);
-    return value;
-  }
-}
-
-void StandardCodecSerializer::WriteSize(size_t size,
-                                        ByteStreamWriter* stream) const {
-  if (size < 254) {
-    stream->WriteByte(static_cast<uint8_t>(size));
-  } else if (size <= 0xffff) {
-    stream->WriteByte(254);
-    uint16_t value = static_cast<uint16_t>(size);
-    stream->WriteBytes(reinterpret_cast<uint8_t*>(&value), 2);
-  } else {
-    stream->WriteByte(255);
-    uint32_t value = static_cast<uint32_t>(size);
-    stream->WriteBytes(reinterpret_cast<uint8_t*>(&value), 4);
-  }
-}
-
-template <typename T>
-EncodableValue StandardCodecSerializer::ReadVector(
-    ByteStreamReader* stream) const {
-  size_t count = ReadSize(stream);
-  std::vector<T> vector;
-  vector.resize(count);
-  uint8_t type_size = static_cast<uint8_t>(sizeof(T));
-  if (type_size > 1) {
-    stream->ReadAlignment(type_size);
-  }
-  stream->ReadBytes(reinterpret_cast<uint8_t*>(vector.data()),
-                    count * type_size);
-  return EncodableValue(vector);
-}
-
-template <typename T>
-void StandardCodecSerializer::WriteVector(const std::vector<T> vector,
-                                          ByteStreamWriter* stream) const {
-  size_t count = vector.size();
-  WriteSize(count, stream);
-  if (count == 0) {
-    return;
+bool EncodableMessageView::Decode(const uint8_t* message,
+                                  size_t message_size) {
+  nodes_.clear();
+  ViewDecoder decoder(message, message_size, &nodes_);
+  if (!decoder.ReadValue()) {
+    nodes_.clear();
+    decoded_size_ = 0;
+    return false;
   }
-  uint8_t type_size = static_cast<uint8_t>(sizeof(T));
-  if (type_size > 1) {
-    stream->WriteAlignment(type_size);
-  }
-  stream->WriteBytes(reinterpret_cast<const uint8_t*>(vector.data()),
-                     count * type_size);
+  decoded_size_ = decoder.location();
+  return true;
 }
 
 // ===== standard_message_codec.h =====
@@ -309,7 +683,14 @@ std::unique_ptr<EncodableValue> StandardMessageCodec::DecodeMessageInternal(
     const uint8_t* binary_message,
     size_t message_size) const {
   ByteBufferStreamReader stream(binary_message, message_size);
-  return std::make_unique<EncodableValue>(serializer_->ReadValue(&stream));
+  return std::make_unique<EncodableValue>(ReadValue(serializer_, &stream));
+}
+
+bool StandardMessageCodec::DecodeMessageView(
+    const uint8_t* binary_message,
+    size_t message_size,
+    EncodableMessageView* view) const {
+  return view->Decode(binary_message, message_size);
 }
 
 std::unique_ptr<std::vector<uint8_t>>
@@ -317,7 +698,7 @@ StandardMessageCodec::EncodeMessageInternal(
     const EncodableValue& message) const {
   auto encoded = std::make_unique<std::vector<uint8_t>>();
   ByteBufferStreamWriter stream(encoded.get());
-  serializer_->WriteValue(message, &stream);
+  WriteValue(serializer_, message, &stream);
   return encoded;
 }
 
@@ -353,7 +734,7 @@ std::unique_ptr<MethodCall<EncodableValue>>
 StandardMethodCodec::DecodeMethodCallInternal(const uint8_t* message,
                                               size_t message_size) const {
   ByteBufferStreamReader stream(message, message_size);
-  EncodableValue method_name_value = serializer_->ReadValue(&stream);
+  EncodableValue method_name_value = ReadValue(serializer_, &stream);
   const auto* method_name = std::get_if<std::string>(&method_name_value);
   if (!method_name) {
     std::cerr << "Invalid method call; method name is not a string."
@@ -361,7 +742,7 @@ StandardMethodCodec::DecodeMethodCallInternal(const uint8_t* message,
     return nullptr;
   }
   auto arguments =
-      std::make_unique<EncodableValue>(serializer_->ReadValue(&stream));
+      std::make_unique<EncodableValue>(ReadValue(serializer_, &stream));
   return std::make_unique<MethodCall<EncodableValue>>(*method_name,
                                                       std::move(arguments));
 }
@@ -371,11 +752,11 @@ StandardMethodCodec::EncodeMethodCallInternal(
     const MethodCall<EncodableValue>& method_call) const {
   auto encoded = std::make_unique<std::vector<uint8_t>>();
   ByteBufferStreamWriter stream(encoded.get());
-  serializer_->WriteValue(EncodableValue(method_call.method_name()), &stream);
+  WriteValue(serializer_, EncodableValue(method_call.method_name()), &stream);
   if (method_call.arguments()) {
-    serializer_->WriteValue(*method_call.arguments(), &stream);
+    WriteValue(serializer_, *method_call.arguments(), &stream);
   } else {
-    serializer_->WriteValue(EncodableValue(), &stream);
+    WriteValue(serializer_, EncodableValue(), &stream);
   }
   return encoded;
 }
@@ -387,9 +768,9 @@ StandardMethodCodec::EncodeSuccessEnvelopeInternal(
   ByteBufferStreamWriter stream(encoded.get());
   stream.WriteByte(0);
   if (result) {
-    serializer_->WriteValue(*result, &stream);
+    WriteValue(serializer_, *result, &stream);
   } else {
-    serializer_->WriteValue(EncodableValue(), &stream);
+    WriteValue(serializer_, EncodableValue(), &stream);
   }
   return encoded;
 }
@@ -402,16 +783,16 @@ StandardMethodCodec::EncodeErrorEnvelopeInternal(
   auto encoded = std::make_unique<std::vector<uint8_t>>();
   ByteBufferStreamWriter stream(encoded.get());
   stream.WriteByte(1);
-  serializer_->WriteValue(EncodableValue(error_code), &stream);
+  WriteValue(serializer_, EncodableValue(error_code), &stream);
   if (error_message.empty()) {
-    serializer_->WriteValue(EncodableValue(), &stream);
+    WriteValue(serializer_, EncodableValue(), &stream);
   } else {
-    serializer_->WriteValue(EncodableValue(error_message), &stream);
+    WriteValue(serializer_, EncodableValue(error_message), &stream);
   }
   if (error_details) {
-    serializer_->WriteValue(*error_details, &stream);
+    WriteValue(serializer_, *error_details, &stream);
   } else {
-    serializer_->WriteValue(EncodableValue(), &stream);
+    WriteValue(serializer_, EncodableValue(), &stream);
   }
   return encoded;
 }
@@ -424,7 +805,7 @@ bool StandardMethodCodec::DecodeAndProcessResponseEnvelopeInternal(
   uint8_t flag = stream.ReadByte();
   switch (flag) {
     case 0: {
-      EncodableValue value = serializer_->ReadValue(&stream);
+      EncodableValue value = ReadValue(serializer_, &stream);
       if (value.IsNull()) {
         result->Success();
       } else {
@@ -433,9 +814,9 @@ bool StandardMethodCodec::DecodeAndProcessResponseEnvelopeInternal(
       return true;
     }
     case 1: {
-      EncodableValue code = serializer_->ReadValue(&stream);
-      EncodableValue message = serializer_->ReadValue(&stream);
-      EncodableValue details = serializer_->ReadValue(&stream);
+      EncodableValue code = ReadValue(serializer_, &stream);
+      EncodableValue message = ReadValue(serializer_, &stream);
+      EncodableValue details = ReadValue(serializer_, &stream);
       const std::string& message_string =
           message.IsNull() ? "" : std::get<std::string>(message);
       if (details.IsNull()) {
@@ -0,0 +1,101 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/common/client_wrapper/include/flutter/encodable_value_view.h"
+#include "flutter/shell/platform/common/client_wrapper/include/flutter/standard_message_codec.h"
+
+namespace flutter {
+
+// A message with a large typed list, like the buffers sent by plugins
+// streaming sensor or audio data.
+static std::vector<uint8_t> EncodeTypedListMessage(size_t length) {
+  EncodableMap arguments = {
+      {EncodableValue("id"), EncodableValue(42)},
+      {EncodableValue("samples"),
+       EncodableValue(std::vector<double>(length, 0.5))},
+      {EncodableValue("bytes"),
+       EncodableValue(std::vector<uint8_t>(length, 0x7f))},
+  };
+  return *StandardMessageCodec::GetInstance().EncodeMessage(
+      EncodableValue(arguments));
+}
+
+// A message with |depth| levels of maps of small values, like the trees of
+// semantics or settings sent by frameworks.
+static std::vector<uint8_t> EncodeNestedMessage(size_t depth) {
+  EncodableValue value("leaf");
+  for (size_t i = 0; i < depth; ++i) {
+    EncodableMap map = {
+        {EncodableValue("name"), EncodableValue("node " + std::to_string(i))},
+        {EncodableValue("index"), EncodableValue(static_cast<int32_t>(i))},
+        {EncodableValue("flags"), EncodableValue(EncodableList{
+                                      EncodableValue(true),
+                                      EncodableValue(1.0),
+                                  })},
+        {EncodableValue("child"), value},
+    };
+    value = EncodableValue(map);
+  }
+  return *StandardMessageCodec::GetInstance().EncodeMessage(value);
+}
+
+static void DecodeMessage(benchmark::State& state,
+                          const std::vector<uint8_t>& message) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(codec.DecodeMessage(message));
+  }
+  state.SetBytesProcessed(state.iterations() * message.size());
+}
+
+static void DecodeMessageView(benchmark::State& state,
+                              const std::vector<uint8_t>& message) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  EncodableMessageView view;
+  while (state.KeepRunning()) {
+    bool decoded =
+        codec.DecodeMessageView(message.data(), message.size(), &view);
+    benchmark::DoNotOptimize(decoded);
+  }
+  state.SetBytesProcessed(state.iterations() * message.size());
+}
+
+static void BM_StandardCodecDecodeTypedList(benchmark::State& state) {
+  DecodeMessage(state, EncodeTypedListMessage(state.range(0)));
+}
+
+static void BM_StandardCodecDecodeTypedListView(benchmark::State& state) {
+  DecodeMessageView(state, EncodeTypedListMessage(state.range(0)));
+}
+
+static void BM_StandardCodecDecodeNested(benchmark::State& state) {
+  DecodeMessage(state, EncodeNestedMessage(state.range(0)));
+}
+
+static void BM_StandardCodecDecodeNestedView(benchmark::State& state) {
+  DecodeMessageView(state, EncodeNestedMessage(state.range(0)));
+}
+
+BENCHMARK(BM_StandardCodecDecodeTypedList)
+    ->RangeMultiplier(8)
+    ->Range(1 << 6, 1 << 18)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StandardCodecDecodeTypedListView)
+    ->RangeMultiplier(8)
+    ->Range(1 << 6, 1 << 18)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StandardCodecDecodeNested)
+    ->RangeMultiplier(4)
+    ->Range(1 << 2, 1 << 8)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StandardCodecDecodeNestedView)
+    ->RangeMultiplier(4)
+    ->Range(1 << 2, 1 << 8)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace flutter
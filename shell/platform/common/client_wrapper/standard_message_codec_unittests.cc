@@ -4,7 +4,10 @@
 
 #include "flutter/shell/platform/common/client_wrapper/include/flutter/standard_message_codec.h"
 
+#include <cstring>
 #include <map>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "flutter/shell/platform/common/client_wrapper/testing/test_codec_extensions.h"
@@ -219,4 +222,143 @@ TEST(StandardMessageCodec, CanEncodeAndDecodeVariableLengthCustomType) {
                     some_data_comparator);
 }
 
+TEST(StandardMessageCodec, CanDecodeMessageView) {
+  EncodableValue value(EncodableMap{
+      {EncodableValue("name"), EncodableValue("thing")},
+      {EncodableValue("values"),
+       EncodableValue(std::vector<double>{1.5, -2.0, 3.25})},
+      {EncodableValue("bytes"), EncodableValue(std::vector<uint8_t>{1, 2, 3})},
+      {EncodableValue("list"), EncodableValue(EncodableList{
+                                   EncodableValue(),
+                                   EncodableValue(true),
+                                   EncodableValue(7),
+                                   EncodableValue(int64_t{1} << 40),
+                                   EncodableValue(0.5),
+                                   EncodableValue(EncodableList{}),
+                               })},
+  });
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  auto encoded = codec.EncodeMessage(value);
+  ASSERT_TRUE(encoded);
+
+  EncodableMessageView view;
+  ASSERT_TRUE(codec.DecodeMessageView(encoded->data(), encoded->size(), &view));
+  EXPECT_EQ(view.decoded_size(), encoded->size());
+  EncodableValueView root = view.value();
+  EXPECT_EQ(root.type(), EncodableValueView::Type::kMap);
+  EXPECT_EQ(root.size(), 4u);
+
+  const uint8_t* begin = encoded->data();
+  const uint8_t* end = begin + encoded->size();
+
+  auto name = root.FindValue("name");
+  ASSERT_TRUE(name);
+  EXPECT_EQ(name->StringValue(), "thing");
+  auto name_data = reinterpret_cast<const uint8_t*>(name->StringValue().data());
+  EXPECT_TRUE(name_data >= begin && name_data < end);
+
+  auto values = root.FindValue("values");
+  ASSERT_TRUE(values);
+  EncodableSpan<double> doubles = values->Float64ListValue();
+  EXPECT_EQ(std::vector<double>(doubles.begin(), doubles.end()),
+            std::vector<double>({1.5, -2.0, 3.25}));
+  auto doubles_data = reinterpret_cast<const uint8_t*>(doubles.data());
+  EXPECT_TRUE(doubles_data >= begin && doubles_data < end);
+
+  auto bytes = root.FindValue("bytes");
+  ASSERT_TRUE(bytes);
+  EXPECT_EQ(bytes->UInt8ListValue().size(), 3u);
+  EXPECT_EQ(bytes->UInt8ListValue()[2], 3);
+
+  auto list = root.FindValue("list");
+  ASSERT_TRUE(list);
+  std::vector<EncodableValueView::Type> types;
+  for (const auto& item : list->ListItems()) {
+    types.push_back(item.type());
+  }
+  EXPECT_EQ(types, std::vector<EncodableValueView::Type>({
+                       EncodableValueView::Type::kNull,
+                       EncodableValueView::Type::kBool,
+                       EncodableValueView::Type::kInt32,
+                       EncodableValueView::Type::kInt64,
+                       EncodableValueView::Type::kDouble,
+                       EncodableValueView::Type::kList,
+                   }));
+
+  EXPECT_FALSE(root.FindValue("missing"));
+  EXPECT_EQ(root.ToEncodableValue(), value);
+}
+
+TEST(StandardMessageCodec, MessageViewMatchesDecodedMessage) {
+  EncodableValue value(EncodableList{
+      EncodableValue(std::vector<int32_t>{-1, 2}),
+      EncodableValue(std::vector<int64_t>{int64_t{1} << 40}),
+      EncodableValue(EncodableMap{
+          {EncodableValue(1), EncodableValue(EncodableList{
+                                  EncodableValue("nested"),
+                                  EncodableValue(std::vector<double>{0.25}),
+                              })},
+      }),
+      EncodableValue(std::string(300, 'a')),
+      EncodableValue(std::vector<int32_t>{}),
+      EncodableValue(true),
+      EncodableValue(std::vector<double>{}),
+  });
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  auto encoded = codec.EncodeMessage(value);
+  ASSERT_TRUE(encoded);
+
+  EncodableMessageView view;
+  ASSERT_TRUE(codec.DecodeMessageView(encoded->data(), encoded->size(), &view));
+  EXPECT_EQ(view.value().ToEncodableValue(), *codec.DecodeMessage(*encoded));
+  EXPECT_EQ(view.value().ToEncodableValue(), value);
+
+  // Empty lists that end the message without the padding older encoders did
+  // not write, in a buffer aligned like the ones messages arrive in.
+  std::vector<std::pair<std::vector<uint8_t>, EncodableValue>> unpadded = {
+      {{0x0b, 0x00}, EncodableValue(std::vector<double>{})},
+      {{0x09, 0x00}, EncodableValue(std::vector<int32_t>{})},
+      {{0x0c, 0x02, 0x01, 0x0b, 0x00},
+       EncodableValue(EncodableList{EncodableValue(true),
+                                    EncodableValue(std::vector<double>{})})},
+  };
+  for (const auto& [message, expected] : unpadded) {
+    std::vector<double> aligned_buffer(message.size() / sizeof(double) + 1);
+    std::memcpy(aligned_buffer.data(), message.data(), message.size());
+    const uint8_t* bytes =
+        reinterpret_cast<const uint8_t*>(aligned_buffer.data());
+    ASSERT_TRUE(codec.DecodeMessageView(bytes, message.size(), &view));
+    EXPECT_EQ(view.value().ToEncodableValue(), expected);
+    EXPECT_EQ(view.value().ToEncodableValue(), *codec.DecodeMessage(message));
+    EXPECT_EQ(view.decoded_size(), message.size());
+  }
+}
+
+TEST(StandardMessageCodec, MessageViewFailsOnMalformedMessages) {
+  EncodableValue value(EncodableMap{
+      {EncodableValue("values"),
+       EncodableValue(std::vector<double>{1.0, 2.0})},
+      {EncodableValue("name"), EncodableValue("thing")},
+  });
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  auto encoded = codec.EncodeMessage(value);
+  ASSERT_TRUE(encoded);
+
+  EncodableMessageView view;
+  for (size_t size = 0; size < encoded->size(); ++size) {
+    EXPECT_FALSE(codec.DecodeMessageView(encoded->data(), size, &view))
+        << "Decoded a message truncated to " << size << " bytes";
+  }
+
+  // An unknown type.
+  std::vector<uint8_t> unknown_type = {0x80, 0x00};
+  EXPECT_FALSE(
+      codec.DecodeMessageView(unknown_type.data(), unknown_type.size(), &view));
+
+  // A list claiming more items than the message has.
+  std::vector<uint8_t> long_list = {0x0c, 0xfe, 0xff, 0xff, 0x00};
+  EXPECT_FALSE(
+      codec.DecodeMessageView(long_list.data(), long_list.size(), &view));
+}
+
 }  // namespace flutter
@@ -0,0 +1,18 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/common/text_editing_delta.h"
+
+#include <codecvt>
+#include <locale>
+
+namespace flutter {
+
+std::string TextEditingDelta::delta_text_utf8() const {
+  std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>
+      utf8_converter;
+  return utf8_converter.to_bytes(delta_text_);
+}
+
+}  // namespace flutter
@@ -0,0 +1,78 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_COMMON_TEXT_EDITING_DELTA_H_
+#define FLUTTER_SHELL_PLATFORM_COMMON_TEXT_EDITING_DELTA_H_
+
+#include <optional>
+#include <string>
+
+#include "flutter/shell/platform/common/text_range.h"
+
+namespace flutter {
+
+// A single change to the text of a |TextInputModel|.
+//
+// The UTF-16 code units in |range| of the text before the change, which were
+// |replaced_text|, were replaced with |delta_text|. Insertions have a
+// collapsed range and deletions have empty |delta_text|.
+class TextEditingDelta {
+ public:
+  TextEditingDelta(const TextRange& range,
+                   std::u16string delta_text,
+                   std::u16string replaced_text)
+      : range_(range),
+        delta_text_(std::move(delta_text)),
+        replaced_text_(std::move(replaced_text)) {}
+
+  TextEditingDelta(const TextEditingDelta&) = default;
+  TextEditingDelta& operator=(const TextEditingDelta&) = default;
+
+  // The replaced range of the text before the change.
+  const TextRange& range() const { return range_; }
+
+  // The text that replaced |range|.
+  const std::u16string& delta_text() const { return delta_text_; }
+
+  // The text that replaced |range| as UTF-8.
+  std::string delta_text_utf8() const;
+
+  // The text in |range| before the change.
+  const std::u16string& replaced_text() const { return replaced_text_; }
+
+  // The selection after the change, and after any change of the selection
+  // made before the next change of the text.
+  const TextRange& selection() const { return selection_; }
+
+  // The composing range at the same time as |selection|, or std::nullopt if
+  // the model was not composing.
+  const std::optional<TextRange>& composing_range() const {
+    return composing_range_;
+  }
+
+  // Sets the selection and composing range after the change.
+  void SetState(const TextRange& selection,
+                const std::optional<TextRange>& composing_range) {
+    selection_ = selection;
+    composing_range_ = composing_range;
+  }
+
+  bool operator==(const TextEditingDelta& other) const {
+    return range_ == other.range_ && delta_text_ == other.delta_text_ &&
+           replaced_text_ == other.replaced_text_ &&
+           selection_ == other.selection_ &&
+           composing_range_ == other.composing_range_;
+  }
+
+ private:
+  TextRange range_;
+  std::u16string delta_text_;
+  std::u16string replaced_text_;
+  TextRange selection_ = TextRange(0);
+  std::optional<TextRange> composing_range_;
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PLATFORM_COMMON_TEXT_EDITING_DELTA_H_
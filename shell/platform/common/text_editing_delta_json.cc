@@ -0,0 +1,85 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/common/text_editing_delta_json.h"
+
+#include <optional>
+#include <string>
+
+static constexpr char kComposingBaseKey[] = "composingBase";
+static constexpr char kComposingExtentKey[] = "composingExtent";
+static constexpr char kSelectionAffinityKey[] = "selectionAffinity";
+static constexpr char kAffinityDownstream[] = "TextAffinity.downstream";
+static constexpr char kSelectionBaseKey[] = "selectionBase";
+static constexpr char kSelectionExtentKey[] = "selectionExtent";
+static constexpr char kSelectionIsDirectionalKey[] = "selectionIsDirectional";
+static constexpr char kDeltasKey[] = "deltas";
+static constexpr char kOldTextKey[] = "oldText";
+static constexpr char kDeltaTextKey[] = "deltaText";
+static constexpr char kDeltaStartKey[] = "deltaStart";
+static constexpr char kDeltaEndKey[] = "deltaEnd";
+
+namespace flutter {
+
+std::unique_ptr<rapidjson::Document> TakeEditingStateWithDeltas(
+    int client_id,
+    TextInputModel& model) {
+  auto args = std::make_unique<rapidjson::Document>(rapidjson::kArrayType);
+  auto& allocator = args->GetAllocator();
+  args->PushBack(client_id, allocator);
+
+  std::optional<TextEditingDelta> delta = model.TakeCombinedDelta();
+  std::string old_text;
+  std::string delta_text;
+  int start = -1;
+  int end = -1;
+  TextRange selection = model.selection();
+  std::optional<TextRange> composing_range;
+  if (delta) {
+    old_text = model.GetTextBeforeDelta(*delta);
+    delta_text = delta->delta_text_utf8();
+    start = static_cast<int>(delta->range().start());
+    end = static_cast<int>(delta->range().end());
+    selection = delta->selection();
+    composing_range = delta->composing_range();
+  } else {
+    // Only the selection or composing range changed, which the framework
+    // represents as a delta that replaces no text.
+    old_text = model.GetText();
+    if (model.composing()) {
+      composing_range = model.composing_range();
+    }
+  }
+
+  rapidjson::Value delta_state(rapidjson::kObjectType);
+  delta_state.AddMember(kOldTextKey,
+                        rapidjson::Value(old_text, allocator).Move(),
+                        allocator);
+  delta_state.AddMember(kDeltaTextKey,
+                        rapidjson::Value(delta_text, allocator).Move(),
+                        allocator);
+  delta_state.AddMember(kDeltaStartKey, start, allocator);
+  delta_state.AddMember(kDeltaEndKey, end, allocator);
+  delta_state.AddMember(kSelectionAffinityKey, kAffinityDownstream,
+                        allocator);
+  delta_state.AddMember(kSelectionBaseKey, selection.base(), allocator);
+  delta_state.AddMember(kSelectionExtentKey, selection.extent(), allocator);
+  delta_state.AddMember(kSelectionIsDirectionalKey, false, allocator);
+  delta_state.AddMember(
+      kComposingBaseKey,
+      composing_range ? static_cast<int>(composing_range->base()) : -1,
+      allocator);
+  delta_state.AddMember(
+      kComposingExtentKey,
+      composing_range ? static_cast<int>(composing_range->extent()) : -1,
+      allocator);
+  rapidjson::Value deltas(rapidjson::kArrayType);
+  deltas.PushBack(delta_state, allocator);
+  rapidjson::Value editing_state(rapidjson::kObjectType);
+  editing_state.AddMember(kDeltasKey, deltas, allocator);
+  args->PushBack(editing_state, allocator);
+  return args;
+}
+
+}  // namespace flutter
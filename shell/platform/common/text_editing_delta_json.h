@@ -0,0 +1,29 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_COMMON_TEXT_EDITING_DELTA_JSON_H_
+#define FLUTTER_SHELL_PLATFORM_COMMON_TEXT_EDITING_DELTA_JSON_H_
+
+#include <rapidjson/document.h>
+
+#include <memory>
+
+#include "flutter/shell/platform/common/text_input_model.h"
+
+namespace flutter {
+
+// Returns the arguments of the TextInputClient.updateEditingStateWithDeltas
+// method that reports the changes made to |model| since the last call to the
+// client |client_id|.
+//
+// The changes are reported as a single delta, with the text before them
+// serialized once. If only the selection or composing range changed, the
+// delta replaces no text.
+std::unique_ptr<rapidjson::Document> TakeEditingStateWithDeltas(
+    int client_id,
+    TextInputModel& model);
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PLATFORM_COMMON_TEXT_EDITING_DELTA_JSON_H_
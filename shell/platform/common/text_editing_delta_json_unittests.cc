@@ -0,0 +1,62 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/common/text_editing_delta_json.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+
+TEST(TextEditingDeltaJson, ReportsEditsAsOneDelta) {
+  TextInputModel model;
+  model.SetText("ABCDE");
+  EXPECT_TRUE(model.SetSelection(TextRange(2)));
+  model.set_record_deltas(true);
+  model.AddText(u"xy");
+  EXPECT_TRUE(model.Backspace());
+
+  std::unique_ptr<rapidjson::Document> args =
+      TakeEditingStateWithDeltas(123, model);
+  ASSERT_TRUE(args->IsArray());
+  ASSERT_EQ(args->Size(), 2u);
+  EXPECT_EQ((*args)[0].GetInt(), 123);
+  const rapidjson::Value& deltas = (*args)[1]["deltas"];
+  ASSERT_TRUE(deltas.IsArray());
+  ASSERT_EQ(deltas.Size(), 1u);
+  const rapidjson::Value& delta = deltas[0];
+  EXPECT_STREQ(delta["oldText"].GetString(), "ABCDE");
+  EXPECT_STREQ(delta["deltaText"].GetString(), "x");
+  EXPECT_EQ(delta["deltaStart"].GetInt(), 2);
+  EXPECT_EQ(delta["deltaEnd"].GetInt(), 2);
+  EXPECT_EQ(delta["selectionBase"].GetInt(), 3);
+  EXPECT_EQ(delta["selectionExtent"].GetInt(), 3);
+  EXPECT_STREQ(delta["selectionAffinity"].GetString(),
+               "TextAffinity.downstream");
+  EXPECT_FALSE(delta["selectionIsDirectional"].GetBool());
+  EXPECT_EQ(delta["composingBase"].GetInt(), -1);
+  EXPECT_EQ(delta["composingExtent"].GetInt(), -1);
+}
+
+TEST(TextEditingDeltaJson, ReportsSelectionChangeAsDeltaWithoutText) {
+  TextInputModel model;
+  model.SetText("ABCDE");
+  model.set_record_deltas(true);
+  EXPECT_TRUE(model.SetSelection(TextRange(1, 3)));
+
+  std::unique_ptr<rapidjson::Document> args =
+      TakeEditingStateWithDeltas(123, model);
+  const rapidjson::Value& deltas = (*args)[1]["deltas"];
+  ASSERT_EQ(deltas.Size(), 1u);
+  const rapidjson::Value& delta = deltas[0];
+  EXPECT_STREQ(delta["oldText"].GetString(), "ABCDE");
+  EXPECT_STREQ(delta["deltaText"].GetString(), "");
+  EXPECT_EQ(delta["deltaStart"].GetInt(), -1);
+  EXPECT_EQ(delta["deltaEnd"].GetInt(), -1);
+  EXPECT_EQ(delta["selectionBase"].GetInt(), 1);
+  EXPECT_EQ(delta["selectionExtent"].GetInt(), 3);
+}
+
+}  // namespace flutter
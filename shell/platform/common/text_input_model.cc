@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <codecvt>
 #include <locale>
+#include <optional>
 
 #if defined(_MSC_VER)
 // TODO(naifu): This temporary code is to solve link error.(VS2015/2017)
@@ -36,7 +37,7 @@ TextInputModel::~TextInputModel() = default;
 void TextInputModel::SetText(const std::string& text) {
   std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>
       utf16_converter;
-  text_ = utf16_converter.from_bytes(text);
+  ReplaceText(0, text_.length(), utf16_converter.from_bytes(text));
   selection_ = TextRange(0);
   composing_range_ = TextRange(0);
 }
@@ -73,7 +74,7 @@ void TextInputModel::UpdateComposingText(const std::u16string& text) {
     return;
   }
   DeleteSelected();
-  text_.replace(composing_range_.start(), composing_range_.length(), text);
+  ReplaceText(composing_range_.start(), composing_range_.length(), text);
   composing_range_.set_end(composing_range_.start() + text.length());
   selection_ = TextRange(composing_range_.end());
 }
@@ -103,7 +104,7 @@ bool TextInputModel::DeleteSelected() {
     return false;
   }
   size_t start = selection_.start();
-  text_.erase(start, selection_.length());
+  ReplaceText(start, selection_.length(), u"");
   selection_ = TextRange(start);
   if (composing_) {
     // This occurs only immediately after composing has begun with a selection.
@@ -130,13 +131,16 @@ void TextInputModel::AddText(const std::u16string& text) {
   DeleteSelected();
   if (composing_) {
     // Delete the current composing text, set the cursor to composing start.
-    text_.erase(composing_range_.start(), composing_range_.length());
+    ReplaceText(composing_range_.start(), composing_range_.length(), u"");
     selection_ = TextRange(composing_range_.start());
-    composing_range_.set_end(composing_range_.start() + text.length());
+    composing_range_ = selection_;
   }
   size_t position = selection_.position();
-  text_.insert(position, text);
+  ReplaceText(position, 0, text);
   selection_ = TextRange(position + text.length());
+  if (composing_) {
+    composing_range_.set_end(position + text.length());
+  }
 }
 
 void TextInputModel::AddText(const std::string& text) {
@@ -153,7 +157,7 @@ bool TextInputModel::Backspace() {
   size_t position = selection_.position();
   if (position != editable_range().start()) {
     int count = IsTrailingSurrogate(text_.at(position - 1)) ? 2 : 1;
-    text_.erase(position - count, count);
+    ReplaceText(position - count, count, u"");
     selection_ = TextRange(position - count);
     if (composing_) {
       composing_range_.set_end(composing_range_.end() - count);
@@ -171,7 +175,7 @@ bool TextInputModel::Delete() {
   size_t position = selection_.position();
   if (position < editable_range().end()) {
     int count = IsLeadingSurrogate(text_.at(position)) ? 2 : 1;
-    text_.erase(position, count);
+    ReplaceText(position, count, u"");
     if (composing_) {
       composing_range_.set_end(composing_range_.end() - count);
     }
@@ -209,7 +213,7 @@ bool TextInputModel::DeleteSurrounding(int offset_from_cursor, int count) {
   }
 
   auto deleted_length = end - start;
-  text_.erase(start, deleted_length);
+  ReplaceText(start, deleted_length, u"");
 
   // Cursor moves only if deleted area is before it.
   selection_ = TextRange(offset_from_cursor <= 0 ? start : selection_.start());
@@ -290,18 +294,99 @@ bool TextInputModel::MoveCursorBack() {
 }
 
 std::string TextInputModel::GetText() const {
-  std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>
-      utf8_converter;
-  return utf8_converter.to_bytes(text_);
+  std::string text;
+  text_.AppendUtf8(0, text_.length(), text);
+  return text;
 }
 
 int TextInputModel::GetCursorOffset() const {
   // Measure the length of the current text up to the selection extent.
-  // There is probably a much more efficient way of doing this.
-  auto leading_text = text_.substr(0, selection_.extent());
+  return text_.Utf8Length(selection_.extent());
+}
+
+void TextInputModel::set_record_deltas(bool record_deltas) {
+  record_deltas_ = record_deltas;
+  if (!record_deltas_) {
+    deltas_.clear();
+  }
+}
+
+std::vector<TextEditingDelta> TextInputModel::TakeDeltas() {
+  UpdateLastDeltaState();
+  std::vector<TextEditingDelta> deltas;
+  std::swap(deltas, deltas_);
+  return deltas;
+}
+
+std::optional<TextEditingDelta> TextInputModel::TakeCombinedDelta() {
+  std::vector<TextEditingDelta> deltas = TakeDeltas();
+  if (deltas.empty()) {
+    return std::nullopt;
+  }
+  // Grow the range of the text changed so far, [start, end) in the text after
+  // each delta, to cover every delta.
+  size_t start = deltas[0].range().start();
+  size_t end = start;
+  for (const TextEditingDelta& delta : deltas) {
+    const size_t changed_end = std::max(end, delta.range().end());
+    start = std::min(start, delta.range().start());
+    end = changed_end - delta.range().length() + delta.delta_text().length();
+  }
+  // Undo the deltas within that range to find the text it replaced.
+  std::u16string delta_text = text_.Substr(start, end - start);
+  std::u16string replaced_text = delta_text;
+  for (size_t i = deltas.size(); i-- > 0;) {
+    const TextEditingDelta& delta = deltas[i];
+    replaced_text.replace(delta.range().start() - start,
+                          delta.delta_text().length(), delta.replaced_text());
+  }
+  if (delta_text == replaced_text) {
+    return std::nullopt;
+  }
+  const TextRange range(start, start + replaced_text.length());
+  TextEditingDelta combined(range, std::move(delta_text),
+                            std::move(replaced_text));
+  combined.SetState(deltas.back().selection(),
+                    deltas.back().composing_range());
+  return combined;
+}
+
+std::string TextInputModel::GetTextBeforeDelta(
+    const TextEditingDelta& delta) const {
   std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>
       utf8_converter;
-  return utf8_converter.to_bytes(leading_text).size();
+  const size_t start = delta.range().start();
+  const size_t end = start + delta.delta_text().length();
+  std::string text;
+  text_.AppendUtf8(0, start, text);
+  text += utf8_converter.to_bytes(delta.replaced_text());
+  text_.AppendUtf8(end, text_.length() - end, text);
+  return text;
+}
+
+void TextInputModel::UpdateLastDeltaState() {
+  if (deltas_.empty()) {
+    return;
+  }
+  std::optional<TextRange> composing_range;
+  if (composing_) {
+    composing_range = composing_range_;
+  }
+  deltas_.back().SetState(selection_, composing_range);
+}
+
+void TextInputModel::ReplaceText(size_t start,
+                                 size_t count,
+                                 const std::u16string& text) {
+  if (count == 0 && text.empty()) {
+    return;
+  }
+  if (record_deltas_) {
+    UpdateLastDeltaState();
+    deltas_.emplace_back(TextRange(start, start + count), text,
+                         text_.Substr(start, count));
+  }
+  text_.Replace(start, count, text);
 }
 
 }  // namespace flutter
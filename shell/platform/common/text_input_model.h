@@ -6,14 +6,21 @@
 #define FLUTTER_SHELL_PLATFORM_COMMON_TEXT_INPUT_MODEL_H_
 
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 
+#include "flutter/shell/platform/common/text_editing_delta.h"
 #include "flutter/shell/platform/common/text_range.h"
+#include "flutter/shell/platform/common/text_rope.h"
 
 namespace flutter {
 
 // Handles underlying text input state, using a simple ASCII model.
 //
+// The text is stored in a |TextRope|, so edits take time logarithmic in the
+// length of the text and do not copy it.
+//
 // Ignores special states like "insert mode" for now.
 class TextInputModel {
  public:
@@ -178,6 +185,30 @@ class TextInputModel {
   // GetText().
   int GetCursorOffset() const;
 
+  // Sets whether changes to the text are recorded for |TakeDeltas|.
+  //
+  // Recording is off by default. Turning it off discards recorded deltas.
+  void set_record_deltas(bool record_deltas);
+
+  // Returns the changes made to the text since the last call, in the order
+  // they were made, and clears them.
+  //
+  // Each delta carries the selection and composing range as they were right
+  // before the next change, or as they are now for the last one.
+  std::vector<TextEditingDelta> TakeDeltas();
+
+  // Returns the changes made to the text since the last call combined into a
+  // single delta, or std::nullopt if they left the text unchanged, and clears
+  // them.
+  //
+  // The framework applies a delta to the text sent with it, so a batch of
+  // changes needs only one delta, and only one copy of the text.
+  std::optional<TextEditingDelta> TakeCombinedDelta();
+
+  // Returns the text as it was before |delta| as UTF-8, given that it was
+  // just returned by |TakeCombinedDelta|.
+  std::string GetTextBeforeDelta(const TextEditingDelta& delta) const;
+
   // Returns a range covering the entire text.
   TextRange text_range() const { return TextRange(0, text_.length()); }
 
@@ -199,6 +230,16 @@ class TextInputModel {
   // reset to the start of the selected range.
   bool DeleteSelected();
 
+  // Replaces |count| code units at |start| with |text|, recording the change
+  // if deltas are being recorded.
+  //
+  // All changes to the text go through this method.
+  void ReplaceText(size_t start, size_t count, const std::u16string& text);
+
+  // Records the current selection and composing range in the last recorded
+  // delta, if any.
+  void UpdateLastDeltaState();
+
   // Returns the currently editable text range.
   //
   // In composing mode, returns the composing range; otherwise, returns a range
@@ -207,10 +248,12 @@ class TextInputModel {
     return composing_ ? composing_range_ : text_range();
   }
 
-  std::u16string text_;
+  TextRope text_;
   TextRange selection_ = TextRange(0);
   TextRange composing_range_ = TextRange(0);
   bool composing_ = false;
+  bool record_deltas_ = false;
+  std::vector<TextEditingDelta> deltas_;
 };
 
 }  // namespace flutter
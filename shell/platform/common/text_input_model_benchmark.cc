@@ -0,0 +1,107 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/common/text_input_model.h"
+
+#include <string>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/common/json_message_codec.h"
+#include "flutter/shell/platform/common/text_editing_delta_json.h"
+
+namespace flutter {
+
+static std::unique_ptr<TextInputModel> CreateModelWithText(size_t length) {
+  auto model = std::make_unique<TextInputModel>();
+  std::string text;
+  text.reserve(length);
+  while (text.length() < length) {
+    text += "The quick brown fox jumps over the lazy dog.\n";
+  }
+  text.resize(length);
+  model->SetText(text);
+  // Edit in the middle of the document, the worst case for a flat string.
+  model->SetSelection(TextRange(length / 2));
+  return model;
+}
+
+// Typing a character, reported the way the text input plugins report edits
+// with the delta model enabled.
+static void BM_TextInputModelTypeCharacter(benchmark::State& state) {
+  auto model = CreateModelWithText(state.range(0));
+  model->set_record_deltas(true);
+  bool insert = true;
+  while (state.KeepRunning()) {
+    if (insert) {
+      model->AddCodePoint('a');
+    } else {
+      model->Backspace();
+    }
+    insert = !insert;
+    benchmark::DoNotOptimize(model->TakeDeltas());
+    benchmark::DoNotOptimize(model->GetCursorOffset());
+  }
+}
+
+// Typing a character and encoding the update the text input plugins send
+// for it with the delta model enabled, as their SendDeltaUpdate does.
+static void BM_TextInputModelSendDeltaUpdate(benchmark::State& state) {
+  auto model = CreateModelWithText(state.range(0));
+  model->set_record_deltas(true);
+  bool insert = true;
+  while (state.KeepRunning()) {
+    if (insert) {
+      model->AddCodePoint('a');
+    } else {
+      model->Backspace();
+    }
+    insert = !insert;
+    std::unique_ptr<rapidjson::Document> args =
+        TakeEditingStateWithDeltas(0, *model);
+    benchmark::DoNotOptimize(
+        JsonMessageCodec::GetInstance().EncodeMessage(*args));
+  }
+}
+
+// Typing a character, reported as the whole text.
+static void BM_TextInputModelTypeCharacterFullText(benchmark::State& state) {
+  auto model = CreateModelWithText(state.range(0));
+  bool insert = true;
+  while (state.KeepRunning()) {
+    if (insert) {
+      model->AddCodePoint('a');
+    } else {
+      model->Backspace();
+    }
+    insert = !insert;
+    benchmark::DoNotOptimize(model->GetText());
+  }
+}
+
+static void BM_TextInputModelDeleteSurrounding(benchmark::State& state) {
+  auto model = CreateModelWithText(state.range(0));
+  while (state.KeepRunning()) {
+    model->AddText(u"abc");
+    model->DeleteSurrounding(-3, 3);
+  }
+}
+
+BENCHMARK(BM_TextInputModelTypeCharacter)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 23)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_TextInputModelSendDeltaUpdate)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 23)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_TextInputModelTypeCharacterFullText)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 23)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_TextInputModelDeleteSurrounding)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 23)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace flutter
@@ -6,6 +6,7 @@
 
 #include <limits>
 #include <map>
+#include <optional>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -1718,4 +1719,145 @@ TEST(TextInputModel, GetCursorOffsetReverseSelection) {
   EXPECT_EQ(model->GetCursorOffset(), 1);
 }
 
+TEST(TextInputModel, DeltasAreNotRecordedByDefault) {
+  auto model = std::make_unique<TextInputModel>();
+  model->SetText("ABCDE");
+  model->AddText(u"x");
+  EXPECT_TRUE(model->TakeDeltas().empty());
+}
+
+TEST(TextInputModel, DeltasDescribeEdits) {
+  auto model = std::make_unique<TextInputModel>();
+  model->set_record_deltas(true);
+  model->SetText("ABCDE");
+  EXPECT_TRUE(model->SetSelection(TextRange(2)));
+  model->AddText(u"xy");
+  EXPECT_TRUE(model->Backspace());
+  EXPECT_TRUE(model->SetSelection(TextRange(1, 3)));
+  EXPECT_TRUE(model->Delete());
+  EXPECT_STREQ(model->GetText().c_str(), "ACDE");
+
+  std::vector<TextEditingDelta> expected = {
+      TextEditingDelta(TextRange(0, 0), u"ABCDE", u""),
+      TextEditingDelta(TextRange(2, 2), u"xy", u""),
+      TextEditingDelta(TextRange(3, 4), u"", u"y"),
+      TextEditingDelta(TextRange(1, 3), u"", u"Bx"),
+  };
+  expected[0].SetState(TextRange(2), std::nullopt);
+  expected[1].SetState(TextRange(4), std::nullopt);
+  expected[2].SetState(TextRange(1, 3), std::nullopt);
+  expected[3].SetState(TextRange(1), std::nullopt);
+  std::vector<TextEditingDelta> deltas = model->TakeDeltas();
+  EXPECT_EQ(deltas, expected);
+  EXPECT_TRUE(model->TakeDeltas().empty());
+}
+
+TEST(TextInputModel, DeltasDescribeComposing) {
+  auto model = std::make_unique<TextInputModel>();
+  model->SetText("ABCDE");
+  EXPECT_TRUE(model->SetSelection(TextRange(1)));
+  model->set_record_deltas(true);
+  model->BeginComposing();
+  model->UpdateComposingText(u"あ");
+  model->UpdateComposingText(u"あい");
+  model->CommitComposing();
+  model->EndComposing();
+  EXPECT_STREQ(model->GetText().c_str(), "AあいBCDE");
+
+  std::vector<TextEditingDelta> expected = {
+      TextEditingDelta(TextRange(1, 1), u"あ", u""),
+      TextEditingDelta(TextRange(1, 2), u"あい", u"あ"),
+  };
+  expected[0].SetState(TextRange(2), TextRange(1, 2));
+  // Composing ended before the deltas were taken.
+  expected[1].SetState(TextRange(3), std::nullopt);
+  EXPECT_EQ(model->TakeDeltas(), expected);
+}
+
+TEST(TextInputModel, DeltasKeepComposingRangeWithinText) {
+  auto model = std::make_unique<TextInputModel>();
+  model->SetText("ABCDE");
+  EXPECT_TRUE(model->SetSelection(TextRange(1)));
+  model->BeginComposing();
+  model->UpdateComposingText(u"xy");
+  model->set_record_deltas(true);
+  model->AddText(u"z");
+  EXPECT_STREQ(model->GetText().c_str(), "AzBCDE");
+
+  std::vector<TextEditingDelta> expected = {
+      TextEditingDelta(TextRange(1, 3), u"", u"xy"),
+      TextEditingDelta(TextRange(1, 1), u"z", u""),
+  };
+  expected[0].SetState(TextRange(1), TextRange(1));
+  expected[1].SetState(TextRange(2), TextRange(1, 2));
+  EXPECT_EQ(model->TakeDeltas(), expected);
+}
+
+TEST(TextInputModel, CombinedDeltaCoversEdits) {
+  auto model = std::make_unique<TextInputModel>();
+  model->SetText("ABCDEFG");
+  model->set_record_deltas(true);
+  EXPECT_TRUE(model->SetSelection(TextRange(4)));
+  model->AddText(u"xy");
+  EXPECT_TRUE(model->SetSelection(TextRange(2)));
+  EXPECT_TRUE(model->Backspace());
+  EXPECT_TRUE(model->SetSelection(TextRange(4, 5)));
+  EXPECT_TRUE(model->Delete());
+  EXPECT_STREQ(model->GetText().c_str(), "ACDxEFG");
+
+  TextEditingDelta expected(TextRange(1, 4), u"CDx", u"BCD");
+  expected.SetState(TextRange(4), std::nullopt);
+  std::optional<TextEditingDelta> delta = model->TakeCombinedDelta();
+  ASSERT_TRUE(delta);
+  EXPECT_EQ(*delta, expected);
+  EXPECT_STREQ(model->GetTextBeforeDelta(*delta).c_str(), "ABCDEFG");
+  EXPECT_FALSE(model->TakeCombinedDelta());
+}
+
+TEST(TextInputModel, CombinedDeltaOfComposing) {
+  auto model = std::make_unique<TextInputModel>();
+  model->SetText("ABCDE");
+  EXPECT_TRUE(model->SetSelection(TextRange(1)));
+  model->set_record_deltas(true);
+  model->BeginComposing();
+  model->UpdateComposingText(u"あ");
+  model->UpdateComposingText(u"あい");
+  EXPECT_STREQ(model->GetText().c_str(), "AあいBCDE");
+
+  TextEditingDelta expected(TextRange(1, 1), u"あい", u"");
+  expected.SetState(TextRange(3), TextRange(1, 3));
+  std::optional<TextEditingDelta> delta = model->TakeCombinedDelta();
+  ASSERT_TRUE(delta);
+  EXPECT_EQ(*delta, expected);
+  EXPECT_STREQ(model->GetTextBeforeDelta(*delta).c_str(), "ABCDE");
+}
+
+TEST(TextInputModel, CombinedDeltaOfEditsThatCancelOut) {
+  auto model = std::make_unique<TextInputModel>();
+  model->SetText("ABCDE");
+  EXPECT_TRUE(model->SetSelection(TextRange(2)));
+  model->set_record_deltas(true);
+  model->AddText(u"x");
+  EXPECT_TRUE(model->Backspace());
+  EXPECT_FALSE(model->TakeCombinedDelta());
+}
+
+TEST(TextInputModel, EditsLargeText) {
+  auto model = std::make_unique<TextInputModel>();
+  std::string text;
+  for (int i = 0; i < 100000; i++) {
+    text += "0123456789";
+  }
+  model->SetText(text);
+  EXPECT_TRUE(model->SetSelection(TextRange(500000)));
+  model->AddText(u"ABC");
+  EXPECT_TRUE(model->Backspace());
+  EXPECT_TRUE(model->MoveCursorForward());
+  EXPECT_TRUE(model->Delete());
+  text.insert(500000, "AB");
+  text.erase(500003, 1);
+  EXPECT_EQ(model->GetText(), text);
+  EXPECT_EQ(model->GetCursorOffset(), 500003);
+}
+
 }  // namespace flutter
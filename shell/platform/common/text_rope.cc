@@ -0,0 +1,448 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/common/text_rope.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace flutter {
+
+namespace {
+
+// The length of the chunks text is split into when it is inserted.
+constexpr size_t kChunkLength = 512;
+
+// Chunks grow up to this length when text is inserted into them in place,
+// and adjacent chunks are joined when they fit in this length together.
+constexpr size_t kMaxChunkLength = 1024;
+
+// Replaces unpaired surrogates in UTF-8.
+constexpr char32_t kReplacementCharacter = 0xFFFD;
+
+// Returns the number of UTF-8 bytes the code point that |code_unit| is part of
+// takes, attributed entirely to the leading surrogate of surrogate pairs.
+size_t CountUtf8Bytes(char16_t code_unit) {
+  if (code_unit < 0x80) {
+    return 1;
+  }
+  if (code_unit < 0x800) {
+    return 2;
+  }
+  if ((code_unit & 0xFC00) == 0xD800) {
+    return 4;
+  }
+  if ((code_unit & 0xFC00) == 0xDC00) {
+    return 0;
+  }
+  return 3;
+}
+
+size_t CountUtf8Bytes(const char16_t* text, size_t count) {
+  size_t length = 0;
+  for (size_t i = 0; i < count; i++) {
+    length += CountUtf8Bytes(text[i]);
+  }
+  return length;
+}
+
+void EncodeUtf8(char32_t code_point, std::string& result) {
+  if (code_point < 0x80) {
+    result.push_back(static_cast<char>(code_point));
+  } else if (code_point < 0x800) {
+    result.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+    result.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else if (code_point < 0x10000) {
+    result.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+    result.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    result.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else {
+    result.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+    result.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+    result.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    result.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+}
+
+}  // namespace
+
+// A node of a treap: the text of the subtree is the text of |left|, followed
+// by |chunk|, followed by the text of |right|. Nodes are ordered as a binary
+// search tree by position and as a heap by |priority|, which keeps the tree
+// balanced with high probability.
+struct TextRope::Node {
+  std::u16string chunk;
+  uint32_t priority = 0;
+  std::unique_ptr<Node> left;
+  std::unique_ptr<Node> right;
+
+  // The length of |chunk| in UTF-8 bytes.
+  size_t chunk_utf8_length = 0;
+  // The length of the text of this subtree in UTF-16 code units.
+  size_t length = 0;
+  // The length of the text of this subtree in UTF-8 bytes.
+  size_t utf8_length = 0;
+  // The number of nodes in this subtree.
+  size_t count = 1;
+
+  static size_t LengthOf(const std::unique_ptr<Node>& node) {
+    return node ? node->length : 0;
+  }
+
+  static size_t Utf8LengthOf(const std::unique_ptr<Node>& node) {
+    return node ? node->utf8_length : 0;
+  }
+
+  static size_t CountOf(const std::unique_ptr<Node>& node) {
+    return node ? node->count : 0;
+  }
+
+  // Recomputes the lengths of this subtree from its children.
+  void Update() {
+    length = LengthOf(left) + chunk.length() + LengthOf(right);
+    utf8_length = Utf8LengthOf(left) + chunk_utf8_length + Utf8LengthOf(right);
+    count = CountOf(left) + 1 + CountOf(right);
+  }
+
+  // Recomputes the lengths of this subtree after |chunk| changed.
+  void UpdateChunk() {
+    chunk_utf8_length = CountUtf8Bytes(chunk.data(), chunk.length());
+    Update();
+  }
+};
+
+TextRope::TextRope() = default;
+
+TextRope::TextRope(const std::u16string& text) {
+  root_ = Build(text);
+}
+
+TextRope::~TextRope() = default;
+
+TextRope::TextRope(TextRope&& other) = default;
+
+TextRope& TextRope::operator=(TextRope&& other) = default;
+
+size_t TextRope::length() const {
+  return Node::LengthOf(root_);
+}
+
+size_t TextRope::chunk_count() const {
+  return Node::CountOf(root_);
+}
+
+char16_t TextRope::at(size_t position) const {
+  assert(position < length());
+  const Node* node = root_.get();
+  while (node) {
+    const size_t left_length = Node::LengthOf(node->left);
+    if (position < left_length) {
+      node = node->left.get();
+    } else if (position < left_length + node->chunk.length()) {
+      return node->chunk[position - left_length];
+    } else {
+      position -= left_length + node->chunk.length();
+      node = node->right.get();
+    }
+  }
+  return 0;
+}
+
+void TextRope::Insert(size_t position, const std::u16string& text) {
+  assert(position <= length());
+  if (text.empty()) {
+    return;
+  }
+  if (root_ && text.length() <= kChunkLength &&
+      InsertInPlace(root_.get(), position, text)) {
+    return;
+  }
+  auto [left, right] = Split(std::move(root_), position);
+  root_ = Join(Join(std::move(left), Build(text)), std::move(right));
+}
+
+void TextRope::Erase(size_t position, size_t count) {
+  assert(position <= length());
+  count = std::min(count, length() - position);
+  if (count == 0) {
+    return;
+  }
+  auto [left, rest] = Split(std::move(root_), position);
+  auto [erased, right] = Split(std::move(rest), count);
+  root_ = Join(std::move(left), std::move(right));
+}
+
+void TextRope::Replace(size_t position,
+                       size_t count,
+                       const std::u16string& text) {
+  Erase(position, count);
+  Insert(position, text);
+}
+
+void TextRope::VisitRange(
+    const Node* node,
+    size_t start,
+    size_t count,
+    const std::function<void(const char16_t* text, size_t length)>& visitor) {
+  while (node && count > 0) {
+    const size_t left_length = Node::LengthOf(node->left);
+    if (start < left_length) {
+      const size_t left_count = std::min(count, left_length - start);
+      VisitRange(node->left.get(), start, left_count, visitor);
+      start = left_length;
+      count -= left_count;
+      continue;
+    }
+    const size_t chunk_start = start - left_length;
+    if (chunk_start < node->chunk.length()) {
+      const size_t chunk_count =
+          std::min(count, node->chunk.length() - chunk_start);
+      visitor(node->chunk.data() + chunk_start, chunk_count);
+      start += chunk_count;
+      count -= chunk_count;
+      continue;
+    }
+    start -= left_length + node->chunk.length();
+    node = node->right.get();
+  }
+}
+
+bool TextRope::InsertInPlace(Node* node,
+                             size_t position,
+                             const std::u16string& text) {
+  const size_t left_length = Node::LengthOf(node->left);
+  bool inserted = false;
+  if (position < left_length) {
+    inserted = InsertInPlace(node->left.get(), position, text);
+  } else if (position <= left_length + node->chunk.length()) {
+    if (node->chunk.length() + text.length() <= kMaxChunkLength) {
+      node->chunk.insert(position - left_length, text);
+      node->UpdateChunk();
+      return true;
+    }
+  } else if (node->right) {
+    inserted = InsertInPlace(node->right.get(),
+                             position - left_length - node->chunk.length(),
+                             text);
+  }
+  if (inserted) {
+    node->Update();
+  }
+  return inserted;
+}
+
+std::u16string TextRope::Substr(size_t position, size_t count) const {
+  std::u16string result;
+  if (position >= length()) {
+    return result;
+  }
+  count = std::min(count, length() - position);
+  result.reserve(count);
+  VisitRange(root_.get(), position, count,
+             [&result](const char16_t* text, size_t length) {
+               result.append(text, length);
+             });
+  return result;
+}
+
+std::u16string TextRope::ToString() const {
+  return Substr(0, length());
+}
+
+void TextRope::AppendUtf8(size_t position,
+                          size_t count,
+                          std::string& result) const {
+  if (position >= length()) {
+    return;
+  }
+  count = std::min(count, length() - position);
+  result.reserve(result.length() + Utf8Length(position + count) -
+                 Utf8Length(position));
+  // A surrogate pair may be split between two chunks.
+  char16_t leading_surrogate = 0;
+  auto append = [&](const char16_t* text, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+      const char16_t code_unit = text[i];
+      if (code_unit < 0x80 && leading_surrogate == 0) {
+        // Copy runs of ASCII, the common case, at once.
+        size_t end = i + 1;
+        while (end < length && text[end] < 0x80) {
+          end++;
+        }
+        const size_t size = result.size();
+        result.resize(size + end - i);
+        std::copy(text + i, text + end, result.begin() + size);
+        i = end - 1;
+        continue;
+      }
+      const bool is_trailing_surrogate = (code_unit & 0xFC00) == 0xDC00;
+      if (leading_surrogate != 0) {
+        if (is_trailing_surrogate) {
+          EncodeUtf8(0x10000 + ((leading_surrogate - 0xD800) << 10) +
+                         (code_unit - 0xDC00),
+                     result);
+          leading_surrogate = 0;
+          continue;
+        }
+        EncodeUtf8(kReplacementCharacter, result);
+        leading_surrogate = 0;
+      }
+      if ((code_unit & 0xFC00) == 0xD800) {
+        leading_surrogate = code_unit;
+      } else if (is_trailing_surrogate) {
+        EncodeUtf8(kReplacementCharacter, result);
+      } else {
+        EncodeUtf8(code_unit, result);
+      }
+    }
+  };
+  VisitRange(root_.get(), position, count, append);
+  if (leading_surrogate != 0) {
+    EncodeUtf8(kReplacementCharacter, result);
+  }
+}
+
+size_t TextRope::Utf8Length(size_t count) const {
+  size_t utf8_length = 0;
+  const Node* node = root_.get();
+  while (node && count > 0) {
+    const size_t left_length = Node::LengthOf(node->left);
+    if (count <= left_length) {
+      node = node->left.get();
+      continue;
+    }
+    utf8_length += Node::Utf8LengthOf(node->left);
+    count -= left_length;
+    if (count <= node->chunk.length()) {
+      return utf8_length + CountUtf8Bytes(node->chunk.data(), count);
+    }
+    utf8_length += node->chunk_utf8_length;
+    count -= node->chunk.length();
+    node = node->right.get();
+  }
+  return utf8_length;
+}
+
+std::unique_ptr<TextRope::Node> TextRope::MakeNode(std::u16string chunk) {
+  auto node = std::make_unique<Node>();
+  node->chunk = std::move(chunk);
+  node->priority = random_();
+  node->UpdateChunk();
+  return node;
+}
+
+std::unique_ptr<TextRope::Node> TextRope::Build(const std::u16string& text) {
+  std::unique_ptr<Node> root;
+  for (size_t start = 0; start < text.length(); start += kChunkLength) {
+    root = Merge(std::move(root), MakeNode(text.substr(start, kChunkLength)));
+  }
+  return root;
+}
+
+std::unique_ptr<TextRope::Node> TextRope::Merge(std::unique_ptr<Node> left,
+                                                std::unique_ptr<Node> right) {
+  if (!left) {
+    return right;
+  }
+  if (!right) {
+    return left;
+  }
+  if (left->priority >= right->priority) {
+    left->right = Merge(std::move(left->right), std::move(right));
+    left->Update();
+    return left;
+  }
+  right->left = Merge(std::move(left), std::move(right->left));
+  right->Update();
+  return right;
+}
+
+std::pair<std::unique_ptr<TextRope::Node>, std::unique_ptr<TextRope::Node>>
+TextRope::Split(std::unique_ptr<Node> node, size_t position) {
+  if (!node) {
+    return {nullptr, nullptr};
+  }
+  const size_t left_length = Node::LengthOf(node->left);
+  if (position <= left_length) {
+    auto [left, right] = Split(std::move(node->left), position);
+    node->left = std::move(right);
+    node->Update();
+    return {std::move(left), std::move(node)};
+  }
+  const size_t chunk_end = left_length + node->chunk.length();
+  if (position >= chunk_end) {
+    auto [left, right] = Split(std::move(node->right), position - chunk_end);
+    node->right = std::move(left);
+    node->Update();
+    return {std::move(node), std::move(right)};
+  }
+  // |position| falls inside the chunk of this node. Keep the head of the
+  // chunk in this node and move the tail to a new one.
+  const size_t offset = position - left_length;
+  auto tail = MakeNode(node->chunk.substr(offset));
+  node->chunk.resize(offset);
+  auto right = std::move(node->right);
+  node->UpdateChunk();
+  return {std::move(node), Merge(std::move(tail), std::move(right))};
+}
+
+std::unique_ptr<TextRope::Node> TextRope::Join(std::unique_ptr<Node> left,
+                                               std::unique_ptr<Node> right) {
+  if (!left || !right) {
+    return Merge(std::move(left), std::move(right));
+  }
+  // Splits leave short chunks on either side of the seam. Join them, and any
+  // neighbors that still fit, so that no two adjacent chunks would fit in
+  // one.
+  std::unique_ptr<Node> node = TakeLast(left);
+  while (right) {
+    std::unique_ptr<Node> next = TakeFirst(right);
+    if (node->chunk.length() + next->chunk.length() > kMaxChunkLength) {
+      right = Merge(std::move(next), std::move(right));
+      break;
+    }
+    node->chunk += next->chunk;
+    node->chunk_utf8_length += next->chunk_utf8_length;
+  }
+  while (left) {
+    std::unique_ptr<Node> previous = TakeLast(left);
+    if (previous->chunk.length() + node->chunk.length() > kMaxChunkLength) {
+      left = Merge(std::move(left), std::move(previous));
+      break;
+    }
+    previous->chunk += node->chunk;
+    previous->chunk_utf8_length += node->chunk_utf8_length;
+    node = std::move(previous);
+  }
+  node->Update();
+  return Merge(Merge(std::move(left), std::move(node)), std::move(right));
+}
+
+std::unique_ptr<TextRope::Node> TextRope::TakeFirst(
+    std::unique_ptr<Node>& node) {
+  if (node->left) {
+    std::unique_ptr<Node> first = TakeFirst(node->left);
+    node->Update();
+    return first;
+  }
+  std::unique_ptr<Node> first = std::move(node);
+  node = std::move(first->right);
+  first->Update();
+  return first;
+}
+
+std::unique_ptr<TextRope::Node> TextRope::TakeLast(
+    std::unique_ptr<Node>& node) {
+  if (node->right) {
+    std::unique_ptr<Node> last = TakeLast(node->right);
+    node->Update();
+    return last;
+  }
+  std::unique_ptr<Node> last = std::move(node);
+  node = std::move(last->left);
+  last->Update();
+  return last;
+}
+
+}  // namespace flutter
@@ -0,0 +1,118 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_COMMON_TEXT_ROPE_H_
+#define FLUTTER_SHELL_PLATFORM_COMMON_TEXT_ROPE_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+
+namespace flutter {
+
+// UTF-16 text stored as a balanced tree of chunks.
+//
+// Unlike a flat string, inserting, erasing and looking up text takes time
+// logarithmic in the length of the text, so editing large documents does not
+// copy or shift the whole text on every keystroke.
+class TextRope {
+ public:
+  TextRope();
+  explicit TextRope(const std::u16string& text);
+  ~TextRope();
+
+  TextRope(TextRope&& other);
+  TextRope& operator=(TextRope&& other);
+
+  // The length of the text in UTF-16 code units.
+  size_t length() const;
+
+  bool empty() const { return length() == 0; }
+
+  // Returns the code unit at |position|, which must be less than |length|.
+  char16_t at(size_t position) const;
+
+  // Inserts |text| before the code unit at |position|, which must not be
+  // greater than |length|.
+  void Insert(size_t position, const std::u16string& text);
+
+  // Erases up to |count| code units starting at |position|, which must not be
+  // greater than |length|.
+  void Erase(size_t position, size_t count);
+
+  // Replaces up to |count| code units starting at |position| with |text|.
+  void Replace(size_t position, size_t count, const std::u16string& text);
+
+  // Returns up to |count| code units starting at |position|.
+  std::u16string Substr(size_t position, size_t count) const;
+
+  // Returns the whole text.
+  std::u16string ToString() const;
+
+  // Appends up to |count| code units starting at |position| to |result| as
+  // UTF-8. Unpaired surrogates are appended as U+FFFD.
+  void AppendUtf8(size_t position, size_t count, std::string& result) const;
+
+  // Returns the number of bytes the first |count| code units take when
+  // encoded as UTF-8.
+  size_t Utf8Length(size_t count) const;
+
+  // The number of chunks the text is stored in.
+  //
+  // Adjacent chunks are joined when an edit leaves them short enough to fit
+  // in one, so this stays proportional to |length| however the text was
+  // edited.
+  size_t chunk_count() const;
+
+ private:
+  struct Node;
+
+  std::unique_ptr<Node> root_;
+  std::minstd_rand random_;
+
+  std::unique_ptr<Node> MakeNode(std::u16string chunk);
+
+  std::unique_ptr<Node> Build(const std::u16string& text);
+
+  std::unique_ptr<Node> Merge(std::unique_ptr<Node> left,
+                              std::unique_ptr<Node> right);
+
+  std::pair<std::unique_ptr<Node>, std::unique_ptr<Node>> Split(
+      std::unique_ptr<Node> node,
+      size_t position);
+
+  // Merges |left| and |right|, joining the chunks on either side of the seam
+  // between them into as few chunks as fit.
+  std::unique_ptr<Node> Join(std::unique_ptr<Node> left,
+                             std::unique_ptr<Node> right);
+
+  // Removes the first node of the non-empty subtree |node| and returns it.
+  static std::unique_ptr<Node> TakeFirst(std::unique_ptr<Node>& node);
+
+  // Removes the last node of the non-empty subtree |node| and returns it.
+  static std::unique_ptr<Node> TakeLast(std::unique_ptr<Node>& node);
+
+  // Inserts |text| into the chunk that contains |position| if that chunk has
+  // room for it. Returns false if it does not.
+  static bool InsertInPlace(Node* node,
+                            size_t position,
+                            const std::u16string& text);
+
+  // Calls |visitor| with the pieces of the chunks of the subtree of |node|
+  // that hold the code units in [|start|, |start| + |count|), in order.
+  static void VisitRange(
+      const Node* node,
+      size_t start,
+      size_t count,
+      const std::function<void(const char16_t* text, size_t length)>& visitor);
+
+  TextRope(const TextRope&) = delete;
+  TextRope& operator=(const TextRope&) = delete;
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PLATFORM_COMMON_TEXT_ROPE_H_
@@ -0,0 +1,123 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/common/text_rope.h"
+
+#include <random>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+
+TEST(TextRope, Empty) {
+  TextRope rope;
+  EXPECT_TRUE(rope.empty());
+  EXPECT_EQ(rope.length(), 0u);
+  EXPECT_EQ(rope.ToString(), u"");
+  EXPECT_EQ(rope.Substr(0, 10), u"");
+  EXPECT_EQ(rope.Utf8Length(0), 0u);
+}
+
+TEST(TextRope, InsertAndErase) {
+  TextRope rope(u"ABCDE");
+  rope.Insert(0, u"x");
+  rope.Insert(3, u"yy");
+  rope.Insert(8, u"z");
+  EXPECT_EQ(rope.ToString(), u"xAByyCDEz");
+  rope.Erase(1, 3);
+  EXPECT_EQ(rope.ToString(), u"xyCDEz");
+  rope.Erase(4, 100);
+  EXPECT_EQ(rope.ToString(), u"xyCD");
+  rope.Replace(1, 2, u"12345");
+  EXPECT_EQ(rope.ToString(), u"x12345D");
+  EXPECT_EQ(rope.at(0), u'x');
+  EXPECT_EQ(rope.at(6), u'D');
+  EXPECT_EQ(rope.Substr(2, 3), u"234");
+}
+
+TEST(TextRope, Utf8Length) {
+  // These characters take 1, 2, 3 and 4 bytes in UTF-8.
+  TextRope rope(u"$¢€𐍈");
+  EXPECT_EQ(rope.length(), 5u);
+  EXPECT_EQ(rope.Utf8Length(1), 1u);
+  EXPECT_EQ(rope.Utf8Length(2), 3u);
+  EXPECT_EQ(rope.Utf8Length(3), 6u);
+  EXPECT_EQ(rope.Utf8Length(5), 10u);
+}
+
+TEST(TextRope, AppendUtf8) {
+  // These characters take 1, 2, 3 and 4 bytes in UTF-8.
+  TextRope rope(u"$¢€𐍈");
+  std::string text = "x";
+  rope.AppendUtf8(0, rope.length(), text);
+  EXPECT_EQ(text, "x$¢€𐍈");
+  text.clear();
+  rope.AppendUtf8(1, 2, text);
+  EXPECT_EQ(text, "¢€");
+  // Unpaired surrogates, including halves of a pair cut by the range.
+  text.clear();
+  rope.AppendUtf8(4, 1, text);
+  EXPECT_EQ(text, "\xEF\xBF\xBD");
+}
+
+TEST(TextRope, AppendUtf8JoinsSurrogatePairsAcrossChunks) {
+  std::u16string expected;
+  for (int i = 0; i < 1000; i++) {
+    expected += u"a𐍈";
+  }
+  TextRope rope(expected);
+  std::string text;
+  rope.AppendUtf8(0, rope.length(), text);
+  std::string expected_text;
+  for (int i = 0; i < 1000; i++) {
+    expected_text += "a𐍈";
+  }
+  EXPECT_EQ(text, expected_text);
+}
+
+TEST(TextRope, ChunksStayLongUnderRandomEdits) {
+  std::minstd_rand random(1);
+  TextRope rope(std::u16string(100000, u'a'));
+  for (int i = 0; i < 20000; i++) {
+    const size_t position = random() % (rope.length() + 1);
+    if (random() % 2 == 0) {
+      rope.Erase(position, 1 + random() % 3);
+    } else {
+      rope.Insert(position, std::u16string(1 + random() % 10, u'b'));
+    }
+  }
+  // Every two adjacent chunks hold more than 512 code units together.
+  EXPECT_LE(rope.chunk_count(), rope.length() / 256 + 1);
+}
+
+TEST(TextRope, MatchesStringUnderRandomEdits) {
+  std::minstd_rand random(1);
+  std::u16string expected;
+  TextRope rope;
+  for (int i = 0; i < 5000; i++) {
+    const size_t position = random() % (expected.length() + 1);
+    if (random() % 3 == 0) {
+      const size_t count = random() % 100;
+      expected.erase(position, count);
+      rope.Erase(position, count);
+    } else {
+      // Mostly keystrokes, sometimes pastes that span several chunks.
+      const size_t count = random() % 20 == 0 ? random() % 3000 : 1;
+      const std::u16string text(count, u'a' + random() % 26);
+      expected.insert(position, text);
+      rope.Insert(position, text);
+    }
+    ASSERT_EQ(rope.length(), expected.length());
+    if (!expected.empty()) {
+      const size_t index = random() % expected.length();
+      ASSERT_EQ(rope.at(index), expected[index]);
+    }
+  }
+  EXPECT_EQ(rope.ToString(), expected);
+  EXPECT_EQ(rope.Substr(1000, 2000), expected.substr(1000, 2000));
+  EXPECT_EQ(rope.Utf8Length(expected.length()), expected.length());
+}
+
+}  // namespace flutter
@@ -45,6 +45,7 @@ extern const intptr_t kPlatformStrongDillSize;
 #include "flutter/fml/paths.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/shell/common/rasterizer.h"
+#include "flutter/shell/common/shell_pool.h"
 #include "flutter/shell/common/switches.h"
 #include "flutter/shell/platform/embedder/embedder.h"
 #include "flutter/shell/platform/embedder/embedder_engine.h"
@@ -118,8 +119,18 @@ static bool IsSoftwareRendererConfigValid(const FlutterRendererConfig* config) {
 
   const FlutterSoftwareRendererConfig* software_config = &config->software;
 
+  const bool has_swapchain_callback =
+      SAFE_ACCESS(software_config, swapchain_callback, nullptr) != nullptr;
+  const bool has_swapchain_present_callback =
+      SAFE_ACCESS(software_config, swapchain_present_callback, nullptr) !=
+      nullptr;
+  if (has_swapchain_callback != has_swapchain_present_callback) {
+    return false;
+  }
+
   if (SAFE_ACCESS(software_config, surface_present_callback, nullptr) ==
-      nullptr) {
+          nullptr &&
+      !has_swapchain_callback) {
     return false;
   }
 
@@ -368,6 +379,75 @@ InferMetalPlatformViewCreationCallback(
 #endif
 }
 
+static SkImageInfo MakeSwapchainBufferImageInfo(
+    const SkISize& size,
+    FlutterSoftwarePixelFormat pixel_format) {
+  switch (pixel_format) {
+    case kFlutterSoftwarePixelFormatNative32:
+      return SkImageInfo::MakeN32(size.width(), size.height(),
+                                  kPremul_SkAlphaType,
+                                  SkColorSpace::MakeSRGB());
+    case kFlutterSoftwarePixelFormatRGBA8888:
+      return SkImageInfo::Make(size, kRGBA_8888_SkColorType,
+                               kPremul_SkAlphaType, SkColorSpace::MakeSRGB());
+    case kFlutterSoftwarePixelFormatBGRA8888:
+      return SkImageInfo::Make(size, kBGRA_8888_SkColorType,
+                               kPremul_SkAlphaType, SkColorSpace::MakeSRGB());
+    case kFlutterSoftwarePixelFormatRGB565:
+      return SkImageInfo::Make(size, kRGB_565_SkColorType, kOpaque_SkAlphaType,
+                               SkColorSpace::MakeSRGB());
+  }
+  return SkImageInfo::MakeUnknown(size.width(), size.height());
+}
+
+// The most buffers an embedder may hand out for a software swapchain.
+static constexpr size_t kMaxSoftwareSwapchainBufferCount = 4;
+
+static std::vector<sk_sp<SkSurface>> AcquireSoftwareSwapchain(
+    FlutterSoftwareSwapchainCallback callback,
+    void* user_data,
+    const SkISize& size) {
+  FlutterFrameInfo frame_info = {};
+  frame_info.struct_size = sizeof(FlutterFrameInfo);
+  frame_info.size = {static_cast<uint32_t>(size.width()),
+                     static_cast<uint32_t>(size.height())};
+
+  FlutterSoftwareSwapchainBuffer buffers[kMaxSoftwareSwapchainBufferCount] =
+      {};
+  for (auto& buffer : buffers) {
+    buffer.struct_size = sizeof(FlutterSoftwareSwapchainBuffer);
+  }
+  size_t buffer_count = kMaxSoftwareSwapchainBufferCount;
+  if (!callback(user_data, &frame_info, buffers, &buffer_count)) {
+    FML_LOG(ERROR) << "The embedder could not provide a software swapchain.";
+    return {};
+  }
+  if (buffer_count == 0 || buffer_count > kMaxSoftwareSwapchainBufferCount) {
+    FML_LOG(ERROR) << "The embedder provided a software swapchain with "
+                   << buffer_count << " buffers.";
+    return {};
+  }
+
+  std::vector<sk_sp<SkSurface>> swapchain;
+  for (size_t i = 0; i < buffer_count; i++) {
+    const FlutterSoftwareSwapchainBuffer& buffer = buffers[i];
+    auto surface = SkSurface::MakeRasterDirect(
+        MakeSwapchainBufferImageInfo(
+            size, SAFE_ACCESS(&buffer, pixel_format,
+                              kFlutterSoftwarePixelFormatNative32)),
+        SAFE_ACCESS(&buffer, allocation, nullptr),
+        SAFE_ACCESS(&buffer, row_bytes, 0));
+    if (!surface) {
+      FML_LOG(ERROR) << "Could not wrap the embedder supplied software "
+                        "swapchain buffer "
+                     << i << ".";
+      return {};
+    }
+    swapchain.push_back(std::move(surface));
+  }
+  return swapchain;
+}
+
 static flutter::Shell::CreateCallback<flutter::PlatformView>
 InferSoftwarePlatformViewCreationCallback(
     const FlutterRendererConfig* config,
@@ -386,19 +466,56 @@ InferSoftwarePlatformViewCreationCallback(
     return ptr(user_data, allocation, row_bytes, height);
   };
 
+  std::function<std::vector<sk_sp<SkSurface>>(const SkISize&)>
+      software_acquire_swapchain;
+  std::function<bool(size_t, const std::vector<SkIRect>&)>
+      software_present_swapchain_buffer;
+  if (auto swapchain_callback =
+          SAFE_ACCESS(&config->software, swapchain_callback, nullptr)) {
+    software_acquire_swapchain = [swapchain_callback,
+                                  user_data](const SkISize& size) {
+      return AcquireSoftwareSwapchain(swapchain_callback, user_data, size);
+    };
+    software_present_swapchain_buffer =
+        [ptr = SAFE_ACCESS(&config->software, swapchain_present_callback,
+                           nullptr),
+         user_data](size_t buffer_index,
+                    const std::vector<SkIRect>& damage) -> bool {
+      std::vector<FlutterRect> damage_rects;
+      damage_rects.reserve(damage.size());
+      for (const auto& rect : damage) {
+        damage_rects.push_back({static_cast<double>(rect.left()),
+                                static_cast<double>(rect.top()),
+                                static_cast<double>(rect.right()),
+                                static_cast<double>(rect.bottom())});
+      }
+      FlutterSoftwareSwapchainPresentInfo present_info = {};
+      present_info.struct_size = sizeof(FlutterSoftwareSwapchainPresentInfo);
+      present_info.buffer_index = buffer_index;
+      present_info.damage = damage_rects.data();
+      present_info.damage_count = damage_rects.size();
+      return ptr(user_data, &present_info);
+    };
+  }
+
   flutter::EmbedderSurfaceSoftware::SoftwareDispatchTable
       software_dispatch_table = {
-          software_present_backing_store,  // required
+          software_present_backing_store,     // required unless swapchain
+          software_acquire_swapchain,         // optional
+          software_present_swapchain_buffer,  // optional
       };
 
   return fml::MakeCopyable(
       [software_dispatch_table, platform_dispatch_table,
        external_view_embedder =
            std::move(external_view_embedder)](flutter::Shell& shell) mutable {
+        const size_t raster_tile_count =
+            shell.GetSettings().software_raster_tile_count;
         return std::make_unique<flutter::PlatformViewEmbedder>(
             shell,                             // delegate
             shell.GetTaskRunners(),            // task runners
             software_dispatch_table,           // software dispatch table
+            raster_tile_count,                 // raster tile count
             platform_dispatch_table,           // platform dispatch table
             std::move(external_view_embedder)  // external view embedder
         );
@@ -872,149 +989,8 @@ void PopulateSnapshotMappingCallbacks(
 #endif  // !OS_FUCHSIA && (FLUTTER_RUNTIME_MODE == FLUTTER_RUNTIME_MODE_DEBUG)
 }
 
-FlutterEngineResult FlutterEngineRun(size_t version,
-                                     const FlutterRendererConfig* config,
-                                     const FlutterProjectArgs* args,
-                                     void* user_data,
-                                     FLUTTER_API_SYMBOL(FlutterEngine) *
-                                         engine_out) {
-  auto result =
-      FlutterEngineInitialize(version, config, args, user_data, engine_out);
-
-  if (result != kSuccess) {
-    return result;
-  }
-
-  return FlutterEngineRunInitialized(*engine_out);
-}
-
-FlutterEngineResult FlutterEngineInitialize(size_t version,
-                                            const FlutterRendererConfig* config,
-                                            const FlutterProjectArgs* args,
-                                            void* user_data,
-                                            FLUTTER_API_SYMBOL(FlutterEngine) *
-                                                engine_out) {
-  // Step 0: Figure out arguments for shell creation.
-  if (version != FLUTTER_ENGINE_VERSION) {
-    return LOG_EMBEDDER_ERROR(
-        kInvalidLibraryVersion,
-        "Flutter embedder version mismatch. There has been a breaking change. "
-        "Please consult the changelog and update the embedder.");
-  }
-
-  if (engine_out == nullptr) {
-    return LOG_EMBEDDER_ERROR(kInvalidArguments,
-                              "The engine out parameter was missing.");
-  }
-
-  if (args == nullptr) {
-    return LOG_EMBEDDER_ERROR(kInvalidArguments,
-                              "The Flutter project arguments were missing.");
-  }
-
-  if (SAFE_ACCESS(args, assets_path, nullptr) == nullptr) {
-    return LOG_EMBEDDER_ERROR(
-        kInvalidArguments,
-        "The assets path in the Flutter project arguments was missing.");
-  }
-
-  if (SAFE_ACCESS(args, main_path__unused__, nullptr) != nullptr) {
-    FML_LOG(WARNING)
-        << "FlutterProjectArgs.main_path is deprecated and should be set null.";
-  }
-
-  if (SAFE_ACCESS(args, packages_path__unused__, nullptr) != nullptr) {
-    FML_LOG(WARNING) << "FlutterProjectArgs.packages_path is deprecated and "
-                        "should be set null.";
-  }
-
-  if (!IsRendererValid(config)) {
-    return LOG_EMBEDDER_ERROR(kInvalidArguments,
-                              "The renderer configuration was invalid.");
-  }
-
-  std::string icu_data_path;
-  if (SAFE_ACCESS(args, icu_data_path, nullptr) != nullptr) {
-    icu_data_path = SAFE_ACCESS(args, icu_data_path, nullptr);
-  }
-
-  if (SAFE_ACCESS(args, persistent_cache_path, nullptr) != nullptr) {
-    std::string persistent_cache_path =
-        SAFE_ACCESS(args, persistent_cache_path, nullptr);
-    flutter::PersistentCache::SetCacheDirectoryPath(persistent_cache_path);
-  }
-
-  if (SAFE_ACCESS(args, is_persistent_cache_read_only, false)) {
-    flutter::PersistentCache::gIsReadOnly = true;
-  }
-
-  fml::CommandLine command_line;
-  if (SAFE_ACCESS(args, command_line_argc, 0) != 0 &&
-      SAFE_ACCESS(args, command_line_argv, nullptr) != nullptr) {
-    command_line = fml::CommandLineFromArgcArgv(
-        SAFE_ACCESS(args, command_line_argc, 0),
-        SAFE_ACCESS(args, command_line_argv, nullptr));
-  }
-
-  flutter::Settings settings = flutter::SettingsFromCommandLine(command_line);
-
-  if (SAFE_ACCESS(args, aot_data, nullptr)) {
-    if (SAFE_ACCESS(args, vm_snapshot_data, nullptr) ||
-        SAFE_ACCESS(args, vm_snapshot_instructions, nullptr) ||
-        SAFE_ACCESS(args, isolate_snapshot_data, nullptr) ||
-        SAFE_ACCESS(args, isolate_snapshot_instructions, nullptr)) {
-      return LOG_EMBEDDER_ERROR(
-          kInvalidArguments,
-          "Multiple AOT sources specified. Embedders should provide either "
-          "*_snapshot_* buffers or aot_data, not both.");
-    }
-  }
-
-  PopulateSnapshotMappingCallbacks(args, settings);
-
-  settings.icu_data_path = icu_data_path;
-  settings.assets_path = args->assets_path;
-  settings.leak_vm = !SAFE_ACCESS(args, shutdown_dart_vm_when_done, false);
-  settings.old_gen_heap_size = SAFE_ACCESS(args, dart_old_gen_heap_size, -1);
-
-  if (!flutter::DartVM::IsRunningPrecompiledCode()) {
-    // Verify the assets path contains Dart 2 kernel assets.
-    const std::string kApplicationKernelSnapshotFileName = "kernel_blob.bin";
-    std::string application_kernel_path = fml::paths::JoinPaths(
-        {settings.assets_path, kApplicationKernelSnapshotFileName});
-    if (!fml::IsFile(application_kernel_path)) {
-      return LOG_EMBEDDER_ERROR(
-          kInvalidArguments,
-          "Not running in AOT mode but could not resolve the kernel binary.");
-    }
-    settings.application_kernel_asset = kApplicationKernelSnapshotFileName;
-  }
-
-  settings.task_observer_add = [](intptr_t key, fml::closure callback) {
-    fml::MessageLoop::GetCurrent().AddTaskObserver(key, std::move(callback));
-  };
-  settings.task_observer_remove = [](intptr_t key) {
-    fml::MessageLoop::GetCurrent().RemoveTaskObserver(key);
-  };
-  if (SAFE_ACCESS(args, root_isolate_create_callback, nullptr) != nullptr) {
-    VoidCallback callback =
-        SAFE_ACCESS(args, root_isolate_create_callback, nullptr);
-    settings.root_isolate_create_callback =
-        [callback, user_data](const auto& isolate) { callback(user_data); };
-  }
-  if (SAFE_ACCESS(args, log_message_callback, nullptr) != nullptr) {
-    FlutterLogMessageCallback callback =
-        SAFE_ACCESS(args, log_message_callback, nullptr);
-    settings.log_message_callback = [callback, user_data](
-                                        const std::string& tag,
-                                        const std::string& message) {
-      callback(tag.c_str(), message.c_str(), user_data);
-    };
-  }
-  if (SAFE_ACCESS(args, log_tag, nullptr) != nullptr) {
-    settings.log_tag = SAFE_ACCESS(args, log_tag, nullptr);
-  }
-
+static flutter::PlatformViewEmbedder::PlatformDispatchTable
+InferPlatformDispatchTable(const FlutterProjectArgs* args, void* user_data) {
   flutter::PlatformViewEmbedder::UpdateSemanticsNodesCallback
       update_semantics_nodes_callback = nullptr;
   if (SAFE_ACCESS(args, update_semantics_node_callback, nullptr) != nullptr) {
@@ -1110,8 +1086,8 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
           const FlutterPlatformMessage incoming_message = {
               sizeof(FlutterPlatformMessage),  // struct_size
               message->channel().c_str(),      // channel
-              message->data().data(),          // message
-              message->data().size(),          // message_size
+              message->data().GetMapping(),    // message
+              message->data().GetSize(),       // message_size
               handle,                          // response_handle
           };
           handle->message = std::move(message);
@@ -1174,37 +1150,18 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
         };
   }
 
-  auto external_view_embedder_result =
-      InferExternalViewEmbedderFromArgs(SAFE_ACCESS(args, compositor, nullptr));
-  if (external_view_embedder_result.second) {
-    return LOG_EMBEDDER_ERROR(kInvalidArguments,
-                              "Compositor arguments were invalid.");
-  }
-
-  flutter::PlatformViewEmbedder::PlatformDispatchTable platform_dispatch_table =
-      {
-          update_semantics_nodes_callback,            //
-          update_semantics_custom_actions_callback,   //
-          platform_message_response_callback,         //
-          vsync_callback,                             //
-          compute_platform_resolved_locale_callback,  //
-      };
-
-  auto on_create_platform_view = InferPlatformViewCreationCallback(
-      config, user_data, platform_dispatch_table,
-      std::move(external_view_embedder_result.first));
-
-  if (!on_create_platform_view) {
-    return LOG_EMBEDDER_ERROR(
-        kInternalInconsistency,
-        "Could not infer platform view creation callback.");
-  }
-
-  flutter::Shell::CreateCallback<flutter::Rasterizer> on_create_rasterizer =
-      [](flutter::Shell& shell) {
-        return std::make_unique<flutter::Rasterizer>(shell);
-      };
+  return {
+      update_semantics_nodes_callback,            //
+      update_semantics_custom_actions_callback,   //
+      platform_message_response_callback,         //
+      vsync_callback,                             //
+      compute_platform_resolved_locale_callback,  //
+  };
+}
 
+static std::unique_ptr<flutter::EmbedderExternalTextureResolver>
+InferExternalTextureResolver(const FlutterRendererConfig* config,
+                             void* user_data) {
   using ExternalTextureResolver = flutter::EmbedderExternalTextureResolver;
   std::unique_ptr<ExternalTextureResolver> external_texture_resolver;
   external_texture_resolver = std::make_unique<ExternalTextureResolver>();
@@ -1255,6 +1212,179 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
   external_texture_resolver = std::make_unique<ExternalTextureResolver>(
       external_texture_metal_callback);
 #endif
+  return external_texture_resolver;
+}
+
+FlutterEngineResult FlutterEngineRun(size_t version,
+                                     const FlutterRendererConfig* config,
+                                     const FlutterProjectArgs* args,
+                                     void* user_data,
+                                     FLUTTER_API_SYMBOL(FlutterEngine) *
+                                         engine_out) {
+  auto result =
+      FlutterEngineInitialize(version, config, args, user_data, engine_out);
+
+  if (result != kSuccess) {
+    return result;
+  }
+
+  return FlutterEngineRunInitialized(*engine_out);
+}
+
+FlutterEngineResult FlutterEngineInitialize(size_t version,
+                                            const FlutterRendererConfig* config,
+                                            const FlutterProjectArgs* args,
+                                            void* user_data,
+                                            FLUTTER_API_SYMBOL(FlutterEngine) *
+                                                engine_out) {
+  // Step 0: Figure out arguments for shell creation.
+  if (version != FLUTTER_ENGINE_VERSION) {
+    return LOG_EMBEDDER_ERROR(
+        kInvalidLibraryVersion,
+        "Flutter embedder version mismatch. There has been a breaking change. "
+        "Please consult the changelog and update the embedder.");
+  }
+
+  if (engine_out == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "The engine out parameter was missing.");
+  }
+
+  if (args == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "The Flutter project arguments were missing.");
+  }
+
+  if (SAFE_ACCESS(args, assets_path, nullptr) == nullptr) {
+    return LOG_EMBEDDER_ERROR(
+        kInvalidArguments,
+        "The assets path in the Flutter project arguments was missing.");
+  }
+
+  if (SAFE_ACCESS(args, main_path__unused__, nullptr) != nullptr) {
+    FML_LOG(WARNING)
+        << "FlutterProjectArgs.main_path is deprecated and should be set null.";
+  }
+
+  if (SAFE_ACCESS(args, packages_path__unused__, nullptr) != nullptr) {
+    FML_LOG(WARNING) << "FlutterProjectArgs.packages_path is deprecated and "
+                        "should be set null.";
+  }
+
+  if (!IsRendererValid(config)) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "The renderer configuration was invalid.");
+  }
+
+  std::string icu_data_path;
+  if (SAFE_ACCESS(args, icu_data_path, nullptr) != nullptr) {
+    icu_data_path = SAFE_ACCESS(args, icu_data_path, nullptr);
+  }
+
+  if (SAFE_ACCESS(args, persistent_cache_path, nullptr) != nullptr) {
+    std::string persistent_cache_path =
+        SAFE_ACCESS(args, persistent_cache_path, nullptr);
+    flutter::PersistentCache::SetCacheDirectoryPath(persistent_cache_path);
+  }
+
+  if (SAFE_ACCESS(args, is_persistent_cache_read_only, false)) {
+    flutter::PersistentCache::gIsReadOnly = true;
+  }
+
+  fml::CommandLine command_line;
+  if (SAFE_ACCESS(args, command_line_argc, 0) != 0 &&
+      SAFE_ACCESS(args, command_line_argv, nullptr) != nullptr) {
+    command_line = fml::CommandLineFromArgcArgv(
+        SAFE_ACCESS(args, command_line_argc, 0),
+        SAFE_ACCESS(args, command_line_argv, nullptr));
+  }
+
+  flutter::Settings settings = flutter::SettingsFromCommandLine(command_line);
+
+  if (SAFE_ACCESS(args, aot_data, nullptr)) {
+    if (SAFE_ACCESS(args, vm_snapshot_data, nullptr) ||
+        SAFE_ACCESS(args, vm_snapshot_instructions, nullptr) ||
+        SAFE_ACCESS(args, isolate_snapshot_data, nullptr) ||
+        SAFE_ACCESS(args, isolate_snapshot_instructions, nullptr)) {
+      return LOG_EMBEDDER_ERROR(
+          kInvalidArguments,
+          "Multiple AOT sources specified. Embedders should provide either "
+          "*_snapshot_* buffers or aot_data, not both.");
+    }
+  }
+
+  PopulateSnapshotMappingCallbacks(args, settings);
+
+  settings.icu_data_path = icu_data_path;
+  settings.assets_path = args->assets_path;
+  settings.leak_vm = !SAFE_ACCESS(args, shutdown_dart_vm_when_done, false);
+  settings.old_gen_heap_size = SAFE_ACCESS(args, dart_old_gen_heap_size, -1);
+
+  if (!flutter::DartVM::IsRunningPrecompiledCode()) {
+    // Verify the assets path contains Dart 2 kernel assets.
+    const std::string kApplicationKernelSnapshotFileName = "kernel_blob.bin";
+    std::string application_kernel_path = fml::paths::JoinPaths(
+        {settings.assets_path, kApplicationKernelSnapshotFileName});
+    if (!fml::IsFile(application_kernel_path)) {
+      return LOG_EMBEDDER_ERROR(
+          kInvalidArguments,
+          "Not running in AOT mode but could not resolve the kernel binary.");
+    }
+    settings.application_kernel_asset = kApplicationKernelSnapshotFileName;
+  }
+
+  settings.task_observer_add = [](intptr_t key, fml::closure callback) {
+    fml::MessageLoop::GetCurrent().AddTaskObserver(key, std::move(callback));
+  };
+  settings.task_observer_remove = [](intptr_t key) {
+    fml::MessageLoop::GetCurrent().RemoveTaskObserver(key);
+  };
+  if (SAFE_ACCESS(args, root_isolate_create_callback, nullptr) != nullptr) {
+    VoidCallback callback =
+        SAFE_ACCESS(args, root_isolate_create_callback, nullptr);
+    settings.root_isolate_create_callback =
+        [callback, user_data](const auto& isolate) { callback(user_data); };
+  }
+  if (SAFE_ACCESS(args, log_message_callback, nullptr) != nullptr) {
+    FlutterLogMessageCallback callback =
+        SAFE_ACCESS(args, log_message_callback, nullptr);
+    settings.log_message_callback = [callback, user_data](
+                                        const std::string& tag,
+                                        const std::string& message) {
+      callback(tag.c_str(), message.c_str(), user_data);
+    };
+  }
+  if (SAFE_ACCESS(args, log_tag, nullptr) != nullptr) {
+    settings.log_tag = SAFE_ACCESS(args, log_tag, nullptr);
+  }
+
+  auto external_view_embedder_result =
+      InferExternalViewEmbedderFromArgs(SAFE_ACCESS(args, compositor, nullptr));
+  if (external_view_embedder_result.second) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "Compositor arguments were invalid.");
+  }
+
+  flutter::PlatformViewEmbedder::PlatformDispatchTable platform_dispatch_table =
+      InferPlatformDispatchTable(args, user_data);
+
+  auto on_create_platform_view = InferPlatformViewCreationCallback(
+      config, user_data, platform_dispatch_table,
+      std::move(external_view_embedder_result.first));
+
+  if (!on_create_platform_view) {
+    return LOG_EMBEDDER_ERROR(
+        kInternalInconsistency,
+        "Could not infer platform view creation callback.");
+  }
+
+  flutter::Shell::CreateCallback<flutter::Rasterizer> on_create_rasterizer =
+      [](flutter::Shell& shell) {
+        return std::make_unique<flutter::Rasterizer>(shell);
+      };
+
+  auto external_texture_resolver =
+      InferExternalTextureResolver(config, user_data);
 
   auto thread_host =
       flutter::EmbedderThreadHost::CreateEmbedderOrEngineManagedThreadHost(
@@ -1382,6 +1512,135 @@ FlutterEngineResult FlutterEngineShutdown(FLUTTER_API_SYMBOL(FlutterEngine)
   return kSuccess;
 }
 
+FlutterEngineResult FlutterEngineCreateShellPool(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    size_t capacity,
+    const char* entrypoint,
+    FlutterEngineShellPool* pool_out) {
+  if (engine == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Engine handle was invalid.");
+  }
+
+  if (pool_out == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Pool handle was invalid.");
+  }
+
+  auto embedder_engine = reinterpret_cast<flutter::EmbedderEngine*>(engine);
+  if (!embedder_engine->IsValid()) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Engine was not running.");
+  }
+
+  const flutter::Shell& spawner = embedder_engine->GetShell();
+  if (!spawner.GetTaskRunners()
+           .GetPlatformTaskRunner()
+           ->RunsTasksOnCurrentThread()) {
+    return LOG_EMBEDDER_ERROR(
+        kInvalidArguments,
+        "Shell pools must be created on the platform thread.");
+  }
+
+  auto run_configuration_factory =
+      [settings = spawner.GetSettings(),
+       dart_entrypoint = std::string{entrypoint ? entrypoint : ""}]() {
+        auto run_configuration =
+            flutter::RunConfiguration::InferFromSettings(settings);
+        if (!dart_entrypoint.empty()) {
+          run_configuration.SetEntrypoint(dart_entrypoint);
+        }
+        return run_configuration;
+      };
+
+  // The views of the idle shells are bound to a renderer when the shells are
+  // handed out.
+  flutter::Shell::CreateCallback<flutter::PlatformView>
+      on_create_platform_view = [](flutter::Shell& shell) {
+        return std::make_unique<flutter::PlatformViewEmbedder>(
+            shell, shell.GetTaskRunners());
+      };
+
+  flutter::Shell::CreateCallback<flutter::Rasterizer> on_create_rasterizer =
+      [](flutter::Shell& shell) {
+        return std::make_unique<flutter::Rasterizer>(shell);
+      };
+
+  auto pool = std::make_unique<flutter::ShellPool>(
+      spawner, capacity, std::move(run_configuration_factory),
+      std::move(on_create_platform_view), std::move(on_create_rasterizer));
+  pool->Fill();
+
+  *pool_out = reinterpret_cast<FlutterEngineShellPool>(pool.release());
+  return kSuccess;
+}
+
+FlutterEngineResult FlutterEngineAcquirePooledEngine(
+    FlutterEngineShellPool pool,
+    const FlutterRendererConfig* config,
+    const FlutterProjectArgs* args,
+    void* user_data,
+    FLUTTER_API_SYMBOL(FlutterEngine) * engine_out) {
+  if (pool == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Pool handle was invalid.");
+  }
+
+  if (engine_out == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "The engine out parameter was missing.");
+  }
+
+  if (!IsRendererValid(config)) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "The renderer configuration was invalid.");
+  }
+
+  if (SAFE_ACCESS(args, compositor, nullptr) != nullptr) {
+    return LOG_EMBEDDER_ERROR(
+        kInvalidArguments,
+        "Engines taken from a shell pool do not support compositors.");
+  }
+
+  auto on_create_platform_view = InferPlatformViewCreationCallback(
+      config, user_data, InferPlatformDispatchTable(args, user_data), nullptr);
+  if (!on_create_platform_view) {
+    return LOG_EMBEDDER_ERROR(
+        kInternalInconsistency,
+        "Could not infer platform view creation callback.");
+  }
+
+  auto shell = reinterpret_cast<flutter::ShellPool*>(pool)->Take();
+  if (!shell) {
+    return LOG_EMBEDDER_ERROR(kInternalInconsistency,
+                              "Could not spawn a shell for the engine.");
+  }
+
+  // The view of the pooled shell takes over the renderer of a view created
+  // for the arguments of this call, which is then discarded.
+  auto view = on_create_platform_view(*shell);
+  static_cast<flutter::PlatformViewEmbedder*>(shell->GetPlatformView().get())
+      ->Bind(static_cast<flutter::PlatformViewEmbedder&>(*view));
+  view.reset();
+
+  auto embedder_engine = std::make_unique<flutter::EmbedderEngine>(
+      std::move(shell), InferExternalTextureResolver(config, user_data));
+
+  if (!embedder_engine->NotifyCreated()) {
+    return LOG_EMBEDDER_ERROR(kInternalInconsistency,
+                              "Could not create platform view components.");
+  }
+
+  *engine_out = reinterpret_cast<FLUTTER_API_SYMBOL(FlutterEngine)>(
+      embedder_engine.release());
+  return kSuccess;
+}
+
+FlutterEngineResult FlutterEngineCollectShellPool(
+    FlutterEngineShellPool pool) {
+  if (pool == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Pool handle was invalid.");
+  }
+  delete reinterpret_cast<flutter::ShellPool*>(pool);
+  return kSuccess;
+}
+
 FlutterEngineResult FlutterEngineSendWindowMetricsEvent(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     const FlutterWindowMetricsEvent* flutter_metrics) {
@@ -1603,9 +1862,11 @@ FlutterEngineResult FlutterEngineSendKeyEvent(FLUTTER_API_SYMBOL(FlutterEngine)
                                   "running Flutter application.");
 }
 
-FlutterEngineResult FlutterEngineSendPlatformMessage(
+static FlutterEngineResult InternalSendPlatformMessage(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
-    const FlutterPlatformMessage* flutter_message) {
+    const FlutterPlatformMessage* flutter_message,
+    FlutterPlatformMessageReleaseCallback release_callback,
+    void* release_user_data) {
   if (engine == nullptr) {
     return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid engine handle.");
   }
@@ -1638,8 +1899,25 @@ FlutterEngineResult FlutterEngineSendPlatformMessage(
 
   fml::RefPtr<flutter::PlatformMessage> message;
   if (message_size == 0) {
+    if (release_callback != nullptr) {
+      // Nothing to hand over. Give the buffer back right away.
+      release_callback(const_cast<uint8_t*>(message_data), message_size,
+                       release_user_data);
+    }
     message = fml::MakeRefCounted<flutter::PlatformMessage>(
         flutter_message->channel, response);
+  } else if (release_callback != nullptr) {
+    // The engine takes ownership of the buffer. It is released when the last
+    // reader, possibly a Dart ByteData aliasing it, is done with it.
+    auto release_proc = [release_callback, release_user_data](
+                            const uint8_t* data, size_t size) {
+      release_callback(const_cast<uint8_t*>(data), size, release_user_data);
+    };
+    message = fml::MakeRefCounted<flutter::PlatformMessage>(
+        flutter_message->channel,
+        std::make_unique<fml::NonOwnedMapping>(message_data, message_size,
+                                               release_proc),
+        response);
   } else {
     message = fml::MakeRefCounted<flutter::PlatformMessage>(
         flutter_message->channel,
@@ -1655,6 +1933,25 @@ FlutterEngineResult FlutterEngineSendPlatformMessage(
                                   "Flutter application.");
 }
 
+FlutterEngineResult FlutterEngineSendPlatformMessage(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessage* flutter_message) {
+  return InternalSendPlatformMessage(engine, flutter_message, nullptr, nullptr);
+}
+
+FlutterEngineResult FlutterEngineSendPlatformMessageWithReleaseCallback(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessage* flutter_message,
+    FlutterPlatformMessageReleaseCallback release_callback,
+    void* release_user_data) {
+  if (release_callback == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "Release callback was nullptr.");
+  }
+  return InternalSendPlatformMessage(engine, flutter_message, release_callback,
+                                     release_user_data);
+}
+
 FlutterEngineResult FlutterPlatformMessageCreateResponseHandle(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     FlutterDataCallback data_callback,
@@ -2279,6 +2576,8 @@ FlutterEngineResult FlutterEngineGetProcAddresses(
   SET_PROC(SendPointerEvent, FlutterEngineSendPointerEvent);
   SET_PROC(SendKeyEvent, FlutterEngineSendKeyEvent);
   SET_PROC(SendPlatformMessage, FlutterEngineSendPlatformMessage);
+  SET_PROC(SendPlatformMessageWithReleaseCallback,
+           FlutterEngineSendPlatformMessageWithReleaseCallback);
   SET_PROC(PlatformMessageCreateResponseHandle,
            FlutterPlatformMessageCreateResponseHandle);
   SET_PROC(PlatformMessageReleaseResponseHandle,
@@ -2308,6 +2607,9 @@ FlutterEngineResult FlutterEngineGetProcAddresses(
   SET_PROC(PostCallbackOnAllNativeThreads,
            FlutterEnginePostCallbackOnAllNativeThreads);
   SET_PROC(NotifyDisplayUpdate, FlutterEngineNotifyDisplayUpdate);
+  SET_PROC(CreateShellPool, FlutterEngineCreateShellPool);
+  SET_PROC(AcquirePooledEngine, FlutterEngineAcquirePooledEngine);
+  SET_PROC(CollectShellPool, FlutterEngineCollectShellPool);
 #undef SET_PROC
 
   return kSuccess;
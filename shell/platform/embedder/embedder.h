@@ -536,6 +536,71 @@ typedef struct {
   FlutterMetalTextureFrameCallback external_texture_frame_callback;
 } FlutterMetalRendererConfig;
 
+typedef enum {
+  /// The native 32-bit RGBA format of the engine, which is also the format of
+  /// the buffers given to `surface_present_callback`.
+  kFlutterSoftwarePixelFormatNative32,
+  /// 32 bits per pixel, with the red, green, blue and alpha channels in that
+  /// order in memory.
+  kFlutterSoftwarePixelFormatRGBA8888,
+  /// 32 bits per pixel, with the blue, green, red and alpha channels in that
+  /// order in memory.
+  kFlutterSoftwarePixelFormatBGRA8888,
+  /// 16 bits per pixel in native endianness, with 5 bits of red in the most
+  /// significant bits, 6 bits of green and 5 bits of blue. Opaque.
+  kFlutterSoftwarePixelFormatRGB565,
+} FlutterSoftwarePixelFormat;
+
+/// A buffer owned by the embedder that the engine renders frames into.
+///
+/// See: \ref FlutterSoftwareRendererConfig.swapchain_callback.
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterSoftwareSwapchainBuffer).
+  size_t struct_size;
+  /// The pixels of the buffer. Must hold at least `row_bytes` times the height
+  /// of the frame bytes.
+  void* allocation;
+  /// The number of bytes between the starts of two rows of the buffer.
+  size_t row_bytes;
+  /// The format of the pixels of the buffer.
+  FlutterSoftwarePixelFormat pixel_format;
+} FlutterSoftwareSwapchainBuffer;
+
+/// Callback for when the engine needs the buffers to render frames of a new
+/// size into. The engine sets the `struct_size` of the buffers in the array
+/// and the number of buffers that fit into it before the call. The embedder
+/// fills in the first buffers of the array and sets their number, which must
+/// be at least one.
+typedef bool (*FlutterSoftwareSwapchainCallback)(
+    void* /* user data */,
+    const FlutterFrameInfo* /* frame info */,
+    FlutterSoftwareSwapchainBuffer* /* buffers */,
+    size_t* /* buffer count */);
+
+/// This information is passed to the embedder when a buffer of the swapchain
+/// is presented.
+///
+/// See: \ref FlutterSoftwareRendererConfig.swapchain_present_callback.
+typedef struct {
+  /// The size of this struct. Must be
+  /// sizeof(FlutterSoftwareSwapchainPresentInfo).
+  size_t struct_size;
+  /// The index of the presented buffer in the buffers returned by the last
+  /// call to the `swapchain_callback`.
+  size_t buffer_index;
+  /// The regions of the buffer that changed since the last presented frame,
+  /// in pixels. Pixels outside of them are the same as in the last presented
+  /// frame.
+  const FlutterRect* damage;
+  /// The number of regions in `damage`.
+  size_t damage_count;
+} FlutterSoftwareSwapchainPresentInfo;
+
+/// Callback for when a buffer of the swapchain is presented.
+typedef bool (*FlutterSoftwareSwapchainPresentCallback)(
+    void* /* user data */,
+    const FlutterSoftwareSwapchainPresentInfo* /* present info */);
+
 typedef struct {
   /// The size of this struct. Must be sizeof(FlutterSoftwareRendererConfig).
   size_t struct_size;
@@ -543,7 +608,27 @@ typedef struct {
   /// to the user. The pixel format of the buffer is the native 32-bit RGBA
   /// format. The buffer is owned by the Flutter engine and must be copied in
   /// this callback if needed.
+  ///
+  /// Required unless the `swapchain_callback` and the
+  /// `swapchain_present_callback` are specified.
   SoftwareSurfacePresentCallback surface_present_callback;
+  /// Specifying both or none of the `swapchain_callback` and the
+  /// `swapchain_present_callback` is required. When specified, the engine
+  /// renders directly into a ring of buffers owned by the embedder instead of
+  /// a buffer of its own, and the `surface_present_callback` is not called.
+  ///
+  /// The engine renders into the buffers in order, starting with the first,
+  /// and the embedder must not modify them. A buffer that is rendered into
+  /// but not presented, e.g. because the frame was discarded, is rendered
+  /// into again by the next frame. A presented buffer is only rendered into
+  /// again once all the other buffers have been presented, so with two
+  /// buffers the embedder may read from the presented buffer until the next
+  /// one is presented.
+  FlutterSoftwareSwapchainCallback swapchain_callback;
+  /// The callback presented to the embedder to present a buffer of the
+  /// swapchain along with the regions that changed since the last presented
+  /// frame.
+  FlutterSoftwareSwapchainPresentCallback swapchain_present_callback;
 } FlutterSoftwareRendererConfig;
 
 typedef struct {
@@ -740,6 +825,13 @@ typedef struct {
   const FlutterPlatformMessageResponseHandle* response_handle;
 } FlutterPlatformMessage;
 
+/// Invoked when the engine no longer needs a buffer handed over using
+/// `FlutterEngineSendPlatformMessageWithReleaseCallback`.
+typedef void (*FlutterPlatformMessageReleaseCallback)(
+    uint8_t* /* data */,
+    size_t /* size */,
+    void* /* user data */);
+
 typedef void (*FlutterPlatformMessageCallback)(
     const FlutterPlatformMessage* /* message*/,
     void* /* user data */);
@@ -1318,6 +1410,10 @@ typedef void (*FlutterLogMessageCallback)(const char* /* tag */,
 /// FlutterEngine instance in AOT mode.
 typedef struct _FlutterEngineAOTData* FlutterEngineAOTData;
 
+/// An opaque object that holds idle engines spawned from a running engine,
+/// which are handed out to new views by `FlutterEngineAcquirePooledEngine`.
+typedef struct _FlutterEngineShellPool* FlutterEngineShellPool;
+
 typedef struct {
   /// The size of this struct. Must be sizeof(FlutterProjectArgs).
   size_t struct_size;
@@ -1696,6 +1792,72 @@ FLUTTER_EXPORT
 FlutterEngineResult FlutterEngineRunInitialized(
     FLUTTER_API_SYMBOL(FlutterEngine) engine);
 
+//------------------------------------------------------------------------------
+/// @brief      Creates a pool of idle engines spawned from a running engine,
+///             for embedders that show many short-lived views and need an
+///             engine for a new view within a frame. The engines are spawned
+///             one per platform task, and share the task runners, the Dart
+///             VM and the isolate group of the running engine. Their Dart
+///             entrypoint runs while they are idle.
+///
+/// @attention  The pool must be created and used on the platform thread, and
+///             must be collected via `FlutterEngineCollectShellPool` before
+///             the running engine is shut down.
+///
+/// @param[in]  engine      A running engine instance.
+/// @param[in]  capacity    The number of idle engines to keep.
+/// @param[in]  entrypoint  The Dart entrypoint of the engines, or NULL to use
+///                         `main`.
+/// @param[out] pool_out    The pool handle on successful creation.
+///
+/// @return     Returns if the pool was created.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineCreateShellPool(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    size_t capacity,
+    const char* entrypoint,
+    FlutterEngineShellPool* pool_out);
+
+//------------------------------------------------------------------------------
+/// @brief      Hands out an idle engine of the pool for a new view, or spawns
+///             one if the pool is empty, and binds it to the renderer and the
+///             callbacks of the view. The pool is filled again in later
+///             platform tasks. The engine is running and is shut down via
+///             `FlutterEngineShutdown`.
+///
+/// @attention  Only the platform message and semantics callbacks of `args`
+///             are used. The engine uses the task runners of the engine the
+///             pool was created from, and does not support compositors.
+///
+/// @param[in]  pool        The pool to take the engine from.
+/// @param[in]  config      The renderer configuration of the view.
+/// @param[in]  args        The callbacks of the view. May be NULL.
+/// @param      user_data   A user data baton passed back to embedders in
+///                         callbacks.
+/// @param[out] engine_out  The engine handle on success.
+///
+/// @return     The result of the call to acquire the engine.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineAcquirePooledEngine(
+    FlutterEngineShellPool pool,
+    const FlutterRendererConfig* config,
+    const FlutterProjectArgs* args,
+    void* user_data,
+    FLUTTER_API_SYMBOL(FlutterEngine) * engine_out);
+
+//------------------------------------------------------------------------------
+/// @brief      Collects the pool and its idle engines. The engines handed out
+///             by the pool keep running.
+///
+/// @param[in]  pool  The pool to collect.
+///
+/// @return     Returns if the pool was collected.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineCollectShellPool(FlutterEngineShellPool pool);
+
 FLUTTER_EXPORT
 FlutterEngineResult FlutterEngineSendWindowMetricsEvent(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
@@ -1738,6 +1900,37 @@ FlutterEngineResult FlutterEngineSendPlatformMessage(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     const FlutterPlatformMessage* message);
 
+//------------------------------------------------------------------------------
+/// @brief      Sends a platform message to the engine without copying its
+///             payload. The engine takes ownership of the buffer pointed to by
+///             the `message` field of the platform message and hands it back
+///             by invoking the release callback once it no longer needs it.
+///             Large payloads are exposed to the Dart application directly, so
+///             the buffer must be writable and must not be modified or freed
+///             by the embedder before the release callback is invoked.
+///
+///             Unless this call returns `kInvalidArguments`, the release
+///             callback is invoked exactly once, possibly on a different
+///             thread and possibly after this call returns.
+///
+/// @see        FlutterEngineSendPlatformMessage()
+///
+/// @param[in]  engine             A running engine instance.
+/// @param[in]  message            The platform message to send.
+/// @param[in]  release_callback   The callback invoked when the engine is
+///                                done with the message buffer.
+/// @param[in]  release_user_data  The user data baton passed to the release
+///                                callback.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineSendPlatformMessageWithReleaseCallback(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessage* message,
+    FlutterPlatformMessageReleaseCallback release_callback,
+    void* release_user_data);
+
 //------------------------------------------------------------------------------
 /// @brief     Creates a platform message response handle that allows the
 ///            embedder to set a native callback for a response to a message.
@@ -2254,6 +2447,12 @@ typedef FlutterEngineResult (*FlutterEngineSendKeyEventFnPtr)(
 typedef FlutterEngineResult (*FlutterEngineSendPlatformMessageFnPtr)(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     const FlutterPlatformMessage* message);
+typedef FlutterEngineResult (
+    *FlutterEngineSendPlatformMessageWithReleaseCallbackFnPtr)(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessage* message,
+    FlutterPlatformMessageReleaseCallback release_callback,
+    void* release_user_data);
 typedef FlutterEngineResult (
     *FlutterEnginePlatformMessageCreateResponseHandleFnPtr)(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
@@ -2329,6 +2528,19 @@ typedef FlutterEngineResult (*FlutterEngineNotifyDisplayUpdateFnPtr)(
     FlutterEngineDisplaysUpdateType update_type,
     const FlutterEngineDisplay* displays,
     size_t display_count);
+typedef FlutterEngineResult (*FlutterEngineCreateShellPoolFnPtr)(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    size_t capacity,
+    const char* entrypoint,
+    FlutterEngineShellPool* pool_out);
+typedef FlutterEngineResult (*FlutterEngineAcquirePooledEngineFnPtr)(
+    FlutterEngineShellPool pool,
+    const FlutterRendererConfig* config,
+    const FlutterProjectArgs* args,
+    void* user_data,
+    FLUTTER_API_SYMBOL(FlutterEngine) * engine_out);
+typedef FlutterEngineResult (*FlutterEngineCollectShellPoolFnPtr)(
+    FlutterEngineShellPool pool);
 
 /// Function-pointer-based versions of the APIs above.
 typedef struct {
@@ -2373,6 +2585,11 @@ typedef struct {
   FlutterEnginePostCallbackOnAllNativeThreadsFnPtr
       PostCallbackOnAllNativeThreads;
   FlutterEngineNotifyDisplayUpdateFnPtr NotifyDisplayUpdate;
+  FlutterEngineSendPlatformMessageWithReleaseCallbackFnPtr
+      SendPlatformMessageWithReleaseCallback;
+  FlutterEngineCreateShellPoolFnPtr CreateShellPool;
+  FlutterEngineAcquirePooledEngineFnPtr AcquirePooledEngine;
+  FlutterEngineCollectShellPoolFnPtr CollectShellPool;
 } FlutterEngineProcTable;
 
 //------------------------------------------------------------------------------
@@ -31,6 +31,12 @@ class EmbedderEngine {
                  std::unique_ptr<EmbedderExternalTextureResolver>
                      external_texture_resolver);
 
+  // Wraps a running shell, such as one handed out by a shell pool. The tasks
+  // of its task runners are run by the engine that owns their thread host.
+  EmbedderEngine(std::unique_ptr<Shell> shell,
+                 std::unique_ptr<EmbedderExternalTextureResolver>
+                     external_texture_resolver);
+
   ~EmbedderEngine();
 
   bool LaunchShell();
@@ -4,6 +4,8 @@
 
 #include "flutter/shell/platform/embedder/embedder_surface_software.h"
 
+#include <algorithm>
+
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/gpu/GrDirectContext.h"
 
@@ -11,10 +13,13 @@ namespace flutter {
 
 EmbedderSurfaceSoftware::EmbedderSurfaceSoftware(
     SoftwareDispatchTable software_dispatch_table,
+    size_t raster_tile_count,
     std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder)
     : software_dispatch_table_(software_dispatch_table),
+      raster_tile_count_(raster_tile_count),
       external_view_embedder_(external_view_embedder) {
-  if (!software_dispatch_table_.software_present_backing_store) {
+  if (!software_dispatch_table_.software_present_backing_store &&
+      !UsesSwapchain()) {
     return;
   }
   valid_ = true;
@@ -33,7 +38,8 @@ std::unique_ptr<Surface> EmbedderSurfaceSoftware::CreateGPUSurface() {
     return nullptr;
   }
   const bool render_to_surface = !external_view_embedder_;
-  auto surface = std::make_unique<GPUSurfaceSoftware>(this, render_to_surface);
+  auto surface = std::make_unique<GPUSurfaceSoftware>(this, render_to_surface,
+                                                      raster_tile_count_);
 
   if (!surface->IsValid()) {
     return nullptr;
@@ -57,6 +63,10 @@ sk_sp<SkSurface> EmbedderSurfaceSoftware::AcquireBackingStore(
     return nullptr;
   }
 
+  if (UsesSwapchain()) {
+    return AcquireSwapchainBuffer(size);
+  }
+
   if (sk_surface_ != nullptr &&
       SkISize::Make(sk_surface_->width(), sk_surface_->height()) == size) {
     // The old and new surface sizes are the same. Nothing to do here.
@@ -83,6 +93,12 @@ bool EmbedderSurfaceSoftware::PresentBackingStore(
     return false;
   }
 
+  if (UsesSwapchain()) {
+    return PresentSwapchainBuffer(
+        backing_store,
+        SkIRect::MakeWH(backing_store->width(), backing_store->height()));
+  }
+
   SkPixmap pixmap;
   if (!backing_store->peekPixels(&pixmap)) {
     FML_LOG(ERROR) << "Could not peek the pixels of the backing store.";
@@ -106,4 +122,52 @@ bool EmbedderSurfaceSoftware::PresentBackingStore(
   );
 }
 
+// |GPUSurfaceSoftwareDelegate|
+bool EmbedderSurfaceSoftware::PresentBackingStoreRegion(
+    sk_sp<SkSurface> backing_store,
+    const SkIRect& damage) {
+  if (!IsValid() || !UsesSwapchain()) {
+    return PresentBackingStore(std::move(backing_store));
+  }
+  return PresentSwapchainBuffer(backing_store, damage);
+}
+
+bool EmbedderSurfaceSoftware::UsesSwapchain() const {
+  return software_dispatch_table_.software_acquire_swapchain &&
+         software_dispatch_table_.software_present_swapchain_buffer;
+}
+
+sk_sp<SkSurface> EmbedderSurfaceSoftware::AcquireSwapchainBuffer(
+    const SkISize& size) {
+  const bool size_changed =
+      swapchain_.empty() || SkISize::Make(swapchain_.front()->width(),
+                                          swapchain_.front()->height()) != size;
+  if (size_changed) {
+    TRACE_EVENT0("flutter", "EmbedderSurfaceSoftware::AcquireSwapchain");
+    swapchain_ = software_dispatch_table_.software_acquire_swapchain(size);
+    next_swapchain_index_ = 0;
+    if (swapchain_.empty()) {
+      FML_LOG(ERROR) << "Could not acquire the software swapchain from the "
+                        "embedder.";
+      return nullptr;
+    }
+  }
+  return swapchain_[next_swapchain_index_];
+}
+
+bool EmbedderSurfaceSoftware::PresentSwapchainBuffer(
+    const sk_sp<SkSurface>& backing_store,
+    const SkIRect& damage) {
+  auto buffer = std::find(swapchain_.begin(), swapchain_.end(), backing_store);
+  if (buffer == swapchain_.end()) {
+    FML_LOG(ERROR) << "Tried to present a buffer that is not part of the "
+                      "software swapchain.";
+    return false;
+  }
+  const size_t buffer_index = buffer - swapchain_.begin();
+  next_swapchain_index_ = (buffer_index + 1) % swapchain_.size();
+  return software_dispatch_table_.software_present_swapchain_buffer(
+      buffer_index, {damage});
+}
+
 }  // namespace flutter
@@ -5,6 +5,8 @@
 #ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_SOFTWARE_H_
 #define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_SOFTWARE_H_
 
+#include <vector>
+
 #include "flutter/fml/macros.h"
 #include "flutter/shell/gpu/gpu_surface_software.h"
 #include "flutter/shell/platform/embedder/embedder_external_view_embedder.h"
@@ -17,11 +19,16 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
  public:
   struct SoftwareDispatchTable {
     std::function<bool(const void* allocation, size_t row_bytes, size_t height)>
-        software_present_backing_store;  // required
+        software_present_backing_store;  // required unless swapchain
+    std::function<std::vector<sk_sp<SkSurface>>(const SkISize& size)>
+        software_acquire_swapchain;  // optional
+    std::function<bool(size_t buffer_index, const std::vector<SkIRect>& damage)>
+        software_present_swapchain_buffer;  // optional
   };
 
   EmbedderSurfaceSoftware(
       SoftwareDispatchTable software_dispatch_table,
+      size_t raster_tile_count,
       std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder);
 
   ~EmbedderSurfaceSoftware() override;
@@ -29,7 +36,12 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
  private:
   bool valid_ = false;
   SoftwareDispatchTable software_dispatch_table_;
+  const size_t raster_tile_count_;
   sk_sp<SkSurface> sk_surface_;
+  // The buffers owned by the embedder that frames are rendered into in turn,
+  // when the embedder provides a swapchain.
+  std::vector<sk_sp<SkSurface>> swapchain_;
+  size_t next_swapchain_index_ = 0;
   std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder_;
 
   // |EmbedderSurface|
@@ -47,6 +59,17 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
   // |GPUSurfaceSoftwareDelegate|
   bool PresentBackingStore(sk_sp<SkSurface> backing_store) override;
 
+  // |GPUSurfaceSoftwareDelegate|
+  bool PresentBackingStoreRegion(sk_sp<SkSurface> backing_store,
+                                 const SkIRect& damage) override;
+
+  bool UsesSwapchain() const;
+
+  sk_sp<SkSurface> AcquireSwapchainBuffer(const SkISize& size);
+
+  bool PresentSwapchainBuffer(const sk_sp<SkSurface>& backing_store,
+                              const SkIRect& damage);
+
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderSurfaceSoftware);
 };
 
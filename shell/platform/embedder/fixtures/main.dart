@@ -554,6 +554,32 @@ void render_gradient() {
   PlatformDispatcher.instance.scheduleFrame();
 }
 
+@pragma('vm:entry-point')
+void render_box_that_changes_color() {
+  int frame = 0;
+  PlatformDispatcher.instance.onBeginFrame = (Duration duration) {
+    Color red = Color.fromARGB(255, 255, 0, 0);
+    Color blue = Color.fromARGB(255, 0, 0, 255);
+
+    SceneBuilder builder = SceneBuilder();
+
+    builder.pushOffset(0.0, 0.0);
+
+    builder.addPicture(
+        Offset(0.0, 0.0), CreateGradientBox(Size(800.0, 600.0)));
+
+    // Only the box differs from the previous frame.
+    builder.addPicture(Offset(100.0, 100.0),
+        CreateColoredBox(frame.isEven ? red : blue, Size(50.0, 50.0)));
+
+    builder.pop();
+
+    PlatformDispatcher.instance.views.first.render(builder.build());
+    frame++;
+  };
+  PlatformDispatcher.instance.scheduleFrame();
+}
+
 @pragma('vm:entry-point')
 void render_texture() {
   PlatformDispatcher.instance.onBeginFrame = (Duration duration) {
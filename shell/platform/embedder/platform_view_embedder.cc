@@ -10,12 +10,14 @@ PlatformViewEmbedder::PlatformViewEmbedder(
     PlatformView::Delegate& delegate,
     flutter::TaskRunners task_runners,
     EmbedderSurfaceSoftware::SoftwareDispatchTable software_dispatch_table,
+    size_t raster_tile_count,
     PlatformDispatchTable platform_dispatch_table,
     std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder)
     : PlatformView(delegate, std::move(task_runners)),
       external_view_embedder_(external_view_embedder),
       embedder_surface_(
           std::make_unique<EmbedderSurfaceSoftware>(software_dispatch_table,
+                                                    raster_tile_count,
                                                     external_view_embedder_)),
       platform_dispatch_table_(platform_dispatch_table) {}
 
@@ -49,8 +51,25 @@ PlatformViewEmbedder::PlatformViewEmbedder(
       platform_dispatch_table_(platform_dispatch_table) {}
 #endif
 
+PlatformViewEmbedder::PlatformViewEmbedder(PlatformView::Delegate& delegate,
+                                           flutter::TaskRunners task_runners)
+    : PlatformView(delegate, std::move(task_runners)) {}
+
 PlatformViewEmbedder::~PlatformViewEmbedder() = default;
 
+void PlatformViewEmbedder::Bind(PlatformViewEmbedder& view) {
+  FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
+  FML_DCHECK(embedder_surface_ == nullptr);
+  embedder_surface_ = std::move(view.embedder_surface_);
+  platform_dispatch_table_.update_semantics_nodes_callback =
+      std::move(view.platform_dispatch_table_.update_semantics_nodes_callback);
+  platform_dispatch_table_.update_semantics_custom_actions_callback =
+      std::move(view.platform_dispatch_table_
+                    .update_semantics_custom_actions_callback);
+  platform_dispatch_table_.platform_message_response_callback = std::move(
+      view.platform_dispatch_table_.platform_message_response_callback);
+}
+
 void PlatformViewEmbedder::UpdateSemantics(
     flutter::SemanticsNodeUpdates update,
     flutter::CustomAccessibilityActionUpdates actions) {
@@ -99,7 +118,8 @@ PlatformViewEmbedder::CreateExternalViewEmbedder() {
 // |PlatformView|
 sk_sp<GrDirectContext> PlatformViewEmbedder::CreateResourceContext() const {
   if (embedder_surface_ == nullptr) {
-    FML_LOG(ERROR) << "Embedder surface was null.";
+    // The shells of a shell pool are spawned before their view is bound, and
+    // use the resource context of the spawning shell.
     return nullptr;
   }
   return embedder_surface_->CreateResourceContext();
@@ -53,6 +53,7 @@ class PlatformViewEmbedder final : public PlatformView {
       PlatformView::Delegate& delegate,
       flutter::TaskRunners task_runners,
       EmbedderSurfaceSoftware::SoftwareDispatchTable software_dispatch_table,
+      size_t raster_tile_count,
       PlatformDispatchTable platform_dispatch_table,
       std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder);
 
@@ -77,8 +78,19 @@ class PlatformViewEmbedder final : public PlatformView {
       std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder);
 #endif
 
+  // Creates a platform view without a rasterizer, for the shells of a shell
+  // pool. The view is given one by |Bind| when its shell is handed out.
+  PlatformViewEmbedder(PlatformView::Delegate& delegate,
+                       flutter::TaskRunners task_runners);
+
   ~PlatformViewEmbedder() override;
 
+  // Moves the rasterizer and the platform thread callbacks of |view| to this
+  // view, which must have been created without a rasterizer and must not be
+  // created yet. The vsync and locale callbacks, which are called on the UI
+  // thread while the shell is idle, stay unset.
+  void Bind(PlatformViewEmbedder& view);
+
   // |PlatformView|
   void UpdateSemantics(
       flutter::SemanticsNodeUpdates update,
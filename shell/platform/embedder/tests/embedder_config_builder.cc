@@ -120,12 +120,40 @@ FlutterProjectArgs& EmbedderConfigBuilder::GetProjectArgs() {
   return project_args_;
 }
 
+FlutterRendererConfig& EmbedderConfigBuilder::GetRendererConfig() {
+  return renderer_config_;
+}
+
 void EmbedderConfigBuilder::SetSoftwareRendererConfig(SkISize surface_size) {
   renderer_config_.type = FlutterRendererType::kSoftware;
   renderer_config_.software = software_renderer_config_;
   context_.SetupSurface(surface_size);
 }
 
+void EmbedderConfigBuilder::SetSoftwareSwapchainRendererConfig(
+    SkISize surface_size,
+    size_t buffer_count) {
+  SetSoftwareRendererConfig(surface_size);
+  FML_CHECK(context_.GetContextType() ==
+            EmbedderTestContextType::kSoftwareContext);
+  static_cast<EmbedderTestContextSoftware&>(context_)
+      .SetSwapchainBufferCount(buffer_count);
+  renderer_config_.software.surface_present_callback = nullptr;
+  renderer_config_.software.swapchain_callback =
+      [](void* context, const FlutterFrameInfo* frame_info,
+         FlutterSoftwareSwapchainBuffer* buffers,
+         size_t* buffer_count) -> bool {
+    return reinterpret_cast<EmbedderTestContextSoftware*>(context)
+        ->GetSwapchainBuffers(*frame_info, buffers, buffer_count);
+  };
+  renderer_config_.software.swapchain_present_callback =
+      [](void* context,
+         const FlutterSoftwareSwapchainPresentInfo* present_info) -> bool {
+    return reinterpret_cast<EmbedderTestContextSoftware*>(context)
+        ->PresentSwapchainBuffer(*present_info);
+  };
+}
+
 void EmbedderConfigBuilder::SetOpenGLFBOCallBack() {
 #ifdef SHELL_ENABLE_GL
   // SetOpenGLRendererConfig must be called before this.
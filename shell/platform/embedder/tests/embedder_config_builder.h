@@ -44,8 +44,15 @@ class EmbedderConfigBuilder {
 
   FlutterProjectArgs& GetProjectArgs();
 
+  FlutterRendererConfig& GetRendererConfig();
+
   void SetSoftwareRendererConfig(SkISize surface_size = SkISize::Make(1, 1));
 
+  // Sets a software renderer config that renders into a swapchain of
+  // |buffer_count| buffers owned by the test context.
+  void SetSoftwareSwapchainRendererConfig(SkISize surface_size,
+                                          size_t buffer_count);
+
   void SetOpenGLRendererConfig(SkISize surface_size);
 
   void SetMetalRendererConfig(SkISize surface_size);
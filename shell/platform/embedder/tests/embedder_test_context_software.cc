@@ -11,6 +11,7 @@
 #include "flutter/shell/platform/embedder/tests/embedder_test_compositor_software.h"
 #include "flutter/testing/testing.h"
 #include "third_party/dart/runtime/bin/elf_loader.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkSurface.h"
 
 namespace flutter {
@@ -30,6 +31,71 @@ bool EmbedderTestContextSoftware::Present(sk_sp<SkImage> image) {
   return true;
 }
 
+void EmbedderTestContextSoftware::SetSwapchainBufferCount(
+    size_t buffer_count) {
+  swapchain_buffer_count_ = buffer_count;
+}
+
+bool EmbedderTestContextSoftware::GetSwapchainBuffers(
+    const FlutterFrameInfo& frame_info,
+    FlutterSoftwareSwapchainBuffer* buffers,
+    size_t* buffer_count) {
+  if (*buffer_count < swapchain_buffer_count_) {
+    return false;
+  }
+  swapchain_acquire_count_++;
+  swapchain_.clear();
+  for (size_t i = 0; i < swapchain_buffer_count_; i++) {
+    auto surface = SkSurface::MakeRasterN32Premul(frame_info.size.width,
+                                                  frame_info.size.height);
+    SkPixmap pixmap;
+    if (!surface || !surface->peekPixels(&pixmap)) {
+      return false;
+    }
+    buffers[i].allocation = pixmap.writable_addr();
+    buffers[i].row_bytes = pixmap.rowBytes();
+    buffers[i].pixel_format = kFlutterSoftwarePixelFormatNative32;
+    swapchain_.push_back(std::move(surface));
+  }
+  *buffer_count = swapchain_buffer_count_;
+  return true;
+}
+
+bool EmbedderTestContextSoftware::PresentSwapchainBuffer(
+    const FlutterSoftwareSwapchainPresentInfo& present_info) {
+  if (present_info.buffer_index >= swapchain_.size()) {
+    return false;
+  }
+  last_swapchain_buffer_index_ = present_info.buffer_index;
+  last_swapchain_damage_.clear();
+  for (size_t i = 0; i < present_info.damage_count; i++) {
+    const FlutterRect& rect = present_info.damage[i];
+    last_swapchain_damage_.push_back(
+        SkIRect::MakeLTRB(rect.left, rect.top, rect.right, rect.bottom));
+  }
+  // The buffer is rendered into again later, so the image must be a copy.
+  SkBitmap bitmap;
+  bitmap.allocPixels(swapchain_[present_info.buffer_index]->imageInfo());
+  if (!swapchain_[present_info.buffer_index]->readPixels(bitmap, 0, 0)) {
+    return false;
+  }
+  bitmap.setImmutable();
+  return Present(SkImage::MakeFromBitmap(bitmap));
+}
+
+size_t EmbedderTestContextSoftware::GetSwapchainAcquireCount() const {
+  return swapchain_acquire_count_;
+}
+
+size_t EmbedderTestContextSoftware::GetLastSwapchainBufferIndex() const {
+  return last_swapchain_buffer_index_;
+}
+
+std::vector<SkIRect> EmbedderTestContextSoftware::GetLastSwapchainDamage()
+    const {
+  return last_swapchain_damage_;
+}
+
 size_t EmbedderTestContextSoftware::GetSurfacePresentCount() const {
   return software_surface_present_count_;
 }
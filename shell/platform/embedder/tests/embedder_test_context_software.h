@@ -5,6 +5,8 @@
 #ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_TESTS_EMBEDDER_CONTEXT_SOFTWARE_H_
 #define FLUTTER_SHELL_PLATFORM_EMBEDDER_TESTS_EMBEDDER_CONTEXT_SOFTWARE_H_
 
+#include <vector>
+
 #include "flutter/shell/platform/embedder/tests/embedder_test_context.h"
 
 namespace flutter {
@@ -23,6 +25,24 @@ class EmbedderTestContextSoftware : public EmbedderTestContext {
 
   bool Present(sk_sp<SkImage> image);
 
+  void SetSwapchainBufferCount(size_t buffer_count);
+
+  bool GetSwapchainBuffers(const FlutterFrameInfo& frame_info,
+                           FlutterSoftwareSwapchainBuffer* buffers,
+                           size_t* buffer_count);
+
+  bool PresentSwapchainBuffer(
+      const FlutterSoftwareSwapchainPresentInfo& present_info);
+
+  // The number of times the engine asked for the buffers of the swapchain.
+  size_t GetSwapchainAcquireCount() const;
+
+  // The index of the last presented buffer of the swapchain.
+  size_t GetLastSwapchainBufferIndex() const;
+
+  // The damage of the last presented buffer of the swapchain.
+  std::vector<SkIRect> GetLastSwapchainDamage() const;
+
  protected:
   virtual void SetupCompositor() override;
 
@@ -30,6 +50,11 @@ class EmbedderTestContextSoftware : public EmbedderTestContext {
   sk_sp<SkSurface> surface_;
   SkISize surface_size_;
   size_t software_surface_present_count_ = 0;
+  size_t swapchain_buffer_count_ = 0;
+  std::vector<sk_sp<SkSurface>> swapchain_;
+  size_t swapchain_acquire_count_ = 0;
+  size_t last_swapchain_buffer_index_ = 0;
+  std::vector<SkIRect> last_swapchain_damage_;
   void SetupSurface(SkISize surface_size) override;
 
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderTestContextSoftware);
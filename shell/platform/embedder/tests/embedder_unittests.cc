@@ -452,6 +452,129 @@ TEST_F(EmbedderTest, InvalidPlatformMessages) {
   ASSERT_EQ(result, kInvalidArguments);
 }
 
+//------------------------------------------------------------------------------
+/// Tests that a platform message buffer handed over with a release callback
+/// reaches Dart intact and is handed back to the embedder once the engine no
+/// longer needs it.
+///
+TEST_F(EmbedderTest, PlatformMessagesCanBeSentWithReleaseCallback) {
+  struct Captures {
+    fml::AutoResetWaitableEvent response_latch;
+    fml::AutoResetWaitableEvent release_latch;
+    std::vector<uint8_t> response;
+    uint8_t* released_data = nullptr;
+    size_t released_size = 0;
+  };
+  Captures captures;
+
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  builder.SetDartEntrypoint("platform_messages_response");
+
+  fml::AutoResetWaitableEvent ready;
+  context.AddNativeCallback(
+      "SignalNativeTest",
+      CREATE_NATIVE_ENTRY(
+          [&ready](Dart_NativeArguments args) { ready.Signal(); }));
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  // Large enough to be handed to Dart as external typed data.
+  const size_t kMessageSize = 1 << 20;
+  uint8_t* message_data = new uint8_t[kMessageSize];
+  for (size_t i = 0; i < kMessageSize; ++i) {
+    message_data[i] = static_cast<uint8_t>(i);
+  }
+
+  FlutterPlatformMessageResponseHandle* response_handle = nullptr;
+  auto response_callback = [](const uint8_t* data, size_t size,
+                              void* user_data) -> void {
+    auto captures = reinterpret_cast<Captures*>(user_data);
+    captures->response.assign(data, data + size);
+    captures->response_latch.Signal();
+  };
+  auto result = FlutterPlatformMessageCreateResponseHandle(
+      engine.get(), response_callback, &captures, &response_handle);
+  ASSERT_EQ(result, kSuccess);
+
+  FlutterPlatformMessage message = {};
+  message.struct_size = sizeof(FlutterPlatformMessage);
+  message.channel = "test_channel";
+  message.message = message_data;
+  message.message_size = kMessageSize;
+  message.response_handle = response_handle;
+
+  auto release_callback = [](uint8_t* data, size_t size, void* user_data) {
+    auto captures = reinterpret_cast<Captures*>(user_data);
+    captures->released_data = data;
+    captures->released_size = size;
+    delete[] data;
+    captures->release_latch.Signal();
+  };
+
+  ready.Wait();
+  result = FlutterEngineSendPlatformMessageWithReleaseCallback(
+      engine.get(), &message, release_callback, &captures);
+  ASSERT_EQ(result, kSuccess);
+  result = FlutterPlatformMessageReleaseResponseHandle(engine.get(),
+                                                       response_handle);
+  ASSERT_EQ(result, kSuccess);
+
+  captures.response_latch.Wait();
+  ASSERT_EQ(captures.response.size(), kMessageSize);
+  for (size_t i = 0; i < kMessageSize; ++i) {
+    ASSERT_EQ(captures.response[i], static_cast<uint8_t>(i));
+  }
+
+  // The ByteData aliasing the buffer is finalized no later than isolate
+  // shutdown.
+  engine.reset();
+  captures.release_latch.Wait();
+  ASSERT_EQ(captures.released_data, message_data);
+  ASSERT_EQ(captures.released_size, kMessageSize);
+}
+
+//------------------------------------------------------------------------------
+/// Tests that an empty buffer handed over with a release callback is given
+/// back right away, and that invalid arguments leave ownership with the
+/// embedder.
+///
+TEST_F(EmbedderTest, PlatformMessageReleaseCallbackOwnership) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  size_t release_count = 0;
+  auto release_callback = [](uint8_t* data, size_t size, void* user_data) {
+    ++*reinterpret_cast<size_t*>(user_data);
+  };
+
+  FlutterPlatformMessage platform_message = {};
+  platform_message.struct_size = sizeof(FlutterPlatformMessage);
+  platform_message.channel = "test_channel";
+  platform_message.message = nullptr;
+  platform_message.message_size = 0;
+
+  auto result = FlutterEngineSendPlatformMessageWithReleaseCallback(
+      engine.get(), &platform_message, release_callback, &release_count);
+  ASSERT_EQ(result, kSuccess);
+  ASSERT_EQ(release_count, 1u);
+
+  platform_message.message_size = 1;
+  result = FlutterEngineSendPlatformMessageWithReleaseCallback(
+      engine.get(), &platform_message, release_callback, &release_count);
+  ASSERT_EQ(result, kInvalidArguments);
+  ASSERT_EQ(release_count, 1u);
+
+  result = FlutterEngineSendPlatformMessageWithReleaseCallback(
+      engine.get(), &platform_message, nullptr, nullptr);
+  ASSERT_EQ(result, kInvalidArguments);
+}
+
 //------------------------------------------------------------------------------
 /// Tests that setting a custom log callback works as expected and defaults to
 /// using tag "flutter".
@@ -564,6 +687,139 @@ TEST_F(EmbedderTest, VMAndIsolateSnapshotSizesAreRedundantInAOTMode) {
   ASSERT_TRUE(engine.is_valid());
 }
 
+//------------------------------------------------------------------------------
+/// Asserts that the software renderer renders into the buffers of a swapchain
+/// owned by the embedder and presents them along with the damaged region.
+///
+TEST_F(EmbedderTest, CanRenderIntoSoftwareSwapchain) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetDartEntrypoint("render_gradient");
+  builder.SetSoftwareSwapchainRendererConfig(SkISize::Make(800, 600), 2);
+
+  auto rendered_scene = context.GetNextSceneImage();
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  // Send a window metrics events so frames may be scheduled.
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+
+  auto image = rendered_scene.get();
+  ASSERT_TRUE(image);
+  EXPECT_EQ(image->dimensions(), SkISize::Make(800, 600));
+
+  auto& software_context = static_cast<EmbedderTestContextSoftware&>(context);
+  EXPECT_EQ(software_context.GetSwapchainAcquireCount(), 1u);
+  EXPECT_EQ(software_context.GetLastSwapchainBufferIndex(), 0u);
+  // The first frame is damaged as a whole.
+  EXPECT_EQ(software_context.GetLastSwapchainDamage(),
+            std::vector<SkIRect>{SkIRect::MakeWH(800, 600)});
+}
+
+#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
+//------------------------------------------------------------------------------
+/// Asserts that a frame that changes part of the previous one is presented to
+/// the software swapchain with the changed region only.
+///
+TEST_F(EmbedderTest, SoftwareSwapchainPresentsOnlyTheDamagedRegion) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetDartEntrypoint("render_box_that_changes_color");
+  builder.SetSoftwareSwapchainRendererConfig(SkISize::Make(800, 600), 1);
+
+  auto first_scene = context.GetNextSceneImage();
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+  ASSERT_TRUE(first_scene.get());
+
+  // The metrics event schedules a frame in which only the box changes color.
+  auto second_scene = context.GetNextSceneImage();
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+  ASSERT_TRUE(second_scene.get());
+
+  auto& software_context = static_cast<EmbedderTestContextSoftware&>(context);
+  const std::vector<SkIRect> damage =
+      software_context.GetLastSwapchainDamage();
+  ASSERT_EQ(damage.size(), 1u);
+  EXPECT_TRUE(damage[0].contains(SkIRect::MakeXYWH(100, 100, 50, 50)));
+  EXPECT_FALSE(damage[0].contains(SkIRect::MakeWH(800, 600)));
+}
+#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
+
+//------------------------------------------------------------------------------
+/// Asserts that an engine taken from a shell pool renders with the renderer it
+/// is bound to when it is handed out.
+///
+TEST_F(EmbedderTest, EngineFromShellPoolRendersIntoBoundView) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetDartEntrypoint("render_gradient");
+  builder.SetSoftwareRendererConfig(SkISize::Make(800, 600));
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  FlutterEngineShellPool pool = nullptr;
+  ASSERT_EQ(FlutterEngineCreateShellPool(engine.get(), 1, "render_gradient",
+                                         &pool),
+            kSuccess);
+  ASSERT_NE(pool, nullptr);
+  // Spawns the idle engine of the pool on this platform thread.
+  ASSERT_EQ(__FlutterEngineFlushPendingTasksNow(), kSuccess);
+
+  auto rendered_scene = context.GetNextSceneImage();
+
+  FlutterEngine pooled_engine = nullptr;
+  ASSERT_EQ(FlutterEngineAcquirePooledEngine(
+                pool, &builder.GetRendererConfig(), &builder.GetProjectArgs(),
+                &context, &pooled_engine),
+            kSuccess);
+  ASSERT_NE(pooled_engine, nullptr);
+
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(pooled_engine, &event),
+            kSuccess);
+
+  auto image = rendered_scene.get();
+  ASSERT_TRUE(image);
+  EXPECT_EQ(image->dimensions(), SkISize::Make(800, 600));
+
+  // Engines taken from the pool can't composite platform views.
+  builder.SetCompositor();
+  FlutterEngine composited_engine = nullptr;
+  EXPECT_EQ(FlutterEngineAcquirePooledEngine(
+                pool, &builder.GetRendererConfig(), &builder.GetProjectArgs(),
+                &context, &composited_engine),
+            kInvalidArguments);
+
+  ASSERT_EQ(FlutterEngineShutdown(pooled_engine), kSuccess);
+  ASSERT_EQ(FlutterEngineCollectShellPool(pool), kSuccess);
+}
+
 //------------------------------------------------------------------------------
 /// Test the layer structure and pixels rendered when using a custom software
 /// compositor.
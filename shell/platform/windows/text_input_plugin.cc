@@ -10,6 +10,7 @@
 #include <iostream>
 
 #include "flutter/shell/platform/common/json_method_codec.h"
+#include "flutter/shell/platform/common/text_editing_delta_json.h"
 #include "flutter/shell/platform/windows/flutter_windows_view.h"
 
 static constexpr char kSetEditingStateMethod[] = "TextInput.setEditingState";
@@ -25,11 +26,14 @@ static constexpr char kMultilineInputType[] = "TextInputType.multiline";
 
 static constexpr char kUpdateEditingStateMethod[] =
     "TextInputClient.updateEditingState";
+static constexpr char kUpdateEditingStateWithDeltasMethod[] =
+    "TextInputClient.updateEditingStateWithDeltas";
 static constexpr char kPerformActionMethod[] = "TextInputClient.performAction";
 
 static constexpr char kTextInputAction[] = "inputAction";
 static constexpr char kTextInputType[] = "inputType";
 static constexpr char kTextInputTypeName[] = "name";
+static constexpr char kEnableDeltaModel[] = "enableDeltaModel";
 static constexpr char kComposingBaseKey[] = "composingBase";
 static constexpr char kComposingExtentKey[] = "composingExtent";
 static constexpr char kSelectionAffinityKey[] = "selectionAffinity";
@@ -185,7 +189,14 @@ void TextInputPlugin::HandleMethodCall(
         input_type_ = input_type_json->value.GetString();
       }
     }
+    enable_delta_model_ = false;
+    auto enable_delta_model_json = client_config.FindMember(kEnableDeltaModel);
+    if (enable_delta_model_json != client_config.MemberEnd() &&
+        enable_delta_model_json->value.IsBool()) {
+      enable_delta_model_ = enable_delta_model_json->value.GetBool();
+    }
     active_model_ = std::make_unique<TextInputModel>();
+    active_model_->set_record_deltas(enable_delta_model_);
   } else if (method.compare(kSetEditingStateMethod) == 0) {
     if (!method_call.arguments() || method_call.arguments()->IsNull()) {
       result->Error(kBadArgumentError, "Method invoked without args");
@@ -220,6 +231,8 @@ void TextInputPlugin::HandleMethodCall(
       selection_base = selection_extent = 0;
     }
     active_model_->SetText(text->value.GetString());
+    // The framework already knows about this change.
+    active_model_->TakeDeltas();
     active_model_->SetSelection(TextRange(selection_base, selection_extent));
 
     base = args.FindMember(kComposingBaseKey);
@@ -308,7 +321,12 @@ Rect TextInputPlugin::GetCursorRect() const {
   return {transformed_point, composing_rect_.size()};
 }
 
-void TextInputPlugin::SendStateUpdate(const TextInputModel& model) {
+void TextInputPlugin::SendStateUpdate(TextInputModel& model) {
+  if (enable_delta_model_) {
+    SendDeltaUpdate(model);
+    return;
+  }
+
   auto args = std::make_unique<rapidjson::Document>(rapidjson::kArrayType);
   auto& allocator = args->GetAllocator();
   args->PushBack(client_id_, allocator);
@@ -333,6 +351,11 @@ void TextInputPlugin::SendStateUpdate(const TextInputModel& model) {
   channel_->InvokeMethod(kUpdateEditingStateMethod, std::move(args));
 }
 
+void TextInputPlugin::SendDeltaUpdate(TextInputModel& model) {
+  channel_->InvokeMethod(kUpdateEditingStateWithDeltasMethod,
+                         TakeEditingStateWithDeltas(client_id_, model));
+}
+
 void TextInputPlugin::EnterPressed(TextInputModel* model) {
   if (input_type_ == kMultilineInputType) {
     model->AddText(std::u16string({u'\n'}));
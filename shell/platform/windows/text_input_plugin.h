@@ -58,7 +58,10 @@ class TextInputPlugin : public KeyboardHandlerBase {
 
  private:
   // Sends the current state of the given model to the Flutter engine.
-  void SendStateUpdate(const TextInputModel& model);
+  void SendStateUpdate(TextInputModel& model);
+
+  // Sends the edits made to |model| since the last update to the framework.
+  void SendDeltaUpdate(TextInputModel& model);
 
   // Sends an action triggered by the Enter key to the Flutter engine.
   void EnterPressed(TextInputModel* model);
@@ -88,6 +91,10 @@ class TextInputPlugin : public KeyboardHandlerBase {
   // https://api.flutter.dev/flutter/services/TextInputType-class.html
   std::string input_type_;
 
+  // Whether the framework asked for edits to be reported as deltas rather
+  // than as the whole text.
+  bool enable_delta_model_ = false;
+
   // An action requested by the user on the input client. See available options:
   // https://api.flutter.dev/flutter/services/TextInputAction-class.html
   std::string input_action_;
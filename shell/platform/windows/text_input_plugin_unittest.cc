@@ -5,8 +5,11 @@
 
 #include <rapidjson/document.h>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "flutter/shell/platform/common/json_message_codec.h"
+#include "flutter/shell/platform/common/json_method_codec.h"
 #include "flutter/shell/platform/windows/flutter_windows_view.h"
 #include "flutter/shell/platform/windows/testing/test_binary_messenger.h"
 #include "gmock/gmock.h"
@@ -59,5 +62,96 @@ TEST(TextInputPluginTest, TextMethodsWorksWithEmptyModel) {
   // Passes if it did not crash
 }
 
+TEST(TextInputPluginTest, SendsDeltasMatchingFrameworkSchema) {
+  std::vector<rapidjson::Document> updates;
+  TestBinaryMessenger messenger([&updates](const std::string& channel,
+                                           const uint8_t* message,
+                                           size_t message_size,
+                                           BinaryReply reply) {
+    auto method_call =
+        JsonMethodCodec::GetInstance().DecodeMethodCall(message, message_size);
+    if (method_call->method_name() ==
+        "TextInputClient.updateEditingStateWithDeltas") {
+      rapidjson::Document update;
+      update.CopyFrom(*method_call->arguments(), update.GetAllocator());
+      updates.push_back(std::move(update));
+    }
+  });
+  EmptyTextInputPluginDelegate delegate;
+  TextInputPlugin handler(&messenger, &delegate);
+
+  auto args = std::make_unique<rapidjson::Document>(rapidjson::kArrayType);
+  auto& allocator = args->GetAllocator();
+  rapidjson::Value config(rapidjson::kObjectType);
+  config.AddMember("enableDeltaModel", true, allocator);
+  args->PushBack(123, allocator);
+  args->PushBack(config, allocator);
+  auto encoded = JsonMethodCodec::GetInstance().EncodeMethodCall(
+      MethodCall<rapidjson::Document>("TextInput.setClient", std::move(args)));
+  EXPECT_TRUE(messenger.SimulateEngineMessage(
+      "flutter/textinput", encoded->data(), encoded->size(),
+      [](const uint8_t* reply, size_t reply_size) {}));
+
+  handler.TextHook(nullptr, u"abc");
+  handler.ComposeBeginHook();
+  handler.ComposeChangeHook(u"x", 1);
+  handler.ComposeChangeHook(u"xy", 2);
+  handler.ComposeEndHook();
+  ASSERT_FALSE(updates.empty());
+
+  // Applies every delta the way TextEditingDelta.fromJSON and
+  // TextEditingDelta.apply do in the framework.
+  std::string text;
+  for (const rapidjson::Document& update : updates) {
+    ASSERT_TRUE(update.IsArray());
+    ASSERT_EQ(update.Size(), 2u);
+    EXPECT_EQ(update[0].GetInt(), 123);
+    const rapidjson::Value& deltas = update[1]["deltas"];
+    ASSERT_TRUE(deltas.IsArray());
+    ASSERT_GT(deltas.Size(), 0u);
+    for (const rapidjson::Value& delta : deltas.GetArray()) {
+      ASSERT_TRUE(delta["oldText"].IsString());
+      ASSERT_TRUE(delta["deltaText"].IsString());
+      ASSERT_TRUE(delta["deltaStart"].IsInt());
+      ASSERT_TRUE(delta["deltaEnd"].IsInt());
+      ASSERT_TRUE(delta["selectionBase"].IsInt());
+      ASSERT_TRUE(delta["selectionExtent"].IsInt());
+      ASSERT_TRUE(delta["selectionAffinity"].IsString());
+      ASSERT_TRUE(delta["selectionIsDirectional"].IsBool());
+      ASSERT_TRUE(delta["composingBase"].IsInt());
+      ASSERT_TRUE(delta["composingExtent"].IsInt());
+
+      EXPECT_EQ(delta["oldText"].GetString(), text);
+      const int start = delta["deltaStart"].GetInt();
+      const int end = delta["deltaEnd"].GetInt();
+      if (start == -1) {
+        EXPECT_EQ(end, -1);
+        EXPECT_STREQ(delta["deltaText"].GetString(), "");
+      } else {
+        ASSERT_LE(0, start);
+        ASSERT_LE(start, end);
+        ASSERT_LE(end, static_cast<int>(text.length()));
+        text.replace(start, end - start, delta["deltaText"].GetString());
+      }
+
+      const int length = static_cast<int>(text.length());
+      EXPECT_LE(0, delta["selectionBase"].GetInt());
+      EXPECT_LE(delta["selectionBase"].GetInt(), length);
+      EXPECT_LE(0, delta["selectionExtent"].GetInt());
+      EXPECT_LE(delta["selectionExtent"].GetInt(), length);
+      const int composing_base = delta["composingBase"].GetInt();
+      const int composing_extent = delta["composingExtent"].GetInt();
+      if (composing_base == -1) {
+        EXPECT_EQ(composing_extent, -1);
+      } else {
+        EXPECT_LE(0, composing_base);
+        EXPECT_LE(composing_base, composing_extent);
+        EXPECT_LE(composing_extent, length);
+      }
+    }
+  }
+  EXPECT_EQ(text, "abcxy");
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -65,13 +65,16 @@ class TesterExternalViewEmbedder : public ExternalViewEmbedder {
 class TesterPlatformView : public PlatformView,
                            public GPUSurfaceSoftwareDelegate {
  public:
-  TesterPlatformView(Delegate& delegate, TaskRunners task_runners)
-      : PlatformView(delegate, std::move(task_runners)) {}
+  TesterPlatformView(Delegate& delegate,
+                     TaskRunners task_runners,
+                     size_t raster_tile_count)
+      : PlatformView(delegate, std::move(task_runners)),
+        raster_tile_count_(raster_tile_count) {}
 
   // |PlatformView|
   std::unique_ptr<Surface> CreateRenderingSurface() override {
     auto surface = std::make_unique<GPUSurfaceSoftware>(
-        this, true /* render to surface */);
+        this, true /* render to surface */, raster_tile_count_);
     FML_DCHECK(surface->IsValid());
     return surface;
   }
@@ -109,6 +112,7 @@ class TesterPlatformView : public PlatformView,
   }
 
  private:
+  const size_t raster_tile_count_;
   sk_sp<SkSurface> sk_surface_ = nullptr;
   std::shared_ptr<TesterExternalViewEmbedder> external_view_embedder_ =
       std::make_shared<TesterExternalViewEmbedder>();
@@ -221,8 +225,9 @@ int RunTester(const flutter::Settings& settings,
 
   Shell::CreateCallback<PlatformView> on_create_platform_view =
       [](Shell& shell) {
-        return std::make_unique<TesterPlatformView>(shell,
-                                                    shell.GetTaskRunners());
+        return std::make_unique<TesterPlatformView>(
+            shell, shell.GetTaskRunners(),
+            shell.GetSettings().software_raster_tile_count);
       };
 
   Shell::CreateCallback<Rasterizer> on_create_rasterizer = [](Shell& shell) {
@@ -84,6 +84,40 @@ void main() {
       <int>[0, 240, 246],
     ]));
   });
+
+  test('ProgressiveCodec decodes the data added so far', () async {
+    final Uint8List data = await _getSkiaResource('baby_tux.png').readAsBytes();
+    final int half = data.length ~/ 2;
+    final ui.ProgressiveCodec codec = ui.ProgressiveCodec();
+    expect(codec.frameCount, 1);
+    expect(codec.repetitionCount, 0);
+    try {
+      await codec.getNextFrame();
+      fail('exception not thrown');
+    } catch(e) {
+      expect(e, exceptionWithMessage('Codec failed'));
+    }
+
+    codec.addData(await ui.ImmutableBuffer.fromUint8List(
+        Uint8List.view(data.buffer, data.offsetInBytes, half)));
+    ui.FrameInfo frameInfo = await codec.getNextFrame();
+    expect(frameInfo.image.width, 240);
+    expect(frameInfo.image.height, 246);
+
+    final ui.ImmutableBuffer rest = await ui.ImmutableBuffer.fromUint8List(
+        Uint8List.view(data.buffer, data.offsetInBytes + half));
+    codec.addData(rest);
+    rest.dispose();
+    codec.setDataComplete();
+    frameInfo = await codec.getNextFrame();
+    final ui.Codec fullCodec = await ui.instantiateImageCodec(data);
+    final ui.FrameInfo fullFrameInfo = await fullCodec.getNextFrame();
+    final ByteData pixels = await frameInfo.image.toByteData();
+    final ByteData fullPixels = await fullFrameInfo.image.toByteData();
+    expect(pixels.buffer.asUint8List(), fullPixels.buffer.asUint8List());
+
+    expect(() => codec.addData(rest), throwsStateError);
+  });
 }
 
 /// Returns a File handle to a file in the skia/resources directory.
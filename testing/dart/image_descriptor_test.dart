@@ -38,6 +38,35 @@ void main() {
     expect(codec.frameCount, 1);
   });
 
+  test('image descriptor - encoded - region', () async {
+    final Uint8List bytes = await readFile('square.png');
+    final ImmutableBuffer buffer = await ImmutableBuffer.fromUint8List(bytes);
+    final ImageDescriptor descriptor = await ImageDescriptor.encoded(buffer);
+
+    Codec codec = await descriptor.instantiateCodec(
+      region: const Rect.fromLTRB(2, 2, 8, 6),
+    );
+    FrameInfo frame = await codec.getNextFrame();
+    expect(frame.image.width, 6);
+    expect(frame.image.height, 4);
+
+    codec = await descriptor.instantiateCodec(
+      targetWidth: 3,
+      region: const Rect.fromLTRB(2, 2, 8, 6),
+    );
+    frame = await codec.getNextFrame();
+    expect(frame.image.width, 3);
+    expect(frame.image.height, 2);
+
+    // Regions are clipped to the image.
+    codec = await descriptor.instantiateCodec(
+      region: const Rect.fromLTRB(5, 5, 20, 20),
+    );
+    frame = await codec.getNextFrame();
+    expect(frame.image.width, 5);
+    expect(frame.image.height, 5);
+  });
+
   test('basic image descriptor - encoded - animated', () async {
     final Uint8List bytes = await _getSkiaResource('test640x479.gif').readAsBytes();
     final ImmutableBuffer buffer = await ImmutableBuffer.fromUint8List(bytes);
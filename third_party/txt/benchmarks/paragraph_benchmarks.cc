@@ -27,6 +27,8 @@
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkColor.h"
+#include "third_party/skia/include/core/SkFontMgr.h"
+#include "txt/fallback_font_index.h"
 #include "txt/font_collection.h"
 #include "txt/font_skia.h"
 #include "txt/font_style.h"
@@ -119,6 +121,111 @@ BENCHMARK_F(ParagraphFixture, LongLayout)(benchmark::State& state) {
   }
 }
 
+static void LayoutMixedScriptParagraph(
+    const std::shared_ptr<FontCollection>& font_collection) {
+  const char* text =
+      "Hello 你好世界 مرحبا بالعالم 😀🎉👍 こんにちは 안녕하세요 "
+      "Привет мир שלום עולם नमस्ते दुनिया สวัสดีชาวโลก";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+  txt::ParagraphBuilderTxt builder(paragraph_style, font_collection);
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = BuildParagraph(builder);
+  paragraph->Layout(300);
+}
+
+// The first layout of a paragraph mixing CJK, Arabic, emoji and other scripts
+// that Roboto doesn't cover, which falls back to the system fonts, as after
+// launching the app. With an argument of 1 the fallback fonts are found in
+// the index saved by a previous launch.
+static void BM_ParagraphFirstLayoutWithSystemFallback(
+    benchmark::State& state) {
+  sk_sp<SkData> saved_index;
+  if (state.range(0) != 0) {
+    auto index = std::make_shared<FallbackFontIndex>();
+    std::shared_ptr<FontCollection> font_collection = GetTestFontCollection();
+    font_collection->SetDefaultFontManager(SkFontMgr::RefDefault());
+    font_collection->SetFallbackFontIndex(index);
+    LayoutMixedScriptParagraph(font_collection);
+    saved_index = index->Serialize();
+  }
+
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    std::shared_ptr<FontCollection> font_collection = GetTestFontCollection();
+    state.ResumeTiming();
+
+    font_collection->SetDefaultFontManager(SkFontMgr::RefDefault());
+    if (saved_index) {
+      auto index = std::make_shared<FallbackFontIndex>();
+      index->Deserialize(saved_index->bytes(), saved_index->size());
+      font_collection->SetFallbackFontIndex(index);
+    }
+    LayoutMixedScriptParagraph(font_collection);
+
+    // Purges the layout caches.
+    state.PauseTiming();
+    font_collection.reset();
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(BM_ParagraphFirstLayoutWithSystemFallback)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMicrosecond);
+
+// Lays out the same paragraph at many widths, as when a window is resized or
+// the intrinsic width of the text is probed. With an argument of 1 every
+// layout starts over as if the text had changed.
+BENCHMARK_DEFINE_F(ParagraphFixture, LongLayoutWidthSweep)
+(benchmark::State& state) {
+  const char* text =
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line. Sometimes, short sentence. Longer "
+      "sentences are okay too because they are necessary. Very short. "
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+      "tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim "
+      "veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea "
+      "commodo consequat. Duis aute irure dolor in reprehenderit in voluptate "
+      "velit esse cillum dolore eu fugiat nulla pariatur. Excepteur sint "
+      "occaecat cupidatat non proident, sunt in culpa qui officia deserunt "
+      "mollit anim id est laborum.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilderTxt builder(paragraph_style, font_collection_);
+
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = BuildParagraph(builder);
+  const bool relayout_from_scratch = state.range(0) == 1;
+  int width = 0;
+  while (state.KeepRunning()) {
+    if (relayout_from_scratch) {
+      paragraph->SetDirty();
+    }
+    paragraph->Layout(200 + width);
+    width = (width + 1) % 400;
+  }
+}
+BENCHMARK_REGISTER_F(ParagraphFixture, LongLayoutWidthSweep)->Arg(0)->Arg(1);
+
 BENCHMARK_F(ParagraphFixture, JustifyLayout)(benchmark::State& state) {
   const char* text =
       "This is a very long sentence to test if the text will properly wrap "
@@ -389,6 +496,34 @@ BENCHMARK_REGISTER_F(ParagraphFixture, MinikinDoLayout)
     ->Range(1 << 7, 1 << 14)
     ->Complexity(benchmark::oN);
 
+// Lays out text on several threads at once, like background isolates measuring
+// text while the UI thread lays out paragraphs. Every thread lays out words of
+// its own, so both shaping and layout cache hits run concurrently.
+static void BM_MinikinDoLayoutMultiThreaded(benchmark::State& state) {
+  static std::shared_ptr<minikin::FontCollection> collection =
+      GetTestFontCollection()->GetMinikinFontCollectionForFamilies(
+          std::vector<std::string>(1, "Roboto"), "en-US");
+
+  std::vector<uint16_t> text;
+  for (int i = 0; i < state.range(0); ++i) {
+    text.push_back(i % 6 == 5 ? ' '
+                              : 'a' + (i * 7 + state.thread_index * 3) % 26);
+  }
+  minikin::FontStyle font(4, false);
+  minikin::MinikinPaint paint;
+  paint.size = 14;
+
+  while (state.KeepRunning()) {
+    minikin::Layout layout;
+    layout.doLayout(text.data(), 0, text.size(), text.size(), false, font,
+                    paint, collection);
+  }
+}
+BENCHMARK(BM_MinikinDoLayoutMultiThreaded)
+    ->Arg(1 << 10)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
 BENCHMARK_DEFINE_F(ParagraphFixture, AddStyleRun)(benchmark::State& state) {
   std::vector<uint16_t> text;
   for (uint16_t i = 0; i < 16000 * 2; ++i) {
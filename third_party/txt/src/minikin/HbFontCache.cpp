@@ -18,6 +18,8 @@
 
 #include "HbFontCache.h"
 
+#include <mutex>
+
 #include <log/log.h>
 #include <utils/LruCache.h>
 
@@ -25,10 +27,12 @@
 #include <hb.h>
 
 #include <minikin/MinikinFont.h>
-#include "MinikinInternal.h"
 
 namespace minikin {
 
+// Unlike the other minikin caches, the HarfBuzz font cache has its own lock
+// instead of relying on gMinikinLock, so that text can be shaped on several
+// threads at once.
 class HbFontCache : private android::OnEntryRemoved<int32_t, hb_font_t*> {
  public:
   HbFontCache() : mCache(kMaxEntries) {
@@ -48,47 +52,52 @@ class HbFontCache : private android::OnEntryRemoved<int32_t, hb_font_t*> {
 
   void remove(int32_t fontId) { mCache.remove(fontId); }
 
+  std::mutex& mutex() { return mMutex; }
+
  private:
   static const size_t kMaxEntries = 100;
 
+  std::mutex mMutex;
   android::LruCache<int32_t, hb_font_t*> mCache;
 };
 
-HbFontCache* getFontCacheLocked() {
-  assertMinikinLocked();
-  static HbFontCache* cache = nullptr;
-  if (cache == nullptr) {
-    cache = new HbFontCache();
-  }
+static HbFontCache* getFontCache() {
+  static HbFontCache* cache = new HbFontCache();
   return cache;
 }
 
-void purgeHbFontCacheLocked() {
-  assertMinikinLocked();
-  getFontCacheLocked()->clear();
+void purgeHbFontCache() {
+  HbFontCache* fontCache = getFontCache();
+  std::scoped_lock _l(fontCache->mutex());
+  fontCache->clear();
 }
 
-void purgeHbFontLocked(const MinikinFont* minikinFont) {
-  assertMinikinLocked();
+void purgeHbFont(const MinikinFont* minikinFont) {
+  HbFontCache* fontCache = getFontCache();
   const int32_t fontId = minikinFont->GetUniqueId();
-  getFontCacheLocked()->remove(fontId);
+  std::scoped_lock _l(fontCache->mutex());
+  fontCache->remove(fontId);
 }
 
 // Returns a new reference to a hb_font_t object, caller is
 // responsible for calling hb_font_destroy() on it.
-hb_font_t* getHbFontLocked(const MinikinFont* minikinFont) {
-  assertMinikinLocked();
+//
+// The returned font is immutable and shared between threads. Callers that
+// need to change its scale or functions must create a sub font of it.
+hb_font_t* getHbFont(const MinikinFont* minikinFont) {
   // TODO: get rid of nullFaceFont
-  static hb_font_t* nullFaceFont = nullptr;
+  static hb_font_t* nullFaceFont = [] {
+    hb_font_t* font = hb_font_create(nullptr);
+    hb_font_make_immutable(font);
+    return font;
+  }();
   if (minikinFont == nullptr) {
-    if (nullFaceFont == nullptr) {
-      nullFaceFont = hb_font_create(nullptr);
-    }
     return hb_font_reference(nullFaceFont);
   }
 
-  HbFontCache* fontCache = getFontCacheLocked();
+  HbFontCache* fontCache = getFontCache();
   const int32_t fontId = minikinFont->GetUniqueId();
+  std::scoped_lock _l(fontCache->mutex());
   hb_font_t* font = fontCache->get(fontId);
   if (font != nullptr) {
     return hb_font_reference(font);
@@ -108,6 +117,7 @@ hb_font_t* getHbFontLocked(const MinikinFont* minikinFont) {
     variations.push_back({variation.axisTag, variation.value});
   }
   hb_font_set_variations(font, variations.data(), variations.size());
+  hb_font_make_immutable(font);
   hb_font_destroy(parent_font);
   hb_face_destroy(face);
   fontCache->put(fontId, font);
@@ -22,6 +22,8 @@
 #include <algorithm>
 #include <fstream>
 #include <iostream>  // for debugging
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -89,6 +91,8 @@ class LayoutCacheKey {
 
   android::hash_t hash() const { return mHash; }
 
+  size_t getTextBytes() const { return mNchars * sizeof(uint16_t); }
+
   void copyText() {
     uint16_t* charsCopy = new uint16_t[mNchars];
     memcpy(charsCopy, mChars, mNchars * sizeof(uint16_t));
@@ -129,53 +133,104 @@ class LayoutCacheKey {
   android::hash_t computeHash() const;
 };
 
-class LayoutCache : private android::OnEntryRemoved<LayoutCacheKey, Layout*> {
+// A least recently used cache of the layouts of words.
+//
+// Text is laid out on the UI thread as well as on background isolates, so the
+// cache is split into shards that are locked independently: lookups of
+// different words rarely contend, and no lock is held while a missing word is
+// shaped. Each shard evicts its least recently used entries once the layouts
+// it holds use more than its share of |kMaxBytes|.
+class LayoutCache {
  public:
-  LayoutCache() : mCache(kMaxEntries) {
-    mCache.setOnEntryRemovedListener(this);
+  LayoutCache() = default;
+
+  void clear() {
+    for (Shard& shard : mShards) {
+      std::scoped_lock _l(shard.mutex);
+      shard.cache.clear();
+    }
   }
 
-  void clear() { mCache.clear(); }
-
-  Layout* get(LayoutCacheKey& key,
-              LayoutContext* ctx,
-              const std::shared_ptr<FontCollection>& collection) {
-    Layout* layout = mCache.get(key);
-    if (layout == NULL) {
-      key.copyText();
-      layout = new Layout();
-      key.doLayout(layout, ctx, collection);
-      mCache.put(key, layout);
+  std::shared_ptr<Layout> get(
+      LayoutCacheKey& key,
+      LayoutContext* ctx,
+      const std::shared_ptr<FontCollection>& collection) {
+    Shard& shard = mShards[key.hash() % kShardCount];
+    {
+      std::scoped_lock _l(shard.mutex);
+      const std::shared_ptr<Layout>& layout = shard.cache.get(key);
+      if (layout != nullptr) {
+        return layout;
+      }
+    }
+
+    auto layout = std::make_shared<Layout>();
+    key.doLayout(layout.get(), ctx, collection);
+
+    std::scoped_lock _l(shard.mutex);
+    // Another thread may have laid out the same word in the meantime.
+    const std::shared_ptr<Layout>& cached = shard.cache.get(key);
+    if (cached != nullptr) {
+      return cached;
+    }
+    key.copyText();
+    shard.bytes += getEntryBytes(key, *layout);
+    shard.cache.put(key, layout);
+    while (shard.bytes > kMaxBytes / kShardCount && shard.cache.size() > 1) {
+      shard.cache.removeOldest();
     }
     return layout;
   }
 
  private:
-  // callback for OnEntryRemoved
-  void operator()(LayoutCacheKey& key, Layout*& value) {
-    key.freeText();
-    delete value;
-  }
+  static const size_t kShardCount = 16;
 
-  android::LruCache<LayoutCacheKey, Layout*> mCache;
+  // The budget of all the shards together.
+  static const size_t kMaxBytes = 2 * 1024 * 1024;
 
-  // static const size_t kMaxEntries = LruCache<LayoutCacheKey,
-  // Layout*>::kUnlimitedCapacity;
+  using ShardCache = android::LruCache<LayoutCacheKey, std::shared_ptr<Layout>>;
 
-  // TODO: eviction based on memory footprint; for now, we just use a constant
-  // number of strings
-  static const size_t kMaxEntries = 5000;
+  struct Shard : private android::OnEntryRemoved<LayoutCacheKey,
+                                                 std::shared_ptr<Layout>> {
+    Shard() : cache(ShardCache::kUnlimitedCapacity) {
+      cache.setOnEntryRemovedListener(this);
+    }
+
+    // callback for OnEntryRemoved
+    void operator()(LayoutCacheKey& key, std::shared_ptr<Layout>& value) {
+      bytes -= getEntryBytes(key, *value);
+      key.freeText();
+      // Layouts still in use by other threads are deleted by the last of
+      // them.
+      value.reset();
+    }
+
+    std::mutex mutex;
+    ShardCache cache;
+    size_t bytes = 0;
+  };
+
+  static size_t getEntryBytes(const LayoutCacheKey& key,
+                              const Layout& layout) {
+    return key.getTextBytes() + layout.getMemoryUsage();
+  }
+
+  Shard mShards[kShardCount];
 };
 
 class LayoutEngine {
  public:
   LayoutEngine() {
     unicodeFunctions = hb_unicode_funcs_create(hb_icu_get_unicode_funcs());
-    hbBuffer = hb_buffer_create();
-    hb_buffer_set_unicode_funcs(hbBuffer, unicodeFunctions);
   }
 
-  hb_buffer_t* hbBuffer;
+  // Returns the buffer the calling thread shapes text into.
+  hb_buffer_t* getHbBuffer() {
+    thread_local std::unique_ptr<hb_buffer_t, decltype(&hb_buffer_destroy)>
+        hbBuffer(createHbBuffer(), &hb_buffer_destroy);
+    return hbBuffer.get();
+  }
+
   hb_unicode_funcs_t* unicodeFunctions;
   LayoutCache layoutCache;
 
@@ -183,6 +238,13 @@ class LayoutEngine {
     static LayoutEngine* instance = new LayoutEngine();
     return *instance;
   }
+
+ private:
+  hb_buffer_t* createHbBuffer() {
+    hb_buffer_t* buffer = hb_buffer_create();
+    hb_buffer_set_unicode_funcs(buffer, unicodeFunctions);
+    return buffer;
+  }
 };
 
 bool LayoutCacheKey::operator==(const LayoutCacheKey& other) const {
@@ -254,34 +316,31 @@ static hb_bool_t harfbuzzGetGlyphHorizontalOrigin(hb_font_t* /* hbFont */,
   return true;
 }
 
-hb_font_funcs_t* getHbFontFuncs(bool forColorBitmapFont) {
-  assertMinikinLocked();
-
-  static hb_font_funcs_t* hbFuncs = nullptr;
-  static hb_font_funcs_t* hbFuncsForColorBitmap = nullptr;
-
-  hb_font_funcs_t** funcs =
-      forColorBitmapFont ? &hbFuncs : &hbFuncsForColorBitmap;
-  if (*funcs == nullptr) {
-    *funcs = hb_font_funcs_create();
-    if (forColorBitmapFont) {
-      // Don't override the h_advance function since we use HarfBuzz's
-      // implementation for emoji for performance reasons. Note that it is
-      // technically possible for a TrueType font to have outline and embedded
-      // bitmap at the same time. We ignore modified advances of hinted outline
-      // glyphs in that case.
-    } else {
-      // Override the h_advance function since we can't use HarfBuzz's
-      // implemenation. It may return the wrong value if the font uses hinting
-      // aggressively.
-      hb_font_funcs_set_glyph_h_advance_func(
-          *funcs, harfbuzzGetGlyphHorizontalAdvance, 0, 0);
-    }
-    hb_font_funcs_set_glyph_h_origin_func(
-        *funcs, harfbuzzGetGlyphHorizontalOrigin, 0, 0);
-    hb_font_funcs_make_immutable(*funcs);
+static hb_font_funcs_t* createHbFontFuncs(bool forColorBitmapFont) {
+  hb_font_funcs_t* funcs = hb_font_funcs_create();
+  if (forColorBitmapFont) {
+    // Don't override the h_advance function since we use HarfBuzz's
+    // implementation for emoji for performance reasons. Note that it is
+    // technically possible for a TrueType font to have outline and embedded
+    // bitmap at the same time. We ignore modified advances of hinted outline
+    // glyphs in that case.
+  } else {
+    // Override the h_advance function since we can't use HarfBuzz's
+    // implemenation. It may return the wrong value if the font uses hinting
+    // aggressively.
+    hb_font_funcs_set_glyph_h_advance_func(
+        funcs, harfbuzzGetGlyphHorizontalAdvance, 0, 0);
   }
-  return *funcs;
+  hb_font_funcs_set_glyph_h_origin_func(funcs, harfbuzzGetGlyphHorizontalOrigin,
+                                        0, 0);
+  hb_font_funcs_make_immutable(funcs);
+  return funcs;
+}
+
+hb_font_funcs_t* getHbFontFuncs(bool forColorBitmapFont) {
+  static hb_font_funcs_t* hbFuncs = createHbFontFuncs(false);
+  static hb_font_funcs_t* hbFuncsForColorBitmap = createHbFontFuncs(true);
+  return forColorBitmapFont ? hbFuncsForColorBitmap : hbFuncs;
 }
 
 static bool isColorBitmapFont(hb_font_t* font) {
@@ -316,7 +375,11 @@ int Layout::findFace(const FakedFont& face, LayoutContext* ctx) {
   // Note: ctx == NULL means we're copying from the cache, no need to create
   // corresponding hb_font object.
   if (ctx != NULL) {
-    hb_font_t* font = getHbFontLocked(face.font);
+    // The cached font is shared between threads, so the layout gets its own
+    // sub font to set the scale and the functions on.
+    hb_font_t* parent = getHbFont(face.font);
+    hb_font_t* font = hb_font_create_sub_font(parent);
+    hb_font_destroy(parent);
     hb_font_set_funcs(font, getHbFontFuncs(isColorBitmapFont(font)),
                       &ctx->paint, 0);
     ctx->hbFonts.push_back(font);
@@ -325,13 +388,26 @@ int Layout::findFace(const FakedFont& face, LayoutContext* ctx) {
 }
 
 static hb_script_t codePointToScript(hb_codepoint_t codepoint) {
-  static hb_unicode_funcs_t* u = 0;
-  if (!u) {
-    u = LayoutEngine::getInstance().unicodeFunctions;
-  }
+  static hb_unicode_funcs_t* u = LayoutEngine::getInstance().unicodeFunctions;
   return hb_unicode_script(u, codepoint);
 }
 
+// Returns the language of the first language in the list that supports
+// |script|, or of the first language if none of them does.
+static hb_language_t getHbLanguage(uint32_t langListId, hb_script_t script) {
+  std::scoped_lock _l(gMinikinLock);
+  const FontLanguages& langList = FontLanguageListCache::getById(langListId);
+  if (langList.size() == 0) {
+    return HB_LANGUAGE_INVALID;
+  }
+  for (size_t i = 0; i < langList.size(); ++i) {
+    if (langList[i].supportsHbScript(script)) {
+      return langList[i].getHbLanguage();
+    }
+  }
+  return langList[0].getHbLanguage();
+}
+
 static hb_codepoint_t decodeUtf16(const uint16_t* chars,
                                   size_t len,
                                   ssize_t* iter) {
@@ -588,8 +664,6 @@ void Layout::doLayout(const uint16_t* buf,
                       const FontStyle& style,
                       const MinikinPaint& paint,
                       const std::shared_ptr<FontCollection>& collection) {
-  std::scoped_lock _l(gMinikinLock);
-
   LayoutContext ctx;
   ctx.style = style;
   ctx.paint = paint;
@@ -612,8 +686,6 @@ float Layout::measureText(const uint16_t* buf,
                           const MinikinPaint& paint,
                           const std::shared_ptr<FontCollection>& collection,
                           float* advances) {
-  std::scoped_lock _l(gMinikinLock);
-
   LayoutContext ctx;
   ctx.style = style;
   ctx.paint = paint;
@@ -720,9 +792,9 @@ float Layout::doLayoutWord(const uint16_t* buf,
     }
     advance = layoutForWord.getAdvance();
   } else {
-    Layout* layoutForWord = cache.get(key, ctx, collection);
+    std::shared_ptr<Layout> layoutForWord = cache.get(key, ctx, collection);
     if (layout) {
-      layout->appendLayout(layoutForWord, bufStart, wordSpacing);
+      layout->appendLayout(layoutForWord.get(), bufStart, wordSpacing);
     }
     if (advances) {
       layoutForWord->getAdvances(advances);
@@ -919,9 +991,12 @@ void Layout::doLayoutRun(const uint16_t* buf,
                          bool isRtl,
                          LayoutContext* ctx,
                          const std::shared_ptr<FontCollection>& collection) {
-  hb_buffer_t* buffer = LayoutEngine::getInstance().hbBuffer;
+  hb_buffer_t* buffer = LayoutEngine::getInstance().getHbBuffer();
   std::vector<FontCollection::Run> items;
-  collection->itemize(buf + start, count, ctx->style, &items);
+  {
+    std::scoped_lock _l(gMinikinLock);
+    collection->itemize(buf + start, count, ctx->style, &items);
+  }
 
   std::vector<hb_feature_t> features;
   // Disable default-on non-required ligature features if letter-spacing
@@ -1005,17 +1080,10 @@ void Layout::doLayoutRun(const uint16_t* buf,
       hb_buffer_set_script(buffer, script);
       hb_buffer_set_direction(buffer,
                               isRtl ? HB_DIRECTION_RTL : HB_DIRECTION_LTR);
-      const FontLanguages& langList =
-          FontLanguageListCache::getById(ctx->style.getLanguageListId());
-      if (langList.size() != 0) {
-        const FontLanguage* hbLanguage = &langList[0];
-        for (size_t i = 0; i < langList.size(); ++i) {
-          if (langList[i].supportsHbScript(script)) {
-            hbLanguage = &langList[i];
-            break;
-          }
-        }
-        hb_buffer_set_language(buffer, hbLanguage->getHbLanguage());
+      const hb_language_t hbLanguage =
+          getHbLanguage(ctx->style.getLanguageListId(), script);
+      if (hbLanguage != HB_LANGUAGE_INVALID) {
+        hb_buffer_set_language(buffer, hbLanguage);
       }
 
       const uint32_t clusterStart =
@@ -1192,11 +1260,16 @@ void Layout::getBounds(MinikinRect* bounds) const {
   bounds->set(mBounds);
 }
 
+size_t Layout::getMemoryUsage() const {
+  return sizeof(Layout) + mGlyphs.capacity() * sizeof(LayoutGlyph) +
+         mAdvances.capacity() * sizeof(float) +
+         mFaces.capacity() * sizeof(FakedFont);
+}
+
 void Layout::purgeCaches() {
-  std::scoped_lock _l(gMinikinLock);
   LayoutCache& layoutCache = LayoutEngine::getInstance().layoutCache;
   layoutCache.clear();
-  purgeHbFontCacheLocked();
+  purgeHbFontCache();
 }
 
 }  // namespace minikin
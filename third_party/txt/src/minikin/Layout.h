@@ -118,6 +118,7 @@ class Layout {
   static void purgeCaches();
 
  private:
+  friend class LayoutCache;
   friend class LayoutCacheKey;
 
   // Find a face in the mFaces vector, or create a new entry
@@ -165,6 +166,9 @@ class Layout {
   // Append another layout (for example, cached value) into this one
   void appendLayout(Layout* src, size_t start, float extraAdvance);
 
+  // Approximate number of bytes used by this layout, for the cache budget
+  size_t getMemoryUsage() const;
+
   std::vector<LayoutGlyph> mGlyphs;
   std::vector<float> mAdvances;
 
@@ -20,6 +20,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <numeric>
 
 #include <log/log.h>
 
@@ -127,13 +128,38 @@ float LineBreaker::addStyleRun(MinikinPaint* paint,
                                size_t start,
                                size_t end,
                                bool isRtl) {
+  return addStyleRun(paint, typeface, style, start, end, isRtl, true);
+}
+
+float LineBreaker::addMeasuredStyleRun(
+    MinikinPaint* paint,
+    const std::shared_ptr<FontCollection>& typeface,
+    FontStyle style,
+    size_t start,
+    size_t end,
+    bool isRtl) {
+  return addStyleRun(paint, typeface, style, start, end, isRtl, false);
+}
+
+float LineBreaker::addStyleRun(MinikinPaint* paint,
+                               const std::shared_ptr<FontCollection>& typeface,
+                               FontStyle style,
+                               size_t start,
+                               size_t end,
+                               bool isRtl,
+                               bool measure) {
   float width = 0.0f;
 
   float hyphenPenalty = 0.0;
   if (paint != nullptr) {
-    width = Layout::measureText(mTextBuf.data(), start, end - start,
-                                mTextBuf.size(), isRtl, style, *paint, typeface,
-                                mCharWidths.data() + start);
+    if (measure) {
+      width = Layout::measureText(mTextBuf.data(), start, end - start,
+                                  mTextBuf.size(), isRtl, style, *paint,
+                                  typeface, mCharWidths.data() + start);
+    } else {
+      width = std::accumulate(mCharWidths.begin() + start,
+                              mCharWidths.begin() + end, 0.0f);
+    }
 
     // a heuristic that seems to perform well
     hyphenPenalty =
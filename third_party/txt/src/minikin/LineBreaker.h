@@ -148,6 +148,17 @@ class LineBreaker {
                     size_t end,
                     bool isRtl);
 
+  // libtxt: Like addStyleRun, but takes the widths of the characters from the
+  // width buffer instead of measuring the text again. Used when only the line
+  // widths changed since the text was measured, with the widths copied back
+  // from charWidths() after the previous addStyleRun.
+  float addMeasuredStyleRun(MinikinPaint* paint,
+                            const std::shared_ptr<FontCollection>& typeface,
+                            FontStyle style,
+                            size_t start,
+                            size_t end,
+                            bool isRtl);
+
   void addReplacement(size_t start, size_t end, float width);
 
   size_t computeBreaks();
@@ -193,6 +204,14 @@ class LineBreaker {
 
   float currentLineWidth() const;
 
+  float addStyleRun(MinikinPaint* paint,
+                    const std::shared_ptr<FontCollection>& typeface,
+                    FontStyle style,
+                    size_t start,
+                    size_t end,
+                    bool isRtl,
+                    bool measure);
+
   void addWordBreak(size_t offset,
                     ParaWidth preBreak,
                     ParaWidth postBreak,
@@ -16,13 +16,11 @@
 
 #include <minikin/MinikinFont.h>
 #include "HbFontCache.h"
-#include "MinikinInternal.h"
 
 namespace minikin {
 
 MinikinFont::~MinikinFont() {
-  std::scoped_lock _l(gMinikinLock);
-  purgeHbFontLocked(this);
+  purgeHbFont(this);
 }
 
 }  // namespace minikin
@@ -0,0 +1,306 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "txt/fallback_font_index.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace txt {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x58494646;  // "FFIX"
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kMaxCodepoint = 0x10FFFF;
+
+// 64-bit FNV-1a. Unlike |std::hash|, the result is the same in every process,
+// which is what makes the fingerprint usable across launches.
+void HashBytes(const void* bytes, size_t size, uint64_t* hash) {
+  const uint8_t* data = static_cast<const uint8_t*>(bytes);
+  for (size_t i = 0; i < size; i++) {
+    *hash ^= data[i];
+    *hash *= 0x100000001b3ull;
+  }
+}
+
+class Writer {
+ public:
+  template <typename T>
+  void Write(T value) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    bytes_.insert(bytes_.end(), bytes, bytes + sizeof(T));
+  }
+
+  void WriteString(const std::string& string) {
+    Write(static_cast<uint32_t>(string.size()));
+    bytes_.insert(bytes_.end(), string.begin(), string.end());
+  }
+
+  sk_sp<SkData> Finish() {
+    return SkData::MakeWithCopy(bytes_.data(), bytes_.size());
+  }
+
+ private:
+  std::vector<uint8_t> bytes_;
+};
+
+class Reader {
+ public:
+  Reader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+  template <typename T>
+  bool Read(T* value) {
+    if (size_ - offset_ < sizeof(T)) {
+      return false;
+    }
+    memcpy(value, data_ + offset_, sizeof(T));
+    offset_ += sizeof(T);
+    return true;
+  }
+
+  bool ReadString(std::string* string) {
+    uint32_t size;
+    if (!Read(&size) || size_ - offset_ < size) {
+      return false;
+    }
+    string->assign(reinterpret_cast<const char*>(data_ + offset_), size);
+    offset_ += size;
+    return true;
+  }
+
+  bool AtEnd() const { return offset_ == size_; }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+  size_t offset_ = 0;
+};
+
+}  // anonymous namespace
+
+uint64_t FallbackFontIndex::ComputeFontSetFingerprint(
+    const sk_sp<SkFontMgr>& manager) {
+  TRACE_EVENT0("flutter", "FallbackFontIndex::ComputeFontSetFingerprint");
+  if (!manager) {
+    return 0;
+  }
+  std::vector<std::string> family_names;
+  const int family_count = manager->countFamilies();
+  family_names.reserve(family_count);
+  for (int i = 0; i < family_count; i++) {
+    SkString family_name;
+    manager->getFamilyName(i, &family_name);
+    family_names.emplace_back(family_name.c_str());
+  }
+  // The order of the families is not meaningful for every font manager.
+  std::sort(family_names.begin(), family_names.end());
+
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (const std::string& family_name : family_names) {
+    // Include the terminator so that the names can't run into each other.
+    HashBytes(family_name.c_str(), family_name.size() + 1, &hash);
+  }
+  return hash;
+}
+
+FallbackFontIndex::FallbackFontIndex() = default;
+
+FallbackFontIndex::~FallbackFontIndex() = default;
+
+bool FallbackFontIndex::Deserialize(const uint8_t* data, size_t size) {
+  TRACE_EVENT0("flutter", "FallbackFontIndex::Deserialize");
+  std::scoped_lock lock(mutex_);
+  Clear();
+  font_set_fingerprint_ = 0;
+  if (!ReadEntries(data, size)) {
+    FML_LOG(WARNING) << "Discarding corrupt fallback font index.";
+    Clear();
+    font_set_fingerprint_ = 0;
+    return false;
+  }
+  return true;
+}
+
+bool FallbackFontIndex::ReadEntries(const uint8_t* data, size_t size) {
+  Reader reader(data, size);
+  uint32_t magic, version, family_count;
+  if (!reader.Read(&magic) || magic != kMagic || !reader.Read(&version) ||
+      version != kVersion || !reader.Read(&font_set_fingerprint_) ||
+      !reader.Read(&family_count)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < family_count; i++) {
+    std::string family;
+    if (!reader.ReadString(&family)) {
+      return false;
+    }
+    family_indices_[family] = families_.size();
+    families_.push_back(std::move(family));
+  }
+
+  uint32_t locale_count;
+  if (!reader.Read(&locale_count)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < locale_count; i++) {
+    std::string locale;
+    uint32_t range_count;
+    if (!reader.ReadString(&locale) || !reader.Read(&range_count)) {
+      return false;
+    }
+    std::map<uint32_t, Range>& ranges = locales_[locale];
+    uint32_t next_first = 0;
+    for (uint32_t j = 0; j < range_count; j++) {
+      uint32_t first;
+      Range range;
+      if (!reader.Read(&first) || !reader.Read(&range.last) ||
+          !reader.Read(&range.family) || first < next_first ||
+          range.last < first || range.last > kMaxCodepoint ||
+          range.family >= families_.size()) {
+        return false;
+      }
+      ranges.emplace_hint(ranges.end(), first, range);
+      next_first = range.last + 1;
+    }
+  }
+  return reader.AtEnd();
+}
+
+sk_sp<SkData> FallbackFontIndex::Serialize() const {
+  TRACE_EVENT0("flutter", "FallbackFontIndex::Serialize");
+  std::scoped_lock lock(mutex_);
+  Writer writer;
+  writer.Write(kMagic);
+  writer.Write(kVersion);
+  writer.Write(font_set_fingerprint_);
+  writer.Write(static_cast<uint32_t>(families_.size()));
+  for (const std::string& family : families_) {
+    writer.WriteString(family);
+  }
+  writer.Write(static_cast<uint32_t>(locales_.size()));
+  for (const auto& [locale, ranges] : locales_) {
+    writer.WriteString(locale);
+    writer.Write(static_cast<uint32_t>(ranges.size()));
+    for (const auto& [first, range] : ranges) {
+      writer.Write(first);
+      writer.Write(range.last);
+      writer.Write(range.family);
+    }
+  }
+  return writer.Finish();
+}
+
+bool FallbackFontIndex::ResetIfFontSetChanged(uint64_t fingerprint) {
+  {
+    std::scoped_lock lock(mutex_);
+    if (fingerprint == font_set_fingerprint_) {
+      return false;
+    }
+    font_set_fingerprint_ = fingerprint;
+    Clear();
+  }
+  NotifyChanged();
+  return true;
+}
+
+bool FallbackFontIndex::Find(uint32_t ch,
+                             const std::string& locale,
+                             std::string* family) const {
+  std::scoped_lock lock(mutex_);
+  auto locale_it = locales_.find(locale);
+  if (locale_it == locales_.end()) {
+    return false;
+  }
+  const std::map<uint32_t, Range>& ranges = locale_it->second;
+  auto range_it = ranges.upper_bound(ch);
+  if (range_it == ranges.begin()) {
+    return false;
+  }
+  --range_it;
+  if (range_it->second.last < ch) {
+    return false;
+  }
+  *family = families_[range_it->second.family];
+  return true;
+}
+
+void FallbackFontIndex::Add(uint32_t first,
+                            uint32_t last,
+                            const std::string& locale,
+                            const std::string& family) {
+  if (last < first) {
+    return;
+  }
+  {
+    std::scoped_lock lock(mutex_);
+    std::map<uint32_t, Range>& ranges = locales_[locale];
+    // Clip the range to the gap between its neighbors.
+    auto next = ranges.upper_bound(first);
+    if (next != ranges.begin()) {
+      auto previous = std::prev(next);
+      if (previous->second.last >= last) {
+        return;
+      }
+      first = std::max(first, previous->second.last + 1);
+    }
+    next = ranges.lower_bound(first);
+    if (next != ranges.end()) {
+      if (next->first == first) {
+        return;
+      }
+      last = std::min(last, next->first - 1);
+    }
+
+    auto family_it = family_indices_.find(family);
+    if (family_it == family_indices_.end()) {
+      const uint32_t family_index = families_.size();
+      family_it = family_indices_.emplace(family, family_index).first;
+      families_.push_back(family);
+    }
+    ranges.emplace_hint(next, first, Range{last, family_it->second});
+  }
+  NotifyChanged();
+}
+
+void FallbackFontIndex::SetChangeCallback(std::function<void()> callback) {
+  std::scoped_lock lock(mutex_);
+  change_callback_ = std::move(callback);
+}
+
+uint64_t FallbackFontIndex::font_set_fingerprint() const {
+  std::scoped_lock lock(mutex_);
+  return font_set_fingerprint_;
+}
+
+size_t FallbackFontIndex::GetRangeCount() const {
+  std::scoped_lock lock(mutex_);
+  size_t count = 0;
+  for (const auto& [locale, ranges] : locales_) {
+    count += ranges.size();
+  }
+  return count;
+}
+
+void FallbackFontIndex::Clear() {
+  families_.clear();
+  family_indices_.clear();
+  locales_.clear();
+}
+
+void FallbackFontIndex::NotifyChanged() {
+  std::function<void()> callback;
+  {
+    std::scoped_lock lock(mutex_);
+    callback = change_callback_;
+  }
+  if (callback) {
+    callback();
+  }
+}
+
+}  // namespace txt
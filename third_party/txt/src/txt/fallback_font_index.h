@@ -0,0 +1,109 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TXT_FALLBACK_FONT_INDEX_H_
+#define TXT_FALLBACK_FONT_INDEX_H_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkFontMgr.h"
+
+namespace txt {
+
+// An index of the system fonts that FontCollection falls back to, mapping
+// ranges of codepoints to the family of the font the system font manager
+// picked for them in a given locale.
+//
+// Asking the system font manager for a font covering a codepoint is slow, on
+// Linux it sorts the whole fontconfig font set. The index is built from the
+// answers of the system font manager as text is laid out, and can be
+// serialized to be used on the next launch, so that each script only costs a
+// system lookup once per device rather than once per process.
+//
+// The index is valid for a given set of system fonts. |ResetIfFontSetChanged|
+// drops the entries when the fingerprint of the system fonts changes.
+//
+// The index is thread-safe so that it can be serialized on a background
+// thread while it is used for layout.
+class FallbackFontIndex {
+ public:
+  // Returns a fingerprint of the font families of |manager|, which changes
+  // when fonts are installed or removed.
+  static uint64_t ComputeFontSetFingerprint(const sk_sp<SkFontMgr>& manager);
+
+  FallbackFontIndex();
+
+  ~FallbackFontIndex();
+
+  // Replaces the entries with those serialized in |data|. Returns false and
+  // leaves the index empty if |data| is corrupt or was written by a different
+  // version of the index.
+  bool Deserialize(const uint8_t* data, size_t size);
+
+  sk_sp<SkData> Serialize() const;
+
+  // Drops the entries if they were built for a different set of fonts than
+  // the one with |fingerprint|, which then becomes the fingerprint of the
+  // index. Returns whether the entries were dropped.
+  bool ResetIfFontSetChanged(uint64_t fingerprint);
+
+  // Looks up the family for |ch| in |locale|. Returns false if the index has
+  // no entry for |ch|, otherwise sets |family| to the family of the fallback
+  // font, or to an empty string if no system font covers |ch|.
+  bool Find(uint32_t ch, const std::string& locale, std::string* family) const;
+
+  // Records that |family| is the fallback font for the codepoints from
+  // |first| to |last| included in |locale|. An empty |family| records that
+  // no system font covers them. Codepoints that already have an entry keep
+  // it.
+  void Add(uint32_t first,
+           uint32_t last,
+           const std::string& locale,
+           const std::string& family);
+
+  // Sets a callback invoked when entries are added or dropped, without any
+  // lock held, so that the index can be saved.
+  void SetChangeCallback(std::function<void()> callback);
+
+  uint64_t font_set_fingerprint() const;
+
+  size_t GetRangeCount() const;
+
+ private:
+  struct Range {
+    uint32_t last;
+    uint32_t family;
+  };
+
+  mutable std::mutex mutex_;
+  uint64_t font_set_fingerprint_ = 0;
+  std::vector<std::string> families_;
+  std::unordered_map<std::string, uint32_t> family_indices_;
+  // For each locale, the ranges of codepoints keyed by their first codepoint.
+  // Ranges never overlap.
+  std::unordered_map<std::string, std::map<uint32_t, Range>> locales_;
+  std::function<void()> change_callback_;
+
+  // Must be called with |mutex_| held.
+  void Clear();
+
+  // Must be called with |mutex_| held, on an empty index.
+  bool ReadEntries(const uint8_t* data, size_t size);
+
+  void NotifyChanged();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FallbackFontIndex);
+};
+
+}  // namespace txt
+
+#endif  // TXT_FALLBACK_FONT_INDEX_H_
@@ -30,6 +30,8 @@
 #include "minikin/Layout.h"
 #include "txt/platform.h"
 #include "txt/text_style.h"
+#include "unicode/uchar.h"
+#include "unicode/uscript.h"
 
 namespace txt {
 
@@ -37,6 +39,8 @@ namespace {
 
 const std::shared_ptr<minikin::FontFamily> g_null_family;
 
+constexpr uint32_t kMaxCodepoint = 0x10FFFF;
+
 }  // anonymous namespace
 
 FontCollection::FamilyKey::FamilyKey(const std::vector<std::string>& families,
@@ -99,10 +103,12 @@ size_t FontCollection::GetFontManagersCount() const {
 
 void FontCollection::SetupDefaultFontManager() {
   default_font_manager_ = GetDefaultFontManager();
+  ValidateFallbackFontIndex();
 }
 
 void FontCollection::SetDefaultFontManager(sk_sp<SkFontMgr> font_manager) {
   default_font_manager_ = font_manager;
+  ValidateFallbackFontIndex();
 
 #if FLUTTER_ENABLE_SKSHAPER
   skt_collection_.reset();
@@ -334,6 +340,11 @@ const std::shared_ptr<minikin::FontFamily>& FontCollection::DoMatchFallbackFont(
     uint32_t ch,
     std::string locale) {
   for (const sk_sp<SkFontMgr>& manager : GetFontManagerOrder()) {
+    if (fallback_font_index_ && manager == default_font_manager_) {
+      // The default font manager is the last one.
+      return MatchSystemFallbackFont(ch, locale);
+    }
+
     std::vector<const char*> bcp47;
     if (!locale.empty())
       bcp47.push_back(locale.c_str());
@@ -346,16 +357,110 @@ const std::shared_ptr<minikin::FontFamily>& FontCollection::DoMatchFallbackFont(
     typeface->getFamilyName(&sk_family_name);
     std::string family_name(sk_family_name.c_str());
 
-    if (std::find(fallback_fonts_for_locale_[locale].begin(),
-                  fallback_fonts_for_locale_[locale].end(),
-                  family_name) == fallback_fonts_for_locale_[locale].end())
-      fallback_fonts_for_locale_[locale].push_back(family_name);
+    AddFallbackFontForLocale(locale, family_name);
 
     return GetFallbackFontFamily(manager, family_name);
   }
   return g_null_family;
 }
 
+const std::shared_ptr<minikin::FontFamily>&
+FontCollection::MatchSystemFallbackFont(uint32_t ch,
+                                        const std::string& locale) {
+  std::string family_name;
+  if (fallback_font_index_->Find(ch, locale, &family_name)) {
+    if (family_name.empty()) {
+      return g_null_family;
+    }
+    const std::shared_ptr<minikin::FontFamily>& family =
+        GetFallbackFontFamily(default_font_manager_, family_name);
+    if (family) {
+      AddFallbackFontForLocale(locale, family_name);
+      return family;
+    }
+    // The font was removed without changing the families of the font
+    // manager, ask it again.
+  }
+
+  TRACE_EVENT0("flutter", "FontCollection::MatchSystemFallbackFont");
+  std::vector<const char*> bcp47;
+  if (!locale.empty())
+    bcp47.push_back(locale.c_str());
+  sk_sp<SkTypeface> typeface(default_font_manager_->matchFamilyStyleCharacter(
+      0, SkFontStyle(), bcp47.data(), bcp47.size(), ch));
+  if (!typeface) {
+    fallback_font_index_->Add(ch, ch, locale, "");
+    return g_null_family;
+  }
+
+  SkString sk_family_name;
+  typeface->getFamilyName(&sk_family_name);
+  family_name = sk_family_name.c_str();
+
+  AddFallbackFontForLocale(locale, family_name);
+
+  const std::shared_ptr<minikin::FontFamily>& family =
+      GetFallbackFontFamily(default_font_manager_, family_name);
+  if (family) {
+    AddToFallbackFontIndex(ch, locale, family_name, *family);
+  }
+  return family;
+}
+
+void FontCollection::AddToFallbackFontIndex(
+    uint32_t ch,
+    const std::string& locale,
+    const std::string& family_name,
+    const minikin::FontFamily& family) {
+  // Font managers pick fallback fonts by script, so the font picked for ch is
+  // assumed to be the pick for the codepoints it covers around ch that are
+  // in the same script and Unicode block.
+  UErrorCode status = U_ZERO_ERROR;
+  const UScriptCode script = uscript_getScript(ch, &status);
+  const UBlockCode block = ublock_getCode(ch);
+  const minikin::SparseBitSet& coverage = family.getCoverage();
+  auto is_neighbor = [&](uint32_t neighbor) {
+    UErrorCode neighbor_status = U_ZERO_ERROR;
+    return coverage.get(neighbor) && ublock_getCode(neighbor) == block &&
+           uscript_getScript(neighbor, &neighbor_status) == script &&
+           U_SUCCESS(neighbor_status);
+  };
+
+  uint32_t first = ch;
+  uint32_t last = ch;
+  if (U_SUCCESS(status) && block != UBLOCK_NO_BLOCK && coverage.get(ch)) {
+    while (first > 0 && is_neighbor(first - 1)) {
+      first--;
+    }
+    while (last < kMaxCodepoint && is_neighbor(last + 1)) {
+      last++;
+    }
+  }
+  fallback_font_index_->Add(first, last, locale, family_name);
+}
+
+void FontCollection::AddFallbackFontForLocale(const std::string& locale,
+                                              const std::string& family_name) {
+  std::vector<std::string>& families = fallback_fonts_for_locale_[locale];
+  if (std::find(families.begin(), families.end(), family_name) ==
+      families.end())
+    families.push_back(family_name);
+}
+
+void FontCollection::SetFallbackFontIndex(
+    std::shared_ptr<FallbackFontIndex> index) {
+  fallback_font_index_ = std::move(index);
+  ValidateFallbackFontIndex();
+}
+
+void FontCollection::ValidateFallbackFontIndex() {
+  if (!fallback_font_index_ || !default_font_manager_) {
+    return;
+  }
+  fallback_font_index_->ResetIfFontSetChanged(
+      FallbackFontIndex::ComputeFontSetFingerprint(default_font_manager_));
+}
+
 const std::shared_ptr<minikin::FontFamily>&
 FontCollection::GetFallbackFontFamily(const sk_sp<SkFontMgr>& manager,
                                       const std::string& family_name) {
@@ -29,6 +29,7 @@
 #include "third_party/skia/include/core/SkFontMgr.h"
 #include "third_party/skia/include/core/SkRefCnt.h"
 #include "txt/asset_font_manager.h"
+#include "txt/fallback_font_index.h"
 #include "txt/text_style.h"
 
 #if FLUTTER_ENABLE_SKSHAPER
@@ -68,6 +69,16 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
   // Remove all entries in the font family cache.
   void ClearFontFamilyCache();
 
+  // Uses |index| to find the system fonts to fall back to before asking the
+  // default font manager, and records the answers of the default font manager
+  // in it. The entries of |index| are dropped if they were built for a
+  // different set of system fonts.
+  void SetFallbackFontIndex(std::shared_ptr<FallbackFontIndex> index);
+
+  const std::shared_ptr<FallbackFontIndex>& GetFallbackFontIndex() const {
+    return fallback_font_index_;
+  }
+
 #if FLUTTER_ENABLE_SKSHAPER
 
   // Construct a Skia text layout FontCollection based on this collection.
@@ -106,6 +117,7 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
       fallback_fonts_;
   std::unordered_map<std::string, std::vector<std::string>>
       fallback_fonts_for_locale_;
+  std::shared_ptr<FallbackFontIndex> fallback_font_index_;
   bool enable_font_fallback_;
 
 #if FLUTTER_ENABLE_SKSHAPER
@@ -119,6 +131,27 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
       uint32_t ch,
       std::string locale);
 
+  // Looks up the fallback font for ch in fallback_font_index_, falling back
+  // to the default font manager and recording its answer.
+  const std::shared_ptr<minikin::FontFamily>& MatchSystemFallbackFont(
+      uint32_t ch,
+      const std::string& locale);
+
+  // Records the family matched for ch by the default font manager in
+  // fallback_font_index_, along with the neighbors of ch it covers.
+  void AddToFallbackFontIndex(uint32_t ch,
+                              const std::string& locale,
+                              const std::string& family_name,
+                              const minikin::FontFamily& family);
+
+  // Adds family_name to the fallback fonts of the font collections of locale.
+  void AddFallbackFontForLocale(const std::string& locale,
+                                const std::string& family_name);
+
+  // Drops the entries of fallback_font_index_ if the default font manager
+  // has different fonts than those the index was built for.
+  void ValidateFallbackFontIndex();
+
   std::vector<sk_sp<SkFontMgr>> GetFontManagerOrder() const;
 
   std::shared_ptr<minikin::FontFamily> FindFontFamilyInManagers(
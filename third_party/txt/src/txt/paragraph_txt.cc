@@ -245,7 +245,7 @@ void ParagraphTxt::SetText(std::vector<uint16_t> text, StyledRuns runs) {
 void ParagraphTxt::SetInlinePlaceholders(
     std::vector<PlaceholderRun> inline_placeholders,
     std::unordered_set<size_t> obj_replacement_char_indexes) {
-  needs_layout_ = true;
+  SetDirty(true);
   inline_placeholders_ = std::move(inline_placeholders);
   obj_replacement_char_indexes_ = std::move(obj_replacement_char_indexes);
 }
@@ -255,6 +255,14 @@ bool ParagraphTxt::ComputeLineBreaks() {
   line_widths_.clear();
   max_intrinsic_width_ = 0;
 
+  // The text was measured by an earlier layout at a different width.
+  const bool reuse_measurements = measurements_valid_;
+  if (!reuse_measurements) {
+    measured_char_widths_.assign(text_.size(), 0);
+    measured_run_widths_.clear();
+  }
+  size_t measured_run_index = 0;
+
   std::vector<size_t> newline_positions;
   // Discover and add all hard breaks.
   for (size_t i = 0; i < text_.size(); ++i) {
@@ -293,6 +301,10 @@ bool ParagraphTxt::ComputeLineBreaks() {
     memcpy(breaker_.buffer(), text_.data() + block_start,
            block_size * sizeof(text_[0]));
     breaker_.setText();
+    if (reuse_measurements) {
+      memcpy(breaker_.charWidths(), measured_char_widths_.data() + block_start,
+             block_size * sizeof(float));
+    }
 
     // Add the runs that include this line to the LineBreaker.
     double block_total_width = 0;
@@ -344,8 +356,16 @@ bool ParagraphTxt::ComputeLineBreaks() {
         inline_placeholder_index++;
       } else {
         // Is a regular text run.
-        double run_width = breaker_.addStyleRun(&paint, collection, font,
-                                                run_start, run_end, isRtl);
+        double run_width;
+        if (reuse_measurements) {
+          breaker_.addMeasuredStyleRun(&paint, collection, font, run_start,
+                                       run_end, isRtl);
+          run_width = measured_run_widths_[measured_run_index++];
+        } else {
+          run_width = breaker_.addStyleRun(&paint, collection, font, run_start,
+                                           run_end, isRtl);
+          measured_run_widths_.push_back(run_width);
+        }
         block_total_width += run_width;
       }
 
@@ -354,6 +374,10 @@ bool ParagraphTxt::ComputeLineBreaks() {
       run_index++;
     }
     max_intrinsic_width_ = std::max(max_intrinsic_width_, block_total_width);
+    if (!reuse_measurements) {
+      memcpy(measured_char_widths_.data() + block_start, breaker_.charWidths(),
+             block_size * sizeof(float));
+    }
 
     size_t breaks_count = breaker_.computeBreaks();
     const int* breaks = breaker_.getBreaks();
@@ -379,6 +403,7 @@ bool ParagraphTxt::ComputeLineBreaks() {
     breaker_.finish();
   }
 
+  measurements_valid_ = true;
   return true;
 }
 
@@ -1368,12 +1393,13 @@ double ParagraphTxt::GetLongestLine() {
 }
 
 void ParagraphTxt::SetParagraphStyle(const ParagraphStyle& style) {
-  needs_layout_ = true;
+  SetDirty(true);
   paragraph_style_ = style;
 }
 
 void ParagraphTxt::SetFontCollection(
     std::shared_ptr<FontCollection> font_collection) {
+  SetDirty(true);
   font_collection_ = std::move(font_collection);
 }
 
@@ -2015,6 +2041,9 @@ bool ParagraphTxt::DidExceedMaxLines() {
 
 void ParagraphTxt::SetDirty(bool dirty) {
   needs_layout_ = dirty;
+  if (dirty) {
+    measurements_valid_ = false;
+  }
 }
 
 std::vector<LineMetrics>& ParagraphTxt::GetLineMetrics() {
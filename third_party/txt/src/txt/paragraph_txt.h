@@ -122,8 +122,8 @@ class ParagraphTxt : public Paragraph {
   std::vector<LineMetrics>& GetLineMetrics() override;
 
   // Sets the needs_layout_ to dirty. When Layout() is called, a new Layout will
-  // be performed when this is set to true. Can also be used to prevent a new
-  // Layout from being calculated by setting to false.
+  // be performed when this is set to true, measuring the text again. Can also
+  // be used to prevent a new Layout from being calculated by setting to false.
   void SetDirty(bool dirty = true);
 
  private:
@@ -320,6 +320,14 @@ class ParagraphTxt : public Paragraph {
 
   bool needs_layout_ = true;
 
+  // The widths of the characters of text_ and of the style runs, in the order
+  // they were added to breaker_, as measured by the last ComputeLineBreaks().
+  // They do not depend on the width of the paragraph, so a Layout() that only
+  // changes the width breaks the lines without measuring the text again.
+  std::vector<float> measured_char_widths_;
+  std::vector<double> measured_run_widths_;
+  bool measurements_valid_ = false;
+
   struct WaveCoordinates {
     double x_start;
     double y_start;
@@ -0,0 +1,120 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "txt/fallback_font_index.h"
+
+#include "gtest/gtest.h"
+
+namespace txt {
+namespace testing {
+
+TEST(FallbackFontIndexTest, FindsFamiliesByLocale) {
+  FallbackFontIndex index;
+  index.Add(0x0600, 0x06FF, "ar", "Noto Naskh Arabic");
+  index.Add(0x4E00, 0x9FFF, "ja", "Noto Sans CJK JP");
+  index.Add(0x4E00, 0x9FFF, "zh-CN", "Noto Sans CJK SC");
+  index.Add(0xE000, 0xE000, "ja", "");
+
+  std::string family;
+  ASSERT_TRUE(index.Find(0x0627, "ar", &family));
+  EXPECT_EQ(family, "Noto Naskh Arabic");
+  ASSERT_TRUE(index.Find(0x4E00, "ja", &family));
+  EXPECT_EQ(family, "Noto Sans CJK JP");
+  ASSERT_TRUE(index.Find(0x9FFF, "zh-CN", &family));
+  EXPECT_EQ(family, "Noto Sans CJK SC");
+
+  // No system font covers the codepoint.
+  ASSERT_TRUE(index.Find(0xE000, "ja", &family));
+  EXPECT_TRUE(family.empty());
+
+  EXPECT_FALSE(index.Find(0x0627, "ja", &family));
+  EXPECT_FALSE(index.Find(0x05FF, "ar", &family));
+  EXPECT_FALSE(index.Find(0x0700, "ar", &family));
+  EXPECT_EQ(index.GetRangeCount(), 4u);
+}
+
+TEST(FallbackFontIndexTest, KeepsExistingEntries) {
+  FallbackFontIndex index;
+  index.Add(0x20, 0x2F, "en", "A");
+  index.Add(0x40, 0x4F, "en", "B");
+  // Overlaps both ranges, only the gap between them is added.
+  index.Add(0x28, 0x48, "en", "C");
+  // Already covered.
+  index.Add(0x22, 0x24, "en", "D");
+
+  std::string family;
+  ASSERT_TRUE(index.Find(0x2F, "en", &family));
+  EXPECT_EQ(family, "A");
+  ASSERT_TRUE(index.Find(0x30, "en", &family));
+  EXPECT_EQ(family, "C");
+  ASSERT_TRUE(index.Find(0x3F, "en", &family));
+  EXPECT_EQ(family, "C");
+  ASSERT_TRUE(index.Find(0x40, "en", &family));
+  EXPECT_EQ(family, "B");
+  ASSERT_TRUE(index.Find(0x22, "en", &family));
+  EXPECT_EQ(family, "A");
+  EXPECT_EQ(index.GetRangeCount(), 3u);
+}
+
+TEST(FallbackFontIndexTest, SerializationRoundTrips) {
+  FallbackFontIndex index;
+  index.ResetIfFontSetChanged(42);
+  index.Add(0x0600, 0x06FF, "ar", "Noto Naskh Arabic");
+  index.Add(0x1F600, 0x1F64F, "en-US", "Noto Color Emoji");
+  index.Add(0xE000, 0xE000, "en-US", "");
+
+  sk_sp<SkData> data = index.Serialize();
+  FallbackFontIndex loaded;
+  ASSERT_TRUE(loaded.Deserialize(data->bytes(), data->size()));
+  EXPECT_EQ(loaded.font_set_fingerprint(), 42u);
+  EXPECT_EQ(loaded.GetRangeCount(), 3u);
+
+  std::string family;
+  ASSERT_TRUE(loaded.Find(0x1F60A, "en-US", &family));
+  EXPECT_EQ(family, "Noto Color Emoji");
+  ASSERT_TRUE(loaded.Find(0xE000, "en-US", &family));
+  EXPECT_TRUE(family.empty());
+  EXPECT_EQ(loaded.Serialize()->size(), data->size());
+}
+
+TEST(FallbackFontIndexTest, RejectsCorruptData) {
+  FallbackFontIndex index;
+  index.ResetIfFontSetChanged(42);
+  index.Add(0x0600, 0x06FF, "ar", "Noto Naskh Arabic");
+  sk_sp<SkData> data = index.Serialize();
+
+  FallbackFontIndex loaded;
+  for (size_t size = 0; size < data->size(); size++) {
+    EXPECT_FALSE(loaded.Deserialize(data->bytes(), size));
+    EXPECT_EQ(loaded.GetRangeCount(), 0u);
+    EXPECT_EQ(loaded.font_set_fingerprint(), 0u);
+  }
+
+  std::vector<uint8_t> bytes(data->bytes(), data->bytes() + data->size());
+  // The version.
+  bytes[4]++;
+  EXPECT_FALSE(loaded.Deserialize(bytes.data(), bytes.size()));
+}
+
+TEST(FallbackFontIndexTest, ResetsWhenFontSetChanges) {
+  FallbackFontIndex index;
+  int change_count = 0;
+  index.SetChangeCallback([&change_count]() { change_count++; });
+
+  EXPECT_TRUE(index.ResetIfFontSetChanged(1));
+  index.Add(0x0600, 0x06FF, "ar", "Noto Naskh Arabic");
+  EXPECT_EQ(change_count, 2);
+
+  EXPECT_FALSE(index.ResetIfFontSetChanged(1));
+  EXPECT_EQ(index.GetRangeCount(), 1u);
+  EXPECT_EQ(change_count, 2);
+
+  EXPECT_TRUE(index.ResetIfFontSetChanged(2));
+  EXPECT_EQ(index.GetRangeCount(), 0u);
+  EXPECT_EQ(index.font_set_fingerprint(), 2u);
+  EXPECT_EQ(change_count, 3);
+}
+
+}  // namespace testing
+}  // namespace txt
@@ -16,8 +16,11 @@
 
 #include "flutter/fml/logging.h"
 #include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkTypeface.h"
 #include "third_party/skia/include/utils/SkCustomTypeface.h"
+#include "txt/asset_font_manager.h"
 #include "txt/font_collection.h"
+#include "txt/typeface_font_asset_provider.h"
 #include "txt_test_utils.h"
 
 namespace txt {
@@ -138,6 +141,106 @@ TEST(FontCollectionTest, CheckSkTypefacesSorting) {
             SkFontStyle::kExpanded_Width);
 }
 
+namespace {
+// A system font manager that falls back to the same typeface for every
+// codepoint and counts how often it is asked to.
+class CountingFallbackFontManager : public AssetFontManager {
+ public:
+  CountingFallbackFontManager(
+      std::unique_ptr<TypefaceFontAssetProvider> font_provider,
+      sk_sp<SkTypeface> fallback_typeface)
+      : AssetFontManager(std::move(font_provider)),
+        fallback_typeface_(std::move(fallback_typeface)) {}
+
+  int match_count() const { return match_count_; }
+
+ private:
+  sk_sp<SkTypeface> fallback_typeface_;
+  mutable int match_count_ = 0;
+
+  // |SkFontMgr|
+  SkTypeface* onMatchFamilyStyleCharacter(const char familyName[],
+                                          const SkFontStyle&,
+                                          const char* bcp47[],
+                                          int bcp47Count,
+                                          SkUnichar character) const override {
+    match_count_++;
+    return SkSafeRef(fallback_typeface_.get());
+  }
+};
+
+sk_sp<CountingFallbackFontManager> CreateCountingFallbackFontManager(
+    const std::vector<std::string>& font_files) {
+  auto font_provider = std::make_unique<TypefaceFontAssetProvider>();
+  sk_sp<SkTypeface> fallback_typeface;
+  for (const std::string& font_file : font_files) {
+    sk_sp<SkTypeface> typeface =
+        SkTypeface::MakeFromFile((GetFontDir() + "/" + font_file).c_str());
+    if (!fallback_typeface) {
+      fallback_typeface = typeface;
+    }
+    font_provider->RegisterTypeface(std::move(typeface));
+  }
+  return sk_make_sp<CountingFallbackFontManager>(std::move(font_provider),
+                                                 std::move(fallback_typeface));
+}
+}  // namespace
+
+TEST(FontCollectionTest, FallbackFontIndexAvoidsSystemLookups) {
+  sk_sp<CountingFallbackFontManager> font_manager =
+      CreateCountingFallbackFontManager({"Roboto-Regular.ttf"});
+  auto index = std::make_shared<FallbackFontIndex>();
+
+  auto collection = std::make_shared<FontCollection>();
+  collection->SetDefaultFontManager(font_manager);
+  collection->SetFallbackFontIndex(index);
+  ASSERT_TRUE(collection->MatchFallbackFont('a', "en-US"));
+  EXPECT_EQ(font_manager->match_count(), 1);
+  // The font covers the Latin letters of the Basic Latin block, which are
+  // assumed to fall back to it as well.
+  ASSERT_TRUE(collection->MatchFallbackFont('z', "en-US"));
+  EXPECT_EQ(font_manager->match_count(), 1);
+
+  // A font collection of the next launch.
+  sk_sp<SkData> data = index->Serialize();
+  auto loaded_index = std::make_shared<FallbackFontIndex>();
+  ASSERT_TRUE(loaded_index->Deserialize(data->bytes(), data->size()));
+  auto next_collection = std::make_shared<FontCollection>();
+  next_collection->SetDefaultFontManager(font_manager);
+  next_collection->SetFallbackFontIndex(loaded_index);
+  const std::shared_ptr<minikin::FontFamily>& family =
+      next_collection->MatchFallbackFont('q', "en-US");
+  ASSERT_TRUE(family);
+  EXPECT_TRUE(family->getCoverage().get('q'));
+  EXPECT_EQ(font_manager->match_count(), 1);
+
+  // Other locales are looked up separately.
+  ASSERT_TRUE(next_collection->MatchFallbackFont('b', "ja"));
+  EXPECT_EQ(font_manager->match_count(), 2);
+}
+
+TEST(FontCollectionTest, FallbackFontIndexIsDroppedWhenFontsChange) {
+  sk_sp<CountingFallbackFontManager> font_manager =
+      CreateCountingFallbackFontManager({"Roboto-Regular.ttf"});
+  auto index = std::make_shared<FallbackFontIndex>();
+  auto collection = std::make_shared<FontCollection>();
+  collection->SetDefaultFontManager(font_manager);
+  collection->SetFallbackFontIndex(index);
+  ASSERT_TRUE(collection->MatchFallbackFont('a', "en-US"));
+  EXPECT_GT(index->GetRangeCount(), 0u);
+
+  // A font was installed.
+  sk_sp<CountingFallbackFontManager> new_font_manager =
+      CreateCountingFallbackFontManager(
+          {"Roboto-Regular.ttf", "HomemadeApple.ttf"});
+  auto next_collection = std::make_shared<FontCollection>();
+  next_collection->SetDefaultFontManager(new_font_manager);
+  next_collection->SetFallbackFontIndex(index);
+  EXPECT_EQ(index->GetRangeCount(), 0u);
+  ASSERT_TRUE(next_collection->MatchFallbackFont('b', "en-US"));
+  EXPECT_EQ(new_font_manager->match_count(), 1);
+}
+
 #if 0
 
 TEST(FontCollection, HasDefaultRegistrations) {
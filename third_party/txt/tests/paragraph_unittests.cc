@@ -16,8 +16,10 @@
 
 #include <cstring>
 #include <iostream>
+#include <thread>
 
 #include "flutter/fml/logging.h"
+#include "minikin/Layout.h"
 #include "render_test.h"
 #include "third_party/icu/source/common/unicode/unistr.h"
 #include "third_party/skia/include/core/SkColor.h"
@@ -7117,4 +7119,118 @@ TEST_F(ParagraphTest, MixedTextHeightBehaviorRectsParagraph) {
 
   ASSERT_TRUE(Snapshot());
 }
+
+TEST_F(ParagraphTest, WidthOnlyRelayoutMatchesFreshLayout) {
+  const char* text =
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line. Sometimes, short sentence.\n"
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+      "tempor incididunt ut labore et dolore magna aliqua.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  auto build_paragraph = [&]() {
+    txt::ParagraphStyle paragraph_style;
+    paragraph_style.break_strategy = minikin::kBreakStrategy_HighQuality;
+    txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+    txt::TextStyle text_style;
+    text_style.font_families = std::vector<std::string>(1, "Roboto");
+    text_style.color = SK_ColorBLACK;
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text.substr(0, 40));
+    text_style.font_size = 20;
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text.substr(40));
+    builder.Pop();
+    builder.Pop();
+    return BuildParagraph(builder);
+  };
+
+  auto paragraph = build_paragraph();
+  paragraph->Layout(GetTestCanvasWidth());
+  for (double width : {250.0, 120.0, 600.0}) {
+    // Relaid out with the measurements of the previous layouts.
+    paragraph->Layout(width);
+
+    auto expected = build_paragraph();
+    expected->Layout(width);
+
+    EXPECT_EQ(paragraph->GetHeight(), expected->GetHeight());
+    EXPECT_EQ(paragraph->GetLongestLine(), expected->GetLongestLine());
+    EXPECT_EQ(paragraph->GetMaxIntrinsicWidth(),
+              expected->GetMaxIntrinsicWidth());
+    EXPECT_EQ(paragraph->GetMinIntrinsicWidth(),
+              expected->GetMinIntrinsicWidth());
+    std::vector<LineMetrics>& lines = paragraph->GetLineMetrics();
+    std::vector<LineMetrics>& expected_lines = expected->GetLineMetrics();
+    ASSERT_EQ(lines.size(), expected_lines.size());
+    for (size_t i = 0; i < lines.size(); ++i) {
+      EXPECT_EQ(lines[i].start_index, expected_lines[i].start_index);
+      EXPECT_EQ(lines[i].end_index, expected_lines[i].end_index);
+      EXPECT_EQ(lines[i].width, expected_lines[i].width);
+    }
+    std::vector<txt::Paragraph::TextBox> boxes = paragraph->GetRectsForRange(
+        0, u16_text.length(), Paragraph::RectHeightStyle::kTight,
+        Paragraph::RectWidthStyle::kTight);
+    std::vector<txt::Paragraph::TextBox> expected_boxes =
+        expected->GetRectsForRange(0, u16_text.length(),
+                                   Paragraph::RectHeightStyle::kTight,
+                                   Paragraph::RectWidthStyle::kTight);
+    ASSERT_EQ(boxes.size(), expected_boxes.size());
+    for (size_t i = 0; i < boxes.size(); ++i) {
+      EXPECT_EQ(boxes[i].rect, expected_boxes[i].rect);
+    }
+  }
+}
+
+TEST_F(ParagraphTest, MinikinLayoutOnSeveralThreads) {
+  const char* text =
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+      "tempor incididunt ut labore et dolore magna aliqua.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::vector<uint16_t> u16_text(icu_text.getBuffer(),
+                                 icu_text.getBuffer() + icu_text.length());
+  const size_t count = u16_text.size();
+
+  auto collection =
+      GetTestFontCollection()->GetMinikinFontCollectionForFamilies(
+          std::vector<std::string>(1, "Roboto"), "en-US");
+  minikin::FontStyle font(4, false);
+  minikin::MinikinPaint paint;
+  paint.size = 14;
+
+  std::vector<float> expected(count);
+  const float expected_advance =
+      minikin::Layout::measureText(u16_text.data(), 0, count, count, false,
+                                   font, paint, collection, expected.data());
+  ASSERT_GT(expected_advance, 0);
+
+  // Both the threads that shape the words and the threads that find them in
+  // the layout cache must see the same advances.
+  minikin::Layout::purgeCaches();
+  constexpr size_t kThreadCount = 4;
+  std::vector<std::vector<float>> advances(kThreadCount,
+                                           std::vector<float>(count));
+  std::vector<float> total_advances(kThreadCount);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kThreadCount; i++) {
+    threads.emplace_back([&, i]() {
+      for (int iteration = 0; iteration < 10; iteration++) {
+        total_advances[i] = minikin::Layout::measureText(
+            u16_text.data(), 0, count, count, false, font, paint, collection,
+            advances[i].data());
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  for (size_t i = 0; i < kThreadCount; i++) {
+    EXPECT_EQ(total_advances[i], expected_advance);
+    EXPECT_EQ(advances[i], expected);
+  }
+}
+
 }  // namespace txt